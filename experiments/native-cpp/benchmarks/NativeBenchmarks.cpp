@@ -0,0 +1,637 @@
+#include "../src/BinanceWsClient.h"
+#include "../src/NativeBacktestBatchRuntime.h"
+#include "../src/NativeBacktestRuntime.h"
+#include "../src/NativeExchangeInfo.h"
+#include "../src/NativeIndicatorRuntime.h"
+#include "../src/NativeKlinePageDecoder.h"
+#include "../src/NativeOrderSafety.h"
+#include "../src/NativePortfolio.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+// Headless benchmarks for the native engines and kernels. Every input is
+// synthetic and generated from fixed seeds, so two builds measure exactly the
+// same work and their JSON reports can be compared entry by entry (matched
+// on name and size), e.g. with --baseline=<previous report>.
+namespace {
+
+constexpr int kReportVersion = 1;
+constexpr quint64 kCandleSeed = 0x9E3779B97F4A7C15ULL;
+constexpr qint64 kFirstOpenTimeMs = 1'700'000'000'000LL;
+constexpr qint64 kMinuteMs = 60'000;
+constexpr qsizetype kFrameCount = 10'000;
+constexpr qsizetype kKlinePageRows = 1'500;
+constexpr qsizetype kExchangeInfoSymbols = 600;
+constexpr int kAuditEventsPerIteration = 200;
+
+// Results are folded in here so the optimizer cannot drop a measured call.
+volatile double g_sink = 0.0;
+
+struct Options {
+    QList<qsizetype> sizes = {10'000, 100'000, 2'000'000};
+    QStringList filters;
+    double minTimeMs = 250.0;
+    QString outputPath;
+    QString baselinePath;
+    bool listOnly = false;
+};
+
+class XorShift {
+public:
+    explicit XorShift(quint64 seed) : state_(seed ? seed : 1) {}
+
+    // Uniform in [0, 1).
+    double next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return static_cast<double>(state_ >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    quint64 state_;
+};
+
+// One-minute random walk around 100 with realistic wicks and volume.
+NativeIndicatorRuntime::CandleColumns syntheticCandles(qsizetype count) {
+    XorShift random(kCandleSeed);
+    NativeIndicatorRuntime::CandleColumns columns;
+    columns.reserve(count);
+    double price = 100.0;
+    for (qsizetype index = 0; index < count; ++index) {
+        const double open = price;
+        const double close = std::max(1.0, open * (1.0 + (random.next() - 0.5) * 0.004));
+        const double high = std::max(open, close) * (1.0 + random.next() * 0.002);
+        const double low = std::min(open, close) * (1.0 - random.next() * 0.002);
+        const double volume = 50.0 + random.next() * 950.0;
+        columns.append(kFirstOpenTimeMs + index * kMinuteMs, {open, high, low, close, volume});
+        price = close;
+    }
+    return columns;
+}
+
+QString priceText(double value) {
+    return QString::number(value, 'f', 2);
+}
+
+QStringList syntheticKlineFrames(bool combined) {
+    XorShift random(kCandleSeed ^ (combined ? 1 : 2));
+    QStringList frames;
+    frames.reserve(kFrameCount);
+    double price = 100.0;
+    for (qsizetype index = 0; index < kFrameCount; ++index) {
+        price *= 1.0 + (random.next() - 0.5) * 0.004;
+        const qint64 openTimeMs = kFirstOpenTimeMs + (index / 4) * kMinuteMs;
+        const QString payload = QStringLiteral(
+            R"({"e":"kline","E":%1,"s":"BTCUSDT","k":{"t":%2,"T":%3,"s":"BTCUSDT","i":"1m","f":100,"L":200,)"
+            R"("o":"%4","c":"%5","h":"%6","l":"%7","v":"%8","n":100,"x":%9,"q":"1.0","V":"0.5","Q":"0.5","B":"0"}})")
+            .arg(QString::number(openTimeMs + 1'000), QString::number(openTimeMs),
+                 QString::number(openTimeMs + kMinuteMs - 1), priceText(price), priceText(price * 1.001),
+                 priceText(price * 1.002), priceText(price * 0.999), priceText(10.0 + random.next() * 90.0),
+                 index % 4 == 3 ? QStringLiteral("true") : QStringLiteral("false"));
+        frames.append(combined
+                          ? QStringLiteral(R"({"stream":"btcusdt@kline_1m","data":%1})").arg(payload)
+                          : payload);
+    }
+    return frames;
+}
+
+// One full futures GET /klines page in the exchange's row layout.
+QByteArray syntheticKlinePage() {
+    XorShift random(kCandleSeed ^ 4);
+    QByteArray page("[");
+    double price = 100.0;
+    for (qsizetype index = 0; index < kKlinePageRows; ++index) {
+        price *= 1.0 + (random.next() - 0.5) * 0.004;
+        const qint64 openTimeMs = kFirstOpenTimeMs + index * kMinuteMs;
+        if (index > 0) page += ',';
+        page += QStringLiteral(R"([%1,"%2","%3","%4","%5","%6",%7,"%8",%9,"%10","%11","0"])")
+                    .arg(QString::number(openTimeMs), priceText(price), priceText(price * 1.002),
+                         priceText(price * 0.998), priceText(price * 1.001),
+                         QString::number(10.0 + random.next() * 90.0, 'f', 3),
+                         QString::number(openTimeMs + kMinuteMs - 1), QString::number(price * 50.0, 'f', 5),
+                         QString::number(100 + index % 50), QString::number(5.0, 'f', 3),
+                         QString::number(price * 5.0, 'f', 5))
+                    .toLatin1();
+    }
+    page += ']';
+    return page;
+}
+
+// A futures exchangeInfo document the size of the live one's symbol list.
+QByteArray syntheticExchangeInfo() {
+    QJsonArray symbols;
+    for (qsizetype index = 0; index < kExchangeInfoSymbols; ++index) {
+        symbols.append(QJsonObject{
+            {QStringLiteral("symbol"), QStringLiteral("SYM%1USDT").arg(index)},
+            {QStringLiteral("pair"), QStringLiteral("SYM%1USDT").arg(index)},
+            {QStringLiteral("contractType"), QStringLiteral("PERPETUAL")},
+            {QStringLiteral("status"), QStringLiteral("TRADING")},
+            {QStringLiteral("baseAsset"), QStringLiteral("SYM%1").arg(index)},
+            {QStringLiteral("quoteAsset"), QStringLiteral("USDT")},
+            {QStringLiteral("pricePrecision"), 4},
+            {QStringLiteral("quantityPrecision"), 1},
+            {QStringLiteral("orderTypes"), QJsonArray{QStringLiteral("LIMIT"), QStringLiteral("MARKET"),
+                                                      QStringLiteral("STOP"), QStringLiteral("TAKE_PROFIT")}},
+            {QStringLiteral("filters"), QJsonArray{
+                QJsonObject{{QStringLiteral("filterType"), QStringLiteral("PRICE_FILTER")},
+                            {QStringLiteral("minPrice"), QStringLiteral("0.0001")},
+                            {QStringLiteral("maxPrice"), QStringLiteral("200000")},
+                            {QStringLiteral("tickSize"), QStringLiteral("0.0001")}},
+                QJsonObject{{QStringLiteral("filterType"), QStringLiteral("LOT_SIZE")},
+                            {QStringLiteral("stepSize"), QStringLiteral("0.1")},
+                            {QStringLiteral("minQty"), QStringLiteral("0.1")},
+                            {QStringLiteral("maxQty"), QStringLiteral("10000000")}},
+                QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MARKET_LOT_SIZE")},
+                            {QStringLiteral("stepSize"), QStringLiteral("0.1")},
+                            {QStringLiteral("minQty"), QStringLiteral("0.1")},
+                            {QStringLiteral("maxQty"), QStringLiteral("2000000")}},
+                QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MAX_NUM_ORDERS")},
+                            {QStringLiteral("limit"), 200}},
+                QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MIN_NOTIONAL")},
+                            {QStringLiteral("notional"), QStringLiteral("5")}},
+                QJsonObject{{QStringLiteral("filterType"), QStringLiteral("PERCENT_PRICE")},
+                            {QStringLiteral("multiplierUp"), QStringLiteral("1.0500")},
+                            {QStringLiteral("multiplierDown"), QStringLiteral("0.9500")}},
+            }},
+        });
+    }
+    return QJsonDocument(QJsonObject{{QStringLiteral("symbols"), symbols}}).toJson(QJsonDocument::Compact);
+}
+
+QStringList syntheticBookTickerFrames() {
+    XorShift random(kCandleSeed ^ 3);
+    QStringList frames;
+    frames.reserve(kFrameCount);
+    double price = 100.0;
+    for (qsizetype index = 0; index < kFrameCount; ++index) {
+        price *= 1.0 + (random.next() - 0.5) * 0.001;
+        frames.append(QStringLiteral(
+            R"({"stream":"btcusdt@bookTicker","data":{"e":"bookTicker","u":%1,"s":"BTCUSDT","b":"%2","B":"3.5","a":"%3","A":"2.25","T":%4,"E":%4}})")
+                          .arg(QString::number(index + 1), priceText(price), priceText(price + 0.01),
+                               QString::number(kFirstOpenTimeMs + index * 100)));
+    }
+    return frames;
+}
+
+NativeIndicatorRuntime::ConfigMap signalConfigs(int count) {
+    const QList<QPair<QString, QJsonObject>> all = {
+        {QStringLiteral("rsi"), QJsonObject{{QStringLiteral("enabled"), true}, {QStringLiteral("length"), 14},
+                                            {QStringLiteral("buy_value"), 30.0}, {QStringLiteral("sell_value"), 70.0}}},
+        {QStringLiteral("macd"), QJsonObject{{QStringLiteral("enabled"), true}}},
+        {QStringLiteral("stoch_rsi"), QJsonObject{{QStringLiteral("enabled"), true}}},
+        {QStringLiteral("willr"), QJsonObject{{QStringLiteral("enabled"), true}}},
+    };
+    NativeIndicatorRuntime::ConfigMap configs;
+    for (int index = 0; index < std::min<int>(count, all.size()); ++index) {
+        configs.insert(all.at(index).first, all.at(index).second);
+    }
+    return configs;
+}
+
+NativeBacktestRuntime::Request backtestRequest(const NativeIndicatorRuntime::ConfigMap &indicators) {
+    NativeBacktestRuntime::Request request;
+    request.symbol = QStringLiteral("BENCHUSDT");
+    request.interval = QStringLiteral("1m");
+    request.indicators = indicators;
+    request.logic = QStringLiteral("OR");
+    request.positionPct = 0.1;
+    request.leverage = 5.0;
+    request.stopLossEnabled = true;
+    request.stopLossMode = QStringLiteral("percent");
+    request.stopLossPercent = 2.0;
+    return request;
+}
+
+QJsonObject openPositionRecord(int index) {
+    const QString sideKey = index % 2 == 0 ? QStringLiteral("L") : QStringLiteral("S");
+    const double mark = 100.0 + index;
+    return QJsonObject{
+        {QStringLiteral("symbol"), QStringLiteral("SYM%1USDT").arg(index)},
+        {QStringLiteral("side_key"), sideKey},
+        {QStringLiteral("entry_tf"), QStringLiteral("5m")},
+        {QStringLiteral("status"), QStringLiteral("Active")},
+        {QStringLiteral("open_time"), QStringLiteral("2026-06-18T10:00:00+00:00")},
+        {QStringLiteral("data"), QJsonObject{
+            {QStringLiteral("qty"), 0.5},
+            {QStringLiteral("mark"), mark},
+            {QStringLiteral("size_usdt"), mark * 0.5},
+            {QStringLiteral("margin_usdt"), mark * 0.05},
+            {QStringLiteral("pnl_value"), (index % 7) - 3.0},
+            {QStringLiteral("roi_percent"), (index % 11) - 5.0},
+            {QStringLiteral("leverage"), 10},
+        }},
+    };
+}
+
+class Runner {
+public:
+    explicit Runner(const Options &options) : options_(options) {}
+
+    bool wants(const QString &name) const {
+        if (options_.filters.isEmpty()) return true;
+        return std::any_of(options_.filters.cbegin(), options_.filters.cend(), [&name](const QString &filter) {
+            return name.contains(filter, Qt::CaseInsensitive);
+        });
+    }
+
+    // Repeats body until minTimeMs has elapsed (at least once). items is the
+    // unit count one call processes; reports normalize to it.
+    void measure(const QString &name, qsizetype size, qint64 items, const std::function<void()> &body) {
+        if (!wants(name)) return;
+        if (options_.listOnly) {
+            std::cout << name.toStdString() << " size=" << size << '\n';
+            return;
+        }
+        const qint64 minimumNs = static_cast<qint64>(options_.minTimeMs * 1'000'000.0);
+        int iterations = 0;
+        QElapsedTimer timer;
+        timer.start();
+        do {
+            body();
+            ++iterations;
+        } while (timer.nsecsElapsed() < minimumNs);
+        const qint64 totalNs = timer.nsecsElapsed();
+
+        const double nsPerIteration = static_cast<double>(totalNs) / iterations;
+        const double nsPerItem = nsPerIteration / static_cast<double>(std::max<qint64>(1, items));
+        results_.append(QJsonObject{
+            {QStringLiteral("name"), name},
+            {QStringLiteral("size"), static_cast<qint64>(size)},
+            {QStringLiteral("items"), items},
+            {QStringLiteral("iterations"), iterations},
+            {QStringLiteral("total_ns"), totalNs},
+            {QStringLiteral("ns_per_iteration"), nsPerIteration},
+            {QStringLiteral("ns_per_item"), nsPerItem},
+            {QStringLiteral("items_per_second"), nsPerItem > 0.0 ? 1e9 / nsPerItem : 0.0},
+        });
+        std::cerr << name.toStdString() << " size=" << size << " iterations=" << iterations
+                  << " ns/item=" << nsPerItem << '\n';
+    }
+
+    QJsonArray results() const { return results_; }
+
+private:
+    const Options &options_;
+    QJsonArray results_;
+};
+
+void benchmarkIndicators(Runner &runner, const NativeIndicatorRuntime::CandleColumns &candles) {
+    const qsizetype size = candles.size();
+    const NativeIndicatorRuntime::CandleSpan span = candles.span();
+    for (const QString &key : NativeIndicatorRuntime::computedIndicatorKeys()) {
+        NativeIndicatorRuntime::ConfigMap configs;
+        configs.insert(key, QJsonObject{{QStringLiteral("enabled"), true}});
+        runner.measure(QStringLiteral("indicators/%1").arg(key), size, size, [&]() {
+            const NativeIndicatorRuntime::SeriesMap series = NativeIndicatorRuntime::computeConfiguredSeries(span, configs);
+            for (const NativeIndicatorRuntime::Series &values : series) {
+                if (!values.isEmpty()) g_sink = g_sink + values.constLast();
+            }
+        });
+    }
+
+    NativeIndicatorRuntime::ConfigMap allConfigs;
+    for (const QString &key : NativeIndicatorRuntime::computedIndicatorKeys()) {
+        allConfigs.insert(key, QJsonObject{{QStringLiteral("enabled"), true}});
+    }
+    runner.measure(QStringLiteral("indicators/incremental_all"), size, size, [&]() {
+        NativeIndicatorRuntime::IncrementalIndicatorSet set(allConfigs);
+        for (qsizetype index = 0; index < size; ++index) {
+            set.appendClosed(span.at(index));
+        }
+        g_sink = g_sink + set.value(QStringLiteral("rsi"));
+    });
+}
+
+void benchmarkBacktests(Runner &runner, const NativeIndicatorRuntime::CandleColumns &candles) {
+    const qsizetype size = candles.size();
+    for (int comboSize = 1; comboSize <= 3; ++comboSize) {
+        const NativeBacktestRuntime::Request request = backtestRequest(signalConfigs(comboSize));
+        runner.measure(QStringLiteral("backtest/run/indicators_%1").arg(comboSize), size, size, [&]() {
+            const NativeBacktestRuntime::Result result = NativeBacktestRuntime::run(candles.span(), request);
+            g_sink = g_sink + result.finalEquity;
+        });
+    }
+
+    for (int comboSize = 1; comboSize <= 3; ++comboSize) {
+        NativeBacktestBatchRuntime::BatchRequest batch;
+        batch.symbols = {QStringLiteral("BENCHUSDT")};
+        batch.intervals = {QStringLiteral("1m")};
+        batch.indicatorConfigs = signalConfigs(4);
+        batch.runTemplate = backtestRequest({});
+        batch.optimizerMode = QStringLiteral("combinations");
+        batch.optimizerComboSize = comboSize;
+        batch.optimizerMinTrades = 0;
+        const qint64 groups = NativeBacktestBatchRuntime::buildIndicatorGroups(
+                                  batch.indicatorConfigs,
+                                  batch.optimizerMode,
+                                  comboSize,
+                                  batch.runTemplate.logic)
+                                  .size();
+        runner.measure(QStringLiteral("backtest/batch/combo_%1").arg(comboSize), size, size * groups, [&]() {
+            const QJsonObject snapshot = NativeBacktestBatchRuntime::runBatch(
+                batch,
+                [&candles](const QString &, const QString &, const NativeBacktestBatchRuntime::StopCallback &) {
+                    return NativeBacktestBatchRuntime::CandleLoadResult{true, candles, {}};
+                });
+            if (snapshot.value(QStringLiteral("state")).toString() != QStringLiteral("completed")) {
+                std::cerr << "batch benchmark did not complete: "
+                          << QJsonDocument(snapshot).toJson(QJsonDocument::Compact).left(200).toStdString() << '\n';
+            }
+            g_sink = g_sink + snapshot.value(QStringLiteral("processed_count")).toDouble();
+        });
+    }
+}
+
+void benchmarkStreamFrames(Runner &runner) {
+    const auto parseAll = [](const QStringList &frames) {
+        for (const QString &frame : frames) {
+            const BinanceWsClient::StreamFrame parsed = BinanceWsClient::parseStreamFrame(frame);
+            g_sink = g_sink + parsed.close + parsed.bidPrice;
+        }
+    };
+    // The QJsonDocument decoder the scanner falls back to, as a reference.
+    const auto parseAllJson = [](const QStringList &frames) {
+        for (const QString &frame : frames) {
+            const BinanceWsClient::StreamFrame parsed = BinanceWsClient::parseStreamFrameJson(frame);
+            g_sink = g_sink + parsed.close + parsed.bidPrice;
+        }
+    };
+    const QStringList rawKlines = syntheticKlineFrames(false);
+    const QStringList combinedKlines = syntheticKlineFrames(true);
+    const QStringList bookTickers = syntheticBookTickerFrames();
+    runner.measure(QStringLiteral("ws/parse/kline_raw"), kFrameCount, kFrameCount, [&]() { parseAll(rawKlines); });
+    runner.measure(QStringLiteral("ws/parse/kline_combined"), kFrameCount, kFrameCount, [&]() { parseAll(combinedKlines); });
+    runner.measure(QStringLiteral("ws/parse/book_ticker_combined"), kFrameCount, kFrameCount, [&]() { parseAll(bookTickers); });
+    runner.measure(QStringLiteral("ws/parse_json/kline_combined"), kFrameCount, kFrameCount, [&]() { parseAllJson(combinedKlines); });
+    runner.measure(QStringLiteral("ws/parse_json/book_ticker_combined"), kFrameCount, kFrameCount, [&]() {
+        parseAllJson(bookTickers);
+    });
+}
+
+void benchmarkKlinePages(Runner &runner) {
+    const QByteArray page = syntheticKlinePage();
+    runner.measure(QStringLiteral("rest/klines/decode_page"), kKlinePageRows, kKlinePageRows, [&]() {
+        const BinanceRestClient::KlinesResult decoded = NativeKlinePageDecoder::decode(page);
+        g_sink = g_sink + decoded.candles.constLast().close;
+    });
+    // The QJsonDocument decoder the fast path falls back to, as a reference.
+    runner.measure(QStringLiteral("rest/klines/decode_page_json"), kKlinePageRows, kKlinePageRows, [&]() {
+        const BinanceRestClient::KlinesResult decoded = NativeKlinePageDecoder::decodeJson(page);
+        g_sink = g_sink + decoded.candles.constLast().close;
+    });
+}
+
+void benchmarkExchangeInfo(Runner &runner) {
+    const QByteArray document = syntheticExchangeInfo();
+    runner.measure(QStringLiteral("rest/exchange_info/parse"), kExchangeInfoSymbols, kExchangeInfoSymbols, [&]() {
+        const NativeExchangeInfo::ParseResult parsed = NativeExchangeInfo::parse(document, true, kFirstOpenTimeMs);
+        g_sink = g_sink + static_cast<double>(parsed.snapshot->usdtSymbols().size());
+    });
+    // What every symbol filter lookup costs once the snapshot is cached.
+    const NativeExchangeInfo::SnapshotPtr snapshot = NativeExchangeInfo::parse(document, true, kFirstOpenTimeMs).snapshot;
+    const QStringList symbols = snapshot->usdtSymbols();
+    runner.measure(QStringLiteral("rest/exchange_info/lookup_filters"), symbols.size(), symbols.size(), [&]() {
+        for (const QString &symbol : symbols) {
+            g_sink = g_sink + snapshot->find(symbol)->filters.stepSize;
+        }
+    });
+}
+
+void benchmarkOrderAudit(Runner &runner) {
+    if (!runner.wants(QStringLiteral("order_audit/append")) && !runner.wants(QStringLiteral("order_audit/enqueue_flush"))) {
+        return;
+    }
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        std::cerr << "order audit benchmark skipped: no temporary directory\n";
+        return;
+    }
+    NativeOrderSafety::OrderAuditLogConfig config;
+    config.path = directory.filePath(QStringLiteral("order_audit.jsonl"));
+    config.maxBytes = 256ULL * 1024 * 1024;
+    config.backupCount = 1;
+    QVector<QJsonObject> events;
+    events.reserve(kAuditEventsPerIteration);
+    const QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(kFirstOpenTimeMs, Qt::UTC);
+    for (int index = 0; index < kAuditEventsPerIteration; ++index) {
+        events.append(NativeOrderSafety::buildOrderAuditEvent(
+            index % 2 == 0 ? QStringLiteral("order_intent") : QStringLiteral("order_result"),
+            QStringLiteral("futures"),
+            {
+                {QStringLiteral("symbol"), QStringLiteral("BTCUSDT")},
+                {QStringLiteral("side"), index % 4 < 2 ? QStringLiteral("BUY") : QStringLiteral("SELL")},
+                {QStringLiteral("type"), QStringLiteral("MARKET")},
+                {QStringLiteral("quantity"), QStringLiteral("0.01000000")},
+                {QStringLiteral("newClientOrderId"), QStringLiteral("bench-%1").arg(index)},
+            },
+            timestamp.addMSecs(index),
+            QStringLiteral("native-benchmarks")));
+    }
+    runner.measure(QStringLiteral("order_audit/append"), kAuditEventsPerIteration, kAuditEventsPerIteration, [&]() {
+        for (const QJsonObject &event : events) {
+            const QJsonObject status = NativeOrderSafety::appendOrderAuditEvent(event, config);
+            g_sink = g_sink + (status.value(QStringLiteral("write_ok")).toBool() ? 1.0 : 0.0);
+        }
+    });
+    NativeOrderSafety::OrderAuditLogConfig queuedConfig = config;
+    queuedConfig.path = directory.filePath(QStringLiteral("order_audit_queued.jsonl"));
+    runner.measure(QStringLiteral("order_audit/enqueue_flush"), kAuditEventsPerIteration, kAuditEventsPerIteration, [&]() {
+        for (const QJsonObject &event : events) {
+            NativeOrderSafety::enqueueOrderAuditEvent(event, queuedConfig);
+        }
+        g_sink = g_sink + (NativeOrderSafety::flushOrderAuditLog() ? 1.0 : 0.0);
+    });
+}
+
+void benchmarkPortfolio(Runner &runner) {
+    for (const int openCount : {50, 500}) {
+        QJsonObject openRecords;
+        for (int index = 0; index < openCount; ++index) {
+            const QJsonObject record = openPositionRecord(index);
+            openRecords.insert(
+                NativePortfolio::serializePositionKey(record.value(QStringLiteral("symbol")).toString(),
+                                                      record.value(QStringLiteral("side_key")).toString()),
+                record);
+        }
+        QJsonArray closedRecords;
+        QJsonObject closedRegistry;
+        for (int index = 0; index < 500; ++index) {
+            const QString symbol = QStringLiteral("OLD%1USDT").arg(index);
+            closedRecords.append(QJsonObject{
+                {QStringLiteral("symbol"), symbol},
+                {QStringLiteral("side_key"), QStringLiteral("L")},
+                {QStringLiteral("status"), QStringLiteral("Closed")},
+            });
+            closedRegistry.insert(symbol + QStringLiteral(":L"), QJsonObject{
+                {QStringLiteral("pnl_value"), (index % 9) - 4.0},
+                {QStringLiteral("margin_usdt"), 25.0},
+            });
+        }
+        const QJsonObject config{{QStringLiteral("account_type"), QStringLiteral("Futures")}};
+        runner.measure(QStringLiteral("portfolio/snapshot"), openCount, openCount, [&]() {
+            const QJsonObject snapshot = NativePortfolio::buildPortfolioSnapshot(
+                config,
+                openRecords,
+                closedRecords,
+                closedRegistry,
+                10'000.0,
+                8'000.0,
+                QStringLiteral("native-benchmarks"),
+                QStringLiteral("2026-06-18T12:00:00.000Z"));
+            g_sink = g_sink + snapshot.value(QStringLiteral("active_pnl")).toDouble();
+        });
+    }
+}
+
+QList<qsizetype> parseSizes(const QString &text, bool *ok) {
+    QList<qsizetype> sizes;
+    *ok = true;
+    for (const QString &part : text.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        bool partOk = false;
+        const qlonglong value = part.trimmed().toLongLong(&partOk);
+        if (!partOk || value <= 0) {
+            *ok = false;
+            return {};
+        }
+        sizes.append(static_cast<qsizetype>(value));
+    }
+    *ok = !sizes.isEmpty();
+    return sizes;
+}
+
+void printUsage() {
+    std::cerr << "usage: native_benchmarks [--sizes=10000,100000,2000000] [--quick] [--filter=text]...\n"
+                 "                         [--min-time-ms=250] [--output=report.json] [--baseline=old.json] [--list]\n";
+}
+
+// Adds the baseline's ns_per_item and the relative change to every result
+// that has a counterpart, and prints the comparison.
+bool compareWithBaseline(QJsonArray &results, const QString &baselinePath) {
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "cannot read baseline " << baselinePath.toStdString() << '\n';
+        return false;
+    }
+    const QJsonArray baselineResults = QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("results")).toArray();
+    QHash<QString, double> baselineNsPerItem;
+    for (const QJsonValue &value : baselineResults) {
+        const QJsonObject result = value.toObject();
+        baselineNsPerItem.insert(
+            QStringLiteral("%1|%2").arg(result.value(QStringLiteral("name")).toString(),
+                                        QString::number(result.value(QStringLiteral("size")).toInteger())),
+            result.value(QStringLiteral("ns_per_item")).toDouble());
+    }
+    for (qsizetype index = 0; index < results.size(); ++index) {
+        QJsonObject result = results.at(index).toObject();
+        const QString key = QStringLiteral("%1|%2").arg(result.value(QStringLiteral("name")).toString(),
+                                                        QString::number(result.value(QStringLiteral("size")).toInteger()));
+        const double baseline = baselineNsPerItem.value(key, 0.0);
+        if (baseline <= 0.0) continue;
+        const double current = result.value(QStringLiteral("ns_per_item")).toDouble();
+        const double changePercent = (current / baseline - 1.0) * 100.0;
+        result.insert(QStringLiteral("baseline_ns_per_item"), baseline);
+        result.insert(QStringLiteral("change_percent"), changePercent);
+        results.replace(index, result);
+        std::cerr << key.toStdString() << ": " << baseline << " -> " << current << " ns/item ("
+                  << (changePercent >= 0.0 ? "+" : "") << changePercent << "%)\n";
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    Options options;
+    const QStringList arguments = QCoreApplication::arguments().mid(1);
+    for (const QString &argument : arguments) {
+        const QString value = argument.section(QLatin1Char('='), 1);
+        if (argument.startsWith(QStringLiteral("--sizes="))) {
+            bool ok = false;
+            options.sizes = parseSizes(value, &ok);
+            if (!ok) {
+                printUsage();
+                return 2;
+            }
+        } else if (argument == QStringLiteral("--quick")) {
+            options.sizes = {10'000};
+            options.minTimeMs = 50.0;
+        } else if (argument.startsWith(QStringLiteral("--filter="))) {
+            options.filters.append(value);
+        } else if (argument.startsWith(QStringLiteral("--min-time-ms="))) {
+            options.minTimeMs = std::max(0.0, value.toDouble());
+        } else if (argument.startsWith(QStringLiteral("--output="))) {
+            options.outputPath = value;
+        } else if (argument.startsWith(QStringLiteral("--baseline="))) {
+            options.baselinePath = value;
+        } else if (argument == QStringLiteral("--list")) {
+            options.listOnly = true;
+        } else {
+            printUsage();
+            return argument == QStringLiteral("--help") ? 0 : 2;
+        }
+    }
+
+    Runner runner(options);
+    for (const qsizetype size : options.sizes) {
+        const NativeIndicatorRuntime::CandleColumns candles = syntheticCandles(size);
+        benchmarkIndicators(runner, candles);
+        benchmarkBacktests(runner, candles);
+    }
+    benchmarkStreamFrames(runner);
+    benchmarkKlinePages(runner);
+    benchmarkExchangeInfo(runner);
+    benchmarkOrderAudit(runner);
+    benchmarkPortfolio(runner);
+    if (options.listOnly) {
+        return 0;
+    }
+
+    QJsonArray results = runner.results();
+    if (!options.baselinePath.isEmpty() && !compareWithBaseline(results, options.baselinePath)) {
+        return 1;
+    }
+    QJsonArray sizes;
+    for (const qsizetype size : options.sizes) {
+        sizes.append(static_cast<qint64>(size));
+    }
+    const QJsonObject report{
+        {QStringLiteral("version"), kReportVersion},
+        {QStringLiteral("generated_at"), QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs)},
+        {QStringLiteral("build_type"), QStringLiteral(TB_BENCHMARK_BUILD_TYPE)},
+        {QStringLiteral("qt_version"), QString::fromLatin1(qVersion())},
+        {QStringLiteral("cpu_architecture"), QSysInfo::currentCpuArchitecture()},
+        {QStringLiteral("ideal_thread_count"), QThread::idealThreadCount()},
+        {QStringLiteral("candle_seed"), QString::number(kCandleSeed, 16)},
+        {QStringLiteral("sizes"), sizes},
+        {QStringLiteral("min_time_ms"), options.minTimeMs},
+        {QStringLiteral("results"), results},
+    };
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (options.outputPath.isEmpty()) {
+        std::cout << json.toStdString();
+        return 0;
+    }
+    QFile output(options.outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) || output.write(json) != json.size()) {
+        std::cerr << "cannot write " << options.outputPath.toStdString() << '\n';
+        return 1;
+    }
+    return 0;
+}
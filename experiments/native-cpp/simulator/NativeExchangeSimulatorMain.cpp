@@ -0,0 +1,148 @@
+#include "../src/NativeExchangeSimulator.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <iostream>
+
+// Serves a local Binance look-alike until interrupted, so the dashboard
+// runtime, kline seeding and order placement can be load-tested at hundreds
+// of symbols without touching the network. Stats go to stdout as one JSON
+// line per interval; everything else goes to stderr.
+namespace {
+
+void printUsage() {
+    std::cerr << "usage: native_exchange_simulator [--port=0] [--symbols=BTCUSDT,ETHUSDT | --symbol-count=100] [--seed=1]\n"
+                 "                                 [--latency-ms=0] [--jitter-ms=0] [--error-rate=0.0]\n"
+                 "                                 [--weight-limit=2400] [--ban-after=5] [--ban-seconds=120]\n"
+                 "                                 [--stream-interval-ms=1000] [--drop-streams-every-ms=0]\n"
+                 "                                 [--script=script.json] [--api-key=key] [--api-secret=secret]\n"
+                 "                                 [--wallet=10000] [--leverage=20] [--stats-interval-s=10]\n";
+}
+
+bool parseInt(const QString &value, int minimum, int *out) {
+    bool ok = false;
+    const int parsed = value.toInt(&ok);
+    if (!ok || parsed < minimum) {
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+QJsonObject statsObject(const NativeExchangeSimulator::Stats &stats, double walletBalance) {
+    return QJsonObject{
+        {QStringLiteral("time"), QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs)},
+        {QStringLiteral("rest_requests"), static_cast<qint64>(stats.restRequests)},
+        {QStringLiteral("scripted_responses"), static_cast<qint64>(stats.scriptedResponses)},
+        {QStringLiteral("injected_errors"), static_cast<qint64>(stats.injectedErrors)},
+        {QStringLiteral("rate_limited"), static_cast<qint64>(stats.rateLimited)},
+        {QStringLiteral("banned"), static_cast<qint64>(stats.banned)},
+        {QStringLiteral("orders_filled"), static_cast<qint64>(stats.ordersFilled)},
+        {QStringLiteral("orders_rejected"), static_cast<qint64>(stats.ordersRejected)},
+        {QStringLiteral("stream_connections"), static_cast<qint64>(stats.streamConnections)},
+        {QStringLiteral("user_data_connections"), static_cast<qint64>(stats.userDataConnections)},
+        {QStringLiteral("stream_frames"), static_cast<qint64>(stats.streamFrames)},
+        {QStringLiteral("wallet_balance"), walletBalance},
+    };
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    NativeExchangeSimulator::Config config;
+    QString scriptPath;
+    int statsIntervalSeconds = 10;
+    const QStringList arguments = QCoreApplication::arguments().mid(1);
+    for (const QString &argument : arguments) {
+        const QString value = argument.section(QLatin1Char('='), 1);
+        bool ok = true;
+        int number = 0;
+        if (argument.startsWith(QStringLiteral("--port="))) {
+            ok = parseInt(value, 0, &number) && number <= 65535;
+            config.port = static_cast<quint16>(number);
+        } else if (argument.startsWith(QStringLiteral("--symbols="))) {
+            config.symbols = value.split(QLatin1Char(','), Qt::SkipEmptyParts);
+            ok = !config.symbols.isEmpty();
+        } else if (argument.startsWith(QStringLiteral("--symbol-count="))) {
+            ok = parseInt(value, 1, &config.symbolCount);
+        } else if (argument.startsWith(QStringLiteral("--seed="))) {
+            config.seed = value.toULongLong(&ok);
+        } else if (argument.startsWith(QStringLiteral("--latency-ms="))) {
+            ok = parseInt(value, 0, &config.latencyMs);
+        } else if (argument.startsWith(QStringLiteral("--jitter-ms="))) {
+            ok = parseInt(value, 0, &config.latencyJitterMs);
+        } else if (argument.startsWith(QStringLiteral("--error-rate="))) {
+            config.errorRate = value.toDouble(&ok);
+            ok = ok && config.errorRate >= 0.0 && config.errorRate <= 1.0;
+        } else if (argument.startsWith(QStringLiteral("--weight-limit="))) {
+            ok = parseInt(value, 0, &config.weightLimitPerMinute);
+        } else if (argument.startsWith(QStringLiteral("--ban-after="))) {
+            ok = parseInt(value, 0, &config.requestsBeforeBan);
+        } else if (argument.startsWith(QStringLiteral("--ban-seconds="))) {
+            ok = parseInt(value, 0, &config.banSeconds);
+        } else if (argument.startsWith(QStringLiteral("--stream-interval-ms="))) {
+            ok = parseInt(value, 10, &config.streamIntervalMs);
+        } else if (argument.startsWith(QStringLiteral("--drop-streams-every-ms="))) {
+            ok = parseInt(value, 0, &config.streamDropIntervalMs);
+        } else if (argument.startsWith(QStringLiteral("--script="))) {
+            scriptPath = value;
+        } else if (argument.startsWith(QStringLiteral("--api-key="))) {
+            config.apiKey = value;
+        } else if (argument.startsWith(QStringLiteral("--api-secret="))) {
+            config.apiSecret = value;
+        } else if (argument.startsWith(QStringLiteral("--wallet="))) {
+            config.walletBalanceUsdt = value.toDouble(&ok);
+            ok = ok && config.walletBalanceUsdt >= 0.0;
+        } else if (argument.startsWith(QStringLiteral("--leverage="))) {
+            ok = parseInt(value, 1, &config.leverage) && config.leverage <= 125;
+        } else if (argument.startsWith(QStringLiteral("--stats-interval-s="))) {
+            ok = parseInt(value, 0, &statsIntervalSeconds);
+        } else {
+            printUsage();
+            return argument == QStringLiteral("--help") ? 0 : 2;
+        }
+        if (!ok) {
+            std::cerr << "invalid value in " << argument.toStdString() << '\n';
+            printUsage();
+            return 2;
+        }
+    }
+
+    NativeExchangeSimulator::Server server(config);
+    QString error;
+    if (!scriptPath.isEmpty() && !server.loadScript(scriptPath, &error)) {
+        std::cerr << error.toStdString() << '\n';
+        return 1;
+    }
+    if (!server.listen(&error)) {
+        std::cerr << "cannot listen: " << error.toStdString() << '\n';
+        return 1;
+    }
+    std::cerr << "serving " << server.market().symbols().size() << " symbols\n"
+              << "  REST    " << server.restBaseUrl().toStdString() << "  (/fapi/v1, /fapi/v2, /api/v3)\n"
+              << "  streams " << server.streamBaseUrl().toStdString() << "  (/ws, /stream)\n"
+              << "point the app at it with\n"
+              << "  CUSTOM_CONNECTOR_BASE_URL=" << server.restBaseUrl().toStdString() << '\n'
+              << "  TB_BINANCE_STREAM_BASE_URL=" << server.streamBaseUrl().toStdString() << '\n';
+#if !HAS_QT_WEBSOCKETS
+    std::cerr << "built without Qt WebSockets: streams are not served\n";
+#endif
+
+    QTimer statsTimer;
+    if (statsIntervalSeconds > 0) {
+        QObject::connect(&statsTimer, &QTimer::timeout, &server, [&server]() {
+            std::cout << QJsonDocument(statsObject(server.stats(), server.walletBalance()))
+                             .toJson(QJsonDocument::Compact)
+                             .toStdString()
+                      << std::endl;
+        });
+        statsTimer.start(statsIntervalSeconds * 1000);
+    }
+    return app.exec();
+}
@@ -1,5 +1,12 @@
 #include "BinanceRestClient.h"
-
+#include "NativeExchangeConnectors.h"
+#include "NativeExchangeInfo.h"
+#include "NativeHttpTransport.h"
+#include "NativeKlinePageDecoder.h"
+#include "NativeKlineStore.h"
+#include "NativeRequestLimiter.h"
+
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QEventLoop>
 #include <QHash>
@@ -7,17 +14,16 @@
 #include <QJsonObject>
 #include <QMap>
 #include <QMessageAuthenticationCode>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QRegularExpression>
 #include <QTimer>
-#include <QThread>
 #include <QUrl>
 #include <QUrlQuery>
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <mutex>
+#include <optional>
 
 namespace {
 qint64 intervalMilliseconds(QString interval) {
@@ -148,71 +154,71 @@ QJsonArray extractBalanceEntries(const QJsonDocument &document) {
     return {};
 }
 
-QJsonDocument httpRequestJson(
+// Sends the request and returns the reply body, or sets error and returns
+// false on a timeout or network error.
+bool httpRequestBody(
     const QString &method,
     const QString &url,
     const QList<QPair<QByteArray, QByteArray>> &headers,
     int timeoutMs,
     QString *error,
+    QByteArray *payload,
     const QByteArray &body = {}) {
-    QNetworkAccessManager manager;
-    QNetworkRequest request{QUrl(url)};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("trading-bot-cpp/1.0"));
-    if (!body.isEmpty()) {
-        request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/x-www-form-urlencoded"));
+    NativeHttpTransport::Request request;
+    request.method = method.trimmed().toUpper().toLatin1();
+    if (request.method != "POST" && request.method != "DELETE" && request.method != "PUT") {
+        request.method = QByteArrayLiteral("GET");
     }
-    for (const auto &header : headers) {
-        request.setRawHeader(header.first, header.second);
+    request.url = QUrl(url);
+    request.headers = headers;
+    if (!body.isEmpty()) {
+        request.contentType = QByteArrayLiteral("application/x-www-form-urlencoded");
     }
+    request.body = body;
+    request.timeoutMs = std::max(1000, timeoutMs);
 
-    const QString verb = method.trimmed().toUpper();
-    QNetworkReply *reply = nullptr;
-    if (verb == QStringLiteral("POST")) {
-        reply = manager.post(request, body);
-    } else if (verb == QStringLiteral("DELETE")) {
-        reply = manager.sendCustomRequest(request, QByteArrayLiteral("DELETE"), body);
-    } else if (verb == QStringLiteral("PUT")) {
-        reply = manager.put(request, body);
-    } else {
-        reply = manager.get(request);
-    }
-    if (!reply) {
-        if (error) {
-            *error = QStringLiteral("Failed to create network request");
-        }
-        return {};
+    NativeRequestLimiter::Limiter &limiter = NativeRequestLimiter::Limiter::forUrl(request.url);
+    if (!limiter.acquire(
+            NativeExchangeConnectors::estimateRequestWeight(request.url.path()),
+            NativeRequestLimiter::priorityFor(request.method, request.url.path()),
+            request.timeoutMs,
+            error)) {
+        return false;
     }
-
-    QEventLoop loop;
-    QTimer timer;
-    timer.setSingleShot(true);
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-    timer.start(std::max(1000, timeoutMs));
-    loop.exec();
-
-    if (!reply->isFinished()) {
-        reply->abort();
-        reply->deleteLater();
+    NativeHttpTransport::Response response = NativeHttpTransport::send(request);
+    limiter.reconcile(response.statusCode, response.headers, response.body, QDateTime::currentMSecsSinceEpoch());
+    if (response.timedOut) {
         if (error) {
             *error = QStringLiteral("Request timeout");
         }
-        return {};
+        return false;
     }
 
-    const QByteArray payload = reply->readAll();
-    if (reply->error() != QNetworkReply::NoError) {
+    if (response.networkError != QNetworkReply::NoError) {
         if (error) {
-            QString message = reply->errorString();
-            if (!payload.isEmpty()) {
-                message += QStringLiteral(" | %1").arg(QString::fromUtf8(payload));
+            QString message = response.errorString;
+            if (!response.body.isEmpty()) {
+                message += QStringLiteral(" | %1").arg(QString::fromUtf8(response.body));
             }
             *error = message;
         }
-        reply->deleteLater();
+        return false;
+    }
+    *payload = std::move(response.body);
+    return true;
+}
+
+QJsonDocument httpRequestJson(
+    const QString &method,
+    const QString &url,
+    const QList<QPair<QByteArray, QByteArray>> &headers,
+    int timeoutMs,
+    QString *error,
+    const QByteArray &body = {}) {
+    QByteArray payload;
+    if (!httpRequestBody(method, url, headers, timeoutMs, error, &payload, body)) {
         return {};
     }
-    reply->deleteLater();
 
     QJsonParseError parseError{};
     const QJsonDocument document = QJsonDocument::fromJson(payload, &parseError);
@@ -289,6 +295,354 @@ QString futuresApiPath(const QString &baseUrlOverride, const QString &suffix) {
         : QStringLiteral("/fapi");
     return prefix + suffix;
 }
+
+std::mutex klineStoreMutex;
+QString klineStoreRoot;
+
+// Spot, futures, testnet and custom hosts never share cached candles; the
+// key is the market's request-weight bucket key.
+QString klineStoreMarket(bool futures, bool testnet, const QString &baseUrlOverride) {
+    return NativeRequestLimiter::marketKey(futures, testnet, baseUrlOverride);
+}
+
+// exchangeInfo of one market from NativeExchangeInfo's cache; markets are
+// keyed like the kline store.
+NativeExchangeInfo::SnapshotPtr exchangeInfoSnapshot(
+    bool futures,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride,
+    QString *error) {
+    const QString overrideBase = baseUrlOverride.trimmed();
+    const QString base = futures
+        ? futuresBaseUrl(testnet, overrideBase)
+        : (!overrideBase.isEmpty() ? overrideBase
+                                   : (testnet ? QStringLiteral("https://testnet.binance.vision")
+                                              : QStringLiteral("https://api.binance.com")));
+    const QString endpoint = futures ? futuresApiPath(overrideBase, QStringLiteral("/v1/exchangeInfo"))
+                                     : QStringLiteral("/api/v3/exchangeInfo");
+    const QString url = QStringLiteral("%1%2").arg(base, endpoint);
+    return NativeExchangeInfo::snapshot(
+        klineStoreMarket(futures, testnet, overrideBase),
+        [url, futures, timeoutMs]() {
+            NativeExchangeInfo::ParseResult result;
+            QByteArray payload;
+            if (!httpRequestBody(QStringLiteral("GET"), url, {}, timeoutMs, &result.error, &payload)) {
+                return result;
+            }
+            return NativeExchangeInfo::parse(payload, futures, QDateTime::currentMSecsSinceEpoch());
+        },
+        error);
+}
+
+// A rejection by the symbol filters may mean the exchange changed them, so
+// the cached exchangeInfo is refreshed before the next order relies on it.
+void noteFuturesOrderRejection(const QString &error, bool testnet, const QString &overrideBase) {
+    if (NativeExchangeInfo::isFilterRejection(error)) {
+        NativeExchangeInfo::markStale(klineStoreMarket(true, testnet, overrideBase));
+    }
+}
+
+// Qt opens at most six HTTP/1.1 connections per host, so more pages in
+// flight would only queue inside QNetworkAccessManager.
+constexpr int kKlinePagesInFlight = 6;
+constexpr int kKlinePageAttempts = 4;
+
+int klinePageLimit(bool futures) {
+    return futures ? 1500 : 1000;
+}
+
+QString klinesEndpoint(bool futures, const QString &overrideBase) {
+    return futures ? futuresApiPath(overrideBase, QStringLiteral("/v1/klines"))
+                   : QStringLiteral("/api/v3/klines");
+}
+
+QUrl klinesUrl(
+    const QString &cleanSymbol,
+    const QString &cleanInterval,
+    bool futures,
+    bool testnet,
+    int limit,
+    const QString &baseUrlOverride,
+    qint64 startTimeMs,
+    qint64 endTimeMs) {
+    const int safeLimit = std::clamp(limit, 1, klinePageLimit(futures));
+    const QString defaultBase = futures
+        ? futuresBaseUrl(testnet, baseUrlOverride)
+        : (testnet ? QStringLiteral("https://testnet.binance.vision")
+                   : QStringLiteral("https://api.binance.com"));
+    const QString overrideBase = baseUrlOverride.trimmed();
+    const QString base = futures ? defaultBase : (overrideBase.isEmpty() ? defaultBase : overrideBase);
+    QUrl url(base + klinesEndpoint(futures, overrideBase));
+    QUrlQuery query;
+    query.addQueryItem(QStringLiteral("symbol"), cleanSymbol);
+    query.addQueryItem(QStringLiteral("interval"), cleanInterval);
+    query.addQueryItem(QStringLiteral("limit"), QString::number(safeLimit));
+    if (startTimeMs > 0) query.addQueryItem(QStringLiteral("startTime"), QString::number(startTimeMs));
+    if (endTimeMs > 0) query.addQueryItem(QStringLiteral("endTime"), QString::number(endTimeMs));
+    url.setQuery(query);
+    return url;
+}
+
+// One kline request; unlike fetchKlines an empty page is a valid answer.
+BinanceRestClient::KlinesResult requestKlines(
+    const QString &symbol,
+    const QString &interval,
+    bool futures,
+    bool testnet,
+    int limit,
+    int timeoutMs,
+    const QString &baseUrlOverride,
+    qint64 startTimeMs,
+    qint64 endTimeMs) {
+    BinanceRestClient::KlinesResult result;
+
+    const QString cleanSymbol = symbol.trimmed().toUpper();
+    const QString cleanInterval = interval.trimmed();
+    if (cleanSymbol.isEmpty()) {
+        result.error = QStringLiteral("Symbol is required");
+        return result;
+    }
+    if (cleanInterval.isEmpty()) {
+        result.error = QStringLiteral("Interval is required");
+        return result;
+    }
+
+    const QUrl url = klinesUrl(
+        cleanSymbol, cleanInterval, futures, testnet, limit, baseUrlOverride, startTimeMs, endTimeMs);
+    QByteArray payload;
+    if (!httpRequestBody(QStringLiteral("GET"), url.toString(), {}, timeoutMs, &result.error, &payload)) {
+        return result;
+    }
+    return NativeKlinePageDecoder::decode(payload);
+}
+
+struct KlineWindow {
+    qint64 firstOpenMs = 0;
+    qint64 lastOpenMs = 0;
+};
+
+// Splits [firstOpenMs, lastOpenMs] into request windows that each hold at most
+// pageLimit candles spaced at least spacingMs apart, so every window is one
+// complete page and all start times are known before anything is sent.
+QVector<KlineWindow> klineWindows(qint64 firstOpenMs, qint64 lastOpenMs, qint64 spacingMs, int pageLimit) {
+    QVector<KlineWindow> windows;
+    const qint64 spanMs = spacingMs > std::numeric_limits<qint64>::max() / pageLimit
+        ? std::numeric_limits<qint64>::max()
+        : spacingMs * pageLimit;
+    for (qint64 start = firstOpenMs; start <= lastOpenMs;) {
+        const qint64 end = lastOpenMs - start < spanMs ? lastOpenMs : start + spanMs - 1;
+        windows.append({start, end});
+        if (end == lastOpenMs) break;
+        start = end + 1;
+    }
+    return windows;
+}
+
+// Fetches every window with up to kKlinePagesInFlight requests outstanding on
+// the thread's pooled transport, each start debited from the market's weight
+// budget. Failed pages are retried on a timer without holding up the others.
+// pages[i] and completed[i] are filled for every window that finished, also
+// when the fetch as a whole fails or is cancelled.
+bool fetchKlineWindows(
+    const QString &symbol,
+    const QString &fetchInterval,
+    bool futures,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride,
+    const QVector<KlineWindow> &windows,
+    int maxCandles,
+    const std::function<bool()> &shouldStop,
+    QVector<QVector<BinanceRestClient::KlineCandle>> *pages,
+    QVector<bool> *completed,
+    QString *error) {
+    pages->clear();
+    pages->resize(windows.size());
+    completed->fill(false, windows.size());
+    if (windows.isEmpty()) return true;
+
+    const QString cleanSymbol = symbol.trimmed().toUpper();
+    const int pageLimit = klinePageLimit(futures);
+    const double pageWeight =
+        NativeExchangeConnectors::estimateRequestWeight(klinesEndpoint(futures, baseUrlOverride.trimmed()));
+    NativeRequestLimiter::Limiter &budget =
+        NativeRequestLimiter::Limiter::forMarket(futures, testnet, baseUrlOverride);
+
+    QEventLoop loop;
+    QTimer pacing;
+    pacing.setSingleShot(true);
+    QTimer stopPoll;
+    QSet<QNetworkReply *> replies;
+    QVector<int> attempts(windows.size(), 0);
+    QVector<qsizetype> retryQueue;
+    qsizetype nextWindow = 0;
+    qsizetype fetchedCount = 0;
+    int pendingRetries = 0;
+    bool failed = false;
+    bool finished = false;
+    std::function<void()> pump;
+
+    const auto fail = [&](const QString &message) {
+        if (failed) return;
+        failed = true;
+        *error = message;
+        pacing.stop();
+        const QSet<QNetworkReply *> pending = replies;
+        for (QNetworkReply *reply : pending) reply->abort();
+    };
+
+    const auto issue = [&](qsizetype index) {
+        const KlineWindow window = windows.at(index);
+        NativeHttpTransport::Request request;
+        request.url = klinesUrl(
+            cleanSymbol, fetchInterval, futures, testnet, pageLimit, baseUrlOverride,
+            window.firstOpenMs, window.lastOpenMs);
+        request.timeoutMs = std::max(1000, timeoutMs);
+        auto sent = std::make_shared<QNetworkReply *>(nullptr);
+        *sent = NativeHttpTransport::sendAsync(request, [&, sent, index, window](
+                                                            const NativeHttpTransport::Response &response) {
+            replies.remove(*sent);
+            budget.reconcile(response.statusCode, response.headers, response.body, QDateTime::currentMSecsSinceEpoch());
+            if (failed) {
+                pump();
+                return;
+            }
+
+            QString pageError;
+            QVector<BinanceRestClient::KlineCandle> candles;
+            if (response.timedOut) {
+                pageError = QStringLiteral("Request timeout");
+            } else if (response.networkError != QNetworkReply::NoError) {
+                pageError = response.errorString;
+                if (!response.body.isEmpty()) {
+                    pageError += QStringLiteral(" | %1").arg(QString::fromUtf8(response.body));
+                }
+            } else if (BinanceRestClient::KlinesResult page = NativeKlinePageDecoder::decode(response.body); page.ok) {
+                candles = std::move(page.candles);
+            } else {
+                pageError = QStringLiteral("Unexpected Binance kline response");
+            }
+
+            if (pageError.isEmpty()) {
+                candles.erase(
+                    std::remove_if(candles.begin(), candles.end(), [&window](const auto &candle) {
+                        return candle.openTimeMs < window.firstOpenMs || candle.openTimeMs > window.lastOpenMs;
+                    }),
+                    candles.end());
+                const auto byOpenTime = [](const auto &left, const auto &right) {
+                    return left.openTimeMs < right.openTimeMs;
+                };
+                if (!std::is_sorted(candles.cbegin(), candles.cend(), byOpenTime)) {
+                    std::sort(candles.begin(), candles.end(), byOpenTime);
+                }
+                fetchedCount += candles.size();
+                (*pages)[index] = std::move(candles);
+                (*completed)[index] = true;
+                if (fetchedCount > maxCandles) {
+                    fail(QStringLiteral("Historical range exceeded the native candle safety limit (%1)")
+                             .arg(maxCandles));
+                }
+            } else if (++attempts[index] < kKlinePageAttempts && !(shouldStop && shouldStop())) {
+                ++pendingRetries;
+                QTimer::singleShot(250 * attempts[index], &loop, [&, index]() {
+                    --pendingRetries;
+                    if (!failed) retryQueue.append(index);
+                    pump();
+                });
+            } else {
+                fail(pageError);
+            }
+            pump();
+        });
+        replies.insert(*sent);
+    };
+
+    pump = [&]() {
+        while (!failed && replies.size() < kKlinePagesInFlight
+               && (!retryQueue.isEmpty() || nextWindow < windows.size())) {
+            if (shouldStop && shouldStop()) {
+                fail(QStringLiteral("Historical kline fetch cancelled"));
+                break;
+            }
+            if (pacing.isActive()) return;
+            const qint64 waitMs = budget.tryAcquire(
+                pageWeight, NativeRequestLimiter::Priority::MarketData, QDateTime::currentMSecsSinceEpoch());
+            if (waitMs == NativeRequestLimiter::kBanned) {
+                fail(QStringLiteral("Binance request weight ban active for %1 s")
+                         .arg(std::ceil(budget.banRemainingMs(QDateTime::currentMSecsSinceEpoch()) / 1000.0)));
+                break;
+            }
+            if (waitMs > 0) {
+                pacing.start(static_cast<int>(std::min<qint64>(waitMs, 60'000)));
+                return;
+            }
+            issue(!retryQueue.isEmpty() ? retryQueue.takeFirst() : nextWindow++);
+        }
+        if (replies.isEmpty() && pendingRetries == 0 && !pacing.isActive()
+            && (failed || (retryQueue.isEmpty() && nextWindow >= windows.size()))) {
+            finished = true;
+            loop.quit();
+        }
+    };
+
+    QObject::connect(&pacing, &QTimer::timeout, &loop, [&]() { pump(); });
+    if (shouldStop) {
+        QObject::connect(&stopPoll, &QTimer::timeout, &loop, [&]() {
+            if (!failed && shouldStop()) {
+                fail(QStringLiteral("Historical kline fetch cancelled"));
+                pump();
+            }
+        });
+        stopPoll.start(100);
+    }
+
+    pump();
+    if (!finished) loop.exec();
+    return !failed;
+}
+
+BinanceRestClient::ListenKeyResult futuresListenKeyRequest(
+    const QString &method,
+    const QString &apiKey,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride) {
+    BinanceRestClient::ListenKeyResult result;
+    if (apiKey.trimmed().isEmpty()) {
+        result.error = QStringLiteral("Missing API credentials");
+        return result;
+    }
+    const QString overrideBase = baseUrlOverride.trimmed();
+    const QString url = futuresBaseUrl(testnet, overrideBase)
+        + futuresApiPath(overrideBase, QStringLiteral("/v1/listenKey"));
+
+    QString requestError;
+    const QJsonDocument doc = httpRequestJson(
+        method,
+        url,
+        {{QByteArrayLiteral("X-MBX-APIKEY"), apiKey.trimmed().toUtf8()}},
+        timeoutMs,
+        &requestError);
+    if (doc.isNull() || !doc.isObject()) {
+        result.error = requestError.isEmpty() ? QStringLiteral("Unexpected Binance listenKey response") : requestError;
+        return result;
+    }
+    const QJsonObject obj = doc.object();
+    if (obj.contains(QStringLiteral("code")) && obj.contains(QStringLiteral("msg"))) {
+        result.error = QStringLiteral("Binance listenKey error: %1")
+                           .arg(obj.value(QStringLiteral("msg")).toString(QStringLiteral("unknown")));
+        return result;
+    }
+    result.listenKey = obj.value(QStringLiteral("listenKey")).toString().trimmed();
+    if (method == QStringLiteral("POST") && result.listenKey.isEmpty()) {
+        result.error = QStringLiteral("Binance listenKey response carried no key");
+        return result;
+    }
+    result.ok = true;
+    return result;
+}
+
 } // namespace
 
 QString BinanceRestClient::hmacSha256Hex(const QString &secret, const QString &message) {
@@ -540,50 +894,15 @@ BinanceRestClient::SymbolsResult BinanceRestClient::fetchUsdtSymbols(
                    : QStringLiteral("https://api.binance.com"));
     const QString overrideBase = baseUrlOverride.trimmed();
     const QString base = futures ? defaultBase : (overrideBase.isEmpty() ? defaultBase : overrideBase);
-    const QString endpoint = futures ? futuresApiPath(overrideBase, QStringLiteral("/v1/exchangeInfo"))
-                                     : QStringLiteral("/api/v3/exchangeInfo");
-    const QString url = QStringLiteral("%1%2").arg(base, endpoint);
 
     QString requestError;
-    const QJsonDocument document = httpGetJson(url, {}, timeoutMs, &requestError);
-    if (document.isNull() || !document.isObject()) {
-        result.error = requestError.isEmpty() ? QStringLiteral("Unexpected Binance response") : requestError;
-        return result;
-    }
-
-    const QJsonObject obj = document.object();
-    if (obj.contains(QStringLiteral("msg"))) {
-        result.error = obj.value(QStringLiteral("msg")).toString(QStringLiteral("Binance API error"));
+    const NativeExchangeInfo::SnapshotPtr exchangeInfo =
+        exchangeInfoSnapshot(futures, testnet, timeoutMs, overrideBase, &requestError);
+    if (!exchangeInfo) {
+        result.error = requestError;
         return result;
     }
-
-    const QJsonArray symbols = obj.value(QStringLiteral("symbols")).toArray();
-    QStringList collected;
-    for (const QJsonValue &entry : symbols) {
-        const QJsonObject sym = entry.toObject();
-        if (sym.value(QStringLiteral("quoteAsset")).toString() != QStringLiteral("USDT")) {
-            continue;
-        }
-        const QString status = sym.value(QStringLiteral("status")).toString().toUpper();
-        if (status != QStringLiteral("TRADING")) {
-            continue;
-        }
-        if (futures) {
-            const QString contractType = sym.value(QStringLiteral("contractType")).toString().toUpper();
-            if (contractType != QStringLiteral("PERPETUAL")) {
-                continue;
-            }
-        }
-        const QString symbol = sym.value(QStringLiteral("symbol")).toString();
-        if (!symbol.isEmpty()) {
-            collected.append(symbol);
-        }
-    }
-
-    collected.removeDuplicates();
-    std::sort(collected.begin(), collected.end(), [](const QString &a, const QString &b) {
-        return a < b;
-    });
+    QStringList collected = exchangeInfo->usdtSymbols();
 
     if (sortByVolume && !collected.isEmpty()) {
         const QString tickerEndpoint = futures ? futuresApiPath(overrideBase, QStringLiteral("/v1/ticker/24hr"))
@@ -637,90 +956,24 @@ BinanceRestClient::KlinesResult BinanceRestClient::fetchKlines(
     const QString &baseUrlOverride,
     qint64 startTimeMs,
     qint64 endTimeMs) {
-    KlinesResult result;
-
-    const QString cleanSymbol = symbol.trimmed().toUpper();
-    const QString cleanInterval = interval.trimmed();
-    if (cleanSymbol.isEmpty()) {
-        result.error = QStringLiteral("Symbol is required");
-        return result;
-    }
-    if (cleanInterval.isEmpty()) {
-        result.error = QStringLiteral("Interval is required");
-        return result;
-    }
-
-    const int safeLimit = std::clamp(limit, 1, futures ? 1500 : 1000);
-    const QString defaultBase = futures
-        ? futuresBaseUrl(testnet, baseUrlOverride)
-        : (testnet ? QStringLiteral("https://testnet.binance.vision")
-                   : QStringLiteral("https://api.binance.com"));
-    const QString overrideBase = baseUrlOverride.trimmed();
-    const QString base = futures ? defaultBase : (overrideBase.isEmpty() ? defaultBase : overrideBase);
-    const QString endpoint = futures ? futuresApiPath(overrideBase, QStringLiteral("/v1/klines"))
-                                     : QStringLiteral("/api/v3/klines");
-    QUrl url(base + endpoint);
-    QUrlQuery query;
-    query.addQueryItem(QStringLiteral("symbol"), cleanSymbol);
-    query.addQueryItem(QStringLiteral("interval"), cleanInterval);
-    query.addQueryItem(QStringLiteral("limit"), QString::number(safeLimit));
-    if (startTimeMs > 0) query.addQueryItem(QStringLiteral("startTime"), QString::number(startTimeMs));
-    if (endTimeMs > 0) query.addQueryItem(QStringLiteral("endTime"), QString::number(endTimeMs));
-    url.setQuery(query);
-
-    QString requestError;
-    const QJsonDocument document = httpGetJson(url.toString(), {}, timeoutMs, &requestError);
-    if (document.isNull() || !document.isArray()) {
-        result.error = requestError.isEmpty() ? QStringLiteral("Unexpected Binance kline response") : requestError;
-        return result;
-    }
-
-    const QJsonArray candles = document.array();
-    QVector<KlineCandle> parsed;
-    parsed.reserve(candles.size());
-    for (const QJsonValue &entry : candles) {
-        if (!entry.isArray()) {
-            continue;
-        }
-        const QJsonArray row = entry.toArray();
-        if (row.size() < 6) {
-            continue;
-        }
-
-        bool timeOk = false;
-        const qint64 openTimeMs = row.at(0).toVariant().toLongLong(&timeOk);
-        double open = 0.0;
-        double high = 0.0;
-        double low = 0.0;
-        double close = 0.0;
-        double volume = 0.0;
-        if (!timeOk
-            || !parseJsonNumber(row.at(1), &open)
-            || !parseJsonNumber(row.at(2), &high)
-            || !parseJsonNumber(row.at(3), &low)
-            || !parseJsonNumber(row.at(4), &close)
-            || !parseJsonNumber(row.at(5), &volume)) {
-            continue;
-        }
-
-        KlineCandle candle;
-        candle.openTimeMs = openTimeMs;
-        candle.open = open;
-        candle.high = high;
-        candle.low = low;
-        candle.close = close;
-        candle.volume = volume;
-        parsed.push_back(candle);
+    KlinesResult result = requestKlines(
+        symbol, interval, futures, testnet, limit, timeoutMs, baseUrlOverride, startTimeMs, endTimeMs);
+    if (result.ok && result.candles.isEmpty()) {
+        result.ok = false;
+        result.error = QStringLiteral("No candle data returned for %1 (%2)")
+                           .arg(symbol.trimmed().toUpper(), interval.trimmed());
     }
+    return result;
+}
 
-    if (parsed.isEmpty()) {
-        result.error = QStringLiteral("No candle data returned for %1 (%2)").arg(cleanSymbol, cleanInterval);
-        return result;
-    }
+void BinanceRestClient::setKlineStoreDirectory(const QString &directory) {
+    std::lock_guard guard(klineStoreMutex);
+    klineStoreRoot = directory.trimmed();
+}
 
-    result.ok = true;
-    result.candles = parsed;
-    return result;
+QString BinanceRestClient::klineStoreDirectory() {
+    std::lock_guard guard(klineStoreMutex);
+    return klineStoreRoot;
 }
 
 BinanceRestClient::TickerPriceResult BinanceRestClient::fetchTickerPrice(
@@ -820,63 +1073,133 @@ BinanceRestClient::KlinesResult BinanceRestClient::fetchKlinesRange(
         : std::min(
               std::numeric_limits<qint64>::max() - requestedIntervalMs,
               endTimeMs) + requestedIntervalMs;
-    const int pageLimit = futures ? 1500 : 1000;
-    QMap<qint64, KlineCandle> candlesByTime;
-    qint64 current = startTimeMs;
-    int pageGuard = 0;
-
-    while (current < fetchEndTimeMs && pageGuard++ < 10000) {
-        if (shouldStop && shouldStop()) {
-            result.error = QStringLiteral("Historical kline fetch cancelled");
-            return result;
-        }
-
-        KlinesResult page;
-        for (int attempt = 0; attempt < 4; ++attempt) {
-            page = fetchKlines(
-                symbol,
+    std::optional<NativeKlineStore::Series> store;
+    if (const QString storeDirectory = klineStoreDirectory(); !storeDirectory.isEmpty()) {
+        store.emplace(
+            storeDirectory,
+            NativeKlineStore::SeriesKey{
+                klineStoreMarket(futures, testnet, baseUrlOverride),
+                symbol.trimmed().toUpper(),
                 fetchInterval,
-                futures,
-                testnet,
-                pageLimit,
-                timeoutMs,
-                baseUrlOverride,
-                current,
-                fetchEndTimeMs);
-            if (page.ok || (shouldStop && shouldStop())) break;
-            QThread::msleep(static_cast<unsigned long>(250 * (attempt + 1)));
-        }
-        if (!page.ok) {
-            result.error = page.error.isEmpty()
-                ? QStringLiteral("Historical kline page request failed")
-                : page.error;
-            return result;
+            });
+        if (!store->isOpen()) store.reset();
+    }
+
+    // Only candles that have closed are stored; anything newer is fetched
+    // every time and merged over the stored range below.
+    const qint64 closedSpanMs = fetchInterval == QStringLiteral("1M")
+        ? 31LL * 24 * 60 * 60 * 1000
+        : fetchIntervalMs;
+    const qint64 closedThroughMs = QDateTime::currentMSecsSinceEpoch() - closedSpanMs;
+    const QVector<NativeKlineStore::Range> gaps = store
+        ? store->missingRanges(startTimeMs, fetchEndTimeMs)
+        : QVector<NativeKlineStore::Range>{{startTimeMs, fetchEndTimeMs}};
+
+    // Windows are laid out from the minimum candle spacing; calendar months
+    // are never shorter than 28 days.
+    const qint64 spacingMs = fetchInterval == QStringLiteral("1M")
+        ? 28LL * 24 * 60 * 60 * 1000
+        : fetchIntervalMs;
+    QVector<KlineWindow> windows;
+    QVector<qsizetype> gapWindowEnds;
+    gapWindowEnds.reserve(gaps.size());
+    for (const NativeKlineStore::Range &gap : gaps) {
+        windows.append(klineWindows(gap.firstOpenMs, gap.lastOpenMs, spacingMs, klinePageLimit(futures)));
+        gapWindowEnds.append(windows.size());
+    }
+
+    QVector<QVector<KlineCandle>> pages;
+    QVector<bool> completed;
+    const bool fetchedAll = fetchKlineWindows(
+        symbol,
+        fetchInterval,
+        futures,
+        testnet,
+        timeoutMs,
+        baseUrlOverride,
+        windows,
+        safeMaxCandles,
+        shouldStop,
+        &pages,
+        &completed,
+        &result.error);
+
+    // Windows are disjoint and ascending, so concatenating the pages in window
+    // order yields one sorted series.
+    qsizetype liveCount = 0;
+    for (const QVector<KlineCandle> &page : pages) liveCount += page.size();
+    QVector<KlineCandle> live;
+    live.reserve(liveCount);
+    for (const QVector<KlineCandle> &page : pages) live.append(page);
+    pages.clear();
+
+    const auto byOpenTime = [](const KlineCandle &candle, qint64 openTimeMs) {
+        return candle.openTimeMs < openTimeMs;
+    };
+    if (store) {
+        qsizetype firstWindow = 0;
+        for (qsizetype gapIndex = 0; gapIndex < gaps.size(); ++gapIndex) {
+            const qsizetype endWindow = gapWindowEnds.at(gapIndex);
+            const bool gapComplete = std::all_of(
+                completed.cbegin() + firstWindow, completed.cbegin() + endWindow, [](bool done) { return done; });
+            firstWindow = endWindow;
+            if (!gapComplete) continue;
+            const NativeKlineStore::Range &gap = gaps.at(gapIndex);
+            const NativeKlineStore::Range closed{gap.firstOpenMs, std::min(gap.lastOpenMs, closedThroughMs)};
+            if (closed.lastOpenMs < closed.firstOpenMs) continue;
+            const auto begin = std::lower_bound(live.cbegin(), live.cend(), closed.firstOpenMs, byOpenTime);
+            const auto end = std::lower_bound(begin, live.cend(), closed.lastOpenMs + 1, byOpenTime);
+            // A failed write only means this gap is fetched again next time.
+            store->append(QVector<KlineCandle>(begin, end), closed);
         }
+    }
+    if (!fetchedAll) {
+        return result;
+    }
 
-        qint64 lastOpenTime = current;
-        for (const KlineCandle &candle : page.candles) {
-            if (candle.openTimeMs >= startTimeMs && candle.openTimeMs <= fetchEndTimeMs) {
-                candlesByTime.insert(candle.openTimeMs, candle);
+    QVector<KlineCandle> fetched;
+    if (store) {
+        bool intact = true;
+        const QVector<KlineCandle> stored = store->read(startTimeMs, fetchEndTimeMs, &intact);
+        store.reset();
+        // A stored segment turned out to be unreadable and was dropped from
+        // the store; go again, once, so its range is fetched like any other
+        // gap.
+        if (!intact) {
+            thread_local bool refetching = false;
+            if (refetching) {
+                result.error = QStringLiteral("Stored candles for %1 (%2) could not be read back")
+                                   .arg(symbol.trimmed().toUpper(), fetchInterval);
+                return result;
+            }
+            refetching = true;
+            KlinesResult refetched = fetchKlinesRange(
+                symbol, interval, futures, testnet, startTimeMs, endTimeMs, maxCandles, timeoutMs, baseUrlOverride, shouldStop);
+            refetching = false;
+            return refetched;
+        }
+        fetched.reserve(stored.size() + live.size());
+        qsizetype liveIndex = 0;
+        for (const KlineCandle &candle : stored) {
+            for (; liveIndex < live.size() && live.at(liveIndex).openTimeMs < candle.openTimeMs; ++liveIndex) {
+                fetched.append(live.at(liveIndex));
+            }
+            if (liveIndex < live.size() && live.at(liveIndex).openTimeMs == candle.openTimeMs) {
+                fetched.append(live.at(liveIndex++));
+            } else {
+                fetched.append(candle);
             }
-            lastOpenTime = std::max(lastOpenTime, candle.openTimeMs);
         }
-        if (candlesByTime.size() > safeMaxCandles) {
+        for (; liveIndex < live.size(); ++liveIndex) {
+            fetched.append(live.at(liveIndex));
+        }
+        if (fetched.size() > safeMaxCandles) {
             result.error = QStringLiteral("Historical range exceeded the native candle safety limit (%1)")
                                .arg(safeMaxCandles);
             return result;
         }
-        if (page.candles.size() < pageLimit) break;
-        const qint64 next = lastOpenTime + fetchIntervalMs;
-        if (next <= current) break;
-        current = next;
-    }
-
-    QVector<KlineCandle> fetched;
-    fetched.reserve(candlesByTime.size());
-    for (auto it = candlesByTime.cbegin(); it != candlesByTime.cend(); ++it) {
-        if (it.key() >= startTimeMs && it.key() <= fetchEndTimeMs) {
-            fetched.append(it.value());
-        }
+    } else {
+        fetched = std::move(live);
     }
     if (fetched.isEmpty()) {
         result.error = QStringLiteral("No candle data returned for %1 (%2)")
@@ -1160,85 +1483,88 @@ BinanceRestClient::FuturesPositionsResult BinanceRestClient::fetchOpenFuturesPos
     return result;
 }
 
-BinanceRestClient::FuturesSymbolFilters BinanceRestClient::fetchFuturesSymbolFilters(
-    const QString &symbol,
+BinanceRestClient::FuturesOpenOrdersResult BinanceRestClient::fetchOpenFuturesOrders(
+    const QString &apiKey,
+    const QString &apiSecret,
     bool testnet,
     int timeoutMs,
     const QString &baseUrlOverride) {
-    FuturesSymbolFilters result;
-    const QString cleanSymbol = symbol.trimmed().toUpper();
-    if (cleanSymbol.isEmpty()) {
-        result.error = QStringLiteral("Symbol is required");
+    FuturesOpenOrdersResult result;
+    if (apiKey.trimmed().isEmpty() || apiSecret.trimmed().isEmpty()) {
+        result.error = QStringLiteral("Missing API credentials");
         return result;
     }
 
     const QString overrideBase = baseUrlOverride.trimmed();
-    const QString base = futuresBaseUrl(testnet, overrideBase);
-    const QString url = QStringLiteral("%1%2").arg(base, futuresApiPath(overrideBase, QStringLiteral("/v1/exchangeInfo")));
-
+    const QString query = QStringLiteral("timestamp=%1").arg(QDateTime::currentMSecsSinceEpoch());
+    const QString url = QStringLiteral("%1%2?%3&signature=%4")
+                            .arg(futuresBaseUrl(testnet, overrideBase),
+                                 futuresApiPath(overrideBase, QStringLiteral("/v1/openOrders")),
+                                 query,
+                                 hmacSha256Hex(apiSecret, query));
     QString requestError;
-    const QJsonDocument document = httpGetJson(url, {}, timeoutMs, &requestError);
-    if (document.isNull() || !document.isObject()) {
+    const QJsonDocument document = httpGetJson(
+        url,
+        {{QByteArrayLiteral("X-MBX-APIKEY"), apiKey.toUtf8()}},
+        timeoutMs,
+        &requestError);
+    if (document.isNull() || !document.isArray()) {
         result.error = requestError.isEmpty() ? QStringLiteral("Unexpected Binance response") : requestError;
         return result;
     }
 
-    const QJsonArray symbols = document.object().value(QStringLiteral("symbols")).toArray();
-    for (const QJsonValue &value : symbols) {
-        const QJsonObject symObj = value.toObject();
-        const QString current = symObj.value(QStringLiteral("symbol")).toString().trimmed().toUpper();
-        if (current != cleanSymbol) {
+    const QJsonArray rows = document.array();
+    result.orders.reserve(rows.size());
+    for (const QJsonValue &value : rows) {
+        const QJsonObject obj = value.toObject();
+        FuturesOpenOrder order;
+        order.orderId = obj.value(QStringLiteral("orderId")).toVariant().toString();
+        order.symbol = obj.value(QStringLiteral("symbol")).toString().trimmed().toUpper();
+        if (order.orderId.isEmpty() || order.symbol.isEmpty()) {
             continue;
         }
+        order.clientOrderId = obj.value(QStringLiteral("clientOrderId")).toString();
+        order.side = obj.value(QStringLiteral("side")).toString().toUpper();
+        order.positionSide = obj.value(QStringLiteral("positionSide")).toString().toUpper();
+        order.type = obj.value(QStringLiteral("type")).toString().toUpper();
+        order.status = obj.value(QStringLiteral("status")).toString().toUpper();
+        parseJsonNumber(obj.value(QStringLiteral("price")), &order.price);
+        parseJsonNumber(obj.value(QStringLiteral("origQty")), &order.origQty);
+        parseJsonNumber(obj.value(QStringLiteral("executedQty")), &order.executedQty);
+        parseJsonNumber(obj.value(QStringLiteral("avgPrice")), &order.avgPrice);
+        order.reduceOnly = obj.value(QStringLiteral("reduceOnly")).toBool(false);
+        order.updateTimeMs = obj.value(QStringLiteral("updateTime")).toVariant().toLongLong();
+        result.orders.append(order);
+    }
+    result.ok = true;
+    return result;
+}
 
-        bool qpOk = false;
-        const int quantityPrecision = symObj.value(QStringLiteral("quantityPrecision")).toVariant().toInt(&qpOk);
-        result.quantityPrecision = qpOk ? std::max(0, quantityPrecision) : 0;
-        bool ppOk = false;
-        const int pricePrecision = symObj.value(QStringLiteral("pricePrecision")).toVariant().toInt(&ppOk);
-        result.pricePrecision = ppOk ? std::max(0, pricePrecision) : 0;
-
-        double lotStepSize = 0.0;
-        double lotMinQty = 0.0;
-        double lotMaxQty = 0.0;
-        double marketStepSize = 0.0;
-        double marketMinQty = 0.0;
-        double marketMaxQty = 0.0;
-        double priceTickSize = 0.0;
-        const QJsonArray filters = symObj.value(QStringLiteral("filters")).toArray();
-        for (const QJsonValue &fValue : filters) {
-            const QJsonObject f = fValue.toObject();
-            const QString filterType = f.value(QStringLiteral("filterType")).toString().trimmed().toUpper();
-            if (filterType == QStringLiteral("LOT_SIZE")) {
-                parseJsonNumber(f.value(QStringLiteral("stepSize")), &lotStepSize);
-                parseJsonNumber(f.value(QStringLiteral("minQty")), &lotMinQty);
-                parseJsonNumber(f.value(QStringLiteral("maxQty")), &lotMaxQty);
-            } else if (filterType == QStringLiteral("MARKET_LOT_SIZE")) {
-                parseJsonNumber(f.value(QStringLiteral("stepSize")), &marketStepSize);
-                parseJsonNumber(f.value(QStringLiteral("minQty")), &marketMinQty);
-                parseJsonNumber(f.value(QStringLiteral("maxQty")), &marketMaxQty);
-            } else if (filterType == QStringLiteral("MIN_NOTIONAL")
-                       || filterType == QStringLiteral("NOTIONAL")) {
-                if (!parseJsonNumber(f.value(QStringLiteral("notional")), &result.minNotional)) {
-                    parseJsonNumber(f.value(QStringLiteral("minNotional")), &result.minNotional);
-                }
-            } else if (filterType == QStringLiteral("PRICE_FILTER")) {
-                parseJsonNumber(f.value(QStringLiteral("tickSize")), &priceTickSize);
-            }
-        }
+BinanceRestClient::FuturesSymbolFilters BinanceRestClient::fetchFuturesSymbolFilters(
+    const QString &symbol,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride) {
+    FuturesSymbolFilters result;
+    const QString cleanSymbol = symbol.trimmed().toUpper();
+    if (cleanSymbol.isEmpty()) {
+        result.error = QStringLiteral("Symbol is required");
+        return result;
+    }
 
-        result.stepSize = marketStepSize > 0.0 ? marketStepSize : lotStepSize;
-        result.tickSize = std::max(0.0, priceTickSize);
-        result.minQty = marketMinQty > 0.0 ? marketMinQty : lotMinQty;
-        result.maxQty = marketMaxQty > 0.0 ? marketMaxQty : lotMaxQty;
-        result.stepSize = std::max(0.0, result.stepSize);
-        result.minQty = std::max(0.0, result.minQty);
-        result.maxQty = std::max(0.0, result.maxQty);
-        result.minNotional = std::max(0.0, result.minNotional);
-        result.ok = true;
+    QString requestError;
+    const NativeExchangeInfo::SnapshotPtr exchangeInfo =
+        exchangeInfoSnapshot(true, testnet, timeoutMs, baseUrlOverride, &requestError);
+    if (!exchangeInfo) {
+        result.error = requestError;
         return result;
     }
+    if (const NativeExchangeInfo::SymbolInfo *info = exchangeInfo->find(cleanSymbol)) {
+        return info->filters;
+    }
 
+    // Possibly listed after the cached snapshot was taken.
+    NativeExchangeInfo::markStale(klineStoreMarket(true, testnet, baseUrlOverride.trimmed()));
     result.error = QStringLiteral("Symbol %1 not found in futures exchangeInfo").arg(cleanSymbol);
     return result;
 }
@@ -1310,6 +1636,7 @@ BinanceRestClient::FuturesOrderResult BinanceRestClient::placeFuturesMarketOrder
         &requestError);
     if (doc.isNull() || !doc.isObject()) {
         result.error = requestError.isEmpty() ? QStringLiteral("Unexpected Binance order response") : requestError;
+        noteFuturesOrderRejection(result.error, testnet, overrideBase);
         return result;
     }
 
@@ -1317,6 +1644,7 @@ BinanceRestClient::FuturesOrderResult BinanceRestClient::placeFuturesMarketOrder
     if (obj.contains(QStringLiteral("code")) || obj.contains(QStringLiteral("msg"))) {
         result.error = QStringLiteral("Binance order error: %1")
                            .arg(obj.value(QStringLiteral("msg")).toString(QStringLiteral("unknown")));
+        noteFuturesOrderRejection(result.error, testnet, overrideBase);
         return result;
     }
 
@@ -1409,6 +1737,7 @@ BinanceRestClient::FuturesOrderResult BinanceRestClient::placeFuturesLimitOrder(
         &requestError);
     if (doc.isNull() || !doc.isObject()) {
         result.error = requestError.isEmpty() ? QStringLiteral("Unexpected Binance order response") : requestError;
+        noteFuturesOrderRejection(result.error, testnet, overrideBase);
         return result;
     }
 
@@ -1416,6 +1745,7 @@ BinanceRestClient::FuturesOrderResult BinanceRestClient::placeFuturesLimitOrder(
     if (obj.contains(QStringLiteral("code")) || obj.contains(QStringLiteral("msg"))) {
         result.error = QStringLiteral("Binance order error: %1")
                            .arg(obj.value(QStringLiteral("msg")).toString(QStringLiteral("unknown")));
+        noteFuturesOrderRejection(result.error, testnet, overrideBase);
         return result;
     }
 
@@ -1432,3 +1762,27 @@ BinanceRestClient::FuturesOrderResult BinanceRestClient::placeFuturesLimitOrder(
     result.ok = true;
     return result;
 }
+
+BinanceRestClient::ListenKeyResult BinanceRestClient::createFuturesListenKey(
+    const QString &apiKey,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride) {
+    return futuresListenKeyRequest(QStringLiteral("POST"), apiKey, testnet, timeoutMs, baseUrlOverride);
+}
+
+BinanceRestClient::ListenKeyResult BinanceRestClient::keepAliveFuturesListenKey(
+    const QString &apiKey,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride) {
+    return futuresListenKeyRequest(QStringLiteral("PUT"), apiKey, testnet, timeoutMs, baseUrlOverride);
+}
+
+BinanceRestClient::ListenKeyResult BinanceRestClient::closeFuturesListenKey(
+    const QString &apiKey,
+    bool testnet,
+    int timeoutMs,
+    const QString &baseUrlOverride) {
+    return futuresListenKeyRequest(QStringLiteral("DELETE"), apiKey, testnet, timeoutMs, baseUrlOverride);
+}
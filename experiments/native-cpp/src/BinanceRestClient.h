@@ -76,6 +76,30 @@ public:
         QString error;
     };
 
+    // A resting order from GET /fapi/v1/openOrders; the user-data stream
+    // keeps the same shape up to date from ORDER_TRADE_UPDATE.
+    struct FuturesOpenOrder {
+        QString symbol;
+        QString orderId;
+        QString clientOrderId;
+        QString side;
+        QString positionSide;
+        QString type;
+        QString status;
+        double price = 0.0;
+        double origQty = 0.0;
+        double executedQty = 0.0;
+        double avgPrice = 0.0;
+        bool reduceOnly = false;
+        qint64 updateTimeMs = 0;
+    };
+
+    struct FuturesOpenOrdersResult {
+        bool ok = false;
+        QVector<FuturesOpenOrder> orders;
+        QString error;
+    };
+
     struct FuturesSymbolFilters {
         bool ok = false;
         double stepSize = 0.0;
@@ -88,6 +112,13 @@ public:
         QString error;
     };
 
+    // listenKey of a futures user-data stream; empty after a close.
+    struct ListenKeyResult {
+        bool ok = false;
+        QString listenKey;
+        QString error;
+    };
+
     struct FuturesOrderResult {
         bool ok = false;
         QString symbol;
@@ -127,6 +158,11 @@ public:
         qint64 startTimeMs = 0,
         qint64 endTimeMs = 0);
 
+    // Pages [startTimeMs, endTimeMs] from the exchange, several pages at a
+    // time within the market's request-weight budget. When a kline store
+    // directory is set, closed candles are kept there and only the ranges not
+    // yet stored are requested; custom intervals are aggregated locally from
+    // the stored base interval.
     static KlinesResult fetchKlinesRange(
         const QString &symbol,
         const QString &interval,
@@ -139,6 +175,10 @@ public:
         const QString &baseUrlOverride = {},
         const std::function<bool()> &shouldStop = {});
 
+    // Root of the on-disk kline store; empty (the default) disables it.
+    static void setKlineStoreDirectory(const QString &directory);
+    static QString klineStoreDirectory();
+
     static TickerPriceResult fetchTickerPrice(
         const QString &symbol,
         bool futures,
@@ -153,6 +193,14 @@ public:
         int timeoutMs = 10000,
         const QString &baseUrlOverride = {});
 
+    // Every open order of the account, all symbols.
+    static FuturesOpenOrdersResult fetchOpenFuturesOrders(
+        const QString &apiKey,
+        const QString &apiSecret,
+        bool testnet,
+        int timeoutMs = 10000,
+        const QString &baseUrlOverride = {});
+
     static FuturesSymbolFilters fetchFuturesSymbolFilters(
         const QString &symbol,
         bool testnet,
@@ -185,6 +233,26 @@ public:
         int timeoutMs = 10000,
         const QString &baseUrlOverride = {});
 
+    // Futures user-data stream keys: created (or the active one returned),
+    // extended by another 60 minutes, or closed. API key only, unsigned.
+    static ListenKeyResult createFuturesListenKey(
+        const QString &apiKey,
+        bool testnet,
+        int timeoutMs = 10000,
+        const QString &baseUrlOverride = {});
+
+    static ListenKeyResult keepAliveFuturesListenKey(
+        const QString &apiKey,
+        bool testnet,
+        int timeoutMs = 10000,
+        const QString &baseUrlOverride = {});
+
+    static ListenKeyResult closeFuturesListenKey(
+        const QString &apiKey,
+        bool testnet,
+        int timeoutMs = 10000,
+        const QString &baseUrlOverride = {});
+
 private:
     static QString hmacSha256Hex(const QString &secret, const QString &message);
     static QJsonDocument httpGetJson(
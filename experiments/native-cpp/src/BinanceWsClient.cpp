@@ -1,19 +1,102 @@
 #include "BinanceWsClient.h"
 
+#include "NativeStreamFrameScanner.h"
+
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMetaMethod>
 #include <QUrl>
 
 #if HAS_QT_WEBSOCKETS
+#include <QTimer>
 #include <QWebSocket>
 #endif
 
+#include <algorithm>
+
 namespace {
+using NativeStreamFrameScanner::ScannedFrame;
+
+#if HAS_QT_WEBSOCKETS
+BinanceWsClient::Tick scannedTick(const ScannedFrame &scanned, QStringView symbol) {
+    BinanceWsClient::Tick tick;
+    tick.symbolId = NativeSymbolTable::find(symbol);
+    if (scanned.type == ScannedFrame::Type::Kline) {
+        tick.type = BinanceWsClient::Tick::Type::Kline;
+        tick.openTimeMs = scanned.openTimeMs;
+        tick.open = scanned.open;
+        tick.high = scanned.high;
+        tick.low = scanned.low;
+        tick.close = scanned.close;
+        tick.volume = scanned.volume;
+        tick.isClosed = scanned.isClosed;
+    } else {
+        tick.type = BinanceWsClient::Tick::Type::BookTicker;
+        tick.bidPrice = scanned.bidPrice;
+        tick.askPrice = scanned.askPrice;
+    }
+    return tick;
+}
+
+// The tick of a frame the scanner left to the JSON decoder; false for
+// replies and frames that carry no market update.
+bool decodedTick(const BinanceWsClient::StreamFrame &frame, BinanceWsClient::Tick *tick) {
+    using Type = BinanceWsClient::StreamFrame::Type;
+    if (frame.type == Type::Kline) {
+        tick->type = BinanceWsClient::Tick::Type::Kline;
+    } else if (frame.type == Type::BookTicker) {
+        tick->type = BinanceWsClient::Tick::Type::BookTicker;
+    } else if (frame.type == Type::MarkPrice) {
+        tick->type = BinanceWsClient::Tick::Type::MarkPrice;
+    } else {
+        return false;
+    }
+    tick->symbolId = NativeSymbolTable::find(frame.symbol);
+    tick->openTimeMs = frame.openTimeMs;
+    tick->open = frame.open;
+    tick->high = frame.high;
+    tick->low = frame.low;
+    tick->close = frame.close;
+    tick->volume = frame.volume;
+    tick->isClosed = frame.isClosed;
+    tick->bidPrice = frame.bidPrice;
+    tick->askPrice = frame.askPrice;
+    tick->markPrice = frame.markPrice;
+    tick->eventTimeMs = frame.eventTimeMs;
+    return true;
+}
+#endif
+
 QString normalizedStreamSymbol(const QString &symbol) {
     QString stream = symbol.trimmed().toLower();
     stream.remove(' ');
     return stream;
 }
+
+// Endpoint root without the /ws or /stream suffix.
+QString streamHost(bool futures, bool testnet) {
+    const QString override = BinanceWsClient::streamHostOverride();
+    if (!override.isEmpty()) {
+        return override;
+    }
+    return futures
+        ? (testnet ? QStringLiteral("wss://stream.binancefuture.com")
+                   : QStringLiteral("wss://fstream.binance.com"))
+        : (testnet ? QStringLiteral("wss://testnet.binance.vision")
+                   : QStringLiteral("wss://stream.binance.com:9443"));
+}
+
+#if HAS_QT_WEBSOCKETS
+// Spot accepts 5 incoming frames per second per connection and futures 10;
+// batching SUBSCRIBE/UNSUBSCRIBE changes on this interval stays under both.
+constexpr int kSubscriptionFlushMs = 500;
+// Streams carried in the opening URL; the rest follow as a SUBSCRIBE frame so
+// a full connection does not produce a multi-kilobyte request line.
+constexpr int kMaxStreamsInUrl = 64;
+constexpr int kReconnectBaseMs = 1000;
+constexpr int kReconnectMaxMs = 30000;
+#endif
 } // namespace
 
 BinanceWsClient::BinanceWsClient(QObject *parent)
@@ -26,45 +109,7 @@ BinanceWsClient::BinanceWsClient(QObject *parent)
     socket_->setParent(this);
     connect(socket_, &QWebSocket::connected, this, &BinanceWsClient::connected);
     connect(socket_, &QWebSocket::disconnected, this, &BinanceWsClient::disconnected);
-    connect(socket_, &QWebSocket::textMessageReceived, this, [this](const QString &message) {
-        QJsonParseError parseError{};
-        const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &parseError);
-        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
-            return;
-        }
-        const QJsonObject obj = doc.object();
-        const QJsonObject klineObj = obj.value(QStringLiteral("k")).toObject();
-        if (!klineObj.isEmpty()) {
-            const QString symbol = klineObj.value(QStringLiteral("s")).toString(obj.value(QStringLiteral("s")).toString());
-            const QString interval = klineObj.value(QStringLiteral("i")).toString();
-            bool openTimeOk = false;
-            const qint64 openTimeMs = klineObj.value(QStringLiteral("t")).toVariant().toLongLong(&openTimeOk);
-            bool openOk = false;
-            bool highOk = false;
-            bool lowOk = false;
-            bool closeOk = false;
-            bool volumeOk = false;
-            const double open = klineObj.value(QStringLiteral("o")).toVariant().toDouble(&openOk);
-            const double high = klineObj.value(QStringLiteral("h")).toVariant().toDouble(&highOk);
-            const double low = klineObj.value(QStringLiteral("l")).toVariant().toDouble(&lowOk);
-            const double close = klineObj.value(QStringLiteral("c")).toVariant().toDouble(&closeOk);
-            const double volume = klineObj.value(QStringLiteral("v")).toVariant().toDouble(&volumeOk);
-            const bool isClosed = klineObj.value(QStringLiteral("x")).toBool(false);
-            if (!symbol.isEmpty() && !interval.isEmpty() && openTimeOk && openOk && highOk && lowOk && closeOk && volumeOk) {
-                emit kline(symbol, interval, openTimeMs, open, high, low, close, volume, isClosed);
-            }
-            return;
-        }
-
-        const QString symbol = obj.value(QStringLiteral("s")).toString();
-        bool bidOk = false;
-        bool askOk = false;
-        const double bid = obj.value(QStringLiteral("b")).toVariant().toDouble(&bidOk);
-        const double ask = obj.value(QStringLiteral("a")).toVariant().toDouble(&askOk);
-        if (!symbol.isEmpty() && bidOk && askOk) {
-            emit bookTicker(symbol, bid, ask);
-        }
-    });
+    connect(socket_, &QWebSocket::textMessageReceived, this, &BinanceWsClient::handleRawMessage);
     connect(
         socket_,
         qOverload<QAbstractSocket::SocketError>(&QWebSocket::errorOccurred),
@@ -75,6 +120,9 @@ BinanceWsClient::BinanceWsClient(QObject *parent)
 
 BinanceWsClient::~BinanceWsClient() {
     disconnectFromStream();
+#if HAS_QT_WEBSOCKETS
+    unsubscribeAll();
+#endif
 }
 
 void BinanceWsClient::connectBookTicker(const QString &symbol, bool futures, bool testnet) {
@@ -89,11 +137,7 @@ void BinanceWsClient::connectBookTicker(const QString &symbol, bool futures, boo
         return;
     }
     const QString stream = streamSymbol + QStringLiteral("@bookTicker");
-    const QString base = futures
-        ? (testnet ? QStringLiteral("wss://stream.binancefuture.com/ws")
-                   : QStringLiteral("wss://fstream.binance.com/ws"))
-        : (testnet ? QStringLiteral("wss://testnet.binance.vision/ws")
-                   : QStringLiteral("wss://stream.binance.com:9443/ws"));
+    const QString base = streamHost(futures, testnet) + QStringLiteral("/ws");
     const QUrl url(base + QStringLiteral("/") + stream);
     if (socket_->state() != QAbstractSocket::UnconnectedState) {
         socket_->close();
@@ -121,11 +165,7 @@ void BinanceWsClient::connectKline(const QString &symbol, const QString &interva
         return;
     }
     const QString stream = streamSymbol + QStringLiteral("@kline_") + streamInterval;
-    const QString base = futures
-        ? (testnet ? QStringLiteral("wss://stream.binancefuture.com/ws")
-                   : QStringLiteral("wss://fstream.binance.com/ws"))
-        : (testnet ? QStringLiteral("wss://testnet.binance.vision/ws")
-                   : QStringLiteral("wss://stream.binance.com:9443/ws"));
+    const QString base = streamHost(futures, testnet) + QStringLiteral("/ws");
     const QUrl url(base + QStringLiteral("/") + stream);
     if (socket_->state() != QAbstractSocket::UnconnectedState) {
         socket_->close();
@@ -147,3 +187,559 @@ void BinanceWsClient::disconnectFromStream() {
     }
 #endif
 }
+
+QString BinanceWsClient::klineStreamName(const QString &symbol, const QString &interval) {
+    const QString streamSymbol = normalizedStreamSymbol(symbol);
+    QString streamInterval = interval.trimmed();
+    streamInterval.remove(' ');
+    // Binance stream names are lower case except the month interval ("1M").
+    if (!streamInterval.endsWith('M')) {
+        streamInterval = streamInterval.toLower();
+    }
+    if (streamSymbol.isEmpty() || streamInterval.isEmpty()) {
+        return {};
+    }
+    return streamSymbol + QStringLiteral("@kline_") + streamInterval;
+}
+
+QString BinanceWsClient::bookTickerStreamName(const QString &symbol) {
+    const QString streamSymbol = normalizedStreamSymbol(symbol);
+    return streamSymbol.isEmpty() ? QString() : streamSymbol + QStringLiteral("@bookTicker");
+}
+
+QString BinanceWsClient::markPriceStreamName(const QString &symbol) {
+    const QString streamSymbol = normalizedStreamSymbol(symbol);
+    return streamSymbol.isEmpty() ? QString() : streamSymbol + QStringLiteral("@markPrice@1s");
+}
+
+QString BinanceWsClient::combinedStreamBaseUrl(bool futures, bool testnet) {
+    return streamHost(futures, testnet) + QStringLiteral("/stream");
+}
+
+QString BinanceWsClient::streamHostOverride() {
+    QString host = qEnvironmentVariable("TB_BINANCE_STREAM_BASE_URL").trimmed();
+    while (host.endsWith(QLatin1Char('/'))) {
+        host.chop(1);
+    }
+    return host;
+}
+
+BinanceWsClient::StreamFrame BinanceWsClient::parseStreamFrame(const QString &message) {
+    const ScannedFrame scanned = NativeStreamFrameScanner::scan(QStringView(message));
+    if (scanned.type == ScannedFrame::Type::Unrecognized) {
+        return parseStreamFrameJson(message);
+    }
+    const auto text = [&message](NativeStreamFrameScanner::TextSpan span) {
+        return message.mid(span.offset, span.length);
+    };
+    StreamFrame frame;
+    frame.stream = text(scanned.stream);
+    frame.symbol = text(scanned.symbol);
+    if (scanned.type == ScannedFrame::Type::Kline) {
+        frame.type = StreamFrame::Type::Kline;
+        frame.interval = text(scanned.interval);
+        frame.openTimeMs = scanned.openTimeMs;
+        frame.open = scanned.open;
+        frame.high = scanned.high;
+        frame.low = scanned.low;
+        frame.close = scanned.close;
+        frame.volume = scanned.volume;
+        frame.isClosed = scanned.isClosed;
+    } else {
+        frame.type = StreamFrame::Type::BookTicker;
+        frame.bidPrice = scanned.bidPrice;
+        frame.askPrice = scanned.askPrice;
+    }
+    return frame;
+}
+
+BinanceWsClient::StreamFrame BinanceWsClient::parseStreamFrameJson(const QString &message) {
+    StreamFrame frame;
+    QJsonParseError parseError{};
+    const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        return frame;
+    }
+    const QJsonObject root = doc.object();
+    const QJsonValue dataValue = root.value(QStringLiteral("data"));
+    const bool combined = dataValue.isObject();
+    const QJsonObject obj = combined ? dataValue.toObject() : root;
+    if (combined) {
+        frame.stream = root.value(QStringLiteral("stream")).toString();
+    }
+
+    const QJsonObject klineObj = obj.value(QStringLiteral("k")).toObject();
+    if (!klineObj.isEmpty()) {
+        frame.symbol = klineObj.value(QStringLiteral("s")).toString(obj.value(QStringLiteral("s")).toString());
+        frame.interval = klineObj.value(QStringLiteral("i")).toString();
+        bool openTimeOk = false;
+        frame.openTimeMs = klineObj.value(QStringLiteral("t")).toVariant().toLongLong(&openTimeOk);
+        bool openOk = false;
+        bool highOk = false;
+        bool lowOk = false;
+        bool closeOk = false;
+        bool volumeOk = false;
+        frame.open = klineObj.value(QStringLiteral("o")).toVariant().toDouble(&openOk);
+        frame.high = klineObj.value(QStringLiteral("h")).toVariant().toDouble(&highOk);
+        frame.low = klineObj.value(QStringLiteral("l")).toVariant().toDouble(&lowOk);
+        frame.close = klineObj.value(QStringLiteral("c")).toVariant().toDouble(&closeOk);
+        frame.volume = klineObj.value(QStringLiteral("v")).toVariant().toDouble(&volumeOk);
+        frame.isClosed = klineObj.value(QStringLiteral("x")).toBool(false);
+        if (!frame.symbol.isEmpty() && !frame.interval.isEmpty()
+            && openTimeOk && openOk && highOk && lowOk && closeOk && volumeOk) {
+            frame.type = StreamFrame::Type::Kline;
+        }
+        return frame;
+    }
+
+    frame.symbol = obj.value(QStringLiteral("s")).toString();
+    bool bidOk = false;
+    bool askOk = false;
+    frame.bidPrice = obj.value(QStringLiteral("b")).toVariant().toDouble(&bidOk);
+    frame.askPrice = obj.value(QStringLiteral("a")).toVariant().toDouble(&askOk);
+    if (!frame.symbol.isEmpty() && bidOk && askOk) {
+        frame.type = StreamFrame::Type::BookTicker;
+        return frame;
+    }
+    // After the book check, so frames the scanner reads as bookTicker decode
+    // the same way here.
+    if (obj.value(QStringLiteral("e")).toString() == QStringLiteral("markPriceUpdate")) {
+        bool markOk = false;
+        frame.markPrice = obj.value(QStringLiteral("p")).toVariant().toDouble(&markOk);
+        frame.eventTimeMs = obj.value(QStringLiteral("E")).toVariant().toLongLong();
+        if (!frame.symbol.isEmpty() && markOk) {
+            frame.type = StreamFrame::Type::MarkPrice;
+        }
+        return frame;
+    }
+    if (combined) {
+        return frame;
+    }
+
+    // {"result":null,"id":N} acknowledges a frame; {"error":{...},"id":N}
+    // rejects it.
+    frame.type = StreamFrame::Type::Reply;
+    frame.requestId = root.value(QStringLiteral("id")).toVariant().toLongLong();
+    const QJsonObject errorObj = root.value(QStringLiteral("error")).toObject();
+    frame.rejected = !errorObj.isEmpty();
+    if (frame.rejected) {
+        frame.errorCode = errorObj.value(QStringLiteral("code")).toVariant().toString();
+        frame.errorMessage = errorObj.value(QStringLiteral("msg")).toString();
+    }
+    return frame;
+}
+
+int BinanceWsClient::defaultMaxStreamsPerConnection(bool futures) {
+    return futures ? 200 : 1024;
+}
+
+void BinanceWsClient::setMaxStreamsPerConnection(int maxStreams) {
+    maxStreamsPerConnection_ = std::max(0, maxStreams);
+}
+
+void BinanceWsClient::setCombinedStreamBaseUrlOverride(const QString &baseUrl) {
+    combinedBaseUrlOverride_ = baseUrl.trimmed();
+}
+
+bool BinanceWsClient::subscribe(const QString &key, const QString &stream, bool futures, bool testnet) {
+#if HAS_QT_WEBSOCKETS
+    const QString streamName = stream.trimmed();
+    if (key.isEmpty() || streamName.isEmpty()) {
+        emit subscriptionError(key, QStringLiteral("Stream name is empty."));
+        return false;
+    }
+    const QString baseUrl = combinedBaseUrlOverride_.isEmpty()
+        ? combinedStreamBaseUrl(futures, testnet)
+        : combinedBaseUrlOverride_;
+    const auto existing = subscriptions_.constFind(key);
+    if (existing != subscriptions_.cend()
+        && existing->stream == streamName
+        && existing->connection->baseUrl == baseUrl) {
+        return true;
+    }
+    unsubscribe(key);
+
+    StreamConnection *connection = connectionFor(baseUrl, futures, streamName);
+    QStringList &keys = connection->subscribers[streamName];
+    keys.append(key);
+    subscriptions_.insert(key, Subscription{streamName, connection});
+    if (!connection->socket) {
+        openConnection(connection);
+    } else if (keys.size() == 1) {
+        scheduleFlush(connection);
+    }
+    return true;
+#else
+    Q_UNUSED(stream)
+    Q_UNUSED(futures)
+    Q_UNUSED(testnet)
+    emit subscriptionError(key, QStringLiteral("Qt WebSockets module is not available in this build."));
+    return false;
+#endif
+}
+
+void BinanceWsClient::unsubscribe(const QString &key) {
+#if HAS_QT_WEBSOCKETS
+    const auto it = subscriptions_.find(key);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+    const Subscription subscription = it.value();
+    subscriptions_.erase(it);
+    StreamConnection *connection = subscription.connection;
+    auto keysIt = connection->subscribers.find(subscription.stream);
+    if (keysIt == connection->subscribers.end()) {
+        return;
+    }
+    keysIt->removeAll(key);
+    if (!keysIt->isEmpty()) {
+        return;
+    }
+    connection->subscribers.erase(keysIt);
+    if (connection->subscribers.isEmpty()) {
+        closeConnection(connection);
+    } else {
+        scheduleFlush(connection);
+    }
+#else
+    Q_UNUSED(key)
+#endif
+}
+
+void BinanceWsClient::unsubscribeAll() {
+#if HAS_QT_WEBSOCKETS
+    subscriptions_.clear();
+    while (!connections_.isEmpty()) {
+        StreamConnection *connection = connections_.constLast();
+        connection->subscribers.clear();
+        closeConnection(connection);
+    }
+#endif
+}
+
+bool BinanceWsClient::isSubscribed(const QString &key) const {
+#if HAS_QT_WEBSOCKETS
+    return subscriptions_.contains(key);
+#else
+    Q_UNUSED(key)
+    return false;
+#endif
+}
+
+QString BinanceWsClient::subscribedStream(const QString &key) const {
+#if HAS_QT_WEBSOCKETS
+    return subscriptions_.value(key).stream;
+#else
+    Q_UNUSED(key)
+    return {};
+#endif
+}
+
+int BinanceWsClient::subscriberCount() const {
+#if HAS_QT_WEBSOCKETS
+    return static_cast<int>(subscriptions_.size());
+#else
+    return 0;
+#endif
+}
+
+int BinanceWsClient::streamCount() const {
+#if HAS_QT_WEBSOCKETS
+    int count = 0;
+    for (const StreamConnection *connection : connections_) {
+        count += static_cast<int>(connection->subscribers.size());
+    }
+    return count;
+#else
+    return 0;
+#endif
+}
+
+int BinanceWsClient::connectionCount() const {
+#if HAS_QT_WEBSOCKETS
+    return static_cast<int>(connections_.size());
+#else
+    return 0;
+#endif
+}
+
+#if HAS_QT_WEBSOCKETS
+void BinanceWsClient::dispatchTick(const Tick &tick, TickText text, const QStringList *keys) {
+    if (keys) {
+        for (const QString &key : *keys) {
+            emit subscriptionTick(key, tick);
+        }
+    }
+    const auto listening = [this](auto signal) { return isSignalConnected(QMetaMethod::fromSignal(signal)); };
+    switch (tick.type) {
+    case Tick::Type::Kline:
+        if (!keys) {
+            emit kline(text.symbol.toString(), text.interval.toString(), tick.openTimeMs, tick.open, tick.high,
+                       tick.low, tick.close, tick.volume, tick.isClosed);
+        } else if (listening(&BinanceWsClient::subscriptionKline)) {
+            const QString symbol = text.symbol.toString();
+            const QString interval = text.interval.toString();
+            for (const QString &key : *keys) {
+                emit subscriptionKline(key, symbol, interval, tick.openTimeMs, tick.open, tick.high, tick.low,
+                                       tick.close, tick.volume, tick.isClosed);
+            }
+        }
+        return;
+    case Tick::Type::BookTicker:
+        if (!keys) {
+            emit bookTicker(text.symbol.toString(), tick.bidPrice, tick.askPrice);
+        } else if (listening(&BinanceWsClient::subscriptionBookTicker)) {
+            const QString symbol = text.symbol.toString();
+            for (const QString &key : *keys) {
+                emit subscriptionBookTicker(key, symbol, tick.bidPrice, tick.askPrice);
+            }
+        }
+        return;
+    case Tick::Type::MarkPrice:
+        // Mark prices are only subscribed through the multiplexer.
+        if (keys && listening(&BinanceWsClient::subscriptionMarkPrice)) {
+            const QString symbol = text.symbol.toString();
+            for (const QString &key : *keys) {
+                emit subscriptionMarkPrice(key, symbol, tick.markPrice, tick.eventTimeMs);
+            }
+        }
+        return;
+    }
+}
+
+void BinanceWsClient::handleRawMessage(const QString &message) {
+    const ScannedFrame scanned = NativeStreamFrameScanner::scan(QStringView(message));
+    if (scanned.type != ScannedFrame::Type::Unrecognized) {
+        const QStringView symbol = QStringView(message).sliced(scanned.symbol.offset, scanned.symbol.length);
+        const QStringView interval = QStringView(message).sliced(scanned.interval.offset, scanned.interval.length);
+        dispatchTick(scannedTick(scanned, symbol), {symbol, interval}, nullptr);
+        return;
+    }
+    const StreamFrame frame = parseStreamFrameJson(message);
+    Tick tick;
+    if (decodedTick(frame, &tick)) {
+        dispatchTick(tick, {frame.symbol, frame.interval}, nullptr);
+    }
+}
+
+void BinanceWsClient::handleCombinedMessage(StreamConnection *connection, const QString &message) {
+    // The hot path: scanned kline and bookTicker frames are routed by a view
+    // of their stream name and reach subscribers as Ticks.
+    const ScannedFrame scanned = NativeStreamFrameScanner::scan(QStringView(message));
+    if (scanned.type != ScannedFrame::Type::Unrecognized) {
+        const QStringView text(message);
+        const auto route = connection->subscribers.constFind(text.sliced(scanned.stream.offset, scanned.stream.length));
+        if (route == connection->subscribers.cend() || route->isEmpty()) {
+            return;
+        }
+        // Copied: a subscriber may unsubscribe (and close this connection)
+        // from inside its slot.
+        const QStringList keys = route.value();
+        const QStringView symbol = text.sliced(scanned.symbol.offset, scanned.symbol.length);
+        const QStringView interval = text.sliced(scanned.interval.offset, scanned.interval.length);
+        dispatchTick(scannedTick(scanned, symbol), {symbol, interval}, &keys);
+        return;
+    }
+
+    const StreamFrame frame = parseStreamFrameJson(message);
+    Tick tick;
+    if (decodedTick(frame, &tick)) {
+        const QStringList keys = connection->subscribers.value(frame.stream);
+        if (!keys.isEmpty()) {
+            dispatchTick(tick, {frame.symbol, frame.interval}, &keys);
+        }
+        return;
+    }
+    if (frame.type != StreamFrame::Type::Reply) {
+        return;
+    }
+
+    const QStringList requested = connection->pendingSubscribes.take(frame.requestId);
+    if (!frame.rejected) {
+        return;
+    }
+    const QString errorText = QStringLiteral("Stream subscription rejected (%1): %2")
+                                  .arg(frame.errorCode, frame.errorMessage);
+    QStringList affectedKeys;
+    for (const QString &stream : requested) {
+        connection->liveStreams.remove(stream);
+        affectedKeys += connection->subscribers.value(stream);
+    }
+    if (requested.isEmpty()) {
+        emit errorOccurred(errorText);
+        return;
+    }
+    for (const QString &key : affectedKeys) {
+        emit subscriptionError(key, errorText);
+    }
+}
+
+int BinanceWsClient::streamLimitFor(const StreamConnection *connection) const {
+    return maxStreamsPerConnection_ > 0
+        ? maxStreamsPerConnection_
+        : defaultMaxStreamsPerConnection(connection->futures);
+}
+
+BinanceWsClient::StreamConnection *BinanceWsClient::connectionFor(
+    const QString &baseUrl,
+    bool futures,
+    const QString &stream) {
+    StreamConnection *withRoom = nullptr;
+    for (StreamConnection *connection : connections_) {
+        if (connection->baseUrl != baseUrl) {
+            continue;
+        }
+        if (connection->subscribers.contains(stream)) {
+            return connection;
+        }
+        if (!withRoom && connection->subscribers.size() < streamLimitFor(connection)) {
+            withRoom = connection;
+        }
+    }
+    if (withRoom) {
+        return withRoom;
+    }
+    auto *connection = new StreamConnection;
+    connection->baseUrl = baseUrl;
+    connection->futures = futures;
+    connections_.append(connection);
+    return connection;
+}
+
+void BinanceWsClient::openConnection(StreamConnection *connection) {
+    if (!connection->socket) {
+        connection->socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+        connection->flushTimer = new QTimer(connection->socket);
+        connection->flushTimer->setSingleShot(true);
+        connection->flushTimer->setInterval(kSubscriptionFlushMs);
+        connection->reconnectTimer = new QTimer(connection->socket);
+        connection->reconnectTimer->setSingleShot(true);
+
+        QWebSocket *socket = connection->socket;
+        connect(connection->flushTimer, &QTimer::timeout, this, [this, connection]() {
+            flushConnection(connection);
+        });
+        connect(connection->reconnectTimer, &QTimer::timeout, this, [this, connection]() {
+            openConnection(connection);
+        });
+        connect(socket, &QWebSocket::connected, this, [this, connection]() {
+            connection->reconnectAttempts = 0;
+            flushConnection(connection);
+        });
+        connect(socket, &QWebSocket::textMessageReceived, this, [this, connection](const QString &message) {
+            handleCombinedMessage(connection, message);
+        });
+        connect(socket, &QWebSocket::disconnected, this, [this, connection]() {
+            // Binance drops every connection after 24 hours; resubscribe
+            // everything on a fresh socket with capped backoff.
+            connection->liveStreams.clear();
+            connection->pendingSubscribes.clear();
+            connection->flushTimer->stop();
+            if (connection->subscribers.isEmpty() || connection->reconnectTimer->isActive()) {
+                return;
+            }
+            const int shift = std::min(connection->reconnectAttempts, 5);
+            ++connection->reconnectAttempts;
+            connection->reconnectTimer->start(std::min(kReconnectMaxMs, kReconnectBaseMs << shift));
+        });
+        connect(
+            socket,
+            qOverload<QAbstractSocket::SocketError>(&QWebSocket::errorOccurred),
+            this,
+            [this, connection](QAbstractSocket::SocketError) {
+                notifyConnectionError(connection, connection->socket->errorString());
+            });
+    }
+
+    if (connection->socket->state() != QAbstractSocket::UnconnectedState) {
+        connection->socket->abort();
+    }
+    connection->reconnectTimer->stop();
+    QStringList urlStreams = connection->subscribers.keys();
+    std::sort(urlStreams.begin(), urlStreams.end());
+    if (urlStreams.size() > kMaxStreamsInUrl) {
+        urlStreams.resize(kMaxStreamsInUrl);
+    }
+    connection->liveStreams = QSet<QString>(urlStreams.cbegin(), urlStreams.cend());
+    connection->pendingSubscribes.clear();
+    connection->socket->open(QUrl(connection->baseUrl + QStringLiteral("?streams=") + urlStreams.join('/')));
+}
+
+void BinanceWsClient::scheduleFlush(StreamConnection *connection) {
+    if (connection->flushTimer && !connection->flushTimer->isActive()) {
+        connection->flushTimer->start();
+    }
+}
+
+void BinanceWsClient::flushConnection(StreamConnection *connection) {
+    if (!connection->socket || connection->socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    QStringList toSubscribe;
+    for (auto it = connection->subscribers.cbegin(); it != connection->subscribers.cend(); ++it) {
+        if (!connection->liveStreams.contains(it.key())) {
+            toSubscribe.append(it.key());
+        }
+    }
+    QStringList toUnsubscribe;
+    for (const QString &stream : std::as_const(connection->liveStreams)) {
+        if (!connection->subscribers.contains(stream)) {
+            toUnsubscribe.append(stream);
+        }
+    }
+    const auto sendFrame = [connection](const QString &method, const QStringList &streams) {
+        const qint64 id = connection->nextRequestId++;
+        const QJsonObject frame{
+            {QStringLiteral("method"), method},
+            {QStringLiteral("params"), QJsonArray::fromStringList(streams)},
+            {QStringLiteral("id"), id},
+        };
+        connection->socket->sendTextMessage(
+            QString::fromUtf8(QJsonDocument(frame).toJson(QJsonDocument::Compact)));
+        return id;
+    };
+    if (!toUnsubscribe.isEmpty()) {
+        std::sort(toUnsubscribe.begin(), toUnsubscribe.end());
+        sendFrame(QStringLiteral("UNSUBSCRIBE"), toUnsubscribe);
+        for (const QString &stream : toUnsubscribe) {
+            connection->liveStreams.remove(stream);
+        }
+    }
+    if (!toSubscribe.isEmpty()) {
+        std::sort(toSubscribe.begin(), toSubscribe.end());
+        const qint64 id = sendFrame(QStringLiteral("SUBSCRIBE"), toSubscribe);
+        connection->pendingSubscribes.insert(id, toSubscribe);
+        for (const QString &stream : toSubscribe) {
+            connection->liveStreams.insert(stream);
+        }
+    }
+}
+
+void BinanceWsClient::notifyConnectionError(StreamConnection *connection, const QString &message) {
+    QStringList keys;
+    for (auto it = connection->subscribers.cbegin(); it != connection->subscribers.cend(); ++it) {
+        keys += it.value();
+    }
+    for (const QString &key : keys) {
+        emit subscriptionError(key, message);
+    }
+}
+
+void BinanceWsClient::closeConnection(StreamConnection *connection) {
+    connections_.removeOne(connection);
+    if (QWebSocket *socket = connection->socket) {
+        // The socket's handlers capture the connection, so detach them before
+        // the close can emit anything.
+        socket->disconnect(this);
+        connection->flushTimer->disconnect(this);
+        connection->reconnectTimer->disconnect(this);
+        connection->flushTimer->stop();
+        connection->reconnectTimer->stop();
+        if (socket->state() != QAbstractSocket::UnconnectedState) {
+            socket->close();
+        }
+        socket->deleteLater();
+    }
+    delete connection;
+}
+#endif
@@ -4,10 +4,17 @@
 #define HAS_QT_WEBSOCKETS 0
 #endif
 
+#include "NativeSymbolTable.h"
+
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QVector>
 
 #if HAS_QT_WEBSOCKETS
+class QTimer;
 class QWebSocket;
 #endif
 
@@ -18,10 +25,103 @@ public:
     explicit BinanceWsClient(QObject *parent = nullptr);
     ~BinanceWsClient() override;
 
+    // One decoded text frame: a raw-stream payload, a combined-stream
+    // {"stream":...,"data":...} envelope, or a SUBSCRIBE/UNSUBSCRIBE reply.
+    struct StreamFrame {
+        enum class Type { Invalid, Kline, BookTicker, MarkPrice, Reply };
+        Type type = Type::Invalid;
+        // Combined envelopes only.
+        QString stream;
+        QString symbol;
+        QString interval;
+        qint64 openTimeMs = 0;
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+        bool isClosed = false;
+        double bidPrice = 0.0;
+        double askPrice = 0.0;
+        double markPrice = 0.0;
+        // Exchange event time (E) of mark price updates.
+        qint64 eventTimeMs = 0;
+        // Replies: the request id and, for rejections, the exchange error.
+        qint64 requestId = 0;
+        bool rejected = false;
+        QString errorCode;
+        QString errorMessage;
+    };
+    // Pure decoding, independent of any socket. Kline and bookTicker frames
+    // are read by NativeStreamFrameScanner; everything else goes to
+    // parseStreamFrameJson. Delivery scans frames itself and keeps them as
+    // Ticks; this is the same decoding with the strings materialized.
+    static StreamFrame parseStreamFrame(const QString &message);
+    // The QJsonDocument decoder: the fallback for frames the scanner leaves
+    // Unrecognized and the reference it must agree with.
+    static StreamFrame parseStreamFrameJson(const QString &message);
+
+    // Single raw stream per client; reopening replaces the previous stream.
     void connectBookTicker(const QString &symbol, bool futures, bool testnet);
     void connectKline(const QString &symbol, const QString &interval, bool futures, bool testnet);
     void disconnectFromStream();
 
+    // A market update as the multiplexer routes it: the symbol as its
+    // NativeSymbolTable id and the numbers, no strings. The id is
+    // kInvalidSymbol unless the symbol was interned before the frame came in.
+    struct Tick {
+        enum class Type : quint8 { Kline, BookTicker, MarkPrice };
+        Type type = Type::Kline;
+        NativeSymbolTable::SymbolId symbolId = NativeSymbolTable::kInvalidSymbol;
+        qint64 openTimeMs = 0;
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+        bool isClosed = false;
+        double bidPrice = 0.0;
+        double askPrice = 0.0;
+        double markPrice = 0.0;
+        // Exchange event time (E) of mark price updates.
+        qint64 eventTimeMs = 0;
+    };
+
+    // Combined-stream multiplexing. Subscribers are identified by a caller key
+    // and any number of keys may share one stream. Streams on the same
+    // endpoint share a /stream?streams=a/b/c socket and are added or removed
+    // at runtime with SUBSCRIBE/UNSUBSCRIBE frames; a further socket is only
+    // opened once every existing one holds maxStreamsPerConnection streams.
+    static QString klineStreamName(const QString &symbol, const QString &interval);
+    static QString bookTickerStreamName(const QString &symbol);
+    // Futures only: the symbol's mark price, pushed every second.
+    static QString markPriceStreamName(const QString &symbol);
+    static QString combinedStreamBaseUrl(bool futures, bool testnet);
+    // Stream host (ws://host:port) from TB_BINANCE_STREAM_BASE_URL, standing
+    // in for every Binance stream endpoint, e.g. a local exchange simulator;
+    // empty when unset. Raw streams live under <host>/ws, combined ones under
+    // <host>/stream.
+    static QString streamHostOverride();
+    // Binance's per-connection limit: 200 streams on futures, 1024 on spot.
+    static int defaultMaxStreamsPerConnection(bool futures);
+
+    // Replaces any previous subscription held by key. Returns false when the
+    // stream name is empty or Qt WebSockets is unavailable.
+    bool subscribe(const QString &key, const QString &stream, bool futures, bool testnet);
+    void unsubscribe(const QString &key);
+    void unsubscribeAll();
+    bool isSubscribed(const QString &key) const;
+    QString subscribedStream(const QString &key) const;
+    int subscriberCount() const;
+    int streamCount() const;
+    int connectionCount() const;
+
+    // 0 restores the Binance default for each endpoint.
+    void setMaxStreamsPerConnection(int maxStreams);
+    // Replaces the combined-stream base URL (ws://host:port/stream) for every
+    // endpoint; empty restores the Binance endpoints.
+    void setCombinedStreamBaseUrlOverride(const QString &baseUrl);
+
 signals:
     void connected();
     void disconnected();
@@ -38,8 +138,74 @@ signals:
         double volume,
         bool isClosed);
 
+    // Multiplexed deliveries, emitted once per subscriber key of the stream.
+    // subscriptionTick carries every kline, bookTicker and markPrice update;
+    // the string signals below carry the same updates for existing slots and
+    // only build their strings while one is connected. Direct connections
+    // only: the tick refers to the caller's stack.
+    void subscriptionTick(const QString &key, const BinanceWsClient::Tick &tick);
+    void subscriptionBookTicker(const QString &key, const QString &symbol, double bidPrice, double askPrice);
+    void subscriptionKline(
+        const QString &key,
+        const QString &symbol,
+        const QString &interval,
+        qint64 openTimeMs,
+        double open,
+        double high,
+        double low,
+        double close,
+        double volume,
+        bool isClosed);
+    void subscriptionMarkPrice(const QString &key, const QString &symbol, double markPrice, qint64 eventTimeMs);
+    void subscriptionError(const QString &key, const QString &message);
+
 private:
 #if HAS_QT_WEBSOCKETS
+    struct StreamConnection {
+        QString baseUrl;
+        bool futures = false;
+        QWebSocket *socket = nullptr;
+        QTimer *flushTimer = nullptr;
+        QTimer *reconnectTimer = nullptr;
+        // Stream name -> subscriber keys routed through this socket.
+        QHash<QString, QStringList> subscribers;
+        // Streams the exchange currently delivers on this socket, through the
+        // URL or a SUBSCRIBE frame; flushConnection() reconciles the two.
+        QSet<QString> liveStreams;
+        QHash<qint64, QStringList> pendingSubscribes;
+        qint64 nextRequestId = 1;
+        int reconnectAttempts = 0;
+    };
+
+    struct Subscription {
+        QString stream;
+        StreamConnection *connection = nullptr;
+    };
+
+    // The symbol and interval of a tick, as views into the frame text or
+    // into a decoded StreamFrame.
+    struct TickText {
+        QStringView symbol;
+        QStringView interval;
+    };
+
+    // Routes to the subscriber keys, or to the raw-stream signals when keys
+    // is null.
+    void dispatchTick(const Tick &tick, TickText text, const QStringList *keys);
+    void handleRawMessage(const QString &message);
+    void handleCombinedMessage(StreamConnection *connection, const QString &message);
+    StreamConnection *connectionFor(const QString &baseUrl, bool futures, const QString &stream);
+    int streamLimitFor(const StreamConnection *connection) const;
+    void openConnection(StreamConnection *connection);
+    void scheduleFlush(StreamConnection *connection);
+    void flushConnection(StreamConnection *connection);
+    void notifyConnectionError(StreamConnection *connection, const QString &message);
+    void closeConnection(StreamConnection *connection);
+
     QWebSocket *socket_;
+    QVector<StreamConnection *> connections_;
+    QHash<QString, Subscription> subscriptions_;
 #endif
+    int maxStreamsPerConnection_ = 0;
+    QString combinedBaseUrlOverride_;
 };
@@ -1,12 +1,36 @@
 #include "NativeBacktestBatchRuntime.h"
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonValue>
+#include <QSaveFile>
+
+#include <QThread>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iterator>
 #include <limits>
-#include <set>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -69,38 +93,154 @@ QStringList withFilters(const QStringList &signalKeys, const QStringList &filter
     return combined;
 }
 
-int compareScoreValues(const QVector<double> &left, const QVector<double> &right) {
-    const qsizetype count = std::min(left.size(), right.size());
-    for (qsizetype index = 0; index < count; ++index) {
-        if (left.at(index) > right.at(index)) return 1;
-        if (left.at(index) < right.at(index)) return -1;
+int compareScoreValues(std::span<const double> left, std::span<const double> right) {
+    const std::size_t count = std::min(left.size(), right.size());
+    for (std::size_t index = 0; index < count; ++index) {
+        if (left[index] > right[index]) return 1;
+        if (left[index] < right[index]) return -1;
     }
     if (left.size() > right.size()) return 1;
     if (left.size() < right.size()) return -1;
     return 0;
 }
 
-struct RankedRow {
-    QVector<double> score;
-    qint64 originalIndex = 0;
-    QJsonObject row;
+// The longest score tuple (roi_drawdown).
+constexpr int kMaxScoreValues = 5;
+
+enum class ScoreMetric { RoiPercent, RoiValue, RoiDrawdown };
+
+// Expects a metric normalized by normalizedOptimizerMetric().
+ScoreMetric scoreMetric(const QString &metric) {
+    if (metric == QStringLiteral("roi_value")) return ScoreMetric::RoiValue;
+    if (metric == QStringLiteral("roi_drawdown")) return ScoreMetric::RoiDrawdown;
+    return ScoreMetric::RoiPercent;
+}
+
+bool scoreEligible(const NativeBacktestRuntime::Result &result, double mddLimit, int minTrades) {
+    const double limit = std::max(0.0, mddLimit);
+    return result.trades >= std::max(0, minTrades)
+        && !(limit > 0.0 && result.maxDrawdownPercent > limit);
+}
+
+QString scoreRejectionReason(const NativeBacktestRuntime::Result &result, double mddLimit, int minTrades) {
+    QStringList reasons;
+    const int tradeFloor = std::max(0, minTrades);
+    const double limit = std::max(0.0, mddLimit);
+    if (result.trades < tradeFloor) {
+        reasons.append(QStringLiteral("trades %1 < %2").arg(result.trades).arg(tradeFloor));
+    }
+    if (limit > 0.0 && result.maxDrawdownPercent > limit) {
+        reasons.append(
+            QStringLiteral("MDD %1% > %2%")
+                .arg(result.maxDrawdownPercent, 0, 'f', 2)
+                .arg(limit, 0, 'f', 2));
+    }
+    return reasons.join(QStringLiteral("; "));
+}
+
+// Writes the ranking tuple of an eligible result, best-first by comparing
+// element-wise. Returns its length.
+int scoreValues(const NativeBacktestRuntime::Result &result, ScoreMetric metric, double *values) {
+    const auto fill = [values](std::initializer_list<double> tuple) {
+        std::copy(tuple.begin(), tuple.end(), values);
+        return static_cast<int>(tuple.size());
+    };
+    switch (metric) {
+    case ScoreMetric::RoiValue:
+        return fill({
+            result.roiValue,
+            result.roiPercent,
+            static_cast<double>(result.trades),
+            -result.maxDrawdownPercent,
+        });
+    case ScoreMetric::RoiDrawdown:
+        return fill({
+            result.roiPercent / std::max(std::abs(result.maxDrawdownPercent), 1.0),
+            result.roiPercent,
+            result.roiValue,
+            static_cast<double>(result.trades),
+            -result.maxDrawdownPercent,
+        });
+    case ScoreMetric::RoiPercent:
+        break;
+    }
+    return fill({
+        result.roiPercent,
+        result.roiValue,
+        static_cast<double>(result.trades),
+        -result.maxDrawdownPercent,
+    });
+}
+
+// One evaluated optimizer candidate as plain data: its score and simulation
+// figures, with the symbol, interval and group implied by its position in
+// the plan. Ranking, top-K selection and the worker merge all run on these;
+// JSON is built only for the rows runBatch returns.
+struct CandidateRecord {
+    // Position in the serial symbol x interval x group plan.
+    qint64 ordinal = 0;
+    bool eligible = false;
+    int scoreSize = 0;
+    std::array<double, kMaxScoreValues> score{};
+    int trades = 0;
+    double roiValue = 0.0;
+    double roiPercent = 0.0;
+    double finalEquity = 0.0;
+    double maxDrawdownValue = 0.0;
+    double maxDrawdownPercent = 0.0;
+    double maxDrawdownDuringValue = 0.0;
+    double maxDrawdownDuringPercent = 0.0;
+    double maxDrawdownResultValue = 0.0;
+    double maxDrawdownResultPercent = 0.0;
+    double feesPaid = 0.0;
+
+    std::span<const double> scoreValues() const {
+        return std::span<const double>(score.data(), static_cast<std::size_t>(scoreSize));
+    }
+
+    static CandidateRecord of(qint64 ordinal, const NativeBacktestRuntime::Result &result) {
+        CandidateRecord record;
+        record.ordinal = ordinal;
+        record.trades = result.trades;
+        record.roiValue = result.roiValue;
+        record.roiPercent = result.roiPercent;
+        record.finalEquity = result.finalEquity;
+        record.maxDrawdownValue = result.maxDrawdownValue;
+        record.maxDrawdownPercent = result.maxDrawdownPercent;
+        record.maxDrawdownDuringValue = result.maxDrawdownDuringValue;
+        record.maxDrawdownDuringPercent = result.maxDrawdownDuringPercent;
+        record.maxDrawdownResultValue = result.maxDrawdownResultValue;
+        record.maxDrawdownResultPercent = result.maxDrawdownResultPercent;
+        record.feesPaid = result.feesPaid;
+        return record;
+    }
+
+    // Copies the simulation figures back onto a described result.
+    void restoreFigures(NativeBacktestRuntime::Result &result) const {
+        result.ok = true;
+        result.trades = trades;
+        result.roiValue = roiValue;
+        result.roiPercent = roiPercent;
+        result.finalEquity = finalEquity;
+        result.maxDrawdownValue = maxDrawdownValue;
+        result.maxDrawdownPercent = maxDrawdownPercent;
+        result.maxDrawdownDuringValue = maxDrawdownDuringValue;
+        result.maxDrawdownDuringPercent = maxDrawdownDuringPercent;
+        result.maxDrawdownResultValue = maxDrawdownResultValue;
+        result.maxDrawdownResultPercent = maxDrawdownResultPercent;
+        result.feesPaid = feesPaid;
+    }
 };
 
 struct BestFirst {
-    bool operator()(const RankedRow &left, const RankedRow &right) const {
-        const int scoreOrder = compareScoreValues(left.score, right.score);
+    bool operator()(const CandidateRecord &left, const CandidateRecord &right) const {
+        const int scoreOrder = compareScoreValues(left.scoreValues(), right.scoreValues());
         if (scoreOrder != 0) return scoreOrder > 0;
-        if (left.originalIndex != right.originalIndex) return left.originalIndex < right.originalIndex;
+        if (left.ordinal != right.ordinal) return left.ordinal < right.ordinal;
         return false;
     }
 };
 
-QJsonArray rowsToArray(const QVector<QJsonObject> &rows) {
-    QJsonArray array;
-    for (const QJsonObject &row : rows) array.append(row);
-    return array;
-}
-
 qint64 saturatingMultiply(qint64 left, qint64 right) {
     if (left <= 0 || right <= 0) return 0;
     if (left > std::numeric_limits<qint64>::max() / right) {
@@ -122,6 +262,968 @@ QString normalizedOptimizerMetric(const QString &metric) {
     return QStringLiteral("roi_percent");
 }
 
+// How many symbol/interval candle sets may be loaded ahead of the slowest
+// worker. Each one holds its candles and cached signals in memory.
+constexpr qsizetype kCandlePrefetchDepth = 2;
+
+struct PairTask {
+    QString symbol;
+    QString interval;
+};
+
+// Everything a worker reads while evaluating groups. Shared read-only.
+struct BatchContext {
+    const NativeBacktestBatchRuntime::BatchRequest &request;
+    const QVector<QStringList> &groups;
+    const ConfigMap &groupConfigs;
+    QString metric;
+    ScoreMetric scoreMetric = ScoreMetric::RoiPercent;
+    QString mode;
+    QString scope;
+    QString effectiveLogic;
+    int resultLimit = 1;
+    qint64 runCount = 0;
+    // What every run of the batch reports besides its figures.
+    const NativeBacktestRuntime::Result &described;
+    const NativeBacktestBatchRuntime::StopCallback &shouldStop;
+};
+
+// Candles and shared signals for one symbol/interval. Read-only once the
+// loader publishes it; the signal cache points into the candles, so this is
+// only ever handled through a shared pointer.
+struct LoadedPair {
+    NativeIndicatorRuntime::CandleColumns candles;
+    std::unique_ptr<NativeBacktestRuntime::SignalCache> signalCache;
+};
+
+// Per-worker partial results. Candidates are keyed by their position in the
+// serial symbol x interval x group plan, so merging the partials reproduces
+// the serial batch exactly regardless of which worker ran what.
+struct WorkerResults {
+    // Heap under BestFirst: front() is the worst candidate kept.
+    std::vector<CandidateRecord> bestRows;
+    std::vector<CandidateRecord> eligibleRows;
+    std::map<qint64, CandidateRecord> rejectedSamples;
+    std::vector<std::pair<qint64, QJsonObject>> errors;
+    qint64 processedCount = 0;
+    qint64 candidateCount = 0;
+    qint64 eligibleCount = 0;
+    qint64 filteredCount = 0;
+    bool cancelled = false;
+
+    void keepEligible(const CandidateRecord &record, int limit) {
+        if (bestRows.size() >= static_cast<std::size_t>(limit) && !BestFirst{}(record, bestRows.front())) return;
+        bestRows.push_back(record);
+        std::push_heap(bestRows.begin(), bestRows.end(), BestFirst{});
+        if (bestRows.size() > static_cast<std::size_t>(limit)) {
+            std::pop_heap(bestRows.begin(), bestRows.end(), BestFirst{});
+            bestRows.pop_back();
+        }
+    }
+
+    // Keeps the earliest rejected candidates in plan order, like the serial
+    // loop.
+    void keepRejected(const CandidateRecord &record, int limit) {
+        if (rejectedSamples.size() >= static_cast<std::size_t>(limit)
+            && record.ordinal > std::prev(rejectedSamples.end())->first) {
+            return;
+        }
+        rejectedSamples.emplace(record.ordinal, record);
+        if (rejectedSamples.size() > static_cast<std::size_t>(limit)) {
+            rejectedSamples.erase(std::prev(rejectedSamples.end()));
+        }
+    }
+};
+
+// Builds the JSON row of a kept candidate.
+QJsonObject candidateRow(
+    const CandidateRecord &record,
+    const BatchContext &context,
+    const QVector<PairTask> &pairs) {
+    const NativeBacktestBatchRuntime::BatchRequest &request = context.request;
+    const qsizetype groupCount = context.groups.size();
+    const PairTask &pair = pairs.at(static_cast<qsizetype>(record.ordinal / groupCount));
+
+    NativeBacktestRuntime::Result result = context.described;
+    result.symbol = pair.symbol;
+    result.interval = pair.interval;
+    // run() reports keys in the order of its indicator map.
+    result.indicatorKeys = context.groups.at(static_cast<qsizetype>(record.ordinal % groupCount));
+    result.indicatorKeys.sort();
+    record.restoreFigures(result);
+
+    QJsonObject row = result.toJson();
+    row.insert(QStringLiteral("start"), request.startDisplay);
+    row.insert(QStringLiteral("end"), request.endDisplay);
+    row.insert(QStringLiteral("loop_interval_override"), request.loopIntervalOverride);
+    row.insert(QStringLiteral("connector_backend"), request.connectorBackend);
+    row.insert(QStringLiteral("optimizer_metric"), context.metric);
+    row.insert(QStringLiteral("optimizer_mode"), context.mode);
+    row.insert(QStringLiteral("optimizer_scope"), context.scope);
+    row.insert(QStringLiteral("optimizer_mdd_limit"), request.optimizerMddLimit);
+    row.insert(QStringLiteral("optimizer_min_trades"), request.optimizerMinTrades);
+    row.insert(QStringLiteral("optimizer_eligible"), record.eligible);
+    row.insert(
+        QStringLiteral("optimizer_primary_score"),
+        record.eligible && record.scoreSize > 0 ? QJsonValue(record.score.front()) : QJsonValue(QJsonValue::Null));
+    row.insert(
+        QStringLiteral("optimizer_rejection_reason"),
+        record.eligible
+            ? QString()
+            : scoreRejectionReason(result, request.optimizerMddLimit, request.optimizerMinTrades));
+    return row;
+}
+
+// [begin, end) ordinals of the plan still to run.
+using OrdinalSpan = std::pair<qint64, qint64>;
+
+constexpr quint32 kCheckpointVersion = 1;
+constexpr char kCheckpointMagic[8] = {'T', 'B', 'O', 'P', 'T', 'C', 'K', 'P'};
+
+// Records are stored raw, so a checkpoint only resumes on a build with the
+// same record layout (checked through recordSize).
+static_assert(std::is_trivially_copyable_v<CandidateRecord>);
+
+// Fixed 128-byte header followed by pendingSpanCount ordinal spans (two
+// qint64 each), bestCount then rejectedCount raw CandidateRecords, the
+// errors as a compact JSON array and a compact JSON summary.
+struct CheckpointHeader {
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+    char fingerprint[32];
+    qint64 runCount;
+    qint64 processedCount;
+    qint64 candidateCount;
+    qint64 eligibleCount;
+    qint64 filteredCount;
+    qint64 pendingSpanCount;
+    qint64 bestCount;
+    qint64 rejectedCount;
+    qint64 errorBytes;
+    qint64 summaryBytes;
+};
+static_assert(sizeof(CheckpointHeader) == 128);
+
+// Where an optimizer batch stood: which runs are left, the counters and the
+// rows kept for the runs already done.
+struct Checkpoint {
+    QByteArray fingerprint;
+    qint64 runCount = 0;
+    qint64 processedCount = 0;
+    qint64 candidateCount = 0;
+    qint64 eligibleCount = 0;
+    qint64 filteredCount = 0;
+    std::vector<OrdinalSpan> pending;
+    std::vector<CandidateRecord> bestRows;
+    std::vector<CandidateRecord> rejectedRows;
+    std::vector<std::pair<qint64, QJsonObject>> errors;
+    QString optimizerMode;
+};
+
+// Identifies the plan and everything that changes its results. The worker
+// count is left out: results are identical for every value.
+QByteArray requestFingerprint(const BatchContext &context, const QVector<PairTask> &pairs) {
+    const NativeBacktestBatchRuntime::BatchRequest &request = context.request;
+    QJsonArray pairRows;
+    for (const PairTask &pair : pairs) pairRows.append(QJsonArray{pair.symbol, pair.interval});
+    QJsonArray groupRows;
+    for (const QStringList &group : context.groups) groupRows.append(QJsonArray::fromStringList(group));
+    QJsonObject configs;
+    for (auto iterator = context.groupConfigs.cbegin(); iterator != context.groupConfigs.cend(); ++iterator) {
+        configs.insert(iterator.key(), iterator.value());
+    }
+    const QJsonObject plan{
+        {QStringLiteral("pairs"), pairRows},
+        {QStringLiteral("groups"), groupRows},
+        {QStringLiteral("configs"), configs},
+        {QStringLiteral("run"), context.described.toJson()},
+        {QStringLiteral("metric"), context.metric},
+        {QStringLiteral("mode"), context.mode},
+        {QStringLiteral("scope"), context.scope},
+        {QStringLiteral("mdd_limit"), request.optimizerMddLimit},
+        {QStringLiteral("min_trades"), request.optimizerMinTrades},
+        {QStringLiteral("result_limit"), context.resultLimit},
+        {QStringLiteral("start"), request.startDisplay},
+        {QStringLiteral("end"), request.endDisplay},
+        {QStringLiteral("loop_interval_override"), request.loopIntervalOverride},
+        {QStringLiteral("connector_backend"), request.connectorBackend},
+    };
+    return QCryptographicHash::hash(QJsonDocument(plan).toJson(QJsonDocument::Compact), QCryptographicHash::Sha256);
+}
+
+bool writeCheckpoint(const QString &path, const Checkpoint &checkpoint, QString *error) {
+    QJsonArray errorRows;
+    for (const auto &entry : checkpoint.errors) {
+        errorRows.append(QJsonObject{
+            {QStringLiteral("ordinal"), static_cast<double>(entry.first)},
+            {QStringLiteral("error"), entry.second},
+        });
+    }
+    const QByteArray errorBytes = QJsonDocument(errorRows).toJson(QJsonDocument::Compact);
+    const QByteArray summaryBytes = QJsonDocument(QJsonObject{
+        {QStringLiteral("optimizer_mode"), checkpoint.optimizerMode},
+    }).toJson(QJsonDocument::Compact);
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+    header.version = kCheckpointVersion;
+    header.recordSize = sizeof(CandidateRecord);
+    std::memcpy(header.fingerprint, checkpoint.fingerprint.constData(),
+                std::min<std::size_t>(sizeof(header.fingerprint), static_cast<std::size_t>(checkpoint.fingerprint.size())));
+    header.runCount = checkpoint.runCount;
+    header.processedCount = checkpoint.processedCount;
+    header.candidateCount = checkpoint.candidateCount;
+    header.eligibleCount = checkpoint.eligibleCount;
+    header.filteredCount = checkpoint.filteredCount;
+    header.pendingSpanCount = static_cast<qint64>(checkpoint.pending.size());
+    header.bestCount = static_cast<qint64>(checkpoint.bestRows.size());
+    header.rejectedCount = static_cast<qint64>(checkpoint.rejectedRows.size());
+    header.errorBytes = errorBytes.size();
+    header.summaryBytes = summaryBytes.size();
+
+    const std::size_t spanBytes = checkpoint.pending.size() * 2 * sizeof(qint64);
+    const std::size_t recordBytes = (checkpoint.bestRows.size() + checkpoint.rejectedRows.size()) * sizeof(CandidateRecord);
+    QByteArray bytes(
+        static_cast<qsizetype>(sizeof(header) + spanBytes + recordBytes) + errorBytes.size() + summaryBytes.size(),
+        Qt::Uninitialized);
+    char *out = bytes.data();
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (const OrdinalSpan &span : checkpoint.pending) {
+        const qint64 bounds[2] = {span.first, span.second};
+        std::memcpy(out, bounds, sizeof(bounds));
+        out += sizeof(bounds);
+    }
+    for (const auto *rows : {&checkpoint.bestRows, &checkpoint.rejectedRows}) {
+        if (rows->empty()) continue;
+        std::memcpy(out, rows->data(), rows->size() * sizeof(CandidateRecord));
+        out += rows->size() * sizeof(CandidateRecord);
+    }
+    std::memcpy(out, errorBytes.constData(), static_cast<std::size_t>(errorBytes.size()));
+    out += errorBytes.size();
+    std::memcpy(out, summaryBytes.constData(), static_cast<std::size_t>(summaryBytes.size()));
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+        if (error) *error = QStringLiteral("Could not write optimizer checkpoint %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+bool readCheckpoint(const QString &path, Checkpoint &checkpoint, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QStringLiteral("Could not open optimizer checkpoint %1").arg(path);
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+    CheckpointHeader header{};
+    if (bytes.size() < static_cast<qsizetype>(sizeof(header))) {
+        if (error) *error = QStringLiteral("Optimizer checkpoint %1 is truncated").arg(path);
+        return false;
+    }
+    std::memcpy(&header, bytes.constData(), sizeof(header));
+    if (std::memcmp(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0
+        || header.version != kCheckpointVersion
+        || header.recordSize != sizeof(CandidateRecord)) {
+        if (error) *error = QStringLiteral("Optimizer checkpoint %1 has an unsupported format").arg(path);
+        return false;
+    }
+    const auto countValid = [](qint64 count, qint64 limit) { return count >= 0 && count <= limit; };
+    const qint64 available = bytes.size() - static_cast<qint64>(sizeof(header));
+    if (!countValid(header.pendingSpanCount, available / static_cast<qint64>(2 * sizeof(qint64)))
+        || !countValid(header.bestCount, available / static_cast<qint64>(sizeof(CandidateRecord)))
+        || !countValid(header.rejectedCount, available / static_cast<qint64>(sizeof(CandidateRecord)))
+        || !countValid(header.errorBytes, available)
+        || !countValid(header.summaryBytes, available)
+        || header.pendingSpanCount * static_cast<qint64>(2 * sizeof(qint64))
+                + (header.bestCount + header.rejectedCount) * static_cast<qint64>(sizeof(CandidateRecord))
+                + header.errorBytes + header.summaryBytes
+            != available) {
+        if (error) *error = QStringLiteral("Optimizer checkpoint %1 is truncated").arg(path);
+        return false;
+    }
+
+    checkpoint.fingerprint = QByteArray(header.fingerprint, sizeof(header.fingerprint));
+    checkpoint.runCount = header.runCount;
+    checkpoint.processedCount = header.processedCount;
+    checkpoint.candidateCount = header.candidateCount;
+    checkpoint.eligibleCount = header.eligibleCount;
+    checkpoint.filteredCount = header.filteredCount;
+    const char *in = bytes.constData() + sizeof(header);
+    checkpoint.pending.resize(static_cast<std::size_t>(header.pendingSpanCount));
+    for (OrdinalSpan &span : checkpoint.pending) {
+        qint64 bounds[2] = {};
+        std::memcpy(bounds, in, sizeof(bounds));
+        in += sizeof(bounds);
+        span = {bounds[0], bounds[1]};
+    }
+    const auto readRows = [&in](std::vector<CandidateRecord> &rows, qint64 count) {
+        rows.resize(static_cast<std::size_t>(count));
+        if (rows.empty()) return;
+        std::memcpy(rows.data(), in, rows.size() * sizeof(CandidateRecord));
+        in += rows.size() * sizeof(CandidateRecord);
+    };
+    readRows(checkpoint.bestRows, header.bestCount);
+    readRows(checkpoint.rejectedRows, header.rejectedCount);
+    const QJsonArray errorRows = QJsonDocument::fromJson(QByteArray(in, header.errorBytes)).array();
+    in += header.errorBytes;
+    checkpoint.errors.clear();
+    for (const QJsonValue &value : errorRows) {
+        const QJsonObject entry = value.toObject();
+        checkpoint.errors.emplace_back(
+            static_cast<qint64>(entry.value(QStringLiteral("ordinal")).toDouble()),
+            entry.value(QStringLiteral("error")).toObject());
+    }
+    const QJsonObject summary = QJsonDocument::fromJson(QByteArray(in, header.summaryBytes)).object();
+    checkpoint.optimizerMode = summary.value(QStringLiteral("optimizer_mode")).toString();
+    return true;
+}
+
+// A contiguous slice of group indices. The owning worker takes from the
+// front; an idle worker steals the back half.
+class StealableRange {
+public:
+    void assign(qsizetype begin, qsizetype end) {
+        std::lock_guard lock(mutex_);
+        begin_ = begin;
+        end_ = end;
+    }
+
+    bool takeFront(qsizetype &index) {
+        std::lock_guard lock(mutex_);
+        if (begin_ >= end_) return false;
+        index = begin_++;
+        return true;
+    }
+
+    bool stealBack(qsizetype &begin, qsizetype &end) {
+        std::lock_guard lock(mutex_);
+        const qsizetype available = end_ - begin_;
+        if (available <= 0) return false;
+        begin = end_ - (available + 1) / 2;
+        end = end_;
+        end_ = begin;
+        return true;
+    }
+
+    std::pair<qsizetype, qsizetype> bounds() {
+        std::lock_guard lock(mutex_);
+        return {begin_, end_};
+    }
+
+private:
+    std::mutex mutex_;
+    qsizetype begin_ = 0;
+    qsizetype end_ = 0;
+};
+
+struct PairSlot {
+    // [begin, end) group indices left to run, sorted. Fixed before the batch
+    // starts: every group on a fresh batch, the checkpoint's rest on resume.
+    std::vector<std::pair<qsizetype, qsizetype>> pendingGroups;
+    bool published = false;
+    std::shared_ptr<const LoadedPair> loaded;
+    std::unique_ptr<StealableRange[]> ranges;
+    std::atomic<qsizetype> remaining = 0;
+};
+
+// Scheduler defaults for the BatchRequest fields left negative.
+constexpr qint64 kDefaultProgressIntervalMs = 1'000;
+constexpr int kDefaultProgressTopRuns = 10;
+constexpr qint64 kDefaultCheckpointIntervalMs = 60'000;
+
+qint64 intervalOrDefault(qint64 requested, qint64 fallback) {
+    return requested < 0 ? fallback : requested;
+}
+
+// Candle loaders run on threads that outlive the batch, so NativeHttpTransport's
+// per-thread QNetworkAccessManager, and with it the keep-alive and TLS
+// sessions to the exchange, carries over from one batch to the next. A batch
+// takes an idle thread or starts one; batches running side by side each get
+// their own. The threads are joined at exit.
+class LoaderThreads {
+public:
+    static LoaderThreads &instance() {
+        static LoaderThreads threads;
+        return threads;
+    }
+
+    ~LoaderThreads() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread &thread : threads_) thread.join();
+    }
+
+    std::future<void> submit(std::function<void()> job) {
+        std::packaged_task<void()> task(std::move(job));
+        std::future<void> finished = task.get_future();
+        {
+            std::lock_guard lock(mutex_);
+            jobs_.push_back(std::move(task));
+            if (jobs_.size() > idle_) threads_.emplace_back([this]() { serve(); });
+        }
+        wake_.notify_one();
+        return finished;
+    }
+
+private:
+    LoaderThreads() = default;
+
+    void serve() {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            ++idle_;
+            wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            --idle_;
+            if (jobs_.empty()) return;
+            std::packaged_task<void()> task = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::packaged_task<void()>> jobs_;
+    std::vector<std::thread> threads_;
+    std::size_t idle_ = 0;
+    bool stopping_ = false;
+};
+
+// Runs the batch plan. A loader thread fetches candles for each
+// symbol/interval in plan order, at most kCandlePrefetchDepth ahead of the
+// workers. Each pair's groups are split evenly across the workers; a worker
+// that runs dry steals from the others, then moves on to the next pair as
+// soon as it is loaded.
+//
+// Each partial result has its own lock, uncontended except while a progress
+// snapshot or a checkpoint copies it. A worker takes its next group and
+// files its outcome under that lock too, so a checkpoint sees every group as
+// still in a range, in flight or done.
+class BatchScheduler {
+public:
+    BatchScheduler(const BatchContext &context, const QVector<PairTask> &pairs, int workerCount, QByteArray fingerprint)
+        : context_(context),
+          pairs_(pairs),
+          workerCount_(workerCount),
+          fingerprint_(std::move(fingerprint)),
+          progressIntervalMs_(intervalOrDefault(context.request.progressIntervalMs, kDefaultProgressIntervalMs)),
+          progressTopRuns_(context.request.progressTopRuns < 0 ? kDefaultProgressTopRuns : context.request.progressTopRuns),
+          checkpointIntervalMs_(intervalOrDefault(context.request.checkpointIntervalMs, kDefaultCheckpointIntervalMs)),
+          slots_(std::make_unique<PairSlot[]>(static_cast<std::size_t>(pairs.size()))),
+          results_(static_cast<std::size_t>(workerCount) + 1),
+          resultLocks_(std::make_unique<std::mutex[]>(static_cast<std::size_t>(workerCount) + 1)),
+          inFlight_(static_cast<std::size_t>(workerCount), -1),
+          nextProgressAtMs_(progressIntervalMs_),
+          nextCheckpointAtMs_(checkpointIntervalMs_) {
+        for (qsizetype pairIndex = 0; pairIndex < pairs.size(); ++pairIndex) {
+            slots_[static_cast<std::size_t>(pairIndex)].pendingGroups = {{0, context.groups.size()}};
+        }
+    }
+
+    // Must be called before run(). The loader's partial result starts out as
+    // the checkpoint's, so merging reproduces the uninterrupted batch.
+    void resumeFrom(Checkpoint checkpoint) {
+        const qint64 groupCount = context_.groups.size();
+        for (qsizetype pairIndex = 0; pairIndex < pairs_.size(); ++pairIndex) {
+            slots_[static_cast<std::size_t>(pairIndex)].pendingGroups.clear();
+        }
+        for (const OrdinalSpan &span : checkpoint.pending) {
+            const qint64 spanEnd = std::min(span.second, context_.runCount);
+            for (qint64 begin = std::max<qint64>(0, span.first); begin < spanEnd;) {
+                const qint64 pairIndex = begin / groupCount;
+                const qint64 end = std::min(spanEnd, (pairIndex + 1) * groupCount);
+                slots_[static_cast<std::size_t>(pairIndex)].pendingGroups.emplace_back(
+                    begin - pairIndex * groupCount,
+                    end - pairIndex * groupCount);
+                begin = end;
+            }
+        }
+
+        WorkerResults &seeded = results_.back();
+        seeded.processedCount = checkpoint.processedCount;
+        seeded.candidateCount = checkpoint.candidateCount;
+        seeded.eligibleCount = checkpoint.eligibleCount;
+        seeded.filteredCount = checkpoint.filteredCount;
+        seeded.bestRows = std::move(checkpoint.bestRows);
+        std::make_heap(seeded.bestRows.begin(), seeded.bestRows.end(), BestFirst{});
+        for (const CandidateRecord &record : checkpoint.rejectedRows) {
+            seeded.rejectedSamples.emplace(record.ordinal, record);
+        }
+        seeded.errors = std::move(checkpoint.errors);
+        resumedProcessedCount_ = checkpoint.processedCount;
+    }
+
+    // The calling thread acts as worker 0.
+    void run(const NativeBacktestBatchRuntime::CandleLoader &loadCandles) {
+        std::future<void> loaded = LoaderThreads::instance().submit([this, &loadCandles]() { loadPairs(loadCandles); });
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(static_cast<std::size_t>(workerCount_ - 1));
+            for (int worker = 1; worker < workerCount_; ++worker) {
+                threads.emplace_back([this, worker]() { work(worker); });
+            }
+            work(0);
+        }
+        loaded.get();
+    }
+
+    WorkerResults mergedResults() {
+        WorkerResults merged;
+        for (WorkerResults &partial : results_) {
+            merged.processedCount += partial.processedCount;
+            merged.candidateCount += partial.candidateCount;
+            merged.eligibleCount += partial.eligibleCount;
+            merged.filteredCount += partial.filteredCount;
+            merged.cancelled = merged.cancelled || partial.cancelled;
+            merged.eligibleRows.insert(merged.eligibleRows.end(), partial.bestRows.cbegin(), partial.bestRows.cend());
+            for (const auto &sample : partial.rejectedSamples) {
+                merged.keepRejected(sample.second, context_.resultLimit);
+            }
+            std::move(partial.errors.begin(), partial.errors.end(), std::back_inserter(merged.errors));
+        }
+        merged.cancelled = merged.cancelled || cancelled_.load();
+        std::sort(merged.eligibleRows.begin(), merged.eligibleRows.end(), BestFirst{});
+        if (merged.eligibleRows.size() > static_cast<std::size_t>(context_.resultLimit)) {
+            merged.eligibleRows.resize(static_cast<std::size_t>(context_.resultLimit));
+        }
+        std::sort(merged.errors.begin(), merged.errors.end(), [](const auto &left, const auto &right) {
+            return left.first < right.first;
+        });
+        return merged;
+    }
+
+    bool budgetExhausted() const { return budgetExhausted_.load(); }
+    bool cancelled() const { return cancelled_.load(); }
+
+    bool saveCheckpoint(QString *error) {
+        const Checkpoint checkpoint = captureCheckpoint();
+        std::lock_guard lock(checkpointMutex_);
+        return writeCheckpoint(context_.request.checkpointPath, checkpoint, error);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    qint64 elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startedAt_).count();
+    }
+
+    bool budgetExpired() {
+        if (context_.request.timeBudgetMs <= 0) return false;
+        if (budgetExhausted_.load(std::memory_order_relaxed)) return true;
+        if (elapsedMs() < context_.request.timeBudgetMs) return false;
+        budgetExhausted_ = true;
+        return true;
+    }
+
+    bool stopRequested() {
+        return cancelled_.load(std::memory_order_relaxed)
+            || budgetExpired()
+            || (context_.shouldStop && context_.shouldStop());
+    }
+
+    // Claims the next progress slot, so at most one worker builds a snapshot
+    // per interval. Costs a clock read per run when a callback is set.
+    void reportProgressIfDue() {
+        if (!context_.request.onProgress) return;
+        const qint64 nowMs = elapsedMs();
+        qint64 dueMs = nextProgressAtMs_.load(std::memory_order_relaxed);
+        if (nowMs < dueMs) return;
+        if (!nextProgressAtMs_.compare_exchange_strong(dueMs, nowMs + progressIntervalMs_)) return;
+        std::lock_guard lock(progressMutex_);
+        context_.request.onProgress(progressSnapshot(nowMs));
+    }
+
+    QJsonObject progressSnapshot(qint64 nowMs) {
+        qint64 processedCount = 0;
+        qint64 candidateCount = 0;
+        qint64 eligibleCount = 0;
+        qint64 filteredCount = 0;
+        qint64 errorCount = 0;
+        std::vector<CandidateRecord> best;
+        for (std::size_t index = 0; index < results_.size(); ++index) {
+            std::lock_guard lock(resultLocks_[index]);
+            const WorkerResults &partial = results_[index];
+            processedCount += partial.processedCount;
+            candidateCount += partial.candidateCount;
+            eligibleCount += partial.eligibleCount;
+            filteredCount += partial.filteredCount;
+            errorCount += static_cast<qint64>(partial.errors.size());
+            best.insert(best.end(), partial.bestRows.cbegin(), partial.bestRows.cend());
+        }
+        const auto topCount = std::min(best.size(), static_cast<std::size_t>(progressTopRuns_));
+        std::partial_sort(best.begin(), best.begin() + static_cast<std::ptrdiff_t>(topCount), best.end(), BestFirst{});
+        QJsonArray topRuns;
+        for (std::size_t index = 0; index < topCount; ++index) {
+            QJsonObject row = candidateRow(best[index], context_, pairs_);
+            row.insert(QStringLiteral("optimizer_rank"), static_cast<int>(index) + 1);
+            topRuns.append(row);
+        }
+
+        const qint64 runCount = context_.runCount;
+        // Runs carried over from a checkpoint do not count towards the rate.
+        const double runsPerSecond = nowMs > 0
+            ? static_cast<double>(processedCount - resumedProcessedCount_) * 1000.0 / static_cast<double>(nowMs)
+            : 0.0;
+        const QJsonValue etaMs = runsPerSecond > 0.0
+            ? QJsonValue(std::round(static_cast<double>(std::max<qint64>(0, runCount - processedCount)) / runsPerSecond * 1000.0))
+            : QJsonValue(QJsonValue::Null);
+        QJsonObject snapshot{
+            {QStringLiteral("source"), QStringLiteral("native-cpp-backtest")},
+            {QStringLiteral("state"), QStringLiteral("running")},
+            {QStringLiteral("cancelled"), false},
+            {QStringLiteral("optimizer_run_count"), static_cast<double>(runCount)},
+            {QStringLiteral("processed_count"), static_cast<double>(processedCount)},
+            {QStringLiteral("optimizer_candidate_count"), static_cast<double>(candidateCount)},
+            {QStringLiteral("optimizer_eligible_count"), static_cast<double>(eligibleCount)},
+            {QStringLiteral("optimizer_filtered_count"), static_cast<double>(filteredCount)},
+            {QStringLiteral("error_count"), static_cast<double>(errorCount)},
+            {QStringLiteral("progress_percent"),
+             runCount > 0 ? std::min(100.0, static_cast<double>(processedCount) / static_cast<double>(runCount) * 100.0) : 0.0},
+            {QStringLiteral("elapsed_ms"), static_cast<double>(nowMs)},
+            {QStringLiteral("runs_per_second"), runsPerSecond},
+            {QStringLiteral("eta_ms"), etaMs},
+            {QStringLiteral("worker_threads"), workerCount_},
+            {QStringLiteral("top_runs"), topRuns},
+            {QStringLiteral("status_message"),
+             QStringLiteral("Native C++ backtest running: %1 of %2 run(s), %3 run(s)/s.")
+                 .arg(processedCount)
+                 .arg(runCount)
+                 .arg(runsPerSecond, 0, 'f', 1)},
+        };
+        if (!topRuns.isEmpty()) snapshot.insert(QStringLiteral("top_run"), topRuns.at(0));
+        return snapshot;
+    }
+
+    // Rewrites the checkpoint at most once per checkpointIntervalMs. A failed
+    // write is retried at the next interval.
+    void checkpointIfDue() {
+        if (context_.request.checkpointPath.isEmpty()) return;
+        const qint64 nowMs = elapsedMs();
+        qint64 dueMs = nextCheckpointAtMs_.load(std::memory_order_relaxed);
+        if (nowMs < dueMs) return;
+        if (!nextCheckpointAtMs_.compare_exchange_strong(dueMs, nowMs + checkpointIntervalMs_)) return;
+        saveCheckpoint(nullptr);
+    }
+
+    static bool pendingGroup(const PairSlot &slot, qsizetype groupIndex) {
+        const auto next = std::upper_bound(
+            slot.pendingGroups.cbegin(),
+            slot.pendingGroups.cend(),
+            groupIndex,
+            [](qsizetype value, const auto &span) { return value < span.first; });
+        return next != slot.pendingGroups.cbegin() && groupIndex < std::prev(next)->second;
+    }
+
+    static qint64 pendingRunCount(const PairSlot &slot) {
+        qint64 count = 0;
+        for (const auto &span : slot.pendingGroups) count += span.second - span.first;
+        return count;
+    }
+
+    Checkpoint captureCheckpoint() {
+        std::vector<std::unique_lock<std::mutex>> resultGuards;
+        resultGuards.reserve(results_.size());
+        for (std::size_t index = 0; index < results_.size(); ++index) resultGuards.emplace_back(resultLocks_[index]);
+        std::lock_guard lock(mutex_);
+
+        Checkpoint checkpoint;
+        checkpoint.fingerprint = fingerprint_;
+        checkpoint.runCount = context_.runCount;
+        checkpoint.optimizerMode = context_.mode;
+        const qint64 groupCount = context_.groups.size();
+        for (qsizetype pairIndex = 0; pairIndex < pairs_.size(); ++pairIndex) {
+            PairSlot &slot = slots_[static_cast<std::size_t>(pairIndex)];
+            std::vector<std::pair<qsizetype, qsizetype>> open;
+            if (!slot.published) {
+                open = slot.pendingGroups;
+            } else if (slot.ranges) {
+                for (int worker = 0; worker < workerCount_; ++worker) {
+                    const auto [begin, end] = slot.ranges[worker].bounds();
+                    for (const auto &span : slot.pendingGroups) {
+                        const qsizetype clippedBegin = std::max(begin, span.first);
+                        const qsizetype clippedEnd = std::min(end, span.second);
+                        if (clippedBegin < clippedEnd) open.emplace_back(clippedBegin, clippedEnd);
+                    }
+                }
+                for (const qint64 ordinal : inFlight_) {
+                    if (ordinal < 0 || ordinal / groupCount != pairIndex) continue;
+                    open.emplace_back(ordinal % groupCount, ordinal % groupCount + 1);
+                }
+            }
+            std::sort(open.begin(), open.end());
+            for (const auto &span : open) {
+                const OrdinalSpan ordinals{pairIndex * groupCount + span.first, pairIndex * groupCount + span.second};
+                if (!checkpoint.pending.empty() && checkpoint.pending.back().second == ordinals.first) {
+                    checkpoint.pending.back().second = ordinals.second;
+                } else {
+                    checkpoint.pending.push_back(ordinals);
+                }
+            }
+        }
+
+        WorkerResults rejected;
+        for (const WorkerResults &partial : results_) {
+            checkpoint.processedCount += partial.processedCount;
+            checkpoint.candidateCount += partial.candidateCount;
+            checkpoint.eligibleCount += partial.eligibleCount;
+            checkpoint.filteredCount += partial.filteredCount;
+            checkpoint.bestRows.insert(checkpoint.bestRows.end(), partial.bestRows.cbegin(), partial.bestRows.cend());
+            for (const auto &sample : partial.rejectedSamples) rejected.keepRejected(sample.second, context_.resultLimit);
+            checkpoint.errors.insert(checkpoint.errors.end(), partial.errors.cbegin(), partial.errors.cend());
+        }
+        std::sort(checkpoint.bestRows.begin(), checkpoint.bestRows.end(), BestFirst{});
+        if (checkpoint.bestRows.size() > static_cast<std::size_t>(context_.resultLimit)) {
+            checkpoint.bestRows.resize(static_cast<std::size_t>(context_.resultLimit));
+        }
+        for (const auto &sample : rejected.rejectedSamples) checkpoint.rejectedRows.push_back(sample.second);
+        std::sort(checkpoint.errors.begin(), checkpoint.errors.end(), [](const auto &left, const auto &right) {
+            return left.first < right.first;
+        });
+        return checkpoint;
+    }
+
+    void cancel() {
+        {
+            std::lock_guard lock(mutex_);
+            cancelled_ = true;
+        }
+        changed_.notify_all();
+    }
+
+    void publish(qsizetype pairIndex, std::shared_ptr<const LoadedPair> loaded) {
+        PairSlot &slot = slots_[static_cast<std::size_t>(pairIndex)];
+        const qsizetype groupCount = context_.groups.size();
+        if (loaded) {
+            slot.ranges = std::make_unique<StealableRange[]>(static_cast<std::size_t>(workerCount_));
+            for (int worker = 0; worker < workerCount_; ++worker) {
+                slot.ranges[worker].assign(
+                    groupCount * worker / workerCount_,
+                    groupCount * (worker + 1) / workerCount_);
+            }
+            slot.remaining = groupCount;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            slot.published = true;
+            slot.loaded = std::move(loaded);
+            if (!slot.loaded) ++releasedPairs_;
+        }
+        changed_.notify_all();
+    }
+
+    void release(qsizetype pairIndex) {
+        {
+            std::lock_guard lock(mutex_);
+            slots_[static_cast<std::size_t>(pairIndex)].loaded.reset();
+            ++releasedPairs_;
+        }
+        changed_.notify_all();
+    }
+
+    void loadPairs(const NativeBacktestBatchRuntime::CandleLoader &loadCandles) {
+        WorkerResults &results = results_.back();
+        std::mutex &resultsLock = resultLocks_[static_cast<std::size_t>(workerCount_)];
+        const qsizetype groupCount = context_.groups.size();
+        // Lets a long candle download end on cancellation or at the budget.
+        const NativeBacktestBatchRuntime::StopCallback loadStop = [this]() { return stopRequested(); };
+        for (qsizetype pairIndex = 0; pairIndex < pairs_.size(); ++pairIndex) {
+            const PairSlot &slot = slots_[static_cast<std::size_t>(pairIndex)];
+            // Fully evaluated before a resume: nothing to load.
+            if (slot.pendingGroups.empty()) {
+                publish(pairIndex, nullptr);
+                continue;
+            }
+            {
+                std::unique_lock lock(mutex_);
+                changed_.wait(lock, [&]() {
+                    return cancelled_ || pairIndex - releasedPairs_ < kCandlePrefetchDepth;
+                });
+                if (cancelled_) return;
+            }
+            if (stopRequested()) {
+                cancel();
+                return;
+            }
+            const PairTask &pair = pairs_.at(pairIndex);
+            NativeBacktestBatchRuntime::CandleLoadResult fetched =
+                loadCandles(pair.symbol, pair.interval, loadStop);
+            if (!fetched.ok) {
+                if (stopRequested() || fetched.error == QStringLiteral("backtest_cancelled")) {
+                    cancel();
+                    return;
+                }
+                // Published under the lock, so no checkpoint sees the error
+                // filed while the pair still looks pending.
+                std::lock_guard lock(resultsLock);
+                results.errors.emplace_back(pairIndex * groupCount, QJsonObject{
+                    {QStringLiteral("symbol"), pair.symbol},
+                    {QStringLiteral("interval"), pair.interval},
+                    {QStringLiteral("error"), fetched.error},
+                });
+                results.processedCount += pendingRunCount(slot);
+                publish(pairIndex, nullptr);
+                continue;
+            }
+
+            // Every group on this symbol/interval reads the same indicator
+            // signals, so compute each unique indicator once up front.
+            auto loaded = std::make_shared<LoadedPair>();
+            loaded->candles = std::move(fetched.candles);
+            loaded->signalCache = std::make_unique<NativeBacktestRuntime::SignalCache>(loaded->candles);
+            loaded->signalCache->prepare(context_.groupConfigs);
+            publish(pairIndex, std::move(loaded));
+        }
+    }
+
+    bool takeGroup(PairSlot &slot, int worker, qsizetype &groupIndex) {
+        if (slot.ranges[worker].takeFront(groupIndex)) return true;
+        for (int offset = 1; offset < workerCount_; ++offset) {
+            qsizetype begin = 0;
+            qsizetype end = 0;
+            if (!slot.ranges[(worker + offset) % workerCount_].stealBack(begin, end)) continue;
+            slot.ranges[worker].assign(begin + 1, end);
+            groupIndex = begin;
+            return true;
+        }
+        return false;
+    }
+
+    // Takes the next pending group and marks it in flight. Groups a resumed
+    // checkpoint already covers are passed over.
+    bool nextGroup(PairSlot &slot, qsizetype pairIndex, int worker, qsizetype &groupIndex) {
+        std::lock_guard lock(resultLocks_[static_cast<std::size_t>(worker)]);
+        while (takeGroup(slot, worker, groupIndex)) {
+            if (pendingGroup(slot, groupIndex)) {
+                inFlight_[static_cast<std::size_t>(worker)] = static_cast<qint64>(pairIndex) * context_.groups.size() + groupIndex;
+                return true;
+            }
+            if (--slot.remaining == 0) release(pairIndex);
+        }
+        return false;
+    }
+
+    void work(int worker) {
+        for (qsizetype pairIndex = 0; pairIndex < pairs_.size(); ++pairIndex) {
+            PairSlot &slot = slots_[static_cast<std::size_t>(pairIndex)];
+            std::shared_ptr<const LoadedPair> loaded;
+            {
+                std::unique_lock lock(mutex_);
+                changed_.wait(lock, [&]() { return cancelled_ || slot.published; });
+                if (cancelled_) return;
+                loaded = slot.loaded;
+            }
+            if (!loaded) continue;
+
+            qsizetype groupIndex = 0;
+            while (nextGroup(slot, pairIndex, worker, groupIndex)) {
+                // A group left unfinished stays in flight, so a checkpoint
+                // keeps it pending.
+                if (stopRequested() || !evaluateGroup(*loaded, pairIndex, groupIndex, worker)) {
+                    {
+                        std::lock_guard lock(resultLocks_[static_cast<std::size_t>(worker)]);
+                        results_[static_cast<std::size_t>(worker)].cancelled = true;
+                    }
+                    cancel();
+                    return;
+                }
+                if (--slot.remaining == 0) release(pairIndex);
+                reportProgressIfDue();
+                checkpointIfDue();
+            }
+        }
+    }
+
+    // Runs one group and files the outcome. Returns false on cancellation.
+    bool evaluateGroup(
+        const LoadedPair &loaded,
+        qsizetype pairIndex,
+        qsizetype groupIndex,
+        int worker) {
+        const PairTask &pair = pairs_.at(pairIndex);
+        const QStringList &group = context_.groups.at(groupIndex);
+        const qint64 ordinal = static_cast<qint64>(pairIndex) * context_.groups.size() + groupIndex;
+        const NativeBacktestBatchRuntime::BatchRequest &request = context_.request;
+
+        NativeBacktestRuntime::Request runRequest = request.runTemplate;
+        runRequest.symbol = pair.symbol;
+        runRequest.interval = pair.interval;
+        runRequest.logic = context_.effectiveLogic;
+        runRequest.indicators.clear();
+        for (const QString &key : group) {
+            runRequest.indicators.insert(key, context_.groupConfigs.value(key));
+        }
+
+        NativeBacktestRuntime::Result result = NativeBacktestRuntime::run(
+            loaded.candles,
+            runRequest,
+            context_.shouldStop,
+            loaded.signalCache.get());
+        if (!result.ok && result.error == QStringLiteral("backtest_cancelled")) return false;
+        WorkerResults &results = results_[static_cast<std::size_t>(worker)];
+        std::lock_guard lock(resultLocks_[static_cast<std::size_t>(worker)]);
+        inFlight_[static_cast<std::size_t>(worker)] = -1;
+        ++results.processedCount;
+        if (!result.ok) {
+            results.errors.emplace_back(ordinal, QJsonObject{
+                {QStringLiteral("symbol"), pair.symbol},
+                {QStringLiteral("interval"), pair.interval},
+                {QStringLiteral("indicator_keys"), QJsonArray::fromStringList(group)},
+                {QStringLiteral("error"), result.error},
+            });
+            return true;
+        }
+
+        CandidateRecord record = CandidateRecord::of(ordinal, result);
+        record.eligible = scoreEligible(result, request.optimizerMddLimit, request.optimizerMinTrades);
+        if (record.eligible) record.scoreSize = scoreValues(result, context_.scoreMetric, record.score.data());
+        ++results.candidateCount;
+        if (record.eligible) {
+            ++results.eligibleCount;
+            results.keepEligible(record, context_.resultLimit);
+        } else {
+            ++results.filteredCount;
+            results.keepRejected(record, context_.resultLimit);
+        }
+        return true;
+    }
+
+    const BatchContext &context_;
+    const QVector<PairTask> &pairs_;
+    const int workerCount_;
+    const QByteArray fingerprint_;
+    const qint64 progressIntervalMs_;
+    const int progressTopRuns_;
+    const qint64 checkpointIntervalMs_;
+    const Clock::time_point startedAt_ = Clock::now();
+    std::unique_ptr<PairSlot[]> slots_;
+    // One entry per worker plus a last one owned by the loader thread.
+    std::vector<WorkerResults> results_;
+    std::unique_ptr<std::mutex[]> resultLocks_;
+    // Ordinal each worker is evaluating, or -1. Guarded by its result lock.
+    std::vector<qint64> inFlight_;
+    qint64 resumedProcessedCount_ = 0;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    qsizetype releasedPairs_ = 0;
+    std::atomic_bool cancelled_ = false;
+    std::atomic_bool budgetExhausted_ = false;
+    std::atomic<qint64> nextProgressAtMs_;
+    std::mutex progressMutex_;
+    std::atomic<qint64> nextCheckpointAtMs_;
+    std::mutex checkpointMutex_;
+};
+
 } // namespace
 
 namespace NativeBacktestBatchRuntime {
@@ -182,54 +1284,36 @@ qint64 estimateRunCount(
     return saturatingMultiply(pairCount, std::max<qint64>(0, indicatorGroupCount));
 }
 
+QString defaultCheckpointPath() {
+    return QDir::home().filePath(QStringLiteral(".trading-bot/native_optimizer_checkpoint.bin"));
+}
+
+CheckpointSummary readCheckpointSummary(const QString &path) {
+    CheckpointSummary summary;
+    Checkpoint checkpoint;
+    if (!readCheckpoint(path, checkpoint, &summary.error)) return summary;
+    summary.ok = true;
+    summary.optimizerMode = checkpoint.optimizerMode;
+    summary.runCount = checkpoint.runCount;
+    summary.processedCount = checkpoint.processedCount;
+    return summary;
+}
+
 Score optimizerScore(
     const NativeBacktestRuntime::Result &result,
     const QString &metric,
     double mddLimit,
     int minTrades) {
     Score score;
-    QStringList reasons;
-    const int tradeFloor = std::max(0, minTrades);
-    const double limit = std::max(0.0, mddLimit);
-    if (result.trades < tradeFloor) {
-        reasons.append(QStringLiteral("trades %1 < %2").arg(result.trades).arg(tradeFloor));
-    }
-    if (limit > 0.0 && result.maxDrawdownPercent > limit) {
-        reasons.append(
-            QStringLiteral("MDD %1% > %2%")
-                .arg(result.maxDrawdownPercent, 0, 'f', 2)
-                .arg(limit, 0, 'f', 2));
-    }
-    if (!reasons.isEmpty()) {
-        score.rejectionReason = reasons.join(QStringLiteral("; "));
+    if (!scoreEligible(result, mddLimit, minTrades)) {
+        score.rejectionReason = scoreRejectionReason(result, mddLimit, minTrades);
         return score;
     }
 
     score.eligible = true;
-    const QString metricNormalized = normalizedOptimizerMetric(metric);
-    if (metricNormalized == QStringLiteral("roi_value")) {
-        score.values = {
-            result.roiValue,
-            result.roiPercent,
-            static_cast<double>(result.trades),
-            -result.maxDrawdownPercent,
-        };
-    } else if (metricNormalized == QStringLiteral("roi_drawdown")) {
-        score.values = {
-            result.roiPercent / std::max(std::abs(result.maxDrawdownPercent), 1.0),
-            result.roiPercent,
-            result.roiValue,
-            static_cast<double>(result.trades),
-            -result.maxDrawdownPercent,
-        };
-    } else {
-        score.values = {
-            result.roiPercent,
-            result.roiValue,
-            static_cast<double>(result.trades),
-            -result.maxDrawdownPercent,
-        };
-    }
+    std::array<double, kMaxScoreValues> values{};
+    const int count = scoreValues(result, scoreMetric(normalizedOptimizerMetric(metric)), values.data());
+    score.values = QVector<double>(values.cbegin(), values.cbegin() + count);
     return score;
 }
 
@@ -299,134 +1383,109 @@ QJsonObject runBatch(
     const QString effectiveLogic = originalLogic == QStringLiteral("SEPARATE")
         ? QStringLiteral("AND")
         : originalLogic;
-    std::multiset<RankedRow, BestFirst> eligibleRows;
-    QVector<QJsonObject> rejectedSamples;
-    QJsonArray errors;
-    qint64 processedCount = 0;
-    qint64 candidateCount = 0;
-    qint64 eligibleCount = 0;
-    qint64 filteredCount = 0;
-    bool cancelled = false;
-
-    snapshot.insert(QStringLiteral("state"), QStringLiteral("running"));
+    ConfigMap groupConfigs;
+    for (const QStringList &group : groups) {
+        for (const QString &key : group) {
+            if (groupConfigs.contains(key)) continue;
+            QJsonObject config = request.indicatorConfigs.value(key);
+            config.insert(QStringLiteral("enabled"), true);
+            groupConfigs.insert(key, config);
+        }
+    }
+    NativeBacktestRuntime::Request describedRequest = request.runTemplate;
+    describedRequest.logic = effectiveLogic;
+    const NativeBacktestRuntime::Result described = NativeBacktestRuntime::describe(describedRequest);
+    const BatchContext context{
+        request,
+        groups,
+        groupConfigs,
+        metric,
+        scoreMetric(metric),
+        mode,
+        scope,
+        effectiveLogic,
+        resultLimit,
+        runCount,
+        described,
+        shouldStop,
+    };
+    QVector<PairTask> pairs;
+    pairs.reserve(symbols.size() * intervals.size());
     for (const QString &symbol : symbols) {
-        for (const QString &interval : intervals) {
-            if (shouldStop && shouldStop()) {
-                cancelled = true;
-                break;
-            }
-            const CandleLoadResult loaded = loadCandles(symbol, interval, shouldStop);
-            if (!loaded.ok) {
-                if ((shouldStop && shouldStop()) || loaded.error == QStringLiteral("backtest_cancelled")) {
-                    cancelled = true;
-                    break;
-                }
-                errors.append(QJsonObject{
-                    {QStringLiteral("symbol"), symbol},
-                    {QStringLiteral("interval"), interval},
-                    {QStringLiteral("error"), loaded.error},
-                });
-                processedCount += groups.size();
-                continue;
-            }
-
-            for (const QStringList &group : groups) {
-                if (shouldStop && shouldStop()) {
-                    cancelled = true;
-                    break;
-                }
-                NativeBacktestRuntime::Request runRequest = request.runTemplate;
-                runRequest.symbol = symbol;
-                runRequest.interval = interval;
-                runRequest.logic = effectiveLogic;
-                runRequest.indicators.clear();
-                for (const QString &key : group) {
-                    QJsonObject config = request.indicatorConfigs.value(key);
-                    config.insert(QStringLiteral("enabled"), true);
-                    runRequest.indicators.insert(key, config);
-                }
-
-                NativeBacktestRuntime::Result result = NativeBacktestRuntime::run(
-                    loaded.candles,
-                    runRequest,
-                    shouldStop);
-                ++processedCount;
-                if (!result.ok) {
-                    if (result.error == QStringLiteral("backtest_cancelled")) {
-                        cancelled = true;
-                        break;
-                    }
-                    errors.append(QJsonObject{
-                        {QStringLiteral("symbol"), symbol},
-                        {QStringLiteral("interval"), interval},
-                        {QStringLiteral("indicator_keys"), QJsonArray::fromStringList(group)},
-                        {QStringLiteral("error"), result.error},
-                    });
-                    continue;
-                }
+        for (const QString &interval : intervals) pairs.append(PairTask{symbol, interval});
+    }
+    const qint64 totalRuns = static_cast<qint64>(pairs.size()) * groups.size();
+    const int requestedWorkers = request.workerThreads > 0 ? request.workerThreads : QThread::idealThreadCount();
+    const int workerCount = static_cast<int>(std::clamp<qint64>(requestedWorkers, 1, totalRuns));
 
-                QJsonObject row = result.toJson();
-                row.insert(QStringLiteral("start"), request.startDisplay);
-                row.insert(QStringLiteral("end"), request.endDisplay);
-                row.insert(QStringLiteral("loop_interval_override"), request.loopIntervalOverride);
-                row.insert(QStringLiteral("connector_backend"), request.connectorBackend);
-                const Score score = optimizerScore(
-                    result,
-                    metric,
-                    request.optimizerMddLimit,
-                    request.optimizerMinTrades);
-                row.insert(QStringLiteral("optimizer_metric"), metric);
-                row.insert(QStringLiteral("optimizer_mode"), mode);
-                row.insert(QStringLiteral("optimizer_scope"), scope);
-                row.insert(QStringLiteral("optimizer_mdd_limit"), request.optimizerMddLimit);
-                row.insert(QStringLiteral("optimizer_min_trades"), request.optimizerMinTrades);
-                row.insert(QStringLiteral("optimizer_eligible"), score.eligible);
-                row.insert(
-                    QStringLiteral("optimizer_primary_score"),
-                    score.eligible && !score.values.isEmpty()
-                        ? QJsonValue(score.values.constFirst())
-                        : QJsonValue(QJsonValue::Null));
-                row.insert(QStringLiteral("optimizer_rejection_reason"), score.rejectionReason);
-                const qint64 originalIndex = candidateCount++;
-                if (score.eligible) {
-                    ++eligibleCount;
-                    eligibleRows.insert(RankedRow{score.values, originalIndex, row});
-                    if (eligibleRows.size() > static_cast<std::size_t>(resultLimit)) {
-                        eligibleRows.erase(std::prev(eligibleRows.end()));
-                    }
-                } else {
-                    ++filteredCount;
-                    if (rejectedSamples.size() < resultLimit) rejectedSamples.append(row);
-                }
-            }
-            if (cancelled) break;
+    const QByteArray fingerprint = requestFingerprint(context, pairs);
+    BatchScheduler scheduler(context, pairs, workerCount, fingerprint);
+    if (request.resumeFromCheckpoint) {
+        Checkpoint checkpoint;
+        QString checkpointError;
+        if (request.checkpointPath.isEmpty()) {
+            checkpointError = QStringLiteral("Resuming needs an optimizer checkpoint path.");
+        } else if (!readCheckpoint(request.checkpointPath, checkpoint, &checkpointError)) {
+            checkpointError += QLatin1Char('.');
+        } else if (checkpoint.fingerprint != fingerprint || checkpoint.runCount != runCount) {
+            checkpointError = QStringLiteral("Optimizer checkpoint %1 belongs to a different batch request.")
+                                  .arg(request.checkpointPath);
         }
-        if (cancelled) break;
+        if (!checkpointError.isEmpty()) {
+            snapshot.insert(QStringLiteral("state"), QStringLiteral("failed"));
+            snapshot.insert(QStringLiteral("status_message"), checkpointError);
+            return snapshot;
+        }
+        scheduler.resumeFrom(std::move(checkpoint));
     }
 
-    QVector<QJsonObject> finalRows;
-    if (!eligibleRows.empty()) {
-        finalRows.reserve(static_cast<qsizetype>(eligibleRows.size()));
-        int rank = 1;
-        for (const RankedRow &ranked : eligibleRows) {
-            QJsonObject row = ranked.row;
-            row.insert(QStringLiteral("optimizer_rank"), rank++);
-            finalRows.append(row);
-        }
-    } else {
-        finalRows = rejectedSamples;
-        for (QJsonObject &row : finalRows) {
-            row.insert(QStringLiteral("optimizer_rank"), QJsonValue(QJsonValue::Null));
+    snapshot.insert(QStringLiteral("state"), QStringLiteral("running"));
+    scheduler.run(loadCandles);
+    if (!request.checkpointPath.isEmpty()) {
+        // Before merging, which moves the partial results out. A batch that
+        // stopped early leaves a checkpoint to resume from; one that ran its
+        // whole plan leaves nothing behind.
+        bool checkpointSaved = false;
+        if (scheduler.cancelled()) {
+            QString checkpointError;
+            checkpointSaved = scheduler.saveCheckpoint(&checkpointError);
+            if (!checkpointSaved) snapshot.insert(QStringLiteral("checkpoint_error"), checkpointError);
+        } else {
+            QFile::remove(request.checkpointPath);
         }
+        snapshot.insert(QStringLiteral("checkpoint_path"), request.checkpointPath);
+        snapshot.insert(QStringLiteral("checkpoint_saved"), checkpointSaved);
+        snapshot.insert(QStringLiteral("resumed_from_checkpoint"), request.resumeFromCheckpoint);
     }
-    for (QJsonObject &row : finalRows) {
+    const WorkerResults merged = scheduler.mergedResults();
+    const qint64 processedCount = merged.processedCount;
+    const qint64 candidateCount = merged.candidateCount;
+    const qint64 eligibleCount = merged.eligibleCount;
+    const qint64 filteredCount = merged.filteredCount;
+    const bool cancelled = merged.cancelled;
+    const bool budgetExhausted = scheduler.budgetExhausted();
+    QJsonArray errors;
+    for (const auto &error : merged.errors) errors.append(error.second);
+    snapshot.insert(QStringLiteral("worker_threads"), workerCount);
+
+    // Only the returned rows are turned into JSON.
+    QJsonArray rows;
+    const auto appendRow = [&](const CandidateRecord &record, const QJsonValue &rank) {
+        QJsonObject row = candidateRow(record, context, pairs);
+        row.insert(QStringLiteral("optimizer_rank"), rank);
         row.insert(QStringLiteral("optimizer_candidate_count"), static_cast<double>(candidateCount));
         row.insert(QStringLiteral("optimizer_eligible_count"), static_cast<double>(eligibleCount));
         row.insert(QStringLiteral("optimizer_filtered_count"), static_cast<double>(filteredCount));
         row.insert(QStringLiteral("optimizer_run_count"), static_cast<double>(runCount));
+        rows.append(row);
+    };
+    if (!merged.eligibleRows.empty()) {
+        int rank = 1;
+        for (const CandidateRecord &record : merged.eligibleRows) appendRow(record, rank++);
+    } else {
+        for (const auto &sample : merged.rejectedSamples) appendRow(sample.second, QJsonValue(QJsonValue::Null));
     }
 
-    const QJsonArray rows = rowsToArray(finalRows);
     snapshot.insert(QStringLiteral("runs"), rows);
     snapshot.insert(QStringLiteral("top_runs"), rows);
     if (!rows.isEmpty()) snapshot.insert(QStringLiteral("top_run"), rows.at(0));
@@ -439,7 +1498,18 @@ QJsonObject runBatch(
         QStringLiteral("progress_percent"),
         runCount > 0 ? std::min(100.0, static_cast<double>(processedCount) / static_cast<double>(runCount) * 100.0) : 100.0);
 
-    if (cancelled) {
+    snapshot.insert(QStringLiteral("time_budget_exhausted"), cancelled && budgetExhausted);
+
+    if (cancelled && budgetExhausted) {
+        snapshot.insert(QStringLiteral("state"), QStringLiteral("cancelled"));
+        snapshot.insert(QStringLiteral("cancelled"), true);
+        snapshot.insert(
+            QStringLiteral("status_message"),
+            QStringLiteral("Native C++ backtest reached its %1 s time budget after %2 of %3 run(s).")
+                .arg(static_cast<double>(request.timeBudgetMs) / 1000.0, 0, 'g', 6)
+                .arg(processedCount)
+                .arg(runCount));
+    } else if (cancelled) {
         snapshot.insert(QStringLiteral("state"), QStringLiteral("cancelled"));
         snapshot.insert(QStringLiteral("cancelled"), true);
         snapshot.insert(
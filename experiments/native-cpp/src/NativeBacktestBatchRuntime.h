@@ -15,11 +15,14 @@ inline constexpr int kDefaultResultLimit = 5'000;
 
 struct CandleLoadResult {
     bool ok = false;
-    QVector<NativeIndicatorRuntime::Candle> candles;
+    NativeIndicatorRuntime::CandleColumns candles;
     QString error;
 };
 
 using StopCallback = std::function<bool()>;
+// Receives a "running" snapshot: the final snapshot's counters and top_runs
+// plus elapsed_ms, runs_per_second and eta_ms. Called on a worker thread.
+using ProgressCallback = std::function<void(const QJsonObject &snapshot)>;
 using CandleLoader = std::function<CandleLoadResult(
     const QString &symbol,
     const QString &interval,
@@ -38,10 +41,42 @@ struct BatchRequest {
     double optimizerMddLimit = 0.0;
     int resultLimit = kDefaultResultLimit;
     qint64 maxRunCount = kMaxOptimizerRuns;
+    // Threads evaluating groups; 0 uses one per core. Results are identical
+    // for every value.
+    int workerThreads = 0;
     QString startDisplay;
     QString endDisplay;
     QString loopIntervalOverride;
     QString connectorBackend;
+    // Optional. Snapshots are built only when one is due, at most once per
+    // progressIntervalMs, with the best progressTopRuns rows so far. A
+    // negative value uses the scheduler's default (1 s, 10 rows).
+    ProgressCallback onProgress;
+    qint64 progressIntervalMs = -1;
+    int progressTopRuns = -1;
+    // Wall-clock limit for the whole batch; 0 is unlimited. When it runs out
+    // the batch stops like a cancellation, keeps the rows ranked so far and
+    // reports time_budget_exhausted.
+    qint64 timeBudgetMs = 0;
+    // Optional. The batch rewrites a binary checkpoint here every
+    // checkpointIntervalMs (negative: every minute) and whenever it stops
+    // early (cancellation or the time budget), and removes it once the plan
+    // has run to the end.
+    QString checkpointPath;
+    qint64 checkpointIntervalMs = -1;
+    // Continues from checkpointPath: runs already evaluated are skipped and
+    // their counters and kept rows carried over, so the final snapshot is the
+    // one an uninterrupted batch would report. The batch fails if the
+    // checkpoint belongs to a different request.
+    bool resumeFromCheckpoint = false;
+};
+
+struct CheckpointSummary {
+    bool ok = false;
+    QString error;
+    QString optimizerMode;
+    qint64 runCount = 0;
+    qint64 processedCount = 0;
 };
 
 struct Score {
@@ -67,6 +102,14 @@ Score optimizerScore(
     double mddLimit,
     int minTrades);
 
+QString defaultCheckpointPath();
+
+// Reads only the header of a checkpoint written by runBatch.
+CheckpointSummary readCheckpointSummary(const QString &path);
+
+// loadCandles is called from a long-lived loader thread shared with later
+// batches, one symbol/interval at a time in plan order; shouldStop is polled
+// from every worker thread.
 QJsonObject runBatch(
     const BatchRequest &request,
     const CandleLoader &loadCandles,
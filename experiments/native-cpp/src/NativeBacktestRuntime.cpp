@@ -1,27 +1,61 @@
 #include "NativeBacktestRuntime.h"
+#include "NativeSignalBits.h"
+#include "NativeStopLoss.h"
 
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonValue>
 
 #include <algorithm>
 #include <cmath>
+#include <deque>
 #include <limits>
 #include <optional>
 #include <utility>
 
+namespace NativeBacktestRuntime {
+
+struct IndicatorSignals {
+    QString key;
+    bool filter = false;
+    std::optional<NativeSignalBits::SignalBits> buy;
+    std::optional<NativeSignalBits::SignalBits> sell;
+    std::optional<NativeSignalBits::SignalBits> gate;
+    QString error;
+};
+
+} // namespace NativeBacktestRuntime
+
 namespace {
 
-using Candle = NativeIndicatorRuntime::Candle;
+using NativeBacktestRuntime::IndicatorSignals;
+using NativeIndicatorRuntime::CandleSpan;
+using NativeSignalBits::SignalBits;
 using ConfigMap = NativeIndicatorRuntime::ConfigMap;
 using Series = NativeIndicatorRuntime::Series;
 using SeriesMap = NativeIndicatorRuntime::SeriesMap;
 
-struct IndicatorSignals {
-    QString key;
-    bool filter = false;
-    std::optional<QVector<bool>> buy;
-    std::optional<QVector<bool>> sell;
-    std::optional<QVector<bool>> gate;
+enum class SignalLogic { And, Or };
+enum class TradeSide { Buy, Sell, Both };
+enum class MddLogic { PerTrade, Cumulative, EntireAccount };
+enum class MarginMode { Isolated, Cross };
+enum class Direction { None, Long, Short };
+
+// Request normalized once up front; the candle loop only reads this.
+struct CompiledRequest {
+    SignalLogic logic = SignalLogic::And;
+    TradeSide side = TradeSide::Both;
+    MddLogic mddLogic = MddLogic::PerTrade;
+    MarginMode marginMode = MarginMode::Isolated;
+    bool stopLossEnabled = false;
+    NativeStopLoss::Limits stopLoss;
+    double capital = 0.0;
+    double leverage = 1.0;
+    double positionFraction = 1.0;
+    double feeBps = 0.0;
+    double slippageBps = 0.0;
+    double feeRate = 0.0;
+    double slippageRate = 0.0;
 };
 
 struct DrawdownState {
@@ -32,7 +66,7 @@ struct DrawdownState {
 
 struct TradeState {
     bool active = false;
-    QString direction;
+    Direction direction = Direction::None;
     double entryPrice = 0.0;
     double peakPrice = 0.0;
     double troughPrice = 0.0;
@@ -106,17 +140,17 @@ Series rawSeries(const SeriesMap &series, const QString &key, int size) {
     return output;
 }
 
-Series relativeVolume(const QVector<Candle> &candles, int length) {
+Series relativeVolume(CandleSpan candles, int length) {
     Series output(candles.size(), std::numeric_limits<double>::quiet_NaN());
     double rolling = 0.0;
     for (int index = 0; index < candles.size(); ++index) {
-        rolling += candles[index].volume;
+        rolling += candles.volume[index];
         if (index >= length) {
-            rolling -= candles[index - length].volume;
+            rolling -= candles.volume[index - length];
         }
         if (index + 1 >= length) {
             const double mean = rolling / static_cast<double>(length);
-            output[index] = mean == 0.0 ? std::numeric_limits<double>::quiet_NaN() : candles[index].volume / mean;
+            output[index] = mean == 0.0 ? std::numeric_limits<double>::quiet_NaN() : candles.volume[index] / mean;
         }
     }
     return output;
@@ -125,7 +159,7 @@ Series relativeVolume(const QVector<Candle> &candles, int length) {
 Series backtestSeries(
     const QString &key,
     const QJsonObject &config,
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     const SeriesMap &computed) {
     const int size = candles.size();
     const QString mode = configText(config, QStringLiteral("signal_mode")).toLower();
@@ -169,7 +203,7 @@ Series backtestSeries(
         Series output(size, 0.0);
         for (int index = 0; index < size; ++index) {
             if (std::isfinite(baseline[index])) {
-                output[index] = candles[index].close - baseline[index];
+                output[index] = candles.close[index] - baseline[index];
             }
         }
         return output;
@@ -195,7 +229,7 @@ Series backtestSeries(
             for (int index = 0; index < size; ++index) {
                 const double range = upper[index] - lower[index];
                 if (std::isfinite(range) && range != 0.0 && std::isfinite(lower[index])) {
-                    output[index] = ((candles[index].close - lower[index]) / range) * 100.0;
+                    output[index] = ((candles.close[index] - lower[index]) / range) * 100.0;
                 }
             }
             return output;
@@ -205,8 +239,8 @@ Series backtestSeries(
     if (mode == QStringLiteral("percent_of_close")) {
         Series output(size, 0.0);
         for (int index = 0; index < size; ++index) {
-            if (candles[index].close != 0.0 && std::isfinite(baseline[index])) {
-                output[index] = (baseline[index] / candles[index].close) * 100.0;
+            if (candles.close[index] != 0.0 && std::isfinite(baseline[index])) {
+                output[index] = (baseline[index] / candles.close[index]) * 100.0;
             }
         }
         return output;
@@ -214,19 +248,18 @@ Series backtestSeries(
     return baseline;
 }
 
-QVector<bool> thresholdEvents(
+SignalBits thresholdEvents(
     const Series &series,
     double threshold,
     bool lessOrEqual) {
-    QVector<bool> events(series.size(), false);
     bool previous = false;
-    for (int index = 0; index < series.size(); ++index) {
+    return SignalBits::fromPredicate(series.size(), [&](qsizetype index) {
         const double value = series[index];
         const bool current = std::isfinite(value) && (lessOrEqual ? value <= threshold : value >= threshold);
-        events[index] = current && !previous;
+        const bool event = current && !previous;
         previous = current;
-    }
-    return events;
+        return event;
+    });
 }
 
 QString normalizedFilterOperator(const QJsonObject &config) {
@@ -246,31 +279,34 @@ std::optional<double> filterThreshold(const QJsonObject &config) {
     return configNumber(config, QStringLiteral("sell_value"));
 }
 
-std::optional<QVector<bool>> filterState(const Series &series, const QJsonObject &config) {
+std::optional<SignalBits> filterState(const Series &series, const QJsonObject &config) {
     const QString op = normalizedFilterOperator(config);
-    QVector<bool> output(series.size(), false);
+    const qsizetype size = series.size();
     if (op == QStringLiteral("between") || op == QStringLiteral("outside")) {
         const auto buy = configNumber(config, QStringLiteral("buy_value"));
         const auto sell = configNumber(config, QStringLiteral("sell_value"));
         if (!buy || !sell) return std::nullopt;
         const double lower = std::min(*buy, *sell);
         const double upper = std::max(*buy, *sell);
-        for (int index = 0; index < series.size(); ++index) {
+        const bool outside = op == QStringLiteral("outside");
+        return SignalBits::fromPredicate(size, [&](qsizetype index) {
             const bool between = std::isfinite(series[index]) && series[index] >= lower && series[index] <= upper;
-            output[index] = op == QStringLiteral("outside") ? !between : between;
-        }
-        return output;
+            return outside ? !between : between;
+        });
     }
     const auto threshold = filterThreshold(config);
     if (!threshold) return std::nullopt;
-    for (int index = 0; index < series.size(); ++index) {
-        if (!std::isfinite(series[index])) continue;
-        if (op == QStringLiteral("gt")) output[index] = series[index] > *threshold;
-        else if (op == QStringLiteral("lte")) output[index] = series[index] <= *threshold;
-        else if (op == QStringLiteral("lt")) output[index] = series[index] < *threshold;
-        else output[index] = series[index] >= *threshold;
+    const double limit = *threshold;
+    if (op == QStringLiteral("gt")) {
+        return SignalBits::fromPredicate(size, [&](qsizetype index) { return std::isfinite(series[index]) && series[index] > limit; });
     }
-    return output;
+    if (op == QStringLiteral("lte")) {
+        return SignalBits::fromPredicate(size, [&](qsizetype index) { return std::isfinite(series[index]) && series[index] <= limit; });
+    }
+    if (op == QStringLiteral("lt")) {
+        return SignalBits::fromPredicate(size, [&](qsizetype index) { return std::isfinite(series[index]) && series[index] < limit; });
+    }
+    return SignalBits::fromPredicate(size, [&](qsizetype index) { return std::isfinite(series[index]) && series[index] >= limit; });
 }
 
 bool isFilter(const QJsonObject &config) {
@@ -293,196 +329,135 @@ void updateDrawdown(DrawdownState &state, double equity) {
     state.maxPct = std::max(state.maxPct, value / state.peak * 100.0);
 }
 
-QJsonArray stringArray(const QStringList &values) {
-    QJsonArray output;
-    for (const QString &value : values) output.append(value);
-    return output;
+template <typename Enum>
+Enum parseToken(const QString &token, std::initializer_list<std::pair<const char *, Enum>> choices, Enum fallback) {
+    for (const auto &[text, value] : choices) {
+        if (token == QLatin1String(text)) return value;
+    }
+    return fallback;
 }
 
-} // namespace
+CompiledRequest compileRequest(const NativeBacktestRuntime::Request &request) {
+    CompiledRequest compiled;
+    compiled.logic = request.logic.trimmed().toUpper() == QStringLiteral("AND") ? SignalLogic::And : SignalLogic::Or;
+    compiled.side = parseToken(
+        request.side.trimmed().toUpper(),
+        {{"BUY", TradeSide::Buy}, {"SELL", TradeSide::Sell}, {"BOTH", TradeSide::Both}},
+        TradeSide::Both);
+    compiled.mddLogic = parseToken(
+        request.mddLogic.trimmed().toLower(),
+        {{"per_trade", MddLogic::PerTrade}, {"cumulative", MddLogic::Cumulative}, {"entire_account", MddLogic::EntireAccount}},
+        MddLogic::PerTrade);
+    compiled.marginMode = request.marginMode.trimmed().toUpper() == QStringLiteral("CROSS") ? MarginMode::Cross : MarginMode::Isolated;
+    compiled.stopLossEnabled = request.stopLossEnabled;
+    compiled.stopLoss.mode = NativeStopLoss::parseMode(request.stopLossMode);
+    compiled.stopLoss.scope = NativeStopLoss::parseScope(request.stopLossScope);
+    compiled.capital = request.capital;
+    compiled.leverage = std::max(1.0, request.leverage);
+    compiled.stopLoss.usdt = std::max(0.0, request.stopLossUsdt);
+    compiled.stopLoss.percent = std::max(0.0, request.stopLossPercent);
+    compiled.feeBps = std::max(0.0, request.feeBps);
+    compiled.slippageBps = std::max(0.0, request.slippageBps);
+    compiled.feeRate = compiled.feeBps / 10000.0;
+    compiled.slippageRate = compiled.slippageBps / 10000.0;
 
-namespace NativeBacktestRuntime {
-
-QJsonObject Result::toJson() const {
-    return {
-        {QStringLiteral("ok"), ok},
-        {QStringLiteral("error"), error},
-        {QStringLiteral("symbol"), symbol},
-        {QStringLiteral("interval"), interval},
-        {QStringLiteral("indicator_keys"), stringArray(indicatorKeys)},
-        {QStringLiteral("trades"), trades},
-        {QStringLiteral("roi_value"), roiValue},
-        {QStringLiteral("roi_percent"), roiPercent},
-        {QStringLiteral("final_equity"), finalEquity},
-        {QStringLiteral("max_drawdown_value"), maxDrawdownValue},
-        {QStringLiteral("max_drawdown_percent"), maxDrawdownPercent},
-        {QStringLiteral("max_drawdown_during_value"), maxDrawdownDuringValue},
-        {QStringLiteral("max_drawdown_during_percent"), maxDrawdownDuringPercent},
-        {QStringLiteral("max_drawdown_result_value"), maxDrawdownResultValue},
-        {QStringLiteral("max_drawdown_result_percent"), maxDrawdownResultPercent},
-        {QStringLiteral("logic"), logic},
-        {QStringLiteral("leverage"), leverage},
-        {QStringLiteral("mdd_logic"), mddLogic},
-        {QStringLiteral("side"), side},
-        {QStringLiteral("capital"), capital},
-        {QStringLiteral("position_pct"), positionPct},
-        {QStringLiteral("position_pct_units"), positionPctUnits},
-        {QStringLiteral("stop_loss_enabled"), stopLossEnabled},
-        {QStringLiteral("stop_loss_mode"), stopLossMode},
-        {QStringLiteral("stop_loss_usdt"), stopLossUsdt},
-        {QStringLiteral("stop_loss_percent"), stopLossPercent},
-        {QStringLiteral("stop_loss_scope"), stopLossScope},
-        {QStringLiteral("margin_mode"), marginMode},
-        {QStringLiteral("position_mode"), positionMode},
-        {QStringLiteral("assets_mode"), assetsMode},
-        {QStringLiteral("account_mode"), accountMode},
-        {QStringLiteral("fee_bps"), feeBps},
-        {QStringLiteral("slippage_bps"), slippageBps},
-        {QStringLiteral("fees_paid"), feesPaid},
-        {QStringLiteral("source"), QStringLiteral("native-cpp-backtest")},
-    };
+    const QString pctUnits = request.positionPctUnits.trimmed().toLower();
+    double pctFraction = request.positionPct;
+    if (QStringList{QStringLiteral("percent"), QStringLiteral("%"), QStringLiteral("perc")}.contains(pctUnits)) pctFraction /= 100.0;
+    else if (!QStringList{QStringLiteral("fraction"), QStringLiteral("decimal"), QStringLiteral("ratio")}.contains(pctUnits) && pctFraction > 1.0) pctFraction /= 100.0;
+    compiled.positionFraction = std::clamp(pctFraction, 0.0001, 1.0);
+    return compiled;
 }
 
-Result run(
-    const QVector<Candle> &candles,
-    const Request &request,
-    const std::function<bool()> &shouldStop) {
-    Result result;
+// The descriptive half of a Result: everything except the simulation figures.
+NativeBacktestRuntime::Result describeResult(const CompiledRequest &compiled, const NativeBacktestRuntime::Request &request) {
+    static const QString sideNames[] = {QStringLiteral("BUY"), QStringLiteral("SELL"), QStringLiteral("BOTH")};
+    static const QString scopeNames[] = {QStringLiteral("per_trade"), QStringLiteral("cumulative"), QStringLiteral("entire_account")};
+    NativeBacktestRuntime::Result result;
     result.symbol = request.symbol.trimmed().toUpper();
     result.interval = request.interval.trimmed();
-    result.logic = request.logic.trimmed().toUpper();
-    if (result.logic != QStringLiteral("AND")) result.logic = QStringLiteral("OR");
-    result.side = request.side.trimmed().toUpper();
-    if (!QStringList{QStringLiteral("BUY"), QStringLiteral("SELL"), QStringLiteral("BOTH")}.contains(result.side)) result.side = QStringLiteral("BOTH");
-    result.capital = request.capital;
-    result.leverage = std::max(1.0, request.leverage);
+    result.logic = compiled.logic == SignalLogic::And ? QStringLiteral("AND") : QStringLiteral("OR");
+    result.side = sideNames[static_cast<int>(compiled.side)];
+    result.capital = compiled.capital;
+    result.leverage = compiled.leverage;
     result.marginMode = request.marginMode.trimmed().toUpper();
     result.positionMode = request.positionMode.trimmed();
     result.assetsMode = request.assetsMode.trimmed();
     result.accountMode = request.accountMode.trimmed();
-    result.mddLogic = request.mddLogic.trimmed().toLower();
-    if (!QStringList{QStringLiteral("per_trade"), QStringLiteral("cumulative"), QStringLiteral("entire_account")}.contains(result.mddLogic)) result.mddLogic = QStringLiteral("per_trade");
-    result.stopLossEnabled = request.stopLossEnabled;
-    result.stopLossMode = request.stopLossMode.trimmed().toLower();
-    if (!QStringList{QStringLiteral("usdt"), QStringLiteral("percent"), QStringLiteral("both")}.contains(result.stopLossMode)) result.stopLossMode = QStringLiteral("usdt");
-    result.stopLossUsdt = std::max(0.0, request.stopLossUsdt);
-    result.stopLossPercent = std::max(0.0, request.stopLossPercent);
-    result.stopLossScope = request.stopLossScope.trimmed().toLower();
-    if (!QStringList{QStringLiteral("per_trade"), QStringLiteral("cumulative"), QStringLiteral("entire_account")}.contains(result.stopLossScope)) result.stopLossScope = QStringLiteral("per_trade");
-    result.feeBps = std::max(0.0, request.feeBps);
-    result.slippageBps = std::max(0.0, request.slippageBps);
-    const double feeRate = result.feeBps / 10000.0;
-    const double slippageRate = result.slippageBps / 10000.0;
-
-    const QString pctUnits = request.positionPctUnits.trimmed().toLower();
-    double pctFraction = request.positionPct;
-    if (QStringList{QStringLiteral("percent"), QStringLiteral("%"), QStringLiteral("perc")}.contains(pctUnits)) pctFraction /= 100.0;
-    else if (!QStringList{QStringLiteral("fraction"), QStringLiteral("decimal"), QStringLiteral("ratio")}.contains(pctUnits) && pctFraction > 1.0) pctFraction /= 100.0;
-    pctFraction = std::clamp(pctFraction, 0.0001, 1.0);
-    result.positionPct = pctFraction;
+    result.mddLogic = scopeNames[static_cast<int>(compiled.mddLogic)];
+    result.stopLossEnabled = compiled.stopLossEnabled;
+    result.stopLossMode = NativeStopLoss::modeName(compiled.stopLoss.mode);
+    result.stopLossUsdt = compiled.stopLoss.usdt;
+    result.stopLossPercent = compiled.stopLoss.percent;
+    result.stopLossScope = NativeStopLoss::scopeName(compiled.stopLoss.scope);
+    result.feeBps = compiled.feeBps;
+    result.slippageBps = compiled.slippageBps;
+    result.positionPct = compiled.positionFraction;
     result.positionPctUnits = QStringLiteral("fraction");
+    return result;
+}
 
-    if (candles.isEmpty()) {
-        result.error = QStringLiteral("Backtest requires at least one candle");
-        return result;
-    }
-    if (result.capital <= 0.0 || !std::isfinite(result.capital)) {
-        result.error = QStringLiteral("Backtest capital must be positive");
-        return result;
-    }
-    const QStringList unsupported = NativeIndicatorRuntime::unsupportedEnabledIndicatorKeys(request.indicators);
-    if (!unsupported.isEmpty()) {
-        result.error = QStringLiteral("Unsupported native backtest indicators: %1").arg(unsupported.join(QStringLiteral(", ")));
-        return result;
-    }
+struct EntrySignals {
+    const SignalBits &rawBuy;
+    const SignalBits &rawSell;
+    const SignalBits &gatedBuy;
+    const SignalBits &gatedSell;
+};
 
-    const SeriesMap computed = NativeIndicatorRuntime::computeConfiguredSeries(candles, request.indicators);
-    QVector<IndicatorSignals> indicatorSignals;
-    for (auto it = request.indicators.cbegin(); it != request.indicators.cend(); ++it) {
-        const QJsonObject config = it.value();
-        if (!configBool(config, QStringLiteral("enabled"))) continue;
-        IndicatorSignals indicatorSignal;
-        indicatorSignal.key = it.key();
-        indicatorSignal.filter = isFilter(config);
-        const Series series = backtestSeries(it.key(), config, candles, computed);
-        if (indicatorSignal.filter) {
-            indicatorSignal.gate = filterState(series, config);
-            if (!indicatorSignal.gate) {
-                result.error = QStringLiteral("Backtest filter '%1' is missing a valid threshold rule").arg(it.key());
-                return result;
-            }
-        } else {
-            const auto buy = configNumber(config, QStringLiteral("buy_value"));
-            const auto sell = configNumber(config, QStringLiteral("sell_value"));
-            if (!buy && !sell) {
-                result.error = QStringLiteral("Backtest indicator '%1' is missing buy/sell values").arg(it.key());
-                return result;
-            }
-            if (buy) indicatorSignal.buy = thresholdEvents(series, *buy, sell && *buy < *sell);
-            if (sell) indicatorSignal.sell = thresholdEvents(series, *sell, !(buy && *buy < *sell));
-        }
-        indicatorSignals.append(indicatorSignal);
-        result.indicatorKeys.append(it.key());
-    }
+struct SimulationOutcome {
+    bool cancelled = false;
+    int trades = 0;
+    double finalEquity = 0.0;
+    double feesPaid = 0.0;
+    DrawdownState maxDrawdown;
+    DrawdownState tradeDuring;
+    DrawdownState tradeResult;
+};
 
-    QVector<const QVector<bool> *> buyArrays;
-    QVector<const QVector<bool> *> sellArrays;
-    QVector<const QVector<bool> *> filterArrays;
-    for (const IndicatorSignals &indicatorSignal : indicatorSignals) {
-        if (indicatorSignal.buy) buyArrays.append(&*indicatorSignal.buy);
-        if (indicatorSignal.sell) sellArrays.append(&*indicatorSignal.sell);
-        if (indicatorSignal.gate) filterArrays.append(&*indicatorSignal.gate);
-    }
-    if (buyArrays.isEmpty() && sellArrays.isEmpty()) {
-        result.error = QStringLiteral("At least one signal indicator is required; filter-only indicators cannot open trades.");
-        return result;
-    }
+inline double entryExecutionPrice(double marketPrice, Direction direction, double slippageRate) {
+    return marketPrice * (direction == Direction::Long ? 1.0 + slippageRate : 1.0 - slippageRate);
+}
 
-    const int size = candles.size();
-    QVector<bool> rawBuy(size, false);
-    QVector<bool> rawSell(size, false);
-    QVector<bool> entryFilter(size, true);
-    const auto combine = [&result, size](const QVector<const QVector<bool> *> &arrays) {
-        QVector<bool> output(size, false);
-        if (arrays.isEmpty()) return output;
-        for (int index = 0; index < size; ++index) {
-            bool value = result.logic == QStringLiteral("AND");
-            for (const QVector<bool> *array : arrays) {
-                if (result.logic == QStringLiteral("AND")) value = value && array->value(index, false);
-                else value = value || array->value(index, false);
-            }
-            output[index] = value;
-        }
-        return output;
-    };
-    rawBuy = combine(buyArrays);
-    rawSell = combine(sellArrays);
-    for (int index = 0; index < size; ++index) {
-        for (const QVector<bool> *array : filterArrays) entryFilter[index] = entryFilter[index] && array->value(index, false);
-    }
+inline double exitExecutionPrice(double marketPrice, Direction direction, double slippageRate) {
+    return marketPrice * (direction == Direction::Long ? 1.0 - slippageRate : 1.0 + slippageRate);
+}
 
-    const bool canLong = result.side == QStringLiteral("BUY") || result.side == QStringLiteral("BOTH");
-    const bool canShort = result.side == QStringLiteral("SELL") || result.side == QStringLiteral("BOTH");
-    double equity = result.capital;
+// The candle loop, specialized on the settings that branch on every bar so
+// the unused drawdown, margin and stop-loss paths compile away.
+template <MddLogic Mdd, MarginMode Margin, bool StopLossEnabled>
+SimulationOutcome simulate(
+    const CompiledRequest &compiled,
+    CandleSpan candles,
+    const EntrySignals &entrySignals,
+    const std::function<bool()> &shouldStop) {
+    SimulationOutcome outcome;
+    const double feeRate = compiled.feeRate;
+    const double slippageRate = compiled.slippageRate;
+    const double pctFraction = compiled.positionFraction;
+    const bool canLong = compiled.side != TradeSide::Sell;
+    const bool canShort = compiled.side != TradeSide::Buy;
+    double effectiveLeverage = compiled.leverage;
+    if constexpr (Margin == MarginMode::Cross) effectiveLeverage = std::max(1.0, compiled.leverage * pctFraction);
+
+    double equity = compiled.capital;
     bool positionOpen = false;
     double entryPrice = 0.0;
     double units = 0.0;
     double positionMargin = 0.0;
     double feesPaid = 0.0;
-    QString direction;
+    Direction direction = Direction::None;
     DrawdownState cumulative{equity, 0.0, 0.0};
     DrawdownState account{equity, 0.0, 0.0};
     DrawdownState perTrade;
-    DrawdownState tradeDuring;
-    DrawdownState tradeResult;
+    DrawdownState &tradeDuring = outcome.tradeDuring;
+    DrawdownState &tradeResult = outcome.tradeResult;
     TradeState trade;
 
-    const auto recordEquity = [&cumulative, &account, &result](double value) {
+    const auto recordEquity = [&cumulative, &account](double value) {
         updateDrawdown(cumulative, value);
-        if (result.mddLogic == QStringLiteral("entire_account")) updateDrawdown(account, value);
+        if constexpr (Mdd == MddLogic::EntireAccount) updateDrawdown(account, value);
     };
-    const auto resetTrade = [&trade]() { trade = TradeState{}; };
-    const auto startTrade = [&trade, &entryPrice](const QString &tradeDirection, double tradeUnits, double entryFee) {
+    const auto startTrade = [&trade, &entryPrice](Direction tradeDirection, double tradeUnits, double entryFee) {
         const double absoluteUnits = std::abs(tradeUnits);
         if (absoluteUnits <= 0.0 || entryPrice <= 0.0) return;
         trade.active = true;
@@ -497,7 +472,7 @@ Result run(
     const auto updateTrade = [&trade, &tradeDuring](double price, double high, double low) {
         if (!trade.active || trade.units <= 0.0) return;
         double drawdownPrice = 0.0;
-        if (trade.direction == QStringLiteral("LONG")) {
+        if (trade.direction == Direction::Long) {
             trade.peakPrice = std::max(trade.peakPrice, high);
             drawdownPrice = std::max(0.0, trade.peakPrice - std::min(low, price));
         } else {
@@ -511,22 +486,24 @@ Result run(
         tradeDuring.maxValue = std::max(tradeDuring.maxValue, value);
         tradeDuring.maxPct = std::max(tradeDuring.maxPct, pct);
     };
-    const auto finalizeTrade = [&trade, &tradeDuring, &tradeResult, &perTrade, &result, &resetTrade](
+    const auto finalizeTrade = [&trade, &tradeDuring, &tradeResult, &perTrade](
                                   std::optional<double> exitPrice,
                                   std::optional<double> realizedPnl = std::nullopt) {
         if (!trade.active) return;
         tradeDuring.maxValue = std::max(tradeDuring.maxValue, trade.maxValue);
         tradeDuring.maxPct = std::max(tradeDuring.maxPct, trade.maxPct);
-        if (result.mddLogic == QStringLiteral("per_trade") && trade.maxValue > perTrade.maxValue) {
-            perTrade.maxValue = trade.maxValue;
-            perTrade.maxPct = trade.maxPct;
+        if constexpr (Mdd == MddLogic::PerTrade) {
+            if (trade.maxValue > perTrade.maxValue) {
+                perTrade.maxValue = trade.maxValue;
+                perTrade.maxPct = trade.maxPct;
+            }
         }
         double lossValue = 0.0;
         double lossPct = 0.0;
         if (trade.units > 0.0 && trade.entryPrice > 0.0) {
             const double exit = exitPrice.value_or(trade.entryPrice);
             const double pnl = realizedPnl.value_or(
-                trade.direction == QStringLiteral("LONG")
+                trade.direction == Direction::Long
                     ? (exit - trade.entryPrice) * trade.units
                     : (trade.entryPrice - exit) * trade.units) - trade.entryFee;
             if (pnl < 0.0) {
@@ -536,171 +513,393 @@ Result run(
         }
         tradeResult.maxValue = std::max(tradeResult.maxValue, lossValue);
         tradeResult.maxPct = std::max(tradeResult.maxPct, lossPct);
-        resetTrade();
-    };
-    const auto entryExecutionPrice = [slippageRate](double marketPrice, const QString &tradeDirection) {
-        return marketPrice * (tradeDirection == QStringLiteral("LONG") ? 1.0 + slippageRate : 1.0 - slippageRate);
+        trade = TradeState{};
     };
-    const auto exitExecutionPrice = [slippageRate](double marketPrice, const QString &tradeDirection) {
-        return marketPrice * (tradeDirection == QStringLiteral("LONG") ? 1.0 - slippageRate : 1.0 + slippageRate);
-    };
-    const auto realizeClose = [&direction, &entryPrice, &units, &feesPaid, feeRate, &exitExecutionPrice](double marketPrice) {
-        const double exitPrice = exitExecutionPrice(marketPrice, direction);
-        const double grossPnl = direction == QStringLiteral("LONG")
+    const auto realizeClose = [&direction, &entryPrice, &units, &feesPaid, feeRate, slippageRate](double marketPrice) {
+        const double exitPrice = exitExecutionPrice(marketPrice, direction, slippageRate);
+        const double grossPnl = direction == Direction::Long
             ? (exitPrice - entryPrice) * units
             : (entryPrice - exitPrice) * units;
         const double exitFee = std::abs(exitPrice * units) * feeRate;
         feesPaid += exitFee;
         return std::make_pair(exitPrice, grossPnl - exitFee);
     };
+    const auto closePosition = [&positionOpen, &units, &positionMargin, &direction]() {
+        positionOpen = false;
+        units = 0.0;
+        positionMargin = 0.0;
+        direction = Direction::None;
+    };
 
-    resetTrade();
     recordEquity(equity);
-    for (int index = 0; index < size; ++index) {
+    const qsizetype size = candles.size();
+    for (qsizetype index = 0; index < size; ++index) {
         if (shouldStop && shouldStop()) {
-            result.error = QStringLiteral("backtest_cancelled");
-            return result;
+            outcome.cancelled = true;
+            return outcome;
         }
-        const Candle &candle = candles[index];
-        const double price = std::isfinite(candle.close) ? candle.close : 0.0;
+        const double close = candles.close[index];
+        const double price = std::isfinite(close) ? close : 0.0;
         if (price <= 0.0) continue;
-        const double high = std::isfinite(candle.high) && candle.high > 0.0 ? candle.high : price;
-        const double low = std::isfinite(candle.low) && candle.low > 0.0 ? candle.low : price;
-        bool entryBuy = rawBuy[index] && entryFilter[index];
-        bool entrySell = rawSell[index] && entryFilter[index];
-        if (!positionOpen && result.mddLogic == QStringLiteral("entire_account")) updateDrawdown(account, equity);
+        const double high = std::isfinite(candles.high[index]) && candles.high[index] > 0.0
+            ? candles.high[index]
+            : price;
+        const double low = std::isfinite(candles.low[index]) && candles.low[index] > 0.0
+            ? candles.low[index]
+            : price;
+        bool entryBuy = entrySignals.gatedBuy.test(index);
+        bool entrySell = entrySignals.gatedSell.test(index);
+        if constexpr (Mdd == MddLogic::EntireAccount) {
+            if (!positionOpen) updateDrawdown(account, equity);
+        }
 
         if (positionOpen) {
             updateTrade(price, high, low);
-            if (result.mddLogic == QStringLiteral("entire_account")) {
+            if constexpr (Mdd == MddLogic::EntireAccount) {
                 if (units > 0.0) {
-                    const double best = direction == QStringLiteral("LONG")
+                    const double best = direction == Direction::Long
                         ? equity + (std::max(high, price) - entryPrice) * units
                         : equity + (entryPrice - std::min(low, price)) * units;
-                    const double worst = direction == QStringLiteral("LONG")
+                    const double worst = direction == Direction::Long
                         ? equity + (std::min(low, price) - entryPrice) * units
                         : equity + (entryPrice - std::max(high, price)) * units;
                     updateDrawdown(account, best);
                     updateDrawdown(account, worst);
                 } else updateDrawdown(account, equity);
             }
-            double effectiveLeverage = result.leverage;
-            if (result.marginMode == QStringLiteral("CROSS")) effectiveLeverage = std::max(1.0, result.leverage * pctFraction);
-            if (direction == QStringLiteral("LONG") && effectiveLeverage > 1.0) {
-                const double liquidation = std::max(0.0, entryPrice * (1.0 - 1.0 / effectiveLeverage));
-                if (low <= liquidation) {
+            if (effectiveLeverage > 1.0) {
+                const double liquidation = direction == Direction::Long
+                    ? std::max(0.0, entryPrice * (1.0 - 1.0 / effectiveLeverage))
+                    : entryPrice * (1.0 + 1.0 / effectiveLeverage);
+                if (direction == Direction::Long ? low <= liquidation : high >= liquidation) {
                     const double loss = std::min(equity, positionMargin);
                     equity = std::max(0.0, equity - loss);
                     recordEquity(equity);
                     finalizeTrade(liquidation, -loss);
-                    positionOpen = false; units = 0.0; positionMargin = 0.0; direction.clear();
-                    continue;
-                }
-            }
-            if (direction == QStringLiteral("SHORT") && effectiveLeverage > 1.0) {
-                const double liquidation = entryPrice * (1.0 + 1.0 / effectiveLeverage);
-                if (high >= liquidation) {
-                    const double loss = std::min(equity, positionMargin);
-                    equity = std::max(0.0, equity - loss);
-                    recordEquity(equity);
-                    finalizeTrade(liquidation, -loss);
-                    positionOpen = false; units = 0.0; positionMargin = 0.0; direction.clear();
+                    closePosition();
                     continue;
                 }
             }
 
-            if (result.stopLossEnabled && units > 0.0 && entryPrice > 0.0) {
-                const double worst = direction == QStringLiteral("LONG") ? std::min(price, low) : std::max(price, high);
-                const double worstExit = exitExecutionPrice(worst, direction);
-                const double loss = direction == QStringLiteral("LONG")
-                    ? std::max(0.0, (entryPrice - worstExit) * units)
-                    : std::max(0.0, (worstExit - entryPrice) * units);
-                const double denominator = result.stopLossScope == QStringLiteral("per_trade") && positionMargin > 0.0
-                    ? positionMargin : entryPrice * units;
-                const double lossPct = denominator > 0.0 ? loss / denominator * 100.0 : 0.0;
-                bool triggered = (result.stopLossMode == QStringLiteral("usdt") || result.stopLossMode == QStringLiteral("both"))
-                    && result.stopLossUsdt > 0.0 && loss >= result.stopLossUsdt;
-                if (!triggered && (result.stopLossMode == QStringLiteral("percent") || result.stopLossMode == QStringLiteral("both"))
-                    && result.stopLossPercent > 0.0 && lossPct >= result.stopLossPercent) triggered = true;
-                if (triggered) {
-                    const auto [exitPrice, pnl] = realizeClose(worst);
-                    equity = std::max(0.0, equity + pnl);
-                    recordEquity(equity);
-                    finalizeTrade(exitPrice, pnl);
-                    positionOpen = false; units = 0.0; positionMargin = 0.0; direction.clear();
-                    ++result.trades;
-                    continue;
+            if constexpr (StopLossEnabled) {
+                if (units > 0.0 && entryPrice > 0.0) {
+                    const double worst = direction == Direction::Long ? std::min(price, low) : std::max(price, high);
+                    const double worstExit = exitExecutionPrice(worst, direction, slippageRate);
+                    const double loss = NativeStopLoss::positionLoss(
+                        direction == Direction::Long, entryPrice, worstExit, units);
+                    if (NativeStopLoss::reached(compiled.stopLoss, loss, positionMargin, entryPrice * units)) {
+                        const auto [exitPrice, pnl] = realizeClose(worst);
+                        equity = std::max(0.0, equity + pnl);
+                        recordEquity(equity);
+                        finalizeTrade(exitPrice, pnl);
+                        closePosition();
+                        ++outcome.trades;
+                        continue;
+                    }
                 }
             }
 
-            if (direction == QStringLiteral("LONG") && rawSell[index]) {
+            if (direction == Direction::Long && entrySignals.rawSell.test(index)) {
                 const auto [exitPrice, pnl] = realizeClose(price);
                 equity = std::max(0.0, equity + pnl);
                 recordEquity(equity);
                 finalizeTrade(exitPrice, pnl);
-                positionOpen = false; units = 0.0; positionMargin = 0.0; direction.clear();
+                closePosition();
                 entrySell = canShort && entrySell && equity > 0.0;
-            } else if (direction == QStringLiteral("SHORT") && rawBuy[index]) {
+            } else if (direction == Direction::Short && entrySignals.rawBuy.test(index)) {
                 const auto [exitPrice, pnl] = realizeClose(price);
                 equity = std::max(0.0, equity + pnl);
                 recordEquity(equity);
                 finalizeTrade(exitPrice, pnl);
-                positionOpen = false; units = 0.0; positionMargin = 0.0; direction.clear();
+                closePosition();
                 entryBuy = canLong && entryBuy && equity > 0.0;
             }
         }
 
         if (!positionOpen && equity > 0.0) {
-            if (entryBuy && canLong) {
-                entryPrice = entryExecutionPrice(price, QStringLiteral("LONG"));
+            Direction entryDirection = Direction::None;
+            if (entryBuy && canLong) entryDirection = Direction::Long;
+            else if (entrySell && canShort) entryDirection = Direction::Short;
+            if (entryDirection != Direction::None) {
+                entryPrice = entryExecutionPrice(price, entryDirection, slippageRate);
                 positionMargin = equity * pctFraction;
-                units = positionMargin * result.leverage / entryPrice;
+                units = positionMargin * compiled.leverage / entryPrice;
                 if (units > 0.0) {
                     const double entryFee = std::abs(entryPrice * units) * feeRate;
                     feesPaid += entryFee;
                     equity = std::max(0.0, equity - entryFee);
-                    positionOpen = true; direction = QStringLiteral("LONG"); startTrade(direction, units, entryFee); ++result.trades;
-                } else positionMargin = 0.0;
-            } else if (entrySell && canShort) {
-                entryPrice = entryExecutionPrice(price, QStringLiteral("SHORT"));
-                positionMargin = equity * pctFraction;
-                units = positionMargin * result.leverage / entryPrice;
-                if (units > 0.0) {
-                    const double entryFee = std::abs(entryPrice * units) * feeRate;
-                    feesPaid += entryFee;
-                    equity = std::max(0.0, equity - entryFee);
-                    positionOpen = true; direction = QStringLiteral("SHORT"); startTrade(direction, units, entryFee); ++result.trades;
+                    positionOpen = true;
+                    direction = entryDirection;
+                    startTrade(direction, units, entryFee);
+                    ++outcome.trades;
                 } else positionMargin = 0.0;
             }
         }
     }
 
     if (positionOpen && units > 0.0) {
-        const double last = candles.constLast().close;
-        const auto [exitPrice, pnl] = realizeClose(last);
+        const auto [exitPrice, pnl] = realizeClose(candles.close.back());
         equity = std::max(0.0, equity + pnl);
         recordEquity(equity);
         finalizeTrade(exitPrice, pnl);
     }
 
-    result.finalEquity = equity;
-    result.roiValue = equity - result.capital;
-    result.roiPercent = result.capital != 0.0 ? result.roiValue / result.capital * 100.0 : 0.0;
-    result.feesPaid = feesPaid;
-    result.maxDrawdownDuringValue = tradeDuring.maxValue;
-    result.maxDrawdownDuringPercent = tradeDuring.maxPct;
-    result.maxDrawdownResultValue = tradeResult.maxValue;
-    result.maxDrawdownResultPercent = tradeResult.maxPct;
-    if (result.mddLogic == QStringLiteral("per_trade")) {
-        result.maxDrawdownValue = perTrade.maxValue;
-        result.maxDrawdownPercent = perTrade.maxPct;
-    } else if (result.mddLogic == QStringLiteral("entire_account")) {
-        result.maxDrawdownValue = account.maxValue;
-        result.maxDrawdownPercent = account.maxPct;
-    } else {
-        result.maxDrawdownValue = cumulative.maxValue;
-        result.maxDrawdownPercent = cumulative.maxPct;
+    outcome.finalEquity = equity;
+    outcome.feesPaid = feesPaid;
+    if constexpr (Mdd == MddLogic::PerTrade) outcome.maxDrawdown = perTrade;
+    else if constexpr (Mdd == MddLogic::EntireAccount) outcome.maxDrawdown = account;
+    else outcome.maxDrawdown = cumulative;
+    return outcome;
+}
+
+template <MddLogic Mdd, MarginMode Margin>
+SimulationOutcome simulateWithStopLoss(
+    const CompiledRequest &compiled,
+    CandleSpan candles,
+    const EntrySignals &entrySignals,
+    const std::function<bool()> &shouldStop) {
+    return compiled.stopLossEnabled
+        ? simulate<Mdd, Margin, true>(compiled, candles, entrySignals, shouldStop)
+        : simulate<Mdd, Margin, false>(compiled, candles, entrySignals, shouldStop);
+}
+
+template <MddLogic Mdd>
+SimulationOutcome simulateWithMargin(
+    const CompiledRequest &compiled,
+    CandleSpan candles,
+    const EntrySignals &entrySignals,
+    const std::function<bool()> &shouldStop) {
+    return compiled.marginMode == MarginMode::Cross
+        ? simulateWithStopLoss<Mdd, MarginMode::Cross>(compiled, candles, entrySignals, shouldStop)
+        : simulateWithStopLoss<Mdd, MarginMode::Isolated>(compiled, candles, entrySignals, shouldStop);
+}
+
+SimulationOutcome simulateCompiled(
+    const CompiledRequest &compiled,
+    CandleSpan candles,
+    const EntrySignals &entrySignals,
+    const std::function<bool()> &shouldStop) {
+    switch (compiled.mddLogic) {
+    case MddLogic::PerTrade:
+        return simulateWithMargin<MddLogic::PerTrade>(compiled, candles, entrySignals, shouldStop);
+    case MddLogic::Cumulative:
+        return simulateWithMargin<MddLogic::Cumulative>(compiled, candles, entrySignals, shouldStop);
+    case MddLogic::EntireAccount:
+        return simulateWithMargin<MddLogic::EntireAccount>(compiled, candles, entrySignals, shouldStop);
     }
+    return {};
+}
+
+IndicatorSignals buildIndicatorSignals(
+    const QString &key,
+    const QJsonObject &config,
+    CandleSpan candles,
+    const SeriesMap &computed) {
+    IndicatorSignals indicatorSignal;
+    indicatorSignal.key = key;
+    indicatorSignal.filter = isFilter(config);
+    const Series series = backtestSeries(key, config, candles, computed);
+    if (indicatorSignal.filter) {
+        indicatorSignal.gate = filterState(series, config);
+        if (!indicatorSignal.gate) {
+            indicatorSignal.error = QStringLiteral("Backtest filter '%1' is missing a valid threshold rule").arg(key);
+        }
+        return indicatorSignal;
+    }
+    const auto buy = configNumber(config, QStringLiteral("buy_value"));
+    const auto sell = configNumber(config, QStringLiteral("sell_value"));
+    if (!buy && !sell) {
+        indicatorSignal.error = QStringLiteral("Backtest indicator '%1' is missing buy/sell values").arg(key);
+        return indicatorSignal;
+    }
+    if (buy) indicatorSignal.buy = thresholdEvents(series, *buy, sell && *buy < *sell);
+    if (sell) indicatorSignal.sell = thresholdEvents(series, *sell, !(buy && *buy < *sell));
+    return indicatorSignal;
+}
+
+// QJsonObject keys are ordered, so compact JSON is a canonical form of the
+// config. "enabled" is dropped because only enabled indicators are cached.
+QByteArray signalCacheKey(const QString &key, QJsonObject config) {
+    config.remove(QStringLiteral("enabled"));
+    return key.toUtf8() + '\n' + QJsonDocument(config).toJson(QJsonDocument::Compact);
+}
+
+QJsonArray stringArray(const QStringList &values) {
+    QJsonArray output;
+    for (const QString &value : values) output.append(value);
+    return output;
+}
+
+} // namespace
+
+namespace NativeBacktestRuntime {
+
+QJsonObject Result::toJson() const {
+    return {
+        {QStringLiteral("ok"), ok},
+        {QStringLiteral("error"), error},
+        {QStringLiteral("symbol"), symbol},
+        {QStringLiteral("interval"), interval},
+        {QStringLiteral("indicator_keys"), stringArray(indicatorKeys)},
+        {QStringLiteral("trades"), trades},
+        {QStringLiteral("roi_value"), roiValue},
+        {QStringLiteral("roi_percent"), roiPercent},
+        {QStringLiteral("final_equity"), finalEquity},
+        {QStringLiteral("max_drawdown_value"), maxDrawdownValue},
+        {QStringLiteral("max_drawdown_percent"), maxDrawdownPercent},
+        {QStringLiteral("max_drawdown_during_value"), maxDrawdownDuringValue},
+        {QStringLiteral("max_drawdown_during_percent"), maxDrawdownDuringPercent},
+        {QStringLiteral("max_drawdown_result_value"), maxDrawdownResultValue},
+        {QStringLiteral("max_drawdown_result_percent"), maxDrawdownResultPercent},
+        {QStringLiteral("logic"), logic},
+        {QStringLiteral("leverage"), leverage},
+        {QStringLiteral("mdd_logic"), mddLogic},
+        {QStringLiteral("side"), side},
+        {QStringLiteral("capital"), capital},
+        {QStringLiteral("position_pct"), positionPct},
+        {QStringLiteral("position_pct_units"), positionPctUnits},
+        {QStringLiteral("stop_loss_enabled"), stopLossEnabled},
+        {QStringLiteral("stop_loss_mode"), stopLossMode},
+        {QStringLiteral("stop_loss_usdt"), stopLossUsdt},
+        {QStringLiteral("stop_loss_percent"), stopLossPercent},
+        {QStringLiteral("stop_loss_scope"), stopLossScope},
+        {QStringLiteral("margin_mode"), marginMode},
+        {QStringLiteral("position_mode"), positionMode},
+        {QStringLiteral("assets_mode"), assetsMode},
+        {QStringLiteral("account_mode"), accountMode},
+        {QStringLiteral("fee_bps"), feeBps},
+        {QStringLiteral("slippage_bps"), slippageBps},
+        {QStringLiteral("fees_paid"), feesPaid},
+        {QStringLiteral("source"), QStringLiteral("native-cpp-backtest")},
+    };
+}
+
+SignalCache::SignalCache(CandleSpan candles)
+    : candles_(candles) {}
+
+void SignalCache::prepare(const ConfigMap &configs) {
+    const QStringList supported = NativeIndicatorRuntime::computedIndicatorKeys();
+    ConfigMap missing;
+    for (auto it = configs.cbegin(); it != configs.cend(); ++it) {
+        if (!configBool(it.value(), QStringLiteral("enabled")) || !supported.contains(it.key())) continue;
+        if (!entries_.contains(signalCacheKey(it.key(), it.value()))) missing.insert(it.key(), it.value());
+    }
+    if (missing.isEmpty()) return;
+    const SeriesMap computed = NativeIndicatorRuntime::computeConfiguredSeries(candles_, missing);
+    for (auto it = missing.cbegin(); it != missing.cend(); ++it) {
+        entries_.insert(
+            signalCacheKey(it.key(), it.value()),
+            std::make_shared<const IndicatorSignals>(buildIndicatorSignals(it.key(), it.value(), candles_, computed)));
+    }
+}
+
+const IndicatorSignals *SignalCache::find(const QString &key, const QJsonObject &config) const {
+    const auto it = entries_.constFind(signalCacheKey(key, config));
+    return it == entries_.cend() ? nullptr : it->get();
+}
+
+Result describe(const Request &request) {
+    return describeResult(compileRequest(request), request);
+}
+
+Result run(
+    CandleSpan candles,
+    const Request &request,
+    const std::function<bool()> &shouldStop,
+    const SignalCache *signalCache) {
+    const CompiledRequest compiled = compileRequest(request);
+    Result result = describeResult(compiled, request);
+
+    if (candles.isEmpty()) {
+        result.error = QStringLiteral("Backtest requires at least one candle");
+        return result;
+    }
+    if (result.capital <= 0.0 || !std::isfinite(result.capital)) {
+        result.error = QStringLiteral("Backtest capital must be positive");
+        return result;
+    }
+    const QStringList unsupported = NativeIndicatorRuntime::unsupportedEnabledIndicatorKeys(request.indicators);
+    if (!unsupported.isEmpty()) {
+        result.error = QStringLiteral("Unsupported native backtest indicators: %1").arg(unsupported.join(QStringLiteral(", ")));
+        return result;
+    }
+
+    // Cached signals are shared; anything the cache does not cover is computed
+    // here, with the series for the whole request built at most once.
+    std::optional<SeriesMap> computed;
+    std::deque<IndicatorSignals> ownedSignals;
+    QVector<const IndicatorSignals *> indicatorSignals;
+    for (auto it = request.indicators.cbegin(); it != request.indicators.cend(); ++it) {
+        const QJsonObject config = it.value();
+        if (!configBool(config, QStringLiteral("enabled"))) continue;
+        const IndicatorSignals *indicatorSignal = signalCache ? signalCache->find(it.key(), config) : nullptr;
+        if (!indicatorSignal) {
+            if (!computed) computed = NativeIndicatorRuntime::computeConfiguredSeries(candles, request.indicators);
+            ownedSignals.push_back(buildIndicatorSignals(it.key(), config, candles, *computed));
+            indicatorSignal = &ownedSignals.back();
+        }
+        if (!indicatorSignal->error.isEmpty()) {
+            result.error = indicatorSignal->error;
+            return result;
+        }
+        indicatorSignals.append(indicatorSignal);
+        result.indicatorKeys.append(it.key());
+    }
+
+    QVector<const SignalBits *> buyArrays;
+    QVector<const SignalBits *> sellArrays;
+    QVector<const SignalBits *> filterArrays;
+    for (const IndicatorSignals *indicatorSignal : indicatorSignals) {
+        if (indicatorSignal->buy) buyArrays.append(&*indicatorSignal->buy);
+        if (indicatorSignal->sell) sellArrays.append(&*indicatorSignal->sell);
+        if (indicatorSignal->gate) filterArrays.append(&*indicatorSignal->gate);
+    }
+    if (buyArrays.isEmpty() && sellArrays.isEmpty()) {
+        result.error = QStringLiteral("At least one signal indicator is required; filter-only indicators cannot open trades.");
+        return result;
+    }
+
+    const int size = candles.size();
+    const bool andLogic = compiled.logic == SignalLogic::And;
+    const auto combine = [andLogic, size](const QVector<const SignalBits *> &arrays) {
+        if (arrays.isEmpty()) return SignalBits(size);
+        SignalBits output = *arrays.constFirst();
+        for (qsizetype index = 1; index < arrays.size(); ++index) {
+            if (andLogic) output &= *arrays.at(index);
+            else output |= *arrays.at(index);
+        }
+        return output;
+    };
+    const SignalBits rawBuy = combine(buyArrays);
+    const SignalBits rawSell = combine(sellArrays);
+    SignalBits entryFilter(size, true);
+    for (const SignalBits *array : filterArrays) entryFilter &= *array;
+    SignalBits gatedBuy = rawBuy;
+    gatedBuy &= entryFilter;
+    SignalBits gatedSell = rawSell;
+    gatedSell &= entryFilter;
+
+    const SimulationOutcome outcome = simulateCompiled(
+        compiled,
+        candles,
+        EntrySignals{rawBuy, rawSell, gatedBuy, gatedSell},
+        shouldStop);
+    if (outcome.cancelled) {
+        result.error = QStringLiteral("backtest_cancelled");
+        return result;
+    }
+
+    result.trades = outcome.trades;
+    result.finalEquity = outcome.finalEquity;
+    result.roiValue = outcome.finalEquity - result.capital;
+    result.roiPercent = result.capital != 0.0 ? result.roiValue / result.capital * 100.0 : 0.0;
+    result.feesPaid = outcome.feesPaid;
+    result.maxDrawdownDuringValue = outcome.tradeDuring.maxValue;
+    result.maxDrawdownDuringPercent = outcome.tradeDuring.maxPct;
+    result.maxDrawdownResultValue = outcome.tradeResult.maxValue;
+    result.maxDrawdownResultPercent = outcome.tradeResult.maxPct;
+    result.maxDrawdownValue = outcome.maxDrawdown.maxValue;
+    result.maxDrawdownPercent = outcome.maxDrawdown.maxPct;
     result.ok = true;
     return result;
 }
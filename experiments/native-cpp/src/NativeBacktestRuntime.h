@@ -2,11 +2,14 @@
 
 #include "NativeIndicatorRuntime.h"
 
+#include <QByteArray>
+#include <QHash>
 #include <QJsonObject>
 #include <QString>
 #include <QStringList>
 
 #include <functional>
+#include <memory>
 
 namespace NativeBacktestRuntime {
 
@@ -73,9 +76,32 @@ struct Result {
     QJsonObject toJson() const;
 };
 
+struct IndicatorSignals;
+
+// Per-indicator entry signals for one candle set, keyed by indicator key and
+// canonical config. prepare() fills it; after that it is read-only and can be
+// shared by every run over the same candles.
+class SignalCache {
+public:
+    explicit SignalCache(NativeIndicatorRuntime::CandleSpan candles);
+
+    void prepare(const NativeIndicatorRuntime::ConfigMap &configs);
+    const IndicatorSignals *find(const QString &key, const QJsonObject &config) const;
+    qsizetype size() const { return entries_.size(); }
+
+private:
+    NativeIndicatorRuntime::CandleSpan candles_;
+    QHash<QByteArray, std::shared_ptr<const IndicatorSignals>> entries_;
+};
+
+// The descriptive half of the Result run() returns for request: everything
+// except the simulation figures and the indicator keys. ok stays false.
+Result describe(const Request &request);
+
 Result run(
-    const QVector<NativeIndicatorRuntime::Candle> &candles,
+    NativeIndicatorRuntime::CandleSpan candles,
     const Request &request,
-    const std::function<bool()> &shouldStop = {});
+    const std::function<bool()> &shouldStop = {},
+    const SignalCache *signalCache = nullptr);
 
 } // namespace NativeBacktestRuntime
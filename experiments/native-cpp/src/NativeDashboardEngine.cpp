@@ -0,0 +1,277 @@
+#include "NativeDashboardEngine.h"
+
+#include <QDateTime>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <functional>
+#include <utility>
+
+namespace NativeDashboardEngine {
+
+namespace {
+
+QVector<SymbolRequest> uniqueSymbolRequests(const QVector<SymbolRequest> &requests) {
+    QVector<SymbolRequest> unique;
+    QSet<QString> seen;
+    for (const SymbolRequest &request : requests) {
+        if (!seen.contains(request.cacheKey)) {
+            seen.insert(request.cacheKey);
+            unique.append(request);
+        }
+    }
+    return unique;
+}
+
+} // namespace
+
+CycleData fetchCycleData(const CyclePlan &plan, QThreadPool *pool) {
+    CycleData data;
+    data.plannedAtMs = plan.plannedAtMs;
+
+    QVector<KlineRequest> klineRequests;
+    klineRequests.reserve(plan.klines.size());
+    QSet<QString> seenFeedKeys;
+    for (const KlineRequest &request : plan.klines) {
+        if (!seenFeedKeys.contains(request.feedKey)) {
+            seenFeedKeys.insert(request.feedKey);
+            klineRequests.append(request);
+        }
+    }
+    QVector<PositionsRequest> positionRequests;
+    QSet<QString> seenConnectors;
+    for (const PositionsRequest &request : plan.positions) {
+        if (!seenConnectors.contains(request.cacheKey)) {
+            seenConnectors.insert(request.cacheKey);
+            positionRequests.append(request);
+        }
+    }
+
+    const QVector<SymbolRequest> filterRequests = uniqueSymbolRequests(plan.symbolFilters);
+    const QVector<SymbolRequest> tickerRequests = uniqueSymbolRequests(plan.tickerPrices);
+
+    // Every task writes its own slot, so the results need no locking.
+    QVector<BinanceRestClient::KlinesResult> klineResults(klineRequests.size());
+    QVector<BinanceRestClient::FuturesPositionsResult> positionResults(positionRequests.size());
+    QVector<BinanceRestClient::FuturesSymbolFilters> filterResults(filterRequests.size());
+    QVector<BinanceRestClient::TickerPriceResult> tickerResults(tickerRequests.size());
+    QVector<std::function<void()>> tasks;
+    tasks.reserve(
+        klineRequests.size() + positionRequests.size() + filterRequests.size() + tickerRequests.size() + 1);
+    for (qsizetype index = 0; index < klineRequests.size(); ++index) {
+        tasks.append([&, index]() {
+            const KlineRequest &request = klineRequests.at(index);
+            klineResults[index] = BinanceRestClient::fetchKlines(
+                request.symbol,
+                request.interval,
+                request.futures,
+                request.testnet,
+                request.limit,
+                10000,
+                request.baseUrl);
+        });
+    }
+    for (qsizetype index = 0; index < positionRequests.size(); ++index) {
+        tasks.append([&, index]() {
+            positionResults[index] = BinanceRestClient::fetchOpenFuturesPositions(
+                plan.apiKey,
+                plan.apiSecret,
+                plan.testnet,
+                10000,
+                positionRequests.at(index).baseUrl);
+        });
+    }
+    for (qsizetype index = 0; index < filterRequests.size(); ++index) {
+        tasks.append([&, index]() {
+            // Served from the process-wide exchangeInfo cache after the
+            // connector's first fetch.
+            filterResults[index] = BinanceRestClient::fetchFuturesSymbolFilters(
+                filterRequests.at(index).symbol,
+                plan.testnet,
+                10000,
+                filterRequests.at(index).baseUrl);
+        });
+    }
+    for (qsizetype index = 0; index < tickerRequests.size(); ++index) {
+        tasks.append([&, index]() {
+            tickerResults[index] = BinanceRestClient::fetchTickerPrice(
+                tickerRequests.at(index).symbol,
+                true,
+                plan.testnet,
+                5000,
+                tickerRequests.at(index).baseUrl);
+        });
+    }
+    if (plan.fetchBalance) {
+        tasks.append([&]() {
+            data.balance = BinanceRestClient::fetchUsdtBalance(
+                plan.apiKey,
+                plan.apiSecret,
+                plan.balanceFutures,
+                plan.testnet,
+                6000,
+                plan.balanceBaseUrl);
+            data.balanceFetched = true;
+        });
+    }
+    QtConcurrent::blockingMap(pool, tasks, [](std::function<void()> &task) { task(); });
+
+    for (qsizetype index = 0; index < klineRequests.size(); ++index) {
+        data.klines.insert(klineRequests.at(index).feedKey, std::move(klineResults[index]));
+    }
+    for (qsizetype index = 0; index < positionRequests.size(); ++index) {
+        data.positions.insert(positionRequests.at(index).cacheKey, std::move(positionResults[index]));
+    }
+    for (qsizetype index = 0; index < filterRequests.size(); ++index) {
+        data.symbolFilters.insert(filterRequests.at(index).cacheKey, std::move(filterResults[index]));
+    }
+    for (qsizetype index = 0; index < tickerRequests.size(); ++index) {
+        data.tickerPrices.insert(tickerRequests.at(index).cacheKey, std::move(tickerResults[index]));
+    }
+    data.finishedAtMs = QDateTime::currentMSecsSinceEpoch();
+    return data;
+}
+
+OrderResults placeOrders(const OrderBatch &batch, const OrderPlacer &placer) {
+    OrderResults results;
+    results.outcomes.reserve(batch.orders.size());
+    // One after another: a connector that rejected an open gets no further
+    // opens from this batch, as the order circuit would have stopped them.
+    QSet<QString> failedConnectors;
+    QVector<PositionsRequest> refreshes;
+    QSet<QString> refreshed;
+    for (const OrderRequest &request : batch.orders) {
+        OrderOutcome outcome;
+        outcome.runtimeKey = request.runtimeKey;
+        if (!request.opening || !failedConnectors.contains(request.connectorCacheKey)) {
+            outcome.sent = true;
+            outcome.order = placer(batch, request);
+            if (request.opening && !outcome.order.ok) {
+                failedConnectors.insert(request.connectorCacheKey);
+            }
+            if (!refreshed.contains(request.connectorCacheKey)) {
+                refreshed.insert(request.connectorCacheKey);
+                refreshes.append({request.connectorCacheKey, request.baseUrl});
+            }
+        }
+        results.outcomes.append(std::move(outcome));
+    }
+    for (const PositionsRequest &refresh : std::as_const(refreshes)) {
+        results.positions.insert(
+            refresh.cacheKey,
+            BinanceRestClient::fetchOpenFuturesPositions(
+                batch.apiKey,
+                batch.apiSecret,
+                batch.testnet,
+                10000,
+                refresh.baseUrl));
+    }
+    return results;
+}
+
+Engine::Engine(QObject *parent)
+    : QObject(parent),
+      orderPlacer_([](const OrderBatch &batch, const OrderRequest &request) {
+          return BinanceRestClient::placeFuturesMarketOrder(
+              batch.apiKey,
+              batch.apiSecret,
+              request.symbol,
+              request.side,
+              request.quantity,
+              batch.testnet,
+              request.reduceOnly,
+              request.positionSide,
+              10000,
+              request.baseUrl);
+      }) {
+    fetchPool_.setMaxThreadCount(kFetchThreads);
+    // Pool threads keep their HTTP transport (and its keep-alive connections)
+    // for as long as the engine lives.
+    fetchPool_.setExpiryTimeout(-1);
+    cyclePool_.setMaxThreadCount(1);
+}
+
+Engine::~Engine() {
+    cancel();
+    cyclePool_.waitForDone();
+    fetchPool_.waitForDone();
+}
+
+bool Engine::submit(CyclePlan plan) {
+    if (busy_) {
+        return false;
+    }
+    busy_ = true;
+    const quint64 generation = generation_.load();
+    cyclePool_.start([this, generation, plan = std::move(plan)]() {
+        auto data = std::make_shared<const CycleData>(fetchCycleData(plan, &fetchPool_));
+        if (generation_.load() != generation) {
+            return;
+        }
+        // Queued with the engine as context: dropped if it is destroyed
+        // before the UI thread gets to it.
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, data = std::move(data)]() {
+                if (generation_.load() != generation) {
+                    return;
+                }
+                busy_ = false;
+                emit cycleReady(data);
+            },
+            Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void Engine::setOrderPlacer(OrderPlacer placer) {
+    orderPlacer_ = std::move(placer);
+}
+
+bool Engine::submitOrders(OrderBatch batch) {
+    if (busy_) {
+        return false;
+    }
+    busy_ = true;
+    ordersInFlight_ = true;
+    cyclePool_.start([this, placer = orderPlacer_, batch = std::move(batch)]() {
+        auto results = std::make_shared<const OrderResults>(placeOrders(batch, placer));
+        {
+            const std::lock_guard<std::mutex> lock(ordersMutex_);
+            placedOrders_ = std::move(results);
+        }
+        QMetaObject::invokeMethod(this, [this]() { deliverOrders(); }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void Engine::finishOrders() {
+    if (!ordersInFlight_) {
+        return;
+    }
+    cyclePool_.waitForDone();
+    deliverOrders();
+}
+
+void Engine::deliverOrders() {
+    OrderResultsPtr results;
+    {
+        const std::lock_guard<std::mutex> lock(ordersMutex_);
+        results = std::move(placedOrders_);
+        placedOrders_.reset();
+    }
+    // Already delivered by finishOrders().
+    if (!results) {
+        return;
+    }
+    ordersInFlight_ = false;
+    busy_ = false;
+    emit ordersReady(results);
+}
+
+void Engine::cancel() {
+    generation_.fetch_add(1);
+    busy_ = ordersInFlight_;
+}
+
+} // namespace NativeDashboardEngine
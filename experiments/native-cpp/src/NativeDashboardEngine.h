@@ -0,0 +1,195 @@
+#pragma once
+
+#include "BinanceRestClient.h"
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// Off-UI-thread network stages of the dashboard runtime cycle.
+//
+// The window describes what one cycle needs as a CyclePlan, built from a
+// snapshot of the override table. The engine runs every blocking REST call of
+// that plan on its worker threads, deduplicated and several at a time, and
+// posts the results back as one immutable CycleData. The window then
+// evaluates the cycle against that snapshot without waiting on the network,
+// so a slow exchange reply delays a cycle instead of freezing the UI.
+//
+// The orders the evaluation decides on go back to the engine as one
+// OrderBatch. It places them in order, refreshes the positions of every
+// connector it sent to, and posts the fills back as one immutable
+// OrderResults for the window to apply.
+namespace NativeDashboardEngine {
+
+struct KlineRequest {
+    // Market-data hub feed key; rows sharing a feed share one request.
+    QString feedKey;
+    QString symbol;
+    QString interval;
+    bool futures = true;
+    bool testnet = false;
+    int limit = 240;
+    QString baseUrl;
+};
+
+struct PositionsRequest {
+    // Connector cache key the cycle looks the snapshot up by.
+    QString cacheKey;
+    QString baseUrl;
+};
+
+// A futures symbol looked up on one connector.
+struct SymbolRequest {
+    // Key the cycle looks the result up by; requests sharing it are sent once.
+    QString cacheKey;
+    QString symbol;
+    QString baseUrl;
+};
+
+struct CyclePlan {
+    qint64 plannedAtMs = 0;
+    QString apiKey;
+    QString apiSecret;
+    bool testnet = false;
+    QVector<KlineRequest> klines;
+    QVector<PositionsRequest> positions;
+    bool fetchBalance = false;
+    bool balanceFutures = true;
+    QString balanceBaseUrl;
+    // Exchange filters of the symbols whose rows may open a position, and
+    // /ticker/price for those the price stream has no fresh book for.
+    QVector<SymbolRequest> symbolFilters;
+    QVector<SymbolRequest> tickerPrices;
+
+    bool isEmpty() const {
+        return klines.isEmpty() && positions.isEmpty() && !fetchBalance && symbolFilters.isEmpty()
+            && tickerPrices.isEmpty();
+    }
+};
+
+struct CycleData {
+    qint64 plannedAtMs = 0;
+    qint64 finishedAtMs = 0;
+    QHash<QString, BinanceRestClient::KlinesResult> klines;
+    QHash<QString, BinanceRestClient::FuturesPositionsResult> positions;
+    bool balanceFetched = false;
+    BinanceRestClient::BalanceResult balance;
+    QHash<QString, BinanceRestClient::FuturesSymbolFilters> symbolFilters;
+    QHash<QString, BinanceRestClient::TickerPriceResult> tickerPrices;
+};
+
+using CycleDataPtr = std::shared_ptr<const CycleData>;
+
+// Concurrent REST calls per cycle; matches Qt's per-host connection limit.
+inline constexpr int kFetchThreads = 6;
+
+// Runs every request of the plan on the calling thread's pool and blocks
+// until all of them finished. Exposed for tests.
+CycleData fetchCycleData(const CyclePlan &plan, QThreadPool *pool);
+
+// One futures market order decided by a cycle.
+struct OrderRequest {
+    QString runtimeKey;
+    // Connector the order goes to; its positions are refreshed afterwards.
+    QString connectorCacheKey;
+    QString baseUrl;
+    bool opening = true;
+    QString symbol;
+    QString side;
+    double quantity = 0.0;
+    QString positionSide;
+    bool reduceOnly = false;
+    // Latest known price, for placers that bound limit fallbacks with it.
+    double referencePrice = 0.0;
+};
+
+struct OrderBatch {
+    QString apiKey;
+    QString apiSecret;
+    bool testnet = false;
+    QVector<OrderRequest> orders;
+};
+
+struct OrderOutcome {
+    QString runtimeKey;
+    // False for an open held back because an earlier open on the same
+    // connector failed in this batch; closes are always sent.
+    bool sent = false;
+    BinanceRestClient::FuturesOrderResult order;
+};
+
+struct OrderResults {
+    // One per order of the batch, in batch order.
+    QVector<OrderOutcome> outcomes;
+    // Open positions per connector cache key, fetched after its orders.
+    QHash<QString, BinanceRestClient::FuturesPositionsResult> positions;
+};
+
+using OrderResultsPtr = std::shared_ptr<const OrderResults>;
+
+// Sends one order and blocks until the exchange answered. Called on the
+// engine's worker thread.
+using OrderPlacer =
+    std::function<BinanceRestClient::FuturesOrderResult(const OrderBatch &batch, const OrderRequest &request)>;
+
+// Places the batch one order at a time with placer, then fetches the open
+// positions of every connector an order was sent to. Exposed for tests.
+OrderResults placeOrders(const OrderBatch &batch, const OrderPlacer &placer);
+
+class Engine final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Engine(QObject *parent = nullptr);
+    ~Engine() override;
+
+    // True from submit() until cycleReady() (or cancel()), and from
+    // submitOrders() until ordersReady().
+    bool busy() const { return busy_; }
+
+    // Starts fetching the plan on the worker threads. Returns false while a
+    // previous cycle or order batch is still in flight.
+    bool submit(CyclePlan plan);
+
+    // Replaces the plain market order placer used by submitOrders().
+    void setOrderPlacer(OrderPlacer placer);
+
+    // Starts placing the batch on the worker thread. Returns false while a
+    // cycle or another batch is in flight.
+    bool submitOrders(OrderBatch batch);
+
+    // Blocks until the batch in flight, if any, has been placed and emits
+    // its ordersReady() before returning, so no sent order goes unrecorded.
+    void finishOrders();
+
+    // Drops the in-flight cycle, if any: its data is never delivered. An
+    // order batch in flight is still delivered.
+    void cancel();
+
+signals:
+    // Delivered on the engine's (UI) thread.
+    void cycleReady(const NativeDashboardEngine::CycleDataPtr &data);
+    void ordersReady(const NativeDashboardEngine::OrderResultsPtr &results);
+
+private:
+    void deliverOrders();
+
+    QThreadPool fetchPool_;
+    QThreadPool cyclePool_;
+    std::atomic<quint64> generation_{0};
+    bool busy_ = false;
+    bool ordersInFlight_ = false;
+    OrderPlacer orderPlacer_;
+    // Set on the worker thread, taken on the engine's thread.
+    std::mutex ordersMutex_;
+    OrderResultsPtr placedOrders_;
+};
+
+} // namespace NativeDashboardEngine
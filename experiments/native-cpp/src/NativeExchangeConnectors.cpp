@@ -433,7 +433,14 @@ QJsonObject buildConnectorHealthSnapshot(const QJsonObject &input) {
     const QString category = lastError.value(QStringLiteral("category")).toString().trimmed().toLower();
     const bool retryable = lastError.value(QStringLiteral("retryable")).toBool(false);
     const bool credentialsPresent = input.value(QStringLiteral("credentials_present")).toBool(false);
-    const double secondsUntilUnban = qMax(0.0, input.value(QStringLiteral("seconds_until_unban")).toDouble(0.0));
+    // NativeRequestLimiter's bucket snapshot; a ban it parsed counts like
+    // one reported by the caller.
+    const bool hasRequestWeight = input.value(QStringLiteral("request_weight")).isObject();
+    const QJsonObject requestWeight = input.value(QStringLiteral("request_weight")).toObject();
+    const double secondsUntilUnban = qMax(
+        0.0,
+        qMax(input.value(QStringLiteral("seconds_until_unban")).toDouble(0.0),
+             requestWeight.value(QStringLiteral("seconds_until_unban")).toDouble(0.0)));
     const bool networkOffline = input.value(QStringLiteral("network_offline")).toBool(false);
 
     QString health = credentialsPresent ? QStringLiteral("ok") : QStringLiteral("unknown");
@@ -500,6 +507,9 @@ QJsonObject buildConnectorHealthSnapshot(const QJsonObject &input) {
     if (hasOrderAudit) {
         payload.insert(QStringLiteral("order_audit"), orderAudit);
     }
+    if (hasRequestWeight) {
+        payload.insert(QStringLiteral("request_weight"), requestWeight);
+    }
     return NativeOrderSafety::redactValue(payload).toObject();
 }
 
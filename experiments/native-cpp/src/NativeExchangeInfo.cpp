@@ -0,0 +1,315 @@
+#include "NativeExchangeInfo.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QThreadPool>
+#include <QVariant>
+#include <QtMath>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+using NativeExchangeInfo::SnapshotPtr;
+
+bool parseJsonNumber(const QJsonValue &value, double *out) {
+    bool ok = false;
+    const double parsed = value.toVariant().toDouble(&ok);
+    if (!ok || !qIsFinite(parsed)) {
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+BinanceRestClient::FuturesSymbolFilters parseFilters(const QJsonObject &symObj) {
+    BinanceRestClient::FuturesSymbolFilters result;
+    bool qpOk = false;
+    const int quantityPrecision = symObj.value(QStringLiteral("quantityPrecision")).toVariant().toInt(&qpOk);
+    result.quantityPrecision = qpOk ? std::max(0, quantityPrecision) : 0;
+    bool ppOk = false;
+    const int pricePrecision = symObj.value(QStringLiteral("pricePrecision")).toVariant().toInt(&ppOk);
+    result.pricePrecision = ppOk ? std::max(0, pricePrecision) : 0;
+
+    double lotStepSize = 0.0;
+    double lotMinQty = 0.0;
+    double lotMaxQty = 0.0;
+    double marketStepSize = 0.0;
+    double marketMinQty = 0.0;
+    double marketMaxQty = 0.0;
+    double priceTickSize = 0.0;
+    const QJsonArray filters = symObj.value(QStringLiteral("filters")).toArray();
+    for (const QJsonValue &fValue : filters) {
+        const QJsonObject f = fValue.toObject();
+        const QString filterType = f.value(QStringLiteral("filterType")).toString().trimmed().toUpper();
+        if (filterType == QStringLiteral("LOT_SIZE")) {
+            parseJsonNumber(f.value(QStringLiteral("stepSize")), &lotStepSize);
+            parseJsonNumber(f.value(QStringLiteral("minQty")), &lotMinQty);
+            parseJsonNumber(f.value(QStringLiteral("maxQty")), &lotMaxQty);
+        } else if (filterType == QStringLiteral("MARKET_LOT_SIZE")) {
+            parseJsonNumber(f.value(QStringLiteral("stepSize")), &marketStepSize);
+            parseJsonNumber(f.value(QStringLiteral("minQty")), &marketMinQty);
+            parseJsonNumber(f.value(QStringLiteral("maxQty")), &marketMaxQty);
+        } else if (filterType == QStringLiteral("MIN_NOTIONAL")
+                   || filterType == QStringLiteral("NOTIONAL")) {
+            if (!parseJsonNumber(f.value(QStringLiteral("notional")), &result.minNotional)) {
+                parseJsonNumber(f.value(QStringLiteral("minNotional")), &result.minNotional);
+            }
+        } else if (filterType == QStringLiteral("PRICE_FILTER")) {
+            parseJsonNumber(f.value(QStringLiteral("tickSize")), &priceTickSize);
+        }
+    }
+
+    result.stepSize = marketStepSize > 0.0 ? marketStepSize : lotStepSize;
+    result.tickSize = std::max(0.0, priceTickSize);
+    result.minQty = marketMinQty > 0.0 ? marketMinQty : lotMinQty;
+    result.maxQty = marketMaxQty > 0.0 ? marketMaxQty : lotMaxQty;
+    result.stepSize = std::max(0.0, result.stepSize);
+    result.minQty = std::max(0.0, result.minQty);
+    result.maxQty = std::max(0.0, result.maxQty);
+    result.minNotional = std::max(0.0, result.minNotional);
+    result.ok = true;
+    return result;
+}
+
+struct Market {
+    // Held for a cold fetch, so concurrent callers download once.
+    std::mutex fetchMutex;
+    // The rest is guarded by Registry::mutex.
+    SnapshotPtr snapshot;
+    bool stale = false;
+    bool refreshing = false;
+    qint64 lastRefreshMs = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    QHash<QString, std::shared_ptr<Market>> markets;
+    std::atomic<qint64> ttlMs{NativeExchangeInfo::kDefaultTtlMs};
+    std::atomic<quint64> hits{0};
+    std::atomic<quint64> fetches{0};
+    std::atomic<quint64> backgroundRefreshes{0};
+    std::atomic<quint64> failedFetches{0};
+};
+
+Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+std::shared_ptr<Market> marketEntry(const QString &market) {
+    Registry &cache = registry();
+    std::lock_guard guard(cache.mutex);
+    std::shared_ptr<Market> &entry = cache.markets[market];
+    if (!entry) {
+        entry = std::make_shared<Market>();
+    }
+    return entry;
+}
+
+// Called with Registry::mutex held.
+bool refreshDue(const Market &entry, qint64 nowMs, qint64 ttlMs) {
+    if (entry.refreshing || nowMs - entry.lastRefreshMs < NativeExchangeInfo::kMinRefreshIntervalMs) {
+        return false;
+    }
+    return entry.stale || nowMs - entry.snapshot->fetchedAtMs() >= ttlMs;
+}
+
+void startRefresh(std::shared_ptr<Market> entry, NativeExchangeInfo::Fetcher fetch) {
+    QThreadPool::globalInstance()->start([entry = std::move(entry), fetch = std::move(fetch)]() {
+        NativeExchangeInfo::ParseResult refreshed = fetch();
+        Registry &cache = registry();
+        std::lock_guard guard(cache.mutex);
+        entry->refreshing = false;
+        if (!refreshed.ok || !refreshed.snapshot) {
+            cache.failedFetches.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        entry->snapshot = std::move(refreshed.snapshot);
+        entry->stale = false;
+        cache.backgroundRefreshes.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+} // namespace
+
+namespace NativeExchangeInfo {
+
+Snapshot::Snapshot(bool futures, qint64 fetchedAtMs, QVector<SymbolInfo> symbols)
+    : futures_(futures),
+      fetchedAtMs_(fetchedAtMs),
+      symbols_(std::move(symbols)) {
+    index_.reserve(symbols_.size());
+    for (qsizetype position = 0; position < symbols_.size(); ++position) {
+        const SymbolInfo &info = symbols_.at(position);
+        // The first listing of a symbol wins, as the old linear scans did.
+        if (info.id != NativeSymbolTable::kInvalidSymbol && !index_.contains(info.id)) {
+            index_.insert(info.id, position);
+        }
+        if (info.quoteAsset != QStringLiteral("USDT")
+            || info.status.toUpper() != QStringLiteral("TRADING")
+            || (futures_ && info.contractType.toUpper() != QStringLiteral("PERPETUAL"))) {
+            continue;
+        }
+        usdtSymbols_.append(info.symbol);
+    }
+    usdtSymbols_.removeDuplicates();
+    std::sort(usdtSymbols_.begin(), usdtSymbols_.end());
+}
+
+const SymbolInfo *Snapshot::find(SymbolId id) const {
+    const auto it = index_.constFind(id);
+    return it == index_.cend() ? nullptr : &symbols_.at(it.value());
+}
+
+const SymbolInfo *Snapshot::find(const QString &symbol) const {
+    const SymbolId id = NativeSymbolTable::find(symbol);
+    if (id != NativeSymbolTable::kInvalidSymbol) {
+        return find(id);
+    }
+    // Only reached for symbols the full symbol table could not intern.
+    const QString canonical = symbol.trimmed().toUpper();
+    for (const SymbolInfo &info : symbols_) {
+        if (info.symbol == canonical) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+ParseResult parse(const QByteArray &body, bool futures, qint64 fetchedAtMs) {
+    ParseResult result;
+    QJsonParseError parseError{};
+    const QJsonDocument document = QJsonDocument::fromJson(body, &parseError);
+    if (parseError.error != QJsonParseError::NoError || document.isNull()) {
+        result.error = QStringLiteral("Invalid JSON response");
+        return result;
+    }
+    if (!document.isObject()) {
+        result.error = QStringLiteral("Unexpected Binance response");
+        return result;
+    }
+    const QJsonObject obj = document.object();
+    if (obj.contains(QStringLiteral("msg"))) {
+        result.error = obj.value(QStringLiteral("msg")).toString(QStringLiteral("Binance API error"));
+        return result;
+    }
+
+    const QJsonArray entries = obj.value(QStringLiteral("symbols")).toArray();
+    QVector<SymbolInfo> symbols;
+    symbols.reserve(entries.size());
+    for (const QJsonValue &entry : entries) {
+        const QJsonObject symObj = entry.toObject();
+        SymbolInfo info;
+        info.symbol = symObj.value(QStringLiteral("symbol")).toString().trimmed().toUpper();
+        if (info.symbol.isEmpty()) {
+            continue;
+        }
+        info.id = NativeSymbolTable::intern(info.symbol);
+        info.quoteAsset = symObj.value(QStringLiteral("quoteAsset")).toString();
+        info.status = symObj.value(QStringLiteral("status")).toString();
+        info.contractType = symObj.value(QStringLiteral("contractType")).toString();
+        info.filters = parseFilters(symObj);
+        symbols.append(std::move(info));
+    }
+    result.snapshot = std::make_shared<const Snapshot>(futures, fetchedAtMs, std::move(symbols));
+    result.ok = true;
+    return result;
+}
+
+SnapshotPtr snapshot(const QString &market, const Fetcher &fetch, QString *error) {
+    Registry &cache = registry();
+    const std::shared_ptr<Market> entry = marketEntry(market);
+    {
+        std::lock_guard guard(cache.mutex);
+        if (entry->snapshot) {
+            cache.hits.fetch_add(1, std::memory_order_relaxed);
+            const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+            if (refreshDue(*entry, nowMs, cache.ttlMs.load(std::memory_order_relaxed))) {
+                entry->refreshing = true;
+                entry->lastRefreshMs = nowMs;
+                startRefresh(entry, fetch);
+            }
+            return entry->snapshot;
+        }
+    }
+
+    std::lock_guard fetchGuard(entry->fetchMutex);
+    {
+        std::lock_guard guard(cache.mutex);
+        if (entry->snapshot) {
+            cache.hits.fetch_add(1, std::memory_order_relaxed);
+            return entry->snapshot;
+        }
+    }
+    ParseResult fetched = fetch();
+    cache.fetches.fetch_add(1, std::memory_order_relaxed);
+    if (!fetched.ok || !fetched.snapshot) {
+        cache.failedFetches.fetch_add(1, std::memory_order_relaxed);
+        if (error) {
+            *error = fetched.error.isEmpty() ? QStringLiteral("Unexpected Binance response") : fetched.error;
+        }
+        return {};
+    }
+    std::lock_guard guard(cache.mutex);
+    entry->snapshot = std::move(fetched.snapshot);
+    entry->stale = false;
+    return entry->snapshot;
+}
+
+void markStale(const QString &market) {
+    Registry &cache = registry();
+    std::lock_guard guard(cache.mutex);
+    const auto it = cache.markets.constFind(market);
+    if (it != cache.markets.cend()) {
+        it.value()->stale = true;
+    }
+}
+
+bool isFilterRejection(const QString &errorText) {
+    const QString err = errorText.trimmed().toLower();
+    return err.contains(QStringLiteral("-1013"))
+        || err.contains(QStringLiteral("-1111"))
+        || err.contains(QStringLiteral("-4005"))
+        || err.contains(QStringLiteral("-4013"))
+        || err.contains(QStringLiteral("-4014"))
+        || err.contains(QStringLiteral("-4023"))
+        || err.contains(QStringLiteral("-4164"))
+        || err.contains(QStringLiteral("filter failure"))
+        || err.contains(QStringLiteral("precision is over the maximum"))
+        || err.contains(QStringLiteral("not increased by tick size"))
+        || err.contains(QStringLiteral("not increased by step size"))
+        || err.contains(QStringLiteral("notional must be no smaller than"));
+}
+
+void setTtlMs(qint64 ttlMs) {
+    registry().ttlMs.store(std::max<qint64>(0, ttlMs), std::memory_order_relaxed);
+}
+
+qint64 ttlMs() {
+    return registry().ttlMs.load(std::memory_order_relaxed);
+}
+
+void clear() {
+    Registry &cache = registry();
+    std::lock_guard guard(cache.mutex);
+    cache.markets.clear();
+}
+
+Stats stats() {
+    const Registry &cache = registry();
+    Stats snapshot;
+    snapshot.hits = cache.hits.load(std::memory_order_relaxed);
+    snapshot.fetches = cache.fetches.load(std::memory_order_relaxed);
+    snapshot.backgroundRefreshes = cache.backgroundRefreshes.load(std::memory_order_relaxed);
+    snapshot.failedFetches = cache.failedFetches.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace NativeExchangeInfo
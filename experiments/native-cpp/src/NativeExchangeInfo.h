@@ -0,0 +1,114 @@
+#pragma once
+
+#include "BinanceRestClient.h"
+#include "NativeSymbolTable.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+// Process-wide cache of Binance exchangeInfo documents.
+//
+// exchangeInfo runs to several MB and changes rarely, yet symbol filters,
+// the tradable symbol list and order normalization all need it. Each market
+// (spot or futures, live or testnet, overridden host) is downloaded and
+// parsed once into an immutable Snapshot indexed by interned symbol; lookups
+// then cost one hash probe. Snapshots older than the TTL, or marked stale
+// after a filter-related order rejection, keep being served while a single
+// background refresh replaces them.
+namespace NativeExchangeInfo {
+
+using SymbolId = NativeSymbolTable::SymbolId;
+
+struct SymbolInfo {
+    SymbolId id = NativeSymbolTable::kInvalidSymbol;
+    QString symbol;
+    QString quoteAsset;
+    QString status;
+    QString contractType;
+    // ok is always true; the values are what fetchFuturesSymbolFilters
+    // reports for the symbol.
+    BinanceRestClient::FuturesSymbolFilters filters;
+};
+
+class Snapshot {
+public:
+    Snapshot(bool futures, qint64 fetchedAtMs, QVector<SymbolInfo> symbols);
+
+    bool futures() const { return futures_; }
+    qint64 fetchedAtMs() const { return fetchedAtMs_; }
+    const QVector<SymbolInfo> &symbols() const { return symbols_; }
+
+    // nullptr when the market does not list the symbol.
+    const SymbolInfo *find(SymbolId id) const;
+    const SymbolInfo *find(const QString &symbol) const;
+
+    // Sorted USDT-quoted symbols in TRADING status; perpetual contracts only
+    // on futures markets. What fetchUsdtSymbols lists before volume sorting.
+    const QStringList &usdtSymbols() const { return usdtSymbols_; }
+
+private:
+    bool futures_ = false;
+    qint64 fetchedAtMs_ = 0;
+    QVector<SymbolInfo> symbols_;
+    QHash<SymbolId, qsizetype> index_;
+    QStringList usdtSymbols_;
+};
+
+using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+struct ParseResult {
+    bool ok = false;
+    SnapshotPtr snapshot;
+    QString error;
+};
+
+// Parses an exchangeInfo reply body. A Binance error object is reported
+// through its msg.
+ParseResult parse(const QByteArray &body, bool futures, qint64 fetchedAtMs);
+
+// Downloads and parses one market's exchangeInfo; run on the calling thread
+// for a cold cache and on the global thread pool for refreshes, so it must
+// own everything it captures.
+using Fetcher = std::function<ParseResult()>;
+
+inline constexpr qint64 kDefaultTtlMs = 15 * 60 * 1000;
+// Background refreshes of one market start at most this often, however
+// often it is marked stale.
+inline constexpr qint64 kMinRefreshIntervalMs = 30 * 1000;
+
+// The cached snapshot for market, fetched on the calling thread when there
+// is none yet (concurrent callers share one download). A snapshot past its
+// TTL or marked stale is returned as is while fetch runs in the background.
+// Returns nullptr and sets error only when no snapshot could be obtained.
+SnapshotPtr snapshot(const QString &market, const Fetcher &fetch, QString *error = nullptr);
+
+// The next snapshot() call for market starts a background refresh, unless
+// one started less than kMinRefreshIntervalMs ago.
+void markStale(const QString &market);
+
+// True for order rejections caused by symbol filters (lot size, tick size,
+// notional, precision), the ones a filter change on the exchange explains.
+bool isFilterRejection(const QString &errorText);
+
+void setTtlMs(qint64 ttlMs);
+qint64 ttlMs();
+
+// Drops every cached snapshot; for tests.
+void clear();
+
+struct Stats {
+    quint64 hits = 0;
+    quint64 fetches = 0;
+    quint64 backgroundRefreshes = 0;
+    quint64 failedFetches = 0;
+};
+
+Stats stats();
+
+} // namespace NativeExchangeInfo
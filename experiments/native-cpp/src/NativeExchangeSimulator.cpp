@@ -0,0 +1,1802 @@
+#include "NativeExchangeSimulator.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QMessageAuthenticationCode>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QVariant>
+
+#if HAS_QT_WEBSOCKETS
+#include <QWebSocket>
+#include <QWebSocketServer>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace {
+
+constexpr qint64 kMinuteMs = 60'000;
+constexpr qint64 kDayMs = 24 * 60 * kMinuteMs;
+constexpr qint64 kFundingIntervalMs = 8 * 60 * kMinuteMs;
+constexpr int kMaxHeaderBytes = 64 * 1024;
+constexpr qint64 kMaxBodyBytes = 1024 * 1024;
+constexpr double kMinNotional = 5.0;
+constexpr double kMaintenanceMarginRate = 0.004;
+constexpr int kBalancePrecision = 8;
+
+// splitmix64's finalizer: a cheap, well-mixed hash of one word.
+quint64 mix64(quint64 x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Uniform in [0, 1).
+double unitFromHash(quint64 hash) {
+    return static_cast<double>(hash >> 11) * 0x1.0p-53;
+}
+
+double nextUnit(quint64 *state) {
+    *state += 0x9E3779B97F4A7C15ULL;
+    return unitFromHash(mix64(*state));
+}
+
+// FNV-1a; unlike qHash it is the same in every process, so a seed serves the
+// same market on every run.
+quint64 symbolHash(const QString &symbol) {
+    quint64 hash = 0xCBF29CE484222325ULL;
+    for (const QChar c : symbol) {
+        hash ^= c.unicode();
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+QStringList syntheticSymbols(int count) {
+    QStringList symbols;
+    symbols.reserve(std::max(0, count));
+    for (int i = 1; i <= count; ++i) {
+        symbols.append(QStringLiteral("SIM%1USDT").arg(i, 4, 10, QLatin1Char('0')));
+    }
+    return symbols;
+}
+
+QString decimal(double value, int precision) {
+    return QString::number(value, 'f', std::max(0, precision));
+}
+
+QByteArray compact(const QJsonObject &object) {
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+QByteArray compact(const QJsonArray &array) {
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QByteArray errorBody(int code, const QString &message) {
+    return compact(QJsonObject{{QStringLiteral("code"), code}, {QStringLiteral("msg"), message}});
+}
+
+QString param(const QList<QPair<QString, QString>> &params, const QString &name) {
+    for (const auto &entry : params) {
+        if (entry.first == name) {
+            return entry.second;
+        }
+    }
+    return {};
+}
+
+qint64 msParam(const QList<QPair<QString, QString>> &params, const QString &name) {
+    bool ok = false;
+    const qint64 value = param(params, name).toLongLong(&ok);
+    return ok && value > 0 ? value : 0;
+}
+
+void appendParams(const QString &encoded, QList<QPair<QString, QString>> *params) {
+    if (encoded.isEmpty()) {
+        return;
+    }
+    params->append(QUrlQuery(encoded).queryItems(QUrl::FullyDecoded));
+}
+
+bool onGrid(double value, double step) {
+    const double steps = value / step;
+    return std::fabs(steps - std::round(steps)) < 1e-6;
+}
+
+double roundToStep(double value, double step) {
+    return step > 0.0 ? std::round(value / step) * step : value;
+}
+
+QByteArray reasonPhrase(int status) {
+    switch (status) {
+    case 200: return QByteArrayLiteral("OK");
+    case 400: return QByteArrayLiteral("Bad Request");
+    case 401: return QByteArrayLiteral("Unauthorized");
+    case 404: return QByteArrayLiteral("Not Found");
+    case 418: return QByteArrayLiteral("I'm a teapot");
+    case 429: return QByteArrayLiteral("Too Many Requests");
+    case 503: return QByteArrayLiteral("Service Unavailable");
+    default: return status < 400 ? QByteArrayLiteral("OK") : QByteArrayLiteral("Error");
+    }
+}
+
+// The exchange's request weights for the endpoints served here.
+int requestWeight(const QString &path, const QList<QPair<QString, QString>> &params) {
+    const bool futures = path.startsWith(QStringLiteral("/fapi/"));
+    const bool oneSymbol = !param(params, QStringLiteral("symbol")).isEmpty();
+    if (path.endsWith(QStringLiteral("/klines"))) {
+        if (!futures) {
+            return 2;
+        }
+        bool ok = false;
+        int limit = param(params, QStringLiteral("limit")).toInt(&ok);
+        limit = ok && limit > 0 ? limit : 500;
+        return limit < 100 ? 1 : limit < 500 ? 2 : limit <= 1000 ? 5 : 10;
+    }
+    if (path.endsWith(QStringLiteral("/exchangeInfo"))) {
+        return futures ? 1 : 20;
+    }
+    if (path.endsWith(QStringLiteral("/ticker/price")) || path.endsWith(QStringLiteral("/ticker/bookTicker"))) {
+        return futures ? (oneSymbol ? 1 : 2) : (oneSymbol ? 2 : 4);
+    }
+    if (path.endsWith(QStringLiteral("/ticker/24hr"))) {
+        return futures ? (oneSymbol ? 1 : 40) : (oneSymbol ? 2 : 80);
+    }
+    if (path.endsWith(QStringLiteral("/openOrders"))) {
+        return oneSymbol ? 1 : 40;
+    }
+    if (path == QStringLiteral("/api/v3/account")) {
+        return 20;
+    }
+    if (path.endsWith(QStringLiteral("/positionRisk")) || path.endsWith(QStringLiteral("/account"))
+        || path.endsWith(QStringLiteral("/balance"))) {
+        return 5;
+    }
+    return 1;
+}
+
+// Quote volume per minute in USDT, between 1k and 1M per symbol, so sorting
+// by 24h volume has a stable order.
+double minuteLiquidity(quint64 noiseSeed) {
+    return std::pow(10.0, 3.0 + 3.0 * unitFromHash(mix64(noiseSeed ^ 0x5A17ULL)));
+}
+
+#if HAS_QT_WEBSOCKETS
+bool isWebSocketUpgrade(const QByteArray &header) {
+    for (const QByteArray &line : header.split('\n')) {
+        const int colon = line.indexOf(':');
+        if (colon > 0 && line.left(colon).trimmed().toLower() == "upgrade") {
+            return line.mid(colon + 1).trimmed().toLower() == "websocket";
+        }
+    }
+    return false;
+}
+#endif
+
+} // namespace
+
+namespace NativeExchangeSimulator {
+
+Market::Market(const QStringList &symbols, quint64 seed) {
+    const double logLow = std::log(0.05);
+    const double logHigh = std::log(60'000.0);
+    const double twoPi = 2.0 * std::numbers::pi;
+    for (const QString &raw : symbols) {
+        const QString symbol = raw.trimmed().toUpper();
+        if (symbol.isEmpty() || indexBySymbol_.contains(symbol)) {
+            continue;
+        }
+        const quint64 hash = mix64(symbolHash(symbol) ^ mix64(seed));
+        SymbolSpec spec;
+        spec.symbol = symbol;
+        // Log-uniform, like the spread of listed prices.
+        const double price = std::exp(logLow + unitFromHash(hash) * (logHigh - logLow));
+        const int magnitude = static_cast<int>(std::floor(std::log10(price)));
+        spec.pricePrecision = std::clamp(4 - magnitude, 1, 7);
+        spec.quantityPrecision = std::clamp(magnitude, 0, 3);
+        spec.tickSize = std::pow(10.0, -spec.pricePrecision);
+        spec.stepSize = std::pow(10.0, -spec.quantityPrecision);
+        spec.basePrice = roundToStep(price, spec.tickSize);
+
+        Waves waves;
+        // Periods in minutes: the slow wave takes 3 to 10 days, the fast one
+        // 1 to 6 hours.
+        waves.slowPeriod = 4320.0 + unitFromHash(mix64(hash + 1)) * 10'080.0;
+        waves.slowPhase = unitFromHash(mix64(hash + 2)) * twoPi;
+        waves.fastPeriod = 60.0 + unitFromHash(mix64(hash + 3)) * 300.0;
+        waves.fastPhase = unitFromHash(mix64(hash + 4)) * twoPi;
+        waves.noiseSeed = mix64(hash + 5);
+
+        indexBySymbol_.insert(symbol, specs_.size());
+        specs_.append(spec);
+        waves_.append(waves);
+    }
+}
+
+int Market::indexOf(const QString &symbol) const {
+    return indexBySymbol_.value(symbol.trimmed().toUpper(), -1);
+}
+
+double Market::logOffset(int index, qint64 minute) const {
+    const Waves &waves = waves_.at(index);
+    const double twoPi = 2.0 * std::numbers::pi;
+    const double m = static_cast<double>(minute);
+    const double noise = unitFromHash(mix64(waves.noiseSeed ^ static_cast<quint64>(minute))) * 2.0 - 1.0;
+    return 0.06 * std::sin(twoPi * m / waves.slowPeriod + waves.slowPhase)
+        + 0.01 * std::sin(twoPi * m / waves.fastPeriod + waves.fastPhase)
+        + 0.0015 * noise;
+}
+
+double Market::priceAt(int index, qint64 timeMs) const {
+    if (index < 0 || index >= specs_.size()) {
+        return 0.0;
+    }
+    const qint64 clamped = std::max<qint64>(0, timeMs);
+    const qint64 minute = clamped / kMinuteMs;
+    const double fraction = static_cast<double>(clamped - minute * kMinuteMs) / kMinuteMs;
+    const double from = logOffset(index, minute);
+    const double to = logOffset(index, minute + 1);
+    return specs_.at(index).basePrice * std::exp(from + (to - from) * fraction);
+}
+
+Candle Market::candle(int index, qint64 openTimeMs, qint64 intervalMs, qint64 nowMs) const {
+    Candle candle;
+    candle.openTimeMs = openTimeMs;
+    candle.closeTimeMs = openTimeMs + intervalMs - 1;
+    if (index < 0 || index >= specs_.size() || intervalMs <= 0) {
+        return candle;
+    }
+    const SymbolSpec &spec = specs_.at(index);
+    const qint64 endMs = std::clamp(nowMs, openTimeMs, openTimeMs + intervalMs);
+    candle.open = roundToTick(index, priceAt(index, openTimeMs));
+    candle.close = roundToTick(index, priceAt(index, endMs));
+    double high = std::max(candle.open, candle.close);
+    double low = std::min(candle.open, candle.close);
+    // A few interior samples and a wick stand in for a scan of every minute,
+    // which a weekly candle would need ten thousand of.
+    for (int i = 1; i <= 3; ++i) {
+        const double price = priceAt(index, openTimeMs + (endMs - openTimeMs) * i / 4);
+        high = std::max(high, price);
+        low = std::min(low, price);
+    }
+    const quint64 hash = mix64(waves_.at(index).noiseSeed ^ static_cast<quint64>(openTimeMs)
+                               ^ (static_cast<quint64>(intervalMs) << 1));
+    high *= 1.0 + unitFromHash(hash) * 0.001;
+    low *= 1.0 - unitFromHash(mix64(hash)) * 0.001;
+    candle.high = std::max(std::ceil(high / spec.tickSize - 1e-9) * spec.tickSize, std::max(candle.open, candle.close));
+    candle.low = std::min(std::floor(low / spec.tickSize + 1e-9) * spec.tickSize, std::min(candle.open, candle.close));
+    candle.low = std::max(candle.low, spec.tickSize);
+
+    const double minutes = static_cast<double>(endMs - openTimeMs) / kMinuteMs;
+    candle.quoteVolume = minuteLiquidity(waves_.at(index).noiseSeed) * minutes * (0.5 + unitFromHash(mix64(hash + 1)));
+    candle.volume = roundToStep(candle.quoteVolume / ((candle.open + candle.close) / 2.0), spec.stepSize);
+    candle.trades = static_cast<int>(minutes * (20.0 + 80.0 * unitFromHash(mix64(hash + 2))));
+    return candle;
+}
+
+void Market::book(int index, qint64 timeMs, double *bid, double *ask) const {
+    if (index < 0 || index >= specs_.size()) {
+        *bid = 0.0;
+        *ask = 0.0;
+        return;
+    }
+    const double tick = specs_.at(index).tickSize;
+    *bid = std::max(tick, std::floor(priceAt(index, timeMs) / tick + 1e-9) * tick);
+    *ask = *bid + tick;
+}
+
+double Market::roundToTick(int index, double price) const {
+    return index < 0 || index >= specs_.size() ? price : roundToStep(price, specs_.at(index).tickSize);
+}
+
+qint64 Market::intervalMs(const QString &interval) {
+    static const QHash<QString, qint64> intervals{
+        {QStringLiteral("1m"), kMinuteMs},
+        {QStringLiteral("3m"), 3 * kMinuteMs},
+        {QStringLiteral("5m"), 5 * kMinuteMs},
+        {QStringLiteral("15m"), 15 * kMinuteMs},
+        {QStringLiteral("30m"), 30 * kMinuteMs},
+        {QStringLiteral("1h"), 60 * kMinuteMs},
+        {QStringLiteral("2h"), 2 * 60 * kMinuteMs},
+        {QStringLiteral("4h"), 4 * 60 * kMinuteMs},
+        {QStringLiteral("6h"), 6 * 60 * kMinuteMs},
+        {QStringLiteral("8h"), 8 * 60 * kMinuteMs},
+        {QStringLiteral("12h"), 12 * 60 * kMinuteMs},
+        {QStringLiteral("1d"), kDayMs},
+        {QStringLiteral("3d"), 3 * kDayMs},
+        {QStringLiteral("1w"), 7 * kDayMs},
+    };
+    return intervals.value(interval.trimmed(), 0);
+}
+
+qint64 Market::alignOpenTime(qint64 timeMs, qint64 intervalMs) {
+    if (intervalMs <= 0) {
+        return timeMs;
+    }
+    // The epoch was a Thursday; Binance weeks open on Monday 00:00 UTC.
+    const qint64 offset = intervalMs == 7 * kDayMs ? 4 * kDayMs : 0;
+    const qint64 shifted = timeMs - offset;
+    qint64 periods = shifted / intervalMs;
+    if (shifted < 0 && shifted % intervalMs != 0) {
+        --periods;
+    }
+    return periods * intervalMs + offset;
+}
+
+Server::Server(const Config &config, QObject *parent)
+    : QObject(parent),
+      config_(config),
+      market_(config.symbols.isEmpty() ? syntheticSymbols(config.symbolCount) : config.symbols, config.seed),
+      tcpServer_(new QTcpServer(this)),
+      randomState_(mix64(config.seed ^ 0xE5C4A6E1ULL)),
+      wallet_(config.walletBalanceUsdt) {
+    connect(tcpServer_, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket *socket = tcpServer_->nextPendingConnection()) {
+            connections_.insert(socket, {});
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handleReadyRead(socket); });
+            connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                connections_.remove(socket);
+                socket->deleteLater();
+            });
+        }
+    });
+#if HAS_QT_WEBSOCKETS
+    webSocketServer_ = new QWebSocketServer(
+        QStringLiteral("NativeExchangeSimulator"), QWebSocketServer::NonSecureMode, this);
+    connect(webSocketServer_, &QWebSocketServer::newConnection, this, [this]() {
+        while (QWebSocket *socket = webSocketServer_->nextPendingConnection()) {
+            acceptStreamSocket(socket);
+        }
+    });
+    streamTimer_ = new QTimer(this);
+    streamTimer_->setInterval(std::max(10, config_.streamIntervalMs));
+    connect(streamTimer_, &QTimer::timeout, this, &Server::pushStreams);
+    dropTimer_ = new QTimer(this);
+    connect(dropTimer_, &QTimer::timeout, this, &Server::dropStreamConnections);
+#endif
+}
+
+Server::~Server() {
+    close();
+}
+
+bool Server::listen(QString *error) {
+    if (tcpServer_->isListening()) {
+        return true;
+    }
+    if (!tcpServer_->listen(QHostAddress::LocalHost, config_.port)) {
+        if (error) {
+            *error = tcpServer_->errorString();
+        }
+        return false;
+    }
+#if HAS_QT_WEBSOCKETS
+    if (config_.streamDropIntervalMs > 0) {
+        dropTimer_->start(config_.streamDropIntervalMs);
+    }
+#endif
+    return true;
+}
+
+void Server::close() {
+#if HAS_QT_WEBSOCKETS
+    streamTimer_->stop();
+    dropTimer_->stop();
+    dropStreamConnections();
+#endif
+    tcpServer_->close();
+    const QList<QTcpSocket *> sockets = connections_.keys();
+    for (QTcpSocket *socket : sockets) {
+        socket->abort();
+    }
+    connections_.clear();
+}
+
+quint16 Server::port() const {
+    return tcpServer_->serverPort();
+}
+
+QString Server::restBaseUrl() const {
+    return QStringLiteral("http://127.0.0.1:%1").arg(port());
+}
+
+QString Server::streamBaseUrl() const {
+    return QStringLiteral("ws://127.0.0.1:%1").arg(port());
+}
+
+bool Server::loadScript(const QString &path, QString *error) {
+    const auto fail = [error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("Cannot open %1: %2").arg(path, file.errorString()));
+    }
+    QJsonParseError parseError{};
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        return fail(QStringLiteral("Invalid simulator script %1: %2").arg(path, parseError.errorString()));
+    }
+    const QJsonObject root = document.object();
+
+    // Everything is validated before anything is applied.
+    QList<std::pair<QPair<QString, QString>, QVector<Candle>>> candleSets;
+    const QJsonObject klines = root.value(QStringLiteral("klines")).toObject();
+    for (auto symbolIt = klines.begin(); symbolIt != klines.end(); ++symbolIt) {
+        const QString symbol = symbolIt.key().trimmed().toUpper();
+        if (market_.indexOf(symbol) < 0) {
+            return fail(QStringLiteral("Scripted klines for unlisted symbol %1").arg(symbol));
+        }
+        const QJsonObject byInterval = symbolIt.value().toObject();
+        for (auto intervalIt = byInterval.begin(); intervalIt != byInterval.end(); ++intervalIt) {
+            QVector<Candle> candles;
+            for (const QJsonValue &rowValue : intervalIt.value().toArray()) {
+                const QJsonArray row = rowValue.toArray();
+                if (row.size() < 6) {
+                    return fail(QStringLiteral("Short kline row for %1 %2").arg(symbol, intervalIt.key()));
+                }
+                const auto number = [&row](int column) { return row.at(column).toVariant().toDouble(); };
+                Candle candle;
+                candle.openTimeMs = row.at(0).toVariant().toLongLong();
+                candle.open = number(1);
+                candle.high = number(2);
+                candle.low = number(3);
+                candle.close = number(4);
+                candle.volume = number(5);
+                candle.closeTimeMs = row.size() > 6 ? row.at(6).toVariant().toLongLong() : 0;
+                candle.quoteVolume = row.size() > 7 ? number(7) : candle.volume * candle.close;
+                candle.trades = row.size() > 8 ? row.at(8).toVariant().toInt() : 0;
+                candles.append(candle);
+            }
+            candleSets.append(std::make_pair(qMakePair(symbol, intervalIt.key()), candles));
+        }
+    }
+
+    QList<ScriptedResponse> responses;
+    for (const QJsonValue &value : root.value(QStringLiteral("responses")).toArray()) {
+        const QJsonObject entry = value.toObject();
+        ScriptedResponse response;
+        response.method = entry.value(QStringLiteral("method")).toString().trimmed().toUpper().toLatin1();
+        response.path = entry.value(QStringLiteral("path")).toString().trimmed();
+        response.status = entry.value(QStringLiteral("status")).toInt(200);
+        const QJsonValue body = entry.value(QStringLiteral("body"));
+        response.body = body.isObject() ? compact(body.toObject())
+            : body.isArray()            ? compact(body.toArray())
+                                        : body.toString().toUtf8();
+        response.remaining = entry.value(QStringLiteral("times")).toInt(-1);
+        response.delayMs = entry.value(QStringLiteral("delay_ms")).toInt(0);
+        if (response.path.isEmpty()) {
+            return fail(QStringLiteral("Scripted response without a path in %1").arg(path));
+        }
+        responses.append(response);
+    }
+
+    for (const auto &set : std::as_const(candleSets)) {
+        setCandles(set.first.first, set.first.second, set.second);
+    }
+    for (const ScriptedResponse &response : std::as_const(responses)) {
+        addScriptedResponse(response);
+    }
+    return true;
+}
+
+void Server::addScriptedResponse(const ScriptedResponse &response) {
+    scripted_.append(response);
+}
+
+void Server::setCandles(const QString &symbol, const QString &interval, const QVector<Candle> &candles) {
+    QVector<Candle> sorted = candles;
+    std::sort(sorted.begin(), sorted.end(), [](const Candle &a, const Candle &b) {
+        return a.openTimeMs < b.openTimeMs;
+    });
+    scriptedCandles_.insert(symbol.trimmed().toUpper() + QLatin1Char('|') + interval.trimmed(), sorted);
+}
+
+void Server::setLatency(int latencyMs, int jitterMs) {
+    config_.latencyMs = std::max(0, latencyMs);
+    config_.latencyJitterMs = std::max(0, jitterMs);
+}
+
+void Server::setErrorRate(double rate) {
+    config_.errorRate = std::clamp(rate, 0.0, 1.0);
+}
+
+void Server::banFor(int seconds) {
+    banUntilMs_ = seconds > 0 ? QDateTime::currentMSecsSinceEpoch() + seconds * 1000LL : 0;
+}
+
+void Server::dropStreamConnections() {
+#if HAS_QT_WEBSOCKETS
+    const QList<QWebSocket *> sockets = streamSockets_.keys();
+    for (QWebSocket *socket : sockets) {
+        socket->close(QWebSocketProtocol::CloseCodeGoingAway, QStringLiteral("Simulated disconnect"));
+    }
+#endif
+}
+
+void Server::expireListenKeys() {
+    if (listenKey_.isEmpty()) {
+        return;
+    }
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    pushUserData(compact(QJsonObject{
+        {QStringLiteral("e"), QStringLiteral("listenKeyExpired")},
+        {QStringLiteral("E"), nowMs},
+        {QStringLiteral("listenKey"), listenKey_},
+    }));
+    listenKey_.clear();
+}
+
+double Server::positionAmount(const QString &symbol, const QString &positionSide) const {
+    return positions_.value(symbol.trimmed().toUpper() + QLatin1Char('|') + positionSide.trimmed().toUpper()).amount;
+}
+
+void Server::handleReadyRead(QTcpSocket *socket) {
+    auto it = connections_.find(socket);
+    if (it == connections_.end()) {
+        return;
+    }
+#if HAS_QT_WEBSOCKETS
+    // Streams share the REST port: a WebSocket handshake on a fresh
+    // connection is handed over before any of it is read.
+    if (!it->served && it->buffer.isEmpty()) {
+        const QByteArray head = socket->peek(kMaxHeaderBytes);
+        const int headerEnd = head.indexOf("\r\n\r\n");
+        if (headerEnd < 0 && head.size() < kMaxHeaderBytes) {
+            return;
+        }
+        if (headerEnd >= 0 && isWebSocketUpgrade(head.left(headerEnd))) {
+            connections_.erase(it);
+            socket->disconnect(this);
+            webSocketServer_->handleConnection(socket);
+            // The handshake already arrived; the server only reads on
+            // readyRead.
+            QMetaObject::invokeMethod(socket, [socket]() { emit socket->readyRead(); }, Qt::QueuedConnection);
+            return;
+        }
+    }
+#endif
+    it->buffer.append(socket->readAll());
+    serveNext(socket);
+}
+
+void Server::serveNext(QTcpSocket *socket) {
+    auto it = connections_.find(socket);
+    if (it == connections_.end() || it->busy) {
+        return;
+    }
+    Request request;
+    bool complete = false;
+    if (!parseRequest(it->buffer, &request, &complete)) {
+        it->buffer.clear();
+        writeReply(socket, Reply{400, errorBody(-1000, QStringLiteral("Malformed HTTP request."))}, false);
+        return;
+    }
+    if (!complete) {
+        return;
+    }
+    it->busy = true;
+    it->served = true;
+    const bool keepAlive = request.headers.value("connection").toLower() != "close";
+    const Reply reply = route(request, QDateTime::currentMSecsSinceEpoch());
+    int delayMs = reply.delayMs;
+    if (delayMs < 0) {
+        delayMs = config_.latencyMs;
+        if (config_.latencyJitterMs > 0) {
+            delayMs += static_cast<int>(nextUnit(&randomState_) * (config_.latencyJitterMs + 1));
+        }
+    }
+    const auto send = [this, socket, reply, keepAlive]() {
+        writeReply(socket, reply, keepAlive);
+        const auto current = connections_.find(socket);
+        if (current == connections_.end()) {
+            return;
+        }
+        current->busy = false;
+        if (keepAlive) {
+            serveNext(socket);
+        }
+    };
+    if (delayMs > 0) {
+        QTimer::singleShot(delayMs, socket, send);
+    } else {
+        send();
+    }
+}
+
+bool Server::parseRequest(QByteArray &buffer, Request *request, bool *complete) {
+    *complete = false;
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return buffer.size() <= kMaxHeaderBytes;
+    }
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    if (requestLine.size() < 3) {
+        return false;
+    }
+    QHash<QByteArray, QByteArray> headers;
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const int colon = line.indexOf(':');
+        if (colon > 0) {
+            headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+        }
+    }
+    bool lengthOk = true;
+    const qint64 length = headers.contains("content-length") ? headers.value("content-length").toLongLong(&lengthOk) : 0;
+    if (!lengthOk || length < 0 || length > kMaxBodyBytes) {
+        return false;
+    }
+    const qint64 bodyStart = headerEnd + 4;
+    if (buffer.size() < bodyStart + length) {
+        return true;
+    }
+
+    request->method = requestLine.at(0).toUpper();
+    const QByteArray target = requestLine.at(1);
+    const int question = target.indexOf('?');
+    request->path = QString::fromLatin1(question < 0 ? target : target.left(question));
+    request->rawQuery = question < 0 ? QString() : QString::fromLatin1(target.mid(question + 1));
+    request->body = buffer.mid(bodyStart, length);
+    request->headers = headers;
+    appendParams(request->rawQuery, &request->params);
+    if (headers.value("content-type").toLower().contains("x-www-form-urlencoded")) {
+        appendParams(QString::fromLatin1(request->body), &request->params);
+    }
+    buffer.remove(0, bodyStart + length);
+    *complete = true;
+    return true;
+}
+
+Server::Reply Server::route(const Request &request, qint64 nowMs) {
+    ++stats_.restRequests;
+    Reply reply;
+    if (!admit(request, nowMs, &reply)) {
+        return reply;
+    }
+    matchRestingOrders(nowMs);
+
+    for (auto it = scripted_.begin(); it != scripted_.end(); ++it) {
+        if ((!it->method.isEmpty() && it->method != request.method) || it->path != request.path) {
+            continue;
+        }
+        ++stats_.scriptedResponses;
+        reply = Reply{it->status, it->body};
+        reply.delayMs = it->delayMs > 0 ? it->delayMs : -1;
+        if (it->remaining > 0 && --it->remaining == 0) {
+            scripted_.erase(it);
+        }
+        reply.usedWeight = weightUsed_;
+        return reply;
+    }
+
+    if (config_.errorRate > 0.0 && nextUnit(&randomState_) < config_.errorRate) {
+        ++stats_.injectedErrors;
+        reply = Reply{503, errorBody(-1001, QStringLiteral("Internal error; unable to process your request. Please try again."))};
+        reply.usedWeight = weightUsed_;
+        return reply;
+    }
+
+    reply = endpoint(request, nowMs);
+    reply.usedWeight = weightUsed_;
+    return reply;
+}
+
+bool Server::admit(const Request &request, qint64 nowMs, Reply *reply) {
+    const qint64 minute = nowMs / kMinuteMs;
+    if (minute != weightMinute_) {
+        weightMinute_ = minute;
+        weightUsed_ = 0;
+        requestsOverLimit_ = 0;
+    }
+    if (banUntilMs_ > nowMs) {
+        ++stats_.banned;
+        *reply = Reply{418, errorBody(-1003, QStringLiteral(
+            "Way too many requests; IP(127.0.0.1) banned until %1. "
+            "Please use the websocket for live updates to avoid bans.").arg(banUntilMs_))};
+        reply->retryAfterSeconds = static_cast<int>((banUntilMs_ - nowMs + 999) / 1000);
+        reply->usedWeight = weightUsed_;
+        return false;
+    }
+    weightUsed_ += requestWeight(request.path, request.params);
+    if (config_.weightLimitPerMinute <= 0 || weightUsed_ <= config_.weightLimitPerMinute) {
+        return true;
+    }
+    if (config_.banSeconds > 0 && ++requestsOverLimit_ > config_.requestsBeforeBan) {
+        banUntilMs_ = nowMs + config_.banSeconds * 1000LL;
+        return admit(request, nowMs, reply);
+    }
+    ++stats_.rateLimited;
+    *reply = Reply{429, errorBody(-1003, QStringLiteral(
+        "Too many requests; current limit of IP(127.0.0.1) is %1 requests per minute. "
+        "Please use the websocket for live updates to avoid polling the API.").arg(config_.weightLimitPerMinute))};
+    reply->retryAfterSeconds = static_cast<int>(((minute + 1) * kMinuteMs - nowMs + 999) / 1000);
+    reply->usedWeight = weightUsed_;
+    return false;
+}
+
+Server::Reply Server::endpoint(const Request &request, qint64 nowMs) {
+    const QStringList parts = request.path.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    const bool futures = parts.value(0) == QStringLiteral("fapi");
+    const bool spot = parts.value(0) == QStringLiteral("api") && parts.value(1) == QStringLiteral("v3");
+    const QString name = parts.mid(2).join(QLatin1Char('/'));
+    const QByteArray &method = request.method;
+    Reply reply;
+
+    if ((futures || spot) && method == "GET") {
+        if (name == QStringLiteral("ping")) {
+            return Reply{200, QByteArrayLiteral("{}")};
+        }
+        if (name == QStringLiteral("time")) {
+            return Reply{200, compact(QJsonObject{{QStringLiteral("serverTime"), nowMs}})};
+        }
+        if (name == QStringLiteral("exchangeInfo")) {
+            return exchangeInfo(futures, nowMs);
+        }
+        if (name == QStringLiteral("klines")) {
+            return klines(request, futures, nowMs);
+        }
+        if (name == QStringLiteral("ticker/price")) {
+            return tickerPrice(request, nowMs);
+        }
+        if (name == QStringLiteral("ticker/24hr")) {
+            return ticker24hr(request, nowMs);
+        }
+        if (name == QStringLiteral("ticker/bookTicker")) {
+            return bookTicker(request, nowMs);
+        }
+    }
+    if (futures && name == QStringLiteral("listenKey")
+        && (method == "POST" || method == "PUT" || method == "DELETE")) {
+        return listenKey(request, nowMs);
+    }
+
+    const bool signedEndpoint = (futures
+            && ((method == "GET"
+                 && (name == QStringLiteral("positionRisk") || name == QStringLiteral("account")
+                     || name == QStringLiteral("balance") || name == QStringLiteral("openOrders")))
+                || (name == QStringLiteral("order") && (method == "POST" || method == "DELETE"))))
+        || (spot && method == "GET" && name == QStringLiteral("account"));
+    if (!signedEndpoint) {
+        return Reply{404, errorBody(-1000, QStringLiteral("Unknown endpoint %1 %2.")
+                                               .arg(QString::fromLatin1(method), request.path))};
+    }
+    if (!checkSignature(request, &reply)) {
+        return reply;
+    }
+    if (spot) {
+        return spotAccount(nowMs);
+    }
+    if (name == QStringLiteral("positionRisk")) {
+        return positionRisk(request, nowMs);
+    }
+    if (name == QStringLiteral("account")) {
+        return futuresAccount(nowMs);
+    }
+    if (name == QStringLiteral("balance")) {
+        return futuresBalance(nowMs);
+    }
+    if (name == QStringLiteral("openOrders")) {
+        return openOrders(request);
+    }
+    return method == "POST" ? newOrder(request, nowMs) : cancelOrder(request, nowMs);
+}
+
+void Server::writeReply(QTcpSocket *socket, const Reply &reply, bool keepAlive) {
+    if (socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    QByteArray head = QByteArrayLiteral("HTTP/1.1 ") + QByteArray::number(reply.status) + ' '
+        + reasonPhrase(reply.status) + "\r\n";
+    head += "Content-Type: application/json;charset=UTF-8\r\n";
+    head += "Content-Length: " + QByteArray::number(reply.body.size()) + "\r\n";
+    if (reply.usedWeight >= 0) {
+        head += "X-MBX-USED-WEIGHT-1M: " + QByteArray::number(reply.usedWeight) + "\r\n";
+    }
+    if (reply.retryAfterSeconds > 0) {
+        head += "Retry-After: " + QByteArray::number(reply.retryAfterSeconds) + "\r\n";
+    }
+    head += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    socket->write(head + reply.body);
+    if (!keepAlive) {
+        socket->disconnectFromHost();
+    }
+}
+
+Server::Reply Server::exchangeInfo(bool futures, qint64 nowMs) const {
+    QJsonArray symbols;
+    for (const SymbolSpec &spec : market_.symbols()) {
+        const QString tick = decimal(spec.tickSize, spec.pricePrecision);
+        const QString step = decimal(spec.stepSize, spec.quantityPrecision);
+        const QJsonArray filters{
+            QJsonObject{{QStringLiteral("filterType"), QStringLiteral("PRICE_FILTER")},
+                        {QStringLiteral("tickSize"), tick},
+                        {QStringLiteral("minPrice"), tick},
+                        {QStringLiteral("maxPrice"), QStringLiteral("1000000")}},
+            QJsonObject{{QStringLiteral("filterType"), QStringLiteral("LOT_SIZE")},
+                        {QStringLiteral("stepSize"), step},
+                        {QStringLiteral("minQty"), step},
+                        {QStringLiteral("maxQty"), QStringLiteral("100000000")}},
+            QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MARKET_LOT_SIZE")},
+                        {QStringLiteral("stepSize"), step},
+                        {QStringLiteral("minQty"), step},
+                        {QStringLiteral("maxQty"), QStringLiteral("100000000")}},
+            futures ? QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MIN_NOTIONAL")},
+                                  {QStringLiteral("notional"), decimal(kMinNotional, 0)}}
+                    : QJsonObject{{QStringLiteral("filterType"), QStringLiteral("NOTIONAL")},
+                                  {QStringLiteral("minNotional"), decimal(kMinNotional, 0)}},
+        };
+        QJsonObject entry{
+            {QStringLiteral("symbol"), spec.symbol},
+            {QStringLiteral("status"), QStringLiteral("TRADING")},
+            {QStringLiteral("baseAsset"), spec.symbol.endsWith(QStringLiteral("USDT")) ? spec.symbol.chopped(4) : spec.symbol},
+            {QStringLiteral("quoteAsset"), QStringLiteral("USDT")},
+            {QStringLiteral("filters"), filters},
+        };
+        if (futures) {
+            entry.insert(QStringLiteral("contractType"), QStringLiteral("PERPETUAL"));
+            entry.insert(QStringLiteral("marginAsset"), QStringLiteral("USDT"));
+            entry.insert(QStringLiteral("pricePrecision"), spec.pricePrecision);
+            entry.insert(QStringLiteral("quantityPrecision"), spec.quantityPrecision);
+        } else {
+            entry.insert(QStringLiteral("baseAssetPrecision"), 8);
+            entry.insert(QStringLiteral("quoteAssetPrecision"), 8);
+        }
+        symbols.append(entry);
+    }
+    const QJsonArray rateLimits{QJsonObject{
+        {QStringLiteral("rateLimitType"), QStringLiteral("REQUEST_WEIGHT")},
+        {QStringLiteral("interval"), QStringLiteral("MINUTE")},
+        {QStringLiteral("intervalNum"), 1},
+        {QStringLiteral("limit"), config_.weightLimitPerMinute},
+    }};
+    return Reply{200, compact(QJsonObject{
+        {QStringLiteral("timezone"), QStringLiteral("UTC")},
+        {QStringLiteral("serverTime"), nowMs},
+        {QStringLiteral("rateLimits"), rateLimits},
+        {QStringLiteral("symbols"), symbols},
+    })};
+}
+
+Server::Reply Server::klines(const Request &request, bool futures, qint64 nowMs) const {
+    const QString symbol = param(request.params, QStringLiteral("symbol")).trimmed().toUpper();
+    const int index = market_.indexOf(symbol);
+    if (index < 0) {
+        return Reply{400, errorBody(-1121, QStringLiteral("Invalid symbol."))};
+    }
+    const QString interval = param(request.params, QStringLiteral("interval")).trimmed();
+    const qint64 step = Market::intervalMs(interval);
+    const auto scripted = scriptedCandles_.constFind(symbol + QLatin1Char('|') + interval);
+    if (step <= 0 && scripted == scriptedCandles_.cend()) {
+        return Reply{400, errorBody(-1120, QStringLiteral("Invalid interval."))};
+    }
+    bool limitOk = false;
+    int limit = param(request.params, QStringLiteral("limit")).toInt(&limitOk);
+    limit = std::min(limitOk && limit > 0 ? limit : 500, futures ? 1500 : 1000);
+    const qint64 startTimeMs = msParam(request.params, QStringLiteral("startTime"));
+    const qint64 endTimeMs = msParam(request.params, QStringLiteral("endTime"));
+
+    QVector<Candle> candles;
+    if (scripted != scriptedCandles_.cend()) {
+        for (const Candle &candle : *scripted) {
+            if (startTimeMs > 0 && candle.openTimeMs < startTimeMs) {
+                continue;
+            }
+            if (endTimeMs > 0 && candle.openTimeMs > endTimeMs) {
+                break;
+            }
+            candles.append(candle);
+        }
+        // Without a start the newest candles are served, like the exchange.
+        candles = startTimeMs > 0 ? candles.mid(0, limit) : candles.mid(std::max<qsizetype>(0, candles.size() - limit));
+    } else {
+        qint64 lastOpenMs = Market::alignOpenTime(nowMs, step);
+        if (endTimeMs > 0) {
+            lastOpenMs = std::min(lastOpenMs, Market::alignOpenTime(endTimeMs, step));
+        }
+        qint64 firstOpenMs = lastOpenMs - (limit - 1) * step;
+        if (startTimeMs > 0) {
+            firstOpenMs = Market::alignOpenTime(startTimeMs, step);
+            if (firstOpenMs < startTimeMs) {
+                firstOpenMs += step;
+            }
+            lastOpenMs = std::min(lastOpenMs, firstOpenMs + (limit - 1) * step);
+        }
+        for (qint64 openMs = std::max<qint64>(0, firstOpenMs); openMs <= lastOpenMs; openMs += step) {
+            candles.append(market_.candle(index, openMs, step, nowMs));
+        }
+    }
+
+    const SymbolSpec &spec = market_.symbols().at(index);
+    QByteArray body;
+    body.reserve(candles.size() * 160 + 2);
+    body += '[';
+    for (const Candle &candle : std::as_const(candles)) {
+        if (body.size() > 1) {
+            body += ',';
+        }
+        const double takerBuyVolume = roundToStep(candle.volume / 2.0, spec.stepSize);
+        body += '[' + QByteArray::number(candle.openTimeMs)
+            + ",\"" + decimal(candle.open, spec.pricePrecision).toLatin1()
+            + "\",\"" + decimal(candle.high, spec.pricePrecision).toLatin1()
+            + "\",\"" + decimal(candle.low, spec.pricePrecision).toLatin1()
+            + "\",\"" + decimal(candle.close, spec.pricePrecision).toLatin1()
+            + "\",\"" + decimal(candle.volume, spec.quantityPrecision).toLatin1()
+            + "\"," + QByteArray::number(candle.closeTimeMs)
+            + ",\"" + decimal(candle.quoteVolume, 4).toLatin1()
+            + "\"," + QByteArray::number(candle.trades)
+            + ",\"" + decimal(takerBuyVolume, spec.quantityPrecision).toLatin1()
+            + "\",\"" + decimal(candle.quoteVolume / 2.0, 4).toLatin1()
+            + "\",\"0\"]";
+    }
+    body += ']';
+    return Reply{200, body};
+}
+
+Server::Reply Server::tickerPrice(const Request &request, qint64 nowMs) const {
+    const auto row = [this, nowMs](int index) {
+        const SymbolSpec &spec = market_.symbols().at(index);
+        return QJsonObject{
+            {QStringLiteral("symbol"), spec.symbol},
+            {QStringLiteral("price"), decimal(market_.roundToTick(index, market_.priceAt(index, nowMs)), spec.pricePrecision)},
+            {QStringLiteral("time"), nowMs},
+        };
+    };
+    const QString symbol = param(request.params, QStringLiteral("symbol"));
+    if (!symbol.isEmpty()) {
+        const int index = market_.indexOf(symbol);
+        return index < 0 ? Reply{400, errorBody(-1121, QStringLiteral("Invalid symbol."))}
+                         : Reply{200, compact(row(index))};
+    }
+    QJsonArray rows;
+    for (int index = 0; index < market_.symbols().size(); ++index) {
+        rows.append(row(index));
+    }
+    return Reply{200, compact(rows)};
+}
+
+Server::Reply Server::ticker24hr(const Request &request, qint64 nowMs) const {
+    const auto row = [this, nowMs](int index) {
+        const SymbolSpec &spec = market_.symbols().at(index);
+        const Candle day = market_.candle(index, nowMs - kDayMs, kDayMs, nowMs);
+        const auto price = [&spec](double value) { return decimal(value, spec.pricePrecision); };
+        return QJsonObject{
+            {QStringLiteral("symbol"), spec.symbol},
+            {QStringLiteral("priceChange"), price(day.close - day.open)},
+            {QStringLiteral("priceChangePercent"), decimal((day.close - day.open) / day.open * 100.0, 3)},
+            {QStringLiteral("weightedAvgPrice"), price(day.volume > 0.0 ? day.quoteVolume / day.volume : day.close)},
+            {QStringLiteral("lastPrice"), price(day.close)},
+            {QStringLiteral("lastQty"), decimal(spec.stepSize, spec.quantityPrecision)},
+            {QStringLiteral("openPrice"), price(day.open)},
+            {QStringLiteral("highPrice"), price(day.high)},
+            {QStringLiteral("lowPrice"), price(day.low)},
+            {QStringLiteral("volume"), decimal(day.volume, spec.quantityPrecision)},
+            {QStringLiteral("quoteVolume"), decimal(day.quoteVolume, 4)},
+            {QStringLiteral("openTime"), day.openTimeMs},
+            {QStringLiteral("closeTime"), nowMs},
+            {QStringLiteral("count"), day.trades},
+        };
+    };
+    const QString symbol = param(request.params, QStringLiteral("symbol"));
+    if (!symbol.isEmpty()) {
+        const int index = market_.indexOf(symbol);
+        return index < 0 ? Reply{400, errorBody(-1121, QStringLiteral("Invalid symbol."))}
+                         : Reply{200, compact(row(index))};
+    }
+    QJsonArray rows;
+    for (int index = 0; index < market_.symbols().size(); ++index) {
+        rows.append(row(index));
+    }
+    return Reply{200, compact(rows)};
+}
+
+Server::Reply Server::bookTicker(const Request &request, qint64 nowMs) const {
+    const auto row = [this, nowMs](int index) {
+        const SymbolSpec &spec = market_.symbols().at(index);
+        double bid = 0.0;
+        double ask = 0.0;
+        market_.book(index, nowMs, &bid, &ask);
+        const QString depth = decimal(std::max(spec.stepSize, roundToStep(1000.0 / bid, spec.stepSize)), spec.quantityPrecision);
+        return QJsonObject{
+            {QStringLiteral("symbol"), spec.symbol},
+            {QStringLiteral("bidPrice"), decimal(bid, spec.pricePrecision)},
+            {QStringLiteral("bidQty"), depth},
+            {QStringLiteral("askPrice"), decimal(ask, spec.pricePrecision)},
+            {QStringLiteral("askQty"), depth},
+            {QStringLiteral("time"), nowMs},
+        };
+    };
+    const QString symbol = param(request.params, QStringLiteral("symbol"));
+    if (!symbol.isEmpty()) {
+        const int index = market_.indexOf(symbol);
+        return index < 0 ? Reply{400, errorBody(-1121, QStringLiteral("Invalid symbol."))}
+                         : Reply{200, compact(row(index))};
+    }
+    QJsonArray rows;
+    for (int index = 0; index < market_.symbols().size(); ++index) {
+        rows.append(row(index));
+    }
+    return Reply{200, compact(rows)};
+}
+
+Server::Reply Server::positionRisk(const Request &request, qint64 nowMs) const {
+    const QString symbol = param(request.params, QStringLiteral("symbol")).trimmed().toUpper();
+    QStringList keys = positions_.keys();
+    std::sort(keys.begin(), keys.end());
+    QJsonArray rows;
+    for (const QString &key : std::as_const(keys)) {
+        const Position &position = positions_[key];
+        const SymbolSpec &spec = market_.symbols().at(position.symbolIndex);
+        if (!symbol.isEmpty() && spec.symbol != symbol) {
+            continue;
+        }
+        const double mark = markPrice(position.symbolIndex, nowMs);
+        const double notional = position.amount * mark;
+        rows.append(QJsonObject{
+            {QStringLiteral("symbol"), spec.symbol},
+            {QStringLiteral("positionAmt"), decimal(position.amount, spec.quantityPrecision)},
+            {QStringLiteral("entryPrice"), decimal(position.entryPrice, kBalancePrecision)},
+            {QStringLiteral("breakEvenPrice"), decimal(position.entryPrice, kBalancePrecision)},
+            {QStringLiteral("markPrice"), decimal(mark, kBalancePrecision)},
+            {QStringLiteral("unRealizedProfit"), decimal((mark - position.entryPrice) * position.amount, kBalancePrecision)},
+            {QStringLiteral("liquidationPrice"), QStringLiteral("0")},
+            {QStringLiteral("leverage"), QString::number(config_.leverage)},
+            {QStringLiteral("maxNotionalValue"), QStringLiteral("1000000")},
+            {QStringLiteral("marginType"), QStringLiteral("cross")},
+            {QStringLiteral("isolatedMargin"), QStringLiteral("0")},
+            {QStringLiteral("isAutoAddMargin"), QStringLiteral("false")},
+            {QStringLiteral("positionSide"), key.mid(key.indexOf(QLatin1Char('|')) + 1)},
+            {QStringLiteral("notional"), decimal(notional, kBalancePrecision)},
+            {QStringLiteral("isolatedWallet"), QStringLiteral("0")},
+            {QStringLiteral("initialMargin"), decimal(std::fabs(notional) / config_.leverage, kBalancePrecision)},
+            {QStringLiteral("maintMargin"), decimal(std::fabs(notional) * kMaintenanceMarginRate, kBalancePrecision)},
+            {QStringLiteral("updateTime"), position.updateTimeMs},
+        });
+    }
+    return Reply{200, compact(rows)};
+}
+
+Server::Reply Server::futuresAccount(qint64 nowMs) const {
+    const double unrealized = unrealizedProfit(nowMs);
+    const double positionInitial = positionMargin(nowMs);
+    const double orderInitial = openOrderMargin();
+    const double available = availableBalance(nowMs);
+    double maintenance = 0.0;
+    QStringList keys = positions_.keys();
+    std::sort(keys.begin(), keys.end());
+    QJsonArray positions;
+    for (const QString &key : std::as_const(keys)) {
+        const Position &position = positions_[key];
+        const SymbolSpec &spec = market_.symbols().at(position.symbolIndex);
+        const double mark = markPrice(position.symbolIndex, nowMs);
+        const double notional = position.amount * mark;
+        maintenance += std::fabs(notional) * kMaintenanceMarginRate;
+        positions.append(QJsonObject{
+            {QStringLiteral("symbol"), spec.symbol},
+            {QStringLiteral("initialMargin"), decimal(std::fabs(notional) / config_.leverage, kBalancePrecision)},
+            {QStringLiteral("maintMargin"), decimal(std::fabs(notional) * kMaintenanceMarginRate, kBalancePrecision)},
+            {QStringLiteral("unrealizedProfit"), decimal((mark - position.entryPrice) * position.amount, kBalancePrecision)},
+            {QStringLiteral("positionInitialMargin"), decimal(std::fabs(notional) / config_.leverage, kBalancePrecision)},
+            {QStringLiteral("openOrderInitialMargin"), QStringLiteral("0")},
+            {QStringLiteral("leverage"), QString::number(config_.leverage)},
+            {QStringLiteral("isolated"), false},
+            {QStringLiteral("entryPrice"), decimal(position.entryPrice, kBalancePrecision)},
+            {QStringLiteral("positionSide"), key.mid(key.indexOf(QLatin1Char('|')) + 1)},
+            {QStringLiteral("positionAmt"), decimal(position.amount, spec.quantityPrecision)},
+            {QStringLiteral("notional"), decimal(notional, kBalancePrecision)},
+            {QStringLiteral("isolatedWallet"), QStringLiteral("0")},
+            {QStringLiteral("updateTime"), position.updateTimeMs},
+        });
+    }
+    const auto amount = [](double value) { return decimal(value, kBalancePrecision); };
+    const QJsonObject asset{
+        {QStringLiteral("asset"), QStringLiteral("USDT")},
+        {QStringLiteral("walletBalance"), amount(wallet_)},
+        {QStringLiteral("unrealizedProfit"), amount(unrealized)},
+        {QStringLiteral("marginBalance"), amount(wallet_ + unrealized)},
+        {QStringLiteral("maintMargin"), amount(maintenance)},
+        {QStringLiteral("initialMargin"), amount(positionInitial + orderInitial)},
+        {QStringLiteral("positionInitialMargin"), amount(positionInitial)},
+        {QStringLiteral("openOrderInitialMargin"), amount(orderInitial)},
+        {QStringLiteral("crossWalletBalance"), amount(wallet_)},
+        {QStringLiteral("crossUnPnl"), amount(unrealized)},
+        {QStringLiteral("availableBalance"), amount(available)},
+        {QStringLiteral("maxWithdrawAmount"), amount(std::min(wallet_, available))},
+        {QStringLiteral("marginAvailable"), true},
+        {QStringLiteral("updateTime"), nowMs},
+    };
+    return Reply{200, compact(QJsonObject{
+        {QStringLiteral("feeTier"), 0},
+        {QStringLiteral("canTrade"), true},
+        {QStringLiteral("canDeposit"), true},
+        {QStringLiteral("canWithdraw"), true},
+        {QStringLiteral("multiAssetsMargin"), false},
+        {QStringLiteral("totalInitialMargin"), amount(positionInitial + orderInitial)},
+        {QStringLiteral("totalMaintMargin"), amount(maintenance)},
+        {QStringLiteral("totalWalletBalance"), amount(wallet_)},
+        {QStringLiteral("totalUnrealizedProfit"), amount(unrealized)},
+        {QStringLiteral("totalMarginBalance"), amount(wallet_ + unrealized)},
+        {QStringLiteral("totalPositionInitialMargin"), amount(positionInitial)},
+        {QStringLiteral("totalOpenOrderInitialMargin"), amount(orderInitial)},
+        {QStringLiteral("totalCrossWalletBalance"), amount(wallet_)},
+        {QStringLiteral("totalCrossUnPnl"), amount(unrealized)},
+        {QStringLiteral("availableBalance"), amount(available)},
+        {QStringLiteral("maxWithdrawAmount"), amount(std::min(wallet_, available))},
+        {QStringLiteral("assets"), QJsonArray{asset}},
+        {QStringLiteral("positions"), positions},
+    })};
+}
+
+Server::Reply Server::futuresBalance(qint64 nowMs) const {
+    const double available = availableBalance(nowMs);
+    return Reply{200, compact(QJsonArray{QJsonObject{
+        {QStringLiteral("accountAlias"), QStringLiteral("SimulatedAccount")},
+        {QStringLiteral("asset"), QStringLiteral("USDT")},
+        {QStringLiteral("balance"), decimal(wallet_, kBalancePrecision)},
+        {QStringLiteral("crossWalletBalance"), decimal(wallet_, kBalancePrecision)},
+        {QStringLiteral("crossUnPnl"), decimal(unrealizedProfit(nowMs), kBalancePrecision)},
+        {QStringLiteral("availableBalance"), decimal(available, kBalancePrecision)},
+        {QStringLiteral("maxWithdrawAmount"), decimal(std::min(wallet_, available), kBalancePrecision)},
+        {QStringLiteral("marginAvailable"), true},
+        {QStringLiteral("updateTime"), nowMs},
+    }})};
+}
+
+Server::Reply Server::spotAccount(qint64 nowMs) const {
+    // Spot trading is not simulated; the account mirrors the futures wallet.
+    return Reply{200, compact(QJsonObject{
+        {QStringLiteral("canTrade"), true},
+        {QStringLiteral("canWithdraw"), true},
+        {QStringLiteral("canDeposit"), true},
+        {QStringLiteral("updateTime"), nowMs},
+        {QStringLiteral("accountType"), QStringLiteral("SPOT")},
+        {QStringLiteral("balances"), QJsonArray{QJsonObject{
+             {QStringLiteral("asset"), QStringLiteral("USDT")},
+             {QStringLiteral("free"), decimal(wallet_, kBalancePrecision)},
+             {QStringLiteral("locked"), decimal(0.0, kBalancePrecision)},
+         }}},
+        {QStringLiteral("permissions"), QJsonArray{QStringLiteral("SPOT")}},
+    })};
+}
+
+Server::Reply Server::newOrder(const Request &request, qint64 nowMs) {
+    const auto reject = [this](int code, const QString &message) {
+        ++stats_.ordersRejected;
+        return Reply{400, errorBody(code, message)};
+    };
+    const auto text = [&request](const char *name) {
+        return param(request.params, QString::fromLatin1(name)).trimmed();
+    };
+
+    Order order;
+    order.symbolIndex = market_.indexOf(text("symbol"));
+    if (order.symbolIndex < 0) {
+        return reject(-1121, QStringLiteral("Invalid symbol."));
+    }
+    const SymbolSpec &spec = market_.symbols().at(order.symbolIndex);
+    order.side = text("side").toUpper();
+    if (order.side != QStringLiteral("BUY") && order.side != QStringLiteral("SELL")) {
+        return reject(-1117, QStringLiteral("Invalid side."));
+    }
+    order.type = text("type").toUpper();
+    if (order.type != QStringLiteral("MARKET") && order.type != QStringLiteral("LIMIT")) {
+        return reject(-1116, QStringLiteral("Invalid orderType."));
+    }
+    order.positionSide = text("positionSide").toUpper();
+    if (order.positionSide.isEmpty()) {
+        order.positionSide = QStringLiteral("BOTH");
+    }
+    if (order.positionSide != QStringLiteral("BOTH") && order.positionSide != QStringLiteral("LONG")
+        && order.positionSide != QStringLiteral("SHORT")) {
+        return reject(-4061, QStringLiteral("Order's position side does not match user's setting."));
+    }
+    order.reduceOnly = text("reduceOnly").toLower() == QStringLiteral("true");
+    if (order.reduceOnly && order.positionSide != QStringLiteral("BOTH")) {
+        return reject(-1106, QStringLiteral("Parameter 'reduceonly' sent when not required."));
+    }
+    bool quantityOk = false;
+    const double quantity = text("quantity").toDouble(&quantityOk);
+    if (!quantityOk || !(quantity > 0.0)) {
+        return reject(-4003, QStringLiteral("Quantity less than or equal to zero."));
+    }
+    if (!onGrid(quantity, spec.stepSize)) {
+        return reject(-1111, QStringLiteral("Precision is over the maximum defined for this asset."));
+    }
+    order.quantity = roundToStep(quantity, spec.stepSize);
+    if (order.type == QStringLiteral("LIMIT")) {
+        bool priceOk = false;
+        order.price = text("price").toDouble(&priceOk);
+        if (!priceOk || !(order.price > 0.0)) {
+            return reject(-1102, QStringLiteral("Mandatory parameter 'price' was not sent, was empty/null, or malformed."));
+        }
+        if (!onGrid(order.price, spec.tickSize)) {
+            return reject(-4014, QStringLiteral("Price not increased by tick size."));
+        }
+        order.timeInForce = text("timeInForce").toUpper();
+        if (order.timeInForce.isEmpty()) {
+            order.timeInForce = QStringLiteral("GTC");
+        }
+        if (order.timeInForce != QStringLiteral("GTC") && order.timeInForce != QStringLiteral("IOC")
+            && order.timeInForce != QStringLiteral("FOK") && order.timeInForce != QStringLiteral("GTX")) {
+            return reject(-1115, QStringLiteral("Invalid timeInForce."));
+        }
+    }
+
+    // What the order closes of the position it trades against; the rest
+    // opens exposure and needs notional and margin.
+    const bool buy = order.side == QStringLiteral("BUY");
+    const double held = positions_.value(spec.symbol + QLatin1Char('|') + order.positionSide).amount;
+    double closable = 0.0;
+    if (order.positionSide == QStringLiteral("BOTH")) {
+        closable = (buy ? held < 0.0 : held > 0.0) ? std::fabs(held) : 0.0;
+    } else {
+        const bool closing = order.positionSide == QStringLiteral("LONG") ? !buy : buy;
+        if (closing && order.quantity > std::fabs(held) + spec.stepSize / 2.0) {
+            return reject(-2022, QStringLiteral("ReduceOnly Order is rejected."));
+        }
+        closable = closing ? order.quantity : 0.0;
+    }
+    if (order.reduceOnly) {
+        if (closable <= 0.0) {
+            return reject(-2022, QStringLiteral("ReduceOnly Order is rejected."));
+        }
+        order.quantity = std::min(order.quantity, closable);
+    }
+    double bid = 0.0;
+    double ask = 0.0;
+    market_.book(order.symbolIndex, nowMs, &bid, &ask);
+    const double opening = std::max(0.0, order.quantity - closable);
+    if (opening > 0.0) {
+        const double referencePrice = order.type == QStringLiteral("LIMIT") ? order.price : (buy ? ask : bid);
+        if (order.quantity * referencePrice < kMinNotional) {
+            return reject(-4164, QStringLiteral("Order's notional must be no smaller than %1 (unless you choose reduce only).")
+                                     .arg(kMinNotional));
+        }
+        const double required = opening * referencePrice / config_.leverage
+            + order.quantity * referencePrice * config_.takerFeeRate;
+        if (required > availableBalance(nowMs)) {
+            return reject(-2019, QStringLiteral("Margin is insufficient."));
+        }
+    }
+
+    order.orderId = nextOrderId_++;
+    order.clientOrderId = text("newClientOrderId");
+    if (order.clientOrderId.isEmpty()) {
+        order.clientOrderId = QStringLiteral("sim-%1").arg(order.orderId);
+    }
+    order.status = QStringLiteral("NEW");
+    order.updateTimeMs = nowMs;
+    pushOrderUpdate(order, QStringLiteral("NEW"), 0.0, 0.0, 0.0, 0.0, nowMs);
+
+    if (order.type == QStringLiteral("MARKET")) {
+        fill(order, order.quantity, buy ? ask : bid, nowMs);
+    } else {
+        const bool crosses = buy ? order.price >= ask : order.price <= bid;
+        if (crosses && order.timeInForce != QStringLiteral("GTX")) {
+            // Takes the touch, which is at least as good as the limit.
+            fill(order, order.quantity, buy ? ask : bid, nowMs);
+        } else if (crosses || order.timeInForce == QStringLiteral("IOC") || order.timeInForce == QStringLiteral("FOK")) {
+            order.status = QStringLiteral("EXPIRED");
+            pushOrderUpdate(order, QStringLiteral("EXPIRED"), 0.0, 0.0, 0.0, 0.0, nowMs);
+        } else {
+            restingOrders_.insert(order.orderId, order);
+        }
+    }
+    return Reply{200, compact(orderObject(order))};
+}
+
+Server::Reply Server::cancelOrder(const Request &request, qint64 nowMs) {
+    const QString symbol = param(request.params, QStringLiteral("symbol")).trimmed().toUpper();
+    const QString orderId = param(request.params, QStringLiteral("orderId")).trimmed();
+    const QString clientOrderId = param(request.params, QStringLiteral("origClientOrderId")).trimmed();
+    for (auto it = restingOrders_.begin(); it != restingOrders_.end(); ++it) {
+        Order &order = it.value();
+        if (market_.symbols().at(order.symbolIndex).symbol != symbol
+            || (!orderId.isEmpty() ? QString::number(order.orderId) != orderId : order.clientOrderId != clientOrderId)) {
+            continue;
+        }
+        order.status = QStringLiteral("CANCELED");
+        order.updateTimeMs = nowMs;
+        pushOrderUpdate(order, QStringLiteral("CANCELED"), 0.0, 0.0, 0.0, 0.0, nowMs);
+        const QJsonObject canceled = orderObject(order);
+        restingOrders_.erase(it);
+        return Reply{200, compact(canceled)};
+    }
+    return Reply{400, errorBody(-2011, QStringLiteral("Unknown order sent."))};
+}
+
+Server::Reply Server::openOrders(const Request &request) const {
+    const QString symbol = param(request.params, QStringLiteral("symbol")).trimmed().toUpper();
+    QList<qint64> ids = restingOrders_.keys();
+    std::sort(ids.begin(), ids.end());
+    QJsonArray rows;
+    for (const qint64 id : std::as_const(ids)) {
+        const Order &order = restingOrders_[id];
+        if (symbol.isEmpty() || market_.symbols().at(order.symbolIndex).symbol == symbol) {
+            rows.append(orderObject(order));
+        }
+    }
+    return Reply{200, compact(rows)};
+}
+
+Server::Reply Server::listenKey(const Request &request, qint64 nowMs) {
+    Q_UNUSED(nowMs)
+    const QString apiKey = QString::fromUtf8(request.headers.value("x-mbx-apikey"));
+    if (apiKey.isEmpty() || (!config_.apiKey.isEmpty() && apiKey != config_.apiKey)) {
+        return Reply{401, errorBody(-2015, QStringLiteral("Invalid API-key, IP, or permissions for action."))};
+    }
+    if (request.method == "POST") {
+        // Like the exchange, one key per account: creating returns the
+        // active one.
+        if (listenKey_.isEmpty()) {
+            QByteArray raw;
+            for (int i = 0; i < 4; ++i) {
+                const quint64 word = mix64(randomState_ += 0x9E3779B97F4A7C15ULL);
+                raw.append(reinterpret_cast<const char *>(&word), sizeof(word));
+            }
+            listenKey_ = QString::fromLatin1(raw.toHex());
+        }
+        return Reply{200, compact(QJsonObject{{QStringLiteral("listenKey"), listenKey_}})};
+    }
+    if (listenKey_.isEmpty()) {
+        return Reply{400, errorBody(-1125, QStringLiteral("This listenKey does not exist."))};
+    }
+    if (request.method == "PUT") {
+        return Reply{200, compact(QJsonObject{{QStringLiteral("listenKey"), listenKey_}})};
+    }
+    listenKey_.clear();
+#if HAS_QT_WEBSOCKETS
+    const QList<QWebSocket *> sockets = streamSockets_.keys();
+    for (QWebSocket *socket : sockets) {
+        if (streamSockets_.value(socket).userData) {
+            socket->close();
+        }
+    }
+#endif
+    return Reply{200, QByteArrayLiteral("{}")};
+}
+
+bool Server::checkSignature(const Request &request, Reply *reply) const {
+    const QString apiKey = QString::fromUtf8(request.headers.value("x-mbx-apikey"));
+    if (apiKey.isEmpty() || (!config_.apiKey.isEmpty() && apiKey != config_.apiKey)) {
+        *reply = Reply{401, errorBody(-2015, QStringLiteral("Invalid API-key, IP, or permissions for action."))};
+        return false;
+    }
+    for (const char *name : {"timestamp", "signature"}) {
+        if (param(request.params, QString::fromLatin1(name)).isEmpty()) {
+            *reply = Reply{400, errorBody(-1102, QStringLiteral(
+                "Mandatory parameter '%1' was not sent, was empty/null, or malformed.").arg(QString::fromLatin1(name)))};
+            return false;
+        }
+    }
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 timestampMs = param(request.params, QStringLiteral("timestamp")).toLongLong();
+    bool windowOk = false;
+    qint64 recvWindowMs = param(request.params, QStringLiteral("recvWindow")).toLongLong(&windowOk);
+    recvWindowMs = windowOk && recvWindowMs > 0 ? recvWindowMs : 5000;
+    if (timestampMs > nowMs + 1000 || nowMs - timestampMs > recvWindowMs) {
+        *reply = Reply{400, errorBody(-1021, QStringLiteral("Timestamp for this request is outside of the recvWindow."))};
+        return false;
+    }
+    if (config_.apiSecret.isEmpty()) {
+        return true;
+    }
+    // The exchange signs the query as sent followed by the body, with the
+    // signature itself taken out.
+    QStringList signedParts;
+    for (const QString &part : request.rawQuery.split(QLatin1Char('&'), Qt::SkipEmptyParts)) {
+        if (!part.startsWith(QStringLiteral("signature="))) {
+            signedParts.append(part);
+        }
+    }
+    const QByteArray payload = signedParts.join(QLatin1Char('&')).toUtf8() + request.body;
+    const QByteArray expected = QMessageAuthenticationCode::hash(
+        payload, config_.apiSecret.toUtf8(), QCryptographicHash::Sha256).toHex();
+    if (expected != param(request.params, QStringLiteral("signature")).trimmed().toLower().toLatin1()) {
+        *reply = Reply{400, errorBody(-1022, QStringLiteral("Signature for this request is not valid."))};
+        return false;
+    }
+    return true;
+}
+
+double Server::markPrice(int index, qint64 nowMs) const {
+    return market_.priceAt(index, nowMs);
+}
+
+double Server::unrealizedProfit(qint64 nowMs) const {
+    double total = 0.0;
+    for (const Position &position : positions_) {
+        total += (markPrice(position.symbolIndex, nowMs) - position.entryPrice) * position.amount;
+    }
+    return total;
+}
+
+double Server::positionMargin(qint64 nowMs) const {
+    double total = 0.0;
+    for (const Position &position : positions_) {
+        total += std::fabs(position.amount) * markPrice(position.symbolIndex, nowMs) / config_.leverage;
+    }
+    return total;
+}
+
+double Server::openOrderMargin() const {
+    double total = 0.0;
+    for (const Order &order : restingOrders_) {
+        if (!order.reduceOnly) {
+            total += (order.quantity - order.executedQty) * order.price / config_.leverage;
+        }
+    }
+    return total;
+}
+
+double Server::availableBalance(qint64 nowMs) const {
+    return wallet_ + unrealizedProfit(nowMs) - positionMargin(nowMs) - openOrderMargin();
+}
+
+void Server::fill(Order &order, double quantity, double price, qint64 nowMs) {
+    const SymbolSpec &spec = market_.symbols().at(order.symbolIndex);
+    const QString key = spec.symbol + QLatin1Char('|') + order.positionSide;
+    Position &position = positions_[key];
+    position.symbolIndex = order.symbolIndex;
+    const double signedQuantity = order.side == QStringLiteral("BUY") ? quantity : -quantity;
+    const double before = position.amount;
+    const double after = roundToStep(before + signedQuantity, spec.stepSize);
+    double realized = 0.0;
+    if (before == 0.0 || (before > 0.0) == (signedQuantity > 0.0)) {
+        position.entryPrice = (std::fabs(before) * position.entryPrice + quantity * price) / std::fabs(after);
+    } else {
+        const double closed = std::min(std::fabs(before), quantity);
+        realized = closed * (price - position.entryPrice) * (before > 0.0 ? 1.0 : -1.0);
+        if (std::fabs(after) < spec.stepSize / 2.0) {
+            position.entryPrice = 0.0;
+        } else if ((after > 0.0) != (before > 0.0)) {
+            position.entryPrice = price;
+        }
+    }
+    position.amount = std::fabs(after) < spec.stepSize / 2.0 ? 0.0 : after;
+    position.updateTimeMs = nowMs;
+
+    const double commission = quantity * price * config_.takerFeeRate;
+    wallet_ += realized - commission;
+    order.avgPrice = (order.executedQty * order.avgPrice + quantity * price) / (order.executedQty + quantity);
+    order.executedQty = roundToStep(order.executedQty + quantity, spec.stepSize);
+    order.status = order.executedQty >= order.quantity - spec.stepSize / 2.0
+        ? QStringLiteral("FILLED")
+        : QStringLiteral("PARTIALLY_FILLED");
+    order.updateTimeMs = nowMs;
+    ++stats_.ordersFilled;
+
+    pushOrderUpdate(order, QStringLiteral("TRADE"), quantity, price, commission, realized, nowMs);
+    pushAccountUpdate(key, nowMs);
+    if (positions_.value(key).amount == 0.0) {
+        positions_.remove(key);
+    }
+}
+
+void Server::matchRestingOrders(qint64 nowMs) {
+    if (restingOrders_.isEmpty()) {
+        return;
+    }
+    QList<qint64> ids = restingOrders_.keys();
+    std::sort(ids.begin(), ids.end());
+    for (const qint64 id : std::as_const(ids)) {
+        Order order = restingOrders_.value(id);
+        double bid = 0.0;
+        double ask = 0.0;
+        market_.book(order.symbolIndex, nowMs, &bid, &ask);
+        const bool buy = order.side == QStringLiteral("BUY");
+        if (buy ? ask > order.price : bid < order.price) {
+            continue;
+        }
+        restingOrders_.remove(id);
+        double quantity = order.quantity - order.executedQty;
+        if (order.reduceOnly) {
+            const QString symbol = market_.symbols().at(order.symbolIndex).symbol;
+            const double held = positions_.value(symbol + QLatin1Char('|') + order.positionSide).amount;
+            quantity = std::min(quantity, (buy ? held < 0.0 : held > 0.0) ? std::fabs(held) : 0.0);
+            if (quantity <= 0.0) {
+                order.status = QStringLiteral("EXPIRED");
+                order.updateTimeMs = nowMs;
+                pushOrderUpdate(order, QStringLiteral("EXPIRED"), 0.0, 0.0, 0.0, 0.0, nowMs);
+                continue;
+            }
+        }
+        // A resting order is the maker: it fills at its own price.
+        fill(order, quantity, order.price, nowMs);
+    }
+}
+
+QJsonObject Server::orderObject(const Order &order) const {
+    const SymbolSpec &spec = market_.symbols().at(order.symbolIndex);
+    return QJsonObject{
+        {QStringLiteral("orderId"), order.orderId},
+        {QStringLiteral("symbol"), spec.symbol},
+        {QStringLiteral("status"), order.status},
+        {QStringLiteral("clientOrderId"), order.clientOrderId},
+        {QStringLiteral("price"), decimal(order.price, spec.pricePrecision)},
+        {QStringLiteral("avgPrice"), decimal(order.avgPrice, kBalancePrecision)},
+        {QStringLiteral("origQty"), decimal(order.quantity, spec.quantityPrecision)},
+        {QStringLiteral("executedQty"), decimal(order.executedQty, spec.quantityPrecision)},
+        {QStringLiteral("cumQuote"), decimal(order.executedQty * order.avgPrice, kBalancePrecision)},
+        {QStringLiteral("timeInForce"), order.timeInForce.isEmpty() ? QStringLiteral("GTC") : order.timeInForce},
+        {QStringLiteral("type"), order.type},
+        {QStringLiteral("origType"), order.type},
+        {QStringLiteral("reduceOnly"), order.reduceOnly},
+        {QStringLiteral("closePosition"), false},
+        {QStringLiteral("side"), order.side},
+        {QStringLiteral("positionSide"), order.positionSide},
+        {QStringLiteral("stopPrice"), QStringLiteral("0")},
+        {QStringLiteral("workingType"), QStringLiteral("CONTRACT_PRICE")},
+        {QStringLiteral("priceProtect"), false},
+        {QStringLiteral("updateTime"), order.updateTimeMs},
+    };
+}
+
+void Server::pushOrderUpdate(const Order &order, const QString &execution, double lastQty, double lastPrice,
+                             double commission, double realized, qint64 nowMs) {
+    const SymbolSpec &spec = market_.symbols().at(order.symbolIndex);
+    const QJsonObject details{
+        {QStringLiteral("s"), spec.symbol},
+        {QStringLiteral("c"), order.clientOrderId},
+        {QStringLiteral("S"), order.side},
+        {QStringLiteral("o"), order.type},
+        {QStringLiteral("f"), order.timeInForce.isEmpty() ? QStringLiteral("GTC") : order.timeInForce},
+        {QStringLiteral("q"), decimal(order.quantity, spec.quantityPrecision)},
+        {QStringLiteral("p"), decimal(order.price, spec.pricePrecision)},
+        {QStringLiteral("ap"), decimal(order.avgPrice, kBalancePrecision)},
+        {QStringLiteral("sp"), QStringLiteral("0")},
+        {QStringLiteral("x"), execution},
+        {QStringLiteral("X"), order.status},
+        {QStringLiteral("i"), order.orderId},
+        {QStringLiteral("l"), decimal(lastQty, spec.quantityPrecision)},
+        {QStringLiteral("z"), decimal(order.executedQty, spec.quantityPrecision)},
+        {QStringLiteral("L"), decimal(lastPrice, spec.pricePrecision)},
+        {QStringLiteral("N"), QStringLiteral("USDT")},
+        {QStringLiteral("n"), decimal(commission, kBalancePrecision)},
+        {QStringLiteral("T"), nowMs},
+        {QStringLiteral("m"), order.type == QStringLiteral("LIMIT") && execution == QStringLiteral("TRADE")
+                                  && lastPrice == order.price},
+        {QStringLiteral("R"), order.reduceOnly},
+        {QStringLiteral("wt"), QStringLiteral("CONTRACT_PRICE")},
+        {QStringLiteral("ot"), order.type},
+        {QStringLiteral("ps"), order.positionSide},
+        {QStringLiteral("cp"), false},
+        {QStringLiteral("rp"), decimal(realized, kBalancePrecision)},
+    };
+    pushUserData(compact(QJsonObject{
+        {QStringLiteral("e"), QStringLiteral("ORDER_TRADE_UPDATE")},
+        {QStringLiteral("E"), nowMs},
+        {QStringLiteral("T"), nowMs},
+        {QStringLiteral("o"), details},
+    }));
+}
+
+void Server::pushAccountUpdate(const QString &positionKey, qint64 nowMs) {
+    const Position position = positions_.value(positionKey);
+    const SymbolSpec &spec = market_.symbols().at(position.symbolIndex);
+    const double mark = markPrice(position.symbolIndex, nowMs);
+    const QJsonObject balance{
+        {QStringLiteral("a"), QStringLiteral("USDT")},
+        {QStringLiteral("wb"), decimal(wallet_, kBalancePrecision)},
+        {QStringLiteral("cw"), decimal(wallet_, kBalancePrecision)},
+        {QStringLiteral("bc"), QStringLiteral("0")},
+    };
+    const QJsonObject changed{
+        {QStringLiteral("s"), spec.symbol},
+        {QStringLiteral("pa"), decimal(position.amount, spec.quantityPrecision)},
+        {QStringLiteral("ep"), decimal(position.entryPrice, kBalancePrecision)},
+        {QStringLiteral("bep"), decimal(position.entryPrice, kBalancePrecision)},
+        {QStringLiteral("cr"), QStringLiteral("0")},
+        {QStringLiteral("up"), decimal((mark - position.entryPrice) * position.amount, kBalancePrecision)},
+        {QStringLiteral("mt"), QStringLiteral("cross")},
+        {QStringLiteral("iw"), QStringLiteral("0")},
+        {QStringLiteral("ps"), positionKey.mid(positionKey.indexOf(QLatin1Char('|')) + 1)},
+    };
+    pushUserData(compact(QJsonObject{
+        {QStringLiteral("e"), QStringLiteral("ACCOUNT_UPDATE")},
+        {QStringLiteral("E"), nowMs},
+        {QStringLiteral("T"), nowMs},
+        {QStringLiteral("a"), QJsonObject{
+             {QStringLiteral("m"), QStringLiteral("ORDER")},
+             {QStringLiteral("B"), QJsonArray{balance}},
+             {QStringLiteral("P"), QJsonArray{changed}},
+         }},
+    }));
+}
+
+void Server::pushUserData(const QByteArray &payload) {
+#if HAS_QT_WEBSOCKETS
+    const QString message = QString::fromUtf8(payload);
+    for (auto it = streamSockets_.cbegin(); it != streamSockets_.cend(); ++it) {
+        if (it->userData) {
+            it.key()->sendTextMessage(message);
+            ++stats_.streamFrames;
+        }
+    }
+#else
+    Q_UNUSED(payload)
+#endif
+}
+
+#if HAS_QT_WEBSOCKETS
+void Server::acceptStreamSocket(QWebSocket *socket) {
+    const QUrl url = socket->requestUrl();
+    const QString path = url.path();
+    StreamSocket entry;
+    bool accepted = true;
+    if (path == QStringLiteral("/stream")) {
+        entry.combined = true;
+        const QString streams = QUrlQuery(url).queryItemValue(QStringLiteral("streams"));
+        for (const QString &stream : streams.split(QLatin1Char('/'), Qt::SkipEmptyParts)) {
+            entry.streams.insert(stream);
+        }
+    } else if (path.startsWith(QStringLiteral("/ws/"))) {
+        const QString tail = path.mid(4);
+        if (!listenKey_.isEmpty() && tail == listenKey_) {
+            entry.userData = true;
+        } else if (tail.contains(QLatin1Char('@'))) {
+            entry.streams.insert(tail);
+        } else {
+            accepted = false;
+        }
+    } else if (path != QStringLiteral("/ws")) {
+        accepted = false;
+    }
+    socket->setParent(this);
+    if (!accepted) {
+        socket->close(QWebSocketProtocol::CloseCodePolicyViolated, QStringLiteral("Unknown stream or listenKey"));
+        socket->deleteLater();
+        return;
+    }
+
+    ++(entry.userData ? stats_.userDataConnections : stats_.streamConnections);
+    streamSockets_.insert(socket, entry);
+    connect(socket, &QWebSocket::textMessageReceived, this, [this, socket](const QString &message) {
+        handleStreamCommand(socket, message);
+    });
+    connect(socket, &QWebSocket::disconnected, this, [this, socket]() {
+        streamSockets_.remove(socket);
+        socket->deleteLater();
+    });
+    if (!streamTimer_->isActive()) {
+        streamTimer_->start();
+    }
+}
+
+void Server::handleStreamCommand(QWebSocket *socket, const QString &message) {
+    const auto entry = streamSockets_.find(socket);
+    if (entry == streamSockets_.end()) {
+        return;
+    }
+    const QJsonObject command = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QString method = command.value(QStringLiteral("method")).toString();
+    const QJsonArray params = command.value(QStringLiteral("params")).toArray();
+    QJsonObject reply{{QStringLiteral("id"), command.value(QStringLiteral("id"))}};
+    if (method == QStringLiteral("SUBSCRIBE") || method == QStringLiteral("UNSUBSCRIBE")) {
+        for (const QJsonValue &stream : params) {
+            if (method == QStringLiteral("SUBSCRIBE")) {
+                entry->streams.insert(stream.toString());
+            } else {
+                entry->streams.remove(stream.toString());
+            }
+        }
+        reply.insert(QStringLiteral("result"), QJsonValue(QJsonValue::Null));
+    } else if (method == QStringLiteral("LIST_SUBSCRIPTIONS")) {
+        QStringList streams(entry->streams.cbegin(), entry->streams.cend());
+        std::sort(streams.begin(), streams.end());
+        reply.insert(QStringLiteral("result"), QJsonArray::fromStringList(streams));
+    } else {
+        reply.insert(QStringLiteral("error"), QJsonObject{
+            {QStringLiteral("code"), 2},
+            {QStringLiteral("msg"), QStringLiteral("Invalid request: unknown method '%1'").arg(method)},
+        });
+    }
+    socket->sendTextMessage(QString::fromUtf8(compact(reply)));
+}
+
+void Server::pushStreams() {
+    if (streamSockets_.isEmpty()) {
+        streamTimer_->stop();
+        return;
+    }
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    matchRestingOrders(nowMs);
+    // Built once per stream and tick, however many sockets follow it.
+    QHash<QString, QByteArrayList> payloads;
+    for (auto it = streamSockets_.cbegin(); it != streamSockets_.cend(); ++it) {
+        for (const QString &stream : it->streams) {
+            auto cached = payloads.find(stream);
+            if (cached == payloads.end()) {
+                cached = payloads.insert(stream, streamPayloads(stream, nowMs));
+            }
+            for (const QByteArray &data : std::as_const(*cached)) {
+                const QByteArray frame = it->combined
+                    ? QByteArray("{\"stream\":\"" + stream.toUtf8() + "\",\"data\":" + data + '}')
+                    : data;
+                it.key()->sendTextMessage(QString::fromUtf8(frame));
+                ++stats_.streamFrames;
+            }
+        }
+    }
+}
+
+QByteArrayList Server::streamPayloads(const QString &stream, qint64 nowMs) {
+    const int at = stream.indexOf(QLatin1Char('@'));
+    const int index = at > 0 ? market_.indexOf(stream.left(at)) : -1;
+    if (index < 0) {
+        return {};
+    }
+    const SymbolSpec &spec = market_.symbols().at(index);
+    const QByteArray symbol = spec.symbol.toLatin1();
+    const auto price = [&spec](double value) { return decimal(value, spec.pricePrecision).toLatin1(); };
+    const QString kind = stream.mid(at + 1);
+
+    if (kind == QStringLiteral("bookTicker")) {
+        double bid = 0.0;
+        double ask = 0.0;
+        market_.book(index, nowMs, &bid, &ask);
+        const QByteArray depth = decimal(std::max(spec.stepSize, roundToStep(1000.0 / bid, spec.stepSize)),
+                                         spec.quantityPrecision).toLatin1();
+        return {"{\"e\":\"bookTicker\",\"u\":" + QByteArray::number(bookUpdateId_++)
+                + ",\"E\":" + QByteArray::number(nowMs) + ",\"T\":" + QByteArray::number(nowMs)
+                + ",\"s\":\"" + symbol + "\",\"b\":\"" + price(bid) + "\",\"B\":\"" + depth
+                + "\",\"a\":\"" + price(ask) + "\",\"A\":\"" + depth + "\"}"};
+    }
+    if (kind == QStringLiteral("markPrice") || kind == QStringLiteral("markPrice@1s")) {
+        const QByteArray mark = decimal(markPrice(index, nowMs), kBalancePrecision).toLatin1();
+        const qint64 nextFundingMs = Market::alignOpenTime(nowMs, kFundingIntervalMs) + kFundingIntervalMs;
+        return {"{\"e\":\"markPriceUpdate\",\"E\":" + QByteArray::number(nowMs) + ",\"s\":\"" + symbol
+                + "\",\"p\":\"" + mark + "\",\"i\":\"" + mark + "\",\"P\":\"" + mark
+                + "\",\"r\":\"0.00010000\",\"T\":" + QByteArray::number(nextFundingMs) + '}'};
+    }
+    if (!kind.startsWith(QStringLiteral("kline_"))) {
+        return {};
+    }
+    const QString interval = kind.mid(6);
+    const qint64 step = Market::intervalMs(interval);
+    if (step <= 0) {
+        return {};
+    }
+    const auto klineFrame = [&](const Candle &candle, bool closed) -> QByteArray {
+        return "{\"e\":\"kline\",\"E\":" + QByteArray::number(nowMs) + ",\"s\":\"" + symbol
+            + "\",\"k\":{\"t\":" + QByteArray::number(candle.openTimeMs)
+            + ",\"T\":" + QByteArray::number(candle.closeTimeMs)
+            + ",\"s\":\"" + symbol + "\",\"i\":\"" + interval.toLatin1()
+            + "\",\"f\":0,\"L\":0,\"o\":\"" + price(candle.open) + "\",\"c\":\"" + price(candle.close)
+            + "\",\"h\":\"" + price(candle.high) + "\",\"l\":\"" + price(candle.low)
+            + "\",\"v\":\"" + decimal(candle.volume, spec.quantityPrecision).toLatin1()
+            + "\",\"n\":" + QByteArray::number(candle.trades)
+            + ",\"x\":" + (closed ? "true" : "false")
+            + ",\"q\":\"" + decimal(candle.quoteVolume, 4).toLatin1()
+            + "\",\"V\":\"0\",\"Q\":\"0\",\"B\":\"0\"}}";
+    };
+    const qint64 openTimeMs = Market::alignOpenTime(nowMs, step);
+    QByteArrayList frames;
+    const auto previous = klineOpenTimes_.constFind(stream);
+    if (previous != klineOpenTimes_.cend() && *previous < openTimeMs) {
+        frames.append(klineFrame(market_.candle(index, *previous, step, nowMs), true));
+    }
+    klineOpenTimes_.insert(stream, openTimeMs);
+    frames.append(klineFrame(market_.candle(index, openTimeMs, step, nowMs), false));
+    return frames;
+}
+#endif
+
+} // namespace NativeExchangeSimulator
@@ -0,0 +1,338 @@
+#pragma once
+
+#ifndef HAS_QT_WEBSOCKETS
+#define HAS_QT_WEBSOCKETS 0
+#endif
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+#if HAS_QT_WEBSOCKETS
+class QWebSocket;
+class QWebSocketServer;
+#endif
+
+// Local stand-in for the Binance endpoints the native client talks to, for
+// offline end-to-end and load tests.
+//
+// One port serves the REST API under /fapi and /api (exchangeInfo, klines,
+// tickers, positionRisk, account, balance, order, listenKey) and, with Qt
+// WebSockets, the market and user-data streams under /ws and /stream. Prices
+// are a deterministic function of symbol, time and seed, so a candle fetched
+// over REST and the same candle pushed on a kline stream agree, and two runs
+// with the same seed serve the same market. Klines and individual responses
+// can be scripted instead, and latency, errors and request-weight bans can be
+// injected. Point BinanceRestClient's base URL override at restBaseUrl() and
+// the stream clients at streamBaseUrl().
+namespace NativeExchangeSimulator {
+
+struct Config {
+    // 0 picks a free port.
+    quint16 port = 0;
+    // Listed USDT symbols; when empty, symbolCount synthetic SIM0001USDT,
+    // SIM0002USDT, ...
+    QStringList symbols;
+    int symbolCount = 100;
+    quint64 seed = 1;
+    // Added to every REST reply, plus a uniform jitter of up to
+    // latencyJitterMs.
+    int latencyMs = 0;
+    int latencyJitterMs = 0;
+    // Share of REST requests answered with a 503 instead.
+    double errorRate = 0.0;
+    // Request weight per minute before replies turn into 429s; 0 disables
+    // the limit. Each further request in the same minute counts against
+    // requestsBeforeBan, after which the IP is banned with 418s for
+    // banSeconds.
+    int weightLimitPerMinute = 2400;
+    int requestsBeforeBan = 5;
+    int banSeconds = 120;
+    // How often subscribed streams are pushed.
+    int streamIntervalMs = 1000;
+    // Closes every stream socket this often to exercise reconnects; 0 never.
+    int streamDropIntervalMs = 0;
+    // Accepted credentials: an empty key accepts any, an empty secret skips
+    // signature checks.
+    QString apiKey;
+    QString apiSecret;
+    double walletBalanceUsdt = 10'000.0;
+    int leverage = 20;
+    double takerFeeRate = 0.0004;
+};
+
+struct Candle {
+    qint64 openTimeMs = 0;
+    qint64 closeTimeMs = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    double quoteVolume = 0.0;
+    int trades = 0;
+};
+
+struct SymbolSpec {
+    QString symbol;
+    double basePrice = 0.0;
+    int pricePrecision = 2;
+    int quantityPrecision = 3;
+    double tickSize = 0.01;
+    double stepSize = 0.001;
+};
+
+// The synthetic market: per symbol a log-price made of a slow and a fast
+// wave plus per-minute noise, interpolated linearly within the minute. A
+// candle's close is the next candle's open.
+class Market {
+public:
+    Market(const QStringList &symbols, quint64 seed);
+
+    const QVector<SymbolSpec> &symbols() const { return specs_; }
+    // -1 for a symbol that is not listed.
+    int indexOf(const QString &symbol) const;
+
+    double priceAt(int index, qint64 timeMs) const;
+    // The candle opening at openTimeMs; a candle still open at nowMs closes
+    // at the nowMs price.
+    Candle candle(int index, qint64 openTimeMs, qint64 intervalMs, qint64 nowMs) const;
+    // Best bid and ask around the price at timeMs, one or more ticks apart.
+    void book(int index, qint64 timeMs, double *bid, double *ask) const;
+    double roundToTick(int index, double price) const;
+
+    // Fixed-length Binance intervals (1m to 1w); 0 for anything else,
+    // including 1M.
+    static qint64 intervalMs(const QString &interval);
+    // Open time of the interval containing timeMs; weeks start on Monday
+    // like Binance's.
+    static qint64 alignOpenTime(qint64 timeMs, qint64 intervalMs);
+
+private:
+    struct Waves {
+        double slowPeriod = 0.0;
+        double slowPhase = 0.0;
+        double fastPeriod = 0.0;
+        double fastPhase = 0.0;
+        quint64 noiseSeed = 0;
+    };
+
+    double logOffset(int index, qint64 minute) const;
+
+    QVector<SymbolSpec> specs_;
+    QVector<Waves> waves_;
+    QHash<QString, int> indexBySymbol_;
+};
+
+// A canned reply for one method and path, served before the simulated
+// endpoint. An empty method matches any.
+struct ScriptedResponse {
+    QByteArray method;
+    QString path;
+    int status = 200;
+    QByteArray body;
+    // Replies left; -1 for every matching request.
+    int remaining = -1;
+    int delayMs = 0;
+};
+
+struct Stats {
+    quint64 restRequests = 0;
+    quint64 scriptedResponses = 0;
+    quint64 injectedErrors = 0;
+    quint64 rateLimited = 0;
+    quint64 banned = 0;
+    quint64 ordersFilled = 0;
+    quint64 ordersRejected = 0;
+    quint64 streamConnections = 0;
+    quint64 userDataConnections = 0;
+    quint64 streamFrames = 0;
+};
+
+class Server final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Server(const Config &config = {}, QObject *parent = nullptr);
+    ~Server() override;
+
+    bool listen(QString *error = nullptr);
+    void close();
+    quint16 port() const;
+    // http://127.0.0.1:<port>, for futures and spot alike.
+    QString restBaseUrl() const;
+    // ws://127.0.0.1:<port>; streams live under /ws and /stream.
+    QString streamBaseUrl() const;
+
+    const Market &market() const { return market_; }
+
+    // Reads {"klines":{"BTCUSDT":{"1m":[[row], ...]}},"responses":[{"method":
+    // "GET","path":"/fapi/v1/ticker/price","status":503,"body":{...},"times":
+    // 2,"delay_ms":0}]}. Kline rows use the exchange's array layout and
+    // replace the synthetic REST candles of that symbol and interval (streams
+    // stay synthetic); the symbol must be listed.
+    bool loadScript(const QString &path, QString *error = nullptr);
+    void addScriptedResponse(const ScriptedResponse &response);
+    void setCandles(const QString &symbol, const QString &interval, const QVector<Candle> &candles);
+
+    void setLatency(int latencyMs, int jitterMs = 0);
+    void setErrorRate(double rate);
+    // Answers every REST request with a 418 for the next seconds.
+    void banFor(int seconds);
+    // Closes every stream and user-data socket.
+    void dropStreamConnections();
+    // Pushes listenKeyExpired to the user-data sockets and forgets the key.
+    void expireListenKeys();
+
+    Stats stats() const { return stats_; }
+    // Futures account, for assertions.
+    double walletBalance() const { return wallet_; }
+    double positionAmount(const QString &symbol, const QString &positionSide = QStringLiteral("BOTH")) const;
+
+private:
+    struct Request {
+        QByteArray method;
+        QString path;
+        // Query and form body merged, in arrival order.
+        QList<QPair<QString, QString>> params;
+        // Undecoded, for the signature check.
+        QString rawQuery;
+        QByteArray body;
+        // Lower-case names.
+        QHash<QByteArray, QByteArray> headers;
+    };
+    struct Reply {
+        int status = 200;
+        QByteArray body;
+        int retryAfterSeconds = 0;
+        // X-MBX-USED-WEIGHT-1M; -1 leaves the header out.
+        int usedWeight = -1;
+        // Overrides the configured latency when >= 0.
+        int delayMs = -1;
+    };
+    struct Connection {
+        QByteArray buffer;
+        bool busy = false;
+        bool served = false;
+    };
+    struct Position {
+        int symbolIndex = -1;
+        // Negative for shorts.
+        double amount = 0.0;
+        double entryPrice = 0.0;
+        qint64 updateTimeMs = 0;
+    };
+    struct Order {
+        qint64 orderId = 0;
+        QString clientOrderId;
+        int symbolIndex = -1;
+        QString side;
+        QString positionSide;
+        QString type;
+        QString timeInForce;
+        double price = 0.0;
+        double quantity = 0.0;
+        double executedQty = 0.0;
+        double avgPrice = 0.0;
+        bool reduceOnly = false;
+        QString status;
+        qint64 updateTimeMs = 0;
+    };
+
+    void handleReadyRead(QTcpSocket *socket);
+    void serveNext(QTcpSocket *socket);
+    bool parseRequest(QByteArray &buffer, Request *request, bool *complete);
+    // Admission, scripted responses and error injection, then endpoint().
+    Reply route(const Request &request, qint64 nowMs);
+    bool admit(const Request &request, qint64 nowMs, Reply *reply);
+    Reply endpoint(const Request &request, qint64 nowMs);
+    void writeReply(QTcpSocket *socket, const Reply &reply, bool keepAlive);
+
+    Reply exchangeInfo(bool futures, qint64 nowMs) const;
+    Reply klines(const Request &request, bool futures, qint64 nowMs) const;
+    Reply tickerPrice(const Request &request, qint64 nowMs) const;
+    Reply ticker24hr(const Request &request, qint64 nowMs) const;
+    Reply bookTicker(const Request &request, qint64 nowMs) const;
+    Reply positionRisk(const Request &request, qint64 nowMs) const;
+    Reply futuresAccount(qint64 nowMs) const;
+    Reply futuresBalance(qint64 nowMs) const;
+    Reply spotAccount(qint64 nowMs) const;
+    Reply newOrder(const Request &request, qint64 nowMs);
+    Reply cancelOrder(const Request &request, qint64 nowMs);
+    Reply openOrders(const Request &request) const;
+    Reply listenKey(const Request &request, qint64 nowMs);
+
+    bool checkSignature(const Request &request, Reply *reply) const;
+    double markPrice(int index, qint64 nowMs) const;
+    double unrealizedProfit(qint64 nowMs) const;
+    double positionMargin(qint64 nowMs) const;
+    double openOrderMargin() const;
+    double availableBalance(qint64 nowMs) const;
+    // Fills qty of order at price and pushes the account and order events.
+    void fill(Order &order, double quantity, double price, qint64 nowMs);
+    void matchRestingOrders(qint64 nowMs);
+    QJsonObject orderObject(const Order &order) const;
+    void pushOrderUpdate(const Order &order, const QString &execution, double lastQty, double lastPrice,
+                         double commission, double realized, qint64 nowMs);
+    void pushAccountUpdate(const QString &positionKey, qint64 nowMs);
+    void pushUserData(const QByteArray &payload);
+
+    Config config_;
+    Market market_;
+    QTcpServer *tcpServer_ = nullptr;
+    QHash<QTcpSocket *, Connection> connections_;
+    QList<ScriptedResponse> scripted_;
+    // symbol|interval -> scripted candles, by open time.
+    QHash<QString, QVector<Candle>> scriptedCandles_;
+    quint64 randomState_ = 0;
+
+    qint64 weightMinute_ = 0;
+    int weightUsed_ = 0;
+    int requestsOverLimit_ = 0;
+    qint64 banUntilMs_ = 0;
+
+    double wallet_ = 0.0;
+    // symbol|positionSide -> open position.
+    QHash<QString, Position> positions_;
+    QHash<qint64, Order> restingOrders_;
+    qint64 nextOrderId_ = 1'000'000;
+    QString listenKey_;
+
+    Stats stats_;
+
+#if HAS_QT_WEBSOCKETS
+    struct StreamSocket {
+        bool combined = false;
+        bool userData = false;
+        QSet<QString> streams;
+    };
+
+    void acceptStreamSocket(QWebSocket *socket);
+    void handleStreamCommand(QWebSocket *socket, const QString &message);
+    void pushStreams();
+    // The stream's frames for this push: a closing kline frame first when
+    // the candle rolled over since the last push. Empty for names the market
+    // does not serve.
+    QByteArrayList streamPayloads(const QString &stream, qint64 nowMs);
+
+    QWebSocketServer *webSocketServer_ = nullptr;
+    QHash<QWebSocket *, StreamSocket> streamSockets_;
+    QTimer *streamTimer_ = nullptr;
+    QTimer *dropTimer_ = nullptr;
+    // kline stream -> open time of the candle last pushed.
+    QHash<QString, qint64> klineOpenTimes_;
+    qint64 bookUpdateId_ = 1;
+#endif
+};
+
+} // namespace NativeExchangeSimulator
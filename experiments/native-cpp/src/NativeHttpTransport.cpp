@@ -0,0 +1,169 @@
+#include "NativeHttpTransport.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+struct Counters {
+    std::atomic<quint64> managersCreated{0};
+    std::atomic<quint64> requests{0};
+    std::atomic<quint64> responses{0};
+    std::atomic<quint64> connectionsOpened{0};
+    std::atomic<quint64> reusedConnections{0};
+    std::atomic<quint64> tlsHandshakes{0};
+    std::atomic<quint64> http2Responses{0};
+};
+
+Counters &counters() {
+    static Counters instance;
+    return instance;
+}
+
+// The main thread's manager is parented to the application so it goes away
+// with it; managers on worker threads are deleted when their thread exits.
+struct ThreadManager {
+    QPointer<QNetworkAccessManager> manager;
+    ~ThreadManager() { delete manager.data(); }
+};
+
+QNetworkAccessManager &threadManager() {
+    thread_local ThreadManager holder;
+    if (!holder.manager) {
+        QCoreApplication *app = QCoreApplication::instance();
+        auto *manager = new QNetworkAccessManager(
+            app && app->thread() == QThread::currentThread() ? app : nullptr);
+        QObject::connect(manager, &QNetworkAccessManager::encrypted, manager, [](QNetworkReply *) {
+            counters().tlsHandshakes.fetch_add(1, std::memory_order_relaxed);
+        });
+        holder.manager = manager;
+        counters().managersCreated.fetch_add(1, std::memory_order_relaxed);
+    }
+    return *holder.manager;
+}
+
+QNetworkReply *dispatch(
+    QNetworkAccessManager &manager,
+    const QNetworkRequest &request,
+    const QByteArray &method,
+    const QByteArray &body) {
+    if (method == "GET") return manager.get(request);
+    if (method == "POST") return manager.post(request, body);
+    if (method == "PUT") return manager.put(request, body);
+    if (method == "DELETE" || method == "PATCH") return manager.sendCustomRequest(request, method, body);
+    return nullptr;
+}
+
+} // namespace
+
+namespace NativeHttpTransport {
+
+QNetworkReply *sendAsync(const Request &request, ResponseCallback onFinished) {
+    QNetworkRequest networkRequest{request.url};
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("trading-bot-cpp/1.0"));
+    networkRequest.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    if (!request.contentType.isEmpty()) {
+        networkRequest.setHeader(QNetworkRequest::ContentTypeHeader, QString::fromLatin1(request.contentType));
+    }
+    for (const auto &header : request.headers) {
+        networkRequest.setRawHeader(header.first, header.second);
+    }
+
+    QNetworkReply *reply = dispatch(threadManager(), networkRequest, request.method.trimmed().toUpper(), request.body);
+    if (!reply) return nullptr;
+    counters().requests.fetch_add(1, std::memory_order_relaxed);
+
+    struct ReplyState {
+        bool openedConnection = false;
+        bool timedOut = false;
+    };
+    auto state = std::make_shared<ReplyState>();
+    QObject::connect(reply, &QNetworkReply::socketStartedConnecting, reply, [state]() {
+        if (state->openedConnection) return;
+        state->openedConnection = true;
+        counters().connectionsOpened.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    auto *deadline = new QTimer(reply);
+    deadline->setSingleShot(true);
+    QObject::connect(deadline, &QTimer::timeout, reply, [reply, state]() {
+        state->timedOut = true;
+        reply->abort();
+    });
+    deadline->start(std::max(1, request.timeoutMs));
+
+    QObject::connect(reply, &QNetworkReply::finished, reply, [reply, state, onFinished = std::move(onFinished)]() {
+        Response response;
+        response.timedOut = state->timedOut;
+        response.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        response.networkError = reply->error();
+        response.errorString = reply->errorString();
+        response.headers = reply->rawHeaderPairs();
+        response.body = reply->readAll();
+        response.http2 = reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool();
+        response.reusedConnection = !state->openedConnection && response.statusCode > 0;
+        reply->deleteLater();
+
+        Counters &totals = counters();
+        totals.responses.fetch_add(1, std::memory_order_relaxed);
+        if (response.reusedConnection) totals.reusedConnections.fetch_add(1, std::memory_order_relaxed);
+        if (response.http2) totals.http2Responses.fetch_add(1, std::memory_order_relaxed);
+        if (onFinished) onFinished(response);
+    });
+    return reply;
+}
+
+Response send(const Request &request) {
+    Response response;
+    bool done = false;
+    QEventLoop loop;
+    QNetworkReply *reply = sendAsync(request, [&](const Response &finished) {
+        response = finished;
+        done = true;
+        loop.quit();
+    });
+    if (!reply) {
+        response.networkError = QNetworkReply::ProtocolUnknownError;
+        response.errorString = QStringLiteral("Unsupported HTTP method %1").arg(QString::fromLatin1(request.method));
+        return response;
+    }
+    if (!done) loop.exec();
+    return response;
+}
+
+Stats stats() {
+    const Counters &totals = counters();
+    Stats snapshot;
+    snapshot.managersCreated = totals.managersCreated.load(std::memory_order_relaxed);
+    snapshot.requests = totals.requests.load(std::memory_order_relaxed);
+    snapshot.responses = totals.responses.load(std::memory_order_relaxed);
+    snapshot.connectionsOpened = totals.connectionsOpened.load(std::memory_order_relaxed);
+    snapshot.reusedConnections = totals.reusedConnections.load(std::memory_order_relaxed);
+    snapshot.tlsHandshakes = totals.tlsHandshakes.load(std::memory_order_relaxed);
+    snapshot.http2Responses = totals.http2Responses.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+QJsonObject statsSnapshot() {
+    const Stats snapshot = stats();
+    return {
+        {QStringLiteral("managers_created"), static_cast<qint64>(snapshot.managersCreated)},
+        {QStringLiteral("requests"), static_cast<qint64>(snapshot.requests)},
+        {QStringLiteral("responses"), static_cast<qint64>(snapshot.responses)},
+        {QStringLiteral("connections_opened"), static_cast<qint64>(snapshot.connectionsOpened)},
+        {QStringLiteral("reused_connections"), static_cast<qint64>(snapshot.reusedConnections)},
+        {QStringLiteral("tls_handshakes"), static_cast<qint64>(snapshot.tlsHandshakes)},
+        {QStringLiteral("http2_responses"), static_cast<qint64>(snapshot.http2Responses)},
+    };
+}
+
+} // namespace NativeHttpTransport
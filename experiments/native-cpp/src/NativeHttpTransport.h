@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QNetworkReply>
+#include <QPair>
+#include <QString>
+#include <QUrl>
+
+#include <functional>
+
+// Shared HTTP transport for the REST clients. Every thread that sends gets one
+// long-lived QNetworkAccessManager, so keep-alive connections, TLS sessions
+// and HTTP/2 sessions survive from one request to the next instead of being
+// rebuilt per call.
+namespace NativeHttpTransport {
+
+struct Request {
+    QByteArray method = QByteArrayLiteral("GET");
+    QUrl url;
+    QList<QPair<QByteArray, QByteArray>> headers;
+    QByteArray contentType;
+    QByteArray body;
+    // Whole-request deadline; the reply is aborted when it passes.
+    int timeoutMs = 10'000;
+};
+
+struct Response {
+    bool timedOut = false;
+    int statusCode = 0;
+    QNetworkReply::NetworkError networkError = QNetworkReply::NoError;
+    QString errorString;
+    // Raw reply headers as received, e.g. X-MBX-USED-WEIGHT-1M.
+    QList<QPair<QByteArray, QByteArray>> headers;
+    QByteArray body;
+    bool http2 = false;
+    bool reusedConnection = false;
+};
+
+using ResponseCallback = std::function<void(const Response &response)>;
+
+// Starts the request on the calling thread's manager and returns the reply,
+// or nullptr for an unsupported method. onFinished runs once on the calling
+// thread, which needs a running event loop. Aborting the reply finishes it
+// with OperationCanceledError.
+QNetworkReply *sendAsync(const Request &request, ResponseCallback onFinished);
+
+// Blocking adapter over sendAsync for synchronous call sites; spins a local
+// event loop until the reply finishes or times out.
+Response send(const Request &request);
+
+struct Stats {
+    quint64 managersCreated = 0;
+    quint64 requests = 0;
+    quint64 responses = 0;
+    quint64 connectionsOpened = 0;
+    quint64 reusedConnections = 0;
+    quint64 tlsHandshakes = 0;
+    quint64 http2Responses = 0;
+};
+
+Stats stats();
+QJsonObject statsSnapshot();
+
+} // namespace NativeHttpTransport
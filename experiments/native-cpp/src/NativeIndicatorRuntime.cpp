@@ -1,5 +1,7 @@
 #include "NativeIndicatorRuntime.h"
 
+#include "NativeRollingWindow.h"
+
 #include <QJsonValue>
 
 #include <algorithm>
@@ -10,8 +12,17 @@
 
 namespace {
 
-using Candle = NativeIndicatorRuntime::Candle;
+using NativeIndicatorRuntime::CandleSpan;
+using NativeIndicatorRuntime::Column;
 using Series = NativeIndicatorRuntime::Series;
+using NativeRollingWindow::CompensatedSum;
+using NativeRollingWindow::Extremum;
+using NativeRollingWindow::MonotonicWindow;
+using NativeRollingWindow::RollingMaximum;
+using NativeRollingWindow::RollingMinimum;
+using NativeRollingWindow::RollingMoments;
+using NativeRollingWindow::RollingSum;
+using NativeRollingWindow::TieBreak;
 
 constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
 
@@ -65,25 +76,15 @@ QString configString(const QJsonObject &config, const QString &key) {
     return config.value(key).toString().trimmed().toUpper();
 }
 
-Series closes(const QVector<Candle> &candles) {
-    Series result;
-    result.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        result.push_back(candle.close);
-    }
-    return result;
+Series toSeries(Column values) {
+    return Series(values.begin(), values.end());
 }
 
-Series volumes(const QVector<Candle> &candles) {
-    Series result;
-    result.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        result.push_back(candle.volume);
-    }
-    return result;
+Column column(const Series &values) {
+    return {values.constData(), static_cast<std::size_t>(values.size())};
 }
 
-Series emaSeries(const Series &values, qsizetype length) {
+Series emaSeries(Column values, qsizetype length) {
     const double alpha = 2.0 / (static_cast<double>(std::max<qsizetype>(1, length)) + 1.0);
     double previous = kNaN;
     Series result;
@@ -101,7 +102,7 @@ Series emaSeries(const Series &values, qsizetype length) {
     return result;
 }
 
-Series ewmAlphaSeries(const Series &values, double alpha) {
+Series ewmAlphaSeries(Column values, double alpha) {
     double previous = kNaN;
     Series result;
     result.reserve(values.size());
@@ -114,87 +115,86 @@ Series ewmAlphaSeries(const Series &values, double alpha) {
     return result;
 }
 
-Series rollingMeanMin(const Series &values, qsizetype length) {
+// Pandas rolling(min_periods=1) semantics: non-finite values are skipped.
+Series rollingMeanMin(Column values, qsizetype length) {
     length = std::max<qsizetype>(1, length);
-    Series result;
-    result.reserve(values.size());
+    Series result(values.size());
+    RollingSum window;
     for (qsizetype index = 0; index < values.size(); ++index) {
-        const qsizetype start = index + 1 - std::min(length, index + 1);
-        double sum = 0.0;
-        qsizetype count = 0;
-        for (qsizetype cursor = start; cursor <= index; ++cursor) {
-            if (std::isfinite(values[cursor])) {
-                sum += values[cursor];
-                ++count;
-            }
+        window.push(values[index]);
+        if (index >= length) {
+            window.pop(values[index - length]);
         }
-        result.push_back(count > 0 ? sum / static_cast<double>(count) : kNaN);
+        result[index] = window.finiteCount() > 0
+            ? window.finiteSum() / static_cast<double>(window.finiteCount())
+            : kNaN;
     }
     return result;
 }
 
-Series rollingSumMin(const Series &values, qsizetype length) {
+Series rollingSumMin(Column values, qsizetype length) {
     length = std::max<qsizetype>(1, length);
-    Series result;
-    result.reserve(values.size());
+    Series result(values.size());
+    RollingSum window;
     for (qsizetype index = 0; index < values.size(); ++index) {
-        const qsizetype start = index + 1 - std::min(length, index + 1);
-        double sum = 0.0;
-        qsizetype count = 0;
-        for (qsizetype cursor = start; cursor <= index; ++cursor) {
-            if (std::isfinite(values[cursor])) {
-                sum += values[cursor];
-                ++count;
-            }
+        window.push(values[index]);
+        if (index >= length) {
+            window.pop(values[index - length]);
         }
-        result.push_back(count > 0 ? sum : kNaN);
+        result[index] = window.finiteCount() > 0 ? window.finiteSum() : kNaN;
     }
     return result;
 }
 
-Series rollingMeanExact(const Series &values, qsizetype length) {
+// Full-window mean: any non-finite value inside the window yields NaN.
+Series rollingMeanExact(Column values, qsizetype length) {
     length = std::max<qsizetype>(1, length);
     Series result = filled(values.size());
-    for (qsizetype index = length - 1; index < values.size(); ++index) {
-        double sum = 0.0;
-        bool finite = true;
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            if (!std::isfinite(values[cursor])) {
-                finite = false;
-                break;
-            }
-            sum += values[cursor];
+    RollingSum window;
+    for (qsizetype index = 0; index < values.size(); ++index) {
+        window.push(values[index]);
+        if (index >= length) {
+            window.pop(values[index - length]);
         }
-        if (finite) {
-            result[index] = sum / static_cast<double>(length);
+        if (index >= length - 1 && window.allFinite()) {
+            result[index] = window.finiteSum() / static_cast<double>(length);
         }
     }
     return result;
 }
 
 std::tuple<Series, Series, Series> bollingerBands(
-    const Series &values,
+    Column values,
     qsizetype length,
     double multiplier
 ) {
     length = std::max<qsizetype>(1, length);
     Series middle = rollingMeanExact(values, length);
     Series deviation = filled(values.size());
-    for (qsizetype index = length - 1; index < values.size(); ++index) {
-        if (length < 2 || !std::isfinite(middle[index])) {
-            continue;
-        }
-        double squared = 0.0;
-        bool finite = true;
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            if (!std::isfinite(values[cursor])) {
-                finite = false;
-                break;
+    RollingMoments moments;
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    for (qsizetype index = 0; index < values.size(); ++index) {
+        highest.expireBefore(index + 1 - length);
+        lowest.expireBefore(index + 1 - length);
+        highest.push(index, values[index]);
+        lowest.push(index, values[index]);
+        if (index >= length && index % length == 0) {
+            moments.rebase(values.begin() + (index - length + 1), values.begin() + index + 1);
+        } else {
+            if (std::isfinite(values[index])) {
+                moments.push(values[index]);
+            }
+            if (index >= length && std::isfinite(values[index - length])) {
+                moments.pop(values[index - length]);
             }
-            squared += std::pow(values[cursor] - middle[index], 2.0);
         }
-        if (finite) {
-            deviation[index] = std::sqrt(squared / static_cast<double>(length - 1));
+        // A finite middle band means every value in the window is finite, so
+        // the moments cover the whole window. Flat windows are exactly zero.
+        if (length >= 2 && index >= length - 1 && std::isfinite(middle[index])) {
+            deviation[index] = highest.value() == lowest.value()
+                ? 0.0
+                : std::sqrt(moments.sampleVariance());
         }
     }
     Series upper(values.size());
@@ -206,7 +206,7 @@ std::tuple<Series, Series, Series> bollingerBands(
     return {upper, middle, lower};
 }
 
-Series bollingerBandWidth(const Series &values, qsizetype length, double multiplier) {
+Series bollingerBandWidth(Column values, qsizetype length, double multiplier) {
     auto [upper, middle, lower] = bollingerBands(values, length, multiplier);
     Series result(values.size());
     for (qsizetype index = 0; index < values.size(); ++index) {
@@ -218,22 +218,21 @@ Series bollingerBandWidth(const Series &values, qsizetype length, double multipl
     return result;
 }
 
-Series trueRangeSeries(const QVector<Candle> &candles) {
+Series trueRangeSeries(CandleSpan candles) {
     Series result;
     result.reserve(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
-        const Candle &candle = candles[index];
-        double range = std::abs(candle.high - candle.low);
+        double range = std::abs(candles.high[index] - candles.low[index]);
         if (index > 0) {
-            range = std::max(range, std::abs(candle.high - candles[index - 1].close));
-            range = std::max(range, std::abs(candle.low - candles[index - 1].close));
+            range = std::max(range, std::abs(candles.high[index] - candles.close[index - 1]));
+            range = std::max(range, std::abs(candles.low[index] - candles.close[index - 1]));
         }
         result.push_back(range);
     }
     return result;
 }
 
-Series atrSeries(const QVector<Candle> &candles, qsizetype length) {
+Series atrSeries(CandleSpan candles, qsizetype length) {
     const Series ranges = trueRangeSeries(candles);
     const double alpha = 1.0 / static_cast<double>(std::max<qsizetype>(1, length));
     double previous = kNaN;
@@ -248,27 +247,27 @@ Series atrSeries(const QVector<Candle> &candles, qsizetype length) {
     return result;
 }
 
-Series natrSeries(const QVector<Candle> &candles, qsizetype length) {
+Series natrSeries(CandleSpan candles, qsizetype length) {
     Series result = atrSeries(candles, length);
     for (qsizetype index = 0; index < result.size(); ++index) {
-        result[index] = std::isfinite(result[index]) && std::isfinite(candles[index].close)
-                && candles[index].close != 0.0
-            ? result[index] / candles[index].close * 100.0
+        result[index] = std::isfinite(result[index]) && std::isfinite(candles.close[index])
+                && candles.close[index] != 0.0
+            ? result[index] / candles.close[index] * 100.0
             : 0.0;
     }
     return result;
 }
 
-Series obvSeries(const QVector<Candle> &candles) {
+Series obvSeries(CandleSpan candles) {
     double cumulative = 0.0;
     Series result;
     result.reserve(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
         if (index > 0) {
-            if (candles[index].close > candles[index - 1].close) {
-                cumulative += candles[index].volume;
-            } else if (candles[index].close < candles[index - 1].close) {
-                cumulative -= candles[index].volume;
+            if (candles.close[index] > candles.close[index - 1]) {
+                cumulative += candles.volume[index];
+            } else if (candles.close[index] < candles.close[index - 1]) {
+                cumulative -= candles.volume[index];
             }
         }
         result.push_back(cumulative);
@@ -276,8 +275,8 @@ Series obvSeries(const QVector<Candle> &candles) {
     return result;
 }
 
-Series relativeVolumeSeries(const QVector<Candle> &candles, qsizetype length) {
-    const Series volume = volumes(candles);
+Series relativeVolumeSeries(CandleSpan candles, qsizetype length) {
+    const Column volume = candles.volume;
     const Series average = rollingMeanMin(volume, length);
     Series result(volume.size());
     for (qsizetype index = 0; index < volume.size(); ++index) {
@@ -288,18 +287,18 @@ Series relativeVolumeSeries(const QVector<Candle> &candles, qsizetype length) {
     return result;
 }
 
-Series chaikinMoneyFlowSeries(const QVector<Candle> &candles, qsizetype length) {
+Series chaikinMoneyFlowSeries(CandleSpan candles, qsizetype length) {
     Series moneyFlow;
     moneyFlow.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        const double range = candle.high - candle.low;
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        const double range = candles.high[index] - candles.low[index];
         moneyFlow.push_back(range == 0.0
             ? 0.0
-            : ((candle.close - candle.low) - (candle.high - candle.close))
-                / range * candle.volume);
+            : ((candles.close[index] - candles.low[index]) - (candles.high[index] - candles.close[index]))
+                / range * candles.volume[index]);
     }
-    const Series flowSum = rollingSumMin(moneyFlow, length);
-    const Series volumeSum = rollingSumMin(volumes(candles), length);
+    const Series flowSum = rollingSumMin(column(moneyFlow), length);
+    const Series volumeSum = rollingSumMin(candles.volume, length);
     Series result(candles.size());
     for (qsizetype index = 0; index < result.size(); ++index) {
         result[index] = std::isfinite(flowSum[index]) && std::isfinite(volumeSum[index])
@@ -310,31 +309,97 @@ Series chaikinMoneyFlowSeries(const QVector<Candle> &candles, qsizetype length)
     return result;
 }
 
-Series cciSeries(const QVector<Candle> &candles, qsizetype length, double constant) {
+// Rolling mean absolute deviation around each window's own mean. The window
+// values are ranked once up front; Fenwick trees over those ranks then give the
+// count and sum of window values at or below the mean in O(log n) per bar.
+// Each node keeps a Neumaier-compensated sum, since a node sees every value of
+// its rank range enter and leave the window over the whole series.
+class RankedWindowDeviation {
+public:
+    explicit RankedWindowDeviation(Column values) {
+        for (double value : values) {
+            if (std::isfinite(value)) ranked_.push_back(value);
+        }
+        std::sort(ranked_.begin(), ranked_.end());
+        ranked_.erase(std::unique(ranked_.begin(), ranked_.end()), ranked_.end());
+        counts_ = QVector<qsizetype>(ranked_.size() + 1, 0);
+        sums_ = QVector<CompensatedSum>(ranked_.size() + 1);
+    }
+
+    void push(double value) { update(value, 1); }
+    void pop(double value) { update(value, -1); }
+
+    // Mean of |value - center| over `count` finite window values summing to `total`.
+    double meanAbsoluteDeviation(double center, qsizetype count, double total) const {
+        const qsizetype rank = std::upper_bound(ranked_.cbegin(), ranked_.cend(), center) - ranked_.cbegin();
+        qsizetype belowCount = 0;
+        CompensatedSum below;
+        for (qsizetype node = rank; node > 0; node -= node & -node) {
+            belowCount += counts_[node];
+            below.add(sums_[node].value());
+        }
+        const double belowSum = below.value();
+        const double lower = center * static_cast<double>(belowCount) - belowSum;
+        const double upper = (total - belowSum) - center * static_cast<double>(count - belowCount);
+        return std::max(0.0, lower + upper) / static_cast<double>(count);
+    }
+
+private:
+    void update(double value, int direction) {
+        if (!std::isfinite(value)) return;
+        const qsizetype rank = std::lower_bound(ranked_.cbegin(), ranked_.cend(), value) - ranked_.cbegin() + 1;
+        for (qsizetype node = rank; node < counts_.size(); node += node & -node) {
+            counts_[node] += direction;
+            sums_[node].add(direction * value);
+        }
+    }
+
+    Series ranked_;
+    QVector<qsizetype> counts_;
+    QVector<CompensatedSum> sums_;
+};
+
+Series cciSeries(CandleSpan candles, qsizetype length, double constant) {
     length = std::max<qsizetype>(1, length);
     Series typical;
     typical.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        typical.push_back((candle.high + candle.low + candle.close) / 3.0);
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        typical.push_back((candles.high[index] + candles.low[index] + candles.close[index]) / 3.0);
     }
-    const Series average = rollingMeanMin(typical, length);
     Series result(typical.size());
+    RollingSum window;
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    RankedWindowDeviation deviation(column(typical));
     for (qsizetype index = 0; index < typical.size(); ++index) {
+        window.push(typical[index]);
+        deviation.push(typical[index]);
+        if (index >= length) {
+            window.pop(typical[index - length]);
+            deviation.pop(typical[index - length]);
+        }
         const qsizetype start = index + 1 - std::min(length, index + 1);
-        double deviation = 0.0;
-        for (qsizetype cursor = start; cursor <= index; ++cursor) {
-            deviation += std::abs(typical[cursor] - average[index]);
+        highest.expireBefore(start);
+        lowest.expireBefore(start);
+        highest.push(index, typical[index]);
+        lowest.push(index, typical[index]);
+        // Non-finite typical prices make the deviation non-finite, and a flat
+        // window has no deviation at all; both report zero.
+        if (!window.allFinite() || highest.value() == lowest.value()) {
+            continue;
         }
-        deviation /= static_cast<double>(index + 1 - start);
-        const double denominator = constant * deviation;
+        const qsizetype count = window.finiteCount();
+        const double average = window.finiteSum() / static_cast<double>(count);
+        const double denominator = constant
+            * deviation.meanAbsoluteDeviation(average, count, window.finiteSum());
         result[index] = std::isfinite(denominator) && denominator != 0.0
-            ? (typical[index] - average[index]) / denominator
+            ? (typical[index] - average) / denominator
             : 0.0;
     }
     return result;
 }
 
-Series rocSeries(const Series &values, qsizetype length) {
+Series rocSeries(Column values, qsizetype length) {
     length = std::max<qsizetype>(1, length);
     Series result(values.size());
     for (qsizetype index = 0; index < values.size(); ++index) {
@@ -345,8 +410,10 @@ Series rocSeries(const Series &values, qsizetype length) {
     return result;
 }
 
-Series trixSeries(const Series &values, qsizetype length) {
-    const Series third = emaSeries(emaSeries(emaSeries(values, length), length), length);
+Series trixSeries(Column values, qsizetype length) {
+    const Series first = emaSeries(values, length);
+    const Series second = emaSeries(column(first), length);
+    const Series third = emaSeries(column(second), length);
     Series result(third.size());
     for (qsizetype index = 1; index < third.size(); ++index) {
         result[index] = third[index - 1] == 0.0
@@ -357,7 +424,7 @@ Series trixSeries(const Series &values, qsizetype length) {
 }
 
 std::tuple<Series, Series, Series> macdSeries(
-    const Series &values,
+    Column values,
     qsizetype fastLength,
     qsizetype slowLength,
     qsizetype signalLength
@@ -368,7 +435,7 @@ std::tuple<Series, Series, Series> macdSeries(
     for (qsizetype index = 0; index < values.size(); ++index) {
         line[index] = fast[index] - slow[index];
     }
-    const Series signal = emaSeries(line, signalLength);
+    const Series signal = emaSeries(column(line), signalLength);
     Series histogram(values.size());
     for (qsizetype index = 0; index < values.size(); ++index) {
         histogram[index] = line[index] - signal[index];
@@ -377,7 +444,7 @@ std::tuple<Series, Series, Series> macdSeries(
 }
 
 std::tuple<Series, Series, Series> ppoSeries(
-    const Series &values,
+    Column values,
     qsizetype fastLength,
     qsizetype slowLength,
     qsizetype signalLength
@@ -390,7 +457,7 @@ std::tuple<Series, Series, Series> ppoSeries(
             ? (fast[index] - slow[index]) / slow[index] * 100.0
             : 0.0;
     }
-    const Series signal = emaSeries(line, signalLength);
+    const Series signal = emaSeries(column(line), signalLength);
     Series histogram(values.size());
     for (qsizetype index = 0; index < values.size(); ++index) {
         histogram[index] = line[index] - signal[index];
@@ -399,17 +466,17 @@ std::tuple<Series, Series, Series> ppoSeries(
 }
 
 Series awesomeOscillatorSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype fastLength,
     qsizetype slowLength
 ) {
     Series median;
     median.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        median.push_back((candle.high + candle.low) / 2.0);
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        median.push_back((candles.high[index] + candles.low[index]) / 2.0);
     }
-    const Series fast = rollingMeanMin(median, fastLength);
-    const Series slow = rollingMeanMin(median, slowLength);
+    const Series fast = rollingMeanMin(column(median), fastLength);
+    const Series slow = rollingMeanMin(column(median), slowLength);
     Series result(candles.size());
     for (qsizetype index = 0; index < result.size(); ++index) {
         result[index] = std::isfinite(fast[index]) && std::isfinite(slow[index])
@@ -419,18 +486,18 @@ Series awesomeOscillatorSeries(
     return result;
 }
 
-Series vwapSeries(const QVector<Candle> &candles, qsizetype length) {
+Series vwapSeries(CandleSpan candles, qsizetype length) {
     Series weighted;
     Series volume;
     weighted.reserve(candles.size());
     volume.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        const double typical = (candle.high + candle.low + candle.close) / 3.0;
-        weighted.push_back(typical * candle.volume);
-        volume.push_back(candle.volume);
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        const double typical = (candles.high[index] + candles.low[index] + candles.close[index]) / 3.0;
+        weighted.push_back(typical * candles.volume[index]);
+        volume.push_back(candles.volume[index]);
     }
-    const Series weightedSum = rollingSumMin(weighted, length);
-    const Series volumeSum = rollingSumMin(volume, length);
+    const Series weightedSum = rollingSumMin(column(weighted), length);
+    const Series volumeSum = rollingSumMin(column(volume), length);
     Series result(candles.size());
     for (qsizetype index = 0; index < result.size(); ++index) {
         result[index] = std::isfinite(weightedSum[index]) && std::isfinite(volumeSum[index])
@@ -441,15 +508,15 @@ Series vwapSeries(const QVector<Candle> &candles, qsizetype length) {
     return result;
 }
 
-Series mfiSeries(const QVector<Candle> &candles, qsizetype length) {
+Series mfiSeries(CandleSpan candles, qsizetype length) {
     Series typical;
     Series raw;
     typical.reserve(candles.size());
     raw.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        const double price = (candle.high + candle.low + candle.close) / 3.0;
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        const double price = (candles.high[index] + candles.low[index] + candles.close[index]) / 3.0;
         typical.push_back(price);
-        raw.push_back(price * candle.volume);
+        raw.push_back(price * candles.volume[index]);
     }
     Series positive(candles.size());
     Series negative(candles.size());
@@ -460,8 +527,8 @@ Series mfiSeries(const QVector<Candle> &candles, qsizetype length) {
             negative[index] = raw[index];
         }
     }
-    const Series positiveSum = rollingSumMin(positive, length);
-    const Series negativeSum = rollingSumMin(negative, length);
+    const Series positiveSum = rollingSumMin(column(positive), length);
+    const Series negativeSum = rollingSumMin(column(negative), length);
     Series result(candles.size());
     for (qsizetype index = 0; index < result.size(); ++index) {
         if (positiveSum[index] == 0.0 && negativeSum[index] == 0.0) {
@@ -477,7 +544,7 @@ Series mfiSeries(const QVector<Candle> &candles, qsizetype length) {
     return result;
 }
 
-Series rsiSeries(const QVector<Candle> &candles, qsizetype length) {
+Series rsiSeries(CandleSpan candles, qsizetype length) {
     length = std::max<qsizetype>(1, length);
     Series result = filled(candles.size());
     if (candles.size() < 2) {
@@ -487,7 +554,7 @@ Series rsiSeries(const QVector<Candle> &candles, qsizetype length) {
     double averageGain = 0.0;
     double averageLoss = 0.0;
     for (qsizetype index = 1; index < candles.size(); ++index) {
-        const double delta = candles[index].close - candles[index - 1].close;
+        const double delta = candles.close[index] - candles.close[index - 1];
         if (!std::isfinite(delta)) {
             continue;
         }
@@ -510,7 +577,7 @@ Series rsiSeries(const QVector<Candle> &candles, qsizetype length) {
 }
 
 std::pair<Series, Series> stochRsiSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype length,
     qsizetype smoothK,
     qsizetype smoothD
@@ -518,72 +585,72 @@ std::pair<Series, Series> stochRsiSeries(
     length = std::max<qsizetype>(1, length);
     const Series rsi = rsiSeries(candles, length);
     Series stochastic = filled(rsi.size());
-    for (qsizetype index = length - 1; index < rsi.size(); ++index) {
-        double minimum = std::numeric_limits<double>::infinity();
-        double maximum = -std::numeric_limits<double>::infinity();
-        bool finite = true;
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            if (!std::isfinite(rsi[cursor])) {
-                finite = false;
-                break;
-            }
-            minimum = std::min(minimum, rsi[cursor]);
-            maximum = std::max(maximum, rsi[cursor]);
-        }
-        if (finite && maximum != minimum) {
-            stochastic[index] = 100.0 * (rsi[index] - minimum) / (maximum - minimum);
+    RollingMaximum maximum(length);
+    RollingMinimum minimum(length);
+    qsizetype nonFinite = 0;
+    for (qsizetype index = 0; index < rsi.size(); ++index) {
+        if (!std::isfinite(rsi[index])) ++nonFinite;
+        if (index >= length && !std::isfinite(rsi[index - length])) --nonFinite;
+        maximum.expireBefore(index + 1 - length);
+        minimum.expireBefore(index + 1 - length);
+        maximum.push(index, rsi[index]);
+        minimum.push(index, rsi[index]);
+        if (index >= length - 1 && nonFinite == 0 && maximum.value() != minimum.value()) {
+            stochastic[index] = 100.0 * (rsi[index] - minimum.value())
+                / (maximum.value() - minimum.value());
         }
     }
-    Series k = rollingMeanExact(stochastic, smoothK);
-    Series d = rollingMeanExact(k, smoothD);
+    Series k = rollingMeanExact(column(stochastic), smoothK);
+    Series d = rollingMeanExact(column(k), smoothD);
     return {k, d};
 }
 
-Series williamsRSeries(const QVector<Candle> &candles, qsizetype length) {
+Series williamsRSeries(CandleSpan candles, qsizetype length) {
     length = std::max<qsizetype>(1, length);
     Series result = filled(candles.size());
-    for (qsizetype index = length - 1; index < candles.size(); ++index) {
-        double highest = -std::numeric_limits<double>::infinity();
-        double lowest = std::numeric_limits<double>::infinity();
-        bool finite = true;
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            const Candle &candle = candles[cursor];
-            if (!std::isfinite(candle.high) || !std::isfinite(candle.low)
-                || !std::isfinite(candle.close)) {
-                finite = false;
-                break;
-            }
-            highest = std::max(highest, candle.high);
-            lowest = std::min(lowest, candle.low);
-        }
-        if (finite && highest != lowest) {
-            result[index] = (highest - candles[index].close) / (highest - lowest) * -100.0;
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    const auto candleFinite = [&candles](qsizetype index) {
+        return std::isfinite(candles.high[index]) && std::isfinite(candles.low[index]) && std::isfinite(candles.close[index]);
+    };
+    qsizetype nonFinite = 0;
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        if (!candleFinite(index)) ++nonFinite;
+        if (index >= length && !candleFinite(index - length)) --nonFinite;
+        highest.expireBefore(index + 1 - length);
+        lowest.expireBefore(index + 1 - length);
+        highest.push(index, candles.high[index]);
+        lowest.push(index, candles.low[index]);
+        if (index >= length - 1 && nonFinite == 0 && highest.value() != lowest.value()) {
+            result[index] = (highest.value() - candles.close[index])
+                / (highest.value() - lowest.value()) * -100.0;
         }
     }
     return result;
 }
 
 std::pair<Series, Series> stochasticSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype length,
     qsizetype smoothK,
     qsizetype smoothD
 ) {
     length = std::max<qsizetype>(1, length);
     Series raw = filled(candles.size());
-    for (qsizetype index = length - 1; index < candles.size(); ++index) {
-        double high = -std::numeric_limits<double>::infinity();
-        double low = std::numeric_limits<double>::infinity();
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            high = std::max(high, candles[cursor].high);
-            low = std::min(low, candles[cursor].low);
-        }
-        if (high != low) {
-            raw[index] = 100.0 * (candles[index].close - low) / (high - low);
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        highest.expireBefore(index + 1 - length);
+        lowest.expireBefore(index + 1 - length);
+        highest.push(index, candles.high[index]);
+        lowest.push(index, candles.low[index]);
+        if (index >= length - 1 && highest.value() != lowest.value()) {
+            raw[index] = 100.0 * (candles.close[index] - lowest.value())
+                / (highest.value() - lowest.value());
         }
     }
-    Series k = rollingMeanMin(raw, smoothK);
-    Series d = rollingMeanMin(k, smoothD);
+    Series k = rollingMeanMin(column(raw), smoothK);
+    Series d = rollingMeanMin(column(k), smoothD);
     for (double &value : k) {
         if (!std::isfinite(value)) {
             value = 0.0;
@@ -598,12 +665,12 @@ std::pair<Series, Series> stochasticSeries(
 }
 
 std::tuple<Series, Series, Series> keltnerChannels(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype length,
     qsizetype atrLength,
     double multiplier
 ) {
-    Series middle = emaSeries(closes(candles), length);
+    Series middle = emaSeries(candles.close, length);
     const Series range = atrSeries(candles, atrLength);
     Series upper(candles.size());
     Series lower(candles.size());
@@ -614,37 +681,41 @@ std::tuple<Series, Series, Series> keltnerChannels(
     return {upper, middle, lower};
 }
 
-Series rollingMidpoint(const QVector<Candle> &candles, qsizetype length) {
+Series rollingMidpoint(CandleSpan candles, qsizetype length) {
     length = std::max<qsizetype>(1, length);
     Series result = filled(candles.size());
-    for (qsizetype index = length - 1; index < candles.size(); ++index) {
-        double high = -std::numeric_limits<double>::infinity();
-        double low = std::numeric_limits<double>::infinity();
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            high = std::max(high, candles[cursor].high);
-            low = std::min(low, candles[cursor].low);
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        highest.expireBefore(index + 1 - length);
+        lowest.expireBefore(index + 1 - length);
+        highest.push(index, candles.high[index]);
+        lowest.push(index, candles.low[index]);
+        if (index >= length - 1) {
+            result[index] = (highest.value() + lowest.value()) / 2.0;
         }
-        result[index] = (high + low) / 2.0;
     }
     return result;
 }
 
 std::tuple<Series, Series, Series> donchianChannels(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype length
 ) {
     length = std::max<qsizetype>(1, length);
     Series high = filled(candles.size());
     Series low = filled(candles.size());
-    for (qsizetype index = length - 1; index < candles.size(); ++index) {
-        double highest = -std::numeric_limits<double>::infinity();
-        double lowest = std::numeric_limits<double>::infinity();
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            highest = std::max(highest, candles[cursor].high);
-            lowest = std::min(lowest, candles[cursor].low);
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        highest.expireBefore(index + 1 - length);
+        lowest.expireBefore(index + 1 - length);
+        highest.push(index, candles.high[index]);
+        lowest.push(index, candles.low[index]);
+        if (index >= length - 1) {
+            high[index] = highest.value();
+            low[index] = lowest.value();
         }
-        high[index] = highest;
-        low[index] = lowest;
     }
     Series middle(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
@@ -653,42 +724,42 @@ std::tuple<Series, Series, Series> donchianChannels(
     return {high, low, middle};
 }
 
-Series parabolicSarSeries(const QVector<Candle> &candles, double af, double maxAf) {
+Series parabolicSarSeries(CandleSpan candles, double af, double maxAf) {
     if (candles.isEmpty()) {
         return {};
     }
-    Series result = closes(candles);
+    Series result = toSeries(candles.close);
     bool bullish = true;
     double acceleration = af;
-    double extremePoint = candles.first().high;
-    result[0] = candles.first().low;
+    double extremePoint = candles.high.front();
+    result[0] = candles.low.front();
     for (qsizetype index = 1; index < candles.size(); ++index) {
         result[index] = result[index - 1]
             + acceleration * (extremePoint - result[index - 1]);
         if (bullish) {
-            if (candles[index].low < result[index]) {
+            if (candles.low[index] < result[index]) {
                 bullish = false;
                 result[index] = extremePoint;
                 acceleration = af;
-                extremePoint = candles[index].low;
-            } else if (candles[index].high > extremePoint) {
-                extremePoint = candles[index].high;
+                extremePoint = candles.low[index];
+            } else if (candles.high[index] > extremePoint) {
+                extremePoint = candles.high[index];
                 acceleration = std::min(acceleration + af, maxAf);
             }
-        } else if (candles[index].high > result[index]) {
+        } else if (candles.high[index] > result[index]) {
             bullish = true;
             result[index] = extremePoint;
             acceleration = af;
-            extremePoint = candles[index].high;
-        } else if (candles[index].low < extremePoint) {
-            extremePoint = candles[index].low;
+            extremePoint = candles.high[index];
+        } else if (candles.low[index] < extremePoint) {
+            extremePoint = candles.low[index];
             acceleration = std::min(acceleration + af, maxAf);
         }
     }
     return result;
 }
 
-Series shiftRight(const Series &values, qsizetype offset) {
+Series shiftRight(Column values, qsizetype offset) {
     Series result = filled(values.size());
     for (qsizetype index = offset; index < values.size(); ++index) {
         result[index] = values[index - offset];
@@ -696,7 +767,7 @@ Series shiftRight(const Series &values, qsizetype offset) {
     return result;
 }
 
-Series shiftLeft(const Series &values, qsizetype offset) {
+Series shiftLeft(Column values, qsizetype offset) {
     Series result = filled(values.size());
     for (qsizetype index = 0; index + offset < values.size(); ++index) {
         result[index] = values[index + offset];
@@ -705,7 +776,7 @@ Series shiftLeft(const Series &values, qsizetype offset) {
 }
 
 std::tuple<Series, Series, Series, Series, Series> ichimokuCloud(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype conversionLength,
     qsizetype baseLength,
     qsizetype spanBLength,
@@ -717,14 +788,14 @@ std::tuple<Series, Series, Series, Series, Series> ichimokuCloud(
     for (qsizetype index = 0; index < candles.size(); ++index) {
         unshiftedSpanA[index] = (tenkan[index] + kijun[index]) / 2.0;
     }
-    Series spanA = shiftRight(unshiftedSpanA, displacement);
-    Series spanB = shiftRight(rollingMidpoint(candles, spanBLength), displacement);
-    Series chikou = shiftLeft(closes(candles), displacement);
+    Series spanA = shiftRight(column(unshiftedSpanA), displacement);
+    Series spanB = shiftRight(column(rollingMidpoint(candles, spanBLength)), displacement);
+    Series chikou = shiftLeft(candles.close, displacement);
     return {tenkan, kijun, spanA, spanB, chikou};
 }
 
 std::tuple<Series, Series, Series> kstSeries(
-    const Series &values,
+    Column values,
     qsizetype roc1,
     qsizetype roc2,
     qsizetype roc3,
@@ -735,16 +806,16 @@ std::tuple<Series, Series, Series> kstSeries(
     qsizetype sma4,
     qsizetype signalLength
 ) {
-    const Series first = rollingMeanMin(rocSeries(values, roc1), sma1);
-    const Series second = rollingMeanMin(rocSeries(values, roc2), sma2);
-    const Series third = rollingMeanMin(rocSeries(values, roc3), sma3);
-    const Series fourth = rollingMeanMin(rocSeries(values, roc4), sma4);
+    const Series first = rollingMeanMin(column(rocSeries(values, roc1)), sma1);
+    const Series second = rollingMeanMin(column(rocSeries(values, roc2)), sma2);
+    const Series third = rollingMeanMin(column(rocSeries(values, roc3)), sma3);
+    const Series fourth = rollingMeanMin(column(rocSeries(values, roc4)), sma4);
     Series line(values.size());
     for (qsizetype index = 0; index < values.size(); ++index) {
         line[index] = first[index] + 2.0 * second[index]
             + 3.0 * third[index] + 4.0 * fourth[index];
     }
-    Series signal = rollingMeanMin(line, signalLength);
+    Series signal = rollingMeanMin(column(line), signalLength);
     Series histogram(values.size());
     for (qsizetype index = 0; index < values.size(); ++index) {
         histogram[index] = line[index] - signal[index];
@@ -752,44 +823,35 @@ std::tuple<Series, Series, Series> kstSeries(
     return {line, signal, histogram};
 }
 
+// Aroon picks the latest extreme in the window (a ">=" scan). That scan starts
+// from the window's first bar, so a NaN there is never displaced.
+template <Extremum Kind>
+Series aroonScore(Column values, qsizetype length) {
+    Series result(values.size());
+    MonotonicWindow<Kind, TieBreak::Latest> extreme(length);
+    for (qsizetype index = 0; index < values.size(); ++index) {
+        const qsizetype start = index + 1 - std::min(length, index + 1);
+        const qsizetype windowSize = index + 1 - start;
+        extreme.expireBefore(start);
+        extreme.push(index, values[index]);
+        if (windowSize <= 1) {
+            result[index] = 100.0;
+            continue;
+        }
+        const qsizetype chosen = std::isnan(values[start]) ? start : extreme.index();
+        result[index] = 100.0 * static_cast<double>(chosen - start)
+            / static_cast<double>(windowSize - 1);
+    }
+    return result;
+}
+
 std::tuple<Series, Series, Series> aroonSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype length
 ) {
     length = std::max<qsizetype>(1, length);
-    const auto score = [length](const Series &values, bool findHigh) {
-        Series result;
-        result.reserve(values.size());
-        for (qsizetype index = 0; index < values.size(); ++index) {
-            const qsizetype start = index + 1 - std::min(length, index + 1);
-            const qsizetype windowSize = index + 1 - start;
-            if (windowSize <= 1) {
-                result.push_back(100.0);
-                continue;
-            }
-            qsizetype chosen = start;
-            for (qsizetype cursor = start; cursor <= index; ++cursor) {
-                if ((findHigh && values[cursor] >= values[chosen])
-                    || (!findHigh && values[cursor] <= values[chosen])) {
-                    chosen = cursor;
-                }
-            }
-            result.push_back(
-                100.0 * static_cast<double>(chosen - start)
-                / static_cast<double>(windowSize - 1));
-        }
-        return result;
-    };
-    Series highs;
-    Series lows;
-    highs.reserve(candles.size());
-    lows.reserve(candles.size());
-    for (const Candle &candle : candles) {
-        highs.push_back(candle.high);
-        lows.push_back(candle.low);
-    }
-    Series up = score(highs, true);
-    Series down = score(lows, false);
+    Series up = aroonScore<Extremum::Maximum>(candles.high, length);
+    Series down = aroonScore<Extremum::Minimum>(candles.low, length);
     Series oscillator(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
         oscillator[index] = up[index] - down[index];
@@ -797,20 +859,27 @@ std::tuple<Series, Series, Series> aroonSeries(
     return {up, down, oscillator};
 }
 
-Series choppinessIndexSeries(const QVector<Candle> &candles, qsizetype length) {
+Series choppinessIndexSeries(CandleSpan candles, qsizetype length) {
     length = std::max<qsizetype>(2, length);
     const Series trueRange = trueRangeSeries(candles);
     Series result(candles.size());
-    for (qsizetype index = length - 1; index < candles.size(); ++index) {
-        double high = -std::numeric_limits<double>::infinity();
-        double low = std::numeric_limits<double>::infinity();
-        double rangeSum = 0.0;
-        for (qsizetype cursor = index + 1 - length; cursor <= index; ++cursor) {
-            high = std::max(high, candles[cursor].high);
-            low = std::min(low, candles[cursor].low);
-            rangeSum += trueRange[cursor];
-        }
-        const double priceRange = high - low;
+    RollingMaximum highest(length);
+    RollingMinimum lowest(length);
+    RollingSum ranges;
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        highest.expireBefore(index + 1 - length);
+        lowest.expireBefore(index + 1 - length);
+        highest.push(index, candles.high[index]);
+        lowest.push(index, candles.low[index]);
+        ranges.push(trueRange[index]);
+        if (index >= length) {
+            ranges.pop(trueRange[index - length]);
+        }
+        if (index < length - 1) {
+            continue;
+        }
+        const double rangeSum = ranges.ieeeSum();
+        const double priceRange = highest.value() - lowest.value();
         if (priceRange > 0.0 && rangeSum > 0.0) {
             result[index] = 100.0 * std::log10(rangeSum / priceRange)
                 / std::log10(static_cast<double>(length));
@@ -820,7 +889,7 @@ Series choppinessIndexSeries(const QVector<Candle> &candles, qsizetype length) {
 }
 
 Series ultimateOscillatorSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype shortLength,
     qsizetype mediumLength,
     qsizetype longLength
@@ -830,16 +899,15 @@ Series ultimateOscillatorSeries(
     buyingPressure.reserve(candles.size());
     trueRange.reserve(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
-        const Candle &candle = candles[index];
-        const double previousClose = index == 0 ? candle.close : candles[index - 1].close;
-        const double trueLow = std::min(candle.low, previousClose);
-        const double trueHigh = std::max(candle.high, previousClose);
-        buyingPressure.push_back(candle.close - trueLow);
+        const double previousClose = index == 0 ? candles.close[index] : candles.close[index - 1];
+        const double trueLow = std::min(candles.low[index], previousClose);
+        const double trueHigh = std::max(candles.high[index], previousClose);
+        buyingPressure.push_back(candles.close[index] - trueLow);
         trueRange.push_back(trueHigh - trueLow);
     }
     const auto ratio = [&buyingPressure, &trueRange](qsizetype length) {
-        const Series pressure = rollingSumMin(buyingPressure, length);
-        const Series range = rollingSumMin(trueRange, length);
+        const Series pressure = rollingSumMin(column(buyingPressure), length);
+        const Series range = rollingSumMin(column(trueRange), length);
         Series result(pressure.size());
         for (qsizetype index = 0; index < result.size(); ++index) {
             result[index] = range[index] != 0.0 ? pressure[index] / range[index] : 0.0;
@@ -858,21 +926,21 @@ Series ultimateOscillatorSeries(
 }
 
 std::tuple<Series, Series, Series> dmiSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype length
 ) {
     length = std::max<qsizetype>(1, length);
     Series plusDm(candles.size());
     Series minusDm(candles.size());
     for (qsizetype index = 1; index < candles.size(); ++index) {
-        const double upMove = candles[index].high - candles[index - 1].high;
-        const double downMove = candles[index - 1].low - candles[index].low;
+        const double upMove = candles.high[index] - candles.high[index - 1];
+        const double downMove = candles.low[index - 1] - candles.low[index];
         plusDm[index] = upMove > downMove && upMove > 0.0 ? upMove : 0.0;
         minusDm[index] = downMove > upMove && downMove > 0.0 ? downMove : 0.0;
     }
     const Series atr = atrSeries(candles, length);
-    const Series plusSmoothed = ewmAlphaSeries(plusDm, 1.0 / static_cast<double>(length));
-    const Series minusSmoothed = ewmAlphaSeries(minusDm, 1.0 / static_cast<double>(length));
+    const Series plusSmoothed = ewmAlphaSeries(column(plusDm), 1.0 / static_cast<double>(length));
+    const Series minusSmoothed = ewmAlphaSeries(column(minusDm), 1.0 / static_cast<double>(length));
     Series plus(candles.size());
     Series minus(candles.size());
     Series dx(candles.size());
@@ -884,11 +952,11 @@ std::tuple<Series, Series, Series> dmiSeries(
             ? std::abs(plus[index] - minus[index]) / sum * 100.0
             : 0.0;
     }
-    return {plus, minus, ewmAlphaSeries(dx, 1.0 / static_cast<double>(length))};
+    return {plus, minus, ewmAlphaSeries(column(dx), 1.0 / static_cast<double>(length))};
 }
 
 Series supertrendSeries(
-    const QVector<Candle> &candles,
+    CandleSpan candles,
     qsizetype atrPeriod,
     double multiplier
 ) {
@@ -899,37 +967,37 @@ Series supertrendSeries(
     Series basicUpper(candles.size());
     Series basicLower(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
-        const double middle = (candles[index].high + candles[index].low) / 2.0;
+        const double middle = (candles.high[index] + candles.low[index]) / 2.0;
         basicUpper[index] = middle + multiplier * atr[index];
         basicLower[index] = middle - multiplier * atr[index];
     }
     Series finalUpper = basicUpper;
     Series finalLower = basicLower;
     for (qsizetype index = 1; index < candles.size(); ++index) {
-        finalUpper[index] = candles[index - 1].close > finalUpper[index - 1]
+        finalUpper[index] = candles.close[index - 1] > finalUpper[index - 1]
             ? basicUpper[index]
             : std::min(basicUpper[index], finalUpper[index - 1]);
-        finalLower[index] = candles[index - 1].close < finalLower[index - 1]
+        finalLower[index] = candles.close[index - 1] < finalLower[index - 1]
             ? basicLower[index]
             : std::max(basicLower[index], finalLower[index - 1]);
     }
     Series line;
     line.reserve(candles.size());
-    line.push_back((candles.first().high + candles.first().low) / 2.0);
+    line.push_back((candles.high.front() + candles.low.front()) / 2.0);
     for (qsizetype index = 1; index < candles.size(); ++index) {
         if (line[index - 1] == finalUpper[index - 1]) {
-            line.push_back(candles[index].close <= finalUpper[index]
+            line.push_back(candles.close[index] <= finalUpper[index]
                 ? finalUpper[index]
                 : finalLower[index]);
         } else {
-            line.push_back(candles[index].close >= finalLower[index]
+            line.push_back(candles.close[index] >= finalLower[index]
                 ? finalLower[index]
                 : finalUpper[index]);
         }
     }
     Series result(candles.size());
     for (qsizetype index = 0; index < candles.size(); ++index) {
-        result[index] = candles[index].close - line[index];
+        result[index] = candles.close[index] - line[index];
     }
     return result;
 }
@@ -938,6 +1006,43 @@ Series supertrendSeries(
 
 namespace NativeIndicatorRuntime {
 
+CandleColumns CandleColumns::fromCandles(const QVector<Candle> &candles) {
+    CandleColumns columns;
+    columns.reserve(candles.size());
+    for (const Candle &candle : candles) {
+        columns.append(0, candle);
+    }
+    return columns;
+}
+
+void CandleColumns::reserve(qsizetype size) {
+    const auto capacity = static_cast<std::size_t>(std::max<qsizetype>(0, size));
+    openTime_.reserve(capacity);
+    open_.reserve(capacity);
+    high_.reserve(capacity);
+    low_.reserve(capacity);
+    close_.reserve(capacity);
+    volume_.reserve(capacity);
+}
+
+void CandleColumns::clear() {
+    openTime_.clear();
+    open_.clear();
+    high_.clear();
+    low_.clear();
+    close_.clear();
+    volume_.clear();
+}
+
+void CandleColumns::append(qint64 openTimeMs, const Candle &candle) {
+    openTime_.push_back(openTimeMs);
+    open_.push_back(candle.open);
+    high_.push_back(candle.high);
+    low_.push_back(candle.low);
+    close_.push_back(candle.close);
+    volume_.push_back(candle.volume);
+}
+
 QStringList computedIndicatorKeys() {
     return {
         QStringLiteral("ma"),
@@ -987,7 +1092,7 @@ QStringList unsupportedEnabledIndicatorKeys(const ConfigMap &configs) {
     return unsupported;
 }
 
-SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMap &configs) {
+SeriesMap computeConfiguredSeries(CandleSpan candles, const ConfigMap &configs) {
     SeriesMap output;
     for (auto iterator = configs.cbegin(); iterator != configs.cend(); ++iterator) {
         const QString &key = iterator.key();
@@ -1007,7 +1112,7 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
                 configDouble(config, QStringLiteral("af"), 0.02),
                 configDouble(config, QStringLiteral("max_af"), 0.2)));
         } else if (key == QStringLiteral("ma")) {
-            const Series values = closes(candles);
+            const Column values = candles.close;
             const qsizetype length = configLength(config, QStringLiteral("length"), 20);
             output.insert(QStringLiteral("ma"), configString(config, QStringLiteral("type"))
                     == QStringLiteral("EMA")
@@ -1015,10 +1120,10 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
                 : rollingMeanExact(values, length));
         } else if (key == QStringLiteral("ema")) {
             output.insert(QStringLiteral("ema"), emaSeries(
-                closes(candles), configLength(config, QStringLiteral("length"), 20)));
+                candles.close, configLength(config, QStringLiteral("length"), 20)));
         } else if (key == QStringLiteral("bb")) {
             auto [upper, middle, lower] = bollingerBands(
-                closes(candles),
+                candles.close,
                 configLength(config, QStringLiteral("length"), 20),
                 configDouble(config, QStringLiteral("std"), 2.0));
             output.insert(QStringLiteral("bb_upper"), upper);
@@ -1026,7 +1131,7 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
             output.insert(QStringLiteral("bb_lower"), lower);
         } else if (key == QStringLiteral("bbw")) {
             output.insert(QStringLiteral("bbw"), bollingerBandWidth(
-                closes(candles),
+                candles.close,
                 configLength(config, QStringLiteral("length"), 20),
                 configDouble(config, QStringLiteral("std"), 2.0)));
         } else if (key == QStringLiteral("keltner")) {
@@ -1071,7 +1176,7 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
             output.insert(QStringLiteral("willr"), williamsRSeries(
                 candles, configLength(config, QStringLiteral("length"), 14)));
         } else if (key == QStringLiteral("volume")) {
-            output.insert(QStringLiteral("volume"), volumes(candles));
+            output.insert(QStringLiteral("volume"), toSeries(candles.volume));
         } else if (key == QStringLiteral("obv")) {
             output.insert(QStringLiteral("obv"), obvSeries(candles));
         } else if (key == QStringLiteral("rvol")) {
@@ -1087,13 +1192,13 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
                 configDouble(config, QStringLiteral("constant"), 0.015)));
         } else if (key == QStringLiteral("roc")) {
             output.insert(QStringLiteral("roc"), rocSeries(
-                closes(candles), configLength(config, QStringLiteral("length"), 12)));
+                candles.close, configLength(config, QStringLiteral("length"), 12)));
         } else if (key == QStringLiteral("trix")) {
             output.insert(QStringLiteral("trix"), trixSeries(
-                closes(candles), configLength(config, QStringLiteral("length"), 15)));
+                candles.close, configLength(config, QStringLiteral("length"), 15)));
         } else if (key == QStringLiteral("ppo")) {
             auto [line, signal, histogram] = ppoSeries(
-                closes(candles),
+                candles.close,
                 configLength(config, QStringLiteral("fast"), 12),
                 configLength(config, QStringLiteral("slow"), 26),
                 configLength(config, QStringLiteral("signal"), 9));
@@ -1107,7 +1212,7 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
                 configLength(config, QStringLiteral("slow"), 34)));
         } else if (key == QStringLiteral("kst")) {
             auto [line, signal, histogram] = kstSeries(
-                closes(candles),
+                candles.close,
                 configLength(config, QStringLiteral("roc1"), 10),
                 configLength(config, QStringLiteral("roc2"), 15),
                 configLength(config, QStringLiteral("roc3"), 20),
@@ -1149,7 +1254,7 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
                 configLength(config, QStringLiteral("long"), 28)));
         } else if (key == QStringLiteral("macd")) {
             auto [line, signal, histogram] = macdSeries(
-                closes(candles),
+                candles.close,
                 configLength(config, QStringLiteral("fast"), 12),
                 configLength(config, QStringLiteral("slow"), 26),
                 configLength(config, QStringLiteral("signal"), 9));
@@ -1193,3 +1298,1353 @@ SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMa
 }
 
 } // namespace NativeIndicatorRuntime
+
+namespace NativeIndicatorRuntime {
+
+// One configured indicator of an IncrementalIndicatorSet.
+class IncrementalIndicator {
+public:
+    virtual ~IncrementalIndicator() = default;
+    virtual std::unique_ptr<IncrementalIndicator> clone() const = 0;
+
+    // Writes the outputs of bar `index` (the number of bars committed so
+    // far) and, with commit set, advances the state past that bar. Without
+    // commit the state is left exactly as it was.
+    virtual void step(qsizetype index, const Candle &candle, double *out, bool commit) = 0;
+
+    // Bars ahead of its own bar that an output's value is taken from: what
+    // step() writes for it belongs lookAhead(output) bars back.
+    virtual qsizetype lookAhead(qsizetype) const { return 0; }
+};
+
+} // namespace NativeIndicatorRuntime
+
+namespace {
+
+using NativeIndicatorRuntime::Candle;
+using NativeIndicatorRuntime::IncrementalIndicator;
+using NativeRollingWindow::RecentValues;
+
+// Each kernel below is the loop body of the batch kernel of the same
+// indicator, fed one bar at a time; the shared arithmetic is kept in the
+// same order so committed values match the batch series bit for bit.
+
+template <typename Derived>
+class IncrementalKernel : public IncrementalIndicator {
+public:
+    std::unique_ptr<IncrementalIndicator> clone() const override {
+        return std::make_unique<Derived>(static_cast<const Derived &>(*this));
+    }
+};
+
+// emaSeries: a non-finite value restarts the average.
+class EmaState {
+public:
+    explicit EmaState(qsizetype length = 1)
+        : alpha_(2.0 / (static_cast<double>(std::max<qsizetype>(1, length)) + 1.0)) {}
+
+    double step(double value, bool commit) {
+        double next = kNaN;
+        if (std::isfinite(value)) {
+            next = std::isfinite(previous_)
+                ? alpha_ * value + (1.0 - alpha_) * previous_
+                : value;
+        }
+        if (commit) previous_ = next;
+        return next;
+    }
+
+private:
+    double alpha_;
+    double previous_ = kNaN;
+};
+
+// ewmAlphaSeries, also the Wilder smoothing of atrSeries.
+class EwmState {
+public:
+    explicit EwmState(double alpha = 1.0) : alpha_(alpha) {}
+
+    double step(double value, bool commit) {
+        const double next = std::isfinite(previous_)
+            ? alpha_ * value + (1.0 - alpha_) * previous_
+            : value;
+        if (commit) previous_ = next;
+        return next;
+    }
+
+private:
+    double alpha_;
+    double previous_ = kNaN;
+};
+
+// RollingSum over the last `length` values of one series, keeping the values
+// it will have to pop.
+class WindowSum {
+public:
+    explicit WindowSum(qsizetype length = 1)
+        : length_(std::max<qsizetype>(1, length)), values_(length_) {}
+
+    RollingSum step(qsizetype index, double value, bool commit) {
+        RollingSum window = window_;
+        window.push(value);
+        if (index >= length_) {
+            window.pop(values_.back(length_ - 1));
+        }
+        if (commit) {
+            window_ = window;
+            values_.push(value);
+        }
+        return window;
+    }
+
+    qsizetype length() const { return length_; }
+    // Committed value `offset` bars before the bar being stepped, minus one.
+    double back(qsizetype offset) const { return values_.back(offset); }
+
+private:
+    qsizetype length_;
+    RollingSum window_;
+    RecentValues values_;
+};
+
+double meanMin(const RollingSum &window) {
+    return window.finiteCount() > 0
+        ? window.finiteSum() / static_cast<double>(window.finiteCount())
+        : kNaN;
+}
+
+double sumMin(const RollingSum &window) {
+    return window.finiteCount() > 0 ? window.finiteSum() : kNaN;
+}
+
+double meanExact(const RollingSum &window, qsizetype index, qsizetype length) {
+    return index >= length - 1 && window.allFinite()
+        ? window.finiteSum() / static_cast<double>(length)
+        : kNaN;
+}
+
+template <Extremum Kind, TieBreak Tie = TieBreak::Earliest>
+class WindowExtreme {
+public:
+    using Peek = typename MonotonicWindow<Kind, Tie>::Peek;
+
+    explicit WindowExtreme(qsizetype length = 1) : window_(length) {}
+
+    // firstIndex is what the batch kernel passes to expireBefore().
+    Peek step(qsizetype firstIndex, qsizetype index, double value, bool commit) {
+        const Peek peek = window_.peek(firstIndex, index, value);
+        if (commit) {
+            window_.expireBefore(firstIndex);
+            window_.push(index, value);
+        }
+        return peek;
+    }
+
+private:
+    MonotonicWindow<Kind, Tie> window_;
+};
+
+using WindowMaximum = WindowExtreme<Extremum::Maximum>;
+using WindowMinimum = WindowExtreme<Extremum::Minimum>;
+
+double trueRange(qsizetype index, const Candle &candle, double previousClose) {
+    double range = std::abs(candle.high - candle.low);
+    if (index > 0) {
+        range = std::max(range, std::abs(candle.high - previousClose));
+        range = std::max(range, std::abs(candle.low - previousClose));
+    }
+    return range;
+}
+
+class AtrState {
+public:
+    explicit AtrState(qsizetype length = 1)
+        : smoothing_(1.0 / static_cast<double>(std::max<qsizetype>(1, length))) {}
+
+    double step(qsizetype index, const Candle &candle, bool commit) {
+        const double value = smoothing_.step(trueRange(index, candle, previousClose_), commit);
+        if (commit) previousClose_ = candle.close;
+        return value;
+    }
+
+private:
+    EwmState smoothing_;
+    double previousClose_ = kNaN;
+};
+
+class RsiState {
+public:
+    explicit RsiState(qsizetype length = 1)
+        : alpha_(1.0 / static_cast<double>(std::max<qsizetype>(1, length))) {}
+
+    double step(qsizetype index, double close, bool commit) {
+        double averageGain = averageGain_;
+        double averageLoss = averageLoss_;
+        double result = kNaN;
+        const double delta = close - previousClose_;
+        if (index >= 1 && std::isfinite(delta)) {
+            const double gain = std::max(delta, 0.0);
+            const double loss = std::max(-delta, 0.0);
+            if (index == 1) {
+                averageGain = gain;
+                averageLoss = loss;
+            } else {
+                averageGain = alpha_ * gain + (1.0 - alpha_) * averageGain;
+                averageLoss = alpha_ * loss + (1.0 - alpha_) * averageLoss;
+            }
+            if (averageLoss == 0.0) {
+                result = averageGain == 0.0 ? kNaN : 100.0;
+            } else {
+                result = 100.0 - 100.0 / (1.0 + averageGain / averageLoss);
+            }
+        }
+        if (commit) {
+            averageGain_ = averageGain;
+            averageLoss_ = averageLoss;
+            previousClose_ = close;
+        }
+        return result;
+    }
+
+private:
+    double alpha_;
+    double averageGain_ = 0.0;
+    double averageLoss_ = 0.0;
+    double previousClose_ = kNaN;
+};
+
+// rollingMidpoint: mid of the highest high and lowest low once the window is full.
+class MidpointState {
+public:
+    explicit MidpointState(qsizetype length = 1)
+        : length_(std::max<qsizetype>(1, length)), highest_(length_), lowest_(length_) {}
+
+    double step(qsizetype index, const Candle &candle, bool commit) {
+        const auto high = highest_.step(index + 1 - length_, index, candle.high, commit);
+        const auto low = lowest_.step(index + 1 - length_, index, candle.low, commit);
+        return index >= length_ - 1 ? (high.value + low.value) / 2.0 : kNaN;
+    }
+
+private:
+    qsizetype length_;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+};
+
+class MovingAverageKernel final : public IncrementalKernel<MovingAverageKernel> {
+public:
+    MovingAverageKernel(qsizetype length, bool exponential)
+        : length_(std::max<qsizetype>(1, length)), exponential_(exponential), ema_(length), window_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        out[0] = exponential_
+            ? ema_.step(candle.close, commit)
+            : meanExact(window_.step(index, candle.close, commit), index, length_);
+    }
+
+private:
+    qsizetype length_;
+    bool exponential_;
+    EmaState ema_;
+    WindowSum window_;
+};
+
+class DonchianKernel final : public IncrementalKernel<DonchianKernel> {
+public:
+    explicit DonchianKernel(qsizetype length)
+        : length_(std::max<qsizetype>(1, length)), highest_(length_), lowest_(length_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const auto high = highest_.step(index + 1 - length_, index, candle.high, commit);
+        const auto low = lowest_.step(index + 1 - length_, index, candle.low, commit);
+        out[0] = index >= length_ - 1 ? high.value : kNaN;
+        out[1] = index >= length_ - 1 ? low.value : kNaN;
+        out[2] = (out[0] + out[1]) / 2.0;
+    }
+
+private:
+    qsizetype length_;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+};
+
+class ParabolicSarKernel final : public IncrementalKernel<ParabolicSarKernel> {
+public:
+    ParabolicSarKernel(double af, double maxAf) : af_(af), maxAf_(maxAf) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        State next = state_;
+        if (index == 0) {
+            next = {candle.low, true, af_, candle.high};
+        } else {
+            next.sar = state_.sar + state_.acceleration * (state_.extremePoint - state_.sar);
+            if (next.bullish) {
+                if (candle.low < next.sar) {
+                    next.bullish = false;
+                    next.sar = next.extremePoint;
+                    next.acceleration = af_;
+                    next.extremePoint = candle.low;
+                } else if (candle.high > next.extremePoint) {
+                    next.extremePoint = candle.high;
+                    next.acceleration = std::min(next.acceleration + af_, maxAf_);
+                }
+            } else if (candle.high > next.sar) {
+                next.bullish = true;
+                next.sar = next.extremePoint;
+                next.acceleration = af_;
+                next.extremePoint = candle.high;
+            } else if (candle.low < next.extremePoint) {
+                next.extremePoint = candle.low;
+                next.acceleration = std::min(next.acceleration + af_, maxAf_);
+            }
+        }
+        out[0] = next.sar;
+        if (commit) state_ = next;
+    }
+
+private:
+    struct State {
+        double sar = 0.0;
+        bool bullish = true;
+        double acceleration = 0.0;
+        double extremePoint = 0.0;
+    };
+
+    double af_;
+    double maxAf_;
+    State state_;
+};
+
+class EmaKernel final : public IncrementalKernel<EmaKernel> {
+public:
+    explicit EmaKernel(qsizetype length) : ema_(length) {}
+
+    void step(qsizetype, const Candle &candle, double *out, bool commit) override {
+        out[0] = ema_.step(candle.close, commit);
+    }
+
+private:
+    EmaState ema_;
+};
+
+// Serves both "bb" (upper, mid, lower) and "bbw" (width).
+class BollingerKernel final : public IncrementalKernel<BollingerKernel> {
+public:
+    BollingerKernel(qsizetype length, double multiplier, bool widthOnly)
+        : length_(std::max<qsizetype>(1, length)),
+          multiplier_(multiplier),
+          widthOnly_(widthOnly),
+          window_(length_),
+          highest_(length_),
+          lowest_(length_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double close = candle.close;
+        const double middle = meanExact(window_.step(index, close, false), index, length_);
+        const auto highest = highest_.step(index + 1 - length_, index, close, commit);
+        const auto lowest = lowest_.step(index + 1 - length_, index, close, commit);
+        RollingMoments moments = moments_;
+        if (index >= length_ && index % length_ == 0) {
+            // Same once-per-window rebase as the batch kernel.
+            moments.reset();
+            for (qsizetype offset = length_ - 2; offset >= 0; --offset) {
+                if (std::isfinite(window_.back(offset))) moments.push(window_.back(offset));
+            }
+            if (std::isfinite(close)) moments.push(close);
+        } else {
+            if (std::isfinite(close)) {
+                moments.push(close);
+            }
+            if (index >= length_ && std::isfinite(window_.back(length_ - 1))) {
+                moments.pop(window_.back(length_ - 1));
+            }
+        }
+        double deviation = kNaN;
+        if (length_ >= 2 && index >= length_ - 1 && std::isfinite(middle)) {
+            deviation = highest.value == lowest.value ? 0.0 : std::sqrt(moments.sampleVariance());
+        }
+        const double upper = middle + multiplier_ * deviation;
+        const double lower = middle - multiplier_ * deviation;
+        if (widthOnly_) {
+            out[0] = std::isfinite(middle) && middle != 0.0
+                    && std::isfinite(upper) && std::isfinite(lower)
+                ? (upper - lower) / middle * 100.0
+                : 0.0;
+        } else {
+            out[0] = upper;
+            out[1] = middle;
+            out[2] = lower;
+        }
+        if (commit) {
+            window_.step(index, close, true);
+            moments_ = moments;
+        }
+    }
+
+private:
+    qsizetype length_;
+    double multiplier_;
+    bool widthOnly_;
+    WindowSum window_;
+    RollingMoments moments_;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+};
+
+class RsiKernel final : public IncrementalKernel<RsiKernel> {
+public:
+    explicit RsiKernel(qsizetype length) : rsi_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        out[0] = rsi_.step(index, candle.close, commit);
+    }
+
+private:
+    RsiState rsi_;
+};
+
+class StochRsiKernel final : public IncrementalKernel<StochRsiKernel> {
+public:
+    StochRsiKernel(qsizetype length, qsizetype smoothK, qsizetype smoothD)
+        : length_(std::max<qsizetype>(1, length)),
+          smoothK_(std::max<qsizetype>(1, smoothK)),
+          smoothD_(std::max<qsizetype>(1, smoothD)),
+          rsi_(length_),
+          rsiValues_(length_),
+          maximum_(length_),
+          minimum_(length_),
+          kWindow_(smoothK_),
+          dWindow_(smoothD_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double rsi = rsi_.step(index, candle.close, commit);
+        qsizetype nonFinite = nonFinite_;
+        if (!std::isfinite(rsi)) ++nonFinite;
+        if (index >= length_ && !std::isfinite(rsiValues_.back(length_ - 1))) --nonFinite;
+        const auto maximum = maximum_.step(index + 1 - length_, index, rsi, commit);
+        const auto minimum = minimum_.step(index + 1 - length_, index, rsi, commit);
+        double stochastic = kNaN;
+        if (index >= length_ - 1 && nonFinite == 0 && maximum.value != minimum.value) {
+            stochastic = 100.0 * (rsi - minimum.value) / (maximum.value - minimum.value);
+        }
+        const double k = meanExact(kWindow_.step(index, stochastic, commit), index, smoothK_);
+        const double d = meanExact(dWindow_.step(index, k, commit), index, smoothD_);
+        out[0] = k;
+        out[1] = k;
+        out[2] = d;
+        if (commit) {
+            nonFinite_ = nonFinite;
+            rsiValues_.push(rsi);
+        }
+    }
+
+private:
+    qsizetype length_;
+    qsizetype smoothK_;
+    qsizetype smoothD_;
+    RsiState rsi_;
+    RecentValues rsiValues_;
+    qsizetype nonFinite_ = 0;
+    WindowMaximum maximum_;
+    WindowMinimum minimum_;
+    WindowSum kWindow_;
+    WindowSum dWindow_;
+};
+
+class WilliamsRKernel final : public IncrementalKernel<WilliamsRKernel> {
+public:
+    explicit WilliamsRKernel(qsizetype length)
+        : length_(std::max<qsizetype>(1, length)), finite_(length_), highest_(length_), lowest_(length_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const bool candleFinite = std::isfinite(candle.high) && std::isfinite(candle.low)
+            && std::isfinite(candle.close);
+        qsizetype nonFinite = nonFinite_;
+        if (!candleFinite) ++nonFinite;
+        if (index >= length_ && finite_.back(length_ - 1) == 0.0) --nonFinite;
+        const auto highest = highest_.step(index + 1 - length_, index, candle.high, commit);
+        const auto lowest = lowest_.step(index + 1 - length_, index, candle.low, commit);
+        out[0] = index >= length_ - 1 && nonFinite == 0 && highest.value != lowest.value
+            ? (highest.value - candle.close) / (highest.value - lowest.value) * -100.0
+            : kNaN;
+        if (commit) {
+            nonFinite_ = nonFinite;
+            finite_.push(candleFinite ? 1.0 : 0.0);
+        }
+    }
+
+private:
+    qsizetype length_;
+    RecentValues finite_;
+    qsizetype nonFinite_ = 0;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+};
+
+class VolumeKernel final : public IncrementalKernel<VolumeKernel> {
+public:
+    void step(qsizetype, const Candle &candle, double *out, bool) override {
+        out[0] = candle.volume;
+    }
+};
+
+class ObvKernel final : public IncrementalKernel<ObvKernel> {
+public:
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        double cumulative = cumulative_;
+        if (index > 0) {
+            if (candle.close > previousClose_) {
+                cumulative += candle.volume;
+            } else if (candle.close < previousClose_) {
+                cumulative -= candle.volume;
+            }
+        }
+        out[0] = cumulative;
+        if (commit) {
+            cumulative_ = cumulative;
+            previousClose_ = candle.close;
+        }
+    }
+
+private:
+    double cumulative_ = 0.0;
+    double previousClose_ = kNaN;
+};
+
+class RelativeVolumeKernel final : public IncrementalKernel<RelativeVolumeKernel> {
+public:
+    explicit RelativeVolumeKernel(qsizetype length) : window_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double average = meanMin(window_.step(index, candle.volume, commit));
+        out[0] = std::isfinite(average) && average != 0.0 ? candle.volume / average : 0.0;
+    }
+
+private:
+    WindowSum window_;
+};
+
+class ChaikinMoneyFlowKernel final : public IncrementalKernel<ChaikinMoneyFlowKernel> {
+public:
+    explicit ChaikinMoneyFlowKernel(qsizetype length) : flow_(length), volume_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double range = candle.high - candle.low;
+        const double moneyFlow = range == 0.0
+            ? 0.0
+            : ((candle.close - candle.low) - (candle.high - candle.close)) / range * candle.volume;
+        const double flowSum = sumMin(flow_.step(index, moneyFlow, commit));
+        const double volumeSum = sumMin(volume_.step(index, candle.volume, commit));
+        out[0] = std::isfinite(flowSum) && std::isfinite(volumeSum) && volumeSum != 0.0
+            ? flowSum / volumeSum
+            : 0.0;
+    }
+
+private:
+    WindowSum flow_;
+    WindowSum volume_;
+};
+
+// The batch kernel ranks the whole series up front for its mean deviation;
+// live state cannot, so it rescans the window instead: O(length) per bar.
+class CciKernel final : public IncrementalKernel<CciKernel> {
+public:
+    CciKernel(qsizetype length, double constant)
+        : length_(std::max<qsizetype>(1, length)),
+          constant_(constant),
+          window_(length_),
+          highest_(length_),
+          lowest_(length_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double typical = (candle.high + candle.low + candle.close) / 3.0;
+        const RollingSum window = window_.step(index, typical, false);
+        const qsizetype start = index + 1 - std::min(length_, index + 1);
+        const auto highest = highest_.step(start, index, typical, commit);
+        const auto lowest = lowest_.step(start, index, typical, commit);
+        out[0] = 0.0;
+        if (window.allFinite() && highest.value != lowest.value) {
+            const qsizetype count = window.finiteCount();
+            const double total = window.finiteSum();
+            const double average = total / static_cast<double>(count);
+            qsizetype belowCount = typical <= average ? 1 : 0;
+            double belowSum = typical <= average ? typical : 0.0;
+            for (qsizetype offset = 0; offset < index - start; ++offset) {
+                const double value = window_.back(offset);
+                if (value <= average) {
+                    ++belowCount;
+                    belowSum += value;
+                }
+            }
+            const double below = average * static_cast<double>(belowCount) - belowSum;
+            const double above = (total - belowSum) - average * static_cast<double>(count - belowCount);
+            const double denominator = constant_
+                * (std::max(0.0, below + above) / static_cast<double>(count));
+            out[0] = std::isfinite(denominator) && denominator != 0.0
+                ? (typical - average) / denominator
+                : 0.0;
+        }
+        if (commit) window_.step(index, typical, true);
+    }
+
+private:
+    qsizetype length_;
+    double constant_;
+    WindowSum window_;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+};
+
+double rateOfChange(qsizetype index, double value, const RecentValues &history, qsizetype length) {
+    if (index < length) return 0.0;
+    const double previous = history.back(length - 1);
+    return previous == 0.0 ? 0.0 : (value - previous) / previous * 100.0;
+}
+
+class RocKernel final : public IncrementalKernel<RocKernel> {
+public:
+    explicit RocKernel(qsizetype length) : length_(std::max<qsizetype>(1, length)), closes_(length_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        out[0] = rateOfChange(index, candle.close, closes_, length_);
+        if (commit) closes_.push(candle.close);
+    }
+
+private:
+    qsizetype length_;
+    RecentValues closes_;
+};
+
+class TrixKernel final : public IncrementalKernel<TrixKernel> {
+public:
+    explicit TrixKernel(qsizetype length) : first_(length), second_(length), third_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double third = third_.step(second_.step(first_.step(candle.close, commit), commit), commit);
+        out[0] = 0.0;
+        if (index > 0) {
+            out[0] = previousThird_ == 0.0 ? 0.0 : (third / previousThird_ - 1.0) * 100.0;
+        }
+        if (commit) previousThird_ = third;
+    }
+
+private:
+    EmaState first_;
+    EmaState second_;
+    EmaState third_;
+    double previousThird_ = kNaN;
+};
+
+// Serves "macd" (line, signal) and "ppo" (line, signal, histogram).
+class OscillatorKernel final : public IncrementalKernel<OscillatorKernel> {
+public:
+    OscillatorKernel(qsizetype fast, qsizetype slow, qsizetype signal, bool percentage)
+        : fast_(fast), slow_(slow), signal_(signal), percentage_(percentage) {}
+
+    void step(qsizetype, const Candle &candle, double *out, bool commit) override {
+        const double fast = fast_.step(candle.close, commit);
+        const double slow = slow_.step(candle.close, commit);
+        double line = fast - slow;
+        if (percentage_) {
+            line = slow != 0.0 ? (fast - slow) / slow * 100.0 : 0.0;
+        }
+        const double signal = signal_.step(line, commit);
+        out[0] = line;
+        out[1] = signal;
+        if (percentage_) out[2] = line - signal;
+    }
+
+private:
+    EmaState fast_;
+    EmaState slow_;
+    EmaState signal_;
+    bool percentage_;
+};
+
+class AwesomeOscillatorKernel final : public IncrementalKernel<AwesomeOscillatorKernel> {
+public:
+    AwesomeOscillatorKernel(qsizetype fast, qsizetype slow) : fast_(fast), slow_(slow) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double median = (candle.high + candle.low) / 2.0;
+        const double fast = meanMin(fast_.step(index, median, commit));
+        const double slow = meanMin(slow_.step(index, median, commit));
+        out[0] = std::isfinite(fast) && std::isfinite(slow) ? fast - slow : 0.0;
+    }
+
+private:
+    WindowSum fast_;
+    WindowSum slow_;
+};
+
+// Serves "atr" and "natr".
+class AtrKernel final : public IncrementalKernel<AtrKernel> {
+public:
+    AtrKernel(qsizetype length, bool normalized) : atr_(length), normalized_(normalized) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double atr = atr_.step(index, candle, commit);
+        out[0] = atr;
+        if (normalized_) {
+            out[0] = std::isfinite(atr) && std::isfinite(candle.close) && candle.close != 0.0
+                ? atr / candle.close * 100.0
+                : 0.0;
+        }
+    }
+
+private:
+    AtrState atr_;
+    bool normalized_;
+};
+
+class VwapKernel final : public IncrementalKernel<VwapKernel> {
+public:
+    explicit VwapKernel(qsizetype length) : weighted_(length), volume_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double typical = (candle.high + candle.low + candle.close) / 3.0;
+        const double weightedSum = sumMin(weighted_.step(index, typical * candle.volume, commit));
+        const double volumeSum = sumMin(volume_.step(index, candle.volume, commit));
+        out[0] = std::isfinite(weightedSum) && std::isfinite(volumeSum) && volumeSum != 0.0
+            ? weightedSum / volumeSum
+            : kNaN;
+    }
+
+private:
+    WindowSum weighted_;
+    WindowSum volume_;
+};
+
+class MfiKernel final : public IncrementalKernel<MfiKernel> {
+public:
+    explicit MfiKernel(qsizetype length) : positive_(length), negative_(length) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double typical = (candle.high + candle.low + candle.close) / 3.0;
+        const double raw = typical * candle.volume;
+        double positive = 0.0;
+        double negative = 0.0;
+        if (index > 0) {
+            if (typical > previousTypical_) {
+                positive = raw;
+            } else if (typical < previousTypical_) {
+                negative = raw;
+            }
+        }
+        const double positiveSum = sumMin(positive_.step(index, positive, commit));
+        const double negativeSum = sumMin(negative_.step(index, negative, commit));
+        if (positiveSum == 0.0 && negativeSum == 0.0) {
+            out[0] = 50.0;
+        } else if (positiveSum == 0.0) {
+            out[0] = 0.0;
+        } else if (negativeSum == 0.0) {
+            out[0] = 100.0;
+        } else {
+            out[0] = 100.0 - 100.0 / (1.0 + positiveSum / negativeSum);
+        }
+        if (commit) previousTypical_ = typical;
+    }
+
+private:
+    WindowSum positive_;
+    WindowSum negative_;
+    double previousTypical_ = kNaN;
+};
+
+class KeltnerKernel final : public IncrementalKernel<KeltnerKernel> {
+public:
+    KeltnerKernel(qsizetype length, qsizetype atrLength, double multiplier)
+        : middle_(length), atr_(atrLength), multiplier_(multiplier) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double middle = middle_.step(candle.close, commit);
+        const double range = atr_.step(index, candle, commit);
+        out[0] = middle + range * multiplier_;
+        out[1] = middle;
+        out[2] = middle - range * multiplier_;
+    }
+
+private:
+    EmaState middle_;
+    AtrState atr_;
+    double multiplier_;
+};
+
+// Outputs tenkan, kijun, span A, span B, chikou, tenkan - kijun. The chikou
+// span is the close `displacement` bars ahead, so each bar's close is written
+// as the chikou value of the bar that far back.
+class IchimokuKernel final : public IncrementalKernel<IchimokuKernel> {
+public:
+    IchimokuKernel(qsizetype conversion, qsizetype base, qsizetype spanB, qsizetype displacement)
+        : displacement_(displacement),
+          tenkan_(conversion),
+          kijun_(base),
+          spanB_(spanB),
+          spanAHistory_(displacement),
+          spanBHistory_(displacement) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double tenkan = tenkan_.step(index, candle, commit);
+        const double kijun = kijun_.step(index, candle, commit);
+        const double spanB = spanB_.step(index, candle, commit);
+        const double spanA = (tenkan + kijun) / 2.0;
+        out[0] = tenkan;
+        out[1] = kijun;
+        out[2] = index >= displacement_ ? spanAHistory_.back(displacement_ - 1) : kNaN;
+        out[3] = index >= displacement_ ? spanBHistory_.back(displacement_ - 1) : kNaN;
+        out[4] = candle.close;
+        out[5] = tenkan - kijun;
+        if (commit) {
+            spanAHistory_.push(spanA);
+            spanBHistory_.push(spanB);
+        }
+    }
+
+    qsizetype lookAhead(qsizetype output) const override { return output == 4 ? displacement_ : 0; }
+
+private:
+    qsizetype displacement_;
+    MidpointState tenkan_;
+    MidpointState kijun_;
+    MidpointState spanB_;
+    RecentValues spanAHistory_;
+    RecentValues spanBHistory_;
+};
+
+class KstKernel final : public IncrementalKernel<KstKernel> {
+public:
+    KstKernel(const std::array<qsizetype, 4> &rocLengths,
+              const std::array<qsizetype, 4> &smaLengths,
+              qsizetype signalLength)
+        : closes_(*std::max_element(rocLengths.begin(), rocLengths.end())),
+          signal_(signalLength) {
+        for (std::size_t part = 0; part < rocLengths.size(); ++part) {
+            rocLengths_[part] = std::max<qsizetype>(1, rocLengths[part]);
+            averages_[part] = WindowSum(smaLengths[part]);
+        }
+    }
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        std::array<double, 4> parts{};
+        for (std::size_t part = 0; part < parts.size(); ++part) {
+            parts[part] = meanMin(averages_[part].step(
+                index, rateOfChange(index, candle.close, closes_, rocLengths_[part]), commit));
+        }
+        const double line = parts[0] + 2.0 * parts[1] + 3.0 * parts[2] + 4.0 * parts[3];
+        const double signal = meanMin(signal_.step(index, line, commit));
+        out[0] = line;
+        out[1] = signal;
+        out[2] = line - signal;
+        if (commit) closes_.push(candle.close);
+    }
+
+private:
+    std::array<qsizetype, 4> rocLengths_{};
+    std::array<WindowSum, 4> averages_;
+    RecentValues closes_;
+    WindowSum signal_;
+};
+
+template <Extremum Kind>
+class AroonScore {
+public:
+    explicit AroonScore(qsizetype length = 1) : length_(length), values_(length), extreme_(length) {}
+
+    double step(qsizetype index, double value, bool commit) {
+        const qsizetype start = index + 1 - std::min(length_, index + 1);
+        const qsizetype windowSize = index + 1 - start;
+        const auto extreme = extreme_.step(start, index, value, commit);
+        double score = 100.0;
+        if (windowSize > 1) {
+            const qsizetype chosen = std::isnan(values_.back(index - 1 - start)) ? start : extreme.index;
+            score = 100.0 * static_cast<double>(chosen - start)
+                / static_cast<double>(windowSize - 1);
+        }
+        if (commit) values_.push(value);
+        return score;
+    }
+
+private:
+    qsizetype length_;
+    RecentValues values_;
+    WindowExtreme<Kind, TieBreak::Latest> extreme_;
+};
+
+class AroonKernel final : public IncrementalKernel<AroonKernel> {
+public:
+    explicit AroonKernel(qsizetype length)
+        : up_(std::max<qsizetype>(1, length)), down_(std::max<qsizetype>(1, length)) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        out[0] = up_.step(index, candle.high, commit);
+        out[1] = down_.step(index, candle.low, commit);
+        out[2] = out[0] - out[1];
+    }
+
+private:
+    AroonScore<Extremum::Maximum> up_;
+    AroonScore<Extremum::Minimum> down_;
+};
+
+class ChoppinessKernel final : public IncrementalKernel<ChoppinessKernel> {
+public:
+    explicit ChoppinessKernel(qsizetype length)
+        : length_(std::max<qsizetype>(2, length)), highest_(length_), lowest_(length_), ranges_(length_) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const auto highest = highest_.step(index + 1 - length_, index, candle.high, commit);
+        const auto lowest = lowest_.step(index + 1 - length_, index, candle.low, commit);
+        const RollingSum ranges = ranges_.step(index, trueRange(index, candle, previousClose_), commit);
+        if (commit) previousClose_ = candle.close;
+        out[0] = 0.0;
+        if (index < length_ - 1) {
+            return;
+        }
+        const double rangeSum = ranges.ieeeSum();
+        const double priceRange = highest.value - lowest.value;
+        if (priceRange > 0.0 && rangeSum > 0.0) {
+            out[0] = 100.0 * std::log10(rangeSum / priceRange)
+                / std::log10(static_cast<double>(length_));
+        }
+    }
+
+private:
+    qsizetype length_;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+    WindowSum ranges_;
+    double previousClose_ = kNaN;
+};
+
+class UltimateOscillatorKernel final : public IncrementalKernel<UltimateOscillatorKernel> {
+public:
+    UltimateOscillatorKernel(qsizetype shortLength, qsizetype mediumLength, qsizetype longLength)
+        : pressure_{WindowSum(shortLength), WindowSum(mediumLength), WindowSum(longLength)},
+          range_{WindowSum(shortLength), WindowSum(mediumLength), WindowSum(longLength)} {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double previousClose = index == 0 ? candle.close : previousClose_;
+        const double trueLow = std::min(candle.low, previousClose);
+        const double trueHigh = std::max(candle.high, previousClose);
+        const double buyingPressure = candle.close - trueLow;
+        const double range = trueHigh - trueLow;
+        std::array<double, 3> ratios{};
+        for (std::size_t part = 0; part < ratios.size(); ++part) {
+            const double pressureSum = sumMin(pressure_[part].step(index, buyingPressure, commit));
+            const double rangeSum = sumMin(range_[part].step(index, range, commit));
+            ratios[part] = rangeSum != 0.0 ? pressureSum / rangeSum : 0.0;
+        }
+        out[0] = 100.0 * (4.0 * ratios[0] + 2.0 * ratios[1] + ratios[2]) / 7.0;
+        if (commit) previousClose_ = candle.close;
+    }
+
+private:
+    std::array<WindowSum, 3> pressure_;
+    std::array<WindowSum, 3> range_;
+    double previousClose_ = kNaN;
+};
+
+// Serves "adx" (adx) and "dmi" (plus, minus, plus - minus).
+class DmiKernel final : public IncrementalKernel<DmiKernel> {
+public:
+    DmiKernel(qsizetype length, bool adxOnly)
+        : atr_(std::max<qsizetype>(1, length)),
+          plus_(1.0 / static_cast<double>(std::max<qsizetype>(1, length))),
+          minus_(1.0 / static_cast<double>(std::max<qsizetype>(1, length))),
+          adx_(1.0 / static_cast<double>(std::max<qsizetype>(1, length))),
+          adxOnly_(adxOnly) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        double plusDm = 0.0;
+        double minusDm = 0.0;
+        if (index > 0) {
+            const double upMove = candle.high - previousHigh_;
+            const double downMove = previousLow_ - candle.low;
+            plusDm = upMove > downMove && upMove > 0.0 ? upMove : 0.0;
+            minusDm = downMove > upMove && downMove > 0.0 ? downMove : 0.0;
+        }
+        const double atr = atr_.step(index, candle, commit);
+        const double plusSmoothed = plus_.step(plusDm, commit);
+        const double minusSmoothed = minus_.step(minusDm, commit);
+        const double plus = atr != 0.0 ? 100.0 * plusSmoothed / atr : 0.0;
+        const double minus = atr != 0.0 ? 100.0 * minusSmoothed / atr : 0.0;
+        const double sum = plus + minus;
+        const double dx = sum != 0.0 ? std::abs(plus - minus) / sum * 100.0 : 0.0;
+        const double adx = adx_.step(dx, commit);
+        if (adxOnly_) {
+            out[0] = adx;
+        } else {
+            out[0] = plus;
+            out[1] = minus;
+            out[2] = plus - minus;
+        }
+        if (commit) {
+            previousHigh_ = candle.high;
+            previousLow_ = candle.low;
+        }
+    }
+
+private:
+    AtrState atr_;
+    EwmState plus_;
+    EwmState minus_;
+    EwmState adx_;
+    bool adxOnly_;
+    double previousHigh_ = kNaN;
+    double previousLow_ = kNaN;
+};
+
+class SupertrendKernel final : public IncrementalKernel<SupertrendKernel> {
+public:
+    SupertrendKernel(qsizetype atrPeriod, double multiplier) : atr_(atrPeriod), multiplier_(multiplier) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const double atr = atr_.step(index, candle, commit);
+        const double middle = (candle.high + candle.low) / 2.0;
+        const double basicUpper = middle + multiplier_ * atr;
+        const double basicLower = middle - multiplier_ * atr;
+        State next{basicUpper, basicLower, middle, candle.close};
+        if (index > 0) {
+            next.finalUpper = state_.close > state_.finalUpper
+                ? basicUpper
+                : std::min(basicUpper, state_.finalUpper);
+            next.finalLower = state_.close < state_.finalLower
+                ? basicLower
+                : std::max(basicLower, state_.finalLower);
+            if (state_.line == state_.finalUpper) {
+                next.line = candle.close <= next.finalUpper ? next.finalUpper : next.finalLower;
+            } else {
+                next.line = candle.close >= next.finalLower ? next.finalLower : next.finalUpper;
+            }
+        }
+        out[0] = candle.close - next.line;
+        if (commit) state_ = next;
+    }
+
+private:
+    struct State {
+        double finalUpper = 0.0;
+        double finalLower = 0.0;
+        double line = 0.0;
+        double close = 0.0;
+    };
+
+    AtrState atr_;
+    double multiplier_;
+    State state_;
+};
+
+class StochasticKernel final : public IncrementalKernel<StochasticKernel> {
+public:
+    StochasticKernel(qsizetype length, qsizetype smoothK, qsizetype smoothD)
+        : length_(std::max<qsizetype>(1, length)),
+          highest_(length_),
+          lowest_(length_),
+          kWindow_(smoothK),
+          dWindow_(smoothD) {}
+
+    void step(qsizetype index, const Candle &candle, double *out, bool commit) override {
+        const auto highest = highest_.step(index + 1 - length_, index, candle.high, commit);
+        const auto lowest = lowest_.step(index + 1 - length_, index, candle.low, commit);
+        double raw = kNaN;
+        if (index >= length_ - 1 && highest.value != lowest.value) {
+            raw = 100.0 * (candle.close - lowest.value) / (highest.value - lowest.value);
+        }
+        const double k = meanMin(kWindow_.step(index, raw, commit));
+        const double d = meanMin(dWindow_.step(index, k, commit));
+        out[0] = std::isfinite(k) ? k : 0.0;
+        out[1] = out[0];
+        out[2] = std::isfinite(d) ? d : 0.0;
+    }
+
+private:
+    qsizetype length_;
+    WindowMaximum highest_;
+    WindowMinimum lowest_;
+    WindowSum kWindow_;
+    WindowSum dWindow_;
+};
+
+} // namespace
+
+namespace NativeIndicatorRuntime {
+
+void IncrementalIndicatorSet::OutputTail::push(double value) {
+    if (count >= kRecentBars) {
+        carry(values[count % kRecentBars]);
+    }
+    values[count % kRecentBars] = value;
+    ++count;
+}
+
+void IncrementalIndicatorSet::OutputTail::settle(qsizetype barsBack, double value) {
+    if (barsBack >= count) {
+        return;
+    }
+    if (barsBack < kRecentBars) {
+        values[(count - 1 - barsBack) % kRecentBars] = value;
+        return;
+    }
+    // The bar already left the ring while it was still unknown; every older
+    // bar was settled before it and every newer one is still unknown.
+    carry(value);
+}
+
+void IncrementalIndicatorSet::OutputTail::carry(double value) {
+    if (!std::isnan(value)) {
+        carriedNonNaN[0] = carriedNonNaN[1];
+        carriedNonNaN[1] = value;
+    }
+    if (std::isfinite(value)) {
+        carriedFinite = value;
+    }
+}
+
+double IncrementalIndicatorSet::OutputTail::latest() const {
+    return count > 0 ? values[(count - 1) % kRecentBars] : kNaN;
+}
+
+Series IncrementalIndicatorSet::OutputTail::series(bool withCarry) const {
+    Series result;
+    const qsizetype kept = std::min(count, kRecentBars);
+    result.reserve(kept + 3);
+    if (count > kRecentBars) {
+        result.push_back(withCarry ? carriedFinite : kNaN);
+        result.push_back(withCarry ? carriedNonNaN[0] : kNaN);
+        result.push_back(withCarry ? carriedNonNaN[1] : kNaN);
+    }
+    for (qsizetype bar = count - kept; bar < count; ++bar) {
+        result.push_back(values[bar % kRecentBars]);
+    }
+    return result;
+}
+
+IncrementalIndicatorSet::IncrementalIndicatorSet() = default;
+
+IncrementalIndicatorSet::IncrementalIndicatorSet(const ConfigMap &configs)
+    : configs_(configs) {
+    for (auto iterator = configs.cbegin(); iterator != configs.cend(); ++iterator) {
+        const QString &key = iterator.key();
+        const QJsonObject &config = iterator.value();
+        if (!configEnabled(config)) {
+            continue;
+        }
+        const auto length = [&config](const char *name, qsizetype fallback) {
+            return configLength(config, QString::fromLatin1(name), fallback);
+        };
+        const auto number = [&config](const char *name, double fallback) {
+            return configDouble(config, QString::fromLatin1(name), fallback);
+        };
+        if (key == QStringLiteral("donchian")) {
+            add(std::make_unique<DonchianKernel>(length("length", 20)),
+                {QStringLiteral("donchian_high"), QStringLiteral("donchian_low"), QStringLiteral("donchian")});
+        } else if (key == QStringLiteral("psar")) {
+            add(std::make_unique<ParabolicSarKernel>(number("af", 0.02), number("max_af", 0.2)),
+                {QStringLiteral("psar")});
+        } else if (key == QStringLiteral("ma")) {
+            add(std::make_unique<MovingAverageKernel>(
+                    length("length", 20),
+                    configString(config, QStringLiteral("type")) == QStringLiteral("EMA")),
+                {QStringLiteral("ma")});
+        } else if (key == QStringLiteral("ema")) {
+            add(std::make_unique<EmaKernel>(length("length", 20)), {QStringLiteral("ema")});
+        } else if (key == QStringLiteral("bb")) {
+            add(std::make_unique<BollingerKernel>(length("length", 20), number("std", 2.0), false),
+                {QStringLiteral("bb_upper"), QStringLiteral("bb_mid"), QStringLiteral("bb_lower")});
+        } else if (key == QStringLiteral("bbw")) {
+            add(std::make_unique<BollingerKernel>(length("length", 20), number("std", 2.0), true),
+                {QStringLiteral("bbw")});
+        } else if (key == QStringLiteral("keltner")) {
+            add(std::make_unique<KeltnerKernel>(
+                    length("length", 20), length("atr_length", 10), number("multiplier", 2.0)),
+                {QStringLiteral("keltner_upper"), QStringLiteral("keltner_mid"), QStringLiteral("keltner_lower")});
+        } else if (key == QStringLiteral("ichimoku")) {
+            add(std::make_unique<IchimokuKernel>(
+                    length("conversion_length", 9),
+                    length("base_length", 26),
+                    length("span_b_length", 52),
+                    length("displacement", 26)),
+                {QStringLiteral("ichimoku_tenkan"),
+                 QStringLiteral("ichimoku_kijun"),
+                 QStringLiteral("ichimoku_span_a"),
+                 QStringLiteral("ichimoku_span_b"),
+                 QStringLiteral("ichimoku_chikou"),
+                 QStringLiteral("ichimoku")});
+        } else if (key == QStringLiteral("rsi")) {
+            add(std::make_unique<RsiKernel>(length("length", 14)), {QStringLiteral("rsi")});
+        } else if (key == QStringLiteral("stoch_rsi")) {
+            add(std::make_unique<StochRsiKernel>(
+                    length("length", 14), length("smooth_k", 3), length("smooth_d", 3)),
+                {QStringLiteral("stoch_rsi"), QStringLiteral("stoch_rsi_k"), QStringLiteral("stoch_rsi_d")});
+        } else if (key == QStringLiteral("willr")) {
+            add(std::make_unique<WilliamsRKernel>(length("length", 14)), {QStringLiteral("willr")});
+        } else if (key == QStringLiteral("volume")) {
+            add(std::make_unique<VolumeKernel>(), {QStringLiteral("volume")});
+        } else if (key == QStringLiteral("obv")) {
+            add(std::make_unique<ObvKernel>(), {QStringLiteral("obv")});
+        } else if (key == QStringLiteral("rvol")) {
+            add(std::make_unique<RelativeVolumeKernel>(length("length", 20)), {QStringLiteral("rvol")});
+        } else if (key == QStringLiteral("cmf")) {
+            add(std::make_unique<ChaikinMoneyFlowKernel>(length("length", 20)), {QStringLiteral("cmf")});
+        } else if (key == QStringLiteral("cci")) {
+            add(std::make_unique<CciKernel>(length("length", 20), number("constant", 0.015)),
+                {QStringLiteral("cci")});
+        } else if (key == QStringLiteral("roc")) {
+            add(std::make_unique<RocKernel>(length("length", 12)), {QStringLiteral("roc")});
+        } else if (key == QStringLiteral("trix")) {
+            add(std::make_unique<TrixKernel>(length("length", 15)), {QStringLiteral("trix")});
+        } else if (key == QStringLiteral("ppo")) {
+            add(std::make_unique<OscillatorKernel>(
+                    length("fast", 12), length("slow", 26), length("signal", 9), true),
+                {QStringLiteral("ppo"), QStringLiteral("ppo_signal"), QStringLiteral("ppo_hist")});
+        } else if (key == QStringLiteral("ao")) {
+            add(std::make_unique<AwesomeOscillatorKernel>(length("fast", 5), length("slow", 34)),
+                {QStringLiteral("ao")});
+        } else if (key == QStringLiteral("kst")) {
+            add(std::make_unique<KstKernel>(
+                    std::array<qsizetype, 4>{
+                        length("roc1", 10), length("roc2", 15), length("roc3", 20), length("roc4", 30)},
+                    std::array<qsizetype, 4>{
+                        length("sma1", 10), length("sma2", 10), length("sma3", 10), length("sma4", 15)},
+                    length("signal", 9)),
+                {QStringLiteral("kst"), QStringLiteral("kst_signal"), QStringLiteral("kst_hist")});
+        } else if (key == QStringLiteral("aroon")) {
+            add(std::make_unique<AroonKernel>(length("length", 25)),
+                {QStringLiteral("aroon_up"), QStringLiteral("aroon_down"), QStringLiteral("aroon")});
+        } else if (key == QStringLiteral("chop")) {
+            add(std::make_unique<ChoppinessKernel>(length("length", 14)), {QStringLiteral("chop")});
+        } else if (key == QStringLiteral("atr")) {
+            add(std::make_unique<AtrKernel>(length("length", 14), false), {QStringLiteral("atr")});
+        } else if (key == QStringLiteral("natr")) {
+            add(std::make_unique<AtrKernel>(length("length", 14), true), {QStringLiteral("natr")});
+        } else if (key == QStringLiteral("vwap")) {
+            add(std::make_unique<VwapKernel>(length("length", 20)), {QStringLiteral("vwap")});
+        } else if (key == QStringLiteral("mfi")) {
+            add(std::make_unique<MfiKernel>(length("length", 14)), {QStringLiteral("mfi")});
+        } else if (key == QStringLiteral("uo")) {
+            add(std::make_unique<UltimateOscillatorKernel>(
+                    length("short", 7), length("medium", 14), length("long", 28)),
+                {QStringLiteral("uo")});
+        } else if (key == QStringLiteral("macd")) {
+            add(std::make_unique<OscillatorKernel>(
+                    length("fast", 12), length("slow", 26), length("signal", 9), false),
+                {QStringLiteral("macd_line"), QStringLiteral("macd_signal")});
+        } else if (key == QStringLiteral("adx")) {
+            add(std::make_unique<DmiKernel>(length("length", 14), true), {QStringLiteral("adx")});
+        } else if (key == QStringLiteral("dmi")) {
+            add(std::make_unique<DmiKernel>(length("length", 14), false),
+                {QStringLiteral("dmi_plus"), QStringLiteral("dmi_minus"), QStringLiteral("dmi")});
+        } else if (key == QStringLiteral("supertrend")) {
+            add(std::make_unique<SupertrendKernel>(length("atr_period", 10), number("multiplier", 3.0)),
+                {QStringLiteral("supertrend")});
+        } else if (key == QStringLiteral("stochastic")) {
+            add(std::make_unique<StochasticKernel>(
+                    length("length", 14), length("smooth_k", 3), length("smooth_d", 3)),
+                {QStringLiteral("stochastic"), QStringLiteral("stochastic_k"), QStringLiteral("stochastic_d")});
+        }
+    }
+    tails_.resize(static_cast<std::size_t>(outputKeys_.size()));
+    values_ = Series(outputKeys_.size(), kNaN);
+    previewValues_ = Series(outputKeys_.size(), kNaN);
+}
+
+IncrementalIndicatorSet::IncrementalIndicatorSet(const IncrementalIndicatorSet &other)
+    : configs_(other.configs_),
+      outputKeys_(other.outputKeys_),
+      lookAhead_(other.lookAhead_),
+      tails_(other.tails_),
+      closes_(other.closes_),
+      values_(other.values_),
+      previewValues_(other.previewValues_),
+      previewClose_(other.previewClose_),
+      closedBars_(other.closedBars_),
+      hasPreview_(other.hasPreview_) {
+    slots_.reserve(other.slots_.size());
+    for (const Slot &slot : other.slots_) {
+        slots_.push_back({slot.indicator->clone(), slot.firstOutput});
+    }
+}
+
+IncrementalIndicatorSet::IncrementalIndicatorSet(IncrementalIndicatorSet &&other) noexcept = default;
+
+IncrementalIndicatorSet &IncrementalIndicatorSet::operator=(const IncrementalIndicatorSet &other) {
+    if (this != &other) {
+        *this = IncrementalIndicatorSet(other);
+    }
+    return *this;
+}
+
+IncrementalIndicatorSet &IncrementalIndicatorSet::operator=(IncrementalIndicatorSet &&other) noexcept = default;
+
+IncrementalIndicatorSet::~IncrementalIndicatorSet() = default;
+
+void IncrementalIndicatorSet::add(std::unique_ptr<IncrementalIndicator> indicator, const QStringList &keys) {
+    for (qsizetype output = 0; output < keys.size(); ++output) {
+        outputKeys_.push_back(keys[output]);
+        lookAhead_.push_back(indicator->lookAhead(output));
+    }
+    slots_.push_back({std::move(indicator), outputKeys_.size() - keys.size()});
+}
+
+void IncrementalIndicatorSet::reset() {
+    *this = IncrementalIndicatorSet(configs_);
+}
+
+void IncrementalIndicatorSet::appendClosed(const Candle &candle) {
+    for (const Slot &slot : slots_) {
+        slot.indicator->step(closedBars_, candle, values_.data() + slot.firstOutput, true);
+    }
+    for (qsizetype output = 0; output < outputKeys_.size(); ++output) {
+        OutputTail &tail = tails_[static_cast<std::size_t>(output)];
+        if (lookAhead_[output] == 0) {
+            tail.push(values_[output]);
+        } else {
+            tail.push(kNaN);
+            tail.settle(lookAhead_[output], values_[output]);
+        }
+    }
+    closes_.push(candle.close);
+    ++closedBars_;
+    hasPreview_ = false;
+}
+
+void IncrementalIndicatorSet::previewOpen(const Candle &candle) {
+    for (const Slot &slot : slots_) {
+        slot.indicator->step(closedBars_, candle, previewValues_.data() + slot.firstOutput, false);
+    }
+    previewClose_ = candle.close;
+    hasPreview_ = true;
+}
+
+double IncrementalIndicatorSet::value(const QString &outputKey) const {
+    const qsizetype output = outputKeys_.indexOf(outputKey);
+    if (output < 0 || lookAhead_[output] > 0) {
+        return kNaN;
+    }
+    return hasPreview_ ? previewValues_[output] : tails_[static_cast<std::size_t>(output)].latest();
+}
+
+RecentSeries IncrementalIndicatorSet::recent(bool includePreview) const {
+    const bool preview = includePreview && hasPreview_;
+    RecentSeries result;
+    OutputTail closes = closes_;
+    if (preview) {
+        closes.push(previewClose_);
+    }
+    result.closes = closes.series(false);
+    for (qsizetype output = 0; output < outputKeys_.size(); ++output) {
+        OutputTail tail = tails_[static_cast<std::size_t>(output)];
+        if (preview) {
+            if (lookAhead_[output] == 0) {
+                tail.push(previewValues_[output]);
+            } else {
+                tail.push(kNaN);
+                tail.settle(lookAhead_[output], previewValues_[output]);
+            }
+        }
+        result.indicators.insert(outputKeys_[output], tail.series(true));
+    }
+    return result;
+}
+
+} // namespace NativeIndicatorRuntime
@@ -5,6 +5,14 @@
 #include <QStringList>
 #include <QVector>
 
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
 namespace NativeIndicatorRuntime {
 
 struct Candle {
@@ -15,12 +23,211 @@ struct Candle {
     double volume = 0.0;
 };
 
+inline constexpr std::size_t kCandleColumnAlignment = 64;
+
+// Allocates candle columns on cache-line boundaries so kernels that stream a
+// column start on an aligned load.
+template <typename T>
+struct CacheLineAllocator {
+    using value_type = T;
+
+    CacheLineAllocator() = default;
+    template <typename U>
+    CacheLineAllocator(const CacheLineAllocator<U> &) noexcept {}
+
+    T *allocate(std::size_t count) {
+        return static_cast<T *>(::operator new(
+            count * sizeof(T), std::align_val_t{kCandleColumnAlignment}));
+    }
+
+    void deallocate(T *pointer, std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t{kCandleColumnAlignment});
+    }
+
+    template <typename U>
+    bool operator==(const CacheLineAllocator<U> &) const noexcept { return true; }
+};
+
+template <typename T>
+using AlignedColumn = std::vector<T, CacheLineAllocator<T>>;
+
+using Column = std::span<const double>;
+
+// Non-owning view of candle columns. Cheap to copy; this is what indicator
+// kernels and the backtest engine take.
+struct CandleSpan {
+    std::span<const qint64> openTime;
+    Column open;
+    Column high;
+    Column low;
+    Column close;
+    Column volume;
+
+    qsizetype size() const { return static_cast<qsizetype>(close.size()); }
+    bool isEmpty() const { return close.empty(); }
+    Candle at(qsizetype index) const {
+        return {open[index], high[index], low[index], close[index], volume[index]};
+    }
+    CandleSpan first(qsizetype count) const { return subspan(0, count); }
+    CandleSpan last(qsizetype count) const { return subspan(size() - count, count); }
+    CandleSpan subspan(qsizetype offset, qsizetype count) const {
+        const auto start = static_cast<std::size_t>(offset);
+        const auto length = static_cast<std::size_t>(count);
+        return {openTime.subspan(start, length), open.subspan(start, length),
+                high.subspan(start, length), low.subspan(start, length),
+                close.subspan(start, length), volume.subspan(start, length)};
+    }
+};
+
+// Struct-of-arrays candle store. Build it once per fetched series and hand
+// out CandleSpan views; every column has the same length.
+class CandleColumns {
+public:
+    CandleColumns() = default;
+
+    static CandleColumns fromCandles(const QVector<Candle> &candles);
+
+    // Accepts any range of kline records exposing openTimeMs, open, high,
+    // low, close and volume, e.g. BinanceRestClient::KlinesResult::candles.
+    template <typename KlineRange>
+    static CandleColumns fromKlines(const KlineRange &klines) {
+        CandleColumns columns;
+        columns.reserve(static_cast<qsizetype>(klines.size()));
+        for (const auto &kline : klines) {
+            columns.append(kline.openTimeMs, {kline.open, kline.high, kline.low, kline.close, kline.volume});
+        }
+        return columns;
+    }
+
+    void reserve(qsizetype size);
+    void clear();
+    void append(qint64 openTimeMs, const Candle &candle);
+
+    qsizetype size() const { return static_cast<qsizetype>(close_.size()); }
+    bool isEmpty() const { return close_.empty(); }
+    Candle at(qsizetype index) const { return span().at(index); }
+
+    CandleSpan span() const {
+        return {openTime_, open_, high_, low_, close_, volume_};
+    }
+    operator CandleSpan() const { return span(); }
+
+private:
+    AlignedColumn<qint64> openTime_;
+    AlignedColumn<double> open_;
+    AlignedColumn<double> high_;
+    AlignedColumn<double> low_;
+    AlignedColumn<double> close_;
+    AlignedColumn<double> volume_;
+};
+
 using ConfigMap = QMap<QString, QJsonObject>;
 using Series = QVector<double>;
 using SeriesMap = QMap<QString, Series>;
 
 QStringList computedIndicatorKeys();
 QStringList unsupportedEnabledIndicatorKeys(const ConfigMap &configs);
-SeriesMap computeConfiguredSeries(const QVector<Candle> &candles, const ConfigMap &configs);
+SeriesMap computeConfiguredSeries(CandleSpan candles, const ConfigMap &configs);
+
+class IncrementalIndicator;
+
+// Trailing bars of an IncrementalIndicatorSet, shaped for
+// NativeStrategyRuntime::StrategySignalInput: closes and every indicator
+// series have the same length and end on the same bar.
+struct RecentSeries {
+    Series closes;
+    SeriesMap indicators;
+};
+
+// Streaming counterpart of computeConfiguredSeries for the live path. Every
+// configured indicator keeps O(1)-per-bar state (CCI rescans its window for
+// the mean deviation), so committing a closed bar or re-evaluating the forming
+// one costs O(indicators) rather than a recompute of the whole window.
+//
+// After n appendClosed() calls the values are those computeConfiguredSeries
+// reports at bar n - 1 over all n bars; previewOpen() gives the values the
+// forming bar would have as bar n. Recursive indicators (EMA, RSI, ATR, ...)
+// therefore carry their state from the first appended bar instead of
+// restarting at the start of a fixed window.
+class IncrementalIndicatorSet {
+public:
+    // Bars recent() returns verbatim: the signal bar, the bar before it and
+    // the one before that, which closed-candle signals compare against.
+    static constexpr qsizetype kRecentBars = 3;
+
+    IncrementalIndicatorSet();
+    explicit IncrementalIndicatorSet(const ConfigMap &configs);
+    IncrementalIndicatorSet(const IncrementalIndicatorSet &other);
+    IncrementalIndicatorSet(IncrementalIndicatorSet &&other) noexcept;
+    IncrementalIndicatorSet &operator=(const IncrementalIndicatorSet &other);
+    IncrementalIndicatorSet &operator=(IncrementalIndicatorSet &&other) noexcept;
+    ~IncrementalIndicatorSet();
+
+    const ConfigMap &configs() const { return configs_; }
+    const QStringList &outputKeys() const { return outputKeys_; }
+    // Closed bars appended since construction or reset().
+    qsizetype size() const { return closedBars_; }
+    bool hasPreview() const { return hasPreview_; }
+
+    // Drops every bar and keeps the configuration.
+    void reset();
+    // Commits the next closed bar and clears the preview.
+    void appendClosed(const Candle &candle);
+    // Evaluates the forming bar after the closed ones without committing it.
+    // Each call replaces the previous preview.
+    void previewOpen(const Candle &candle);
+    void clearPreview() { hasPreview_ = false; }
+
+    // Value of an output at the latest bar: the preview while one is set,
+    // the last closed bar otherwise. NaN for unknown keys and during warm-up.
+    double value(const QString &outputKey) const;
+
+    // The last kRecentBars bars, counting the preview as a bar when it is
+    // included. Once older bars exist, three carry slots lead every series:
+    // the latest older finite value, then the two latest older non-NaN
+    // values. Reading the last finite value, or the last two non-NaN values,
+    // therefore gives the same answer as on the full series. The carry slots
+    // of closes are NaN.
+    RecentSeries recent(bool includePreview) const;
+
+private:
+    struct OutputTail {
+        static constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+        std::array<double, kRecentBars> values{};
+        qsizetype count = 0;
+        double carriedFinite = kNaN;
+        std::array<double, 2> carriedNonNaN{kNaN, kNaN};
+
+        void push(double value);
+        // Fills in the bar barsBack bars before the latest one, for outputs
+        // that only become known later (the Ichimoku chikou span).
+        void settle(qsizetype barsBack, double value);
+        void carry(double value);
+        double latest() const;
+        Series series(bool withCarry) const;
+    };
+
+    struct Slot {
+        std::unique_ptr<IncrementalIndicator> indicator;
+        qsizetype firstOutput = 0;
+    };
+
+    void add(std::unique_ptr<IncrementalIndicator> indicator, const QStringList &keys);
+
+    ConfigMap configs_;
+    QStringList outputKeys_;
+    // Per output, how many bars back step() values are filed; see
+    // IncrementalIndicator::lookAhead().
+    QVector<qsizetype> lookAhead_;
+    std::vector<Slot> slots_;
+    std::vector<OutputTail> tails_;
+    OutputTail closes_;
+    Series values_;
+    Series previewValues_;
+    double previewClose_ = 0.0;
+    qsizetype closedBars_ = 0;
+    bool hasPreview_ = false;
+};
 
 } // namespace NativeIndicatorRuntime
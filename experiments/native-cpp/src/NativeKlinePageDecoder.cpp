@@ -0,0 +1,296 @@
+#include "NativeKlinePageDecoder.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QVariant>
+#include <QtMath>
+
+#include <atomic>
+
+namespace {
+
+// Longest number converted in place; longer ones are left to QJsonDocument.
+constexpr qsizetype kMaxNumberLength = 64;
+constexpr qint64 kMaxExactInteger = qint64(1) << 53;
+constexpr int kCandleFields = 6;
+
+struct Counters {
+    std::atomic<quint64> pages{0};
+    std::atomic<quint64> fallbackPages{0};
+    std::atomic<quint64> candles{0};
+    std::atomic<quint64> decodeNs{0};
+    std::atomic<quint64> lastPageDecodeNs{0};
+    std::atomic<quint64> maxPageDecodeNs{0};
+};
+
+Counters &counters() {
+    static Counters instance;
+    return instance;
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// A plain decimal, the subset of what QString::toDouble accepts that needs no
+// trimming or locale handling.
+bool isDecimalText(QByteArrayView text) {
+    qsizetype index = 0;
+    const auto digits = [&]() {
+        const qsizetype start = index;
+        while (index < text.size() && isDigit(text[index])) ++index;
+        return index > start;
+    };
+    if (index < text.size() && text[index] == '-') ++index;
+    if (!digits()) return false;
+    if (index < text.size() && text[index] == '.') {
+        ++index;
+        if (!digits()) return false;
+    }
+    if (index < text.size() && (text[index] == 'e' || text[index] == 'E')) {
+        ++index;
+        if (index < text.size() && (text[index] == '+' || text[index] == '-')) ++index;
+        if (!digits()) return false;
+    }
+    return index == text.size();
+}
+
+class PageReader {
+public:
+    explicit PageReader(QByteArrayView body)
+        : data_(body.data()),
+          size_(body.size()) {}
+
+    bool read(QVector<BinanceRestClient::KlineCandle> &candles) {
+        if (!consume('[')) return false;
+        if (!consume(']')) {
+            do {
+                BinanceRestClient::KlineCandle candle;
+                if (!readRow(candle)) return false;
+                candles.append(candle);
+            } while (consume(','));
+            if (!consume(']')) return false;
+        }
+        skipWhitespace();
+        return pos_ == size_;
+    }
+
+private:
+    struct Token {
+        bool string = false;
+        QByteArrayView text;
+    };
+
+    void skipWhitespace() {
+        while (pos_ < size_ && (data_[pos_] == ' ' || data_[pos_] == '\t' || data_[pos_] == '\n' || data_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) {
+        skipWhitespace();
+        if (pos_ >= size_ || data_[pos_] != expected) return false;
+        ++pos_;
+        return true;
+    }
+
+    bool readDigits() {
+        const qsizetype start = pos_;
+        while (pos_ < size_ && isDigit(data_[pos_])) ++pos_;
+        return pos_ > start;
+    }
+
+    // Plain ASCII strings and JSON numbers; everything else is left to
+    // QJsonDocument. Exponents are converted here because QJsonDocument
+    // rejects a page holding a number that overflows a double.
+    bool readToken(Token &token) {
+        skipWhitespace();
+        if (pos_ >= size_) return false;
+        const qsizetype start = pos_;
+        if (data_[pos_] == '"') {
+            for (++pos_; pos_ < size_ && data_[pos_] != '"'; ++pos_) {
+                const auto byte = static_cast<unsigned char>(data_[pos_]);
+                if (byte < 0x20 || byte >= 0x80 || byte == '\\') return false;
+            }
+            if (pos_ >= size_) return false;
+            token.string = true;
+            token.text = QByteArrayView(data_ + start + 1, pos_++ - start - 1);
+            return true;
+        }
+        if (data_[pos_] == '-') ++pos_;
+        if (pos_ < size_ && data_[pos_] == '0') {
+            ++pos_;
+        } else if (!readDigits()) {
+            return false;
+        }
+        if (pos_ < size_ && data_[pos_] == '.') {
+            ++pos_;
+            if (!readDigits()) return false;
+        }
+        bool exponent = false;
+        if (pos_ < size_ && (data_[pos_] == 'e' || data_[pos_] == 'E')) {
+            exponent = true;
+            ++pos_;
+            if (pos_ < size_ && (data_[pos_] == '+' || data_[pos_] == '-')) ++pos_;
+            if (!readDigits()) return false;
+        }
+        token.string = false;
+        token.text = QByteArrayView(data_ + start, pos_ - start);
+        if (token.text.size() > kMaxNumberLength) return false;
+        if (!exponent) return true;
+        bool ok = false;
+        return qIsFinite(token.text.toDouble(&ok)) && ok;
+    }
+
+    // The open time must be an integer number, as Binance sends it.
+    static bool openTime(const Token &token, qint64 &value) {
+        if (token.string) return false;
+        for (const char c : token.text) {
+            if (c != '-' && !isDigit(c)) return false;
+        }
+        bool ok = false;
+        value = token.text.toLongLong(&ok);
+        // QJsonDocument may keep larger integers as doubles.
+        return ok && value <= kMaxExactInteger && value >= -kMaxExactInteger;
+    }
+
+    // Converted by the routine QJsonDocument and QString::toDouble use, so
+    // both paths produce identical values.
+    static bool decimal(const Token &token, double &value) {
+        if (token.string && (token.text.size() > kMaxNumberLength || !isDecimalText(token.text))) return false;
+        bool ok = false;
+        value = token.text.toDouble(&ok);
+        return ok && qIsFinite(value);
+    }
+
+    bool readRow(BinanceRestClient::KlineCandle &candle) {
+        if (!consume('[')) return false;
+        int field = 0;
+        do {
+            Token token;
+            if (!readToken(token)) return false;
+            bool ok = true;
+            switch (field) {
+            case 0: ok = openTime(token, candle.openTimeMs); break;
+            case 1: ok = decimal(token, candle.open); break;
+            case 2: ok = decimal(token, candle.high); break;
+            case 3: ok = decimal(token, candle.low); break;
+            case 4: ok = decimal(token, candle.close); break;
+            case 5: ok = decimal(token, candle.volume); break;
+            default: break;
+            }
+            if (!ok) return false;
+            ++field;
+        } while (consume(','));
+        return field >= kCandleFields && consume(']');
+    }
+
+    const char *data_;
+    const qsizetype size_;
+    qsizetype pos_ = 0;
+};
+
+bool parseJsonNumber(const QJsonValue &value, double *out) {
+    bool ok = false;
+    const double parsed = value.toVariant().toDouble(&ok);
+    if (!ok || !qIsFinite(parsed)) {
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+} // namespace
+
+namespace NativeKlinePageDecoder {
+
+bool decodeFast(QByteArrayView body, QVector<BinanceRestClient::KlineCandle> &candles) {
+    const qsizetype previousSize = candles.size();
+    if (PageReader(body).read(candles)) return true;
+    candles.resize(previousSize);
+    return false;
+}
+
+BinanceRestClient::KlinesResult decodeJson(const QByteArray &body) {
+    BinanceRestClient::KlinesResult result;
+    QJsonParseError parseError{};
+    const QJsonDocument document = QJsonDocument::fromJson(body, &parseError);
+    if (parseError.error != QJsonParseError::NoError || document.isNull()) {
+        result.error = QStringLiteral("Invalid JSON response");
+        return result;
+    }
+    if (!document.isArray()) {
+        result.error = QStringLiteral("Unexpected Binance kline response");
+        return result;
+    }
+
+    const QJsonArray rows = document.array();
+    result.candles.reserve(rows.size());
+    for (const QJsonValue &entry : rows) {
+        if (!entry.isArray()) {
+            continue;
+        }
+        const QJsonArray row = entry.toArray();
+        if (row.size() < kCandleFields) {
+            continue;
+        }
+
+        bool timeOk = false;
+        BinanceRestClient::KlineCandle candle;
+        candle.openTimeMs = row.at(0).toVariant().toLongLong(&timeOk);
+        if (!timeOk
+            || !parseJsonNumber(row.at(1), &candle.open)
+            || !parseJsonNumber(row.at(2), &candle.high)
+            || !parseJsonNumber(row.at(3), &candle.low)
+            || !parseJsonNumber(row.at(4), &candle.close)
+            || !parseJsonNumber(row.at(5), &candle.volume)) {
+            continue;
+        }
+        result.candles.push_back(candle);
+    }
+    result.ok = true;
+    return result;
+}
+
+BinanceRestClient::KlinesResult decode(const QByteArray &body) {
+    QElapsedTimer timer;
+    timer.start();
+    BinanceRestClient::KlinesResult result;
+    // Rows run to roughly 150 bytes.
+    result.candles.reserve(body.size() / 128 + 1);
+    const bool fast = decodeFast(body, result.candles);
+    if (fast) {
+        result.ok = true;
+    } else {
+        result = decodeJson(body);
+    }
+
+    const auto elapsedNs = static_cast<quint64>(timer.nsecsElapsed());
+    Counters &totals = counters();
+    totals.pages.fetch_add(1, std::memory_order_relaxed);
+    if (!fast) totals.fallbackPages.fetch_add(1, std::memory_order_relaxed);
+    totals.candles.fetch_add(static_cast<quint64>(result.candles.size()), std::memory_order_relaxed);
+    totals.decodeNs.fetch_add(elapsedNs, std::memory_order_relaxed);
+    totals.lastPageDecodeNs.store(elapsedNs, std::memory_order_relaxed);
+    quint64 maxNs = totals.maxPageDecodeNs.load(std::memory_order_relaxed);
+    while (elapsedNs > maxNs
+           && !totals.maxPageDecodeNs.compare_exchange_weak(maxNs, elapsedNs, std::memory_order_relaxed)) {
+    }
+    return result;
+}
+
+Stats stats() {
+    const Counters &totals = counters();
+    Stats snapshot;
+    snapshot.pages = totals.pages.load(std::memory_order_relaxed);
+    snapshot.fallbackPages = totals.fallbackPages.load(std::memory_order_relaxed);
+    snapshot.candles = totals.candles.load(std::memory_order_relaxed);
+    snapshot.decodeNs = totals.decodeNs.load(std::memory_order_relaxed);
+    snapshot.lastPageDecodeNs = totals.lastPageDecodeNs.load(std::memory_order_relaxed);
+    snapshot.maxPageDecodeNs = totals.maxPageDecodeNs.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace NativeKlinePageDecoder
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "BinanceRestClient.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QVector>
+
+// Decoder for GET /klines reply bodies, the [[openTime,"open","high","low",
+// "close","volume",...],...] pages behind every history fetch. The fast path
+// reads the reply bytes in one pass and appends candles straight to the
+// caller's buffer; any page it does not fully understand (escapes, literals,
+// nested values, short rows, unusual number forms) is decoded with
+// QJsonDocument instead. Both paths produce identical candles.
+namespace NativeKlinePageDecoder {
+
+// Appends the page's candles to candles and returns true, or returns false
+// and leaves candles as they were.
+bool decodeFast(QByteArrayView body, QVector<BinanceRestClient::KlineCandle> &candles);
+
+// The QJsonDocument decoder: the fallback for decodeFast and the reference
+// it must agree with. Rows that are not arrays, have fewer than six values
+// or hold unparsable numbers are skipped.
+BinanceRestClient::KlinesResult decodeJson(const QByteArray &body);
+
+// decodeFast with decodeJson as the fallback; every call is counted in
+// stats().
+BinanceRestClient::KlinesResult decode(const QByteArray &body);
+
+struct Stats {
+    quint64 pages = 0;
+    quint64 fallbackPages = 0;
+    quint64 candles = 0;
+    quint64 decodeNs = 0;
+    quint64 lastPageDecodeNs = 0;
+    quint64 maxPageDecodeNs = 0;
+};
+
+Stats stats();
+
+} // namespace NativeKlinePageDecoder
@@ -0,0 +1,407 @@
+#include "NativeKlineStore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr int kIndexFormatVersion = 1;
+constexpr quint32 kSegmentVersion = 1;
+constexpr quint32 kSegmentColumnCount = 6;
+constexpr char kSegmentMagic[8] = {'T', 'B', 'K', 'L', 'I', 'N', 'E', 'S'};
+
+// Fixed 48-byte header followed by kSegmentColumnCount columns of `count`
+// 8-byte values: open time, open, high, low, close, volume. Every column
+// starts 8-byte aligned, so mapped columns can be read in place.
+struct SegmentHeader {
+    char magic[8];
+    quint32 version;
+    quint32 columnCount;
+    qint64 count;
+    qint64 firstOpenMs;
+    qint64 lastOpenMs;
+    qint64 reserved;
+};
+static_assert(sizeof(SegmentHeader) == 48);
+
+QString pathComponent(const QString &value) {
+    static const QRegularExpression unsafe(QStringLiteral("[^A-Za-z0-9._-]"));
+    QString cleaned = value.trimmed();
+    cleaned.replace(unsafe, QStringLiteral("_"));
+    return cleaned.isEmpty() ? QStringLiteral("_") : cleaned;
+}
+
+// "1M" and "1m" must not share a directory on case-insensitive filesystems.
+QString intervalComponent(const QString &interval) {
+    const QString trimmed = interval.trimmed();
+    return trimmed == QStringLiteral("1M") ? QStringLiteral("1mo") : pathComponent(trimmed);
+}
+
+std::shared_ptr<std::mutex> seriesMutex(const QString &directory) {
+    static std::mutex registryMutex;
+    static QHash<QString, std::shared_ptr<std::mutex>> registry;
+    std::lock_guard guard(registryMutex);
+    std::shared_ptr<std::mutex> &entry = registry[directory];
+    if (!entry) entry = std::make_shared<std::mutex>();
+    return entry;
+}
+
+void mergeRange(QVector<NativeKlineStore::Range> &ranges, const NativeKlineStore::Range &added) {
+    ranges.append(added);
+    std::sort(ranges.begin(), ranges.end(), [](const auto &left, const auto &right) {
+        return left.firstOpenMs < right.firstOpenMs;
+    });
+    QVector<NativeKlineStore::Range> merged;
+    merged.reserve(ranges.size());
+    for (const auto &range : ranges) {
+        if (!merged.isEmpty()
+            && (merged.back().lastOpenMs == std::numeric_limits<qint64>::max()
+                || range.firstOpenMs <= merged.back().lastOpenMs + 1)) {
+            merged.back().lastOpenMs = std::max(merged.back().lastOpenMs, range.lastOpenMs);
+        } else {
+            merged.append(range);
+        }
+    }
+    ranges = std::move(merged);
+}
+
+void removeRange(QVector<NativeKlineStore::Range> &ranges, const NativeKlineStore::Range &removed) {
+    QVector<NativeKlineStore::Range> kept;
+    kept.reserve(ranges.size() + 1);
+    for (const auto &range : ranges) {
+        if (range.lastOpenMs < removed.firstOpenMs || range.firstOpenMs > removed.lastOpenMs) {
+            kept.append(range);
+            continue;
+        }
+        if (range.firstOpenMs < removed.firstOpenMs) kept.append({range.firstOpenMs, removed.firstOpenMs - 1});
+        if (range.lastOpenMs > removed.lastOpenMs) kept.append({removed.lastOpenMs + 1, range.lastOpenMs});
+    }
+    ranges = std::move(kept);
+}
+
+qint64 segmentFileSize(qint64 count) {
+    return static_cast<qint64>(sizeof(SegmentHeader)) + count * static_cast<qint64>(kSegmentColumnCount * sizeof(qint64));
+}
+
+bool headerMatches(const SegmentHeader &header, qint64 count, const NativeKlineStore::Range &range) {
+    return std::memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) == 0
+        && header.version == kSegmentVersion
+        && header.columnCount == kSegmentColumnCount
+        && header.count == count
+        && header.firstOpenMs == range.firstOpenMs
+        && header.lastOpenMs == range.lastOpenMs;
+}
+
+// Sorts by open time and keeps the last candle written for each open time.
+void sortUniqueKeepLast(QVector<NativeKlineStore::Candle> &candles) {
+    std::stable_sort(candles.begin(), candles.end(), [](const auto &left, const auto &right) {
+        return left.openTimeMs < right.openTimeMs;
+    });
+    qsizetype write = 0;
+    for (qsizetype index = 0; index < candles.size(); ++index) {
+        if (index + 1 < candles.size() && candles.at(index + 1).openTimeMs == candles.at(index).openTimeMs) {
+            continue;
+        }
+        candles[write++] = candles.at(index);
+    }
+    candles.resize(write);
+}
+
+} // namespace
+
+namespace NativeKlineStore {
+
+QString seriesDirectory(const QString &rootDirectory, const SeriesKey &key) {
+    return QDir(rootDirectory).filePath(
+        QStringLiteral("%1/%2/%3")
+            .arg(pathComponent(key.market), pathComponent(key.symbol.toUpper()), intervalComponent(key.interval)));
+}
+
+Series::Series(const QString &rootDirectory, const SeriesKey &key)
+    : directory_(QDir::cleanPath(QDir(seriesDirectory(rootDirectory, key)).absolutePath())),
+      mutex_(seriesMutex(directory_)),
+      lock_(*mutex_) {
+    open_ = QDir().mkpath(directory_) && loadIndex();
+}
+
+Series::~Series() = default;
+
+QVector<Range> Series::missingRanges(qint64 firstOpenMs, qint64 lastOpenMs) const {
+    QVector<Range> missing;
+    if (lastOpenMs < firstOpenMs) return missing;
+    qint64 cursor = firstOpenMs;
+    for (const Range &range : covered_) {
+        if (range.lastOpenMs < cursor) continue;
+        if (range.firstOpenMs > lastOpenMs) break;
+        if (range.firstOpenMs > cursor) missing.append({cursor, range.firstOpenMs - 1});
+        if (range.lastOpenMs >= lastOpenMs) return missing;
+        cursor = range.lastOpenMs + 1;
+    }
+    missing.append({cursor, lastOpenMs});
+    return missing;
+}
+
+bool Series::append(const QVector<Candle> &candles, const Range &covered, QString *error) {
+    if (!open_) {
+        if (error) *error = QStringLiteral("Kline store %1 is not open").arg(directory_);
+        return false;
+    }
+    if (covered.lastOpenMs < covered.firstOpenMs) return true;
+
+    QVector<Candle> inside;
+    inside.reserve(candles.size());
+    for (const Candle &candle : candles) {
+        if (candle.openTimeMs >= covered.firstOpenMs && candle.openTimeMs <= covered.lastOpenMs) {
+            inside.append(candle);
+        }
+    }
+    sortUniqueKeepLast(inside);
+
+    if (!inside.isEmpty()) {
+        const QString fileName = QStringLiteral("segment-%1.bin").arg(nextSegment_, 6, 10, QLatin1Char('0'));
+        if (!writeSegment(fileName, inside, error)) return false;
+        ++nextSegment_;
+        segments_.append({fileName, {inside.constFirst().openTimeMs, inside.constLast().openTimeMs}, inside.size()});
+    }
+    mergeRange(covered_, covered);
+    if (!saveIndex(error)) return false;
+    return compact(error);
+}
+
+QVector<Candle> Series::read(qint64 firstOpenMs, qint64 lastOpenMs, bool *intact) {
+    QVector<Candle> candles;
+    if (intact) *intact = true;
+    if (!open_ || lastOpenMs < firstOpenMs) return candles;
+
+    int overlapping = 0;
+    QVector<Segment> unreadable;
+    for (const Segment &segment : std::as_const(segments_)) {
+        if (segment.range.lastOpenMs < firstOpenMs || segment.range.firstOpenMs > lastOpenMs) continue;
+        ++overlapping;
+        if (!readSegment(segment, firstOpenMs, lastOpenMs, &candles)) unreadable.append(segment);
+    }
+    if (overlapping > 1) sortUniqueKeepLast(candles);
+
+    // The range a lost segment held is no longer stored: forget it so the
+    // next missingRanges() call reports it and the caller fetches it again.
+    if (!unreadable.isEmpty()) {
+        if (intact) *intact = false;
+        for (const Segment &segment : std::as_const(unreadable)) dropSegment(segment);
+        saveIndex(nullptr);
+    }
+    return candles;
+}
+
+bool Series::readSegment(const Segment &segment, qint64 firstOpenMs, qint64 lastOpenMs, QVector<Candle> *candles) const {
+    QFile file(QDir(directory_).filePath(segment.fileName));
+    const qint64 expectedSize = segmentFileSize(segment.count);
+    uchar *mapped = file.open(QIODevice::ReadOnly) && file.size() == expectedSize
+        ? file.map(0, expectedSize)
+        : nullptr;
+    SegmentHeader header{};
+    if (mapped) std::memcpy(&header, mapped, sizeof(header));
+    if (!mapped || !headerMatches(header, segment.count, segment.range)) {
+        if (mapped) file.unmap(mapped);
+        return false;
+    }
+
+    const auto count = static_cast<std::size_t>(header.count);
+    const auto *openTimes = reinterpret_cast<const qint64 *>(mapped + sizeof(SegmentHeader));
+    const auto *open = reinterpret_cast<const double *>(openTimes + count);
+    const auto *high = open + count;
+    const auto *low = high + count;
+    const auto *close = low + count;
+    const auto *volume = close + count;
+    const std::size_t begin = std::lower_bound(openTimes, openTimes + count, firstOpenMs) - openTimes;
+    const std::size_t end = std::upper_bound(openTimes, openTimes + count, lastOpenMs) - openTimes;
+    candles->reserve(candles->size() + static_cast<qsizetype>(end - begin));
+    for (std::size_t index = begin; index < end; ++index) {
+        candles->append({openTimes[index], open[index], high[index], low[index], close[index], volume[index]});
+    }
+    file.unmap(mapped);
+    return true;
+}
+
+void Series::dropSegment(const Segment &segment) {
+    segments_.removeIf([&](const Segment &kept) { return kept.fileName == segment.fileName; });
+    removeRange(covered_, segment.range);
+    QFile::remove(QDir(directory_).filePath(segment.fileName));
+}
+
+bool Series::loadIndex() {
+    segments_.clear();
+    covered_.clear();
+    nextSegment_ = 1;
+
+    QFile file(QDir(directory_).filePath(QStringLiteral("index.json")));
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    if (index.value(QStringLiteral("format_version")).toInt() != kIndexFormatVersion) return true;
+
+    // An entry that cannot name a file in this directory means the index
+    // itself is damaged, so the series starts over.
+    QVector<Segment> segments;
+    for (const QJsonValue &value : index.value(QStringLiteral("segments")).toArray()) {
+        const QJsonObject entry = value.toObject();
+        Segment segment;
+        segment.fileName = entry.value(QStringLiteral("file")).toString();
+        segment.range.firstOpenMs = entry.value(QStringLiteral("first_open_ms")).toInteger();
+        segment.range.lastOpenMs = entry.value(QStringLiteral("last_open_ms")).toInteger();
+        segment.count = entry.value(QStringLiteral("count")).toInteger();
+        if (segment.fileName.isEmpty() || segment.fileName.contains(QLatin1Char('/')) || segment.count <= 0
+            || segment.range.lastOpenMs < segment.range.firstOpenMs) {
+            return true;
+        }
+        segments.append(segment);
+    }
+    QVector<Range> covered;
+    for (const QJsonValue &value : index.value(QStringLiteral("covered")).toArray()) {
+        const QJsonArray pair = value.toArray();
+        if (pair.size() != 2) return true;
+        mergeRange(covered, {pair.at(0).toInteger(), pair.at(1).toInteger()});
+    }
+
+    segments_ = std::move(segments);
+    covered_ = std::move(covered);
+    nextSegment_ = std::max<qint64>(1, index.value(QStringLiteral("next_segment")).toInteger());
+
+    // A segment that is missing, truncated or not the file the index describes
+    // takes its coverage with it; the rest of the series stays usable.
+    QVector<Segment> unreadable;
+    for (const Segment &segment : std::as_const(segments_)) {
+        QFile segmentFile(QDir(directory_).filePath(segment.fileName));
+        SegmentHeader header{};
+        if (!segmentFile.open(QIODevice::ReadOnly) || segmentFile.size() != segmentFileSize(segment.count)
+            || segmentFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)
+            || !headerMatches(header, segment.count, segment.range)) {
+            unreadable.append(segment);
+        }
+    }
+    if (!unreadable.isEmpty()) {
+        for (const Segment &segment : std::as_const(unreadable)) dropSegment(segment);
+        saveIndex(nullptr);
+    }
+    return true;
+}
+
+bool Series::saveIndex(QString *error) {
+    QJsonArray segments;
+    for (const Segment &segment : segments_) {
+        segments.append(QJsonObject{
+            {QStringLiteral("file"), segment.fileName},
+            {QStringLiteral("first_open_ms"), segment.range.firstOpenMs},
+            {QStringLiteral("last_open_ms"), segment.range.lastOpenMs},
+            {QStringLiteral("count"), segment.count},
+        });
+    }
+    QJsonArray covered;
+    for (const Range &range : covered_) {
+        covered.append(QJsonArray{range.firstOpenMs, range.lastOpenMs});
+    }
+    const QJsonObject index{
+        {QStringLiteral("format_version"), kIndexFormatVersion},
+        {QStringLiteral("next_segment"), nextSegment_},
+        {QStringLiteral("segments"), segments},
+        {QStringLiteral("covered"), covered},
+    };
+
+    QSaveFile file(QDir(directory_).filePath(QStringLiteral("index.json")));
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(index).toJson(QJsonDocument::Compact)) < 0
+        || !file.commit()) {
+        if (error) *error = QStringLiteral("Could not write kline store index in %1").arg(directory_);
+        return false;
+    }
+    return true;
+}
+
+bool Series::writeSegment(const QString &fileName, const QVector<Candle> &candles, QString *error) {
+    SegmentHeader header{};
+    std::memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+    header.version = kSegmentVersion;
+    header.columnCount = kSegmentColumnCount;
+    header.count = candles.size();
+    header.firstOpenMs = candles.constFirst().openTimeMs;
+    header.lastOpenMs = candles.constLast().openTimeMs;
+
+    const std::size_t count = static_cast<std::size_t>(candles.size());
+    QByteArray bytes(static_cast<qsizetype>(sizeof(header) + count * kSegmentColumnCount * sizeof(qint64)), Qt::Uninitialized);
+    char *out = bytes.data();
+    std::memcpy(out, &header, sizeof(header));
+    auto *openTimes = reinterpret_cast<qint64 *>(out + sizeof(header));
+    auto *open = reinterpret_cast<double *>(openTimes + count);
+    auto *high = open + count;
+    auto *low = high + count;
+    auto *close = low + count;
+    auto *volume = close + count;
+    for (std::size_t index = 0; index < count; ++index) {
+        const Candle &candle = candles.at(static_cast<qsizetype>(index));
+        openTimes[index] = candle.openTimeMs;
+        open[index] = candle.open;
+        high[index] = candle.high;
+        low[index] = candle.low;
+        close[index] = candle.close;
+        volume[index] = candle.volume;
+    }
+
+    QSaveFile file(QDir(directory_).filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+        if (error) *error = QStringLiteral("Could not write kline segment %1 in %2").arg(fileName, directory_);
+        return false;
+    }
+    bytesWritten_ += bytes.size();
+    return true;
+}
+
+bool Series::compact(QString *error) {
+    // The trailing run to merge: extended backwards while the segment before
+    // it is not clearly larger than the run.
+    qsizetype first = segments_.size() - 1;
+    qint64 runCount = first >= 0 ? segments_.at(first).count : 0;
+    while (first > 0 && segments_.at(first - 1).count < kCompactSizeRatio * runCount) {
+        --first;
+        runCount += segments_.at(first).count;
+    }
+    if (first < 0 || first == segments_.size() - 1) return true;
+
+    // Later segments win on overlapping open times, as in read().
+    QVector<Candle> candles;
+    candles.reserve(runCount);
+    QVector<Segment> unreadable;
+    for (qsizetype index = first; index < segments_.size(); ++index) {
+        const Segment &segment = segments_.at(index);
+        if (!readSegment(segment, std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max(), &candles)) {
+            unreadable.append(segment);
+        }
+    }
+    if (!unreadable.isEmpty()) {
+        for (const Segment &segment : std::as_const(unreadable)) dropSegment(segment);
+        return saveIndex(error);
+    }
+    sortUniqueKeepLast(candles);
+
+    const QString fileName = QStringLiteral("segment-%1.bin").arg(nextSegment_, 6, 10, QLatin1Char('0'));
+    if (!writeSegment(fileName, candles, error)) return false;
+    ++nextSegment_;
+    const QVector<Segment> replaced = segments_.mid(first);
+    segments_.resize(first);
+    segments_.append({fileName, {candles.constFirst().openTimeMs, candles.constLast().openTimeMs}, candles.size()});
+    if (!saveIndex(error)) return false;
+    for (const Segment &segment : replaced) {
+        QFile::remove(QDir(directory_).filePath(segment.fileName));
+    }
+    return true;
+}
+
+} // namespace NativeKlineStore
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "BinanceRestClient.h"
+
+#include <QString>
+#include <QVector>
+
+#include <memory>
+#include <mutex>
+
+// Persistent candle store behind BinanceRestClient::fetchKlinesRange.
+//
+// Each series (market, symbol, fetch interval) lives in its own directory:
+// an index.json listing immutable columnar segment files plus the open-time
+// ranges already known to be complete (the gap index). Segments are written
+// once and read through QFile::map; only closed candles are ever stored, so a
+// covered range never needs to be fetched again.
+namespace NativeKlineStore {
+
+using Candle = BinanceRestClient::KlineCandle;
+
+struct SeriesKey {
+    QString market;
+    QString symbol;
+    QString interval;
+};
+
+// Inclusive open-time bounds in milliseconds.
+struct Range {
+    qint64 firstOpenMs = 0;
+    qint64 lastOpenMs = 0;
+};
+
+// append() merges the newest segments while the segment before them holds
+// fewer than kCompactSizeRatio times their candles. Segment sizes so at least
+// halve towards the newest one, each candle is rewritten O(log n) times and
+// large older segments are left alone.
+inline constexpr qint64 kCompactSizeRatio = 2;
+
+QString seriesDirectory(const QString &rootDirectory, const SeriesKey &key);
+
+// Holds the series lock for its lifetime, so concurrent fetches of the same
+// series serialize and the second one reads what the first one stored.
+class Series {
+public:
+    Series(const QString &rootDirectory, const SeriesKey &key);
+    ~Series();
+    Series(const Series &) = delete;
+    Series &operator=(const Series &) = delete;
+
+    bool isOpen() const { return open_; }
+    const QString &directory() const { return directory_; }
+    const QVector<Range> &coveredRanges() const { return covered_; }
+    qsizetype segmentCount() const { return segments_.size(); }
+    // Segment file bytes written through this handle, compaction included.
+    qint64 bytesWritten() const { return bytesWritten_; }
+
+    // Sub-ranges of [firstOpenMs, lastOpenMs] not yet covered, in order.
+    QVector<Range> missingRanges(qint64 firstOpenMs, qint64 lastOpenMs) const;
+
+    // Stores the candles inside `covered` as a new segment and marks the
+    // range complete. Candles outside the range are ignored.
+    bool append(const QVector<Candle> &candles, const Range &covered, QString *error = nullptr);
+
+    // Stored candles with firstOpenMs <= openTime <= lastOpenMs, ascending.
+    // A segment that can no longer be read is dropped together with its
+    // coverage and the index rewritten, so the range is reported missing (and
+    // fetched) again; *intact is false when that happened.
+    QVector<Candle> read(qint64 firstOpenMs, qint64 lastOpenMs, bool *intact = nullptr);
+
+private:
+    struct Segment {
+        QString fileName;
+        Range range;
+        qint64 count = 0;
+    };
+
+    bool loadIndex();
+    // Appends segment's candles inside [firstOpenMs, lastOpenMs]; false when
+    // the file is missing or not the one the index describes.
+    bool readSegment(const Segment &segment, qint64 firstOpenMs, qint64 lastOpenMs, QVector<Candle> *candles) const;
+    void dropSegment(const Segment &segment);
+    bool saveIndex(QString *error);
+    bool writeSegment(const QString &fileName, const QVector<Candle> &candles, QString *error);
+    bool compact(QString *error);
+
+    QString directory_;
+    bool open_ = false;
+    qint64 nextSegment_ = 1;
+    qint64 bytesWritten_ = 0;
+    QVector<Segment> segments_;
+    QVector<Range> covered_;
+    std::shared_ptr<std::mutex> mutex_;
+    std::unique_lock<std::mutex> lock_;
+};
+
+} // namespace NativeKlineStore
@@ -0,0 +1,220 @@
+#include "NativeMarketDataHub.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+namespace NativeMarketDataHub {
+
+QString feedKey(const QString &connectorToken, bool futures, const QString &symbol, const QString &interval) {
+    // Symbol and interval lead, as in runtime signal keys. Intervals keep
+    // their case: "1m" and "1M" are different feeds.
+    return QStringLiteral("%1|%2|%3|%4")
+        .arg(symbol.trimmed().toUpper(),
+             interval.trimmed(),
+             futures ? QStringLiteral("futures") : QStringLiteral("spot"),
+             connectorToken.trimmed().toLower());
+}
+
+CandleView::CandleView(const Candle *head, qsizetype headSize, const Candle *tail, qsizetype tailSize)
+    : head_(head),
+      headSize_(std::max<qsizetype>(0, headSize)),
+      tail_(tail),
+      tailSize_(std::max<qsizetype>(0, tailSize)) {}
+
+CandleView CandleView::of(const QVector<Candle> &candles) {
+    return CandleView(candles.constData(), candles.size());
+}
+
+CandleView CandleView::first(qsizetype count) const {
+    count = std::clamp<qsizetype>(count, 0, size());
+    if (count <= headSize_) {
+        return CandleView(head_, count);
+    }
+    return CandleView(head_, headSize_, tail_, count - headSize_);
+}
+
+QVector<Candle> CandleView::toVector() const {
+    QVector<Candle> candles;
+    candles.reserve(size());
+    for (qsizetype index = 0; index < size(); ++index) {
+        candles.append(at(index));
+    }
+    return candles;
+}
+
+CandleRing::CandleRing(qsizetype capacity)
+    : slots_(std::max<qsizetype>(1, capacity)) {}
+
+void CandleRing::clear() {
+    start_ = 0;
+    count_ = 0;
+}
+
+void CandleRing::assign(const CandleView &candles) {
+    clear();
+    const qsizetype skip = std::max<qsizetype>(0, candles.size() - capacity());
+    for (qsizetype index = skip; index < candles.size(); ++index) {
+        slots_[count_++] = candles.at(index);
+    }
+}
+
+bool CandleRing::upsert(const Candle &candle) {
+    const qsizetype capacity = slots_.size();
+    if (count_ > 0) {
+        Candle &latest = slots_[(start_ + count_ - 1) % capacity];
+        if (candle.openTimeMs == latest.openTimeMs) {
+            latest = candle;
+            return true;
+        }
+        if (candle.openTimeMs < latest.openTimeMs) {
+            return false;
+        }
+    }
+    if (count_ < capacity) {
+        slots_[(start_ + count_) % capacity] = candle;
+        ++count_;
+    } else {
+        slots_[start_] = candle;
+        start_ = (start_ + 1) % capacity;
+    }
+    return true;
+}
+
+CandleView CandleRing::view() const {
+    const qsizetype capacity = slots_.size();
+    const qsizetype headSize = std::min(count_, capacity - start_);
+    return CandleView(slots_.constData() + start_, headSize, slots_.constData(), count_ - headSize);
+}
+
+Hub::Hub(qsizetype capacity, QObject *parent)
+    : QObject(parent),
+      capacity_(std::max<qsizetype>(1, capacity)) {}
+
+void Hub::clear() {
+    feeds_.clear();
+    consumerFeeds_.clear();
+}
+
+void Hub::attach(const QString &consumerKey, const QString &feedKey) {
+    const auto existing = consumerFeeds_.constFind(consumerKey);
+    if (existing != consumerFeeds_.cend()) {
+        if (existing.value() == feedKey) {
+            return;
+        }
+        detach(consumerKey);
+    }
+    consumerFeeds_.insert(consumerKey, feedKey);
+    feedFor(feedKey).consumers.append(consumerKey);
+}
+
+void Hub::detach(const QString &consumerKey) {
+    const QString feedKey = consumerFeeds_.take(consumerKey);
+    const auto it = feeds_.find(feedKey);
+    if (it != feeds_.end()) {
+        it->consumers.removeAll(consumerKey);
+    }
+}
+
+QStringList Hub::consumersOf(const QString &feedKey) const {
+    const auto it = feeds_.constFind(feedKey);
+    return it == feeds_.cend() ? QStringList() : it->consumers;
+}
+
+bool Hub::isSeeded(const QString &feedKey) const {
+    const auto it = feeds_.constFind(feedKey);
+    return it != feeds_.cend() && it->seeded;
+}
+
+CandleView Hub::view(const QString &feedKey) const {
+    const auto it = feeds_.constFind(feedKey);
+    return it == feeds_.cend() ? CandleView() : it->ring.view();
+}
+
+bool Hub::latestClosed(const QString &feedKey) const {
+    const auto it = feeds_.constFind(feedKey);
+    return it != feeds_.cend() && it->latestClosed;
+}
+
+qint64 Hub::updatedAtMs(const QString &feedKey) const {
+    const auto it = feeds_.constFind(feedKey);
+    return it == feeds_.cend() ? 0 : it->updatedAtMs;
+}
+
+int Hub::fetchLimit(const QString &feedKey, qint64 intervalMs, qint64 nowMs) const {
+    const auto it = feeds_.constFind(feedKey);
+    if (it == feeds_.cend() || !it->seeded || it->ring.isEmpty() || intervalMs <= 0) {
+        return static_cast<int>(capacity_);
+    }
+    const qint64 elapsedMs = std::max<qint64>(0, nowMs - it->ring.view().constLast().openTimeMs);
+    const qint64 bars = elapsedMs / intervalMs + 2;
+    return static_cast<int>(std::min<qint64>(bars, capacity_));
+}
+
+bool Hub::ingest(const QString &feedKey, const QVector<Candle> &candles) {
+    if (candles.isEmpty()) {
+        return false;
+    }
+    Feed &feed = feedFor(feedKey);
+    bool merged = true;
+    if (!feed.seeded) {
+        // Stream ticks may have arrived before the seed page: keep the ones
+        // the page does not cover yet.
+        const QVector<Candle> streamed = feed.ring.view().toVector();
+        feed.ring.assign(CandleView::of(candles));
+        for (const Candle &candle : streamed) {
+            feed.ring.upsert(candle);
+        }
+        feed.seeded = true;
+    } else if (!feed.ring.isEmpty() && candles.constFirst().openTimeMs <= feed.ring.view().constLast().openTimeMs) {
+        for (const Candle &candle : candles) {
+            feed.ring.upsert(candle);
+        }
+    } else {
+        feed.ring.clear();
+        feed.seeded = false;
+        merged = false;
+    }
+    // A REST page ends with the forming candle; a newer streamed candle
+    // keeps its own flag.
+    if (merged && feed.ring.view().constLast().openTimeMs == candles.constLast().openTimeMs) {
+        feed.latestClosed = false;
+    }
+    feed.updatedAtMs = QDateTime::currentMSecsSinceEpoch();
+    if (merged) {
+        notify(feedKey);
+    }
+    return merged;
+}
+
+void Hub::update(const QString &feedKey, const Candle &candle, bool closed) {
+    Feed &feed = feedFor(feedKey);
+    if (!feed.ring.upsert(candle)) {
+        return;
+    }
+    feed.latestClosed = closed;
+    feed.updatedAtMs = QDateTime::currentMSecsSinceEpoch();
+    notify(feedKey);
+}
+
+Hub::Feed &Hub::feedFor(const QString &feedKey) {
+    auto it = feeds_.find(feedKey);
+    if (it == feeds_.end()) {
+        it = feeds_.insert(feedKey, Feed{CandleRing(capacity_)});
+    }
+    return it.value();
+}
+
+void Hub::notify(const QString &feedKey) {
+    // Copied: a consumer may attach or detach from its slot.
+    const auto it = feeds_.constFind(feedKey);
+    if (it == feeds_.cend()) {
+        return;
+    }
+    const QStringList consumers = it->consumers;
+    for (const QString &consumerKey : consumers) {
+        emit candlesUpdated(consumerKey, feedKey);
+    }
+}
+
+} // namespace NativeMarketDataHub
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "BinanceRestClient.h"
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Live candle state shared by every dashboard consumer of a market.
+//
+// One feed exists per (connector, market, symbol, interval). It is seeded
+// from REST once, then kept current by stream ticks or small incremental REST
+// pages, in a fixed-capacity ring buffer: a new candle overwrites the oldest
+// slot instead of shifting the whole history. Consumers (dashboard signal
+// keys) attach to a feed, are notified on every write, and read the candles
+// through a CandleView that points into the ring.
+namespace NativeMarketDataHub {
+
+using Candle = BinanceRestClient::KlineCandle;
+
+// Candles the dashboard runtime evaluates per signal.
+inline constexpr qsizetype kDefaultCapacity = 240;
+
+QString feedKey(const QString &connectorToken, bool futures, const QString &symbol, const QString &interval);
+
+// Read-only, oldest-first view of up to two contiguous runs of candles. A view
+// taken from the hub stays valid until its feed is next written or the hub is
+// cleared, so it must not be held across a nested event loop.
+class CandleView {
+public:
+    CandleView() = default;
+    CandleView(const Candle *head, qsizetype headSize, const Candle *tail = nullptr, qsizetype tailSize = 0);
+
+    static CandleView of(const QVector<Candle> &candles);
+
+    qsizetype size() const { return headSize_ + tailSize_; }
+    bool isEmpty() const { return size() == 0; }
+    const Candle &at(qsizetype index) const {
+        return index < headSize_ ? head_[index] : tail_[index - headSize_];
+    }
+    const Candle &constFirst() const { return at(0); }
+    const Candle &constLast() const { return at(size() - 1); }
+
+    // The oldest `count` candles.
+    CandleView first(qsizetype count) const;
+    QVector<Candle> toVector() const;
+
+private:
+    const Candle *head_ = nullptr;
+    qsizetype headSize_ = 0;
+    const Candle *tail_ = nullptr;
+    qsizetype tailSize_ = 0;
+};
+
+// Fixed-capacity candle history ordered by open time. Every write is O(1);
+// storage is allocated once and never moves.
+class CandleRing {
+public:
+    explicit CandleRing(qsizetype capacity = kDefaultCapacity);
+
+    qsizetype capacity() const { return slots_.size(); }
+    qsizetype size() const { return count_; }
+    bool isEmpty() const { return count_ == 0; }
+
+    void clear();
+    // Replaces the contents with the newest `capacity` candles.
+    void assign(const CandleView &candles);
+    // Replaces the latest candle when the open time matches, appends when it
+    // is newer (dropping the oldest once full) and ignores older candles.
+    // Returns false only for the ignored case.
+    bool upsert(const Candle &candle);
+
+    CandleView view() const;
+
+private:
+    QVector<Candle> slots_;
+    qsizetype start_ = 0;
+    qsizetype count_ = 0;
+};
+
+class Hub final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Hub(qsizetype capacity = kDefaultCapacity, QObject *parent = nullptr);
+
+    qsizetype capacity() const { return capacity_; }
+    int feedCount() const { return feeds_.size(); }
+    void clear();
+
+    // A consumer follows one feed at a time; attaching again moves it.
+    void attach(const QString &consumerKey, const QString &feedKey);
+    void detach(const QString &consumerKey);
+    QString feedOf(const QString &consumerKey) const { return consumerFeeds_.value(consumerKey); }
+    QStringList consumersOf(const QString &feedKey) const;
+
+    bool contains(const QString &feedKey) const { return feeds_.contains(feedKey); }
+    bool isSeeded(const QString &feedKey) const;
+    CandleView view(const QString &feedKey) const;
+    bool latestClosed(const QString &feedKey) const;
+    qint64 updatedAtMs(const QString &feedKey) const;
+
+    // Candles a REST refresh of the feed should request: the full capacity
+    // until it is seeded, afterwards its latest candle, the bars opened since
+    // and one spare.
+    int fetchLimit(const QString &feedKey, qint64 intervalMs, qint64 nowMs) const;
+
+    // Applies a REST page. An unseeded feed is seeded from it, keeping any
+    // newer candles a stream delivered meanwhile. A seeded feed merges the
+    // page, which must overlap its latest candle; otherwise the feed is
+    // emptied so the next refresh reseeds it, and false is returned.
+    bool ingest(const QString &feedKey, const QVector<Candle> &candles);
+    // Applies a stream tick.
+    void update(const QString &feedKey, const Candle &candle, bool closed);
+
+signals:
+    // Emitted once per attached consumer after every write to its feed.
+    void candlesUpdated(const QString &consumerKey, const QString &feedKey);
+
+private:
+    struct Feed {
+        CandleRing ring;
+        bool seeded = false;
+        bool latestClosed = false;
+        qint64 updatedAtMs = 0;
+        QStringList consumers;
+    };
+
+    Feed &feedFor(const QString &feedKey);
+    void notify(const QString &feedKey);
+
+    qsizetype capacity_;
+    QHash<QString, Feed> feeds_;
+    QHash<QString, QString> consumerFeeds_;
+};
+
+} // namespace NativeMarketDataHub
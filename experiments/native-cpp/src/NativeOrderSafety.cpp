@@ -11,8 +11,22 @@
 
 #include "generated/PythonParityContract.h"
 
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -20,6 +34,8 @@ constexpr int kDefaultOrderAuditMaxBytes = 10 * 1024 * 1024;
 constexpr int kDefaultOrderAuditBackupCount = 1;
 constexpr int kMaxLiveSessionOrders = 100000;
 constexpr int kBinanceMaxFuturesLeverage = 125;
+// Written by appendOrderAuditEvent callers and the audit writer thread.
+std::mutex gOrderAuditStatusMutex;
 QJsonObject gOrderAuditStatus;
 
 QString normalizedKey(QString value) {
@@ -188,6 +204,55 @@ NativeOrderSafety::OrderAuditLogConfig sanitizedOrderAuditConfig(
     return config;
 }
 
+QJsonObject publishOrderAuditStatus(QJsonObject status) {
+    std::lock_guard guard(gOrderAuditStatusMutex);
+    gOrderAuditStatus = status;
+    return status;
+}
+
+// Shifts path to .1, .1 to .2 and so on, dropping the oldest backup; with no
+// backups the log is removed. error is set when a step failed.
+bool rotateOrderAuditFiles(const QString &path, int backupCount, QString *error) {
+    if (backupCount == 0) {
+        if (!QFile::remove(path)) {
+            if (error) {
+                *error = QStringLiteral("Could not remove %1 before order audit rotation.").arg(path);
+            }
+        }
+        return true;
+    }
+
+    QDir parent = QFileInfo(path).dir();
+    if (!parent.exists() && !parent.mkpath(QStringLiteral("."))) {
+        if (error) {
+            *error = QStringLiteral("Could not create order audit directory %1.").arg(parent.absolutePath());
+        }
+        return false;
+    }
+
+    for (int index = backupCount; index >= 1; --index) {
+        const QString source = index == 1 ? path : NativeOrderSafety::orderAuditBackupPath(path, index - 1);
+        const QString target = NativeOrderSafety::orderAuditBackupPath(path, index);
+        if (!QFileInfo::exists(source)) {
+            continue;
+        }
+        if (QFileInfo::exists(target) && !QFile::remove(target)) {
+            if (error) {
+                *error = QStringLiteral("Could not remove stale order audit backup %1.").arg(target);
+            }
+            return false;
+        }
+        QFile sourceFile(source);
+        if (!sourceFile.rename(target)) {
+            if (error) {
+                *error = QStringLiteral("Could not rotate order audit log %1 to %2.").arg(source, target);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 QJsonObject compactObject(QJsonObject object) {
     for (auto it = object.begin(); it != object.end();) {
         const QJsonValue value = it.value();
@@ -767,6 +832,12 @@ OrderAuditLogConfig orderAuditLogConfigFromEnvironment() {
     const QString configuredPath = envValue("BOT_ORDER_AUDIT_LOG_PATH");
     const QString legacyPath = envValue("BOT_ORDER_AUDIT_LOG");
     config.path = configuredPath.isEmpty() ? legacyPath : configuredPath;
+    const QString syncPolicy = envValue("BOT_ORDER_AUDIT_FSYNC").toLower();
+    if (syncPolicy == QStringLiteral("none") || syncPolicy == QStringLiteral("off")) {
+        config.syncPolicy = OrderAuditSyncPolicy::None;
+    } else if (syncPolicy == QStringLiteral("event") || syncPolicy == QStringLiteral("always")) {
+        config.syncPolicy = OrderAuditSyncPolicy::EveryEvent;
+    }
     return sanitizedOrderAuditConfig(config);
 }
 
@@ -793,54 +864,427 @@ bool rotateOrderAuditLogIfNeeded(
         return false;
     }
 
-    if (backupCount == 0) {
-        if (!QFile::remove(path)) {
-            if (error) {
-                *error = QStringLiteral("Could not remove %1 before order audit rotation.").arg(path);
+    return rotateOrderAuditFiles(path, backupCount, error);
+}
+
+namespace {
+
+static_assert((kOrderAuditQueueCapacity & (kOrderAuditQueueCapacity - 1)) == 0,
+              "the audit queue indexes cells with a mask");
+
+// Events the writer pops before committing them as one batch.
+constexpr int kOrderAuditBatchLimit = 512;
+// How often a log that failed to write is retried while no new events
+// arrive.
+constexpr int kOrderAuditRetryMs = 250;
+
+struct QueuedOrderAuditEvent {
+    QJsonObject event;
+    OrderAuditLogConfig config;
+};
+
+// Bounded multi-producer ring (sequence-numbered cells): producers claim a
+// slot with one compare-and-swap and never wait on each other or on the
+// writer, which is the only consumer.
+class OrderAuditQueue {
+public:
+    OrderAuditQueue()
+        : cells_(kOrderAuditQueueCapacity) {
+        for (quint64 index = 0; index < cells_.size(); ++index) {
+            cells_[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(QueuedOrderAuditEvent &&item) {
+        quint64 position = enqueuePosition_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[position & kMask];
+            const quint64 sequence = cell.sequence.load(std::memory_order_acquire);
+            const qint64 lag = static_cast<qint64>(sequence - position);
+            if (lag == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.item = std::move(item);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
             }
         }
-        return true;
     }
 
-    QDir parent = currentInfo.dir();
-    if (!parent.exists() && !parent.mkpath(QStringLiteral("."))) {
-        if (error) {
-            *error = QStringLiteral("Could not create order audit directory %1.").arg(parent.absolutePath());
+    bool tryPop(QueuedOrderAuditEvent &item) {
+        const quint64 position = dequeuePosition_.load(std::memory_order_relaxed);
+        Cell &cell = cells_[position & kMask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
         }
+        item = std::move(cell.item);
+        cell.item = {};
+        cell.sequence.store(position + kOrderAuditQueueCapacity, std::memory_order_release);
+        dequeuePosition_.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Events claimed by producers so far, including ones still being stored.
+    quint64 pushed() const {
+        return enqueuePosition_.load(std::memory_order_acquire);
+    }
+
+    quint64 depth() const {
+        const quint64 popped = dequeuePosition_.load(std::memory_order_acquire);
+        return pushed() - std::min(popped, pushed());
+    }
+
+private:
+    static constexpr quint64 kMask = kOrderAuditQueueCapacity - 1;
+
+    struct Cell {
+        std::atomic<quint64> sequence{0};
+        QueuedOrderAuditEvent item;
+    };
+
+    std::vector<Cell> cells_;
+    alignas(64) std::atomic<quint64> enqueuePosition_{0};
+    alignas(64) std::atomic<quint64> dequeuePosition_{0};
+};
+
+bool syncToDisk(QFile &file) {
+    if (!file.flush()) {
         return false;
     }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
 
-    for (int index = backupCount; index >= 1; --index) {
-        const QString source = index == 1 ? path : orderAuditBackupPath(path, index - 1);
-        const QString target = orderAuditBackupPath(path, index);
-        if (!QFileInfo::exists(source)) {
-            continue;
+// Owns the writer thread, started by the first enqueued event. It keeps each
+// log open, tracks its size in memory so rotation needs no stat calls, and
+// turns every drained batch into one write per log.
+class OrderAuditWriter {
+public:
+    static OrderAuditWriter &instance() {
+        // Events are redacted on the writer thread. Building redactText's
+        // pattern statics first keeps them alive until the writer has
+        // drained and stopped at exit.
+        static OrderAuditWriter &writer = []() -> OrderAuditWriter & {
+            redactText(QStringLiteral("order audit"));
+            static OrderAuditWriter instance;
+            return instance;
+        }();
+        return writer;
+    }
+
+    ~OrderAuditWriter() {
+        if (thread_.joinable()) {
+            thread_.request_stop();
+            wake();
         }
-        if (QFileInfo::exists(target) && !QFile::remove(target)) {
-            if (error) {
-                *error = QStringLiteral("Could not remove stale order audit backup %1.").arg(target);
+    }
+
+    bool enqueue(QueuedOrderAuditEvent &&item) {
+        std::call_once(started_, [this]() {
+            thread_ = std::jthread([this](std::stop_token stop) { run(stop); });
+        });
+        if (!queue_.tryPush(std::move(item))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        wake();
+        return true;
+    }
+
+    bool flush(int timeoutMs) {
+        const quint64 target = queue_.pushed();
+        std::unique_lock lock(commitMutex_);
+        const bool settled =
+            committedChanged_.wait_for(lock, std::chrono::milliseconds(std::max(0, timeoutMs)), [&]() {
+                return committed_ + lost_ >= target;
+            });
+        return settled && lost_ == 0;
+    }
+
+    quint64 depth() const {
+        return queue_.depth();
+    }
+
+    quint64 dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    quint64 lost() {
+        std::lock_guard guard(commitMutex_);
+        return lost_;
+    }
+
+private:
+    struct OpenLog {
+        std::unique_ptr<QFile> file;
+        quint64 size = 0;
+        // Lines not yet handed to the file; kept across failed writes.
+        QByteArray pending;
+        // Events in pending, or written but not yet synced.
+        quint64 events = 0;
+        OrderAuditLogConfig config;
+        QString error;
+        bool touched = false;
+    };
+
+    OrderAuditWriter() = default;
+
+    void wake() {
+        wakeups_.fetch_add(1, std::memory_order_release);
+        wakeups_.notify_one();
+        retryWake_.notify_one();
+    }
+
+    void run(std::stop_token stop) {
+        for (;;) {
+            const quint64 seen = wakeups_.load(std::memory_order_acquire);
+            if (commitBatch()) {
+                continue;
             }
+            if (stop.stop_requested()) {
+                break;
+            }
+            if (hasUncommitted()) {
+                std::unique_lock lock(retryMutex_);
+                retryWake_.wait_for(lock, stop, std::chrono::milliseconds(kOrderAuditRetryMs), [&]() {
+                    return wakeups_.load(std::memory_order_acquire) != seen;
+                });
+                lock.unlock();
+                retryUncommitted();
+                continue;
+            }
+            wakeups_.wait(seen, std::memory_order_acquire);
+        }
+        // One last attempt; whatever still cannot be written is lost.
+        retryUncommitted();
+        quint64 lost = 0;
+        for (const auto &entry : logs_) {
+            lost += entry.second.events;
+        }
+        logs_.clear();
+        markLost(lost);
+    }
+
+    bool hasUncommitted() const {
+        return std::any_of(logs_.cbegin(), logs_.cend(), [](const auto &entry) {
+            return entry.second.events > 0;
+        });
+    }
+
+    void markCommitted(OpenLog &log) {
+        if (log.events == 0) {
+            return;
+        }
+        {
+            std::lock_guard guard(commitMutex_);
+            committed_ += log.events;
+        }
+        log.events = 0;
+        committedChanged_.notify_all();
+    }
+
+    void markLost(quint64 count) {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard guard(commitMutex_);
+            lost_ += count;
+        }
+        committedChanged_.notify_all();
+    }
+
+    bool open(const QString &path, OpenLog &log) {
+        if (log.file) {
+            return true;
+        }
+        const QDir parent = QFileInfo(path).dir();
+        if (!parent.exists() && !parent.mkpath(QStringLiteral("."))) {
+            log.error = QStringLiteral("Could not create order audit directory %1.").arg(parent.absolutePath());
             return false;
         }
-        QFile sourceFile(source);
-        if (!sourceFile.rename(target)) {
-            if (error) {
-                *error = QStringLiteral("Could not rotate order audit log %1 to %2.").arg(source, target);
+        auto file = std::make_unique<QFile>(path);
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            log.error = file->errorString();
+            return false;
+        }
+        log.size = static_cast<quint64>(std::max<qint64>(0, file->size()));
+        log.file = std::move(file);
+        return true;
+    }
+
+    // Writes what is pending for the log and counts its events committed
+    // once they are synced (or flushed, without sync). On failure the
+    // unwritten bytes stay pending and the file is closed, so the next
+    // attempt reopens it and writes them again.
+    bool write(const QString &path, OpenLog &log, bool sync) {
+        if (log.pending.isEmpty() && log.events == 0) {
+            return true;
+        }
+        if (!open(path, log)) {
+            return false;
+        }
+        const qint64 written = log.file->write(log.pending);
+        bool ok = written == log.pending.size();
+        if (!ok) {
+            log.error = QStringLiteral("Order audit write was incomplete.");
+        } else if (!(sync ? syncToDisk(*log.file) : log.file->flush())) {
+            ok = false;
+            log.error = QStringLiteral("Could not sync order audit log: %1").arg(log.file->errorString());
+        }
+        if (written > 0) {
+            log.size += static_cast<quint64>(written);
+            log.pending.remove(0, written);
+        }
+        if (!ok) {
+            log.file.reset();
+            return false;
+        }
+        markCommitted(log);
+        return true;
+    }
+
+    // Bounds what a log that keeps failing holds on to: its oldest lines
+    // beyond the queue capacity are given up and counted lost.
+    void trimUncommitted(OpenLog &log) {
+        quint64 lost = 0;
+        while (log.events > static_cast<quint64>(kOrderAuditQueueCapacity)) {
+            const qsizetype end = log.pending.indexOf('\n');
+            if (end < 0) {
+                break;
+            }
+            log.pending.remove(0, end + 1);
+            --log.events;
+            ++lost;
+        }
+        markLost(lost);
+    }
+
+    void append(const QueuedOrderAuditEvent &item) {
+        const OrderAuditLogConfig &config = item.config;
+        OpenLog &log = logs_[config.path];
+        log.config = config;
+        log.touched = true;
+        const QByteArray line = (orderAuditEventJsonLine(item.event) + QStringLiteral("\n")).toUtf8();
+        // Rotates only once everything before the line is on disk; a log
+        // that cannot be written keeps growing pending until it can.
+        if (open(config.path, log)) {
+            const quint64 current = log.size + static_cast<quint64>(log.pending.size());
+            if (current > 0 && current + static_cast<quint64>(line.size()) > config.maxBytes
+                && write(config.path, log, config.syncPolicy != OrderAuditSyncPolicy::None)) {
+                log.file.reset();
+                QString rotationError;
+                rotateOrderAuditFiles(config.path, config.backupCount, &rotationError);
+                if (!rotationError.isEmpty()) {
+                    log.error = rotationError;
+                }
+                open(config.path, log);
+            }
+        }
+        log.pending += line;
+        ++log.events;
+        if (config.syncPolicy == OrderAuditSyncPolicy::EveryEvent) {
+            write(config.path, log, true);
+        }
+        trimUncommitted(log);
+    }
+
+    // Writes the lines failed logs still hold while no new batch arrives.
+    void retryUncommitted() {
+        const QString now = currentIso(QDateTime::currentDateTimeUtc());
+        for (auto &[path, log] : logs_) {
+            if (log.events == 0) {
+                continue;
             }
+            write(path, log, log.config.syncPolicy != OrderAuditSyncPolicy::None);
+            publishOrderAuditStatus(log.error.isEmpty()
+                    ? buildOrderAuditStatus(true, path, log.config.maxBytes, log.config.backupCount, {}, {}, now)
+                    : buildOrderAuditStatus(true, path, log.config.maxBytes, log.config.backupCount, log.error, now));
+            log.error.clear();
+        }
+    }
+
+    bool commitBatch() {
+        QueuedOrderAuditEvent item;
+        QString lastPath;
+        int count = 0;
+        while (count < kOrderAuditBatchLimit && queue_.tryPop(item)) {
+            append(item);
+            lastPath = item.config.path;
+            ++count;
+        }
+        if (count == 0) {
             return false;
         }
+
+        const QString now = currentIso(QDateTime::currentDateTimeUtc());
+        QJsonObject lastStatus;
+        for (auto it = logs_.begin(); it != logs_.end();) {
+            OpenLog &log = it->second;
+            if (!log.touched && log.events == 0) {
+                // Idle since the previous batch: release the handle.
+                it = logs_.erase(it);
+                continue;
+            }
+            write(it->first, log, log.config.syncPolicy != OrderAuditSyncPolicy::None);
+            const QJsonObject status = log.error.isEmpty()
+                ? buildOrderAuditStatus(true, it->first, log.config.maxBytes, log.config.backupCount, {}, {}, now)
+                : buildOrderAuditStatus(true, it->first, log.config.maxBytes, log.config.backupCount, log.error, now);
+            if (it->first == lastPath) {
+                lastStatus = status;
+            } else {
+                publishOrderAuditStatus(status);
+            }
+            log.error.clear();
+            log.touched = false;
+            ++it;
+        }
+        publishOrderAuditStatus(lastStatus);
+        return true;
     }
-    return true;
+
+    OrderAuditQueue queue_;
+    std::atomic<quint64> wakeups_{0};
+    std::atomic<quint64> dropped_{0};
+    std::mutex commitMutex_;
+    std::condition_variable committedChanged_;
+    // Events written and synced, and events given up on.
+    quint64 committed_ = 0;
+    quint64 lost_ = 0;
+    std::mutex retryMutex_;
+    std::condition_variable_any retryWake_;
+    // Writer thread only.
+    std::map<QString, OpenLog> logs_;
+    std::once_flag started_;
+    // Last, so it is joined before the members it uses go away.
+    std::jthread thread_;
+};
+
+QJsonObject withOrderAuditQueue(QJsonObject status) {
+    OrderAuditWriter &writer = OrderAuditWriter::instance();
+    status.insert(QStringLiteral("queue_depth"), static_cast<qint64>(writer.depth()));
+    status.insert(QStringLiteral("queue_capacity"), kOrderAuditQueueCapacity);
+    status.insert(QStringLiteral("dropped_events"), static_cast<qint64>(writer.dropped()));
+    status.insert(QStringLiteral("failed_events"), static_cast<qint64>(writer.lost()));
+    return status;
 }
 
+} // namespace
+
 QJsonObject appendOrderAuditEvent(
     const QJsonObject &event,
     const OrderAuditLogConfig &config) {
     const OrderAuditLogConfig safeConfig = sanitizedOrderAuditConfig(config);
     const QString path = safeConfig.path;
     if (!safeConfig.enabled) {
-        gOrderAuditStatus = buildOrderAuditStatus(false, path, safeConfig.maxBytes, safeConfig.backupCount);
-        return gOrderAuditStatus;
+        return publishOrderAuditStatus(buildOrderAuditStatus(false, path, safeConfig.maxBytes, safeConfig.backupCount));
     }
 
     const QString line = orderAuditEventJsonLine(event) + QStringLiteral("\n");
@@ -849,14 +1293,13 @@ QJsonObject appendOrderAuditEvent(
     QDir parent = info.dir();
     const QString now = currentIso(QDateTime::currentDateTimeUtc());
     if (!parent.exists() && !parent.mkpath(QStringLiteral("."))) {
-        gOrderAuditStatus = buildOrderAuditStatus(
+        return publishOrderAuditStatus(buildOrderAuditStatus(
             true,
             path,
             safeConfig.maxBytes,
             safeConfig.backupCount,
             QStringLiteral("Could not create order audit directory %1.").arg(parent.absolutePath()),
-            now);
-        return gOrderAuditStatus;
+            now));
     }
 
     QString rotationError;
@@ -867,63 +1310,88 @@ QJsonObject appendOrderAuditEvent(
             safeConfig.backupCount,
             &rotationError)
         && !rotationError.isEmpty()) {
-        gOrderAuditStatus = buildOrderAuditStatus(
+        return publishOrderAuditStatus(buildOrderAuditStatus(
             true,
             path,
             safeConfig.maxBytes,
             safeConfig.backupCount,
             rotationError,
-            now);
-        return gOrderAuditStatus;
+            now));
     }
 
     QFile file(path);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        gOrderAuditStatus = buildOrderAuditStatus(
+        return publishOrderAuditStatus(buildOrderAuditStatus(
             true,
             path,
             safeConfig.maxBytes,
             safeConfig.backupCount,
             file.errorString(),
-            now);
-        return gOrderAuditStatus;
+            now));
     }
     const qint64 written = file.write(encoded);
     file.close();
     if (written != encoded.size()) {
-        gOrderAuditStatus = buildOrderAuditStatus(
+        return publishOrderAuditStatus(buildOrderAuditStatus(
             true,
             path,
             safeConfig.maxBytes,
             safeConfig.backupCount,
             QStringLiteral("Order audit write was incomplete."),
-            now);
-        return gOrderAuditStatus;
+            now));
     }
 
-    gOrderAuditStatus = buildOrderAuditStatus(
+    return publishOrderAuditStatus(buildOrderAuditStatus(
         true,
         path,
         safeConfig.maxBytes,
         safeConfig.backupCount,
         {},
         {},
-        now);
-    return gOrderAuditStatus;
+        now));
+}
+
+QJsonObject enqueueOrderAuditEvent(
+    const QJsonObject &event,
+    const OrderAuditLogConfig &config) {
+    const OrderAuditLogConfig safeConfig = sanitizedOrderAuditConfig(config);
+    if (!safeConfig.enabled) {
+        return withOrderAuditQueue(publishOrderAuditStatus(
+            buildOrderAuditStatus(false, safeConfig.path, safeConfig.maxBytes, safeConfig.backupCount)));
+    }
+    if (!OrderAuditWriter::instance().enqueue({event, safeConfig})) {
+        return withOrderAuditQueue(publishOrderAuditStatus(buildOrderAuditStatus(
+            true,
+            safeConfig.path,
+            safeConfig.maxBytes,
+            safeConfig.backupCount,
+            QStringLiteral("Order audit queue is full; the event was dropped."),
+            currentIso(QDateTime::currentDateTimeUtc()))));
+    }
+    return currentOrderAuditStatus(safeConfig);
+}
+
+bool flushOrderAuditLog(int timeoutMs) {
+    return OrderAuditWriter::instance().flush(timeoutMs);
 }
 
 QJsonObject currentOrderAuditStatus(const OrderAuditLogConfig &config) {
     const OrderAuditLogConfig safeConfig = sanitizedOrderAuditConfig(config);
     const QString configuredPath = QDir::cleanPath(safeConfig.path);
-    const QString lastPath = QDir::cleanPath(gOrderAuditStatus.value(QStringLiteral("path")).toString());
-    if (!gOrderAuditStatus.isEmpty() && (lastPath.isEmpty() || lastPath == configuredPath)) {
-        return gOrderAuditStatus;
+    QJsonObject lastStatus;
+    {
+        std::lock_guard guard(gOrderAuditStatusMutex);
+        lastStatus = gOrderAuditStatus;
+    }
+    const QString lastPath = QDir::cleanPath(lastStatus.value(QStringLiteral("path")).toString());
+    if (!lastStatus.isEmpty() && (lastPath.isEmpty() || lastPath == configuredPath)) {
+        return withOrderAuditQueue(lastStatus);
     }
-    return buildOrderAuditStatus(
+    return withOrderAuditQueue(buildOrderAuditStatus(
         safeConfig.enabled,
         safeConfig.path,
         safeConfig.maxBytes,
-        safeConfig.backupCount);
+        safeConfig.backupCount));
 }
 
 namespace {
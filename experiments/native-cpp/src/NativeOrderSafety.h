@@ -90,13 +90,31 @@ struct MinimumOrderAutoBumpGuardResult {
     QStringList errors;
 };
 
+// When the asynchronous writer forces written events to disk. Whatever the
+// policy, events still in the queue are lost if the process dies, and a
+// crash mid-write can leave a truncated last line, which readers skip.
+enum class OrderAuditSyncPolicy {
+    // Handed to the OS after every batch: survives a process crash, not a
+    // power loss.
+    None,
+    // One fsync per batch the writer drains (group commit).
+    Batch,
+    // One fsync per event.
+    EveryEvent,
+};
+
 struct OrderAuditLogConfig {
     bool enabled = true;
     QString path;
     quint64 maxBytes = 10 * 1024 * 1024;
     int backupCount = 1;
+    // Used by enqueueOrderAuditEvent only.
+    OrderAuditSyncPolicy syncPolicy = OrderAuditSyncPolicy::Batch;
 };
 
+// Events enqueueOrderAuditEvent can hold before the writer catches up.
+inline constexpr int kOrderAuditQueueCapacity = 4096;
+
 struct ConnectorOrderCircuitConfig {
     bool enabled = true;
     int blockThreshold = 2;
@@ -217,6 +235,22 @@ bool rotateOrderAuditLogIfNeeded(
 QJsonObject appendOrderAuditEvent(
     const QJsonObject &event,
     const OrderAuditLogConfig &config = {});
+// Hands the event to the audit writer thread and returns without touching
+// the disk. The writer keeps each log open, tracks its size in memory,
+// rotates by that size and commits every drained batch with one write and
+// the config's sync policy. A full queue drops the event and reports
+// write_failed until the writer next commits, so live order guards stop
+// new submissions meanwhile.
+QJsonObject enqueueOrderAuditEvent(
+    const QJsonObject &event,
+    const OrderAuditLogConfig &config = {});
+// Waits until every event enqueued before the call has been written and
+// synced. A log that fails to write keeps its lines and retries them, so
+// this returns false on timeout while it is failing, and from then on once
+// the writer has given up on any event.
+bool flushOrderAuditLog(int timeoutMs = 5'000);
+// Includes queue_depth, queue_capacity, dropped_events and failed_events
+// (events given up on unwritten) for the writer.
 QJsonObject currentOrderAuditStatus(const OrderAuditLogConfig &config = {});
 
 QJsonObject buildOperationalPreflightSnapshot(const OperationalPreflightInput &input);
@@ -0,0 +1,277 @@
+#include "NativePriceStream.h"
+
+#include "BinanceWsClient.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+bool validPrice(double price) {
+    return std::isfinite(price) && price > 0.0;
+}
+
+bool fresh(qint64 updatedMs, qint64 nowMs, qint64 maxAgeMs) {
+    return updatedMs > 0 && nowMs - updatedMs <= maxAgeMs;
+}
+
+QString markSubscriptionKey(const QString &symbol) {
+    return QStringLiteral("mark|") + symbol;
+}
+
+QString bookSubscriptionKey(const QString &symbol) {
+    return QStringLiteral("book|") + symbol;
+}
+
+} // namespace
+
+namespace NativePriceStream {
+
+PriceTable::PriceTable()
+    : slots_(std::make_unique<Slot[]>(NativeSymbolTable::kMaxSymbols)) {}
+
+PriceTable::Slot *PriceTable::slot(SymbolId id) const {
+    return id < static_cast<SymbolId>(NativeSymbolTable::kMaxSymbols) ? &slots_[id] : nullptr;
+}
+
+void PriceTable::updateMark(SymbolId id, double markPrice, qint64 nowMs) {
+    Slot *target = slot(id);
+    if (!target || !validPrice(markPrice)) {
+        return;
+    }
+    const quint32 sequence = target->sequence.load(std::memory_order_relaxed);
+    target->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    target->markPrice.store(markPrice, std::memory_order_relaxed);
+    target->markUpdatedMs.store(nowMs, std::memory_order_relaxed);
+    target->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PriceTable::updateBook(SymbolId id, double bidPrice, double askPrice, qint64 nowMs) {
+    Slot *target = slot(id);
+    if (!target || !validPrice(bidPrice) || !validPrice(askPrice)) {
+        return;
+    }
+    const quint32 sequence = target->sequence.load(std::memory_order_relaxed);
+    target->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    target->bidPrice.store(bidPrice, std::memory_order_relaxed);
+    target->askPrice.store(askPrice, std::memory_order_relaxed);
+    target->bookUpdatedMs.store(nowMs, std::memory_order_relaxed);
+    target->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PriceTable::clear(SymbolId id) {
+    Slot *target = slot(id);
+    if (!target) {
+        return;
+    }
+    const quint32 sequence = target->sequence.load(std::memory_order_relaxed);
+    target->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    target->markPrice.store(0.0, std::memory_order_relaxed);
+    target->bidPrice.store(0.0, std::memory_order_relaxed);
+    target->askPrice.store(0.0, std::memory_order_relaxed);
+    target->markUpdatedMs.store(0, std::memory_order_relaxed);
+    target->bookUpdatedMs.store(0, std::memory_order_relaxed);
+    target->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+Quote PriceTable::quote(SymbolId id) const {
+    const Slot *source = slot(id);
+    if (!source) {
+        return {};
+    }
+    Quote copy;
+    for (;;) {
+        const quint32 before = source->sequence.load(std::memory_order_acquire);
+        if (before & 1U) {
+            continue;
+        }
+        copy.markPrice = source->markPrice.load(std::memory_order_relaxed);
+        copy.bidPrice = source->bidPrice.load(std::memory_order_relaxed);
+        copy.askPrice = source->askPrice.load(std::memory_order_relaxed);
+        copy.markUpdatedMs = source->markUpdatedMs.load(std::memory_order_relaxed);
+        copy.bookUpdatedMs = source->bookUpdatedMs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (source->sequence.load(std::memory_order_relaxed) == before) {
+            return copy;
+        }
+    }
+}
+
+double PriceTable::markPrice(SymbolId id, qint64 nowMs, qint64 maxAgeMs) const {
+    const Quote current = quote(id);
+    if (fresh(current.markUpdatedMs, nowMs, maxAgeMs)) {
+        return current.markPrice;
+    }
+    if (fresh(current.bookUpdatedMs, nowMs, maxAgeMs)) {
+        return (current.bidPrice + current.askPrice) / 2.0;
+    }
+    return 0.0;
+}
+
+double PriceTable::executionPrice(SymbolId id, bool buy, qint64 nowMs, qint64 maxAgeMs) const {
+    const Quote current = quote(id);
+    if (fresh(current.bookUpdatedMs, nowMs, maxAgeMs)) {
+        return buy ? current.askPrice : current.bidPrice;
+    }
+    return fresh(current.markUpdatedMs, nowMs, maxAgeMs) ? current.markPrice : 0.0;
+}
+
+bool stopLossTriggered(
+    const StopLossRule &rule,
+    bool isLong,
+    double entryPrice,
+    double quantity,
+    double marginUsdt,
+    double price) {
+    if (!rule.enabled || !validPrice(entryPrice) || !validPrice(price) || !(quantity > 0.0)) {
+        return false;
+    }
+    return NativeStopLoss::reached(
+        rule.limits,
+        NativeStopLoss::positionLoss(isLong, entryPrice, price, quantity),
+        marginUsdt,
+        entryPrice * quantity);
+}
+
+bool StopLossWatch::enforced() const {
+    return rule_.enabled && rule_.limits.scope == NativeStopLoss::Scope::PerTrade;
+}
+
+void StopLossWatch::watch(SymbolId id, const QString &key) {
+    QStringList &keys = watched_[id];
+    if (!keys.contains(key)) {
+        keys.append(key);
+    }
+}
+
+bool StopLossWatch::flag(const QString &key, const Position &position, double price) {
+    if (!enforced() || closing_.contains(key)
+        || !stopLossTriggered(
+            rule_, position.isLong, position.entryPrice, position.quantity, position.marginUsdt, price)) {
+        return false;
+    }
+    closing_.insert(key);
+    return true;
+}
+
+QStringList StopLossWatch::flagMark(SymbolId id, double markPrice, const PositionLookup &lookup) {
+    QStringList flagged;
+    const auto it = watched_.constFind(id);
+    if (!enforced() || it == watched_.cend()) {
+        return flagged;
+    }
+    for (const QString &key : it.value()) {
+        Position position;
+        if (lookup(key, &position) && flag(key, position, markPrice)) {
+            flagged.append(key);
+        }
+    }
+    return flagged;
+}
+
+void StopLossWatch::clear() {
+    watched_.clear();
+    closing_.clear();
+}
+
+Service::Service(QObject *parent)
+    : QObject(parent),
+      client_(new BinanceWsClient(this)) {
+    // Ids were interned by setSymbols, so each frame arrives already
+    // resolved and nothing here touches a string.
+    connect(client_, &BinanceWsClient::subscriptionTick, this,
+            [this](const QString &, const BinanceWsClient::Tick &tick) {
+                if (tick.symbolId == NativeSymbolTable::kInvalidSymbol) {
+                    return;
+                }
+                // Receive time, not the exchange's E: staleness is judged
+                // against the local clock.
+                const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+                if (tick.type == BinanceWsClient::Tick::Type::MarkPrice) {
+                    table_.updateMark(tick.symbolId, tick.markPrice, nowMs);
+                    emit priceUpdated(tick.symbolId);
+                    emit markUpdated(tick.symbolId);
+                } else if (tick.type == BinanceWsClient::Tick::Type::BookTicker) {
+                    table_.updateBook(tick.symbolId, tick.bidPrice, tick.askPrice, nowMs);
+                    emit priceUpdated(tick.symbolId);
+                }
+            }, Qt::DirectConnection);
+    connect(client_, &BinanceWsClient::subscriptionError, this,
+            [this](const QString &key, const QString &message) {
+                emit errorOccurred(QStringLiteral("%1: %2").arg(key.section(QLatin1Char('|'), 1), message));
+            });
+    connect(client_, &BinanceWsClient::errorOccurred, this, &Service::errorOccurred);
+}
+
+Service::~Service() = default;
+
+void Service::setMarket(bool futures, bool testnet) {
+    if (futures == futures_ && testnet == testnet_) {
+        return;
+    }
+    const QStringList followed = symbols();
+    stop();
+    futures_ = futures;
+    testnet_ = testnet;
+    setSymbols(followed);
+}
+
+bool Service::setSymbols(const QStringList &symbols) {
+    QHash<QString, SymbolId> wanted;
+    for (const QString &symbol : symbols) {
+        const QString canonical = symbol.trimmed().toUpper();
+        if (!canonical.isEmpty() && !wanted.contains(canonical)) {
+            wanted.insert(canonical, NativeSymbolTable::intern(canonical));
+        }
+    }
+    for (auto it = symbols_.cbegin(); it != symbols_.cend(); ++it) {
+        if (wanted.contains(it.key())) {
+            continue;
+        }
+        client_->unsubscribe(markSubscriptionKey(it.key()));
+        client_->unsubscribe(bookSubscriptionKey(it.key()));
+        table_.clear(it.value());
+    }
+    bool ok = true;
+    for (auto it = wanted.cbegin(); it != wanted.cend(); ++it) {
+        const QString &symbol = it.key();
+        if (symbols_.contains(symbol)) {
+            continue;
+        }
+        if (futures_) {
+            ok = client_->subscribe(
+                     markSubscriptionKey(symbol), BinanceWsClient::markPriceStreamName(symbol), futures_, testnet_)
+                && ok;
+        }
+        ok = client_->subscribe(
+                 bookSubscriptionKey(symbol), BinanceWsClient::bookTickerStreamName(symbol), futures_, testnet_)
+            && ok;
+    }
+    symbols_ = wanted;
+    return ok;
+}
+
+QStringList Service::symbols() const {
+    QStringList sorted = symbols_.keys();
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+void Service::stop() {
+    client_->unsubscribeAll();
+    for (const SymbolId id : std::as_const(symbols_)) {
+        table_.clear(id);
+    }
+    symbols_.clear();
+}
+
+void Service::setCombinedStreamBaseUrlOverride(const QString &baseUrl) {
+    client_->setCombinedStreamBaseUrlOverride(baseUrl);
+}
+
+} // namespace NativePriceStream
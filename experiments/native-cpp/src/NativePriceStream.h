@@ -0,0 +1,175 @@
+#pragma once
+
+#include "NativeStopLoss.h"
+#include "NativeSymbolTable.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class BinanceWsClient;
+
+// Streamed latest prices: markPrice@1s and bookTicker per followed symbol,
+// folded into a table indexed by NativeSymbolTable id. PnL, stop-loss and
+// order sizing read a symbol's prices in O(1) instead of polling
+// /ticker/price every cycle.
+namespace NativePriceStream {
+
+using NativeSymbolTable::SymbolId;
+
+// Prices older than this are treated as missing.
+inline constexpr qint64 kDefaultMaxAgeMs = 5000;
+
+struct Quote {
+    double markPrice = 0.0;
+    double bidPrice = 0.0;
+    double askPrice = 0.0;
+    // Local receive times; 0 until the first update.
+    qint64 markUpdatedMs = 0;
+    qint64 bookUpdatedMs = 0;
+};
+
+// Latest quote per symbol id, in arrays sized for kMaxSymbols up front.
+// One thread writes; any thread reads without locking. Each slot carries a
+// sequence counter that is odd while a write is in progress, and readers
+// retry until they see the same even value before and after copying it.
+class PriceTable {
+public:
+    PriceTable();
+
+    void updateMark(SymbolId id, double markPrice, qint64 nowMs);
+    void updateBook(SymbolId id, double bidPrice, double askPrice, qint64 nowMs);
+    // Forgets the symbol's prices.
+    void clear(SymbolId id);
+
+    // An empty Quote for an unknown id.
+    Quote quote(SymbolId id) const;
+
+    // The mark price, or the book mid on markets without one; 0 when
+    // neither was updated within maxAgeMs of nowMs.
+    double markPrice(SymbolId id, qint64 nowMs, qint64 maxAgeMs = kDefaultMaxAgeMs) const;
+    // Where a market order would start filling: the ask for a buy, the bid
+    // for a sell, else the mark price; 0 when all are stale.
+    double executionPrice(SymbolId id, bool buy, qint64 nowMs, qint64 maxAgeMs = kDefaultMaxAgeMs) const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<quint32> sequence{0};
+        std::atomic<double> markPrice{0.0};
+        std::atomic<double> bidPrice{0.0};
+        std::atomic<double> askPrice{0.0};
+        std::atomic<qint64> markUpdatedMs{0};
+        std::atomic<qint64> bookUpdatedMs{0};
+    };
+    static_assert(std::atomic<double>::is_always_lock_free);
+
+    Slot *slot(SymbolId id) const;
+
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// The dashboard's stop-loss, parsed once from its settings.
+struct StopLossRule {
+    bool enabled = false;
+    NativeStopLoss::Limits limits;
+};
+
+// True when the loss of a position at price reaches the rule's USDT or
+// percent limit.
+bool stopLossTriggered(
+    const StopLossRule &rule,
+    bool isLong,
+    double entryPrice,
+    double quantity,
+    double marginUsdt,
+    double price);
+
+// The live stop-loss over the open positions: which positions each symbol's
+// mark update checks, and which already have a close in flight. Only the
+// per_trade scope is enforced live; cumulative and entire_account sum the
+// losses of several positions, which the runtime does not track yet.
+class StopLossWatch {
+public:
+    struct Position {
+        bool isLong = true;
+        double entryPrice = 0.0;
+        double quantity = 0.0;
+        double marginUsdt = 0.0;
+    };
+    // Fills in a watched key's current position; false once it is gone.
+    using PositionLookup = std::function<bool(const QString &key, Position *position)>;
+
+    void setRule(const StopLossRule &rule) { rule_ = rule; }
+    const StopLossRule &rule() const { return rule_; }
+    // False while the rule is off or its scope is not enforced live.
+    bool enforced() const;
+
+    // Adds key to the positions checked on id's mark updates.
+    void watch(SymbolId id, const QString &key);
+    void clearWatched() { watched_.clear(); }
+
+    // Flags key for closing when its loss at price reaches the rule. True
+    // only for the call that flags it: a position already closing is never
+    // flagged twice.
+    bool flag(const QString &key, const Position &position, double price);
+    // flag() for every position watched on id; returns the keys it flagged.
+    QStringList flagMark(SymbolId id, double markPrice, const PositionLookup &lookup);
+
+    bool closing(const QString &key) const { return closing_.contains(key); }
+    const QSet<QString> &closingKeys() const { return closing_; }
+    // The close of key filled or the position went away.
+    void finishClose(const QString &key) { closing_.remove(key); }
+    void clear();
+
+private:
+    StopLossRule rule_;
+    QHash<SymbolId, QStringList> watched_;
+    QSet<QString> closing_;
+};
+
+// Follows a set of symbols on one market over BinanceWsClient's combined
+// streams and keeps the table current. Mark prices exist on futures only;
+// spot follows the book alone.
+class Service final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Service(QObject *parent = nullptr);
+    ~Service() override;
+
+    // Switching market drops every subscription and price.
+    void setMarket(bool futures, bool testnet);
+    // Follows exactly these symbols; the others are unsubscribed and
+    // cleared. Returns false without Qt WebSockets.
+    bool setSymbols(const QStringList &symbols);
+    QStringList symbols() const;
+    void stop();
+
+    const PriceTable &table() const { return table_; }
+
+    // Replaces the combined-stream base URL; for tests.
+    void setCombinedStreamBaseUrlOverride(const QString &baseUrl);
+
+signals:
+    // Emitted after every applied mark price or book update.
+    void priceUpdated(NativeSymbolTable::SymbolId symbolId);
+    // Emitted after mark price updates only; stop-loss follows the mark.
+    void markUpdated(NativeSymbolTable::SymbolId symbolId);
+    void errorOccurred(const QString &message);
+
+private:
+    BinanceWsClient *client_ = nullptr;
+    PriceTable table_;
+    // Followed symbols and the ids interned for them.
+    QHash<QString, SymbolId> symbols_;
+    bool futures_ = true;
+    bool testnet_ = false;
+};
+
+} // namespace NativePriceStream
@@ -0,0 +1,257 @@
+#include "NativeRequestLimiter.h"
+#include "NativeExchangeConnectors.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+
+namespace {
+
+// Longest single sleep inside acquire(), so a waiting order notices a
+// refill or a lifted ban promptly.
+constexpr qint64 kMaxSleepMs = 100;
+
+double limiterCapacity(bool futures, bool testnet) {
+    const QJsonObject settings = NativeExchangeConnectors::limiterSettingsFor(
+        NativeExchangeConnectors::environmentTag(testnet ? QStringLiteral("testnet") : QStringLiteral("live")),
+        NativeExchangeConnectors::accountTag(futures ? QStringLiteral("FUTURES") : QStringLiteral("SPOT")));
+    return settings.value(QStringLiteral("max_per_minute")).toDouble()
+        * settings.value(QStringLiteral("safety_margin")).toDouble(1.0);
+}
+
+// scheme://host:port of a base URL that is not served by Binance itself, or
+// empty for Binance's own hosts and for no override at all.
+QString customOrigin(const QString &baseUrl) {
+    const QUrl url(baseUrl.trimmed());
+    const QString host = url.host().toLower();
+    if (host.isEmpty()) return {};
+    for (const QString &domain : {QStringLiteral("binance.com"),
+                                  QStringLiteral("binance.vision"),
+                                  QStringLiteral("binancefuture.com")}) {
+        if (host == domain || host.endsWith(QLatin1Char('.') + domain)) return {};
+    }
+    return url.scheme().toLower() + QStringLiteral("://") + host
+        + (url.port() >= 0 ? QStringLiteral(":%1").arg(url.port()) : QString());
+}
+
+void sleepFor(qint64 ms) {
+    QEventLoop loop;
+    QTimer::singleShot(static_cast<int>(std::max<qint64>(1, ms)), &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+} // namespace
+
+namespace NativeRequestLimiter {
+
+Limiter::Limiter(double weightPerMinute, qint64 nowMs) {
+    capacity_ = std::max(1.0, weightPerMinute);
+    tokens_ = capacity_;
+    refillPerMs_ = capacity_ / 60'000.0;
+    lastRefillMs_ = nowMs;
+}
+
+QString marketKey(bool futures, bool testnet, const QString &baseUrl) {
+    QString market = futures ? QStringLiteral("futures") : QStringLiteral("spot");
+    const QString origin = customOrigin(baseUrl);
+    if (origin.isEmpty()) {
+        return testnet ? market + QStringLiteral("-testnet") : market;
+    }
+    return market + QLatin1Char('-')
+        + QString::fromLatin1(QCryptographicHash::hash(origin.toUtf8(), QCryptographicHash::Sha1).toHex().left(12));
+}
+
+Limiter &Limiter::forMarket(bool futures, bool testnet, const QString &baseUrl) {
+    static std::mutex registryMutex;
+    static std::map<QString, std::unique_ptr<Limiter>> registry;
+    const QString key = marketKey(futures, testnet, baseUrl);
+    std::lock_guard guard(registryMutex);
+    std::unique_ptr<Limiter> &limiter = registry[key];
+    if (!limiter) {
+        // A custom host is sized like the live market it stands in for.
+        const bool sizedAsTestnet = testnet && customOrigin(baseUrl).isEmpty();
+        limiter = std::make_unique<Limiter>(
+            limiterCapacity(futures, sizedAsTestnet), QDateTime::currentMSecsSinceEpoch());
+    }
+    return *limiter;
+}
+
+Limiter &Limiter::forUrl(const QUrl &url) {
+    const QString path = url.path().toLower();
+    const bool futures = path.startsWith(QStringLiteral("/fapi/")) || path.startsWith(QStringLiteral("/dapi/"));
+    const bool testnet = NativeExchangeConnectors::environmentTag(url.host()) == QStringLiteral("testnet");
+    return forMarket(futures, testnet, url.toString());
+}
+
+void Limiter::refill(qint64 nowMs) {
+    if (nowMs > lastRefillMs_) {
+        tokens_ = std::min(capacity_, tokens_ + static_cast<double>(nowMs - lastRefillMs_) * refillPerMs_);
+        lastRefillMs_ = nowMs;
+    }
+}
+
+qint64 Limiter::tryAcquire(double weight, Priority priority, qint64 nowMs) {
+    std::lock_guard guard(mutex_);
+    if (nowMs < banUntilMs_) {
+        ++rejected_;
+        return kBanned;
+    }
+    refill(nowMs);
+    const bool order = priority == Priority::Order;
+    const double floor = order ? 0.0 : capacity_ * kOrderReserveShare;
+    weight = std::clamp(weight, 0.0, capacity_ - floor);
+    if (!order && ordersWaiting_ > 0) {
+        return kMaxSleepMs;
+    }
+    if (tokens_ - weight >= floor) {
+        tokens_ -= weight;
+        (order ? orderWeight_ : marketDataWeight_) += weight;
+        return 0;
+    }
+    return std::max<qint64>(1, static_cast<qint64>(std::ceil((floor + weight - tokens_) / refillPerMs_)));
+}
+
+bool Limiter::acquire(double weight, Priority priority, int maxWaitMs, QString *error) {
+    const qint64 startedMs = QDateTime::currentMSecsSinceEpoch();
+    qint64 nowMs = startedMs;
+    qint64 waitMs = tryAcquire(weight, priority, nowMs);
+    if (waitMs > 0) {
+        const bool order = priority == Priority::Order;
+        {
+            std::lock_guard guard(mutex_);
+            ++waits_;
+            if (order) ++ordersWaiting_;
+        }
+        // Gives up at once when the refill would come after the deadline.
+        while (waitMs > 0 && nowMs - startedMs + waitMs <= maxWaitMs) {
+            sleepFor(std::min(waitMs, kMaxSleepMs));
+            nowMs = QDateTime::currentMSecsSinceEpoch();
+            waitMs = tryAcquire(weight, priority, nowMs);
+        }
+        std::lock_guard guard(mutex_);
+        waitedMs_ += static_cast<quint64>(std::max<qint64>(0, nowMs - startedMs));
+        if (order) --ordersWaiting_;
+    }
+    if (waitMs == 0) {
+        return true;
+    }
+    if (error) {
+        *error = waitMs == kBanned
+            ? QStringLiteral("Binance request weight ban active for %1 s")
+                  .arg(std::ceil(static_cast<double>(banRemainingMs(nowMs)) / 1000.0))
+            : QStringLiteral("Request weight budget exhausted; %1 ms until enough weight refills").arg(waitMs);
+    }
+    return false;
+}
+
+void Limiter::reconcile(
+    int statusCode,
+    const QList<QPair<QByteArray, QByteArray>> &headers,
+    const QByteArray &body,
+    qint64 nowMs) {
+    int usedWeight = -1;
+    double retryAfter = -1.0;
+    for (const auto &header : headers) {
+        const QByteArray name = header.first.trimmed().toLower();
+        bool ok = false;
+        if (name == "x-mbx-used-weight-1m") {
+            const int value = header.second.trimmed().toInt(&ok);
+            if (ok) usedWeight = value;
+        } else if (name == "retry-after") {
+            const double value = header.second.trimmed().toDouble(&ok);
+            if (ok) retryAfter = value;
+        }
+    }
+
+    qint64 banUntilMs = 0;
+    if (statusCode >= 400) {
+        const QJsonObject error = QJsonDocument::fromJson(body).object();
+        const QJsonObject backoff = NativeExchangeConnectors::buildHttpBackoff(
+            statusCode,
+            error.value(QStringLiteral("code")).toInt(),
+            error.value(QStringLiteral("msg")).toString(QString::fromUtf8(body.left(512))),
+            retryAfter,
+            static_cast<double>(nowMs) / 1000.0);
+        if (backoff.value(QStringLiteral("triggered")).toBool(false)) {
+            banUntilMs = static_cast<qint64>(std::ceil(backoff.value(QStringLiteral("ban_until")).toDouble() * 1000.0));
+        }
+    }
+
+    std::lock_guard guard(mutex_);
+    refill(nowMs);
+    if (usedWeight >= 0) {
+        lastUsedWeight_ = usedWeight;
+        // The exchange also counts traffic this bucket never saw (other
+        // processes, requests sent before start-up), never less.
+        tokens_ = std::min(tokens_, std::max(0.0, capacity_ - usedWeight));
+    }
+    if (banUntilMs > banUntilMs_) {
+        banUntilMs_ = banUntilMs;
+        tokens_ = 0.0;
+        ++bans_;
+    }
+}
+
+qint64 Limiter::banRemainingMs(qint64 nowMs) const {
+    std::lock_guard guard(mutex_);
+    return std::max<qint64>(0, banUntilMs_ - nowMs);
+}
+
+QJsonObject Limiter::snapshot(qint64 nowMs) const {
+    std::lock_guard guard(mutex_);
+    const double available = std::min(
+        capacity_, tokens_ + static_cast<double>(std::max<qint64>(0, nowMs - lastRefillMs_)) * refillPerMs_);
+    const qint64 banRemaining = std::max<qint64>(0, banUntilMs_ - nowMs);
+    return {
+        {QStringLiteral("max_per_minute"), capacity_},
+        {QStringLiteral("available"), available},
+        {QStringLiteral("utilization"), 1.0 - available / capacity_},
+        {QStringLiteral("used_weight_1m"), lastUsedWeight_ >= 0 ? QJsonValue(lastUsedWeight_) : QJsonValue{}},
+        {QStringLiteral("seconds_until_unban"), static_cast<double>(banRemaining) / 1000.0},
+        {QStringLiteral("ban_until"), banRemaining > 0 ? QJsonValue(static_cast<double>(banUntilMs_) / 1000.0)
+                                                        : QJsonValue{}},
+        {QStringLiteral("order_weight"), orderWeight_},
+        {QStringLiteral("market_data_weight"), marketDataWeight_},
+        {QStringLiteral("orders_waiting"), ordersWaiting_},
+        {QStringLiteral("waits"), static_cast<qint64>(waits_)},
+        {QStringLiteral("waited_ms"), static_cast<qint64>(waitedMs_)},
+        {QStringLiteral("rejected"), static_cast<qint64>(rejected_)},
+        {QStringLiteral("bans"), static_cast<qint64>(bans_)},
+    };
+}
+
+void Limiter::reset(qint64 nowMs) {
+    std::lock_guard guard(mutex_);
+    tokens_ = capacity_;
+    lastRefillMs_ = nowMs;
+    banUntilMs_ = 0;
+    lastUsedWeight_ = -1;
+    ordersWaiting_ = 0;
+    orderWeight_ = 0.0;
+    marketDataWeight_ = 0.0;
+    waits_ = 0;
+    waitedMs_ = 0;
+    rejected_ = 0;
+    bans_ = 0;
+}
+
+Priority priorityFor(const QByteArray &method, const QString &path) {
+    const QString lower = path.toLower();
+    const bool orderPath = lower.endsWith(QStringLiteral("/order")) || lower.endsWith(QStringLiteral("/batchorders"))
+        || lower.endsWith(QStringLiteral("/allopenorders"));
+    return orderPath && method.trimmed().toUpper() != "GET" ? Priority::Order : Priority::MarketData;
+}
+
+QJsonObject snapshot(bool futures, bool testnet, const QString &baseUrl) {
+    return Limiter::forMarket(futures, testnet, baseUrl).snapshot(QDateTime::currentMSecsSinceEpoch());
+}
+
+} // namespace NativeRequestLimiter
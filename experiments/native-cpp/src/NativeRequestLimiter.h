@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QUrl>
+
+#include <mutex>
+
+// Client-side request-weight limiter for the Binance REST API.
+//
+// One token bucket per market (see marketKey), sized by
+// NativeExchangeConnectors::limiterSettingsFor and shared by every REST call
+// in the process. A
+// request debits its estimateRequestWeight before it is sent; responses
+// reconcile the bucket against the exchange's own X-MBX-USED-WEIGHT-1M count
+// and turn 418/429 replies into a ban window during which nothing is sent.
+// Order traffic may spend the whole bucket, everything else stops at a
+// reserve kept for orders and yields to orders that are waiting.
+namespace NativeRequestLimiter {
+
+enum class Priority : quint8 { Order, MarketData };
+
+// Share of each bucket only orders may spend.
+inline constexpr double kOrderReserveShare = 0.2;
+// tryAcquire's answer while a ban is in force.
+inline constexpr qint64 kBanned = -1;
+
+// "spot", "futures", "spot-testnet" or "futures-testnet", or, for a base URL
+// that is not a Binance host (a proxy, the local simulator), the account
+// followed by a hash of its origin: such a host enforces its own weight and
+// serves its own data. Request-weight buckets, the kline store and the
+// exchangeInfo cache are all keyed by it.
+QString marketKey(bool futures, bool testnet, const QString &baseUrl = {});
+
+class Limiter {
+public:
+    explicit Limiter(double weightPerMinute, qint64 nowMs = 0);
+
+    // The shared bucket of one market; baseUrl is the base URL override, if
+    // any.
+    static Limiter &forMarket(bool futures, bool testnet, const QString &baseUrl = {});
+    // The shared bucket a REST URL draws from: /fapi and /dapi are futures,
+    // testnet hosts are testnet, and other hosts get their own bucket.
+    static Limiter &forUrl(const QUrl &url);
+
+    // Debits weight and returns 0, returns the milliseconds until enough
+    // weight has refilled, or kBanned.
+    qint64 tryAcquire(double weight, Priority priority, qint64 nowMs);
+
+    // tryAcquire that waits, spinning a local event loop, for at most
+    // maxWaitMs. Returns false and sets error when banned or out of time.
+    bool acquire(double weight, Priority priority, int maxWaitMs, QString *error = nullptr);
+
+    // Reads X-MBX-USED-WEIGHT-1M and, for 418/429 replies, the ban window
+    // from the body's msg or the Retry-After header.
+    void reconcile(
+        int statusCode,
+        const QList<QPair<QByteArray, QByteArray>> &headers,
+        const QByteArray &body,
+        qint64 nowMs);
+
+    qint64 banRemainingMs(qint64 nowMs) const;
+
+    // max_per_minute, available, utilization, used_weight_1m,
+    // seconds_until_unban and counters; the request_weight input of
+    // NativeExchangeConnectors::buildConnectorHealthSnapshot.
+    QJsonObject snapshot(qint64 nowMs) const;
+
+    // Full bucket, no ban, zero counters; for tests.
+    void reset(qint64 nowMs);
+
+private:
+    void refill(qint64 nowMs);
+
+    mutable std::mutex mutex_;
+    double capacity_ = 1.0;
+    double tokens_ = 1.0;
+    double refillPerMs_ = 1.0;
+    qint64 lastRefillMs_ = 0;
+    qint64 banUntilMs_ = 0;
+    int lastUsedWeight_ = -1;
+    int ordersWaiting_ = 0;
+    double orderWeight_ = 0.0;
+    double marketDataWeight_ = 0.0;
+    quint64 waits_ = 0;
+    quint64 waitedMs_ = 0;
+    quint64 rejected_ = 0;
+    quint64 bans_ = 0;
+};
+
+// Whether a Binance REST call is order traffic, by method and path.
+Priority priorityFor(const QByteArray &method, const QString &path);
+
+// The shared bucket's snapshot for the connector health report.
+QJsonObject snapshot(bool futures, bool testnet, const QString &baseUrl = {});
+
+} // namespace NativeRequestLimiter
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Streaming building blocks for O(1)-per-bar rolling indicator windows.
+//
+// Callers drive the window explicitly: push() the value entering the window and
+// pop() the value leaving it. Nothing here owns the series, so the same types
+// serve batch kernels (which read the leaving value back from the input) and
+// live state (which keeps its own ring of recent values).
+namespace NativeRollingWindow {
+
+// Neumaier-compensated running sum. subtract() removes a value that was added
+// earlier, which keeps long rolling ranges within a few ulps of a fresh sum.
+class CompensatedSum {
+public:
+    void add(double value) {
+        const double total = sum_ + value;
+        if (std::abs(sum_) >= std::abs(value)) {
+            compensation_ += (sum_ - total) + value;
+        } else {
+            compensation_ += (value - total) + sum_;
+        }
+        sum_ = total;
+    }
+
+    void subtract(double value) { add(-value); }
+
+    double value() const { return sum_ + compensation_; }
+
+    void reset() {
+        sum_ = 0.0;
+        compensation_ = 0.0;
+    }
+
+private:
+    double sum_ = 0.0;
+    double compensation_ = 0.0;
+};
+
+// Rolling sum that mirrors what a naive rescan of the window would report:
+// finite values are summed with compensation, while NaN and infinities are
+// counted so the caller can apply "skip non-finite" or "any non-finite
+// poisons the window" semantics without rescanning.
+class RollingSum {
+public:
+    void push(double value) {
+        if (std::isfinite(value)) {
+            sum_.add(value);
+            ++finiteCount_;
+            if (value != 0.0) ++nonZeroCount_;
+        } else if (std::isnan(value)) {
+            ++nanCount_;
+        } else if (value > 0.0) {
+            ++positiveInfinityCount_;
+        } else {
+            ++negativeInfinityCount_;
+        }
+    }
+
+    void pop(double value) {
+        if (std::isfinite(value)) {
+            sum_.subtract(value);
+            --finiteCount_;
+            if (value != 0.0) --nonZeroCount_;
+            // A window that only holds zeros must sum to exactly zero, which
+            // downstream "!= 0.0" guards rely on.
+            if (nonZeroCount_ == 0) sum_.reset();
+        } else if (std::isnan(value)) {
+            --nanCount_;
+        } else if (value > 0.0) {
+            --positiveInfinityCount_;
+        } else {
+            --negativeInfinityCount_;
+        }
+    }
+
+    void reset() { *this = RollingSum{}; }
+
+    qsizetype finiteCount() const { return finiteCount_; }
+    qsizetype nonFiniteCount() const {
+        return nanCount_ + positiveInfinityCount_ + negativeInfinityCount_;
+    }
+    bool allFinite() const { return nonFiniteCount() == 0; }
+
+    // Sum of the finite values only.
+    double finiteSum() const { return nonZeroCount_ == 0 ? 0.0 : sum_.value(); }
+
+    // Sum with IEEE propagation, as if every value had been added in turn.
+    double ieeeSum() const {
+        if (nanCount_ > 0 || (positiveInfinityCount_ > 0 && negativeInfinityCount_ > 0)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        if (positiveInfinityCount_ > 0) return std::numeric_limits<double>::infinity();
+        if (negativeInfinityCount_ > 0) return -std::numeric_limits<double>::infinity();
+        return finiteSum();
+    }
+
+private:
+    CompensatedSum sum_;
+    qsizetype finiteCount_ = 0;
+    qsizetype nonZeroCount_ = 0;
+    qsizetype nanCount_ = 0;
+    qsizetype positiveInfinityCount_ = 0;
+    qsizetype negativeInfinityCount_ = 0;
+};
+
+// Mean/variance with removal, kept as compensated sums of (value - shift) and
+// (value - shift)^2. The shift is the first value pushed after a reset, so the
+// sums stay small relative to the spread; callers that run for long series
+// should rebase() about once per window so the shift follows the data. Only
+// finite values may be pushed; track non-finite values separately (see
+// RollingSum).
+class RollingMoments {
+public:
+    void push(double value) {
+        if (count_ == 0) shift_ = value;
+        const double delta = value - shift_;
+        sum_.add(delta);
+        squares_.add(delta * delta);
+        ++count_;
+    }
+
+    void pop(double value) {
+        if (count_ <= 1) {
+            reset();
+            return;
+        }
+        const double delta = value - shift_;
+        sum_.subtract(delta);
+        squares_.subtract(delta * delta);
+        --count_;
+    }
+
+    // Re-anchors on the values currently in the window.
+    template <typename Iterator>
+    void rebase(Iterator first, Iterator last) {
+        reset();
+        for (; first != last; ++first) {
+            if (std::isfinite(*first)) push(*first);
+        }
+    }
+
+    void reset() { *this = RollingMoments{}; }
+
+    qsizetype count() const { return count_; }
+    double mean() const {
+        return count_ > 0 ? shift_ + sum_.value() / static_cast<double>(count_)
+                          : std::numeric_limits<double>::quiet_NaN();
+    }
+    double sampleVariance() const {
+        if (count_ <= 1) return std::numeric_limits<double>::quiet_NaN();
+        const double sum = sum_.value();
+        const double centered = squares_.value() - sum * sum / static_cast<double>(count_);
+        return std::max(0.0, centered) / static_cast<double>(count_ - 1);
+    }
+
+private:
+    CompensatedSum sum_;
+    CompensatedSum squares_;
+    qsizetype count_ = 0;
+    double shift_ = 0.0;
+};
+
+enum class Extremum { Maximum, Minimum };
+
+// Which index wins when several window values tie for the extremum. Earliest
+// matches a left-to-right std::max/std::min scan; Latest matches a ">=" scan.
+enum class TieBreak { Earliest, Latest };
+
+// Monotonic deque over (index, value) pairs giving the window extremum in
+// amortized O(1). NaN is never stored, matching std::max/std::min scans where
+// a NaN operand never replaces the running value.
+template <Extremum Kind, TieBreak Tie>
+class MonotonicWindow {
+public:
+    explicit MonotonicWindow(qsizetype length = 1)
+        : entries_(std::max<qsizetype>(1, length) + 1) {}
+
+    void push(qsizetype index, double value) {
+        if (std::isnan(value)) return;
+        while (size_ > 0 && dominates(value, entries_[slot(size_ - 1)].value)) --size_;
+        entries_[slot(size_)] = Entry{index, value};
+        ++size_;
+    }
+
+    // Drops every entry whose index is before firstIndex.
+    void expireBefore(qsizetype firstIndex) {
+        while (size_ > 0 && entries_[head_].index < firstIndex) {
+            head_ = (head_ + 1) % entries_.size();
+            --size_;
+        }
+    }
+
+    void reset() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    struct Peek {
+        qsizetype index = -1;
+        double value = 0.0;
+    };
+
+    // What index()/value() would report after expireBefore(firstIndex) and
+    // push(index, value), without changing the window. Live state uses this
+    // to evaluate a forming bar it must not commit yet; when the window only
+    // ever advances one bar at a time, at most one entry is skipped here.
+    Peek peek(qsizetype firstIndex, qsizetype index, double value) const {
+        qsizetype offset = 0;
+        while (offset < size_ && entries_[slot(offset)].index < firstIndex) ++offset;
+        if (offset == size_) {
+            return std::isnan(value) ? Peek{-1, emptyValue()} : Peek{index, value};
+        }
+        const Entry &head = entries_[slot(offset)];
+        // The deque is monotonic, so an incoming value that displaces the
+        // head displaces every entry behind it as well.
+        if (!std::isnan(value) && dominates(value, head.value)) return {index, value};
+        return {head.index, head.value};
+    }
+
+    bool isEmpty() const { return size_ == 0; }
+    qsizetype index() const { return entries_[head_].index; }
+
+    // Empty windows report the fold identity of the equivalent scan.
+    double value() const { return size_ == 0 ? emptyValue() : entries_[head_].value; }
+
+private:
+    struct Entry {
+        qsizetype index = 0;
+        double value = 0.0;
+    };
+
+    static double emptyValue() {
+        return Kind == Extremum::Maximum ? -std::numeric_limits<double>::infinity()
+                                         : std::numeric_limits<double>::infinity();
+    }
+
+    static bool dominates(double incoming, double existing) {
+        if constexpr (Kind == Extremum::Maximum) {
+            return Tie == TieBreak::Latest ? existing <= incoming : existing < incoming;
+        } else {
+            return Tie == TieBreak::Latest ? existing >= incoming : existing > incoming;
+        }
+    }
+
+    qsizetype slot(qsizetype offset) const { return (head_ + offset) % entries_.size(); }
+
+    QVector<Entry> entries_;
+    qsizetype head_ = 0;
+    qsizetype size_ = 0;
+};
+
+// Fixed-capacity ring of the latest pushed values, for live state that must
+// pop the value leaving a window without keeping the whole series.
+class RecentValues {
+public:
+    explicit RecentValues(qsizetype capacity = 1)
+        : values_(std::max<qsizetype>(1, capacity), 0.0) {}
+
+    void push(double value) {
+        head_ = (head_ + 1) % values_.size();
+        values_[head_] = value;
+    }
+
+    // offset 0 is the latest push. Valid while offset is below both the
+    // capacity and the number of pushes so far.
+    double back(qsizetype offset) const {
+        return values_[(head_ + values_.size() - offset) % values_.size()];
+    }
+
+    qsizetype capacity() const { return values_.size(); }
+
+private:
+    QVector<double> values_;
+    qsizetype head_ = 0;
+};
+
+using RollingMaximum = MonotonicWindow<Extremum::Maximum, TieBreak::Earliest>;
+using RollingMinimum = MonotonicWindow<Extremum::Minimum, TieBreak::Earliest>;
+
+} // namespace NativeRollingWindow
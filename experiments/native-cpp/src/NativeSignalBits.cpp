@@ -0,0 +1,126 @@
+#include "NativeSignalBits.h"
+
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NATIVE_SIGNAL_BITS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define NATIVE_SIGNAL_BITS_X86 0
+#endif
+
+// GCC and Clang only emit AVX2 instructions inside functions that ask for
+// them; MSVC accepts the intrinsics anywhere.
+#if NATIVE_SIGNAL_BITS_X86 && (defined(__GNUC__) || defined(__clang__))
+#define NATIVE_SIGNAL_BITS_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define NATIVE_SIGNAL_BITS_AVX2_TARGET
+#endif
+
+namespace {
+
+template <typename Op>
+void combineScalar(quint64 *target, const quint64 *source, std::size_t begin, std::size_t count, Op op) {
+    for (std::size_t index = begin; index < count; ++index) target[index] = op(target[index], source[index]);
+}
+
+#if NATIVE_SIGNAL_BITS_X86
+
+bool detectAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4] = {};
+    __cpuid(registers, 0);
+    if (registers[0] < 7) return false;
+    __cpuid(registers, 1);
+    const bool osxsave = (registers[2] & (1 << 27)) != 0;
+    const bool avx = (registers[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(registers, 7, 0);
+    return (registers[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+NATIVE_SIGNAL_BITS_AVX2_TARGET
+std::size_t andAvx2(quint64 *target, const quint64 *source, std::size_t count) {
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(target + index));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + index));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target + index), _mm256_and_si256(left, right));
+    }
+    return index;
+}
+
+NATIVE_SIGNAL_BITS_AVX2_TARGET
+std::size_t orAvx2(quint64 *target, const quint64 *source, std::size_t count) {
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(target + index));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + index));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target + index), _mm256_or_si256(left, right));
+    }
+    return index;
+}
+
+#endif
+
+} // namespace
+
+namespace NativeSignalBits {
+
+bool avx2Available() {
+#if NATIVE_SIGNAL_BITS_X86
+    static const bool available = detectAvx2();
+    return available;
+#else
+    return false;
+#endif
+}
+
+void andWords(std::span<quint64> target, std::span<const quint64> source) {
+    const std::size_t count = std::min(target.size(), source.size());
+    std::size_t done = 0;
+#if NATIVE_SIGNAL_BITS_X86
+    if (avx2Available()) done = andAvx2(target.data(), source.data(), count);
+#endif
+    combineScalar(target.data(), source.data(), done, count, [](quint64 left, quint64 right) { return left & right; });
+}
+
+void orWords(std::span<quint64> target, std::span<const quint64> source) {
+    const std::size_t count = std::min(target.size(), source.size());
+    std::size_t done = 0;
+#if NATIVE_SIGNAL_BITS_X86
+    if (avx2Available()) done = orAvx2(target.data(), source.data(), count);
+#endif
+    combineScalar(target.data(), source.data(), done, count, [](quint64 left, quint64 right) { return left | right; });
+}
+
+SignalBits::SignalBits(qsizetype size, bool value)
+    : size_(std::max<qsizetype>(0, size)),
+      words_(static_cast<std::size_t>((size_ + 63) / 64), value ? ~quint64{0} : quint64{0}) {
+    if (value && (size_ & 63) != 0) words_.back() = (quint64{1} << (size_ & 63)) - 1;
+}
+
+qsizetype SignalBits::count() const {
+    qsizetype total = 0;
+    for (const quint64 word : words_) total += std::popcount(word);
+    return total;
+}
+
+SignalBits &SignalBits::operator&=(const SignalBits &other) {
+    andWords(words_, other.words_);
+    return *this;
+}
+
+SignalBits &SignalBits::operator|=(const SignalBits &other) {
+    orWords(words_, other.words_);
+    return *this;
+}
+
+} // namespace NativeSignalBits
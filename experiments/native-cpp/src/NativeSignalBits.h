@@ -0,0 +1,63 @@
+#pragma once
+
+#include "NativeIndicatorRuntime.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <span>
+
+// Packed per-candle signal flags for the backtest combiner. Bit i of word
+// i / 64 is candle i; bits past size() are always zero, so word-wide AND/OR
+// never leaks flags beyond the series.
+namespace NativeSignalBits {
+
+class SignalBits {
+public:
+    SignalBits() = default;
+    explicit SignalBits(qsizetype size, bool value = false);
+
+    // Builds the bitset a word at a time from predicate(index), called once
+    // per index in ascending order.
+    template <typename Predicate>
+    static SignalBits fromPredicate(qsizetype size, Predicate &&predicate) {
+        SignalBits bits(size);
+        quint64 *words = bits.words_.data();
+        for (qsizetype base = 0; base < size; base += 64) {
+            const qsizetype end = std::min<qsizetype>(size, base + 64);
+            quint64 word = 0;
+            for (qsizetype index = base; index < end; ++index) {
+                word |= static_cast<quint64>(predicate(index) ? 1 : 0) << (index - base);
+            }
+            words[base / 64] = word;
+        }
+        return bits;
+    }
+
+    qsizetype size() const { return size_; }
+    bool test(qsizetype index) const {
+        return (words_[static_cast<std::size_t>(index >> 6)] >> (index & 63)) & 1U;
+    }
+    void set(qsizetype index) {
+        words_[static_cast<std::size_t>(index >> 6)] |= quint64{1} << (index & 63);
+    }
+    qsizetype count() const;
+
+    // Both operands must have the same size.
+    SignalBits &operator&=(const SignalBits &other);
+    SignalBits &operator|=(const SignalBits &other);
+
+    std::span<const quint64> words() const { return words_; }
+
+private:
+    qsizetype size_ = 0;
+    NativeIndicatorRuntime::AlignedColumn<quint64> words_;
+};
+
+// Word-wide kernels over equally sized word arrays. They use AVX2 when the
+// CPU supports it and a scalar loop otherwise.
+void andWords(std::span<quint64> target, std::span<const quint64> source);
+void orWords(std::span<quint64> target, std::span<const quint64> source);
+bool avx2Available();
+
+} // namespace NativeSignalBits
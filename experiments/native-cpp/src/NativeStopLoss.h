@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QString>
+
+#include <algorithm>
+
+// The stop-loss rule shared by the backtest and the live dashboard runtime.
+//
+// Settings are parsed once into Limits; the per-candle and per-tick checks
+// below only compare numbers.
+namespace NativeStopLoss {
+
+enum class Mode { Usdt, Percent, Both };
+enum class Scope { PerTrade, Cumulative, EntireAccount };
+
+struct Limits {
+    Mode mode = Mode::Usdt;
+    // PerTrade measures the percent against the position's margin, the other
+    // scopes against its entry notional.
+    Scope scope = Scope::PerTrade;
+    double usdt = 0.0;
+    double percent = 0.0;
+};
+
+// usdt, percent or both; anything else falls back to usdt.
+inline Mode parseMode(const QString &text) {
+    const QString token = text.trimmed().toLower();
+    if (token == QStringLiteral("percent")) return Mode::Percent;
+    if (token == QStringLiteral("both")) return Mode::Both;
+    return Mode::Usdt;
+}
+
+// per_trade, cumulative or entire_account; anything else falls back to per_trade.
+inline Scope parseScope(const QString &text) {
+    const QString token = text.trimmed().toLower();
+    if (token == QStringLiteral("cumulative")) return Scope::Cumulative;
+    if (token == QStringLiteral("entire_account")) return Scope::EntireAccount;
+    return Scope::PerTrade;
+}
+
+inline QString modeName(Mode mode) {
+    static const QString names[] = {QStringLiteral("usdt"), QStringLiteral("percent"), QStringLiteral("both")};
+    return names[static_cast<int>(mode)];
+}
+
+inline QString scopeName(Scope scope) {
+    static const QString names[] = {QStringLiteral("per_trade"), QStringLiteral("cumulative"), QStringLiteral("entire_account")};
+    return names[static_cast<int>(scope)];
+}
+
+// Loss of units held from entryPrice when closed at exitPrice; never negative.
+inline double positionLoss(bool isLong, double entryPrice, double exitPrice, double units) {
+    return isLong
+        ? std::max(0.0, (entryPrice - exitPrice) * units)
+        : std::max(0.0, (exitPrice - entryPrice) * units);
+}
+
+// True when loss reaches the USDT limit or, measured against the scope's
+// denominator, the percent limit.
+inline bool reached(const Limits &limits, double loss, double marginUsdt, double entryNotional) {
+    if (limits.mode != Mode::Percent && limits.usdt > 0.0 && loss >= limits.usdt) {
+        return true;
+    }
+    if (limits.mode == Mode::Usdt || !(limits.percent > 0.0)) {
+        return false;
+    }
+    const double denominator = limits.scope == Scope::PerTrade && marginUsdt > 0.0 ? marginUsdt : entryNotional;
+    return denominator > 0.0 && loss / denominator * 100.0 >= limits.percent;
+}
+
+} // namespace NativeStopLoss
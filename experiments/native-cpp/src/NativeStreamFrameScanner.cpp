@@ -0,0 +1,396 @@
+#include "NativeStreamFrameScanner.h"
+
+#include <type_traits>
+
+namespace NativeStreamFrameScanner {
+namespace {
+
+// Deeper frames are left to QJsonDocument.
+constexpr int kMaxDepth = 32;
+// Longest decimal converted in place; longer ones are left to QJsonDocument.
+constexpr qsizetype kMaxNumberLength = 64;
+constexpr qint64 kMaxExactInteger = qint64(1) << 53;
+
+// A value the scanner kept for one of the keys it reads.
+struct Field {
+    enum class Kind : quint8 { Absent, String, EscapedString, Number, True, False, Null, Object, Array };
+    Kind kind = Kind::Absent;
+    // String contents without the quotes, or the number token.
+    TextSpan text;
+};
+
+struct KlineFields {
+    Field symbol;
+    Field interval;
+    Field openTime;
+    Field open;
+    Field high;
+    Field low;
+    Field close;
+    Field volume;
+    Field closed;
+    int memberCount = 0;
+};
+
+// The keys read from a raw payload or a combined envelope's "data" object.
+struct PayloadFields {
+    Field symbol;
+    Field bid;
+    Field ask;
+    Field kline;
+    KlineFields klineFields;
+};
+
+bool isDigit(char16_t c) {
+    return c >= u'0' && c <= u'9';
+}
+
+bool isHexDigit(char16_t c) {
+    return isDigit(c) || (c >= u'a' && c <= u'f') || (c >= u'A' && c <= u'F');
+}
+
+template <typename Char>
+class Scanner {
+public:
+    Scanner(const Char *data, qsizetype size)
+        : data_(data),
+          size_(size) {}
+
+    ScannedFrame scan() {
+        PayloadFields root;
+        PayloadFields data;
+        Field stream;
+        Field dataField;
+        const bool parsed = parseObject(1, [&](TextSpan key, int depth) {
+            if (keyIs(key, "stream")) return readField(stream, depth);
+            if (keyIs(key, "data")) {
+                if (dataField.kind != Field::Kind::Absent) return false;
+                skipWhitespace();
+                if (pos_ < size_ && at(pos_) == u'{') {
+                    dataField.kind = Field::Kind::Object;
+                    return parseObject(depth, [&](TextSpan dataKey, int dataDepth) {
+                        return readPayloadMember(data, dataKey, dataDepth);
+                    });
+                }
+                return readField(dataField, depth);
+            }
+            return readPayloadMember(root, key, depth);
+        });
+        skipWhitespace();
+        if (!parsed || pos_ != size_) return {};
+
+        ScannedFrame frame;
+        const bool combined = dataField.kind == Field::Kind::Object;
+        if (dataField.kind != Field::Kind::Absent && !combined) return {};
+        if (combined) {
+            if (stream.kind == Field::Kind::EscapedString) return {};
+            if (stream.kind == Field::Kind::String) frame.stream = stream.text;
+        }
+        const PayloadFields &payload = combined ? data : root;
+
+        if (payload.kline.kind != Field::Kind::Absent) {
+            const KlineFields &kline = payload.klineFields;
+            if (payload.kline.kind != Field::Kind::Object || kline.memberCount == 0) return {};
+            const Field &symbol = kline.symbol.kind == Field::Kind::Absent ? payload.symbol : kline.symbol;
+            if (!plainText(symbol, frame.symbol) || !plainText(kline.interval, frame.interval)
+                || !integerValue(kline.openTime, frame.openTimeMs)
+                || !decimalValue(kline.open, frame.open)
+                || !decimalValue(kline.high, frame.high)
+                || !decimalValue(kline.low, frame.low)
+                || !decimalValue(kline.close, frame.close)
+                || !decimalValue(kline.volume, frame.volume)) {
+                return {};
+            }
+            frame.isClosed = kline.closed.kind == Field::Kind::True;
+            frame.type = ScannedFrame::Type::Kline;
+            return frame;
+        }
+
+        if (!plainText(payload.symbol, frame.symbol)
+            || !decimalValue(payload.bid, frame.bidPrice)
+            || !decimalValue(payload.ask, frame.askPrice)) {
+            return {};
+        }
+        frame.type = ScannedFrame::Type::BookTicker;
+        return frame;
+    }
+
+private:
+    static constexpr bool kUtf8 = std::is_same_v<Char, char>;
+
+    char16_t at(qsizetype index) const {
+        return static_cast<char16_t>(static_cast<std::make_unsigned_t<Char>>(data_[index]));
+    }
+
+    bool keyIs(TextSpan key, const char *name) const {
+        qsizetype index = 0;
+        for (; name[index] != '\0'; ++index) {
+            if (index >= key.length || at(key.offset + index) != static_cast<char16_t>(name[index])) return false;
+        }
+        return index == key.length;
+    }
+
+    void skipWhitespace() {
+        while (pos_ < size_) {
+            const char16_t c = at(pos_);
+            if (c != u' ' && c != u'\t' && c != u'\n' && c != u'\r') return;
+            ++pos_;
+        }
+    }
+
+    bool consume(char16_t expected) {
+        skipWhitespace();
+        if (pos_ >= size_ || at(pos_) != expected) return false;
+        ++pos_;
+        return true;
+    }
+
+    // Reads a string from its opening quote. Only plain strings (ASCII, no
+    // escapes) are ever returned as values.
+    bool readString(TextSpan &text, bool &plain) {
+        if (pos_ >= size_ || at(pos_) != u'"') return false;
+        text.offset = ++pos_;
+        plain = true;
+        while (pos_ < size_) {
+            const char16_t c = at(pos_++);
+            if (c == u'"') {
+                text.length = pos_ - 1 - text.offset;
+                return true;
+            }
+            if (c < 0x20) return false;
+            if (c >= 0x80) {
+                // Left to QJsonDocument's UTF-8 validation.
+                if constexpr (kUtf8) return false;
+                plain = false;
+            } else if (c == u'\\') {
+                plain = false;
+                if (pos_ >= size_) return false;
+                const char16_t escaped = at(pos_++);
+                if (escaped == u'u') {
+                    for (int digit = 0; digit < 4; ++digit) {
+                        if (pos_ >= size_ || !isHexDigit(at(pos_++))) return false;
+                    }
+                } else if (escaped != u'"' && escaped != u'\\' && escaped != u'/' && escaped != u'b'
+                           && escaped != u'f' && escaped != u'n' && escaped != u'r' && escaped != u't') {
+                    return false;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool readDigits() {
+        const qsizetype start = pos_;
+        while (pos_ < size_ && isDigit(at(pos_))) ++pos_;
+        return pos_ > start;
+    }
+
+    // JSON number grammar: no leading zeros, '+' or bare fractions.
+    // QJsonDocument rejects numbers that overflow a double, so exponents are
+    // converted here too; overlong tokens are left to it.
+    bool readNumber(TextSpan &text) {
+        text.offset = pos_;
+        if (pos_ < size_ && at(pos_) == u'-') ++pos_;
+        if (pos_ < size_ && at(pos_) == u'0') {
+            ++pos_;
+        } else if (!readDigits()) {
+            return false;
+        }
+        if (pos_ < size_ && at(pos_) == u'.') {
+            ++pos_;
+            if (!readDigits()) return false;
+        }
+        bool exponent = false;
+        if (pos_ < size_ && (at(pos_) == u'e' || at(pos_) == u'E')) {
+            exponent = true;
+            ++pos_;
+            if (pos_ < size_ && (at(pos_) == u'+' || at(pos_) == u'-')) ++pos_;
+            if (!readDigits()) return false;
+        }
+        text.length = pos_ - text.offset;
+        if (text.length > kMaxNumberLength) return false;
+        if (!exponent) return true;
+        char buffer[kMaxNumberLength];
+        bool ok = false;
+        latin1(text, buffer).toDouble(&ok);
+        return ok;
+    }
+
+    bool readLiteral(const char *literal) {
+        for (qsizetype index = 0; literal[index] != '\0'; ++index, ++pos_) {
+            if (pos_ >= size_ || at(pos_) != static_cast<char16_t>(literal[index])) return false;
+        }
+        return true;
+    }
+
+    // Validates any value; field, if given, records what it was.
+    bool readValue(int depth, Field *field) {
+        Field ignored;
+        Field &out = field ? *field : ignored;
+        skipWhitespace();
+        if (pos_ >= size_) return false;
+        switch (at(pos_)) {
+        case u'"': {
+            bool plain = false;
+            if (!readString(out.text, plain)) return false;
+            out.kind = plain ? Field::Kind::String : Field::Kind::EscapedString;
+            return true;
+        }
+        case u'{':
+            out.kind = Field::Kind::Object;
+            return parseObject(depth + 1, [this](TextSpan, int memberDepth) { return readValue(memberDepth, nullptr); });
+        case u'[':
+            out.kind = Field::Kind::Array;
+            return parseArray(depth + 1);
+        case u't':
+            out.kind = Field::Kind::True;
+            return readLiteral("true");
+        case u'f':
+            out.kind = Field::Kind::False;
+            return readLiteral("false");
+        case u'n':
+            out.kind = Field::Kind::Null;
+            return readLiteral("null");
+        default:
+            out.kind = Field::Kind::Number;
+            return readNumber(out.text);
+        }
+    }
+
+    // A key read twice is left to QJsonDocument's duplicate handling.
+    bool readField(Field &field, int depth) {
+        return field.kind == Field::Kind::Absent && readValue(depth, &field);
+    }
+
+    // Hands each member's key to onMember, which reads its value.
+    template <typename OnMember>
+    bool parseObject(int depth, OnMember &&onMember) {
+        if (depth > kMaxDepth || !consume(u'{')) return false;
+        if (consume(u'}')) return true;
+        do {
+            skipWhitespace();
+            TextSpan key;
+            bool plain = false;
+            if (!readString(key, plain) || !plain || !consume(u':') || !onMember(key, depth)) return false;
+        } while (consume(u','));
+        return consume(u'}');
+    }
+
+    bool parseArray(int depth) {
+        if (depth > kMaxDepth || !consume(u'[')) return false;
+        if (consume(u']')) return true;
+        do {
+            if (!readValue(depth, nullptr)) return false;
+        } while (consume(u','));
+        return consume(u']');
+    }
+
+    bool readPayloadMember(PayloadFields &payload, TextSpan key, int depth) {
+        if (keyIs(key, "s")) return readField(payload.symbol, depth);
+        if (keyIs(key, "b")) return readField(payload.bid, depth);
+        if (keyIs(key, "a")) return readField(payload.ask, depth);
+        if (!keyIs(key, "k")) return readValue(depth, nullptr);
+        if (payload.kline.kind != Field::Kind::Absent) return false;
+        skipWhitespace();
+        if (pos_ >= size_ || at(pos_) != u'{') return readField(payload.kline, depth);
+        payload.kline.kind = Field::Kind::Object;
+        KlineFields &kline = payload.klineFields;
+        return parseObject(depth + 1, [&](TextSpan klineKey, int klineDepth) {
+            ++kline.memberCount;
+            if (keyIs(klineKey, "s")) return readField(kline.symbol, klineDepth);
+            if (keyIs(klineKey, "i")) return readField(kline.interval, klineDepth);
+            if (keyIs(klineKey, "t")) return readField(kline.openTime, klineDepth);
+            if (keyIs(klineKey, "o")) return readField(kline.open, klineDepth);
+            if (keyIs(klineKey, "h")) return readField(kline.high, klineDepth);
+            if (keyIs(klineKey, "l")) return readField(kline.low, klineDepth);
+            if (keyIs(klineKey, "c")) return readField(kline.close, klineDepth);
+            if (keyIs(klineKey, "v")) return readField(kline.volume, klineDepth);
+            if (keyIs(klineKey, "x")) return readField(kline.closed, klineDepth);
+            return readValue(klineDepth, nullptr);
+        });
+    }
+
+    static bool plainText(const Field &field, TextSpan &text) {
+        if (field.kind != Field::Kind::String || field.text.length == 0) return false;
+        text = field.text;
+        return true;
+    }
+
+    // Strings must hold a plain decimal, the subset of what QString::toDouble
+    // accepts that needs no trimming or locale handling.
+    bool decimalText(TextSpan text) const {
+        qsizetype index = text.offset;
+        const qsizetype end = text.offset + text.length;
+        const auto digits = [&]() {
+            const qsizetype start = index;
+            while (index < end && isDigit(at(index))) ++index;
+            return index > start;
+        };
+        if (index < end && at(index) == u'-') ++index;
+        if (!digits()) return false;
+        if (index < end && at(index) == u'.') {
+            ++index;
+            if (!digits()) return false;
+        }
+        if (index < end && (at(index) == u'e' || at(index) == u'E')) {
+            ++index;
+            if (index < end && (at(index) == u'+' || at(index) == u'-')) ++index;
+            if (!digits()) return false;
+        }
+        return index == end;
+    }
+
+    // The text as Latin-1 bytes: in place for UTF-8 frames, otherwise copied
+    // to buffer. Only called on ASCII-checked spans.
+    QByteArrayView latin1(TextSpan text, char *buffer) const {
+        if constexpr (kUtf8) {
+            return QByteArrayView(data_ + text.offset, text.length);
+        } else {
+            for (qsizetype index = 0; index < text.length; ++index) {
+                buffer[index] = static_cast<char>(at(text.offset + index));
+            }
+            return QByteArrayView(buffer, text.length);
+        }
+    }
+
+    // Converted by the same routine QJsonDocument and QString::toDouble use,
+    // so both paths produce identical values.
+    bool decimalValue(const Field &field, double &value) const {
+        if (field.text.length > kMaxNumberLength) return false;
+        if (field.kind != Field::Kind::Number && !(field.kind == Field::Kind::String && decimalText(field.text))) {
+            return false;
+        }
+        char buffer[kMaxNumberLength];
+        bool ok = false;
+        value = latin1(field.text, buffer).toDouble(&ok);
+        return ok;
+    }
+
+    bool integerValue(const Field &field, qint64 &value) const {
+        if (field.kind != Field::Kind::Number || field.text.length > kMaxNumberLength) return false;
+        for (qsizetype index = 0; index < field.text.length; ++index) {
+            if (at(field.text.offset + index) != u'-' && !isDigit(at(field.text.offset + index))) return false;
+        }
+        char buffer[kMaxNumberLength];
+        bool ok = false;
+        value = latin1(field.text, buffer).toLongLong(&ok);
+        // QJsonDocument keeps larger integers as doubles.
+        return ok && value <= kMaxExactInteger && value >= -kMaxExactInteger;
+    }
+
+    const Char *data_;
+    const qsizetype size_;
+    qsizetype pos_ = 0;
+};
+
+} // namespace
+
+ScannedFrame scan(QStringView message) {
+    return Scanner<char16_t>(message.utf16(), message.size()).scan();
+}
+
+ScannedFrame scan(QByteArrayView message) {
+    return Scanner<char>(message.data(), message.size()).scan();
+}
+
+} // namespace NativeStreamFrameScanner
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QStringView>
+#include <QtGlobal>
+
+#include <type_traits>
+
+// Single-pass reader for the Binance market-stream frames that dominate live
+// traffic: kline and bookTicker payloads, raw or inside a combined-stream
+// {"stream":...,"data":...} envelope. It validates the whole frame as JSON
+// but builds no document: the known keys are picked out as it goes, decimals
+// are converted from the frame text in place and strings are returned as
+// spans into it.
+//
+// Anything it is not sure about comes back Unrecognized, never wrong:
+// escapes or non-ASCII text in the fields it reads, duplicate keys, numbers
+// in unexpected forms, subscription replies and every other event type.
+// Callers decode those with QJsonDocument.
+namespace NativeStreamFrameScanner {
+
+struct TextSpan {
+    qsizetype offset = 0;
+    qsizetype length = 0;
+};
+
+struct ScannedFrame {
+    enum class Type : quint8 { Unrecognized, Kline, BookTicker };
+    Type type = Type::Unrecognized;
+    // Combined envelopes only.
+    TextSpan stream;
+    TextSpan symbol;
+    TextSpan interval;
+    qint64 openTimeMs = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    bool isClosed = false;
+    double bidPrice = 0.0;
+    double askPrice = 0.0;
+};
+static_assert(std::is_trivially_copyable_v<ScannedFrame>);
+
+// Text frames as QtWebSockets delivers them, read without converting to
+// UTF-8 first.
+ScannedFrame scan(QStringView message);
+// Raw UTF-8 frames. Spans index bytes; any non-ASCII byte makes the frame
+// Unrecognized.
+ScannedFrame scan(QByteArrayView message);
+
+} // namespace NativeStreamFrameScanner
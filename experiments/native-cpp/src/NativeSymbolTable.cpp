@@ -0,0 +1,92 @@
+#include "NativeSymbolTable.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace {
+
+struct Table {
+    std::shared_mutex mutex;
+    QHash<QString, NativeSymbolTable::SymbolId> ids;
+    QVector<QString> names;
+};
+
+Table &table() {
+    static Table instance;
+    return instance;
+}
+
+bool isCanonical(QStringView symbol) {
+    for (const QChar c : symbol) {
+        if (c.isSpace() || c.isLower()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Exchange symbols almost always arrive canonical; only the rest pay for a
+// trimmed, upper-cased copy.
+QString canonicalSymbol(const QString &symbol) {
+    return isCanonical(symbol) ? symbol : symbol.trimmed().toUpper();
+}
+
+} // namespace
+
+namespace NativeSymbolTable {
+
+SymbolId intern(const QString &symbol) {
+    const QString canonical = canonicalSymbol(symbol);
+    if (canonical.isEmpty()) {
+        return kInvalidSymbol;
+    }
+    Table &symbols = table();
+    {
+        std::shared_lock guard(symbols.mutex);
+        const auto it = symbols.ids.constFind(canonical);
+        if (it != symbols.ids.cend()) {
+            return it.value();
+        }
+    }
+    std::unique_lock guard(symbols.mutex);
+    const auto it = symbols.ids.constFind(canonical);
+    if (it != symbols.ids.cend()) {
+        return it.value();
+    }
+    if (symbols.names.size() >= kMaxSymbols) {
+        return kInvalidSymbol;
+    }
+    const auto id = static_cast<SymbolId>(symbols.names.size());
+    symbols.names.append(canonical);
+    symbols.ids.insert(canonical, id);
+    return id;
+}
+
+SymbolId find(QStringView symbol) {
+    QString canonical;
+    if (!isCanonical(symbol)) {
+        canonical = symbol.trimmed().toString().toUpper();
+        symbol = canonical;
+    }
+    Table &symbols = table();
+    std::shared_lock guard(symbols.mutex);
+    const auto it = symbols.ids.constFind(symbol);
+    return it != symbols.ids.cend() ? it.value() : kInvalidSymbol;
+}
+
+QString name(SymbolId id) {
+    Table &symbols = table();
+    std::shared_lock guard(symbols.mutex);
+    return id < static_cast<SymbolId>(symbols.names.size()) ? symbols.names.at(id) : QString();
+}
+
+int size() {
+    Table &symbols = table();
+    std::shared_lock guard(symbols.mutex);
+    return static_cast<int>(symbols.names.size());
+}
+
+} // namespace NativeSymbolTable
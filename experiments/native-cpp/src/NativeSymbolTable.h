@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+
+// Process-wide interning of exchange symbols. Every distinct symbol gets a
+// small dense id on first sight, kept for the life of the process, so hot
+// paths can key tables by an integer (or index a flat array) instead of
+// hashing and comparing strings.
+namespace NativeSymbolTable {
+
+using SymbolId = quint32;
+
+inline constexpr SymbolId kInvalidSymbol = ~SymbolId(0);
+// Ids stay below this bound, so per-symbol arrays can be sized up front.
+inline constexpr int kMaxSymbols = 8192;
+
+// Symbols are compared trimmed and upper-cased. Returns kInvalidSymbol for
+// an empty symbol or once kMaxSymbols are interned.
+SymbolId intern(const QString &symbol);
+
+// The id of an already interned symbol, or kInvalidSymbol. Canonical
+// symbols are looked up in place, without a copy, so stream decoders can
+// resolve a span of the frame text.
+SymbolId find(QStringView symbol);
+
+// The canonical spelling of id, or an empty string for an unknown id.
+QString name(SymbolId id);
+
+int size();
+
+} // namespace NativeSymbolTable
@@ -0,0 +1,684 @@
+#include "NativeUserDataStream.h"
+
+#include "BinanceWsClient.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QSet>
+#include <QUrl>
+#include <QVariant>
+
+#if HAS_QT_WEBSOCKETS
+#include <QTimer>
+#include <QWebSocket>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+using FuturesPosition = BinanceRestClient::FuturesPosition;
+
+constexpr double kFlatAmount = 1e-10;
+
+// Binance sends every number as a string.
+double jsonNumber(const QJsonValue &value) {
+    if (value.isDouble()) {
+        return value.toDouble();
+    }
+    bool ok = false;
+    const double parsed = value.toString().toDouble(&ok);
+    return ok && std::isfinite(parsed) ? parsed : 0.0;
+}
+
+qint64 jsonMs(const QJsonValue &value) {
+    return value.isDouble() ? static_cast<qint64>(value.toDouble()) : value.toString().toLongLong();
+}
+
+bool isOpenOrderStatus(const QString &status) {
+    return status == QStringLiteral("NEW") || status == QStringLiteral("PARTIALLY_FILLED");
+}
+
+#if HAS_QT_WEBSOCKETS
+constexpr int kReconnectMaxMs = 30000;
+// Frames buffered while a resync is in flight; past this the socket is
+// dropped and the next connect starts over.
+constexpr qsizetype kMaxPendingFrames = 4096;
+constexpr int kRestTimeoutMs = 10000;
+#endif
+
+} // namespace
+
+namespace NativeUserDataStream {
+
+QString AccountState::positionKey(const QString &symbol, const QString &positionSide) {
+    return symbol + QLatin1Char('|') + (positionSide.isEmpty() ? QStringLiteral("BOTH") : positionSide);
+}
+
+void AccountState::resync(
+    const BinanceRestClient::FuturesPositionsResult &positions,
+    const BinanceRestClient::BalanceResult &balance,
+    const BinanceRestClient::FuturesOpenOrdersResult &openOrders,
+    qint64 nowMs) {
+    positions_.clear();
+    leverageBySymbol_.clear();
+    isolatedBySymbol_.clear();
+    openOrders_.clear();
+    for (const OpenOrder &order : openOrders.orders) {
+        if (isOpenOrderStatus(order.status)) {
+            openOrders_.insert(order.orderId, order);
+        }
+    }
+    double isolatedWallets = 0.0;
+    for (const FuturesPosition &position : positions.positions) {
+        if (std::fabs(position.positionAmt) <= kFlatAmount) {
+            continue;
+        }
+        FuturesPosition seeded = position;
+        seeded.symbol = position.symbol.trimmed().toUpper();
+        seeded.positionSide = position.positionSide.trimmed().toUpper();
+        if (seeded.positionSide.isEmpty()) {
+            seeded.positionSide = QStringLiteral("BOTH");
+        }
+        const bool isolated = seeded.isolatedWallet > 0.0;
+        isolatedBySymbol_.insert(seeded.symbol, isolated);
+        if (seeded.leverage > 0.0) {
+            leverageBySymbol_.insert(seeded.symbol, seeded.leverage);
+        }
+        if (isolated) {
+            isolatedWallets += seeded.isolatedWallet;
+        }
+        positions_.insert(positionKey(seeded.symbol, seeded.positionSide), seeded);
+    }
+    balanceAsset_ = balance.asset.isEmpty() ? QStringLiteral("USDT") : balance.asset.trimmed().toUpper();
+    walletBalance_ = balance.totalUsdtBalance > 0.0 ? balance.totalUsdtBalance : balance.usdtBalance;
+    crossWalletBalance_ = std::max(0.0, walletBalance_ - isolatedWallets);
+    availableOffset_ = balance.availableUsdtBalance - crossWalletBalance_ - crossMarginDelta();
+    synced_ = positions.ok && balance.ok && openOrders.ok;
+    syncedAtMs_ = nowMs;
+    lastAccountEventMs_ = 0;
+    ++stats_.resyncs;
+}
+
+void AccountState::invalidate() {
+    synced_ = false;
+    openOrders_.clear();
+}
+
+EventType AccountState::apply(const QByteArray &frame) {
+    QJsonParseError parseError{};
+    const QJsonDocument document = QJsonDocument::fromJson(frame, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        return EventType::Invalid;
+    }
+    QJsonObject event = document.object();
+    if (event.contains(QStringLiteral("stream")) && event.value(QStringLiteral("data")).isObject()) {
+        event = event.value(QStringLiteral("data")).toObject();
+    }
+    const QString type = event.value(QStringLiteral("e")).toString();
+    EventType eventType = EventType::Other;
+    if (type == QStringLiteral("ACCOUNT_UPDATE")) {
+        eventType = EventType::AccountUpdate;
+    } else if (type == QStringLiteral("ORDER_TRADE_UPDATE")) {
+        eventType = EventType::OrderTradeUpdate;
+    } else if (type == QStringLiteral("ACCOUNT_CONFIG_UPDATE")) {
+        eventType = EventType::AccountConfigUpdate;
+    } else if (type == QStringLiteral("markPriceUpdate")) {
+        eventType = EventType::MarkPriceUpdate;
+    } else if (type == QStringLiteral("listenKeyExpired")) {
+        eventType = EventType::ListenKeyExpired;
+    }
+    // Until the first resync there is nothing to apply events to, and the
+    // resync replaces whatever they would have changed.
+    if (!synced_) {
+        return eventType;
+    }
+    switch (eventType) {
+    case EventType::AccountUpdate:
+        applyAccountUpdate(event);
+        break;
+    case EventType::OrderTradeUpdate:
+        applyOrderTradeUpdate(event);
+        break;
+    case EventType::AccountConfigUpdate:
+        applyAccountConfigUpdate(event);
+        break;
+    case EventType::MarkPriceUpdate:
+        ++stats_.markPriceUpdates;
+        applyMarkPrice(event.value(QStringLiteral("s")).toString().toUpper(), jsonNumber(event.value(QStringLiteral("p"))));
+        break;
+    default:
+        break;
+    }
+    return eventType;
+}
+
+void AccountState::applyAccountUpdate(const QJsonObject &event) {
+    const qint64 eventMs = jsonMs(event.value(QStringLiteral("E")));
+    if (eventMs < lastAccountEventMs_) {
+        ++stats_.staleEvents;
+        return;
+    }
+    lastAccountEventMs_ = eventMs;
+    lastEventTimeMs_ = std::max(lastEventTimeMs_, eventMs);
+    ++stats_.accountUpdates;
+
+    const QJsonObject account = event.value(QStringLiteral("a")).toObject();
+    for (const QJsonValue &value : account.value(QStringLiteral("B")).toArray()) {
+        const QJsonObject row = value.toObject();
+        if (row.value(QStringLiteral("a")).toString().toUpper() != balanceAsset_) {
+            continue;
+        }
+        walletBalance_ = jsonNumber(row.value(QStringLiteral("wb")));
+        crossWalletBalance_ = jsonNumber(row.value(QStringLiteral("cw")));
+    }
+    // Only the positions that changed are listed, each with its full state.
+    for (const QJsonValue &value : account.value(QStringLiteral("P")).toArray()) {
+        const QJsonObject row = value.toObject();
+        const QString symbol = row.value(QStringLiteral("s")).toString().trimmed().toUpper();
+        if (symbol.isEmpty()) {
+            continue;
+        }
+        QString positionSide = row.value(QStringLiteral("ps")).toString().trimmed().toUpper();
+        if (positionSide.isEmpty()) {
+            positionSide = QStringLiteral("BOTH");
+        }
+        const bool isolated = row.value(QStringLiteral("mt")).toString().toLower() == QStringLiteral("isolated");
+        isolatedBySymbol_.insert(symbol, isolated);
+        const QString key = positionKey(symbol, positionSide);
+        const double amount = jsonNumber(row.value(QStringLiteral("pa")));
+        if (std::fabs(amount) <= kFlatAmount) {
+            positions_.remove(key);
+            continue;
+        }
+        auto it = positions_.find(key);
+        if (it == positions_.end()) {
+            FuturesPosition opened;
+            opened.symbol = symbol;
+            opened.positionSide = positionSide;
+            opened.leverage = leverageBySymbol_.value(symbol, 0.0);
+            it = positions_.insert(key, opened);
+        }
+        FuturesPosition &position = it.value();
+        position.positionAmt = amount;
+        position.entryPrice = jsonNumber(row.value(QStringLiteral("ep")));
+        position.isolatedWallet = isolated ? jsonNumber(row.value(QStringLiteral("iw"))) : 0.0;
+        const double unrealized = jsonNumber(row.value(QStringLiteral("up")));
+        revalue(position, position.entryPrice > 0.0 ? position.entryPrice + unrealized / amount : position.markPrice);
+    }
+}
+
+void AccountState::applyOrderTradeUpdate(const QJsonObject &event) {
+    const QJsonObject order = event.value(QStringLiteral("o")).toObject();
+    const QString orderId = order.value(QStringLiteral("i")).toVariant().toString();
+    if (orderId.isEmpty()) {
+        return;
+    }
+    const qint64 eventMs = jsonMs(event.value(QStringLiteral("E")));
+    const qint64 updateMs = jsonMs(order.value(QStringLiteral("T")));
+    const auto existing = openOrders_.constFind(orderId);
+    if (existing != openOrders_.cend() && existing->updateTimeMs > updateMs) {
+        ++stats_.staleEvents;
+        return;
+    }
+    lastEventTimeMs_ = std::max(lastEventTimeMs_, eventMs);
+    ++stats_.orderUpdates;
+
+    const QString status = order.value(QStringLiteral("X")).toString().toUpper();
+    if (!isOpenOrderStatus(status)) {
+        openOrders_.remove(orderId);
+        return;
+    }
+    OpenOrder &open = openOrders_[orderId];
+    open.orderId = orderId;
+    open.symbol = order.value(QStringLiteral("s")).toString().trimmed().toUpper();
+    open.clientOrderId = order.value(QStringLiteral("c")).toString();
+    open.side = order.value(QStringLiteral("S")).toString().toUpper();
+    open.positionSide = order.value(QStringLiteral("ps")).toString().toUpper();
+    open.type = order.value(QStringLiteral("o")).toString().toUpper();
+    open.status = status;
+    open.price = jsonNumber(order.value(QStringLiteral("p")));
+    open.origQty = jsonNumber(order.value(QStringLiteral("q")));
+    open.executedQty = jsonNumber(order.value(QStringLiteral("z")));
+    open.avgPrice = jsonNumber(order.value(QStringLiteral("ap")));
+    open.reduceOnly = order.value(QStringLiteral("R")).toBool(false);
+    open.updateTimeMs = updateMs;
+}
+
+void AccountState::applyAccountConfigUpdate(const QJsonObject &event) {
+    lastEventTimeMs_ = std::max(lastEventTimeMs_, jsonMs(event.value(QStringLiteral("E"))));
+    ++stats_.configUpdates;
+    // ai (multi-assets mode) carries no per-symbol state.
+    const QJsonObject config = event.value(QStringLiteral("ac")).toObject();
+    const QString symbol = config.value(QStringLiteral("s")).toString().trimmed().toUpper();
+    const double leverage = jsonNumber(config.value(QStringLiteral("l")));
+    if (symbol.isEmpty() || leverage <= 0.0) {
+        return;
+    }
+    leverageBySymbol_.insert(symbol, leverage);
+    for (FuturesPosition &position : positions_) {
+        if (position.symbol == symbol) {
+            position.leverage = leverage;
+            revalue(position, position.markPrice);
+        }
+    }
+}
+
+void AccountState::applyMarkPrice(const QString &symbol, double markPrice) {
+    if (symbol.isEmpty() || markPrice <= 0.0) {
+        return;
+    }
+    for (FuturesPosition &position : positions_) {
+        if (position.symbol == symbol) {
+            revalue(position, markPrice);
+        }
+    }
+}
+
+void AccountState::revalue(FuturesPosition &position, double markPrice) const {
+    if (!std::isfinite(markPrice) || markPrice <= 0.0) {
+        return;
+    }
+    position.markPrice = markPrice;
+    position.notional = position.positionAmt * markPrice;
+    position.unrealizedProfit = position.entryPrice > 0.0
+        ? (markPrice - position.entryPrice) * position.positionAmt
+        : 0.0;
+    // Leverage comes from the resync or ACCOUNT_CONFIG_UPDATE; without it
+    // the margin is unknown rather than the full notional.
+    position.initialMargin = position.leverage > 0.0 ? std::fabs(position.notional) / position.leverage : 0.0;
+    position.positionInitialMargin = position.initialMargin;
+    if (isolatedBySymbol_.value(position.symbol, false)) {
+        position.isolatedMargin = position.isolatedWallet + position.unrealizedProfit;
+    }
+}
+
+double AccountState::crossMarginDelta() const {
+    double delta = 0.0;
+    for (const FuturesPosition &position : positions_) {
+        if (isolatedBySymbol_.value(position.symbol, false)) {
+            continue;
+        }
+        delta += position.unrealizedProfit - position.positionInitialMargin;
+    }
+    for (const OpenOrder &order : openOrders_) {
+        const double remaining = order.origQty - order.executedQty;
+        if (order.reduceOnly || order.price <= 0.0 || remaining <= 0.0) {
+            continue;
+        }
+        delta -= remaining * order.price / std::max(1.0, leverageBySymbol_.value(order.symbol, 1.0));
+    }
+    return delta;
+}
+
+BinanceRestClient::FuturesPositionsResult AccountState::positions() const {
+    BinanceRestClient::FuturesPositionsResult result;
+    if (!synced_) {
+        result.error = QStringLiteral("User-data stream is not synced");
+        return result;
+    }
+    QStringList keys = positions_.keys();
+    std::sort(keys.begin(), keys.end());
+    result.positions.reserve(keys.size());
+    for (const QString &key : std::as_const(keys)) {
+        result.positions.append(positions_.value(key));
+    }
+    result.ok = true;
+    return result;
+}
+
+BinanceRestClient::BalanceResult AccountState::balance() const {
+    BinanceRestClient::BalanceResult result;
+    if (!synced_) {
+        result.error = QStringLiteral("User-data stream is not synced");
+        return result;
+    }
+    const double total = std::max(0.0, walletBalance_);
+    result.ok = true;
+    result.asset = balanceAsset_;
+    result.totalUsdtBalance = total;
+    result.usdtBalance = total;
+    result.availableUsdtBalance = std::clamp(availableOffset_ + crossWalletBalance_ + crossMarginDelta(), 0.0, total);
+    return result;
+}
+
+QStringList AccountState::positionSymbols() const {
+    QSet<QString> symbols;
+    for (const FuturesPosition &position : positions_) {
+        symbols.insert(position.symbol);
+    }
+    QStringList sorted(symbols.cbegin(), symbols.cend());
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+Client::Client(QObject *parent)
+    : QObject(parent) {
+#if HAS_QT_WEBSOCKETS
+    socket_ = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    keepAliveTimer_ = new QTimer(this);
+    keepAliveTimer_->setInterval(kKeepAliveIntervalMs);
+    reconnectTimer_ = new QTimer(this);
+    reconnectTimer_->setSingleShot(true);
+    restPool_.setMaxThreadCount(1);
+
+    connect(keepAliveTimer_, &QTimer::timeout, this, &Client::keepAlive);
+    connect(reconnectTimer_, &QTimer::timeout, this, [this]() {
+        if (!running_) {
+            return;
+        }
+        if (renewOnReconnect_ || listenKey_.isEmpty()) {
+            renewOnReconnect_ = false;
+            requestListenKey();
+        } else {
+            openSocket();
+        }
+    });
+    connect(socket_, &QWebSocket::connected, this, [this]() {
+        reconnectAttempts_ = 0;
+        requestResync();
+    });
+    connect(socket_, &QWebSocket::textMessageReceived, this, &Client::handleMessage);
+    connect(socket_, &QWebSocket::disconnected, this, [this]() {
+        if (!running_) {
+            return;
+        }
+        // Whatever happened while disconnected is only in REST now.
+        state_.invalidate();
+        resyncing_ = false;
+        pendingFrames_.clear();
+        markPriceStreams_.clear();
+        emit disconnected();
+        scheduleReconnect(false);
+    });
+    connect(
+        socket_,
+        qOverload<QAbstractSocket::SocketError>(&QWebSocket::errorOccurred),
+        this,
+        [this](QAbstractSocket::SocketError) { emit errorOccurred(socket_->errorString()); });
+#endif
+}
+
+Client::~Client() {
+    stop();
+#if HAS_QT_WEBSOCKETS
+    ++generation_;
+    restPool_.waitForDone();
+#endif
+}
+
+QString Client::streamBaseUrl(bool testnet) {
+    const QString host = BinanceWsClient::streamHostOverride();
+    if (!host.isEmpty()) {
+        return host + QStringLiteral("/ws");
+    }
+    return testnet ? QStringLiteral("wss://stream.binancefuture.com/ws") : QStringLiteral("wss://fstream.binance.com/ws");
+}
+
+void Client::start(const QString &apiKey, const QString &apiSecret, bool testnet, const QString &restBaseUrl) {
+    const QString key = apiKey.trimmed();
+    const QString secret = apiSecret.trimmed();
+    const QString base = restBaseUrl.trimmed();
+    if (running_ && key == apiKey_ && secret == apiSecret_ && testnet == testnet_ && base == restBaseUrl_) {
+        return;
+    }
+    stop();
+    if (key.isEmpty() || secret.isEmpty()) {
+        emit errorOccurred(QStringLiteral("User-data stream needs API credentials"));
+        return;
+    }
+    apiKey_ = key;
+    apiSecret_ = secret;
+    testnet_ = testnet;
+    restBaseUrl_ = base;
+#if HAS_QT_WEBSOCKETS
+    running_ = true;
+    reconnectAttempts_ = 0;
+    requestListenKey();
+#else
+    emit errorOccurred(QStringLiteral("Qt WebSockets is unavailable; account state falls back to REST polling"));
+#endif
+}
+
+void Client::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+#if HAS_QT_WEBSOCKETS
+    ++generation_;
+    keepAliveTimer_->stop();
+    reconnectTimer_->stop();
+    resyncing_ = false;
+    renewOnReconnect_ = false;
+    pendingFrames_.clear();
+    markPriceStreams_.clear();
+    if (socket_->state() != QAbstractSocket::UnconnectedState) {
+        socket_->abort();
+    }
+    if (!listenKey_.isEmpty()) {
+        restPool_.start([apiKey = apiKey_, testnet = testnet_, base = restBaseUrl_]() {
+            BinanceRestClient::closeFuturesListenKey(apiKey, testnet, 3000, base);
+        });
+    }
+#endif
+    listenKey_.clear();
+    state_.invalidate();
+}
+
+bool Client::isConnected() const {
+#if HAS_QT_WEBSOCKETS
+    return socket_->state() == QAbstractSocket::ConnectedState;
+#else
+    return false;
+#endif
+}
+
+void Client::setStreamBaseUrlOverride(const QString &baseUrl) {
+    streamBaseUrlOverride_ = baseUrl.trimmed();
+    while (streamBaseUrlOverride_.endsWith(QLatin1Char('/'))) {
+        streamBaseUrlOverride_.chop(1);
+    }
+}
+
+void Client::setReconnectBaseMs(int ms) {
+    reconnectBaseMs_ = std::max(1, ms);
+}
+
+#if HAS_QT_WEBSOCKETS
+template <typename Work, typename Done>
+void Client::runRest(Work work, Done done) {
+    const quint64 generation = generation_.load();
+    restPool_.start([this, generation, work = std::move(work), done = std::move(done)]() mutable {
+        auto result = work();
+        if (generation_.load() != generation) {
+            return;
+        }
+        // Queued with the client as context: dropped if it is destroyed
+        // before its thread gets to it.
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, done = std::move(done), result = std::move(result)]() mutable {
+                if (generation_.load() == generation) {
+                    done(std::move(result));
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void Client::requestListenKey() {
+    runRest(
+        [apiKey = apiKey_, testnet = testnet_, base = restBaseUrl_]() {
+            return BinanceRestClient::createFuturesListenKey(apiKey, testnet, kRestTimeoutMs, base);
+        },
+        [this](BinanceRestClient::ListenKeyResult result) {
+            if (!result.ok) {
+                emit errorOccurred(QStringLiteral("User-data listenKey request failed: %1").arg(result.error));
+                scheduleReconnect(true);
+                return;
+            }
+            listenKey_ = result.listenKey;
+            keepAliveTimer_->start();
+            openSocket();
+        });
+}
+
+void Client::openSocket() {
+    if (socket_->state() != QAbstractSocket::UnconnectedState) {
+        socket_->abort();
+    }
+    reconnectTimer_->stop();
+    const QString base = streamBaseUrlOverride_.isEmpty() ? streamBaseUrl(testnet_) : streamBaseUrlOverride_;
+    socket_->open(QUrl(base + QLatin1Char('/') + listenKey_));
+}
+
+void Client::requestResync() {
+    resyncing_ = true;
+    pendingFrames_.clear();
+    struct Snapshot {
+        BinanceRestClient::FuturesPositionsResult positions;
+        BinanceRestClient::BalanceResult balance;
+        BinanceRestClient::FuturesOpenOrdersResult openOrders;
+    };
+    runRest(
+        [apiKey = apiKey_, apiSecret = apiSecret_, testnet = testnet_, base = restBaseUrl_]() {
+            return Snapshot{
+                BinanceRestClient::fetchOpenFuturesPositions(apiKey, apiSecret, testnet, kRestTimeoutMs, base),
+                BinanceRestClient::fetchUsdtBalance(apiKey, apiSecret, true, testnet, kRestTimeoutMs, base),
+                BinanceRestClient::fetchOpenFuturesOrders(apiKey, apiSecret, testnet, kRestTimeoutMs, base),
+            };
+        },
+        [this](Snapshot snapshot) {
+            if (!resyncing_ || socket_->state() != QAbstractSocket::ConnectedState) {
+                return;
+            }
+            if (!snapshot.positions.ok || !snapshot.balance.ok || !snapshot.openOrders.ok) {
+                emit errorOccurred(QStringLiteral("User-data resync failed: %1")
+                                       .arg(!snapshot.positions.ok ? snapshot.positions.error
+                                            : !snapshot.balance.ok ? snapshot.balance.error
+                                                                   : snapshot.openOrders.error));
+                // Reconnecting retries the resync with backoff.
+                socket_->abort();
+                return;
+            }
+            state_.resync(snapshot.positions, snapshot.balance, snapshot.openOrders, QDateTime::currentMSecsSinceEpoch());
+            resyncing_ = false;
+            const QList<QByteArray> frames = std::exchange(pendingFrames_, {});
+            for (const QByteArray &frame : frames) {
+                if (state_.apply(frame) == EventType::ListenKeyExpired) {
+                    renewOnReconnect_ = true;
+                    socket_->abort();
+                    return;
+                }
+            }
+            syncMarkPriceStreams();
+            emit synced();
+            emit accountChanged();
+        });
+}
+
+void Client::keepAlive() {
+    runRest(
+        [apiKey = apiKey_, testnet = testnet_, base = restBaseUrl_]() {
+            return BinanceRestClient::keepAliveFuturesListenKey(apiKey, testnet, kRestTimeoutMs, base);
+        },
+        [this](BinanceRestClient::ListenKeyResult result) {
+            if (result.ok) {
+                return;
+            }
+            emit errorOccurred(QStringLiteral("User-data listenKey keepalive failed: %1").arg(result.error));
+            // -1125: the key is gone; only a new one brings the stream back.
+            if (result.error.contains(QStringLiteral("-1125"))
+                || result.error.contains(QStringLiteral("does not exist"), Qt::CaseInsensitive)) {
+                renewOnReconnect_ = true;
+                socket_->abort();
+            }
+        });
+}
+
+void Client::scheduleReconnect(bool renewListenKey) {
+    renewOnReconnect_ = renewOnReconnect_ || renewListenKey;
+    if (!running_ || reconnectTimer_->isActive()) {
+        return;
+    }
+    const int shift = std::min(reconnectAttempts_, 5);
+    ++reconnectAttempts_;
+    reconnectTimer_->start(std::min(kReconnectMaxMs, reconnectBaseMs_ << shift));
+}
+
+void Client::handleMessage(const QString &message) {
+    const QByteArray frame = message.toUtf8();
+    if (resyncing_) {
+        if (pendingFrames_.size() >= kMaxPendingFrames) {
+            emit errorOccurred(QStringLiteral("User-data resync fell too far behind the stream"));
+            socket_->abort();
+            return;
+        }
+        pendingFrames_.append(frame);
+        return;
+    }
+    switch (state_.apply(frame)) {
+    case EventType::ListenKeyExpired:
+        emit errorOccurred(QStringLiteral("User-data listenKey expired"));
+        renewOnReconnect_ = true;
+        socket_->abort();
+        return;
+    case EventType::AccountUpdate:
+        syncMarkPriceStreams();
+        emit accountChanged();
+        return;
+    case EventType::OrderTradeUpdate:
+    case EventType::AccountConfigUpdate:
+    case EventType::MarkPriceUpdate:
+        emit accountChanged();
+        return;
+    default:
+        return;
+    }
+}
+
+void Client::syncMarkPriceStreams() {
+    if (socket_->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    QSet<QString> wanted;
+    for (const QString &symbol : state_.positionSymbols()) {
+        wanted.insert(BinanceWsClient::markPriceStreamName(symbol));
+    }
+    QStringList toSubscribe;
+    for (const QString &stream : std::as_const(wanted)) {
+        if (!markPriceStreams_.contains(stream)) {
+            toSubscribe.append(stream);
+        }
+    }
+    QStringList toUnsubscribe;
+    for (const QString &stream : std::as_const(markPriceStreams_)) {
+        if (!wanted.contains(stream)) {
+            toUnsubscribe.append(stream);
+        }
+    }
+    const auto sendFrame = [this](const QString &method, QStringList streams) {
+        std::sort(streams.begin(), streams.end());
+        const QJsonObject frame{
+            {QStringLiteral("method"), method},
+            {QStringLiteral("params"), QJsonArray::fromStringList(streams)},
+            {QStringLiteral("id"), nextRequestId_++},
+        };
+        socket_->sendTextMessage(QString::fromUtf8(QJsonDocument(frame).toJson(QJsonDocument::Compact)));
+    };
+    if (!toUnsubscribe.isEmpty()) {
+        sendFrame(QStringLiteral("UNSUBSCRIBE"), toUnsubscribe);
+    }
+    if (!toSubscribe.isEmpty()) {
+        sendFrame(QStringLiteral("SUBSCRIBE"), toSubscribe);
+    }
+    markPriceStreams_ = wanted;
+}
+#endif
+
+} // namespace NativeUserDataStream
@@ -0,0 +1,210 @@
+#pragma once
+
+#ifndef HAS_QT_WEBSOCKETS
+#define HAS_QT_WEBSOCKETS 0
+#endif
+
+#include "BinanceRestClient.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+
+#if HAS_QT_WEBSOCKETS
+class QTimer;
+class QWebSocket;
+#endif
+
+// Binance futures user-data stream.
+//
+// A listenKey opens a private WebSocket over which the exchange pushes every
+// balance, position and order change of the account. AccountState folds those
+// events into the same position and balance snapshots the REST calls return,
+// so the dashboard runtime reads them without a network call. REST is only
+// used to seed the state (positions, balance and open orders) when the
+// socket (re)connects; events that arrive while that snapshot is in flight
+// are replayed on top of it.
+//
+// The dashboard still confirms its own orders over REST: the dashboard
+// engine reads the connector's positions right after placing a batch, and
+// the next cycle uses that snapshot instead of racing the batch's
+// ACCOUNT_UPDATE. The sticky positions cache only guards REST reads and is
+// not consulted while a stream is synced.
+namespace NativeUserDataStream {
+
+using OpenOrder = BinanceRestClient::FuturesOpenOrder;
+
+enum class EventType {
+    Invalid,
+    AccountUpdate,
+    OrderTradeUpdate,
+    AccountConfigUpdate,
+    MarkPriceUpdate,
+    ListenKeyExpired,
+    // SUBSCRIBE replies and events the state does not track.
+    Other,
+};
+
+// Account state rebuilt from stream events. Not thread-safe: it lives on the
+// thread of the Client that feeds it.
+class AccountState {
+public:
+    // Replaces everything with a REST snapshot taken at nowMs. Open orders
+    // are seeded before the available balance is derived, so their margin is
+    // not counted twice.
+    void resync(
+        const BinanceRestClient::FuturesPositionsResult &positions,
+        const BinanceRestClient::BalanceResult &balance,
+        const BinanceRestClient::FuturesOpenOrdersResult &openOrders,
+        qint64 nowMs);
+    // Forgets the snapshot; positions() and balance() report not ok until the
+    // next resync.
+    void invalidate();
+    bool isSynced() const { return synced_; }
+
+    // Applies one stream frame, raw or inside a combined-stream envelope.
+    // Account updates older than the last applied one, and order updates
+    // older than the order's last, are ignored. Nothing is applied while
+    // not synced.
+    EventType apply(const QByteArray &frame);
+
+    // ok only while synced. Flat positions are left out, like the REST call.
+    BinanceRestClient::FuturesPositionsResult positions() const;
+    // Wallet balance from ACCOUNT_UPDATE; the available balance is the
+    // resync's value moved by the cross-wallet, unrealized PnL and margin
+    // changes since. Positions opened at a leverage the state never saw
+    // count no margin.
+    BinanceRestClient::BalanceResult balance() const;
+    QList<OpenOrder> openOrders() const { return openOrders_.values(); }
+    // Symbols with a non-zero position, sorted.
+    QStringList positionSymbols() const;
+
+    qint64 syncedAtMs() const { return syncedAtMs_; }
+    // Event time (E) of the newest applied account or order event.
+    qint64 lastEventTimeMs() const { return lastEventTimeMs_; }
+
+    struct Stats {
+        quint64 accountUpdates = 0;
+        quint64 orderUpdates = 0;
+        quint64 configUpdates = 0;
+        quint64 markPriceUpdates = 0;
+        quint64 staleEvents = 0;
+        quint64 resyncs = 0;
+    };
+    const Stats &stats() const { return stats_; }
+
+private:
+    static QString positionKey(const QString &symbol, const QString &positionSide);
+    void applyAccountUpdate(const QJsonObject &event);
+    void applyOrderTradeUpdate(const QJsonObject &event);
+    void applyAccountConfigUpdate(const QJsonObject &event);
+    void applyMarkPrice(const QString &symbol, double markPrice);
+    void revalue(BinanceRestClient::FuturesPosition &position, double markPrice) const;
+    // Cross unrealized PnL less position and open-order margin; what the
+    // available balance moves with besides the cross wallet.
+    double crossMarginDelta() const;
+
+    bool synced_ = false;
+    qint64 syncedAtMs_ = 0;
+    qint64 lastEventTimeMs_ = 0;
+    qint64 lastAccountEventMs_ = 0;
+    // symbol|positionSide -> open (non-flat) position.
+    QHash<QString, BinanceRestClient::FuturesPosition> positions_;
+    QHash<QString, double> leverageBySymbol_;
+    QHash<QString, bool> isolatedBySymbol_;
+    // orderId -> open order.
+    QHash<QString, OpenOrder> openOrders_;
+    QString balanceAsset_ = QStringLiteral("USDT");
+    double walletBalance_ = 0.0;
+    double crossWalletBalance_ = 0.0;
+    // availableBalance at resync minus the cross terms it was made of.
+    double availableOffset_ = 0.0;
+    Stats stats_;
+};
+
+// The listenKey lifecycle and the socket: creates the key, keeps it alive,
+// reconnects with capped backoff, renews an expired key, resyncs over REST on
+// every (re)connect and follows the mark price of every open position on the
+// same socket. REST calls run on a private thread pool, never on the
+// client's thread.
+class Client final : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Client(QObject *parent = nullptr);
+    ~Client() override;
+
+    // Binance closes a listenKey 60 minutes after its last keepalive.
+    static constexpr int kKeepAliveIntervalMs = 30 * 60 * 1000;
+
+    static QString streamBaseUrl(bool testnet);
+
+    // restBaseUrl is the connector's futures REST base; empty for Binance.
+    // Restarting with the same arguments is a no-op.
+    void start(const QString &apiKey, const QString &apiSecret, bool testnet, const QString &restBaseUrl = {});
+    // Closes the socket and the listenKey.
+    void stop();
+
+    bool isRunning() const { return running_; }
+    bool isConnected() const;
+    bool isSynced() const { return state_.isSynced(); }
+    const AccountState &state() const { return state_; }
+
+    // Replaces the WebSocket base (ws://host:port/ws) the listenKey is
+    // appended to; empty restores the Binance endpoint.
+    void setStreamBaseUrlOverride(const QString &baseUrl);
+    // Reconnect backoff base; for tests.
+    void setReconnectBaseMs(int ms);
+
+signals:
+    // The REST snapshot has been applied; the state is readable.
+    void synced();
+    // Emitted after every applied account, order or mark price event.
+    void accountChanged();
+    void disconnected();
+    void errorOccurred(const QString &message);
+
+private:
+#if HAS_QT_WEBSOCKETS
+    template <typename Work, typename Done>
+    void runRest(Work work, Done done);
+    void requestListenKey();
+    void openSocket();
+    void requestResync();
+    void keepAlive();
+    void scheduleReconnect(bool renewListenKey);
+    void handleMessage(const QString &message);
+    void syncMarkPriceStreams();
+
+    QWebSocket *socket_ = nullptr;
+    QTimer *keepAliveTimer_ = nullptr;
+    QTimer *reconnectTimer_ = nullptr;
+    QThreadPool restPool_;
+    std::atomic<quint64> generation_{0};
+    bool resyncing_ = false;
+    bool renewOnReconnect_ = false;
+    QList<QByteArray> pendingFrames_;
+    QSet<QString> markPriceStreams_;
+    qint64 nextRequestId_ = 1;
+    int reconnectAttempts_ = 0;
+#endif
+    AccountState state_;
+    bool running_ = false;
+    QString apiKey_;
+    QString apiSecret_;
+    bool testnet_ = false;
+    QString restBaseUrl_;
+    QString listenKey_;
+    QString streamBaseUrlOverride_;
+    int reconnectBaseMs_ = 1000;
+};
+
+} // namespace NativeUserDataStream
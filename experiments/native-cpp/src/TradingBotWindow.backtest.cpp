@@ -35,6 +35,7 @@
 #include <QtConcurrent>
 
 #include <algorithm>
+#include <cmath>
 
 namespace {
 
@@ -318,6 +319,44 @@ QString backtestSnapshotStatusText(const QJsonObject &snapshot, const QString &f
     return message;
 }
 
+// Status line for a native runBatch progress snapshot.
+QString nativeBacktestProgressText(const QJsonObject &snapshot) {
+    QString message = backtestSnapshotStatusText(snapshot, QStringLiteral("running"));
+    const double etaMs = jsonNumber(snapshot, QStringLiteral("eta_ms"), -1.0);
+    if (etaMs >= 0.0) {
+        message += QStringLiteral(" ETA %1 s.").arg(std::ceil(etaMs / 1000.0), 0, 'f', 0);
+    }
+    const QJsonObject best = snapshot.value(QStringLiteral("top_run")).toObject();
+    if (!best.isEmpty()) {
+        QStringList keys;
+        for (const QJsonValue &key : best.value(QStringLiteral("indicator_keys")).toArray()) {
+            keys.append(key.toString());
+        }
+        message += QStringLiteral(" Best so far: %1 %2 %3, ROI %4%.")
+                       .arg(jsonText(best, QStringLiteral("symbol")),
+                            jsonText(best, QStringLiteral("interval")),
+                            keys.join(QLatin1Char('+')))
+                       .arg(jsonNumber(best, QStringLiteral("roi_percent")), 0, 'f', 2);
+    }
+    return message;
+}
+
+// Points the resume button at the checkpoint a stopped native optimizer
+// left behind, if there is one. Returns whether there is.
+bool offerNativeCheckpoint(QPushButton *button) {
+    const NativeBacktestBatchRuntime::CheckpointSummary summary =
+        NativeBacktestBatchRuntime::readCheckpointSummary(NativeBacktestBatchRuntime::defaultCheckpointPath());
+    if (!button) return summary.ok;
+    button->setProperty("checkpointAvailable", summary.ok);
+    button->setProperty("nativeCheckpoint", summary.ok);
+    button->setToolTip(summary.ok
+        ? QStringLiteral("Resume the stopped native C++ optimizer (%1 of %2 run(s) done) with the same selections.")
+              .arg(summary.processedCount)
+              .arg(summary.runCount)
+        : QStringLiteral("Available after a native C++ optimizer run is stopped or the Python Service API saves an optimizer time-budget checkpoint."));
+    return summary.ok;
+}
+
 QJsonObject cleanBacktestResultMetadata(const QJsonObject &row) {
     const QStringList metadataKeys = {
         QStringLiteral("symbol"),
@@ -958,9 +997,7 @@ QWidget *TradingBotWindow::createBacktestTab() {
     runButton_ = new QPushButton("Run Backtest", outputGroup);
     controlsLayout->addWidget(runButton_);
     resumeBacktestButton_ = new QPushButton("Resume Optimizer", outputGroup);
-    resumeBacktestButton_->setEnabled(false);
-    resumeBacktestButton_->setToolTip(
-        "Available after the Python Service API saves an optimizer time-budget checkpoint.");
+    resumeBacktestButton_->setEnabled(offerNativeCheckpoint(resumeBacktestButton_));
     controlsLayout->addWidget(resumeBacktestButton_);
     stopButton_ = new QPushButton("Stop", outputGroup);
     stopButton_->setEnabled(false);
@@ -1049,7 +1086,7 @@ void TradingBotWindow::setBacktestRunningUi(bool running) {
     refreshPositionsSummaryLabels();
 }
 
-void TradingBotWindow::startBacktest(bool optimizerRequested) {
+void TradingBotWindow::startBacktest(bool optimizerRequested, bool resumeCheckpoint) {
     if (backtestFutureWatcher_ && backtestFutureWatcher_->isRunning()) {
         updateStatusMessage(QStringLiteral("A native C++ backtest is already running."));
         return;
@@ -1200,6 +1237,10 @@ void TradingBotWindow::startBacktest(bool optimizerRequested) {
         batchRequest.endDisplay = endDate.toString(Qt::ISODate);
         batchRequest.loopIntervalOverride = loopInterval;
         batchRequest.connectorBackend = jsonText(request, QStringLiteral("connector_backend"));
+        if (optimizerRequested) {
+            batchRequest.checkpointPath = NativeBacktestBatchRuntime::defaultCheckpointPath();
+            batchRequest.resumeFromCheckpoint = resumeCheckpoint;
+        }
 
         const QVector<QStringList> groups = NativeBacktestBatchRuntime::buildIndicatorGroups(
             batchRequest.indicatorConfigs,
@@ -1242,14 +1283,17 @@ void TradingBotWindow::startBacktest(bool optimizerRequested) {
                 const QJsonObject snapshot = backtestFutureWatcher_->result();
                 const int addedRows = appendBacktestRows(resultsTable_, snapshot, QString());
                 backtestStopFlag_.reset();
+                // A failed resume leaves its checkpoint in place to retry.
+                const bool checkpointAvailable = offerNativeCheckpoint(resumeBacktestButton_);
                 setBacktestRunningUi(false);
                 const QString state = jsonText(snapshot, QStringLiteral("state"), QStringLiteral("failed")).toLower();
                 const QString status = backtestSnapshotStatusText(snapshot, QStringLiteral("Native C++ backtest finished."));
                 if (state == QStringLiteral("cancelled")) {
                     updateStatusMessage(
-                        QStringLiteral("Native C++ backtest cancelled: %1 row(s) imported. %2")
+                        QStringLiteral("Native C++ backtest cancelled: %1 row(s) imported. %2%3")
                             .arg(addedRows)
-                            .arg(status));
+                            .arg(status)
+                            .arg(checkpointAvailable ? QStringLiteral(" Use Resume Optimizer to continue.") : QString()));
                 } else if (state == QStringLiteral("failed")) {
                     updateStatusMessage(QStringLiteral("Native C++ backtest failed: %1").arg(status));
                 } else {
@@ -1261,6 +1305,20 @@ void TradingBotWindow::startBacktest(bool optimizerRequested) {
             });
         }
 
+        // Snapshots arrive on a batch worker thread; queued with the watcher
+        // as context, they are dropped once it is gone or the run finished.
+        QFutureWatcher<QJsonObject> *watcher = backtestFutureWatcher_;
+        batchRequest.onProgress = [this, watcher](const QJsonObject &progress) {
+            QMetaObject::invokeMethod(
+                watcher,
+                [this, watcher, progress]() {
+                    if (!watcher->isRunning()) return;
+                    updateStatusMessage(
+                        QStringLiteral("Native C++ backtest running: %1").arg(nativeBacktestProgressText(progress)));
+                },
+                Qt::QueuedConnection);
+        };
+
         setBacktestRunningUi(true);
         updateStatusMessage(
             QStringLiteral("Native C++ backtest started: %1 run(s), %2 indicator group(s).")
@@ -1290,16 +1348,7 @@ void TradingBotWindow::startBacktest(bool optimizerRequested) {
                         NativeBacktestBatchRuntime::CandleLoadResult loaded;
                         loaded.ok = fetched.ok;
                         loaded.error = fetched.error;
-                        loaded.candles.reserve(fetched.candles.size());
-                        for (const BinanceRestClient::KlineCandle &candle : fetched.candles) {
-                            loaded.candles.append({
-                                candle.open,
-                                candle.high,
-                                candle.low,
-                                candle.close,
-                                candle.volume,
-                            });
-                        }
+                        loaded.candles = NativeIndicatorRuntime::CandleColumns::fromKlines(fetched.candles);
                         return loaded;
                     };
                 return NativeBacktestBatchRuntime::runBatch(batchRequest, loader, shouldStop);
@@ -1328,6 +1377,11 @@ void TradingBotWindow::resumeBacktestCheckpoint() {
         return;
     }
 
+    if (resumeBacktestButton_->property("nativeCheckpoint").toBool()) {
+        startBacktest(true, true);
+        return;
+    }
+
     QJsonObject request;
     request.insert(QStringLiteral("queue_if_busy"), false);
     request.insert(QStringLiteral("resume_checkpoint"), true);
@@ -1414,6 +1468,7 @@ void TradingBotWindow::submitServiceBacktest(
     const bool checkpointAvailable = state == QStringLiteral("budget_exhausted");
     if (resumeBacktestButton_) {
         resumeBacktestButton_->setProperty("checkpointAvailable", checkpointAvailable);
+        resumeBacktestButton_->setProperty("nativeCheckpoint", false);
         resumeBacktestButton_->setToolTip(checkpointAvailable
             ? QStringLiteral("Resume the saved optimizer checkpoint using current Python Service API credentials.")
             : QStringLiteral("Available after the Python Service API saves an optimizer time-budget checkpoint."));
@@ -20,6 +20,7 @@ void TradingBotWindow::updateDashboardStopLossWidgetState() {
     if (!dashboardStopLossEnableCheck_) {
         return;
     }
+    dashboardRuntimeStopLoss_.setRule(dashboardStopLossRule());
     const bool runtimeActive = dashboardRuntimeActive_;
     const bool stopLossEnabled = dashboardStopLossEnableCheck_->isChecked() && !runtimeActive;
 
@@ -429,6 +429,16 @@ QString TradingBotWindow::dashboardStopLossSummary() const {
     return QStringLiteral("%1 (%2)").arg(valueText, details.join(QStringLiteral(" | ")));
 }
 
+NativePriceStream::StopLossRule TradingBotWindow::dashboardStopLossRule() const {
+    NativePriceStream::StopLossRule rule;
+    rule.enabled = dashboardStopLossEnableCheck_ && dashboardStopLossEnableCheck_->isChecked();
+    rule.limits.mode = NativeStopLoss::parseMode(comboDataOrText(dashboardStopLossModeCombo_, QStringLiteral("usdt")));
+    rule.limits.scope = NativeStopLoss::parseScope(comboDataOrText(dashboardStopLossScopeCombo_, QStringLiteral("per_trade")));
+    rule.limits.usdt = dashboardStopLossUsdtSpin_ ? dashboardStopLossUsdtSpin_->value() : 0.0;
+    rule.limits.percent = dashboardStopLossPercentSpin_ ? dashboardStopLossPercentSpin_->value() : 0.0;
+    return rule;
+}
+
 QString TradingBotWindow::dashboardStrategySummary() const {
     QStringList values;
     if (dashboardSideCombo_) {
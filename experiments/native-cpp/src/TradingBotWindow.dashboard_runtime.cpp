@@ -3,7 +3,9 @@
 #include "BinanceWsClient.h"
 #include "NativeIndicatorRuntime.h"
 #include "NativeOrderSafety.h"
+#include "NativePriceStream.h"
 #include "NativeStrategyRuntime.h"
+#include "NativeUserDataStream.h"
 #include "TradingBotWindow.dashboard_runtime_internal.h"
 #include "TradingBotWindow.dashboard_runtime_shared.h"
 
@@ -32,6 +34,7 @@
 #include <cmath>
 #include <limits>
 #include <optional>
+#include <utility>
 
 
 using namespace TradingBotWindowDashboardRuntime;
@@ -40,21 +43,8 @@ using ConnectorRuntimeConfig = TradingBotWindowSupport::ConnectorRuntimeConfig;
 
 namespace {
 
-QVector<NativeIndicatorRuntime::Candle> toNativeIndicatorCandles(
-    const QVector<BinanceRestClient::KlineCandle> &candles
-) {
-    QVector<NativeIndicatorRuntime::Candle> result;
-    result.reserve(candles.size());
-    for (const BinanceRestClient::KlineCandle &candle : candles) {
-        result.push_back({
-            candle.open,
-            candle.high,
-            candle.low,
-            candle.close,
-            candle.volume,
-        });
-    }
-    return result;
+NativeIndicatorRuntime::Candle toNativeCandle(const BinanceRestClient::KlineCandle &candle) {
+    return {candle.open, candle.high, candle.low, candle.close, candle.volume};
 }
 
 NativeIndicatorRuntime::ConfigMap nativeIndicatorConfigsForKeys(
@@ -83,20 +73,17 @@ std::optional<double> optionalIndicatorThreshold(
 }
 
 NativeStrategyRuntime::StrategySignalInput nativeSignalInput(
-    const QVector<NativeIndicatorRuntime::Candle> &candles,
+    const NativeIndicatorRuntime::RecentSeries &recent,
     const NativeIndicatorRuntime::ConfigMap &configs,
     const QMap<QString, QVariantMap> &indicatorParams,
     const QString &side
 ) {
     NativeStrategyRuntime::StrategySignalInput input;
     input.side = side;
-    // Closed-candle mode removes the incomplete candle before this conversion.
+    // Closed-candle mode leaves the incomplete candle out of `recent`.
     input.useLiveValues = true;
-    input.indicators = NativeIndicatorRuntime::computeConfiguredSeries(candles, configs);
-    input.closes.reserve(candles.size());
-    for (const NativeIndicatorRuntime::Candle &candle : candles) {
-        input.closes.push_back(candle.close);
-    }
+    input.indicators = recent.indicators;
+    input.closes = recent.closes;
     for (auto iterator = configs.cbegin(); iterator != configs.cend(); ++iterator) {
         const QVariantMap config = indicatorParams.value(iterator.key());
         input.rules.insert(iterator.key(), NativeStrategyRuntime::IndicatorRule{
@@ -157,11 +144,53 @@ QString formatNativeIndicatorSummary(
     return parts.isEmpty() ? QStringLiteral("-") : parts.join(QStringLiteral(" | "));
 }
 
+QString runtimeConnectorCacheKey(const ConnectorRuntimeConfig &cfg, bool isTestnet) {
+    return QStringLiteral("%1|%2|%3")
+        .arg(cfg.key.trimmed().toLower(),
+             cfg.baseUrl.trimmed().toLower(),
+             isTestnet ? QStringLiteral("testnet") : QStringLiteral("live"));
+}
+
+// Key of a symbol's exchange filters and ticker price on one connector.
+QString runtimeSymbolCacheKey(const QString &symbol, const ConnectorRuntimeConfig &cfg, bool isTestnet) {
+    return QStringLiteral("%1|%2")
+        .arg(symbol.trimmed().toUpper(), runtimeConnectorCacheKey(cfg, isTestnet));
+}
+
+// Last account balance seen by the runtime; refetched after five seconds.
+struct RuntimeBalanceCache {
+    QString key;
+    qint64 updatedMs = 0;
+    bool valid = false;
+    double total = 0.0;
+    double available = 0.0;
+};
+
+constexpr qint64 kRuntimeBalanceCacheMs = 5000;
+
+RuntimeBalanceCache &runtimeBalanceCache() {
+    static RuntimeBalanceCache cache;
+    return cache;
+}
+
+QString runtimeBalanceCacheKey(const QString &apiKey, bool futures, bool isTestnet, const QString &baseUrl) {
+    return QStringLiteral("%1|%2|%3|%4")
+        .arg(apiKey.trimmed(),
+             futures ? QStringLiteral("futures") : QStringLiteral("spot"),
+             isTestnet ? QStringLiteral("testnet") : QStringLiteral("live"),
+             baseUrl.trimmed().toLower());
+}
+
+bool runtimeBalanceCacheFresh(const QString &cacheKey, qint64 nowMs) {
+    const RuntimeBalanceCache &cache = runtimeBalanceCache();
+    return cache.valid && cache.key == cacheKey && (nowMs - cache.updatedMs) <= kRuntimeBalanceCacheMs;
+}
+
 } // namespace
 
 void TradingBotWindow::refreshDashboardOpenPositionIndicatorValuesForSignalKey(
     const QString &signalKey,
-    const QVector<BinanceRestClient::KlineCandle> &marketCandles) {
+    const NativeMarketDataHub::CandleView &marketCandles) {
     if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_ || !positionsTable_ || marketCandles.isEmpty()) {
         return;
     }
@@ -203,9 +232,13 @@ void TradingBotWindow::refreshDashboardOpenPositionIndicatorValuesForSignalKey(
         const NativeIndicatorRuntime::ConfigMap displayConfigs =
             nativeIndicatorConfigsForKeys(displayIndicatorKeys, dashboardIndicatorParams_);
         const NativeIndicatorRuntime::SeriesMap displaySeries =
-            NativeIndicatorRuntime::computeConfiguredSeries(
-                toNativeIndicatorCandles(marketCandles),
-                displayConfigs);
+            syncDashboardRuntimeIndicatorSet(
+                signalKey,
+                displayConfigs,
+                marketCandles,
+                dashboardRuntimeMarketData_->latestClosed(dashboardRuntimeMarketData_->feedOf(signalKey)))
+                .recent(true)
+                .indicators;
 
         const int targetRow = findOpenPositionRow(positionsTable_, symbol, openPos.interval, openPos.connectorKey);
         if (targetRow < 0) {
@@ -226,6 +259,125 @@ void TradingBotWindow::refreshDashboardOpenPositionIndicatorValuesForSignalKey(
     applyPositionsViewMode(false, false);
 }
 
+const NativeIndicatorRuntime::IncrementalIndicatorSet &TradingBotWindow::syncDashboardRuntimeIndicatorSet(
+    const QString &signalKey,
+    const NativeIndicatorRuntime::ConfigMap &configs,
+    const NativeMarketDataHub::CandleView &marketCandles,
+    bool latestCandleClosed) {
+    const QString stateKey = QStringLiteral("%1|%2").arg(signalKey, configs.keys().join(QLatin1Char(',')));
+    NativeIndicatorRuntime::IncrementalIndicatorSet &set = dashboardRuntimeIndicatorSets_[stateKey];
+    qint64 &lastClosedOpenTimeMs = dashboardRuntimeIndicatorOpenTimeMs_[stateKey];
+    const qsizetype closedCount = latestCandleClosed ? marketCandles.size() : marketCandles.size() - 1;
+
+    // Only candles after the last committed one are appended. A snapshot that
+    // no longer contains that candle (a reconnect gap, a fresh seed) or
+    // changed indicator parameters rebuild the set from the snapshot.
+    qsizetype next = -1;
+    if (set.size() > 0 && set.configs() == configs) {
+        for (qsizetype index = closedCount - 1; index >= 0; --index) {
+            const qint64 openTimeMs = marketCandles.at(index).openTimeMs;
+            if (openTimeMs <= lastClosedOpenTimeMs) {
+                next = openTimeMs == lastClosedOpenTimeMs ? index + 1 : -1;
+                break;
+            }
+        }
+        if (closedCount <= 0 || marketCandles.constFirst().openTimeMs > lastClosedOpenTimeMs) {
+            next = -1;
+        }
+    }
+    if (next < 0) {
+        set = NativeIndicatorRuntime::IncrementalIndicatorSet(configs);
+        next = 0;
+    }
+    for (qsizetype index = next; index < closedCount; ++index) {
+        set.appendClosed(toNativeCandle(marketCandles.at(index)));
+    }
+    if (closedCount > 0) {
+        lastClosedOpenTimeMs = marketCandles.at(closedCount - 1).openTimeMs;
+    }
+    if (closedCount < marketCandles.size()) {
+        set.previewOpen(toNativeCandle(marketCandles.constLast()));
+    } else {
+        set.clearPreview();
+    }
+    return set;
+}
+
+NativeUserDataStream::Client *TradingBotWindow::dashboardUserDataStream(
+    const QString &connectorCacheKey,
+    bool testnet,
+    const QString &baseUrl,
+    const QString &apiKey,
+    const QString &apiSecret) {
+    if (!qtWebSocketsRuntimeAvailable()) {
+        return nullptr;
+    }
+    NativeUserDataStream::Client *&stream = dashboardUserDataStreams_[connectorCacheKey];
+    if (!stream) {
+        stream = new NativeUserDataStream::Client(this);
+        connect(stream, &NativeUserDataStream::Client::errorOccurred, this, [this, connectorCacheKey](const QString &message) {
+            const QString warningKey = QStringLiteral("user-data|%1|%2").arg(connectorCacheKey, message);
+            if (!dashboardRuntimeConnectorWarnings_.contains(warningKey)) {
+                dashboardRuntimeConnectorWarnings_.insert(warningKey);
+                appendDashboardPositionLog(
+                    QStringLiteral("Account stream (%1): %2; positions fall back to REST until it resyncs.")
+                        .arg(connectorCacheKey.section(QLatin1Char('|'), 0, 0), message));
+            }
+        });
+    }
+    stream->start(apiKey, apiSecret, testnet, baseUrl);
+    return stream;
+}
+
+void TradingBotWindow::checkDashboardRuntimeStopLoss(NativeSymbolTable::SymbolId symbolId) {
+    if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_ || !dashboardPriceStream_
+        || !dashboardRuntimeStopLoss_.enforced()) {
+        return;
+    }
+    const double markPrice =
+        dashboardPriceStream_->table().markPrice(symbolId, QDateTime::currentMSecsSinceEpoch());
+    if (markPrice <= 0.0) {
+        return;
+    }
+    const QStringList flagged = dashboardRuntimeStopLoss_.flagMark(
+        symbolId,
+        markPrice,
+        [this](const QString &runtimeKey, NativePriceStream::StopLossWatch::Position *position) {
+            const auto posIt = dashboardRuntimeOpenPositions_.constFind(runtimeKey);
+            if (posIt == dashboardRuntimeOpenPositions_.cend()) {
+                return false;
+            }
+            const RuntimePosition &pos = posIt.value();
+            *position = {pos.side == QStringLiteral("LONG"), pos.entryPrice, pos.quantity, pos.roiBasisUsdt};
+            return true;
+        });
+    for (const QString &runtimeKey : flagged) {
+        const RuntimePosition pos = dashboardRuntimeOpenPositions_.value(runtimeKey);
+        appendDashboardPositionLog(
+            QString("%1 %2@%3 stop-loss reached at mark %4 (%5); closing.")
+                .arg(pos.side,
+                     NativeSymbolTable::name(symbolId),
+                     pos.interval,
+                     QString::number(markPrice, 'f', 6),
+                     dashboardStopLossSummary()));
+    }
+    if (!flagged.isEmpty()) {
+        // The cycle closes flagged positions whether or not their loop
+        // interval is due.
+        QTimer::singleShot(0, this, &TradingBotWindow::runDashboardRuntimeCycle);
+    }
+}
+
+void TradingBotWindow::rebuildDashboardRuntimeStopLossIndex() {
+    dashboardRuntimeStopLoss_.clearWatched();
+    for (auto it = dashboardRuntimeOpenPositions_.cbegin(); it != dashboardRuntimeOpenPositions_.cend(); ++it) {
+        const QString symbol = it.key().section('|', 0, 0).trimmed().toUpper();
+        if (!symbol.isEmpty()) {
+            dashboardRuntimeStopLoss_.watch(NativeSymbolTable::intern(symbol), it.key());
+        }
+    }
+}
+
 void TradingBotWindow::runDashboardRuntimeCycle() {
     if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_ || dashboardRuntimeCycleInProgress_) {
         return;
@@ -233,6 +385,219 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
     if (!dashboardOverridesTable_ || dashboardOverridesTable_->rowCount() <= 0) {
         return;
     }
+    if (!dashboardRuntimeEngine_) {
+        dashboardRuntimeEngine_ = new NativeDashboardEngine::Engine(this);
+        connect(
+            dashboardRuntimeEngine_,
+            &NativeDashboardEngine::Engine::cycleReady,
+            this,
+            &TradingBotWindow::applyDashboardRuntimeCycle);
+        connect(
+            dashboardRuntimeEngine_,
+            &NativeDashboardEngine::Engine::ordersReady,
+            this,
+            &TradingBotWindow::applyDashboardRuntimeOrders);
+        // Opens retry without positionSide and closes fall back to limit
+        // orders the way the synchronous path always did.
+        dashboardRuntimeEngine_->setOrderPlacer(
+            [](const NativeDashboardEngine::OrderBatch &batch, const NativeDashboardEngine::OrderRequest &request) {
+                if (request.opening) {
+                    return placeFuturesOpenOrderWithFallback(
+                        batch.apiKey,
+                        batch.apiSecret,
+                        request.symbol,
+                        request.side,
+                        request.quantity,
+                        batch.testnet,
+                        request.positionSide,
+                        10000,
+                        request.baseUrl);
+                }
+                return placeFuturesCloseOrderWithFallback(
+                    batch.apiKey,
+                    batch.apiSecret,
+                    request.symbol,
+                    request.side,
+                    request.quantity,
+                    batch.testnet,
+                    request.reduceOnly,
+                    request.positionSide,
+                    10000,
+                    request.baseUrl,
+                    request.referencePrice);
+            });
+    }
+    if (!dashboardRuntimeMarketData_) {
+        dashboardRuntimeMarketData_ = new NativeMarketDataHub::Hub(NativeMarketDataHub::kDefaultCapacity, this);
+        connect(
+            dashboardRuntimeMarketData_,
+            &NativeMarketDataHub::Hub::candlesUpdated,
+            this,
+            [this](const QString &signalKey, const QString &feedKey) {
+                refreshDashboardOpenPositionIndicatorValuesForSignalKey(
+                    signalKey,
+                    dashboardRuntimeMarketData_->view(feedKey));
+            });
+    }
+    if (dashboardRuntimeEngine_->busy()) {
+        return;
+    }
+
+    // Snapshot what this cycle has to fetch; the engine does the network
+    // work off the UI thread and hands the results to
+    // applyDashboardRuntimeCycle().
+    NativeDashboardEngine::CyclePlan plan;
+    plan.plannedAtMs = QDateTime::currentMSecsSinceEpoch();
+    const bool futures = dashboardAccountTypeCombo_
+        ? dashboardAccountTypeCombo_->currentText().trimmed().toLower().startsWith("fut")
+        : true;
+    const QString modeText = dashboardModeCombo_ ? dashboardModeCombo_->currentText() : QStringLiteral("Live");
+    const bool paperTrading = TradingBotWindowSupport::isPaperTradingModeLabel(modeText);
+    const bool isTestnet = TradingBotWindowSupport::isTestnetModeLabel(modeText);
+    const QString indicatorSourceKey = normalizedIndicatorSourceKey(
+        dashboardIndicatorSourceCombo_
+            ? dashboardIndicatorSourceCombo_->currentText().trimmed()
+            : QStringLiteral("Binance futures"));
+    const bool indicatorUsesBinanceFutures = indicatorSourceKey == QStringLiteral("binance_futures");
+    const bool indicatorUsesBinanceSpot = indicatorSourceKey == QStringLiteral("binance_spot");
+    const bool useWebSocketFeed = normalizedSignalFeedKey(
+                                      dashboardSignalFeedCombo_
+                                          ? dashboardSignalFeedCombo_->currentText().trimmed()
+                                          : QStringLiteral("REST Poll"))
+            == QStringLiteral("websocket")
+        && qtWebSocketsRuntimeAvailable();
+    const QString defaultConnectorText = dashboardConnectorCombo_
+        ? dashboardConnectorCombo_->currentText().trimmed()
+        : TradingBotWindowSupport::connectorLabelForKey(TradingBotWindowSupport::recommendedConnectorKey(futures));
+    const ConnectorRuntimeConfig defaultConnectorCfg = TradingBotWindowSupport::resolveConnectorConfig(defaultConnectorText, futures);
+    plan.apiKey = dashboardApiKey_ ? dashboardApiKey_->text().trimmed() : QString();
+    plan.apiSecret = dashboardApiSecret_ ? dashboardApiSecret_->text().trimmed() : QString();
+    plan.testnet = isTestnet;
+    const bool hasApiCredentials = !plan.apiKey.isEmpty() && !plan.apiSecret.isEmpty();
+    const bool livePositionsAvailable = !paperTrading && futures && hasApiCredentials;
+
+    // A synced user-data stream already holds the connector's positions and
+    // balance; REST is only planned for connectors without one.
+    const auto accountStreamSynced = [&](const ConnectorRuntimeConfig &cfg) {
+        const NativeUserDataStream::Client *stream = livePositionsAvailable
+            ? dashboardUserDataStream(
+                  runtimeConnectorCacheKey(cfg, isTestnet), isTestnet, cfg.baseUrl, plan.apiKey, plan.apiSecret)
+            : nullptr;
+        return stream && stream->isSynced();
+    };
+
+    const auto streamedBookFresh = [this, &plan](const QString &symbol) {
+        if (!dashboardPriceStream_) {
+            return false;
+        }
+        const NativeSymbolTable::SymbolId symbolId = NativeSymbolTable::find(symbol);
+        return dashboardPriceStream_->table().executionPrice(symbolId, true, plan.plannedAtMs) > 0.0
+            && dashboardPriceStream_->table().executionPrice(symbolId, false, plan.plannedAtMs) > 0.0;
+    };
+
+    if (defaultConnectorCfg.ok() && !paperTrading && hasApiCredentials) {
+        plan.balanceFutures = futures;
+        plan.balanceBaseUrl = defaultConnectorCfg.baseUrl;
+        plan.fetchBalance = !accountStreamSynced(defaultConnectorCfg)
+            && !runtimeBalanceCacheFresh(
+                runtimeBalanceCacheKey(plan.apiKey, futures, isTestnet, defaultConnectorCfg.baseUrl),
+                plan.plannedAtMs);
+    }
+
+    for (int row = 0; row < dashboardOverridesTable_->rowCount(); ++row) {
+        const auto *symbolItem = dashboardOverridesTable_->item(row, 0);
+        const auto *intervalItem = dashboardOverridesTable_->item(row, 1);
+        if (!symbolItem || !intervalItem) {
+            continue;
+        }
+        const QString symbol = symbolItem->text().trimmed().toUpper();
+        const QString interval = intervalItem->text().trimmed();
+        if (symbol.isEmpty() || interval.isEmpty()) {
+            continue;
+        }
+        const auto *connectorItem = dashboardOverridesTable_->item(row, 5);
+        const QString rowConnectorText = connectorItem && !connectorItem->text().trimmed().isEmpty()
+            ? connectorItem->text().trimmed()
+            : defaultConnectorText;
+        const ConnectorRuntimeConfig rowConnectorCfg = TradingBotWindowSupport::resolveConnectorConfig(rowConnectorText, futures);
+        if (!rowConnectorCfg.ok()) {
+            continue;
+        }
+        const QString connectorToken = rowConnectorCfg.key + "|" + rowConnectorCfg.baseUrl;
+        const QString key = runtimeKeyFor(symbol, interval, connectorToken);
+        if (dashboardRuntimeEntryRetryAfterMs_.value(key, 0) > plan.plannedAtMs) {
+            continue;
+        }
+        const auto *loopItem = dashboardOverridesTable_->item(row, 3);
+        const qint64 loopSeconds = std::max<qint64>(0, loopSecondsFromText(loopItem ? loopItem->text() : QString()));
+        const qint64 lastMs = dashboardRuntimeLastEvalMs_.value(key, 0);
+        const bool hasOpenPosition = dashboardRuntimeOpenPositions_.contains(key);
+        const bool evaluationDue = !(loopSeconds > 0 && lastMs > 0 && (plan.plannedAtMs - lastMs) < (loopSeconds * 1000));
+        if (!evaluationDue && !hasOpenPosition) {
+            continue;
+        }
+        if (hasOpenPosition && livePositionsAvailable && !accountStreamSynced(rowConnectorCfg)) {
+            plan.positions.append({runtimeConnectorCacheKey(rowConnectorCfg, isTestnet), rowConnectorCfg.baseUrl});
+        }
+        if (evaluationDue && !hasOpenPosition && futures && (paperTrading || hasApiCredentials)) {
+            // A row that may open needs the symbol's filters to size the
+            // order, and a price to size it at when the stream has no book.
+            const NativeDashboardEngine::SymbolRequest symbolRequest{
+                runtimeSymbolCacheKey(symbol, rowConnectorCfg, isTestnet),
+                symbol,
+                rowConnectorCfg.baseUrl,
+            };
+            plan.symbolFilters.append(symbolRequest);
+            if (!paperTrading && !streamedBookFresh(symbol)) {
+                plan.tickerPrices.append(symbolRequest);
+            }
+        }
+        if (!indicatorUsesBinanceFutures && !indicatorUsesBinanceSpot) {
+            continue;
+        }
+        const QString requestInterval = normalizeBinanceKlineInterval(interval, nullptr);
+        const QString feedKey = NativeMarketDataHub::feedKey(
+            connectorToken,
+            indicatorUsesBinanceFutures,
+            symbol,
+            requestInterval);
+        if (useWebSocketFeed && dashboardRuntimeMarketData_->isSeeded(feedKey)) {
+            continue;
+        }
+        // Seeded feeds only fetch the candles they are missing.
+        plan.klines.append({
+            feedKey,
+            symbol,
+            requestInterval,
+            indicatorUsesBinanceFutures,
+            isTestnet && indicatorUsesBinanceFutures,
+            dashboardRuntimeMarketData_->fetchLimit(
+                feedKey,
+                intervalTokenToSeconds(requestInterval) * 1000,
+                plan.plannedAtMs),
+            rowConnectorCfg.baseUrl,
+        });
+    }
+
+    if (plan.isEmpty()) {
+        // Nothing to wait for: evaluate against the streamed candles now.
+        NativeDashboardEngine::CycleData immediate;
+        immediate.plannedAtMs = plan.plannedAtMs;
+        immediate.finishedAtMs = plan.plannedAtMs;
+        applyDashboardRuntimeCycle(std::make_shared<const NativeDashboardEngine::CycleData>(std::move(immediate)));
+        return;
+    }
+    dashboardRuntimeEngine_->submit(std::move(plan));
+}
+
+void TradingBotWindow::applyDashboardRuntimeCycle(const NativeDashboardEngine::CycleDataPtr &prefetched) {
+    if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_ || dashboardRuntimeCycleInProgress_
+        || !dashboardRuntimeMarketData_) {
+        return;
+    }
+    if (!dashboardOverridesTable_ || dashboardOverridesTable_->rowCount() <= 0) {
+        return;
+    }
     dashboardRuntimeCycleInProgress_ = true;
     struct RuntimeCycleGuard final {
         bool *flag = nullptr;
@@ -303,8 +668,6 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
                                                          ? dashboardAccountTypeCombo_->currentText().trimmed().toLower()
                                                          : QStringLiteral("futures"),
                                                      modeText.trimmed().toLower());
-    QMap<QString, BinanceRestClient::FuturesSymbolFilters> symbolFiltersCache;
-    QMap<QString, BinanceRestClient::TickerPriceResult> tickerPriceCache;
     QMap<QString, BinanceRestClient::FuturesPositionsResult> livePositionsCache;
     static QMap<QString, BinanceRestClient::FuturesPositionsResult> s_stickyLivePositionsCache;
     static QMap<QString, qint64> s_stickyLivePositionsCacheMs;
@@ -326,38 +689,57 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
         return activePnl;
     };
     const auto connectorCacheKeyFor = [isTestnet](const ConnectorRuntimeConfig &cfg) {
-        return QStringLiteral("%1|%2|%3")
-            .arg(cfg.key.trimmed().toLower(),
-                 cfg.baseUrl.trimmed().toLower(),
-                 isTestnet ? QStringLiteral("testnet") : QStringLiteral("live"));
+        return runtimeConnectorCacheKey(cfg, isTestnet);
     };
-    const auto tickerCacheKeyFor = [isTestnet](const QString &symbol, const ConnectorRuntimeConfig &cfg) {
-        return QStringLiteral("%1|%2|%3|%4")
-            .arg(symbol.trimmed().toUpper(),
-                 cfg.key.trimmed().toLower(),
-                 cfg.baseUrl.trimmed().toLower(),
-                 isTestnet ? QStringLiteral("testnet") : QStringLiteral("live"));
+    // Snapshots fetched by the engine for this cycle, each used once.
+    QHash<QString, BinanceRestClient::FuturesPositionsResult> prefetchedPositions = prefetched->positions;
+    const auto syncedAccountStream =
+        [this, &connectorCacheKeyFor](const ConnectorRuntimeConfig &cfg) -> const NativeUserDataStream::Client * {
+        const NativeUserDataStream::Client *stream =
+            dashboardUserDataStreams_.value(connectorCacheKeyFor(cfg), nullptr);
+        return stream && stream->isRunning() && stream->isSynced() ? stream : nullptr;
     };
-    const auto fetchExecutionTickerPrice =
-        [isTestnet, &tickerPriceCache, &tickerCacheKeyFor](
+    // Connectors the last order batch went to: the snapshot the engine took
+    // after placing it confirms the fills over REST instead of racing the
+    // stream's ACCOUNT_UPDATE. A snapshot planned for this cycle is newer.
+    QSet<QString> orderRefreshConnectors;
+    for (auto it = dashboardRuntimeOrderPositions_.cbegin(); it != dashboardRuntimeOrderPositions_.cend(); ++it) {
+        orderRefreshConnectors.insert(it.key());
+        if (!prefetchedPositions.contains(it.key())) {
+            prefetchedPositions.insert(it.key(), it.value());
+        }
+    }
+    dashboardRuntimeOrderPositions_.clear();
+    // The streamed mark price while it is fresh; 0 otherwise.
+    const auto streamedMarkPrice = [this](const QString &symbol) {
+        return dashboardPriceStream_
+            ? dashboardPriceStream_->table().markPrice(
+                  NativeSymbolTable::find(symbol), QDateTime::currentMSecsSinceEpoch())
+            : 0.0;
+    };
+    // The streamed book side while it is fresh, else the /ticker/price the
+    // engine fetched for this cycle; 0 when neither is available.
+    const auto fetchExecutionPrice =
+        [this, isTestnet, &prefetched](
             const QString &symbol,
-            const ConnectorRuntimeConfig &cfg) -> const BinanceRestClient::TickerPriceResult * {
+            const ConnectorRuntimeConfig &cfg,
+            bool buy) -> double {
         if (!cfg.ok()) {
-            return nullptr;
+            return 0.0;
         }
-        const QString cacheKey = tickerCacheKeyFor(symbol, cfg);
-        auto it = tickerPriceCache.find(cacheKey);
-        if (it == tickerPriceCache.end()) {
-            it = tickerPriceCache.insert(
-                cacheKey,
-                BinanceRestClient::fetchTickerPrice(
-                    symbol,
-                    true,
-                    isTestnet,
-                    5000,
-                    cfg.baseUrl));
+        const double streamed = dashboardPriceStream_
+            ? dashboardPriceStream_->table().executionPrice(
+                  NativeSymbolTable::find(symbol), buy, QDateTime::currentMSecsSinceEpoch())
+            : 0.0;
+        if (streamed > 0.0) {
+            return streamed;
         }
-        return &it.value();
+        const auto it = prefetched->tickerPrices.constFind(runtimeSymbolCacheKey(symbol, cfg, isTestnet));
+        if (it == prefetched->tickerPrices.cend()) {
+            return 0.0;
+        }
+        const BinanceRestClient::TickerPriceResult &ticker = it.value();
+        return ticker.ok && qIsFinite(ticker.price) && ticker.price > 0.0 ? ticker.price : 0.0;
     };
     const auto hasTrackedOpenPositionsForConnector =
         [this](const ConnectorRuntimeConfig &cfg) -> bool {
@@ -373,20 +755,27 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
         return false;
     };
     const auto fetchLivePositionsForConnector =
-        [this, futures, hasApiCredentials, paperTrading, &apiKey, &apiSecret, isTestnet, &livePositionsCache, &connectorCacheKeyFor, &hasTrackedOpenPositionsForConnector](
+        [this, futures, hasApiCredentials, paperTrading, &apiKey, &apiSecret, isTestnet, &livePositionsCache, &prefetchedPositions, &connectorCacheKeyFor, &hasTrackedOpenPositionsForConnector, &syncedAccountStream, &orderRefreshConnectors](
             const ConnectorRuntimeConfig &cfg) -> const BinanceRestClient::FuturesPositionsResult * {
         if (paperTrading || !futures || !hasApiCredentials || !cfg.ok()) {
             return nullptr;
         }
         const QString cacheKey = connectorCacheKeyFor(cfg);
         auto it = livePositionsCache.find(cacheKey);
+        const NativeUserDataStream::Client *stream = syncedAccountStream(cfg);
+        if (it == livePositionsCache.end() && stream && !orderRefreshConnectors.contains(cacheKey)) {
+            it = livePositionsCache.insert(cacheKey, stream->state().positions());
+        }
         if (it == livePositionsCache.end()) {
-            const auto result = BinanceRestClient::fetchOpenFuturesPositions(
-                apiKey,
-                apiSecret,
-                isTestnet,
-                10000,
-                cfg.baseUrl);
+            const auto prefetchedIt = prefetchedPositions.find(cacheKey);
+            const auto result = prefetchedIt != prefetchedPositions.end()
+                ? prefetchedPositions.take(cacheKey)
+                : BinanceRestClient::fetchOpenFuturesPositions(
+                      apiKey,
+                      apiSecret,
+                      isTestnet,
+                      10000,
+                      cfg.baseUrl);
             it = livePositionsCache.insert(cacheKey, result);
             if (!result.ok) {
                 const QString warningKey = QStringLiteral("live-positions|%1|%2")
@@ -419,40 +808,8 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
         [hedgeMode](
             const BinanceRestClient::FuturesPositionsResult *snapshot,
             const QString &symbol,
-            const QString &runtimeSide) -> const BinanceRestClient::FuturesPosition * {
-        if (!snapshot || !snapshot->ok) {
-            return nullptr;
-        }
-        const QString sym = symbol.trimmed().toUpper();
-        const QString side = runtimeSide.trimmed().toUpper();
-        const BinanceRestClient::FuturesPosition *best = nullptr;
-        double bestAbsAmt = 0.0;
-        for (const auto &pos : snapshot->positions) {
-            if (pos.symbol.trimmed().toUpper() != sym) {
-                continue;
-            }
-            const double absAmt = std::fabs(pos.positionAmt);
-            if (absAmt <= 1e-10) {
-                continue;
-            }
-            const QString posSide = pos.positionSide.trimmed().toUpper();
-            const bool sideMatches = (side == QStringLiteral("LONG") && pos.positionAmt > 0.0)
-                || (side == QStringLiteral("SHORT") && pos.positionAmt < 0.0)
-                || side.isEmpty();
-            if (hedgeMode) {
-                if ((side == QStringLiteral("LONG") && posSide == QStringLiteral("LONG"))
-                    || (side == QStringLiteral("SHORT") && posSide == QStringLiteral("SHORT"))) {
-                    return &pos;
-                }
-            } else if ((posSide.isEmpty() || posSide == QStringLiteral("BOTH")) && sideMatches) {
-                return &pos;
-            }
-            if (sideMatches && absAmt > bestAbsAmt) {
-                bestAbsAmt = absAmt;
-                best = &pos;
-            }
-        }
-        return best;
+            const QString &runtimeSide) {
+        return pickLiveFuturesPosition(snapshot, symbol, runtimeSide, hedgeMode);
     };
     QMap<QString, double> runtimeQtyByExposureKey;
     for (auto it = dashboardRuntimeOpenPositions_.cbegin(); it != dashboardRuntimeOpenPositions_.cend(); ++it) {
@@ -470,31 +827,76 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
             runtimeQtyByExposureKey[exposureKey] += qty;
         }
     }
+    // Every fetched page lands in the hub once, however many rows share its
+    // feed; rows then read the feed's ring instead of their own copy.
+    for (auto it = prefetched->klines.cbegin(); it != prefetched->klines.cend(); ++it) {
+        if (it.value().ok) {
+            dashboardRuntimeMarketData_->ingest(it.key(), it.value().candles);
+        }
+    }
+    // Mark and book prices follow every runtime symbol; until a symbol's
+    // first update the rows keep using /ticker/price and the candle close.
+    if (futures && qtWebSocketsRuntimeAvailable()) {
+        if (!dashboardPriceStream_) {
+            dashboardPriceStream_ = new NativePriceStream::Service(this);
+            connect(
+                dashboardPriceStream_,
+                &NativePriceStream::Service::markUpdated,
+                this,
+                &TradingBotWindow::checkDashboardRuntimeStopLoss);
+            connect(dashboardPriceStream_, &NativePriceStream::Service::errorOccurred, this, [this](const QString &message) {
+                const QString warningKey = QStringLiteral("price-stream|%1").arg(message);
+                if (!dashboardRuntimeConnectorWarnings_.contains(warningKey)) {
+                    dashboardRuntimeConnectorWarnings_.insert(warningKey);
+                    appendDashboardAllLog(QString("Price stream error: %1").arg(message));
+                }
+            });
+        }
+        QStringList priceSymbols;
+        for (int row = 0; row < dashboardOverridesTable_->rowCount(); ++row) {
+            if (const auto *symbolItem = dashboardOverridesTable_->item(row, 0)) {
+                priceSymbols.append(symbolItem->text());
+            }
+        }
+        for (auto it = dashboardRuntimeOpenPositions_.cbegin(); it != dashboardRuntimeOpenPositions_.cend(); ++it) {
+            priceSymbols.append(it.key().section('|', 0, 0));
+        }
+        dashboardPriceStream_->setMarket(true, isTestnet);
+        dashboardPriceStream_->setSymbols(priceSymbols);
+    }
+    dashboardRuntimeStopLoss_.setRule(dashboardStopLossRule());
+    const NativePriceStream::StopLossRule &stopLossRule = dashboardRuntimeStopLoss_.rule();
+    if (stopLossRule.enabled && !dashboardRuntimeStopLoss_.enforced()) {
+        const QString scopeName = NativeStopLoss::scopeName(stopLossRule.limits.scope);
+        const QString warningKey = QStringLiteral("stop-loss-scope|%1").arg(scopeName);
+        if (!dashboardRuntimeConnectorWarnings_.contains(warningKey)) {
+            dashboardRuntimeConnectorWarnings_.insert(warningKey);
+            appendDashboardAllLog(
+                QString("Stop-loss scope %1 is not enforced live yet; only per_trade closes positions.")
+                    .arg(scopeName));
+        }
+    }
+    rebuildDashboardRuntimeStopLossIndex();
+    for (const QString &runtimeKey : QStringList(dashboardRuntimeStopLoss_.closingKeys().values())) {
+        if (!dashboardRuntimeOpenPositions_.contains(runtimeKey)) {
+            dashboardRuntimeStopLoss_.finishClose(runtimeKey);
+        }
+    }
     const auto ensureSignalStreamForKey =
-        [this, useWebSocketFeed, isTestnet]
+        [this, useWebSocketFeed, isTestnet, &prefetched]
         (const QString &signalKey,
+         const QString &feedKey,
          const QString &symbol,
          const QString &requestInterval,
-         bool signalUsesFutures,
-         const QString &baseUrl) -> bool {
+         bool signalUsesFutures) -> bool {
         if (!useWebSocketFeed) {
             return false;
         }
 
-        if (!dashboardRuntimeSignalCandles_.contains(signalKey)) {
-            const auto seed = BinanceRestClient::fetchKlines(
-                symbol,
-                requestInterval,
-                signalUsesFutures,
-                isTestnet && signalUsesFutures,
-                240,
-                10000,
-                baseUrl);
-            if (seed.ok && !seed.candles.isEmpty()) {
-                dashboardRuntimeSignalCandles_.insert(signalKey, seed.candles);
-                dashboardRuntimeSignalLastClosed_.insert(signalKey, false);
-                dashboardRuntimeSignalUpdateMs_.insert(signalKey, QDateTime::currentMSecsSinceEpoch());
-            } else {
+        const auto seedIt = prefetched->klines.constFind(feedKey);
+        if (!dashboardRuntimeMarketData_->isSeeded(feedKey) && seedIt != prefetched->klines.cend()) {
+            const auto &seed = seedIt.value();
+            if (!seed.ok || seed.candles.isEmpty()) {
                 const QString warningKey = QStringLiteral("signal-seed|%1|%2").arg(signalKey, seed.error);
                 if (!dashboardRuntimeConnectorWarnings_.contains(warningKey)) {
                     dashboardRuntimeConnectorWarnings_.insert(warningKey);
@@ -505,61 +907,43 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
             }
         }
 
-        if (dashboardRuntimeSignalSockets_.contains(signalKey)) {
-            return dashboardRuntimeSignalCandles_.contains(signalKey)
-                && !dashboardRuntimeSignalCandles_.value(signalKey).isEmpty();
-        }
-
-        auto *client = new BinanceWsClient(this);
-        const QString symbolKey = symbol.trimmed().toUpper();
-        const QString intervalKey = requestInterval.trimmed().toLower();
-        connect(client, &BinanceWsClient::kline, this, [this, signalKey, symbolKey, intervalKey](
-                                                        const QString &streamSymbol,
-                                                        const QString &streamInterval,
-                                                        qint64 openTimeMs,
-                                                        double open,
-                                                        double high,
-                                                        double low,
-                                                        double close,
-                                                        double volume,
-                                                        bool isClosed) {
-            if (streamSymbol.trimmed().toUpper() != symbolKey
-                || streamInterval.trimmed().toLower() != intervalKey) {
-                return;
-            }
-            BinanceRestClient::KlineCandle candle;
-            candle.openTimeMs = openTimeMs;
-            candle.open = open;
-            candle.high = high;
-            candle.low = low;
-            candle.close = close;
-            candle.volume = volume;
-            auto &cache = dashboardRuntimeSignalCandles_[signalKey];
-            if (!cache.isEmpty() && cache.constLast().openTimeMs == openTimeMs) {
-                cache.last() = candle;
-            } else {
-                cache.push_back(candle);
-                if (cache.size() > 240) {
-                    cache.remove(0, cache.size() - 240);
+        if (!dashboardRuntimeSignalStream_) {
+            // One multiplexed client for every feed: streams share sockets,
+            // and the hub fans each tick out to the signal keys on the feed.
+            auto *stream = new BinanceWsClient(this);
+            connect(stream, &BinanceWsClient::subscriptionTick, this, [this](const QString &streamKey, const BinanceWsClient::Tick &tick) {
+                if (tick.type != BinanceWsClient::Tick::Type::Kline || !dashboardRuntimeMarketData_) {
+                    return;
                 }
-            }
-            dashboardRuntimeSignalLastClosed_[signalKey] = isClosed;
-            dashboardRuntimeSignalUpdateMs_[signalKey] = QDateTime::currentMSecsSinceEpoch();
-            refreshDashboardOpenPositionIndicatorValuesForSignalKey(signalKey, cache);
-        });
-        connect(client, &BinanceWsClient::errorOccurred, this, [this, signalKey, symbolKey, intervalKey](const QString &message) {
-            const QString warningKey = QStringLiteral("signal-stream|%1|%2").arg(signalKey, message);
-            if (!dashboardRuntimeConnectorWarnings_.contains(warningKey)) {
-                dashboardRuntimeConnectorWarnings_.insert(warningKey);
-                appendDashboardAllLog(
-                    QString("Signal stream error for %1@%2: %3")
-                        .arg(symbolKey, intervalKey, message));
-            }
-        });
-        dashboardRuntimeSignalSockets_.insert(signalKey, client);
-        client->connectKline(symbol, requestInterval, signalUsesFutures, isTestnet && signalUsesFutures);
-        return dashboardRuntimeSignalCandles_.contains(signalKey)
-            && !dashboardRuntimeSignalCandles_.value(signalKey).isEmpty();
+                BinanceRestClient::KlineCandle candle;
+                candle.openTimeMs = tick.openTimeMs;
+                candle.open = tick.open;
+                candle.high = tick.high;
+                candle.low = tick.low;
+                candle.close = tick.close;
+                candle.volume = tick.volume;
+                dashboardRuntimeMarketData_->update(streamKey, candle, tick.isClosed);
+            });
+            connect(stream, &BinanceWsClient::subscriptionError, this, [this](const QString &streamKey, const QString &message) {
+                const QString warningKey = QStringLiteral("signal-stream|%1|%2").arg(streamKey, message);
+                if (!dashboardRuntimeConnectorWarnings_.contains(warningKey)) {
+                    dashboardRuntimeConnectorWarnings_.insert(warningKey);
+                    appendDashboardAllLog(
+                        QString("Signal stream error for %1@%2: %3")
+                            .arg(streamKey.section('|', 0, 0), streamKey.section('|', 1, 1), message));
+                }
+            });
+            dashboardRuntimeSignalStream_ = stream;
+        }
+        dashboardRuntimeMarketData_->attach(signalKey, feedKey);
+        if (!dashboardRuntimeSignalStream_->isSubscribed(feedKey)) {
+            dashboardRuntimeSignalStream_->subscribe(
+                feedKey,
+                BinanceWsClient::klineStreamName(symbol, requestInterval),
+                signalUsesFutures,
+                isTestnet && signalUsesFutures);
+        }
+        return !dashboardRuntimeMarketData_->view(feedKey).isEmpty();
     };
 
     if (!futures) {
@@ -604,40 +988,35 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
             positionsLastAvailableBalanceUsdt_ = paperBalance;
             availableUsdt = paperBalance;
         } else if (hasApiCredentials) {
-            static QString s_balanceCacheKey;
-            static qint64 s_balanceCacheMs = 0;
-            static bool s_balanceCacheValid = false;
-            static double s_balanceCacheTotal = 0.0;
-            static double s_balanceCacheAvailable = 0.0;
-
-            const QString balanceCacheKey = QStringLiteral("%1|%2|%3|%4")
-                                                .arg(apiKey.trimmed(),
-                                                     futures ? QStringLiteral("futures") : QStringLiteral("spot"),
-                                                     isTestnet ? QStringLiteral("testnet") : QStringLiteral("live"),
-                                                     defaultConnectorCfg.baseUrl.trimmed().toLower());
-            const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
-            const bool useCachedBalance = s_balanceCacheValid
-                && s_balanceCacheKey == balanceCacheKey
-                && (nowMs - s_balanceCacheMs) <= 5000;
+            RuntimeBalanceCache &balanceCache = runtimeBalanceCache();
+            const QString balanceCacheKey =
+                runtimeBalanceCacheKey(apiKey, futures, isTestnet, defaultConnectorCfg.baseUrl);
+            // A synced account stream is fresher than anything polled.
+            const NativeUserDataStream::Client *balanceStream =
+                futures ? syncedAccountStream(defaultConnectorCfg) : nullptr;
+            const BinanceRestClient::BalanceResult streamedBalance = balanceStream
+                ? balanceStream->state().balance()
+                : BinanceRestClient::BalanceResult{};
+            const BinanceRestClient::BalanceResult *freshBalance = streamedBalance.ok
+                ? &streamedBalance
+                : (prefetched->balanceFetched ? &prefetched->balance : nullptr);
+            // The plan skipped the balance request when the cache was fresh at
+            // planning time; judge freshness at that same instant.
+            const bool useCachedBalance = !freshBalance
+                && runtimeBalanceCacheFresh(balanceCacheKey, prefetched->plannedAtMs);
 
             if (useCachedBalance) {
-                if (qIsFinite(s_balanceCacheTotal) && s_balanceCacheTotal >= 0.0) {
-                    positionsLastTotalBalanceUsdt_ = s_balanceCacheTotal;
+                if (qIsFinite(balanceCache.total) && balanceCache.total >= 0.0) {
+                    positionsLastTotalBalanceUsdt_ = balanceCache.total;
                 }
-                if (qIsFinite(s_balanceCacheAvailable) && s_balanceCacheAvailable >= 0.0) {
-                    positionsLastAvailableBalanceUsdt_ = s_balanceCacheAvailable;
-                    if (s_balanceCacheAvailable > 0.0) {
-                        availableUsdt = s_balanceCacheAvailable;
+                if (qIsFinite(balanceCache.available) && balanceCache.available >= 0.0) {
+                    positionsLastAvailableBalanceUsdt_ = balanceCache.available;
+                    if (balanceCache.available > 0.0) {
+                        availableUsdt = balanceCache.available;
                     }
                 }
-            } else {
-                const auto balance = BinanceRestClient::fetchUsdtBalance(
-                    apiKey,
-                    apiSecret,
-                    futures,
-                    isTestnet,
-                    6000,
-                    defaultConnectorCfg.baseUrl);
+            } else if (freshBalance) {
+                const auto &balance = *freshBalance;
                 if (!balance.ok) {
                     appendDashboardPositionLog(
                         QString("Balance fetch failed (%1): %2")
@@ -649,11 +1028,13 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
                     const double availableBalance = std::max(
                         0.0,
                         (balance.availableUsdtBalance > 0.0) ? balance.availableUsdtBalance : totalBalance);
-                    s_balanceCacheKey = balanceCacheKey;
-                    s_balanceCacheMs = nowMs;
-                    s_balanceCacheValid = true;
-                    s_balanceCacheTotal = totalBalance;
-                    s_balanceCacheAvailable = availableBalance;
+                    balanceCache.key = balanceCacheKey;
+                    balanceCache.updatedMs = freshBalance == &streamedBalance
+                        ? QDateTime::currentMSecsSinceEpoch()
+                        : prefetched->finishedAtMs;
+                    balanceCache.valid = true;
+                    balanceCache.total = totalBalance;
+                    balanceCache.available = availableBalance;
                     if (qIsFinite(totalBalance) && totalBalance >= 0.0) {
                         positionsLastTotalBalanceUsdt_ = totalBalance;
                     }
@@ -693,17 +1074,13 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
         waitingIt.value() = waitingEntry;
     };
 
+    // Live orders of this cycle, placed together on the engine once every
+    // row is evaluated.
+    NativeDashboardEngine::OrderBatch orderBatch{apiKey, apiSecret, isTestnet, {}};
     for (int row = 0; row < dashboardOverridesTable_->rowCount(); ++row) {
         if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_) {
             break;
         }
-        if (row > 0) {
-            flushPendingPositionsView();
-            pumpUiEvents();
-            if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_) {
-                break;
-            }
-        }
         const auto *symbolItem = dashboardOverridesTable_->item(row, 0);
         const auto *intervalItem = dashboardOverridesTable_->item(row, 1);
         if (!symbolItem || !intervalItem) {
@@ -827,30 +1204,34 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
         }
 
         const QString signalKey = runtimeKeyFor(symbol, requestInterval, connectorToken);
-        QVector<BinanceRestClient::KlineCandle> marketCandles;
+        const QString feedKey = NativeMarketDataHub::feedKey(
+            connectorToken,
+            indicatorUsesBinanceFutures,
+            symbol,
+            requestInterval);
+        NativeMarketDataHub::CandleView marketCandles;
         bool latestCandleClosed = false;
         if (useWebSocketFeed) {
             ensureSignalStreamForKey(
                 signalKey,
+                feedKey,
                 symbol,
                 requestInterval,
-                indicatorUsesBinanceFutures,
-                rowConnectorCfg.baseUrl);
-            marketCandles = dashboardRuntimeSignalCandles_.value(signalKey);
-            latestCandleClosed = dashboardRuntimeSignalLastClosed_.value(signalKey, false);
+                indicatorUsesBinanceFutures);
+            marketCandles = dashboardRuntimeMarketData_->view(feedKey);
+            latestCandleClosed = dashboardRuntimeMarketData_->latestClosed(feedKey);
             if (marketCandles.isEmpty()) {
                 touchWaitingEntry(key, nowMs);
                 continue;
             }
         } else {
-            const auto candles = BinanceRestClient::fetchKlines(
-                symbol,
-                requestInterval,
-                indicatorUsesBinanceFutures,
-                isTestnet && indicatorUsesBinanceFutures,
-                240,
-                10000,
-                rowConnectorCfg.baseUrl);
+            const auto candlesIt = prefetched->klines.constFind(feedKey);
+            if (candlesIt == prefetched->klines.cend()) {
+                // Became due after the engine's snapshot; picked up next cycle.
+                touchWaitingEntry(key, nowMs);
+                continue;
+            }
+            const auto &candles = candlesIt.value();
             if (!candles.ok || candles.candles.isEmpty()) {
                 const QString intervalLabel = requestInterval.compare(interval, Qt::CaseInsensitive) == 0
                     ? interval
@@ -861,10 +1242,16 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
                 touchWaitingEntry(key, nowMs);
                 continue;
             }
-            marketCandles = candles.candles;
+            marketCandles = dashboardRuntimeMarketData_->view(feedKey);
+            if (marketCandles.isEmpty()) {
+                // The page did not reach the feed's last candle; the feed
+                // reseeds on the next cycle.
+                touchWaitingEntry(key, nowMs);
+                continue;
+            }
         }
 
-        const QVector<BinanceRestClient::KlineCandle> signalCandles =
+        const NativeMarketDataHub::CandleView signalCandles =
             signalCandlesFromSnapshot(marketCandles, useLiveSignalCandles, latestCandleClosed);
         if (signalCandles.isEmpty()) {
             touchWaitingEntry(key, nowMs);
@@ -877,25 +1264,50 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
             touchWaitingEntry(key, nowMs);
             continue;
         }
+        // A reached stop-loss closes the position in this cycle, whether or
+        // not the row's loop interval is due.
+        const double streamedStopLossPrice = streamedMarkPrice(symbol);
+        const double stopLossPrice = streamedStopLossPrice > 0.0 ? streamedStopLossPrice : price;
+        bool stopLossHit = false;
+        if (openIt != dashboardRuntimeOpenPositions_.end()) {
+            const RuntimePosition &pos = openIt.value();
+            stopLossHit = dashboardRuntimeStopLoss_.closing(key);
+            if (!stopLossHit
+                && dashboardRuntimeStopLoss_.flag(
+                    key,
+                    {pos.side == QStringLiteral("LONG"), pos.entryPrice, pos.quantity, pos.roiBasisUsdt},
+                    stopLossPrice)) {
+                stopLossHit = true;
+                appendDashboardPositionLog(
+                    QString("%1 %2@%3 stop-loss reached at %4 (%5); closing.")
+                        .arg(pos.side,
+                             symbol,
+                             interval,
+                             QString::number(stopLossPrice, 'f', 6),
+                             dashboardStopLossSummary()));
+            }
+        }
 
-        const QVector<NativeIndicatorRuntime::Candle> nativeSignalCandles =
-            toNativeIndicatorCandles(signalCandles);
+        const NativeIndicatorRuntime::IncrementalIndicatorSet &indicatorSet = syncDashboardRuntimeIndicatorSet(
+            signalKey,
+            nativeConfigs,
+            marketCandles,
+            latestCandleClosed);
+        const bool signalIncludesFormingCandle = signalCandles.size() == marketCandles.size();
         const NativeStrategyRuntime::StrategySignalInput fullSignalInput = nativeSignalInput(
-            nativeSignalCandles,
+            indicatorSet.recent(signalIncludesFormingCandle),
             nativeConfigs,
             dashboardIndicatorParams_,
             QStringLiteral("BOTH"));
         const NativeIndicatorRuntime::SeriesMap displayIndicatorSeries =
-            signalCandles.size() == marketCandles.size()
+            signalIncludesFormingCandle
             ? fullSignalInput.indicators
-            : NativeIndicatorRuntime::computeConfiguredSeries(
-                  toNativeIndicatorCandles(marketCandles),
-                  nativeConfigs);
+            : indicatorSet.recent(true).indicators;
         const QString indicatorValueSummary =
             formatNativeIndicatorSummary(fullSignalInput.indicators, indicatorKeys);
         const QString displayIndicatorValueSummary =
             formatNativeIndicatorSummary(displayIndicatorSeries, indicatorKeys);
-        if (openIt != dashboardRuntimeOpenPositions_.end() && !evaluationDue) {
+        if (openIt != dashboardRuntimeOpenPositions_.end() && !evaluationDue && !stopLossHit) {
             if (positionsTable_) {
                 RuntimePosition &openPos = openIt.value();
                 const auto *liveSnapshot = fetchLivePositionsForConnector(rowConnectorCfg);
@@ -917,9 +1329,7 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
                                                      openPos.side.trimmed().toUpper(),
                                                      connectorToken.toLower());
                 const double groupQty = runtimeQtyByExposureKey.value(exposureKey, rowQty);
-                const double markPrice = (livePos && qIsFinite(livePos->markPrice) && livePos->markPrice > 0.0)
-                    ? livePos->markPrice
-                    : price;
+                const double markPrice = dashboardRuntimeMarkPrice(symbol, livePos, price);
                 const double fallbackPnlUsdt = (openPos.side == QStringLiteral("LONG"))
                     ? (markPrice - openPos.entryPrice) * rowQty
                     : (openPos.entryPrice - markPrice) * rowQty;
@@ -1027,18 +1437,17 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
                 continue;
             }
 
-            const QString filterCacheKey = QStringLiteral("%1|%2|%3")
-                                               .arg(symbol, rowConnectorCfg.baseUrl, isTestnet ? QStringLiteral("testnet")
-                                                                                                 : QStringLiteral("live"));
-            BinanceRestClient::FuturesSymbolFilters symbolFilters = symbolFiltersCache.value(filterCacheKey);
-            if (!symbolFilters.ok) {
-                symbolFilters = BinanceRestClient::fetchFuturesSymbolFilters(
-                    symbol,
-                    isTestnet,
-                    10000,
-                    rowConnectorCfg.baseUrl);
-                symbolFiltersCache.insert(filterCacheKey, symbolFilters);
+            // Looked up by the engine, from the process-wide exchangeInfo cache
+            // after the connector's first fetch.
+            const auto symbolFiltersIt =
+                prefetched->symbolFilters.constFind(runtimeSymbolCacheKey(symbol, rowConnectorCfg, isTestnet));
+            if (symbolFiltersIt == prefetched->symbolFilters.cend()) {
+                // Became due after the engine's snapshot; due again next cycle.
+                dashboardRuntimeLastEvalMs_.remove(key);
+                touchWaitingEntry(key, nowMs);
+                continue;
             }
+            const BinanceRestClient::FuturesSymbolFilters &symbolFilters = symbolFiltersIt.value();
             if (!symbolFilters.ok) {
                 appendDashboardPositionLog(
                     QString("%1 %2@%3 blocked: symbol filters fetch failed (%4): %5")
@@ -1049,9 +1458,10 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
 
             double orderSizingPrice = price;
             if (!paperTrading) {
-                const auto *tickerPrice = fetchExecutionTickerPrice(symbol, rowConnectorCfg);
-                if (tickerPrice && tickerPrice->ok && qIsFinite(tickerPrice->price) && tickerPrice->price > 0.0) {
-                    orderSizingPrice = tickerPrice->price;
+                const double executionPrice =
+                    fetchExecutionPrice(symbol, rowConnectorCfg, openSide == QStringLiteral("LONG"));
+                if (executionPrice > 0.0) {
+                    orderSizingPrice = executionPrice;
                     if (std::fabs(orderSizingPrice - price) / std::max(price, 1e-12) >= 0.05) {
                         const QString warningKey = QStringLiteral("order-sizing-price|%1|%2")
                                                        .arg(symbol, rowConnectorCfg.key);
@@ -1142,271 +1552,123 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
 
             const QString openOrderSide = (openSide == QStringLiteral("LONG")) ? QStringLiteral("BUY") : QStringLiteral("SELL");
             const QString openPositionSide = hedgeMode ? openSide : QString();
-            QString openOrderId;
-            double filledQty = orderQty;
-            double entryPrice = price;
-            QString openOrderInfo;
-            const BinanceRestClient::FuturesPosition *livePos = nullptr;
+            PendingRuntimeOrder pendingOpen;
+            pendingOpen.runtimeKey = key;
+            pendingOpen.symbol = symbol;
+            pendingOpen.interval = interval;
+            pendingOpen.side = openSide;
+            pendingOpen.connectorKey = rowConnectorCfg.key;
+            pendingOpen.connectorBaseUrl = rowConnectorCfg.baseUrl;
+            pendingOpen.connectorCacheKey = connectorCacheKeyFor(rowConnectorCfg);
+            pendingOpen.hedgeMode = hedgeMode;
+            pendingOpen.testnet = isTestnet;
+            pendingOpen.price = price;
+            pendingOpen.quantity = orderQty;
+            pendingOpen.leverage = leverage;
+            pendingOpen.triggerSource = triggerSource;
+            pendingOpen.triggerText = triggerText;
+            pendingOpen.indicatorValueSummary = indicatorValueSummary;
+            pendingOpen.rowIndicatorValueSummary = rowIndicatorValueSummary;
+            pendingOpen.stopLossText = dashboardOverridesTable_->item(row, 7)
+                ? dashboardOverridesTable_->item(row, 7)->text()
+                : QStringLiteral("Disabled");
+            pendingOpen.symbolFilters = symbolFilters;
             if (paperTrading) {
-                openOrderId = QStringLiteral("paper-open-%1").arg(QDateTime::currentMSecsSinceEpoch());
-            } else {
-                if (dashboardRuntimeConnectorOrderCircuit_ && dashboardRuntimeConnectorOrderCircuit_->isOpen()) {
-                    const QJsonObject snapshot = dashboardRuntimeConnectorOrderCircuit_->snapshot(
-                        QDateTime::currentDateTimeUtc());
-                    appendDashboardPositionLog(
-                        QString("%1 %2@%3 blocked by connector order circuit: %4")
-                            .arg(openSide,
-                                 symbol,
-                                 interval,
-                                 snapshot.value(QStringLiteral("message")).toString(
-                                     QStringLiteral("connector health circuit breaker paused trading"))));
-                    touchWaitingEntry(key, nowMs);
-                    continue;
-                }
-                const NativeOrderSafety::OrderAuditLogConfig orderAuditConfig = nativeRuntimeOrderAuditLogConfig();
-                const QJsonObject orderAuditStatus = NativeOrderSafety::currentOrderAuditStatus(orderAuditConfig);
-                NativeOrderSafety::LiveOrderGuardInput orderGuardInput;
-                orderGuardInput.mode = modeText;
-                orderGuardInput.market = QStringLiteral("futures");
-                orderGuardInput.params = {
-                    {QStringLiteral("symbol"), symbol},
-                    {QStringLiteral("side"), openOrderSide},
-                    {QStringLiteral("type"), QStringLiteral("MARKET")},
-                    {QStringLiteral("quantity"), QString::number(orderQty, 'f', 12)},
-                };
-                if (!openPositionSide.isEmpty()) {
-                    orderGuardInput.params.append({QStringLiteral("positionSide"), openPositionSide});
-                }
-                orderGuardInput.apiKey = apiKey;
-                orderGuardInput.apiSecret = apiSecret;
-                orderGuardInput.accountType = QStringLiteral("FUTURES");
-                orderGuardInput.leverage = static_cast<int>(leverage);
-                orderGuardInput.marginMode = dashboardMarginModeCombo_
-                    ? dashboardMarginModeCombo_->currentText()
-                    : QStringLiteral("Isolated");
-                orderGuardInput.positionPct = positionPct;
-                orderGuardInput.config = liveSafetyConfig;
-                orderGuardInput.hasFilters = true;
-                orderGuardInput.filters = {
-                    symbolFilters.stepSize,
-                    symbolFilters.tickSize,
-                    symbolFilters.minQty,
-                    symbolFilters.minNotional,
-                };
-                orderGuardInput.hasLastPrice = true;
-                orderGuardInput.lastPrice = orderSizingPrice;
-                orderGuardInput.orderAuditEnabled = orderAuditStatus.value(QStringLiteral("enabled")).toBool(true);
-                orderGuardInput.orderAuditWritable = orderAuditStatus.value(QStringLiteral("write_ok")).toBool(true);
-                orderGuardInput.connectorState = rowConnectorCfg.ok() ? QStringLiteral("ready") : QStringLiteral("error");
-                orderGuardInput.connectorHealth = rowConnectorCfg.ok() ? QStringLiteral("ok") : QStringLiteral("error");
-                orderGuardInput.liveSubmitAttemptCount = dashboardRuntimeLiveSubmitAttemptCount_;
-                const NativeOrderSafety::LiveOrderGuardResult orderGuard =
-                    NativeOrderSafety::guardLiveOrderSubmit(orderGuardInput);
-                if (!orderGuard.allowed) {
-                    appendDashboardPositionLog(
-                        QString("%1 %2@%3 blocked by order safety: %4")
-                            .arg(openSide, symbol, interval, orderGuard.errors.join(QStringLiteral(" | "))));
-                    touchWaitingEntry(key, nowMs);
-                    continue;
-                }
-                dashboardRuntimeLiveSubmitAttemptCount_ = orderGuard.nextSubmitAttemptCount;
-                const auto openOrder = placeFuturesOpenOrderWithFallback(
-                    apiKey,
-                    apiSecret,
-                    symbol,
-                    openOrderSide,
-                    orderQty,
-                    isTestnet,
-                    openPositionSide,
-                    10000,
-                    rowConnectorCfg.baseUrl);
-                if (!openOrder.ok) {
-                    if (dashboardRuntimeConnectorOrderCircuit_) {
-                        const NativeOrderSafety::ConnectorOrderBlockEvent circuitEvent{
-                            static_cast<double>(QDateTime::currentMSecsSinceEpoch()) / 1000.0,
-                            symbol,
-                            interval,
-                            openSide,
-                            QStringLiteral("FUTURES"),
-                            QStringLiteral("error"),
-                            QStringLiteral("error"),
-                            openOrder.error,
-                            key,
-                            QStringLiteral("cpp-futures-open"),
-                        };
-                        const QJsonObject circuitSnapshot = dashboardRuntimeConnectorOrderCircuit_->recordConnectorOrderBlock(
-                            circuitEvent,
-                            QDateTime::currentDateTimeUtc());
-                        if (!circuitSnapshot.isEmpty()) {
-                            NativeOrderSafety::OrderAuditLogConfig incidentLogConfig;
-                            incidentLogConfig.enabled = true;
-                            incidentLogConfig.path = dashboardConnectorOrderIncidentLogPathEdit_
-                                ? dashboardConnectorOrderIncidentLogPathEdit_->text().trimmed()
-                                : QString();
-                            incidentLogConfig.maxBytes = static_cast<quint64>(dashboardConnectorOrderIncidentMaxBytesSpin_
-                                ? dashboardConnectorOrderIncidentMaxBytesSpin_->value()
-                                : 2 * 1024 * 1024);
-                            incidentLogConfig.backupCount = dashboardConnectorOrderIncidentBackupCountSpin_
-                                ? dashboardConnectorOrderIncidentBackupCountSpin_->value()
-                                : 1;
-                            const QJsonObject incident = NativeOrderSafety::buildConnectorOrderCircuitIncident(
-                                QStringLiteral("opened"),
-                                circuitSnapshot,
-                                QStringLiteral("cpp-dashboard"),
-                                openOrder.error,
-                                QDateTime::currentDateTimeUtc());
-                            NativeOrderSafety::appendOrderAuditEvent(incident, incidentLogConfig);
-                            appendDashboardAllLog(
-                                QStringLiteral("Connector order circuit opened: %1")
-                                    .arg(circuitSnapshot.value(QStringLiteral("message")).toString()));
-                        }
-                    }
-                    if (isPercentPriceFilterError(openOrder.error)) {
-                        double reducedQtyCap = orderQty * 0.5;
-                        if (qIsFinite(symbolFilters.stepSize) && symbolFilters.stepSize > 0.0) {
-                            reducedQtyCap = floorToOrderStep(
-                                reducedQtyCap,
-                                symbolFilters.stepSize,
-                                symbolFilters.quantityPrecision);
-                        }
-                        const double minQtyCap = (qIsFinite(symbolFilters.minQty) && symbolFilters.minQty > 0.0)
-                            ? symbolFilters.minQty
-                            : (qIsFinite(symbolFilters.stepSize) && symbolFilters.stepSize > 0.0
-                                   ? symbolFilters.stepSize
-                                   : 0.0);
-                        if (reducedQtyCap > 0.0) {
-                            reducedQtyCap = std::max(minQtyCap, reducedQtyCap);
-                            dashboardRuntimeOpenQtyCaps_.insert(key, reducedQtyCap);
-                        }
-                        const qint64 retryDelayMs = isTestnet ? 15000 : 5000;
-                        dashboardRuntimeEntryRetryAfterMs_.insert(key, nowMs + retryDelayMs);
-                        appendDashboardPositionLog(
-                            QString("%1 %2@%3 entry delayed (%4): %5 Retrying with smaller size in %6s.")
-                                .arg(openSide,
-                                     symbol,
-                                     interval,
-                                     rowConnectorCfg.key,
-                                     openOrder.error,
-                                     QString::number(retryDelayMs / 1000)));
-                    } else {
-                        dashboardRuntimeOpenQtyCaps_.remove(key);
-                        appendDashboardPositionLog(
-                            QString("%1 %2@%3 order failed (%4): %5")
-                                .arg(openSide, symbol, interval, rowConnectorCfg.key, openOrder.error));
-                    }
-                    touchWaitingEntry(key, nowMs);
-                    continue;
-                }
-
-                openOrderId = openOrder.orderId;
-                openOrderInfo = openOrder.error;
-                filledQty = (qIsFinite(openOrder.executedQty) && openOrder.executedQty > 0.0)
-                    ? openOrder.executedQty
-                    : orderQty;
-                dashboardRuntimeEntryRetryAfterMs_.remove(key);
-                if (!openOrderInfo.trimmed().isEmpty() && isPercentPriceFilterError(openOrderInfo)) {
-                    dashboardRuntimeOpenQtyCaps_.insert(key, std::max(filledQty, 0.0));
-                } else {
-                    dashboardRuntimeOpenQtyCaps_.remove(key);
-                }
-                entryPrice = (qIsFinite(openOrder.avgPrice) && openOrder.avgPrice > 0.0)
-                    ? openOrder.avgPrice
-                    : price;
-                livePositionsCache.remove(connectorCacheKeyFor(rowConnectorCfg));
-                const auto *liveSnapshot = fetchLivePositionsForConnector(rowConnectorCfg);
-                livePos = pickLivePosition(liveSnapshot, symbol, openSide);
-                if (livePos && qIsFinite(livePos->entryPrice) && livePos->entryPrice > 0.0) {
-                    entryPrice = livePos->entryPrice;
-                }
+                BinanceRestClient::FuturesOrderResult paperFill;
+                paperFill.ok = true;
+                paperFill.orderId = QStringLiteral("paper-open-%1").arg(QDateTime::currentMSecsSinceEpoch());
+                paperFill.executedQty = orderQty;
+                applyDashboardRuntimeOpenFill(
+                    pendingOpen,
+                    paperFill,
+                    nullptr,
+                    &positionsTableMutated,
+                    &positionsTableStructureChanged);
+                const QString exposureKey = QStringLiteral("%1|%2|%3")
+                                                .arg(symbol,
+                                                     openSide,
+                                                     connectorToken.toLower());
+                runtimeQtyByExposureKey[exposureKey] +=
+                    std::max(0.0, dashboardRuntimeOpenPositions_.value(key).quantity);
+                applyCumulativeViewImmediately();
+                continue;
             }
-            double rowQty = filledQty;
-            if ((!qIsFinite(rowQty) || rowQty <= 1e-10)
-                && livePos
-                && qIsFinite(livePos->positionAmt)
-                && std::fabs(livePos->positionAmt) > 1e-10) {
-                rowQty = std::fabs(livePos->positionAmt);
+            if (dashboardRuntimeConnectorOrderCircuit_ && dashboardRuntimeConnectorOrderCircuit_->isOpen()) {
+                const QJsonObject snapshot = dashboardRuntimeConnectorOrderCircuit_->snapshot(
+                    QDateTime::currentDateTimeUtc());
+                appendDashboardPositionLog(
+                    QString("%1 %2@%3 blocked by connector order circuit: %4")
+                        .arg(openSide,
+                             symbol,
+                             interval,
+                             snapshot.value(QStringLiteral("message")).toString(
+                                 QStringLiteral("connector health circuit breaker paused trading"))));
+                touchWaitingEntry(key, nowMs);
+                continue;
             }
-            const QString exposureKey = QStringLiteral("%1|%2|%3")
-                                            .arg(symbol,
-                                                 openSide,
-                                                 connectorToken.toLower());
-            const double existingGroupQty = runtimeQtyByExposureKey.value(exposureKey, 0.0);
-            const double groupQty = existingGroupQty + std::max(0.0, rowQty);
-            const double markPrice = (livePos && qIsFinite(livePos->markPrice) && livePos->markPrice > 0.0)
-                ? livePos->markPrice
-                : price;
-            const double fallbackMarginUsdt = std::max(0.0, (entryPrice * rowQty) / leverage);
-            const LivePositionMetricsShare liveShare = allocateLivePositionShare(
-                livePos,
-                rowQty,
-                groupQty,
-                std::max(0.0, rowQty * markPrice),
-                fallbackMarginUsdt,
-                fallbackMarginUsdt,
-                0.0);
-            const double sizeUsdt = std::max(0.0, liveShare.sizeUsdt);
-            const double displayMarginUsdt = std::max(0.0, liveShare.displayMarginUsdt);
-            const double roiBasisUsdt = std::max(1e-9, liveShare.roiBasisUsdt);
-            const double marginRatio = (livePos && livePos->marginRatio > 0.0) ? livePos->marginRatio : 0.0;
-            const double liqPrice = (livePos && livePos->liquidationPrice > 0.0) ? livePos->liquidationPrice : 0.0;
-            dashboardRuntimeOpenPositions_.insert(
-                key,
-                RuntimePosition{
-                    openSide,
-                    interval,
-                    triggerSource,
-                    rowConnectorCfg.key,
-                    rowConnectorCfg.baseUrl,
-                    entryPrice,
-                    rowQty,
-                    leverage,
-                    roiBasisUsdt,
-                    displayMarginUsdt,
-                });
-            runtimeQtyByExposureKey[exposureKey] = groupQty;
-
-            if (positionsTable_) {
-                if (appendOpenPositionRow(
-                        positionsTable_,
-                        positionsRowSequenceCounter_,
-                        PositionTableOpenRowData{
-                            symbol,
-                            interval,
-                            triggerSource,
-                            triggerText,
-                            rowIndicatorValueSummary,
-                            openSide,
-                            QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"),
-                            dashboardOverridesTable_->item(row, 7)
-                                ? dashboardOverridesTable_->item(row, 7)->text()
-                                : QStringLiteral("Disabled"),
-                            rowConnectorCfg.key,
-                            openOrderId,
-                            sizeUsdt,
-                            rowQty,
-                            markPrice,
-                            marginRatio,
-                            liqPrice,
-                            displayMarginUsdt,
-                            roiBasisUsdt,
-                        })) {
-                    positionsTableStructureChanged = true;
-                    positionsTableMutated = true;
-                }
+            const NativeOrderSafety::OrderAuditLogConfig orderAuditConfig = nativeRuntimeOrderAuditLogConfig();
+            const QJsonObject orderAuditStatus = NativeOrderSafety::currentOrderAuditStatus(orderAuditConfig);
+            NativeOrderSafety::LiveOrderGuardInput orderGuardInput;
+            orderGuardInput.mode = modeText;
+            orderGuardInput.market = QStringLiteral("futures");
+            orderGuardInput.params = {
+                {QStringLiteral("symbol"), symbol},
+                {QStringLiteral("side"), openOrderSide},
+                {QStringLiteral("type"), QStringLiteral("MARKET")},
+                {QStringLiteral("quantity"), QString::number(orderQty, 'f', 12)},
+            };
+            if (!openPositionSide.isEmpty()) {
+                orderGuardInput.params.append({QStringLiteral("positionSide"), openPositionSide});
             }
-            applyCumulativeViewImmediately();
-            appendDashboardPositionLog(
-                QString("%1 %2@%3 opened at %4 qty=%5 (%6, values: %7, connector=%8, orderId=%9%10)")
-                    .arg(openSide,
-                         symbol,
-                         interval,
-                         QString::number(entryPrice, 'f', 6),
-                         QString::number(rowQty, 'f', 6),
-                         triggerText,
-                         indicatorValueSummary,
-                         rowConnectorCfg.key,
-                         openOrderId,
-                         openOrderInfo.trimmed().isEmpty() ? QString() : QStringLiteral(", note=%1").arg(openOrderInfo.trimmed())));
+            orderGuardInput.apiKey = apiKey;
+            orderGuardInput.apiSecret = apiSecret;
+            orderGuardInput.accountType = QStringLiteral("FUTURES");
+            orderGuardInput.leverage = static_cast<int>(leverage);
+            orderGuardInput.marginMode = dashboardMarginModeCombo_
+                ? dashboardMarginModeCombo_->currentText()
+                : QStringLiteral("Isolated");
+            orderGuardInput.positionPct = positionPct;
+            orderGuardInput.config = liveSafetyConfig;
+            orderGuardInput.hasFilters = true;
+            orderGuardInput.filters = {
+                symbolFilters.stepSize,
+                symbolFilters.tickSize,
+                symbolFilters.minQty,
+                symbolFilters.minNotional,
+            };
+            orderGuardInput.hasLastPrice = true;
+            orderGuardInput.lastPrice = orderSizingPrice;
+            orderGuardInput.orderAuditEnabled = orderAuditStatus.value(QStringLiteral("enabled")).toBool(true);
+            orderGuardInput.orderAuditWritable = orderAuditStatus.value(QStringLiteral("write_ok")).toBool(true);
+            orderGuardInput.connectorState = rowConnectorCfg.ok() ? QStringLiteral("ready") : QStringLiteral("error");
+            orderGuardInput.connectorHealth = rowConnectorCfg.ok() ? QStringLiteral("ok") : QStringLiteral("error");
+            orderGuardInput.liveSubmitAttemptCount = dashboardRuntimeLiveSubmitAttemptCount_;
+            const NativeOrderSafety::LiveOrderGuardResult orderGuard =
+                NativeOrderSafety::guardLiveOrderSubmit(orderGuardInput);
+            if (!orderGuard.allowed) {
+                appendDashboardPositionLog(
+                    QString("%1 %2@%3 blocked by order safety: %4")
+                        .arg(openSide, symbol, interval, orderGuard.errors.join(QStringLiteral(" | "))));
+                touchWaitingEntry(key, nowMs);
+                continue;
+            }
+            dashboardRuntimeLiveSubmitAttemptCount_ = orderGuard.nextSubmitAttemptCount;
+            // Placed on the engine after the row loop; the fill is applied
+            // when the batch comes back.
+            orderBatch.orders.append({
+                key,
+                pendingOpen.connectorCacheKey,
+                rowConnectorCfg.baseUrl,
+                true,
+                symbol,
+                openOrderSide,
+                orderQty,
+                openPositionSide,
+                false,
+                orderSizingPrice,
+            });
+            dashboardRuntimePendingOrders_.append(std::move(pendingOpen));
+            touchWaitingEntry(key, nowMs);
             continue;
         }
 
@@ -1446,9 +1708,7 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
                                              openPos.side.trimmed().toUpper(),
                                              connectorToken.toLower());
         const double groupQty = runtimeQtyByExposureKey.value(exposureKey, rowQty);
-        const double markPrice = (livePos && qIsFinite(livePos->markPrice) && livePos->markPrice > 0.0)
-            ? livePos->markPrice
-            : price;
+        const double markPrice = dashboardRuntimeMarkPrice(symbol, livePos, price);
         const double fallbackPnlUsdt = (openPos.side == QStringLiteral("LONG"))
             ? (markPrice - openPos.entryPrice) * rowQty
             : (openPos.entryPrice - markPrice) * rowQty;
@@ -1493,7 +1753,7 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
             positionsTableMutated = true;
         }
 
-        if (!shouldCloseLong && !shouldCloseShort) {
+        if (!shouldCloseLong && !shouldCloseShort && !stopLossHit) {
             continue;
         }
 
@@ -1511,156 +1771,51 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
         const QString closeOrderSide = (openPos.side == QStringLiteral("LONG")) ? QStringLiteral("SELL")
                                                                                  : QStringLiteral("BUY");
         const QString closePositionSide = hedgeMode ? openPos.side : QString();
-        const bool closeReduceOnly = !hedgeMode;
-        QString closeOrderId;
-        QString closeOrderError;
-        double closePrice = price;
-        double closeQty = openPos.quantity;
+        PendingRuntimeOrder pendingClose;
+        pendingClose.runtimeKey = key;
+        pendingClose.symbol = symbol;
+        pendingClose.interval = interval;
+        pendingClose.side = openPos.side;
+        pendingClose.connectorKey = rowConnectorCfg.key;
+        pendingClose.connectorBaseUrl = rowConnectorCfg.baseUrl;
+        pendingClose.connectorCacheKey = connectorCacheKeyFor(rowConnectorCfg);
+        pendingClose.opening = false;
+        pendingClose.hedgeMode = hedgeMode;
+        pendingClose.testnet = isTestnet;
+        pendingClose.price = price;
+        pendingClose.quantity = openPos.quantity;
+        pendingClose.leverage = openPos.leverage;
+        pendingClose.closeReferencePrice = stopLossHit ? stopLossPrice : price;
         if (paperTrading) {
-            closeOrderId = QStringLiteral("paper-close-%1").arg(QDateTime::currentMSecsSinceEpoch());
-        } else {
-            const auto closeOrder = placeFuturesCloseOrderWithFallback(
-                apiKey,
-                apiSecret,
-                symbol,
-                closeOrderSide,
-                openPos.quantity,
-                isTestnet,
-                closeReduceOnly,
-                closePositionSide,
-                10000,
-                rowConnectorCfg.baseUrl,
-                price);
-            if (!closeOrder.ok) {
-                if (isReduceOnlyRejectedError(closeOrder.error)) {
-                    livePositionsCache.remove(connectorCacheKeyFor(rowConnectorCfg));
-                    const auto *latestSnapshot = fetchLivePositionsForConnector(rowConnectorCfg);
-                    if (!hasMatchingOpenFuturesPosition(latestSnapshot, symbol, openPos.side, hedgeMode)) {
-                        if (targetRow >= 0 && positionsTable_) {
-                            markPositionClosedRow(
-                                positionsTable_,
-                                positionsCumulativeView_,
-                                targetRow,
-                                QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"));
-                            positionsTableMutated = true;
-                        }
-                        applyCumulativeViewImmediately();
-                        appendDashboardPositionLog(
-                            QString("%1 %2@%3 close confirmed (%4): position is already flat on exchange.")
-                                .arg(openPos.side, symbol, interval, rowConnectorCfg.key));
-                        dashboardRuntimeLastEvalMs_.remove(key);
-                        dashboardRuntimeEntryRetryAfterMs_.remove(key);
-                        dashboardRuntimeOpenQtyCaps_.remove(key);
-                        dashboardRuntimeOpenPositions_.remove(key);
-                        continue;
-                    }
-                }
-                appendDashboardPositionLog(
-                    QString("%1 %2@%3 close order failed (%4): %5")
-                        .arg(openPos.side, symbol, interval, rowConnectorCfg.key, closeOrder.error));
-                continue;
-            }
-            livePositionsCache.remove(connectorCacheKeyFor(rowConnectorCfg));
-            closeOrderId = closeOrder.orderId;
-            closeOrderError = closeOrder.error;
-            closePrice = (qIsFinite(closeOrder.avgPrice) && closeOrder.avgPrice > 0.0)
-                ? closeOrder.avgPrice
-                : price;
-            closeQty = (qIsFinite(closeOrder.executedQty) && closeOrder.executedQty > 0.0)
-                ? closeOrder.executedQty
-                : openPos.quantity;
-        }
-        const double effectiveCloseQty = std::max(0.0, std::min(openPos.quantity, closeQty));
-        if (effectiveCloseQty <= 0.0) {
-            appendDashboardPositionLog(
-                QString("%1 %2@%3 close order returned zero fill; keeping position open.")
-                    .arg(openPos.side, symbol, interval));
-            continue;
-        }
-        const double realizedPnlUsdt = (openPos.side == "LONG")
-            ? (closePrice - openPos.entryPrice) * effectiveCloseQty
-            : (openPos.entryPrice - closePrice) * effectiveCloseQty;
-        const double closeShareRatio = rowQty > 1e-9
-            ? std::min(1.0, std::max(0.0, effectiveCloseQty / rowQty))
-            : 1.0;
-        const double closeRoiBasisUsed = std::max(1e-9, openPos.roiBasisUsdt * closeShareRatio);
-        const double realizedPnlPct = (realizedPnlUsdt / closeRoiBasisUsed) * 100.0;
-        const bool partialClose = (effectiveCloseQty + 1e-9) < openPos.quantity;
-        double remainingQty = 0.0;
-        double remainingNotional = 0.0;
-        double remainingDisplayMarginUsdt = 0.0;
-        double remainingRoiBasisUsdt = 0.0;
-
-        if (partialClose) {
-            remainingQty = std::max(0.0, openPos.quantity - effectiveCloseQty);
-            const double remainingRatio = rowQty > 1e-9
-                ? std::min(1.0, std::max(0.0, remainingQty / rowQty))
-                : 0.0;
-            remainingNotional = std::max(0.0, remainingQty * closePrice);
-            remainingDisplayMarginUsdt = std::max(0.0, openPos.displayMarginUsdt * remainingRatio);
-            remainingRoiBasisUsdt = std::max(0.0, openPos.roiBasisUsdt * remainingRatio);
-            openPos.displayMarginUsdt = std::max(1e-9, remainingDisplayMarginUsdt);
-            openPos.roiBasisUsdt = std::max(1e-9, remainingRoiBasisUsdt);
-        }
-
-        if (targetRow >= 0 && positionsTable_) {
-            applyCloseToPositionRow(
-                positionsTable_,
-                positionsCumulativeView_,
-                targetRow,
-                PositionTableCloseRowData{
-                    symbol,
-                    QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"),
-                    closePrice,
-                    realizedPnlUsdt,
-                    realizedPnlPct,
-                    closeRoiBasisUsed,
-                    partialClose,
-                    remainingQty,
-                    remainingNotional,
-                    remainingDisplayMarginUsdt,
-                    remainingRoiBasisUsdt,
-                });
-            positionsTableMutated = true;
-        }
-        applyCumulativeViewImmediately();
-
-        if (partialClose) {
-            openPos.quantity = std::max(0.0, openPos.quantity - effectiveCloseQty);
-            if (openPos.quantity <= 1e-9) {
-                openPos.quantity = 0.0;
-            }
-            appendDashboardPositionLog(
-                QString("%1 %2@%3 partially closed at %4, qty=%5 remaining=%6, PNL=%7 USDT (%8%%), connector=%9, orderId=%10: %11")
-                    .arg(openPos.side,
-                         symbol,
-                         interval,
-                         QString::number(closePrice, 'f', 6),
-                         QString::number(effectiveCloseQty, 'f', 6),
-                         QString::number(openPos.quantity, 'f', 6),
-                         QString::number(realizedPnlUsdt, 'f', 2),
-                         QString::number(realizedPnlPct, 'f', 2),
-                         rowConnectorCfg.key,
-                         closeOrderId,
-                         closeOrderError.isEmpty() ? QStringLiteral("remaining exposure still open")
-                                                   : closeOrderError));
+            BinanceRestClient::FuturesOrderResult paperFill;
+            paperFill.ok = true;
+            paperFill.orderId = QStringLiteral("paper-close-%1").arg(QDateTime::currentMSecsSinceEpoch());
+            applyDashboardRuntimeCloseFill(pendingClose, paperFill, nullptr, &positionsTableMutated);
+            applyCumulativeViewImmediately();
             continue;
         }
+        orderBatch.orders.append({
+            key,
+            pendingClose.connectorCacheKey,
+            rowConnectorCfg.baseUrl,
+            false,
+            symbol,
+            closeOrderSide,
+            openPos.quantity,
+            closePositionSide,
+            !hedgeMode,
+            price,
+        });
+        dashboardRuntimePendingOrders_.append(std::move(pendingClose));
+    }
 
+    if (!dashboardRuntimeActive_ || dashboardRuntimeStopping_) {
+        dashboardRuntimePendingOrders_.clear();
+    } else if (!orderBatch.orders.isEmpty()
+               && !dashboardRuntimeEngine_->submitOrders(std::move(orderBatch))) {
         appendDashboardPositionLog(
-            QString("%1 %2@%3 closed at %4, PNL=%5 USDT (%6%%), connector=%7, orderId=%8")
-                .arg(openPos.side,
-                     symbol,
-                     interval,
-                     QString::number(closePrice, 'f', 6),
-                     QString::number(realizedPnlUsdt, 'f', 2),
-                     QString::number(realizedPnlPct, 'f', 2),
-                     rowConnectorCfg.key,
-                     closeOrderId));
-        dashboardRuntimeLastEvalMs_.remove(key);
-        dashboardRuntimeEntryRetryAfterMs_.remove(key);
-        dashboardRuntimeOpenQtyCaps_.remove(key);
-        dashboardRuntimeOpenPositions_.remove(key);
+            QStringLiteral("Order batch not sent: the dashboard engine is still busy; signals are re-evaluated next cycle."));
+        dashboardRuntimePendingOrders_.clear();
     }
 
     if (!dashboardWaitingActiveEntries_.isEmpty()) {
@@ -1725,4 +1880,424 @@ void TradingBotWindow::runDashboardRuntimeCycle() {
     refreshPositionsSummaryLabels();
 }
 
+void TradingBotWindow::applyDashboardRuntimeOrders(const NativeDashboardEngine::OrderResultsPtr &results) {
+    const QList<PendingRuntimeOrder> pendingOrders = std::exchange(dashboardRuntimePendingOrders_, {});
+    if (!results) {
+        return;
+    }
+    // The next cycle reads these instead of the account stream, which may
+    // not have applied the fills yet.
+    dashboardRuntimeOrderPositions_ = results->positions;
+
+    bool positionsTableMutated = false;
+    bool positionsTableStructureChanged = false;
+    QSet<QString> closedKeys;
+    const qsizetype count = std::min<qsizetype>(pendingOrders.size(), results->outcomes.size());
+    for (qsizetype index = 0; index < count; ++index) {
+        const PendingRuntimeOrder &pending = pendingOrders.at(index);
+        const NativeDashboardEngine::OrderOutcome &outcome = results->outcomes.at(index);
+        if (outcome.runtimeKey != pending.runtimeKey) {
+            continue;
+        }
+        if (!outcome.sent) {
+            appendDashboardPositionLog(
+                QString("%1 %2@%3 entry deferred: an earlier order on %4 failed this cycle.")
+                    .arg(pending.side, pending.symbol, pending.interval, pending.connectorKey));
+            continue;
+        }
+        const auto snapshotIt = results->positions.constFind(pending.connectorCacheKey);
+        const BinanceRestClient::FuturesPositionsResult *snapshot =
+            snapshotIt != results->positions.cend() ? &snapshotIt.value() : nullptr;
+        if (pending.opening) {
+            applyDashboardRuntimeOpenFill(
+                pending,
+                outcome.order,
+                snapshot,
+                &positionsTableMutated,
+                &positionsTableStructureChanged);
+        } else {
+            closedKeys.insert(pending.runtimeKey);
+            applyDashboardRuntimeCloseFill(pending, outcome.order, snapshot, &positionsTableMutated);
+        }
+    }
+
+    if (positionsTableMutated) {
+        if (positionsCumulativeView_) {
+            applyPositionsViewMode(positionsTableStructureChanged, positionsTableStructureChanged);
+        } else if (positionsTableStructureChanged) {
+            refreshPositionsTableSizing();
+        }
+    }
+    refreshPositionsSummaryLabels();
+
+    // Stop-losses reached while the batch was in flight could not start a
+    // cycle of their own.
+    if (dashboardRuntimeActive_ && !dashboardRuntimeStopping_) {
+        for (const QString &runtimeKey : dashboardRuntimeStopLoss_.closingKeys()) {
+            if (!closedKeys.contains(runtimeKey) && dashboardRuntimeOpenPositions_.contains(runtimeKey)) {
+                QTimer::singleShot(0, this, &TradingBotWindow::runDashboardRuntimeCycle);
+                break;
+            }
+        }
+    }
+}
+
+void TradingBotWindow::applyDashboardRuntimeOpenFill(
+    const PendingRuntimeOrder &pending,
+    const BinanceRestClient::FuturesOrderResult &order,
+    const BinanceRestClient::FuturesPositionsResult *snapshot,
+    bool *tableMutated,
+    bool *tableStructureChanged) {
+    const QString &key = pending.runtimeKey;
+    const QString &symbol = pending.symbol;
+    const QString &interval = pending.interval;
+    const QString &openSide = pending.side;
+    const BinanceRestClient::FuturesSymbolFilters &symbolFilters = pending.symbolFilters;
+    if (!order.ok) {
+        if (dashboardRuntimeConnectorOrderCircuit_) {
+            const NativeOrderSafety::ConnectorOrderBlockEvent circuitEvent{
+                static_cast<double>(QDateTime::currentMSecsSinceEpoch()) / 1000.0,
+                symbol,
+                interval,
+                openSide,
+                QStringLiteral("FUTURES"),
+                QStringLiteral("error"),
+                QStringLiteral("error"),
+                order.error,
+                key,
+                QStringLiteral("cpp-futures-open"),
+            };
+            const QJsonObject circuitSnapshot = dashboardRuntimeConnectorOrderCircuit_->recordConnectorOrderBlock(
+                circuitEvent,
+                QDateTime::currentDateTimeUtc());
+            if (!circuitSnapshot.isEmpty()) {
+                NativeOrderSafety::OrderAuditLogConfig incidentLogConfig;
+                incidentLogConfig.enabled = true;
+                incidentLogConfig.path = dashboardConnectorOrderIncidentLogPathEdit_
+                    ? dashboardConnectorOrderIncidentLogPathEdit_->text().trimmed()
+                    : QString();
+                incidentLogConfig.maxBytes = static_cast<quint64>(dashboardConnectorOrderIncidentMaxBytesSpin_
+                    ? dashboardConnectorOrderIncidentMaxBytesSpin_->value()
+                    : 2 * 1024 * 1024);
+                incidentLogConfig.backupCount = dashboardConnectorOrderIncidentBackupCountSpin_
+                    ? dashboardConnectorOrderIncidentBackupCountSpin_->value()
+                    : 1;
+                const QJsonObject incident = NativeOrderSafety::buildConnectorOrderCircuitIncident(
+                    QStringLiteral("opened"),
+                    circuitSnapshot,
+                    QStringLiteral("cpp-dashboard"),
+                    order.error,
+                    QDateTime::currentDateTimeUtc());
+                NativeOrderSafety::enqueueOrderAuditEvent(incident, incidentLogConfig);
+                appendDashboardAllLog(
+                    QStringLiteral("Connector order circuit opened: %1")
+                        .arg(circuitSnapshot.value(QStringLiteral("message")).toString()));
+            }
+        }
+        if (isPercentPriceFilterError(order.error)) {
+            double reducedQtyCap = pending.quantity * 0.5;
+            if (qIsFinite(symbolFilters.stepSize) && symbolFilters.stepSize > 0.0) {
+                reducedQtyCap = floorToOrderStep(
+                    reducedQtyCap,
+                    symbolFilters.stepSize,
+                    symbolFilters.quantityPrecision);
+            }
+            const double minQtyCap = (qIsFinite(symbolFilters.minQty) && symbolFilters.minQty > 0.0)
+                ? symbolFilters.minQty
+                : (qIsFinite(symbolFilters.stepSize) && symbolFilters.stepSize > 0.0
+                       ? symbolFilters.stepSize
+                       : 0.0);
+            if (reducedQtyCap > 0.0) {
+                reducedQtyCap = std::max(minQtyCap, reducedQtyCap);
+                dashboardRuntimeOpenQtyCaps_.insert(key, reducedQtyCap);
+            }
+            const qint64 retryDelayMs = pending.testnet ? 15000 : 5000;
+            dashboardRuntimeEntryRetryAfterMs_.insert(key, QDateTime::currentMSecsSinceEpoch() + retryDelayMs);
+            appendDashboardPositionLog(
+                QString("%1 %2@%3 entry delayed (%4): %5 Retrying with smaller size in %6s.")
+                    .arg(openSide,
+                         symbol,
+                         interval,
+                         pending.connectorKey,
+                         order.error,
+                         QString::number(retryDelayMs / 1000)));
+        } else {
+            dashboardRuntimeOpenQtyCaps_.remove(key);
+            appendDashboardPositionLog(
+                QString("%1 %2@%3 order failed (%4): %5")
+                    .arg(openSide, symbol, interval, pending.connectorKey, order.error));
+        }
+        return;
+    }
+
+    const QString openOrderInfo = order.error;
+    const double filledQty = (qIsFinite(order.executedQty) && order.executedQty > 0.0)
+        ? order.executedQty
+        : pending.quantity;
+    dashboardRuntimeEntryRetryAfterMs_.remove(key);
+    if (!openOrderInfo.trimmed().isEmpty() && isPercentPriceFilterError(openOrderInfo)) {
+        dashboardRuntimeOpenQtyCaps_.insert(key, std::max(filledQty, 0.0));
+    } else {
+        dashboardRuntimeOpenQtyCaps_.remove(key);
+    }
+    double entryPrice = (qIsFinite(order.avgPrice) && order.avgPrice > 0.0)
+        ? order.avgPrice
+        : pending.price;
+    const BinanceRestClient::FuturesPosition *livePos =
+        pickLiveFuturesPosition(snapshot, symbol, openSide, pending.hedgeMode);
+    if (livePos && qIsFinite(livePos->entryPrice) && livePos->entryPrice > 0.0) {
+        entryPrice = livePos->entryPrice;
+    }
+    double rowQty = filledQty;
+    if ((!qIsFinite(rowQty) || rowQty <= 1e-10)
+        && livePos
+        && qIsFinite(livePos->positionAmt)
+        && std::fabs(livePos->positionAmt) > 1e-10) {
+        rowQty = std::fabs(livePos->positionAmt);
+    }
+    // The exchange reports one position per symbol and side, shared by every
+    // runtime row on the same connector.
+    double existingGroupQty = 0.0;
+    for (auto it = dashboardRuntimeOpenPositions_.cbegin(); it != dashboardRuntimeOpenPositions_.cend(); ++it) {
+        const RuntimePosition &pos = it.value();
+        if (it.key().section('|', 0, 0).trimmed().toUpper() == symbol
+            && pos.side.trimmed().toUpper() == openSide
+            && pos.connectorKey.trimmed().toLower() == pending.connectorKey.trimmed().toLower()
+            && pos.connectorBaseUrl.trimmed().toLower() == pending.connectorBaseUrl.trimmed().toLower()) {
+            existingGroupQty += std::max(0.0, pos.quantity);
+        }
+    }
+    const double groupQty = existingGroupQty + std::max(0.0, rowQty);
+    const double markPrice = dashboardRuntimeMarkPrice(symbol, livePos, pending.price);
+    const double fallbackMarginUsdt = std::max(0.0, (entryPrice * rowQty) / pending.leverage);
+    const LivePositionMetricsShare liveShare = allocateLivePositionShare(
+        livePos,
+        rowQty,
+        groupQty,
+        std::max(0.0, rowQty * markPrice),
+        fallbackMarginUsdt,
+        fallbackMarginUsdt,
+        0.0);
+    const double sizeUsdt = std::max(0.0, liveShare.sizeUsdt);
+    const double displayMarginUsdt = std::max(0.0, liveShare.displayMarginUsdt);
+    const double roiBasisUsdt = std::max(1e-9, liveShare.roiBasisUsdt);
+    const double marginRatio = (livePos && livePos->marginRatio > 0.0) ? livePos->marginRatio : 0.0;
+    const double liqPrice = (livePos && livePos->liquidationPrice > 0.0) ? livePos->liquidationPrice : 0.0;
+    dashboardRuntimeOpenPositions_.insert(
+        key,
+        RuntimePosition{
+            openSide,
+            interval,
+            pending.triggerSource,
+            pending.connectorKey,
+            pending.connectorBaseUrl,
+            entryPrice,
+            rowQty,
+            pending.leverage,
+            roiBasisUsdt,
+            displayMarginUsdt,
+        });
+    dashboardRuntimeStopLoss_.watch(NativeSymbolTable::intern(symbol), key);
+
+    if (positionsTable_) {
+        if (appendOpenPositionRow(
+                positionsTable_,
+                positionsRowSequenceCounter_,
+                PositionTableOpenRowData{
+                    symbol,
+                    interval,
+                    pending.triggerSource,
+                    pending.triggerText,
+                    pending.rowIndicatorValueSummary,
+                    openSide,
+                    QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"),
+                    pending.stopLossText,
+                    pending.connectorKey,
+                    order.orderId,
+                    sizeUsdt,
+                    rowQty,
+                    markPrice,
+                    marginRatio,
+                    liqPrice,
+                    displayMarginUsdt,
+                    roiBasisUsdt,
+                })) {
+            *tableStructureChanged = true;
+            *tableMutated = true;
+        }
+    }
+    appendDashboardPositionLog(
+        QString("%1 %2@%3 opened at %4 qty=%5 (%6, values: %7, connector=%8, orderId=%9%10)")
+            .arg(openSide,
+                 symbol,
+                 interval,
+                 QString::number(entryPrice, 'f', 6),
+                 QString::number(rowQty, 'f', 6),
+                 pending.triggerText,
+                 pending.indicatorValueSummary,
+                 pending.connectorKey,
+                 order.orderId,
+                 openOrderInfo.trimmed().isEmpty() ? QString() : QStringLiteral(", note=%1").arg(openOrderInfo.trimmed())));
+}
+
+void TradingBotWindow::applyDashboardRuntimeCloseFill(
+    const PendingRuntimeOrder &pending,
+    const BinanceRestClient::FuturesOrderResult &order,
+    const BinanceRestClient::FuturesPositionsResult *snapshot,
+    bool *tableMutated) {
+    const QString &key = pending.runtimeKey;
+    const QString &symbol = pending.symbol;
+    const QString &interval = pending.interval;
+    const auto openIt = dashboardRuntimeOpenPositions_.find(key);
+    if (openIt == dashboardRuntimeOpenPositions_.end()) {
+        appendDashboardPositionLog(
+            QString("%1 %2@%3 close result ignored (%4): the runtime position is no longer tracked.")
+                .arg(pending.side, symbol, interval, pending.connectorKey));
+        return;
+    }
+    RuntimePosition &openPos = openIt.value();
+    const int targetRow = findOpenPositionRow(positionsTable_, symbol, interval, pending.connectorKey);
+    if (!order.ok) {
+        if (isReduceOnlyRejectedError(order.error)
+            && !hasMatchingOpenFuturesPosition(snapshot, symbol, openPos.side, pending.hedgeMode)) {
+            if (targetRow >= 0 && positionsTable_) {
+                markPositionClosedRow(
+                    positionsTable_,
+                    positionsCumulativeView_,
+                    targetRow,
+                    QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"));
+                *tableMutated = true;
+            }
+            appendDashboardPositionLog(
+                QString("%1 %2@%3 close confirmed (%4): position is already flat on exchange.")
+                    .arg(openPos.side, symbol, interval, pending.connectorKey));
+            dashboardRuntimeLastEvalMs_.remove(key);
+            dashboardRuntimeEntryRetryAfterMs_.remove(key);
+            dashboardRuntimeOpenQtyCaps_.remove(key);
+            dashboardRuntimeOpenPositions_.remove(key);
+            dashboardRuntimeStopLoss_.finishClose(key);
+            return;
+        }
+        appendDashboardPositionLog(
+            QString("%1 %2@%3 close order failed (%4): %5")
+                .arg(openPos.side, symbol, interval, pending.connectorKey, order.error));
+        return;
+    }
 
+    const QString closeOrderId = order.orderId;
+    const QString closeOrderError = order.error;
+    const double closePrice = (qIsFinite(order.avgPrice) && order.avgPrice > 0.0)
+        ? order.avgPrice
+        : pending.closeReferencePrice;
+    const double closeQty = (qIsFinite(order.executedQty) && order.executedQty > 0.0)
+        ? order.executedQty
+        : pending.quantity;
+    const double rowQty = std::max(0.0, pending.quantity);
+    const double effectiveCloseQty = std::max(0.0, std::min(openPos.quantity, closeQty));
+    if (effectiveCloseQty <= 0.0) {
+        appendDashboardPositionLog(
+            QString("%1 %2@%3 close order returned zero fill; keeping position open.")
+                .arg(openPos.side, symbol, interval));
+        return;
+    }
+    const double realizedPnlUsdt = (openPos.side == "LONG")
+        ? (closePrice - openPos.entryPrice) * effectiveCloseQty
+        : (openPos.entryPrice - closePrice) * effectiveCloseQty;
+    const double closeShareRatio = rowQty > 1e-9
+        ? std::min(1.0, std::max(0.0, effectiveCloseQty / rowQty))
+        : 1.0;
+    const double closeRoiBasisUsed = std::max(1e-9, openPos.roiBasisUsdt * closeShareRatio);
+    const double realizedPnlPct = (realizedPnlUsdt / closeRoiBasisUsed) * 100.0;
+    const bool partialClose = (effectiveCloseQty + 1e-9) < openPos.quantity;
+    double remainingQty = 0.0;
+    double remainingNotional = 0.0;
+    double remainingDisplayMarginUsdt = 0.0;
+    double remainingRoiBasisUsdt = 0.0;
+
+    if (partialClose) {
+        remainingQty = std::max(0.0, openPos.quantity - effectiveCloseQty);
+        const double remainingRatio = rowQty > 1e-9
+            ? std::min(1.0, std::max(0.0, remainingQty / rowQty))
+            : 0.0;
+        remainingNotional = std::max(0.0, remainingQty * closePrice);
+        remainingDisplayMarginUsdt = std::max(0.0, openPos.displayMarginUsdt * remainingRatio);
+        remainingRoiBasisUsdt = std::max(0.0, openPos.roiBasisUsdt * remainingRatio);
+        openPos.displayMarginUsdt = std::max(1e-9, remainingDisplayMarginUsdt);
+        openPos.roiBasisUsdt = std::max(1e-9, remainingRoiBasisUsdt);
+    }
+
+    if (targetRow >= 0 && positionsTable_) {
+        applyCloseToPositionRow(
+            positionsTable_,
+            positionsCumulativeView_,
+            targetRow,
+            PositionTableCloseRowData{
+                symbol,
+                QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"),
+                closePrice,
+                realizedPnlUsdt,
+                realizedPnlPct,
+                closeRoiBasisUsed,
+                partialClose,
+                remainingQty,
+                remainingNotional,
+                remainingDisplayMarginUsdt,
+                remainingRoiBasisUsdt,
+            });
+        *tableMutated = true;
+    }
+
+    if (partialClose) {
+        openPos.quantity = std::max(0.0, openPos.quantity - effectiveCloseQty);
+        if (openPos.quantity <= 1e-9) {
+            openPos.quantity = 0.0;
+        }
+        appendDashboardPositionLog(
+            QString("%1 %2@%3 partially closed at %4, qty=%5 remaining=%6, PNL=%7 USDT (%8%%), connector=%9, orderId=%10: %11")
+                .arg(openPos.side,
+                     symbol,
+                     interval,
+                     QString::number(closePrice, 'f', 6),
+                     QString::number(effectiveCloseQty, 'f', 6),
+                     QString::number(openPos.quantity, 'f', 6),
+                     QString::number(realizedPnlUsdt, 'f', 2),
+                     QString::number(realizedPnlPct, 'f', 2),
+                     pending.connectorKey,
+                     closeOrderId,
+                     closeOrderError.isEmpty() ? QStringLiteral("remaining exposure still open")
+                                               : closeOrderError));
+        return;
+    }
+
+    appendDashboardPositionLog(
+        QString("%1 %2@%3 closed at %4, PNL=%5 USDT (%6%%), connector=%7, orderId=%8")
+            .arg(openPos.side,
+                 symbol,
+                 interval,
+                 QString::number(closePrice, 'f', 6),
+                 QString::number(realizedPnlUsdt, 'f', 2),
+                 QString::number(realizedPnlPct, 'f', 2),
+                 pending.connectorKey,
+                 closeOrderId));
+    dashboardRuntimeLastEvalMs_.remove(key);
+    dashboardRuntimeEntryRetryAfterMs_.remove(key);
+    dashboardRuntimeOpenQtyCaps_.remove(key);
+    dashboardRuntimeOpenPositions_.remove(key);
+    dashboardRuntimeStopLoss_.finishClose(key);
+}
+
+double TradingBotWindow::dashboardRuntimeMarkPrice(
+    const QString &symbol,
+    const BinanceRestClient::FuturesPosition *livePos,
+    double fallbackPrice) const {
+    const double streamed = dashboardPriceStream_
+        ? dashboardPriceStream_->table().markPrice(
+              NativeSymbolTable::find(symbol), QDateTime::currentMSecsSinceEpoch())
+        : 0.0;
+    if (streamed > 0.0) {
+        return streamed;
+    }
+    return (livePos && qIsFinite(livePos->markPrice) && livePos->markPrice > 0.0)
+        ? livePos->markPrice
+        : fallbackPrice;
+}
@@ -152,10 +152,16 @@ void TradingBotWindow::startDashboardRuntime() {
         orderCircuitConfig);
     dashboardRuntimeConnectorWarnings_.clear();
     dashboardRuntimeIntervalWarnings_.clear();
-    clearRuntimeSignalSockets(dashboardRuntimeSignalSockets_);
-    dashboardRuntimeSignalCandles_.clear();
-    dashboardRuntimeSignalLastClosed_.clear();
-    dashboardRuntimeSignalUpdateMs_.clear();
+    if (dashboardRuntimeEngine_) {
+        dashboardRuntimeEngine_->cancel();
+    }
+    clearRuntimeSignalStream(dashboardRuntimeSignalStream_);
+    if (dashboardRuntimeMarketData_) {
+        dashboardRuntimeMarketData_->clear();
+    }
+    dashboardRuntimeIndicatorSets_.clear();
+    dashboardRuntimeIndicatorOpenTimeMs_.clear();
+    dashboardRuntimeStopLoss_.clear();
     const int staleOpenCount = dashboardRuntimeOpenPositions_.size();
     dashboardRuntimeOpenPositions_.clear();
     int restoredOpenCount = 0;
@@ -340,6 +346,11 @@ void TradingBotWindow::stopDashboardRuntime() {
     if (!stopGuardMessage.isEmpty()) {
         appendDashboardAllLog(stopGuardMessage);
     }
+    // Orders already sent are recorded before the stop sweep looks at the
+    // open positions.
+    if (dashboardRuntimeEngine_) {
+        dashboardRuntimeEngine_->finishOrders();
+    }
     dashboardRuntimeStopping_ = true;
     dashboardRuntimeActive_ = false;
     positionsLiveActivePnlValid_ = false;
@@ -1024,9 +1035,23 @@ void TradingBotWindow::stopDashboardRuntime() {
     }
     appendDashboardAllLog("Stop triggered from Dashboard.");
     appendDashboardPositionLog("Runtime strategy loop stopped.");
-    clearRuntimeSignalSockets(dashboardRuntimeSignalSockets_);
-    dashboardRuntimeSignalCandles_.clear();
-    dashboardRuntimeSignalLastClosed_.clear();
-    dashboardRuntimeSignalUpdateMs_.clear();
+    if (dashboardRuntimeEngine_) {
+        dashboardRuntimeEngine_->cancel();
+    }
+    // Kept for the next start; stopping closes the socket and the listenKey.
+    for (NativeUserDataStream::Client *stream : std::as_const(dashboardUserDataStreams_)) {
+        stream->stop();
+    }
+    if (dashboardPriceStream_) {
+        dashboardPriceStream_->stop();
+    }
+    dashboardRuntimeStopLoss_.clear();
+    dashboardRuntimeOrderPositions_.clear();
+    clearRuntimeSignalStream(dashboardRuntimeSignalStream_);
+    if (dashboardRuntimeMarketData_) {
+        dashboardRuntimeMarketData_->clear();
+    }
+    dashboardRuntimeIndicatorSets_.clear();
+    dashboardRuntimeIndicatorOpenTimeMs_.clear();
     dashboardRuntimeStopping_ = false;
 }
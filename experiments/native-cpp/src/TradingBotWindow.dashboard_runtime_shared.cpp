@@ -79,16 +79,13 @@ int dashboardRuntimePollIntervalMs(const QTableWidget *table, bool useWebSocketF
     return useWebSocketFeed ? kInstantWsPollMs : kInstantPollMs;
 }
 
-void clearRuntimeSignalSockets(QMap<QString, BinanceWsClient *> &sockets) {
-    for (auto it = sockets.cbegin(); it != sockets.cend(); ++it) {
-        BinanceWsClient *client = it.value();
-        if (!client) {
-            continue;
-        }
-        client->disconnectFromStream();
-        client->deleteLater();
+void clearRuntimeSignalStream(BinanceWsClient *&stream) {
+    if (!stream) {
+        return;
     }
-    sockets.clear();
+    stream->unsubscribeAll();
+    stream->deleteLater();
+    stream = nullptr;
 }
 
 NativeOrderSafety::OrderAuditLogConfig gNativeRuntimeOrderAuditConfig;
@@ -183,7 +180,7 @@ void appendNativeFuturesOrderAudit(
     if (!extra.isEmpty()) {
         payload.insert(QStringLiteral("extra"), extra);
     }
-    NativeOrderSafety::appendOrderAuditEvent(
+    NativeOrderSafety::enqueueOrderAuditEvent(
         payload,
         nativeRuntimeOrderAuditLogConfig());
 }
@@ -353,15 +350,12 @@ LivePositionMetricsShare allocateLivePositionShare(
     return share;
 }
 
-QVector<BinanceRestClient::KlineCandle> signalCandlesFromSnapshot(
-    QVector<BinanceRestClient::KlineCandle> candles,
+NativeMarketDataHub::CandleView signalCandlesFromSnapshot(
+    const NativeMarketDataHub::CandleView &candles,
     bool useLiveCandles,
     bool latestCandleClosed) {
-    if (candles.isEmpty()) {
-        return candles;
-    }
     if (!useLiveCandles && !latestCandleClosed && candles.size() > 1) {
-        candles.removeLast();
+        return candles.first(candles.size() - 1);
     }
     return candles;
 }
@@ -916,6 +910,46 @@ bool hasMatchingOpenFuturesPosition(
     return false;
 }
 
+const BinanceRestClient::FuturesPosition *pickLiveFuturesPosition(
+    const BinanceRestClient::FuturesPositionsResult *snapshot,
+    const QString &symbol,
+    const QString &runtimeSide,
+    bool hedgeMode) {
+    if (!snapshot || !snapshot->ok) {
+        return nullptr;
+    }
+    const QString sym = symbol.trimmed().toUpper();
+    const QString side = runtimeSide.trimmed().toUpper();
+    const BinanceRestClient::FuturesPosition *best = nullptr;
+    double bestAbsAmt = 0.0;
+    for (const auto &pos : snapshot->positions) {
+        if (pos.symbol.trimmed().toUpper() != sym) {
+            continue;
+        }
+        const double absAmt = std::fabs(pos.positionAmt);
+        if (absAmt <= 1e-10) {
+            continue;
+        }
+        const QString posSide = pos.positionSide.trimmed().toUpper();
+        const bool sideMatches = (side == QStringLiteral("LONG") && pos.positionAmt > 0.0)
+            || (side == QStringLiteral("SHORT") && pos.positionAmt < 0.0)
+            || side.isEmpty();
+        if (hedgeMode) {
+            if ((side == QStringLiteral("LONG") && posSide == QStringLiteral("LONG"))
+                || (side == QStringLiteral("SHORT") && posSide == QStringLiteral("SHORT"))) {
+                return &pos;
+            }
+        } else if ((posSide.isEmpty() || posSide == QStringLiteral("BOTH")) && sideMatches) {
+            return &pos;
+        }
+        if (sideMatches && absAmt > bestAbsAmt) {
+            bestAbsAmt = absAmt;
+            best = &pos;
+        }
+    }
+    return best;
+}
+
 BinanceRestClient::FuturesOrderResult placeFuturesCloseOrderWithFallback(
     const QString &apiKey,
     const QString &apiSecret,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BinanceRestClient.h"
+#include "NativeMarketDataHub.h"
 #include "NativeOrderSafety.h"
 
 #include <QMap>
@@ -18,7 +19,7 @@ QString normalizedSignalFeedKey(const QString &feedText);
 bool qtWebSocketsRuntimeAvailable();
 bool loopTextRequestsInstant(const QString &text);
 int dashboardRuntimePollIntervalMs(const QTableWidget *table, bool useWebSocketFeed);
-void clearRuntimeSignalSockets(QMap<QString, BinanceWsClient *> &sockets);
+void clearRuntimeSignalStream(BinanceWsClient *&stream);
 void setNativeRuntimeOrderAuditLogConfig(const NativeOrderSafety::OrderAuditLogConfig &config);
 NativeOrderSafety::OrderAuditLogConfig nativeRuntimeOrderAuditLogConfig();
 
@@ -51,8 +52,8 @@ LivePositionMetricsShare allocateLivePositionShare(
     double fallbackRoiBasisUsdt,
     double fallbackPnlUsdt);
 
-QVector<BinanceRestClient::KlineCandle> signalCandlesFromSnapshot(
-    QVector<BinanceRestClient::KlineCandle> candles,
+NativeMarketDataHub::CandleView signalCandlesFromSnapshot(
+    const NativeMarketDataHub::CandleView &candles,
     bool useLiveCandles,
     bool latestCandleClosed);
 QString normalizedIndicatorKey(QString indicatorName);
@@ -81,6 +82,13 @@ bool hasMatchingOpenFuturesPosition(
     const QString &symbol,
     const QString &runtimeSide,
     bool hedgeMode);
+// The snapshot's position backing a runtime position: the exact hedge side
+// or one-way entry, else the largest position on that side.
+const BinanceRestClient::FuturesPosition *pickLiveFuturesPosition(
+    const BinanceRestClient::FuturesPositionsResult *snapshot,
+    const QString &symbol,
+    const QString &runtimeSide,
+    bool hedgeMode);
 
 BinanceRestClient::FuturesOrderResult placeFuturesCloseOrderWithFallback(
     const QString &apiKey,
@@ -1673,10 +1673,12 @@ QWidget *TradingBotWindow::createDashboardTab() {
     dashboardRuntimeOpenQtyCaps_.clear();
     dashboardRuntimeConnectorWarnings_.clear();
     dashboardRuntimeIntervalWarnings_.clear();
-    TradingBotWindowDashboardRuntime::clearRuntimeSignalSockets(dashboardRuntimeSignalSockets_);
-    dashboardRuntimeSignalCandles_.clear();
-    dashboardRuntimeSignalLastClosed_.clear();
-    dashboardRuntimeSignalUpdateMs_.clear();
+    TradingBotWindowDashboardRuntime::clearRuntimeSignalStream(dashboardRuntimeSignalStream_);
+    if (dashboardRuntimeMarketData_) {
+        dashboardRuntimeMarketData_->clear();
+    }
+    dashboardRuntimeIndicatorSets_.clear();
+    dashboardRuntimeIndicatorOpenTimeMs_.clear();
     dashboardRuntimeLockWidgets_.clear();
     dashboardLeadTraderEnableCheck_ = nullptr;
     dashboardLeadTraderCombo_ = nullptr;
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "BinanceRestClient.h"
+#include "NativeDashboardEngine.h"
+#include "NativeIndicatorRuntime.h"
+#include "NativeMarketDataHub.h"
 #include "NativeOrderSafety.h"
+#include "NativePriceStream.h"
+#include "NativeUserDataStream.h"
 
 #include <QMainWindow>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QJsonObject>
 #include <QList>
 #include <QMap>
@@ -76,17 +82,61 @@ private:
     void removeSelectedBacktestSymbolIntervalPairs();
     void clearBacktestSymbolIntervalPairs();
     void refreshBacktestSymbolIntervalTable();
-    void startBacktest(bool optimizerRequested);
+    void startBacktest(bool optimizerRequested, bool resumeCheckpoint = false);
     void resumeBacktestCheckpoint();
     void submitServiceBacktest(const QJsonObject &request, const QString &loopInterval, const QString &startMessage);
     void setBacktestRunningUi(bool running);
     void startDashboardRuntime();
     void stopDashboardRuntime();
     void runDashboardRuntimeCycle();
+    void applyDashboardRuntimeCycle(const NativeDashboardEngine::CycleDataPtr &prefetched);
+    // Records the fills of the order batch a cycle queued on the engine.
+    void applyDashboardRuntimeOrders(const NativeDashboardEngine::OrderResultsPtr &results);
+    struct PendingRuntimeOrder;
+    // Apply one order's result, placed by the engine or filled on paper, to
+    // the runtime positions and the positions table; snapshot is the
+    // connector's positions after the order, if fetched.
+    void applyDashboardRuntimeOpenFill(
+        const PendingRuntimeOrder &pending,
+        const BinanceRestClient::FuturesOrderResult &order,
+        const BinanceRestClient::FuturesPositionsResult *snapshot,
+        bool *tableMutated,
+        bool *tableStructureChanged);
+    void applyDashboardRuntimeCloseFill(
+        const PendingRuntimeOrder &pending,
+        const BinanceRestClient::FuturesOrderResult &order,
+        const BinanceRestClient::FuturesPositionsResult *snapshot,
+        bool *tableMutated);
+    // The streamed mark price while it is fresh, else the exchange's, else
+    // fallbackPrice.
+    double dashboardRuntimeMarkPrice(
+        const QString &symbol,
+        const BinanceRestClient::FuturesPosition *livePos,
+        double fallbackPrice) const;
+    // The connector's user-data stream, started (or restarted for new
+    // credentials) on demand; nullptr without Qt WebSockets.
+    NativeUserDataStream::Client *dashboardUserDataStream(
+        const QString &connectorCacheKey,
+        bool testnet,
+        const QString &baseUrl,
+        const QString &apiKey,
+        const QString &apiSecret);
+    // Flags the open runtime positions of the symbol whose per_trade
+    // stop-loss the streamed mark price has reached and runs a cycle to
+    // close them.
+    void checkDashboardRuntimeStopLoss(NativeSymbolTable::SymbolId symbolId);
+    // Regroups the open runtime position keys by symbol id for the
+    // stop-loss check at cycle start.
+    void rebuildDashboardRuntimeStopLossIndex();
     void refreshDashboardOrderAuditStatus();
     void refreshDashboardOpenPositionIndicatorValuesForSignalKey(
         const QString &signalKey,
-        const QVector<BinanceRestClient::KlineCandle> &marketCandles);
+        const NativeMarketDataHub::CandleView &marketCandles);
+    const NativeIndicatorRuntime::IncrementalIndicatorSet &syncDashboardRuntimeIndicatorSet(
+        const QString &signalKey,
+        const NativeIndicatorRuntime::ConfigMap &configs,
+        const NativeMarketDataHub::CandleView &marketCandles,
+        bool latestCandleClosed);
     void appendDashboardAllLog(const QString &message);
     void appendDashboardPositionLog(const QString &message);
     void appendDashboardWaitingLog(const QString &message);
@@ -118,6 +168,7 @@ private:
     void registerDashboardRuntimeLockWidget(QWidget *widget);
     QString dashboardEnabledIndicatorsSummary() const;
     QString dashboardStopLossSummary() const;
+    NativePriceStream::StopLossRule dashboardStopLossRule() const;
     QString dashboardStrategySummary() const;
     bool dashboardOverridesHasPair(const QString &symbol, const QString &interval) const;
     bool addDashboardOverrideRow(const QString &symbolRaw, const QString &intervalRaw);
@@ -270,10 +321,12 @@ private:
     QMap<QString, double> dashboardRuntimeOpenQtyCaps_;
     QSet<QString> dashboardRuntimeConnectorWarnings_;
     QSet<QString> dashboardRuntimeIntervalWarnings_;
-    QMap<QString, BinanceWsClient *> dashboardRuntimeSignalSockets_;
-    QMap<QString, QVector<BinanceRestClient::KlineCandle>> dashboardRuntimeSignalCandles_;
-    QMap<QString, bool> dashboardRuntimeSignalLastClosed_;
-    QMap<QString, qint64> dashboardRuntimeSignalUpdateMs_;
+    BinanceWsClient *dashboardRuntimeSignalStream_ = nullptr;
+    NativeMarketDataHub::Hub *dashboardRuntimeMarketData_ = nullptr;
+    // Live indicator state per signal key and indicator selection, with the
+    // open time of the last closed candle each set has committed.
+    QMap<QString, NativeIndicatorRuntime::IncrementalIndicatorSet> dashboardRuntimeIndicatorSets_;
+    QMap<QString, qint64> dashboardRuntimeIndicatorOpenTimeMs_;
     QList<QWidget *> dashboardRuntimeLockWidgets_;
     QCheckBox *dashboardLeadTraderEnableCheck_;
     QComboBox *dashboardLeadTraderCombo_;
@@ -289,6 +342,16 @@ private:
     bool dashboardRuntimeActive_ = false;
     bool dashboardRuntimeStopping_ = false;
     bool dashboardRuntimeCycleInProgress_ = false;
+    NativeDashboardEngine::Engine *dashboardRuntimeEngine_ = nullptr;
+    // Futures account state per runtime connector cache key; replaces the
+    // per-cycle position and balance polling while synced.
+    QHash<QString, NativeUserDataStream::Client *> dashboardUserDataStreams_;
+    // Mark and book prices of every runtime symbol.
+    NativePriceStream::Service *dashboardPriceStream_ = nullptr;
+    // Stop-loss settings as of the last settings change or cycle start, the
+    // open position keys per symbol id and the keys whose close is in
+    // flight; keys closed since the last rebuild are skipped on lookup.
+    NativePriceStream::StopLossWatch dashboardRuntimeStopLoss_;
     int dashboardRuntimeLiveSubmitAttemptCount_ = 0;
     std::unique_ptr<NativeOrderSafety::ConnectorOrderCircuitBreaker> dashboardRuntimeConnectorOrderCircuit_;
     QMap<QString, QVariantMap> dashboardWaitingActiveEntries_;
@@ -307,6 +370,40 @@ private:
         double displayMarginUsdt = 0.0;
     };
     QMap<QString, RuntimePosition> dashboardRuntimeOpenPositions_;
+    // What applying an order's result needs from the cycle that queued it.
+    struct PendingRuntimeOrder {
+        QString runtimeKey;
+        QString symbol;
+        QString interval;
+        // LONG or SHORT: the side opened, or the side of the position closed.
+        QString side;
+        QString connectorKey;
+        QString connectorBaseUrl;
+        // Keys the engine's post-order positions snapshot.
+        QString connectorCacheKey;
+        bool opening = true;
+        bool hedgeMode = true;
+        bool testnet = false;
+        // Candle close the signal was evaluated at.
+        double price = 0.0;
+        double quantity = 0.0;
+        double leverage = 1.0;
+        // Opens only.
+        QString triggerSource;
+        QString triggerText;
+        QString indicatorValueSummary;
+        QString rowIndicatorValueSummary;
+        QString stopLossText;
+        BinanceRestClient::FuturesSymbolFilters symbolFilters;
+        // Closes only: the fill price assumed when the exchange reports none.
+        double closeReferencePrice = 0.0;
+    };
+    // The batch on the engine, in batch order.
+    QList<PendingRuntimeOrder> dashboardRuntimePendingOrders_;
+    // Positions fetched after the last batch per connector cache key; the
+    // next cycle reads them instead of an account stream that may not have
+    // applied the fills yet.
+    QHash<QString, BinanceRestClient::FuturesPositionsResult> dashboardRuntimeOrderPositions_;
 
     QComboBox *chartMarketCombo_;
     QComboBox *chartSymbolCombo_;
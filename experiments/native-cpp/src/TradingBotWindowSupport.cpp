@@ -1,24 +1,21 @@
 #include "TradingBotWindowSupport.h"
 
+#include "NativeHttpTransport.h"
 #include "generated/PythonParityContract.h"
 
 #include <QColor>
 #include <QComboBox>
 #include <QByteArray>
-#include <QEventLoop>
 #include <QHostAddress>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QRegularExpression>
 #include <QSet>
 #include <QSignalBlocker>
 #include <QStandardItemModel>
 #include <QTableWidgetItem>
-#include <QTimer>
 #include <QUrl>
 #include <QUrlQuery>
 #include <QVector>
@@ -483,49 +480,31 @@ ServiceApiJsonResult serviceApiRequestJson(
         requestUrl.setQuery(query);
     }
 
-    QNetworkAccessManager manager;
-    QNetworkRequest request{requestUrl};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("trading-bot-cpp/1.0"));
-    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
-    if (!token.isEmpty()) {
-        request.setRawHeader(QByteArrayLiteral("Authorization"), QByteArrayLiteral("Bearer ") + token.toUtf8());
-    }
-
-    QNetworkReply *reply = nullptr;
-    const QByteArray payload = body.isEmpty() ? QByteArrayLiteral("{}") : QJsonDocument(body).toJson(QJsonDocument::Compact);
-    if (normalizedMethod == QStringLiteral("GET")) {
-        reply = manager.get(request);
-    } else if (normalizedMethod == QStringLiteral("POST")) {
-        reply = manager.post(request, payload);
-    } else if (normalizedMethod == QStringLiteral("PATCH")) {
-        reply = manager.sendCustomRequest(request, QByteArrayLiteral("PATCH"), payload);
-    } else if (normalizedMethod == QStringLiteral("PUT")) {
-        reply = manager.put(request, payload);
-    } else if (normalizedMethod == QStringLiteral("DELETE")) {
-        reply = manager.sendCustomRequest(request, QByteArrayLiteral("DELETE"), payload);
-    } else {
+    if (normalizedMethod != QStringLiteral("GET") && normalizedMethod != QStringLiteral("POST")
+        && normalizedMethod != QStringLiteral("PATCH") && normalizedMethod != QStringLiteral("PUT")
+        && normalizedMethod != QStringLiteral("DELETE")) {
         result.error = QStringLiteral("Unsupported Service API method %1").arg(normalizedMethod);
         return result;
     }
 
-    QEventLoop loop;
-    QTimer timer;
-    bool timedOut = false;
-    timer.setSingleShot(true);
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    QObject::connect(&timer, &QTimer::timeout, &loop, [&]() {
-        timedOut = true;
-        reply->abort();
-        loop.quit();
-    });
-    timer.start(timeoutMs);
-    loop.exec();
-
-    const QByteArray responseBody = reply->readAll();
-    result.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    const QNetworkReply::NetworkError networkError = reply->error();
-    const QString networkErrorText = reply->errorString();
-    reply->deleteLater();
+    NativeHttpTransport::Request request;
+    request.method = normalizedMethod.toLatin1();
+    request.url = requestUrl;
+    request.contentType = QByteArrayLiteral("application/json");
+    if (!token.isEmpty()) {
+        request.headers.append({QByteArrayLiteral("Authorization"), QByteArrayLiteral("Bearer ") + token.toUtf8()});
+    }
+    if (normalizedMethod != QStringLiteral("GET")) {
+        request.body = body.isEmpty() ? QByteArrayLiteral("{}") : QJsonDocument(body).toJson(QJsonDocument::Compact);
+    }
+    request.timeoutMs = timeoutMs;
+
+    const NativeHttpTransport::Response response = NativeHttpTransport::send(request);
+    const bool timedOut = response.timedOut;
+    const QByteArray &responseBody = response.body;
+    result.statusCode = response.statusCode;
+    const QNetworkReply::NetworkError networkError = response.networkError;
+    const QString &networkErrorText = response.errorString;
 
     if (timedOut) {
         result.error = QStringLiteral("Service API request timed out: %1").arg(url);
@@ -1,3 +1,5 @@
+#include "BinanceRestClient.h"
+#include "NativeOrderSafety.h"
 #include "TradingBotWindow.h"
 
 #include <QApplication>
@@ -9,6 +11,7 @@
 #include <QFileInfo>
 #include <QGuiApplication>
 #include <QIcon>
+#include <QStandardPaths>
 #include <QStringList>
 #include <QTabWidget>
 #include <QTextStream>
@@ -186,6 +189,10 @@ int main(int argc, char *argv[]) {
         return runBoundedSmoke(app, icon);
     }
 
+    // Historical candles persist between sessions so backtests only fetch what is new.
+    BinanceRestClient::setKlineStoreDirectory(
+        QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(QStringLiteral("klines")));
+
     TradingBotWindow window;
     if (!icon.isNull()) {
         window.setWindowIcon(icon);
@@ -193,6 +200,9 @@ int main(int argc, char *argv[]) {
 
     window.showMaximized();
 
-    return app.exec();
+    const int exitCode = app.exec();
+    // Order audit lines are written in the background; land the tail on disk.
+    NativeOrderSafety::flushOrderAuditLog();
+    return exitCode;
 }
 
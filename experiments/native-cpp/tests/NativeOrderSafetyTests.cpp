@@ -9,6 +9,9 @@
 #include "../src/NativeLlmAdvisory.h"
 #include "../src/NativeOrderSafety.h"
 #include "../src/NativePortfolio.h"
+#include "../src/NativeRequestLimiter.h"
+#include "../src/NativeRollingWindow.h"
+#include "../src/NativeSignalBits.h"
 #include "../src/NativeStartupPackaging.h"
 #include "../src/NativeStrategyRuntime.h"
 #include "../src/generated/PythonIndicatorReference.h"
@@ -25,8 +28,14 @@
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <chrono>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -107,12 +116,12 @@ int main(int argc, char **argv) {
               == parityContractHash,
           QStringLiteral("indicator fixture payload should identify the active Python source contract"));
 
-    QVector<NativeIndicatorRuntime::Candle> indicatorCandles;
+    NativeIndicatorRuntime::CandleColumns indicatorCandles;
     const QJsonArray indicatorCandleValues = indicatorReference.value(QStringLiteral("candles")).toArray();
     indicatorCandles.reserve(indicatorCandleValues.size());
     for (const QJsonValue &value : indicatorCandleValues) {
         const QJsonObject candle = value.toObject();
-        indicatorCandles.push_back({
+        indicatorCandles.append(0, {
             candle.value(QStringLiteral("open")).toDouble(),
             candle.value(QStringLiteral("high")).toDouble(),
             candle.value(QStringLiteral("low")).toDouble(),
@@ -169,6 +178,282 @@ int main(int argc, char **argv) {
     check(NativeIndicatorRuntime::unsupportedEnabledIndicatorKeys(indicatorConfigs).isEmpty(),
           QStringLiteral("native C++ calculator should support every enabled Python fixture indicator"));
 
+    NativeRollingWindow::RollingSum zeroWindow;
+    zeroWindow.push(0.1);
+    zeroWindow.push(0.0);
+    zeroWindow.pop(0.1);
+    check(zeroWindow.finiteSum() == 0.0 && zeroWindow.finiteCount() == 1,
+          QStringLiteral("rolling sum should report exactly zero once only zeros remain"));
+    zeroWindow.push(std::numeric_limits<double>::quiet_NaN());
+    check(!zeroWindow.allFinite() && std::isnan(zeroWindow.ieeeSum()),
+          QStringLiteral("rolling sum should propagate NaN through its IEEE sum"));
+    NativeRollingWindow::RollingMaximum earliestMaximum(3);
+    NativeRollingWindow::MonotonicWindow<NativeRollingWindow::Extremum::Maximum,
+                                         NativeRollingWindow::TieBreak::Latest> latestMaximum(3);
+    for (qsizetype index = 0; index < 3; ++index) {
+        const double value = index == 1 ? std::numeric_limits<double>::quiet_NaN() : 5.0;
+        earliestMaximum.push(index, value);
+        latestMaximum.push(index, value);
+    }
+    check(earliestMaximum.index() == 0 && latestMaximum.index() == 2,
+          QStringLiteral("monotonic windows should honour their tie-break and skip NaN"));
+
+    // Sizes straddle the four-word AVX2 block and a partial last word.
+    for (const qsizetype bitCount : {qsizetype{1}, qsizetype{64}, qsizetype{257}, qsizetype{1000}}) {
+        const auto leftFlag = [](qsizetype index) { return index % 3 == 0 || index % 64 == 63; };
+        const auto rightFlag = [](qsizetype index) { return index % 5 < 2; };
+        const NativeSignalBits::SignalBits left = NativeSignalBits::SignalBits::fromPredicate(bitCount, leftFlag);
+        const NativeSignalBits::SignalBits right = NativeSignalBits::SignalBits::fromPredicate(bitCount, rightFlag);
+        NativeSignalBits::SignalBits both = left;
+        both &= right;
+        NativeSignalBits::SignalBits either = left;
+        either |= right;
+        const NativeSignalBits::SignalBits all(bitCount, true);
+        bool bitsMatch = all.count() == bitCount;
+        qsizetype expectedEither = 0;
+        for (qsizetype index = 0; index < bitCount; ++index) {
+            bitsMatch = bitsMatch && left.test(index) == leftFlag(index)
+                && both.test(index) == (leftFlag(index) && rightFlag(index))
+                && either.test(index) == (leftFlag(index) || rightFlag(index));
+            if (leftFlag(index) || rightFlag(index)) ++expectedEither;
+        }
+        check(bitsMatch && either.count() == expectedEither,
+              QStringLiteral("signal bitsets should combine word-wide like per-bar flags for %1 bits").arg(bitCount));
+    }
+
+    // Streaming window kernels against a direct rescan of every window, over
+    // candles with NaN gaps and a flat stretch.
+    QVector<NativeIndicatorRuntime::Candle> windowCandles;
+    for (qsizetype index = 0; index < 720; ++index) {
+        const double drift = 100.0 + 12.0 * std::sin(static_cast<double>(index) / 17.0)
+            + 0.05 * static_cast<double>(index % 11);
+        NativeIndicatorRuntime::Candle candle{
+            drift - 0.4, drift + 0.9 + 0.1 * static_cast<double>(index % 3), drift - 1.1, drift,
+            500.0 + static_cast<double>((index * 37) % 101)};
+        if (index >= 300 && index < 340) {
+            candle = {100.0, 100.0, 100.0, 100.0, 0.0};
+        }
+        if (index % 97 == 13) {
+            candle.high = std::numeric_limits<double>::quiet_NaN();
+        }
+        if (index % 131 == 29) {
+            candle.close = std::numeric_limits<double>::quiet_NaN();
+        }
+        windowCandles.push_back(candle);
+    }
+    const qsizetype windowLength = 14;
+    NativeIndicatorRuntime::ConfigMap windowConfigs;
+    for (const QString &key : {QStringLiteral("ma"), QStringLiteral("bb"), QStringLiteral("donchian"),
+                               QStringLiteral("willr"), QStringLiteral("aroon"), QStringLiteral("cci")}) {
+        windowConfigs.insert(key, QJsonObject{
+            {QStringLiteral("enabled"), true},
+            {QStringLiteral("length"), static_cast<double>(windowLength)},
+        });
+    }
+    const NativeIndicatorRuntime::SeriesMap windowActual =
+        NativeIndicatorRuntime::computeConfiguredSeries(
+            NativeIndicatorRuntime::CandleColumns::fromCandles(windowCandles),
+            windowConfigs);
+    const auto sameValue = [](double expected, double actual, double relativeTolerance) {
+        if (std::isnan(expected) || std::isnan(actual)) {
+            return std::isnan(expected) && std::isnan(actual);
+        }
+        return std::abs(actual - expected) <= relativeTolerance * std::max(1.0, std::abs(expected));
+    };
+    for (qsizetype index = 0; index < windowCandles.size(); ++index) {
+        const qsizetype start = std::max<qsizetype>(0, index + 1 - windowLength);
+        const bool fullWindow = index + 1 >= windowLength;
+        double highest = -std::numeric_limits<double>::infinity();
+        double lowest = std::numeric_limits<double>::infinity();
+        double closeSum = 0.0;
+        double typicalSum = 0.0;
+        double typicalHigh = -std::numeric_limits<double>::infinity();
+        double typicalLow = std::numeric_limits<double>::infinity();
+        bool candlesFinite = true;
+        bool closesFinite = true;
+        bool typicalFinite = true;
+        qsizetype latestHigh = start;
+        qsizetype latestLow = start;
+        for (qsizetype cursor = start; cursor <= index; ++cursor) {
+            const NativeIndicatorRuntime::Candle &candle = windowCandles[cursor];
+            const double typical = (candle.high + candle.low + candle.close) / 3.0;
+            highest = std::max(highest, candle.high);
+            lowest = std::min(lowest, candle.low);
+            closeSum += candle.close;
+            typicalSum += typical;
+            typicalHigh = std::max(typicalHigh, typical);
+            typicalLow = std::min(typicalLow, typical);
+            candlesFinite = candlesFinite && std::isfinite(candle.high) && std::isfinite(candle.low)
+                && std::isfinite(candle.close);
+            closesFinite = closesFinite && std::isfinite(candle.close);
+            typicalFinite = typicalFinite && std::isfinite(typical);
+            if (candle.high >= windowCandles[latestHigh].high) latestHigh = cursor;
+            if (candle.low <= windowCandles[latestLow].low) latestLow = cursor;
+        }
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double mean = fullWindow && closesFinite ? closeSum / static_cast<double>(windowLength) : nan;
+        double squares = 0.0;
+        double absoluteDeviation = 0.0;
+        const double typicalMean = typicalSum / static_cast<double>(index + 1 - start);
+        for (qsizetype cursor = start; cursor <= index; ++cursor) {
+            const NativeIndicatorRuntime::Candle &candle = windowCandles[cursor];
+            squares += (candle.close - mean) * (candle.close - mean);
+            absoluteDeviation += std::abs((candle.high + candle.low + candle.close) / 3.0 - typicalMean);
+        }
+        const double deviation = std::sqrt(squares / static_cast<double>(windowLength - 1));
+        const double span = static_cast<double>(index - start);
+        const double typical = (windowCandles[index].high + windowCandles[index].low
+                                + windowCandles[index].close) / 3.0;
+        const double cciDenominator = 0.015 * absoluteDeviation / static_cast<double>(index + 1 - start);
+        const double expectedCci = !typicalFinite || typicalHigh == typicalLow
+            ? 0.0
+            : (typical - typicalMean) / cciDenominator;
+        const double expectedWillr = fullWindow && candlesFinite && highest != lowest
+            ? (highest - windowCandles[index].close) / (highest - lowest) * -100.0
+            : nan;
+        const auto checkWindow = [&](const QString &key, double expected, double tolerance) {
+            const double actual = windowActual.value(key).value(index, nan);
+            check(sameValue(expected, actual, tolerance),
+                  QStringLiteral("streaming %1[%2] should match a window rescan: expected %3, got %4")
+                      .arg(key).arg(index).arg(expected, 0, 'g', 17).arg(actual, 0, 'g', 17));
+        };
+        checkWindow(QStringLiteral("donchian_high"), fullWindow ? highest : nan, 0.0);
+        checkWindow(QStringLiteral("donchian_low"), fullWindow ? lowest : nan, 0.0);
+        checkWindow(QStringLiteral("willr"), expectedWillr, 0.0);
+        checkWindow(QStringLiteral("aroon_up"),
+                    span == 0.0 ? 100.0 : 100.0 * static_cast<double>(latestHigh - start) / span, 0.0);
+        checkWindow(QStringLiteral("aroon_down"),
+                    span == 0.0 ? 100.0 : 100.0 * static_cast<double>(latestLow - start) / span, 0.0);
+        checkWindow(QStringLiteral("ma"), mean, 1e-12);
+        checkWindow(QStringLiteral("bb_upper"), mean + 2.0 * deviation, 1e-9);
+        checkWindow(QStringLiteral("cci"), expectedCci, 1e-9);
+    }
+
+    // Incremental indicator state against the batch kernels, bar by bar, for
+    // the forming bar and once it closes. Both configurations cover every
+    // computed indicator; the short one also exercises EMA "ma" and a short
+    // Ichimoku displacement.
+    const NativeIndicatorRuntime::CandleColumns incrementalColumns =
+        NativeIndicatorRuntime::CandleColumns::fromCandles(windowCandles);
+    for (const bool shortLengths : {false, true}) {
+        NativeIndicatorRuntime::ConfigMap incrementalConfigs;
+        for (const QString &key : NativeIndicatorRuntime::computedIndicatorKeys()) {
+            QJsonObject config{{QStringLiteral("enabled"), true}};
+            if (shortLengths) {
+                config.insert(QStringLiteral("length"), 5);
+                config.insert(QStringLiteral("displacement"), 2);
+                config.insert(QStringLiteral("smooth_k"), 1);
+                config.insert(QStringLiteral("type"), QStringLiteral("EMA"));
+            }
+            incrementalConfigs.insert(key, config);
+        }
+        const NativeIndicatorRuntime::SeriesMap batchSeries =
+            NativeIndicatorRuntime::computeConfiguredSeries(incrementalColumns, incrementalConfigs);
+        NativeIndicatorRuntime::IncrementalIndicatorSet incremental(incrementalConfigs);
+        QStringList batchKeys = batchSeries.keys();
+        QStringList incrementalKeys = incremental.outputKeys();
+        batchKeys.sort();
+        incrementalKeys.sort();
+        check(batchKeys == incrementalKeys,
+              QStringLiteral("incremental indicators should produce the batch output keys"));
+        qsizetype mismatches = 0;
+        const auto compareBar = [&](qsizetype index, const QString &phase) {
+            for (const QString &key : incrementalKeys) {
+                // The chikou span looks ahead, so its latest value is always NaN.
+                if (key == QStringLiteral("ichimoku_chikou")) continue;
+                const double expected = batchSeries.value(key).value(index);
+                const double actual = incremental.value(key);
+                if (expected != actual && !sameValue(expected, actual, 1e-9) && ++mismatches <= 10) {
+                    check(false,
+                          QStringLiteral("incremental %1 %2[%3] should match the batch kernel: expected %4, got %5")
+                              .arg(phase, key).arg(index).arg(expected, 0, 'g', 17).arg(actual, 0, 'g', 17));
+                }
+            }
+        };
+        for (qsizetype index = 0; index < windowCandles.size(); ++index) {
+            NativeIndicatorRuntime::Candle tick = windowCandles[index];
+            tick.close += 2.5;
+            tick.high += 4.0;
+            tick.volume *= 2.0;
+            incremental.previewOpen(tick);
+            incremental.previewOpen(windowCandles[index]);
+            compareBar(index, QStringLiteral("preview"));
+            incremental.appendClosed(windowCandles[index]);
+            compareBar(index, QStringLiteral("closed"));
+        }
+        check(mismatches == 0 && incremental.size() == windowCandles.size() && !incremental.hasPreview(),
+              QStringLiteral("incremental indicators should track the batch kernels on every bar"));
+
+        // The recent view keeps the last bars verbatim and carries enough older
+        // values for signal decisions to match the full series.
+        const qsizetype recentEnd = 500;
+        NativeIndicatorRuntime::IncrementalIndicatorSet replay(incrementalConfigs);
+        for (qsizetype index = 0; index < recentEnd; ++index) {
+            replay.appendClosed(windowCandles[index]);
+        }
+        replay.previewOpen(windowCandles[recentEnd]);
+        const NativeIndicatorRuntime::SeriesMap prefixSeries = NativeIndicatorRuntime::computeConfiguredSeries(
+            incrementalColumns.span().first(recentEnd + 1), incrementalConfigs);
+        const NativeIndicatorRuntime::RecentSeries recent = replay.recent(true);
+        bool recentMatches = recent.closes.size() == NativeIndicatorRuntime::IncrementalIndicatorSet::kRecentBars + 3
+            && recent.closes.constLast() == windowCandles[recentEnd].close;
+        for (auto iterator = prefixSeries.cbegin(); iterator != prefixSeries.cend(); ++iterator) {
+            const NativeIndicatorRuntime::Series &full = iterator.value();
+            const NativeIndicatorRuntime::Series tail = recent.indicators.value(iterator.key());
+            recentMatches = recentMatches && tail.size() == recent.closes.size();
+            for (qsizetype back = 1; recentMatches && back <= NativeIndicatorRuntime::IncrementalIndicatorSet::kRecentBars; ++back) {
+                recentMatches = sameValue(full[full.size() - back], tail[tail.size() - back], 1e-9);
+            }
+        }
+        NativeStrategyRuntime::StrategySignalInput fullInput;
+        fullInput.closes = NativeIndicatorRuntime::Series(
+            incrementalColumns.span().close.begin(), incrementalColumns.span().close.begin() + recentEnd + 1);
+        fullInput.indicators = prefixSeries;
+        for (const QString &key : incrementalConfigs.keys()) {
+            fullInput.rules.insert(key, NativeStrategyRuntime::IndicatorRule{true, std::nullopt, std::nullopt});
+        }
+        NativeStrategyRuntime::StrategySignalInput recentInput = fullInput;
+        recentInput.closes = recent.closes;
+        recentInput.indicators = recent.indicators;
+        for (const bool useLiveValues : {true, false}) {
+            fullInput.useLiveValues = useLiveValues;
+            recentInput.useLiveValues = useLiveValues;
+            recentMatches = recentMatches
+                && NativeStrategyRuntime::buildSignalDecision(fullInput)
+                    == NativeStrategyRuntime::buildSignalDecision(recentInput);
+        }
+        check(recentMatches,
+              QStringLiteral("incremental recent series should drive the same signal decision as the full series"));
+    }
+
+    struct TimedKline {
+        qint64 openTimeMs = 0;
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+    };
+    const QVector<TimedKline> timedKlines{
+        {60'000, 1.0, 2.0, 0.5, 1.5, 10.0},
+        {120'000, 1.5, 2.5, 1.0, 2.0, 20.0},
+        {180'000, 2.0, 3.0, 1.5, 2.5, 30.0},
+    };
+    const NativeIndicatorRuntime::CandleColumns timedColumns =
+        NativeIndicatorRuntime::CandleColumns::fromKlines(timedKlines);
+    const NativeIndicatorRuntime::CandleSpan timedSpan = timedColumns;
+    check(timedColumns.size() == 3 && timedSpan.openTime[2] == 180'000
+              && timedSpan.close[1] == 2.0 && timedSpan.volume[0] == 10.0,
+          QStringLiteral("candle columns should keep each kline field in its own column"));
+    check(timedSpan.last(2).size() == 2 && timedSpan.last(2).openTime[0] == 120'000
+              && timedSpan.first(1).high[0] == 2.0,
+          QStringLiteral("candle spans should slice every column together"));
+    for (const NativeIndicatorRuntime::Column column :
+         {timedSpan.open, timedSpan.high, timedSpan.low, timedSpan.close, timedSpan.volume}) {
+        check(reinterpret_cast<quintptr>(column.data()) % NativeIndicatorRuntime::kCandleColumnAlignment == 0,
+              QStringLiteral("candle columns should start on a cache-line boundary"));
+    }
+
     const QJsonArray backtestCases = indicatorReference.value(QStringLiteral("backtest_cases")).toArray();
     check(!backtestCases.isEmpty(),
           QStringLiteral("generated Python fixture should include native backtest parity cases"));
@@ -256,6 +541,17 @@ int main(int argc, char **argv) {
         check(actual.stopLossEnabled == expected.value(QStringLiteral("stop_loss_enabled")).toBool(),
               QStringLiteral("native C++ backtest stop-loss enabled state should match Python for %1")
                   .arg(caseName));
+
+        NativeBacktestRuntime::SignalCache signalCache(indicatorCandles);
+        signalCache.prepare(request.indicators);
+        const qsizetype cachedSignals = signalCache.size();
+        signalCache.prepare(request.indicators);
+        check(cachedSignals > 0 && signalCache.size() == cachedSignals,
+              QStringLiteral("native C++ signal cache should compute each indicator once for %1").arg(caseName));
+        const NativeBacktestRuntime::Result cached =
+            NativeBacktestRuntime::run(indicatorCandles, request, {}, &signalCache);
+        check(cached.ok && cached.toJson() == actualJson,
+              QStringLiteral("native C++ backtest should match with shared cached signals for %1").arg(caseName));
     }
 
     NativeBacktestRuntime::Request cancelledBacktest;
@@ -275,6 +571,31 @@ int main(int argc, char **argv) {
     check(!cancelledResult.ok && cancelledResult.error == QStringLiteral("backtest_cancelled"),
           QStringLiteral("native C++ backtest should preserve cooperative cancellation"));
 
+    NativeBacktestRuntime::Request canonicalBacktest = cancelledBacktest;
+    canonicalBacktest.side = QStringLiteral("SELL");
+    canonicalBacktest.logic = QStringLiteral("OR");
+    canonicalBacktest.mddLogic = QStringLiteral("entire_account");
+    canonicalBacktest.marginMode = QStringLiteral("CROSS");
+    canonicalBacktest.leverage = 20.0;
+    canonicalBacktest.stopLossEnabled = true;
+    canonicalBacktest.stopLossMode = QStringLiteral("both");
+    canonicalBacktest.stopLossPercent = 5.0;
+    canonicalBacktest.stopLossUsdt = 2.0;
+    NativeBacktestRuntime::Request spelledBacktest = canonicalBacktest;
+    spelledBacktest.side = QStringLiteral(" sell ");
+    spelledBacktest.logic = QStringLiteral("any");
+    spelledBacktest.mddLogic = QStringLiteral("Entire_Account");
+    spelledBacktest.marginMode = QStringLiteral("cross");
+    spelledBacktest.stopLossMode = QStringLiteral(" BOTH");
+    const NativeBacktestRuntime::Result canonicalResult = NativeBacktestRuntime::run(indicatorCandles, canonicalBacktest);
+    const NativeBacktestRuntime::Result spelledResult = NativeBacktestRuntime::run(indicatorCandles, spelledBacktest);
+    check(canonicalResult.ok && canonicalResult.toJson() == spelledResult.toJson(),
+          QStringLiteral("native C++ backtest should normalize request settings once, whatever their spelling"));
+    check(spelledResult.side == QStringLiteral("SELL") && spelledResult.logic == QStringLiteral("OR")
+              && spelledResult.mddLogic == QStringLiteral("entire_account")
+              && spelledResult.stopLossMode == QStringLiteral("both"),
+          QStringLiteral("native C++ backtest should report canonical request settings"));
+
     NativeIndicatorRuntime::ConfigMap optimizerConfigs;
     optimizerConfigs.insert(
         QStringLiteral("rsi"),
@@ -387,6 +708,167 @@ int main(int argc, char **argv) {
     check(batchSnapshot.value(QStringLiteral("top_run")).toObject().value(QStringLiteral("source")).toString()
               == QStringLiteral("native-cpp-backtest"),
           QStringLiteral("native batch backtest should identify its native C++ source"));
+    NativeBacktestRuntime::Request directRequest = batchRequest.runTemplate;
+    directRequest.symbol = QStringLiteral("BTCUSDT");
+    directRequest.interval = QStringLiteral("1m");
+    directRequest.indicators.clear();
+    directRequest.indicators.insert(QStringLiteral("rsi"), optimizerConfigs.value(QStringLiteral("rsi")));
+    const QJsonObject directRow = NativeBacktestRuntime::run(indicatorCandles, directRequest).toJson();
+    QJsonObject batchBtcRow;
+    for (const QJsonValue &value : batchSnapshot.value(QStringLiteral("top_runs")).toArray()) {
+        if (value.toObject().value(QStringLiteral("symbol")).toString() == QStringLiteral("BTCUSDT")) {
+            batchBtcRow = value.toObject();
+        }
+    }
+    bool batchRowMatchesRun = !batchBtcRow.isEmpty();
+    for (auto it = directRow.cbegin(); it != directRow.cend(); ++it) {
+        batchRowMatchesRun = batchRowMatchesRun && batchBtcRow.value(it.key()) == it.value();
+    }
+    check(batchRowMatchesRun
+              && batchBtcRow.value(QStringLiteral("start")).toString() == QStringLiteral("2026-01-01")
+              && batchBtcRow.value(QStringLiteral("optimizer_rank")).isDouble(),
+          QStringLiteral("native batch rows built from candidate records should match the run's own JSON"));
+    NativeBacktestBatchRuntime::BatchRequest rejectedBatch = batchRequest;
+    rejectedBatch.optimizerMinTrades = 1'000'000;
+    rejectedBatch.resultLimit = 1;
+    const QJsonObject rejectedSnapshot = NativeBacktestBatchRuntime::runBatch(
+        rejectedBatch,
+        [&indicatorCandles](const QString &, const QString &, const NativeBacktestBatchRuntime::StopCallback &) {
+            return NativeBacktestBatchRuntime::CandleLoadResult{true, indicatorCandles, {}};
+        });
+    const QJsonArray rejectedRows = rejectedSnapshot.value(QStringLiteral("top_runs")).toArray();
+    check(rejectedRows.size() == 1
+              && rejectedRows.at(0).toObject().value(QStringLiteral("symbol")).toString() == QStringLiteral("BTCUSDT")
+              && rejectedRows.at(0).toObject().value(QStringLiteral("optimizer_rank")).isNull()
+              && rejectedRows.at(0).toObject().value(QStringLiteral("optimizer_rejection_reason")).toString()
+                     .startsWith(QStringLiteral("trades "))
+              && rejectedSnapshot.value(QStringLiteral("optimizer_filtered_count")).toInt() == 2,
+          QStringLiteral("native batch should return the earliest rejected candidates with their reasons"));
+
+    NativeBacktestBatchRuntime::BatchRequest parallelBatch = batchRequest;
+    parallelBatch.symbols = {QStringLiteral("BTCUSDT"), QStringLiteral("ETHUSDT"), QStringLiteral("SOLUSDT")};
+    parallelBatch.intervals = {QStringLiteral("1m"), QStringLiteral("5m")};
+    parallelBatch.indicatorConfigs = optimizerConfigs;
+    parallelBatch.optimizerMode = QStringLiteral("combinations");
+    parallelBatch.resultLimit = 4;
+    const NativeBacktestBatchRuntime::CandleLoader parallelLoader =
+        [&indicatorCandles](const QString &symbol, const QString &interval, const NativeBacktestBatchRuntime::StopCallback &) {
+            if (symbol == QStringLiteral("ETHUSDT") && interval == QStringLiteral("5m")) {
+                return NativeBacktestBatchRuntime::CandleLoadResult{false, {}, QStringLiteral("fixture load failure")};
+            }
+            return NativeBacktestBatchRuntime::CandleLoadResult{true, indicatorCandles, {}};
+        };
+    parallelBatch.workerThreads = 1;
+    QJsonObject serialSnapshot = NativeBacktestBatchRuntime::runBatch(parallelBatch, parallelLoader);
+    parallelBatch.workerThreads = 4;
+    QJsonObject parallelSnapshot = NativeBacktestBatchRuntime::runBatch(parallelBatch, parallelLoader);
+    check(serialSnapshot.value(QStringLiteral("worker_threads")).toInt() == 1
+              && parallelSnapshot.value(QStringLiteral("worker_threads")).toInt() == 4,
+          QStringLiteral("native batch backtest should report its worker thread count"));
+    serialSnapshot.remove(QStringLiteral("worker_threads"));
+    parallelSnapshot.remove(QStringLiteral("worker_threads"));
+    check(serialSnapshot == parallelSnapshot,
+          QStringLiteral("native parallel batch backtest should match serial results and rank ties by plan order"));
+    check(parallelSnapshot.value(QStringLiteral("processed_count")).toInt() == 18
+              && parallelSnapshot.value(QStringLiteral("errors")).toArray().size() == 1
+              && parallelSnapshot.value(QStringLiteral("top_runs")).toArray().size() == 4,
+          QStringLiteral("native parallel batch backtest should merge per-worker results and load errors"));
+    const QJsonArray parallelTopRuns = parallelSnapshot.value(QStringLiteral("top_runs")).toArray();
+    check(parallelTopRuns.at(0).toObject().value(QStringLiteral("symbol")).toString() == QStringLiteral("BTCUSDT")
+              && parallelTopRuns.at(1).toObject().value(QStringLiteral("symbol")).toString() == QStringLiteral("BTCUSDT"),
+          QStringLiteral("native parallel batch backtest should break equal scores by original plan order"));
+    std::atomic_int parallelStopPolls = 0;
+    const QJsonObject cancelledParallel = NativeBacktestBatchRuntime::runBatch(
+        parallelBatch,
+        parallelLoader,
+        [&parallelStopPolls]() { return ++parallelStopPolls > 50; });
+    check(cancelledParallel.value(QStringLiteral("state")).toString() == QStringLiteral("cancelled"),
+          QStringLiteral("native parallel batch backtest should stop every worker on cancellation"));
+
+    NativeBacktestBatchRuntime::BatchRequest progressBatch = parallelBatch;
+    progressBatch.progressIntervalMs = 0;
+    progressBatch.progressTopRuns = 2;
+    std::mutex progressMutex;
+    QVector<QJsonObject> progressSnapshots;
+    progressBatch.onProgress = [&progressMutex, &progressSnapshots](const QJsonObject &progress) {
+        std::lock_guard lock(progressMutex);
+        progressSnapshots.append(progress);
+    };
+    QJsonObject progressFinal = NativeBacktestBatchRuntime::runBatch(progressBatch, parallelLoader);
+    bool progressOrdered = !progressSnapshots.isEmpty();
+    double previousProcessed = -1.0;
+    for (const QJsonObject &progress : progressSnapshots) {
+        const double processed = progress.value(QStringLiteral("processed_count")).toDouble();
+        progressOrdered = progressOrdered
+            && progress.value(QStringLiteral("state")).toString() == QStringLiteral("running")
+            && processed >= previousProcessed
+            && progress.value(QStringLiteral("top_runs")).toArray().size() <= 2
+            && progress.contains(QStringLiteral("runs_per_second"))
+            && progress.contains(QStringLiteral("eta_ms"));
+        previousProcessed = processed;
+    }
+    check(progressOrdered,
+          QStringLiteral("native batch progress snapshots should report growing counts and a bounded top-N"));
+    progressFinal.remove(QStringLiteral("worker_threads"));
+    check(progressFinal == parallelSnapshot,
+          QStringLiteral("native batch progress reporting should not change the final snapshot"));
+
+    NativeBacktestBatchRuntime::BatchRequest budgetBatch = parallelBatch;
+    budgetBatch.timeBudgetMs = 20;
+    const QJsonObject budgetSnapshot = NativeBacktestBatchRuntime::runBatch(
+        budgetBatch,
+        [](const QString &, const QString &, const NativeBacktestBatchRuntime::StopCallback &stopRequested) {
+            for (int attempt = 0; attempt < 5'000 && !stopRequested(); ++attempt) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return NativeBacktestBatchRuntime::CandleLoadResult{false, {}, QStringLiteral("backtest_cancelled")};
+        });
+    check(budgetSnapshot.value(QStringLiteral("state")).toString() == QStringLiteral("cancelled")
+              && budgetSnapshot.value(QStringLiteral("time_budget_exhausted")).toBool(),
+          QStringLiteral("native batch should stop a slow candle load once its time budget runs out"));
+
+    QTemporaryDir checkpointDir;
+    NativeBacktestBatchRuntime::BatchRequest checkpointBatch = parallelBatch;
+    checkpointBatch.checkpointPath = checkpointDir.filePath(QStringLiteral("optimizer_checkpoint.bin"));
+    checkpointBatch.checkpointIntervalMs = 0;
+    std::atomic_int checkpointStopPolls = 0;
+    const QJsonObject stoppedSnapshot = NativeBacktestBatchRuntime::runBatch(
+        checkpointBatch,
+        parallelLoader,
+        [&checkpointStopPolls]() { return ++checkpointStopPolls > 50; });
+    const NativeBacktestBatchRuntime::CheckpointSummary checkpointSummary =
+        NativeBacktestBatchRuntime::readCheckpointSummary(checkpointBatch.checkpointPath);
+    check(stoppedSnapshot.value(QStringLiteral("state")).toString() == QStringLiteral("cancelled")
+              && stoppedSnapshot.value(QStringLiteral("checkpoint_saved")).toBool()
+              && checkpointSummary.ok
+              && checkpointSummary.optimizerMode == QStringLiteral("combinations")
+              && checkpointSummary.runCount == 18
+              && checkpointSummary.processedCount
+                     == static_cast<qint64>(stoppedSnapshot.value(QStringLiteral("processed_count")).toDouble()),
+          QStringLiteral("cancelled native batch should leave a checkpoint of the runs it finished"));
+    NativeBacktestBatchRuntime::BatchRequest mismatchedBatch = checkpointBatch;
+    mismatchedBatch.resumeFromCheckpoint = true;
+    mismatchedBatch.resultLimit = 3;
+    const QJsonObject mismatchedSnapshot = NativeBacktestBatchRuntime::runBatch(mismatchedBatch, parallelLoader);
+    check(mismatchedSnapshot.value(QStringLiteral("state")).toString() == QStringLiteral("failed")
+              && QFile::exists(checkpointBatch.checkpointPath),
+          QStringLiteral("native batch should refuse a checkpoint written for a different request"));
+    checkpointBatch.resumeFromCheckpoint = true;
+    checkpointBatch.workerThreads = 2;
+    QJsonObject resumedSnapshot = NativeBacktestBatchRuntime::runBatch(checkpointBatch, parallelLoader);
+    check(resumedSnapshot.value(QStringLiteral("state")).toString() == QStringLiteral("completed")
+              && resumedSnapshot.value(QStringLiteral("resumed_from_checkpoint")).toBool()
+              && !resumedSnapshot.value(QStringLiteral("checkpoint_saved")).toBool()
+              && !QFile::exists(checkpointBatch.checkpointPath),
+          QStringLiteral("resumed native batch should finish the plan and remove its checkpoint"));
+    for (const QString &key : {QStringLiteral("worker_threads"),
+                               QStringLiteral("checkpoint_path"),
+                               QStringLiteral("checkpoint_saved"),
+                               QStringLiteral("resumed_from_checkpoint")}) {
+        resumedSnapshot.remove(key);
+    }
+    check(resumedSnapshot == parallelSnapshot,
+          QStringLiteral("resumed native batch should report exactly what an uninterrupted batch reports"));
 
     NativeOrderSafety::LiveOrderGuardInput paperInvalidOrder;
     paperInvalidOrder.mode = QStringLiteral("Demo/Testnet");
@@ -793,6 +1275,68 @@ int main(int argc, char **argv) {
     check(!QString::fromUtf8(QJsonDocument(connectorHealth).toJson(QJsonDocument::Compact)).contains(QStringLiteral("leaked")),
           QStringLiteral("native connector health should not leak secrets"));
 
+    NativeRequestLimiter::Limiter weightLimiter(100.0, 0);
+    check(weightLimiter.tryAcquire(75.0, NativeRequestLimiter::Priority::Order, 0) == 0,
+          QStringLiteral("request limiter should grant weight within the bucket"));
+    const qint64 marketDataWaitMs = weightLimiter.tryAcquire(10.0, NativeRequestLimiter::Priority::MarketData, 0);
+    check(marketDataWaitMs >= 2'999 && marketDataWaitMs <= 3'001,
+          QStringLiteral("market data should wait until the order reserve is refilled (%1 ms)").arg(marketDataWaitMs));
+    check(weightLimiter.tryAcquire(25.0, NativeRequestLimiter::Priority::Order, 0) == 0,
+          QStringLiteral("orders should be allowed to spend the reserve market data leaves"));
+    const qint64 orderWaitMs = weightLimiter.tryAcquire(1.0, NativeRequestLimiter::Priority::Order, 0);
+    check(orderWaitMs >= 599 && orderWaitMs <= 601,
+          QStringLiteral("an empty bucket should report the refill time (%1 ms)").arg(orderWaitMs));
+    check(weightLimiter.tryAcquire(1.0, NativeRequestLimiter::Priority::Order, 600) == 0,
+          QStringLiteral("request limiter should refill at the per-minute rate"));
+
+    NativeRequestLimiter::Limiter reconciledLimiter(100.0, 0);
+    reconciledLimiter.reconcile(200, {{QByteArrayLiteral("x-mbx-used-weight-1m"), QByteArrayLiteral("70")}}, {}, 0);
+    const QJsonObject reconciledSnapshot = reconciledLimiter.snapshot(0);
+    check(reconciledSnapshot.value(QStringLiteral("available")).toDouble() == 30.0
+              && reconciledSnapshot.value(QStringLiteral("used_weight_1m")).toInt() == 70
+              && std::abs(reconciledSnapshot.value(QStringLiteral("utilization")).toDouble() - 0.7) < 1e-9,
+          QStringLiteral("request limiter should reconcile against the exchange's used weight"));
+    reconciledLimiter.reconcile(200, {{QByteArrayLiteral("X-MBX-USED-WEIGHT-1M"), QByteArrayLiteral("10")}}, {}, 0);
+    check(reconciledLimiter.snapshot(0).value(QStringLiteral("available")).toDouble() == 30.0,
+          QStringLiteral("a lower exchange count should not hand back weight the bucket already spent"));
+
+    const qint64 banNowMs = 1'770'000'000'000LL;
+    NativeRequestLimiter::Limiter bannedLimiter(100.0, banNowMs);
+    bannedLimiter.reconcile(
+        418,
+        {},
+        QByteArrayLiteral(R"({"code":-1003,"msg":"Way too much request weight used; IP banned until 1770000100000"})"),
+        banNowMs);
+    check(bannedLimiter.tryAcquire(1.0, NativeRequestLimiter::Priority::Order, banNowMs + 1'000)
+              == NativeRequestLimiter::kBanned
+              && bannedLimiter.banRemainingMs(banNowMs) == 100'000,
+          QStringLiteral("a parsed ban should block every request until it expires"));
+    check(bannedLimiter.tryAcquire(1.0, NativeRequestLimiter::Priority::Order, banNowMs + 100'000)
+              != NativeRequestLimiter::kBanned,
+          QStringLiteral("requests should resume once the ban expires"));
+    NativeRequestLimiter::Limiter retryLimiter(100.0, banNowMs);
+    retryLimiter.reconcile(429, {{QByteArrayLiteral("Retry-After"), QByteArrayLiteral("12")}},
+                           QByteArrayLiteral(R"({"code":-1003,"msg":"Too many requests."})"), banNowMs);
+    const QJsonObject retrySnapshot = retryLimiter.snapshot(banNowMs);
+    check(retrySnapshot.value(QStringLiteral("seconds_until_unban")).toDouble() == 12.0
+              && retrySnapshot.value(QStringLiteral("bans")).toInt() == 1,
+          QStringLiteral("a 429 should ban for the Retry-After window"));
+    const QJsonObject weightHealth = NativeExchangeConnectors::buildConnectorHealthSnapshot(QJsonObject{
+        {QStringLiteral("credentials_present"), true},
+        {QStringLiteral("generated_at"), 1770000000.0},
+        {QStringLiteral("request_weight"), retrySnapshot},
+    });
+    check(weightHealth.value(QStringLiteral("state")).toString() == QStringLiteral("rate_limited")
+              && weightHealth.value(QStringLiteral("request_weight")).toObject().contains(QStringLiteral("utilization")),
+          QStringLiteral("connector health should export request weight utilization and its ban"));
+    check(NativeRequestLimiter::priorityFor(QByteArrayLiteral("POST"), QStringLiteral("/fapi/v1/order"))
+                  == NativeRequestLimiter::Priority::Order
+              && NativeRequestLimiter::priorityFor(QByteArrayLiteral("GET"), QStringLiteral("/fapi/v1/order"))
+                  == NativeRequestLimiter::Priority::MarketData
+              && NativeRequestLimiter::priorityFor(QByteArrayLiteral("GET"), QStringLiteral("/fapi/v1/klines"))
+                  == NativeRequestLimiter::Priority::MarketData,
+          QStringLiteral("only order placement and cancellation should be order traffic"));
+
     const QStringList indicatorKeys = NativeStrategyRuntime::indicatorOutputKeysFromConfig(QJsonObject{
         {QStringLiteral("rsi"), QJsonObject{{QStringLiteral("enabled"), QStringLiteral("false")}}},
         {QStringLiteral("ema"), QJsonObject{{QStringLiteral("enabled"), QStringLiteral("true")}}},
@@ -1791,6 +2335,106 @@ int main(int argc, char **argv) {
           QStringLiteral("disabled audit status should be disabled"));
     check(!QFile::exists(disabled.path), QStringLiteral("disabled audit should not create a file"));
 
+    NativeOrderSafety::OrderAuditLogConfig queuedConfig;
+    queuedConfig.path = dir.filePath(QStringLiteral("queued/order_audit.jsonl"));
+    queuedConfig.maxBytes = 1024 * 1024;
+    queuedConfig.backupCount = 1;
+    const QJsonObject queuedStatus = NativeOrderSafety::enqueueOrderAuditEvent(first, queuedConfig);
+    check(queuedStatus.value(QStringLiteral("queue_capacity")).toInt() == NativeOrderSafety::kOrderAuditQueueCapacity,
+          QStringLiteral("queued audit status should expose the queue capacity"));
+    NativeOrderSafety::enqueueOrderAuditEvent(accepted, queuedConfig);
+    NativeOrderSafety::enqueueOrderAuditEvent(rejected, queuedConfig);
+    check(NativeOrderSafety::flushOrderAuditLog(), QStringLiteral("queued audit events should flush"));
+    const QStringList queuedLines = readText(queuedConfig.path).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    check(queuedLines.size() == 3
+              && queuedLines.value(0).contains(QStringLiteral("order_intent"))
+              && queuedLines.value(1).contains(QStringLiteral("order_accepted"))
+              && queuedLines.value(2).contains(QStringLiteral("order_rejected")),
+          QStringLiteral("queued audit events should be written in submission order"));
+    check(!readText(queuedConfig.path).contains(QStringLiteral("super-secret-value")),
+          QStringLiteral("queued audit lines should be redacted"));
+    const QJsonObject flushedStatus = NativeOrderSafety::currentOrderAuditStatus(queuedConfig);
+    check(flushedStatus.value(QStringLiteral("write_ok")).toBool(false)
+              && flushedStatus.value(QStringLiteral("queue_depth")).toInt(-1) == 0
+              && flushedStatus.value(QStringLiteral("path")).toString() == queuedConfig.path,
+          QStringLiteral("flushed audit queue should report an empty queue and the written log"));
+
+    NativeOrderSafety::OrderAuditLogConfig queuedRotation = config;
+    queuedRotation.path = dir.filePath(QStringLiteral("queued_rotation.jsonl"));
+    queuedRotation.syncPolicy = NativeOrderSafety::OrderAuditSyncPolicy::EveryEvent;
+    NativeOrderSafety::enqueueOrderAuditEvent(first, queuedRotation);
+    NativeOrderSafety::enqueueOrderAuditEvent(accepted, queuedRotation);
+    NativeOrderSafety::enqueueOrderAuditEvent(rejected, queuedRotation);
+    NativeOrderSafety::flushOrderAuditLog();
+    check(readText(queuedRotation.path).contains(QStringLiteral("order_rejected"))
+              && readText(NativeOrderSafety::orderAuditBackupPath(queuedRotation.path, 1)).contains(QStringLiteral("order_accepted"))
+              && readText(NativeOrderSafety::orderAuditBackupPath(queuedRotation.path, 2)).contains(QStringLiteral("order_intent")),
+          QStringLiteral("queued audit writer should rotate like the synchronous append"));
+
+    NativeOrderSafety::OrderAuditLogConfig concurrentConfig = queuedConfig;
+    concurrentConfig.path = dir.filePath(QStringLiteral("concurrent_order_audit.jsonl"));
+    constexpr int kAuditProducers = 4;
+    constexpr int kAuditEventsPerProducer = 250;
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kAuditProducers; ++producer) {
+        producers.emplace_back([&, producer]() {
+            for (int index = 0; index < kAuditEventsPerProducer; ++index) {
+                NativeOrderSafety::enqueueOrderAuditEvent(
+                    QJsonObject{
+                        {QStringLiteral("event"), QStringLiteral("order_intent")},
+                        {QStringLiteral("producer"), producer},
+                        {QStringLiteral("index"), index},
+                    },
+                    concurrentConfig);
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    check(NativeOrderSafety::flushOrderAuditLog(), QStringLiteral("concurrent audit events should flush"));
+    const QStringList concurrentLines = readText(concurrentConfig.path).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    QVector<int> nextIndex(kAuditProducers, 0);
+    bool producerOrderKept = concurrentLines.size() == kAuditProducers * kAuditEventsPerProducer;
+    for (const QString &line : concurrentLines) {
+        const QJsonObject event = QJsonDocument::fromJson(line.toUtf8()).object();
+        const int producer = event.value(QStringLiteral("producer")).toInt(-1);
+        if (producer < 0 || producer >= kAuditProducers
+            || event.value(QStringLiteral("index")).toInt(-1) != nextIndex[producer]++) {
+            producerOrderKept = false;
+        }
+    }
+    check(producerOrderKept, QStringLiteral("concurrent audit producers should each keep their event order"));
+
+    // A regular file where the log's directory should be makes every open
+    // fail until it is removed.
+    const QString auditBlocker = dir.filePath(QStringLiteral("audit_blocker"));
+    {
+        QFile blocker(auditBlocker);
+        check(blocker.open(QIODevice::WriteOnly), QStringLiteral("audit blocker file should be created"));
+    }
+    NativeOrderSafety::OrderAuditLogConfig failingConfig = queuedConfig;
+    failingConfig.path = dir.filePath(QStringLiteral("audit_blocker/order_audit.jsonl"));
+    NativeOrderSafety::enqueueOrderAuditEvent(accepted, failingConfig);
+    check(!NativeOrderSafety::flushOrderAuditLog(500),
+          QStringLiteral("flushing should fail while the audit log cannot be written"));
+    const QJsonObject failingStatus = NativeOrderSafety::currentOrderAuditStatus(failingConfig);
+    check(!failingStatus.value(QStringLiteral("write_ok")).toBool(true)
+              && failingStatus.value(QStringLiteral("failed_events")).toInt(-1) == 0,
+          QStringLiteral("a failing audit log should report the write error and keep its events for retry"));
+    check(QFile::remove(auditBlocker), QStringLiteral("audit blocker file should be removed"));
+    check(NativeOrderSafety::flushOrderAuditLog(),
+          QStringLiteral("retained audit events should flush once the log can be written"));
+    check(readText(failingConfig.path).contains(QStringLiteral("order_accepted")),
+          QStringLiteral("retained audit events should reach the log after the retry"));
+
+    disabled.path = dir.filePath(QStringLiteral("disabled_queued_order_audit.jsonl"));
+    const QJsonObject disabledQueuedStatus = NativeOrderSafety::enqueueOrderAuditEvent(first, disabled);
+    NativeOrderSafety::flushOrderAuditLog();
+    check(disabledQueuedStatus.value(QStringLiteral("state")).toString() == QStringLiteral("disabled")
+              && !QFile::exists(disabled.path),
+          QStringLiteral("disabled queued audit should not create a file"));
+
     const QDateTime preflightNow = QDateTime::fromString(QStringLiteral("2026-06-18T12:10:00.000Z"), Qt::ISODateWithMs);
     auto freshness = [preflightNow](
                          int ageSeconds,
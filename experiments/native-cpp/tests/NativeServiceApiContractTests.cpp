@@ -1,19 +1,48 @@
 #include "../src/TradingBotWindowSupport.h"
 #include "../src/BinanceRestClient.h"
+#include "../src/BinanceWsClient.h"
+#include "../src/NativeDashboardEngine.h"
+#include "../src/NativeExchangeInfo.h"
+#include "../src/NativeExchangeSimulator.h"
+#include "../src/NativeHttpTransport.h"
+#include "../src/NativeKlinePageDecoder.h"
+#include "../src/NativeKlineStore.h"
+#include "../src/NativeMarketDataHub.h"
+#include "../src/NativePriceStream.h"
+#include "../src/NativeRequestLimiter.h"
+#include "../src/NativeStreamFrameScanner.h"
+#include "../src/NativeSymbolTable.h"
+#include "../src/NativeUserDataStream.h"
 
 #include <QByteArray>
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
 #include <QHostAddress>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QRandomGenerator>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTimer>
 #include <QUrl>
 #include <QUrlQuery>
 
+#if HAS_QT_WEBSOCKETS
+#include <QWebSocket>
+#include <QWebSocketServer>
+#endif
+
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
 
 namespace {
 
@@ -38,6 +67,44 @@ void writeJsonResponseAndClose(QTcpSocket *socket, const QByteArray &body) {
     socket->write(response);
 }
 
+bool sameStreamFrame(const BinanceWsClient::StreamFrame &left, const BinanceWsClient::StreamFrame &right) {
+    return left.type == right.type && left.stream == right.stream && left.symbol == right.symbol
+        && left.interval == right.interval && left.openTimeMs == right.openTimeMs && left.open == right.open
+        && left.high == right.high && left.low == right.low && left.close == right.close
+        && left.volume == right.volume && left.isClosed == right.isClosed && left.bidPrice == right.bidPrice
+        && left.askPrice == right.askPrice && left.requestId == right.requestId && left.rejected == right.rejected
+        && left.errorCode == right.errorCode && left.errorMessage == right.errorMessage
+        && left.markPrice == right.markPrice && left.eventTimeMs == right.eventTimeMs;
+}
+
+bool sameScan(
+    const NativeStreamFrameScanner::ScannedFrame &left,
+    const NativeStreamFrameScanner::ScannedFrame &right) {
+    const auto sameSpan = [](NativeStreamFrameScanner::TextSpan a, NativeStreamFrameScanner::TextSpan b) {
+        return a.offset == b.offset && a.length == b.length;
+    };
+    return left.type == right.type && sameSpan(left.stream, right.stream) && sameSpan(left.symbol, right.symbol)
+        && sameSpan(left.interval, right.interval) && left.openTimeMs == right.openTimeMs && left.open == right.open
+        && left.high == right.high && left.low == right.low && left.close == right.close
+        && left.volume == right.volume && left.isClosed == right.isClosed && left.bidPrice == right.bidPrice
+        && left.askPrice == right.askPrice;
+}
+
+bool sameKlines(const BinanceRestClient::KlinesResult &left, const BinanceRestClient::KlinesResult &right) {
+    if (left.ok != right.ok || left.error != right.error || left.candles.size() != right.candles.size()) {
+        return false;
+    }
+    for (qsizetype index = 0; index < left.candles.size(); ++index) {
+        const BinanceRestClient::KlineCandle &a = left.candles.at(index);
+        const BinanceRestClient::KlineCandle &b = right.candles.at(index);
+        if (a.openTimeMs != b.openTimeMs || a.open != b.open || a.high != b.high || a.low != b.low
+            || a.close != b.close || a.volume != b.volume) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace
 
 int main(int argc, char **argv) {
@@ -330,7 +397,8 @@ int main(int argc, char **argv) {
 
             QJsonArray candles;
             constexpr qint64 intervalMs = 60'000;
-            for (qint64 openTime = startTime;
+            // Like Binance, the first candle is the first open time at or after startTime.
+            for (qint64 openTime = (startTime + intervalMs - 1) / intervalMs * intervalMs;
                  openTime <= endTime && candles.size() < std::max(1, limit);
                  openTime += intervalMs) {
                 const double open = 100.0 + static_cast<double>(openTime / intervalMs);
@@ -363,8 +431,9 @@ int main(int argc, char **argv) {
     check(pagedKlines.ok && pagedKlines.candles.size() == 1002,
           QStringLiteral("native historical loader should page a range larger than Binance spot page size"));
     check(observedKlineStarts.size() >= 2
-              && observedKlineStarts.at(1) == pageStart + 1000 * minuteMs,
-          QStringLiteral("native historical loader should advance the next page after the last open time"));
+              && observedKlineStarts.contains(pageStart)
+              && observedKlineStarts.contains(pageStart + 1000 * minuteMs),
+          QStringLiteral("native historical loader should start the next page where the previous page window ends"));
     check(observedKlineIntervals.size() >= 2
               && observedKlineIntervals.at(0) == QStringLiteral("1m"),
           QStringLiteral("native historical loader should preserve native Binance intervals"));
@@ -404,5 +473,1361 @@ int main(int argc, char **argv) {
     check(observedKlineStarts.size() == requestsBeforeCancellation,
           QStringLiteral("cancelled native historical fetch should not contact the exchange"));
 
+    NativeDashboardEngine::CyclePlan cyclePlan;
+    cyclePlan.plannedAtMs = 1;
+    cyclePlan.klines = {
+        {QStringLiteral("BTCUSDT|1m|a"), QStringLiteral("BTCUSDT"), QStringLiteral("1m"), false, false, 5, klineBaseUrl},
+        {QStringLiteral("BTCUSDT|1m|a"), QStringLiteral("BTCUSDT"), QStringLiteral("1m"), false, false, 5, klineBaseUrl},
+        {QStringLiteral("ETHUSDT|1m|a"), QStringLiteral("ETHUSDT"), QStringLiteral("1m"), false, false, 5, klineBaseUrl},
+    };
+    const qsizetype requestsBeforeCycle = observedKlineStarts.size();
+    NativeDashboardEngine::Engine runtimeEngine;
+    NativeDashboardEngine::CycleDataPtr cycleData;
+    QEventLoop cycleLoop;
+    QObject::connect(&runtimeEngine, &NativeDashboardEngine::Engine::cycleReady,
+                     [&](const NativeDashboardEngine::CycleDataPtr &data) {
+                         cycleData = data;
+                         cycleLoop.quit();
+                     });
+    check(runtimeEngine.submit(cyclePlan) && runtimeEngine.busy(),
+          QStringLiteral("runtime engine should accept a cycle plan"));
+    check(!runtimeEngine.submit(cyclePlan),
+          QStringLiteral("runtime engine should refuse a second cycle while one is in flight"));
+    QTimer::singleShot(5'000, &cycleLoop, &QEventLoop::quit);
+    cycleLoop.exec();
+    check(cycleData && cycleData->klines.size() == 2
+              && cycleData->klines.value(QStringLiteral("BTCUSDT|1m|a")).ok
+              && cycleData->klines.value(QStringLiteral("ETHUSDT|1m|a")).ok
+              && cycleData->plannedAtMs == 1,
+          QStringLiteral("runtime engine should deliver every planned kline snapshot"));
+    check(observedKlineStarts.size() - requestsBeforeCycle == 2,
+          QStringLiteral("runtime engine should fetch rows sharing a signal key once"));
+    check(!runtimeEngine.busy(), QStringLiteral("runtime engine should accept a new cycle after delivering"));
+
+    NativeDashboardEngine::OrderBatch orderBatch{QStringLiteral("key"), QStringLiteral("secret"), false, {}};
+    orderBatch.orders = {
+        {QStringLiteral("BTCUSDT|1m|a"), QStringLiteral("a"), klineBaseUrl, true, QStringLiteral("BTCUSDT"),
+         QStringLiteral("BUY"), 1.0, QStringLiteral("LONG"), false, 100.0},
+        {QStringLiteral("ETHUSDT|1m|a"), QStringLiteral("a"), klineBaseUrl, true, QStringLiteral("ETHUSDT"),
+         QStringLiteral("BUY"), 1.0, QStringLiteral("LONG"), false, 100.0},
+        {QStringLiteral("SOLUSDT|1m|a"), QStringLiteral("a"), klineBaseUrl, false, QStringLiteral("SOLUSDT"),
+         QStringLiteral("SELL"), 1.0, QStringLiteral("LONG"), false, 100.0},
+    };
+    QStringList placedSymbols;
+    runtimeEngine.setOrderPlacer([&placedSymbols](const NativeDashboardEngine::OrderBatch &,
+                                                  const NativeDashboardEngine::OrderRequest &request) {
+        placedSymbols.append(request.symbol);
+        BinanceRestClient::FuturesOrderResult order;
+        order.ok = !request.opening || request.symbol != QStringLiteral("BTCUSDT");
+        order.orderId = request.symbol;
+        order.error = order.ok ? QString() : QStringLiteral("rejected");
+        return order;
+    });
+    NativeDashboardEngine::OrderResultsPtr orderResults;
+    QEventLoop ordersLoop;
+    QObject::connect(&runtimeEngine, &NativeDashboardEngine::Engine::ordersReady,
+                     [&](const NativeDashboardEngine::OrderResultsPtr &results) {
+                         orderResults = results;
+                         ordersLoop.quit();
+                     });
+    check(runtimeEngine.submitOrders(orderBatch) && runtimeEngine.busy() && !runtimeEngine.submit(cyclePlan),
+          QStringLiteral("runtime engine should hold new cycles while an order batch is in flight"));
+    // The positions refresh is served by this thread's test server.
+    QTimer::singleShot(15'000, &ordersLoop, &QEventLoop::quit);
+    ordersLoop.exec();
+    check(orderResults && orderResults->outcomes.size() == 3 && !runtimeEngine.busy(),
+          QStringLiteral("runtime engine should deliver one outcome per order of the batch"));
+    check(orderResults && !orderResults->outcomes.at(0).order.ok && !orderResults->outcomes.at(1).sent
+              && orderResults->outcomes.at(2).sent && orderResults->outcomes.at(2).order.ok,
+          QStringLiteral("a failed open should hold back later opens on its connector but not closes"));
+    check(placedSymbols == QStringList{QStringLiteral("BTCUSDT"), QStringLiteral("SOLUSDT")},
+          QStringLiteral("held-back opens should never reach the exchange"));
+    check(orderResults && orderResults->positions.size() == 1
+              && orderResults->positions.contains(QStringLiteral("a")),
+          QStringLiteral("order batches should refresh positions once per connector they sent to"));
+    orderResults.reset();
+    check(runtimeEngine.submitOrders({}), QStringLiteral("runtime engine should accept an order batch after delivering"));
+    runtimeEngine.finishOrders();
+    check(orderResults && orderResults->outcomes.isEmpty() && !runtimeEngine.busy(),
+          QStringLiteral("finishing orders should deliver the batch in flight before returning"));
+
+    const auto hubCandle = [](qint64 openTimeMs, double close) {
+        NativeMarketDataHub::Candle candle;
+        candle.openTimeMs = openTimeMs;
+        candle.open = close;
+        candle.high = close;
+        candle.low = close;
+        candle.close = close;
+        return candle;
+    };
+    const auto viewOpenTimes = [](const NativeMarketDataHub::CandleView &view) {
+        QVector<qint64> openTimes;
+        for (qsizetype index = 0; index < view.size(); ++index) {
+            openTimes.append(view.at(index).openTimeMs);
+        }
+        return openTimes;
+    };
+    NativeMarketDataHub::CandleRing ring(4);
+    for (qint64 openTime = 1; openTime <= 6; ++openTime) {
+        ring.upsert(hubCandle(openTime, static_cast<double>(openTime)));
+    }
+    check(viewOpenTimes(ring.view()) == QVector<qint64>{3, 4, 5, 6},
+          QStringLiteral("candle ring should keep the newest candles in order once it wraps"));
+    check(ring.upsert(hubCandle(6, 60.0)) && ring.view().constLast().close == 60.0 && ring.size() == 4,
+          QStringLiteral("candle ring should replace the forming candle in place"));
+    check(!ring.upsert(hubCandle(2, 2.0)) && ring.view().constFirst().openTimeMs == 3,
+          QStringLiteral("candle ring should ignore candles older than its latest"));
+    check(viewOpenTimes(ring.view().first(3)) == QVector<qint64>{3, 4, 5},
+          QStringLiteral("candle view prefix should span both runs of a wrapped ring"));
+
+    const QString hubFeed = NativeMarketDataHub::feedKey(
+        QStringLiteral("Binance-SDK|https://fapi"), true, QStringLiteral("btcusdt"), QStringLiteral("1m"));
+    check(hubFeed != NativeMarketDataHub::feedKey(
+              QStringLiteral("binance-sdk|https://fapi"), false, QStringLiteral("BTCUSDT"), QStringLiteral("1m"))
+              && hubFeed == NativeMarketDataHub::feedKey(
+                  QStringLiteral("binance-sdk|https://fapi"), true, QStringLiteral("BTCUSDT"), QStringLiteral("1m")),
+          QStringLiteral("market data feeds should be keyed by connector, market, symbol and interval"));
+    NativeMarketDataHub::Hub hub(5);
+    QStringList hubNotified;
+    QObject::connect(&hub, &NativeMarketDataHub::Hub::candlesUpdated,
+                     [&](const QString &consumerKey, const QString &) { hubNotified.append(consumerKey); });
+    hub.attach(QStringLiteral("row-a"), hubFeed);
+    hub.attach(QStringLiteral("row-b"), hubFeed);
+    hub.update(hubFeed, hubCandle(8 * minuteMs, 8.0), false);
+    check(hub.fetchLimit(hubFeed, minuteMs, 8 * minuteMs) == 5,
+          QStringLiteral("market data hub should request a full seed page until a feed is seeded"));
+    QVector<NativeMarketDataHub::Candle> seedPage;
+    for (qint64 minute = 1; minute <= 7; ++minute) {
+        seedPage.append(hubCandle(minute * minuteMs, static_cast<double>(minute)));
+    }
+    check(hub.ingest(hubFeed, seedPage) && hub.isSeeded(hubFeed)
+              && viewOpenTimes(hub.view(hubFeed)).constLast() == 8 * minuteMs
+              && hub.view(hubFeed).size() == 5,
+          QStringLiteral("seeding a feed should keep newer streamed candles within the ring capacity"));
+    hubNotified.sort();
+    check(hubNotified == QStringList{QStringLiteral("row-a"), QStringLiteral("row-a"),
+                                     QStringLiteral("row-b"), QStringLiteral("row-b")},
+          QStringLiteral("market data hub should notify every consumer of a feed on each write"));
+    check(hub.fetchLimit(hubFeed, minuteMs, 10 * minuteMs + 5) == 4,
+          QStringLiteral("a seeded feed should only request the candles it is missing"));
+    hub.update(hubFeed, hubCandle(8 * minuteMs, 8.5), true);
+    check(hub.latestClosed(hubFeed) && hub.view(hubFeed).constLast().close == 8.5,
+          QStringLiteral("stream ticks should update the forming candle and its closed flag"));
+    check(hub.ingest(hubFeed, {hubCandle(8 * minuteMs, 8.5), hubCandle(9 * minuteMs, 9.0)})
+              && !hub.latestClosed(hubFeed) && hub.view(hubFeed).constLast().openTimeMs == 9 * minuteMs,
+          QStringLiteral("an overlapping REST page should extend a seeded feed"));
+    hub.detach(QStringLiteral("row-b"));
+    check(hub.consumersOf(hubFeed) == QStringList{QStringLiteral("row-a")}
+              && hub.feedOf(QStringLiteral("row-a")) == hubFeed,
+          QStringLiteral("detached consumers should stop following their feed"));
+    check(!hub.ingest(hubFeed, {hubCandle(20 * minuteMs, 20.0)})
+              && !hub.isSeeded(hubFeed) && hub.view(hubFeed).isEmpty(),
+          QStringLiteral("a REST page that leaves a gap should reset the feed for reseeding"));
+
+    QTemporaryDir klineStoreDir;
+    check(klineStoreDir.isValid(), QStringLiteral("kline store temporary directory should be created"));
+    BinanceRestClient::setKlineStoreDirectory(klineStoreDir.path());
+    const auto sameCandles = [](const BinanceRestClient::KlinesResult &left,
+                                const BinanceRestClient::KlinesResult &right) {
+        if (!left.ok || !right.ok || left.candles.size() != right.candles.size()) return false;
+        for (qsizetype index = 0; index < left.candles.size(); ++index) {
+            const auto &a = left.candles.at(index);
+            const auto &b = right.candles.at(index);
+            if (a.openTimeMs != b.openTimeMs || a.open != b.open || a.high != b.high
+                || a.low != b.low || a.close != b.close || a.volume != b.volume) {
+                return false;
+            }
+        }
+        return true;
+    };
+    constexpr qint64 storeStart = 50'000 * minuteMs;
+    const auto fetchStored = [&](const QString &interval, qint64 start, qint64 end) {
+        return BinanceRestClient::fetchKlinesRange(
+            QStringLiteral("SOLUSDT"), interval, false, false, start, end, 5'000, 5'000, klineBaseUrl);
+    };
+
+    int requestsBeforeStore = observedKlineStarts.size();
+    const BinanceRestClient::KlinesResult storedFirst = fetchStored(
+        QStringLiteral("1m"), storeStart, storeStart + 1499 * minuteMs);
+    check(storedFirst.ok && storedFirst.candles.size() == 1500
+              && observedKlineStarts.size() - requestsBeforeStore == 2,
+          QStringLiteral("kline store should page an uncached range from the exchange"));
+    const QStringList storedMarkets = QDir(klineStoreDir.path()).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    check(storedMarkets.size() == 1 && storedMarkets.constFirst().startsWith(QStringLiteral("spot-"))
+              && QFile::exists(QDir(klineStoreDir.path())
+                                   .filePath(storedMarkets.constFirst() + QStringLiteral("/SOLUSDT/1m/index.json"))),
+          QStringLiteral("kline store should keep a gap index per market, symbol and interval"));
+
+    requestsBeforeStore = observedKlineStarts.size();
+    const BinanceRestClient::KlinesResult storedAgain = fetchStored(
+        QStringLiteral("1m"), storeStart, storeStart + 1499 * minuteMs);
+    check(observedKlineStarts.size() == requestsBeforeStore,
+          QStringLiteral("kline store should answer a covered range without contacting the exchange"));
+    check(sameCandles(storedFirst, storedAgain),
+          QStringLiteral("kline store should return the candles it fetched"));
+
+    requestsBeforeStore = observedKlineStarts.size();
+    const BinanceRestClient::KlinesResult storedExtended = fetchStored(
+        QStringLiteral("1m"), storeStart - 10 * minuteMs, storeStart + 1509 * minuteMs);
+    check(storedExtended.ok && storedExtended.candles.size() == 1520,
+          QStringLiteral("kline store should merge stored and newly fetched candles"));
+    check(observedKlineStarts.size() - requestsBeforeStore == 2
+              && observedKlineStarts.mid(requestsBeforeStore).contains(storeStart - 10 * minuteMs)
+              && observedKlineStarts.mid(requestsBeforeStore).contains(storeStart + 1499 * minuteMs + 1),
+          QStringLiteral("kline store should fetch only the missing ranges around a covered range"));
+
+    requestsBeforeStore = observedKlineStarts.size();
+    const BinanceRestClient::KlinesResult storedCustom = fetchStored(
+        QStringLiteral("7m"), storeStart, storeStart + 1400 * minuteMs);
+    check(storedCustom.ok && storedCustom.candles.size() == 200
+              && std::abs(storedCustom.candles.constFirst().volume - 7.0) < 1e-12,
+          QStringLiteral("kline store should aggregate custom intervals from stored base candles"));
+    check(observedKlineStarts.size() == requestsBeforeStore,
+          QStringLiteral("custom intervals inside the stored range should not contact the exchange"));
+
+    const QDir storedSeries(QDir(klineStoreDir.path()).filePath(storedMarkets.constFirst() + QStringLiteral("/SOLUSDT/1m")));
+    const QStringList storedSegments = storedSeries.entryList({QStringLiteral("segment-*.bin")}, QDir::Files);
+    for (const QString &segment : storedSegments) {
+        QFile::resize(storedSeries.filePath(segment), 16);
+    }
+    requestsBeforeStore = observedKlineStarts.size();
+    const BinanceRestClient::KlinesResult storedRepaired = fetchStored(
+        QStringLiteral("1m"), storeStart - 10 * minuteMs, storeStart + 1509 * minuteMs);
+    check(!storedSegments.isEmpty() && sameCandles(storedExtended, storedRepaired)
+              && observedKlineStarts.size() > requestsBeforeStore,
+          QStringLiteral("kline store should drop truncated segments and fetch their range again"));
+    requestsBeforeStore = observedKlineStarts.size();
+    const BinanceRestClient::KlinesResult storedAfterRepair = fetchStored(
+        QStringLiteral("1m"), storeStart - 10 * minuteMs, storeStart + 1509 * minuteMs);
+    check(sameCandles(storedExtended, storedAfterRepair) && observedKlineStarts.size() == requestsBeforeStore,
+          QStringLiteral("kline store should serve a refetched range from disk again"));
+    BinanceRestClient::setKlineStoreDirectory({});
+
+    // Many small appends merge into size-tiered segments: each candle is
+    // rewritten a few times, not once per compaction of the whole series.
+    {
+        NativeKlineStore::Series series(
+            klineStoreDir.path(),
+            NativeKlineStore::SeriesKey{QStringLiteral("futures"), QStringLiteral("TIERUSDT"), QStringLiteral("1m")});
+        constexpr int appendCount = 1000;
+        constexpr int pageCandles = 10;
+        const qint64 pageBytes = 48 + pageCandles * 6 * static_cast<qint64>(sizeof(qint64));
+        bool appended = series.isOpen();
+        for (int page = 0; appended && page < appendCount; ++page) {
+            QVector<NativeKlineStore::Candle> candles;
+            for (int index = 0; index < pageCandles; ++index) {
+                const qint64 openTimeMs = (page * pageCandles + index) * minuteMs;
+                candles.append({openTimeMs, 1.0, 2.0, 0.5, 1.5, double(page)});
+            }
+            appended = series.append(candles, {candles.constFirst().openTimeMs, candles.constLast().openTimeMs});
+        }
+        check(appended && series.segmentCount() <= 10,
+              QStringLiteral("small appends should leave O(log n) segments (%1)").arg(series.segmentCount()));
+        check(series.bytesWritten() < 8 * appendCount * pageBytes,
+              QStringLiteral("compaction should rewrite each candle O(log n) times (%1 bytes for %2 appended)")
+                  .arg(series.bytesWritten())
+                  .arg(appendCount * pageBytes));
+        const qint64 bytesBefore = series.bytesWritten();
+        QVector<NativeKlineStore::Candle> lastPage;
+        for (int index = 0; index < pageCandles; ++index) {
+            lastPage.append({(appendCount * pageCandles + index) * minuteMs, 1.0, 2.0, 0.5, 1.5, double(appendCount)});
+        }
+        series.append(lastPage, {lastPage.constFirst().openTimeMs, lastPage.constLast().openTimeMs});
+        check(series.bytesWritten() - bytesBefore < appendCount * pageBytes / 10,
+              QStringLiteral("a small append should leave the large compacted segments alone"));
+        const QVector<NativeKlineStore::Candle> stored =
+            series.read(0, (appendCount + 1) * pageCandles * minuteMs);
+        bool ordered = stored.size() == (appendCount + 1) * pageCandles;
+        for (qsizetype index = 0; ordered && index < stored.size(); ++index) {
+            ordered = stored.at(index).openTimeMs == index * minuteMs
+                && stored.at(index).volume == double(index / pageCandles);
+        }
+        check(ordered, QStringLiteral("tiered segments should read back every appended candle in order"));
+    }
+
+    // Holds every response until three page requests are open at once, so a
+    // serial pager only gets answers from the fallback timer.
+    QTcpServer windowServer;
+    check(windowServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local windowed kline HTTP test server should listen"));
+    QList<QPair<QTcpSocket *, QByteArray>> heldPages;
+    int maxHeldPages = 0;
+    const auto releaseHeldPages = [&]() {
+        for (const auto &held : std::as_const(heldPages)) {
+            writeJsonResponseAndClose(held.first, held.second);
+        }
+        heldPages.clear();
+    };
+    QTimer windowFallback;
+    windowFallback.setSingleShot(true);
+    QObject::connect(&windowFallback, &QTimer::timeout, releaseHeldPages);
+    QObject::connect(&windowServer, &QTcpServer::newConnection, [&]() {
+        QTcpSocket *socket = windowServer.nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, [&, socket]() {
+            const QByteArray requestBytes = socket->readAll();
+            const QList<QByteArray> requestLineParts = requestBytes.split('\n').value(0).trimmed().split(' ');
+            const QByteArray target = requestLineParts.size() >= 2 ? requestLineParts.at(1) : QByteArray("/");
+            const QUrlQuery query(QUrl(QStringLiteral("http://localhost") + QString::fromUtf8(target)));
+            const qint64 startTime = query.queryItemValue(QStringLiteral("startTime")).toLongLong();
+            const qint64 endTime = query.queryItemValue(QStringLiteral("endTime")).toLongLong();
+            QJsonArray candles;
+            for (qint64 openTime = (startTime + minuteMs - 1) / minuteMs * minuteMs; openTime <= endTime;
+                 openTime += minuteMs) {
+                candles.append(QJsonArray{openTime, QStringLiteral("1"), QStringLiteral("2"),
+                                          QStringLiteral("0.5"), QStringLiteral("1.5"), QStringLiteral("3")});
+            }
+            heldPages.append({socket, QJsonDocument(candles).toJson(QJsonDocument::Compact)});
+            maxHeldPages = std::max(maxHeldPages, static_cast<int>(heldPages.size()));
+            if (heldPages.size() >= 3) {
+                windowFallback.stop();
+                releaseHeldPages();
+            } else {
+                windowFallback.start(1'000);
+            }
+        });
+    });
+    const BinanceRestClient::KlinesResult windowedKlines = BinanceRestClient::fetchKlinesRange(
+        QStringLiteral("XRPUSDT"),
+        QStringLiteral("1m"),
+        false,
+        false,
+        pageStart,
+        pageStart + 2999 * minuteMs,
+        5'000,
+        5'000,
+        QStringLiteral("http://127.0.0.1:%1").arg(windowServer.serverPort()));
+    check(maxHeldPages >= 3,
+          QStringLiteral("native historical loader should keep several page requests in flight"));
+    bool windowedContiguous = windowedKlines.ok && windowedKlines.candles.size() == 3000;
+    for (qsizetype index = 0; windowedContiguous && index < windowedKlines.candles.size(); ++index) {
+        windowedContiguous = windowedKlines.candles.at(index).openTimeMs == pageStart + index * minuteMs;
+    }
+    check(windowedContiguous,
+          QStringLiteral("concurrent kline pages should be stitched back in open-time order"));
+
+    QTcpServer keepAliveServer;
+    check(keepAliveServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local keep-alive HTTP test server should listen"));
+    int keepAliveConnections = 0;
+    QObject::connect(&keepAliveServer, &QTcpServer::newConnection, [&]() {
+        QTcpSocket *socket = keepAliveServer.nextPendingConnection();
+        ++keepAliveConnections;
+        auto pending = std::make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::readyRead, [socket, pending]() {
+            *pending += socket->readAll();
+            for (qsizetype end = pending->indexOf("\r\n\r\n"); end >= 0; end = pending->indexOf("\r\n\r\n")) {
+                pending->remove(0, end + 4);
+                const QByteArray body = R"({"ok":true})";
+                socket->write(
+                    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: "
+                    + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+            }
+        });
+    });
+    const QUrl keepAliveUrl(QStringLiteral("http://127.0.0.1:%1/ping").arg(keepAliveServer.serverPort()));
+    const NativeHttpTransport::Stats statsBeforeReuse = NativeHttpTransport::stats();
+    bool pooledResponsesOk = true;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        NativeHttpTransport::Request request;
+        request.url = keepAliveUrl;
+        request.timeoutMs = 5'000;
+        const NativeHttpTransport::Response response = NativeHttpTransport::send(request);
+        pooledResponsesOk = pooledResponsesOk && response.statusCode == 200
+            && response.networkError == QNetworkReply::NoError && response.body == R"({"ok":true})";
+    }
+    const NativeHttpTransport::Stats statsAfterReuse = NativeHttpTransport::stats();
+    check(pooledResponsesOk, QStringLiteral("pooled transport blocking adapter should return response bodies"));
+    check(keepAliveConnections == 1,
+          QStringLiteral("pooled transport should keep one connection alive across sequential requests"));
+    check(statsAfterReuse.reusedConnections - statsBeforeReuse.reusedConnections == 2
+              && statsAfterReuse.connectionsOpened - statsBeforeReuse.connectionsOpened == 1,
+          QStringLiteral("pooled transport should count reused and newly opened connections"));
+    check(NativeHttpTransport::statsSnapshot().contains(QStringLiteral("reused_connections")),
+          QStringLiteral("pooled transport snapshot should expose connection reuse counters"));
+
+    int asyncResponses = 0;
+    QEventLoop asyncLoop;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        NativeHttpTransport::Request request;
+        request.url = keepAliveUrl;
+        request.timeoutMs = 5'000;
+        NativeHttpTransport::sendAsync(request, [&](const NativeHttpTransport::Response &response) {
+            if (response.statusCode == 200) ++asyncResponses;
+            if (asyncResponses == 2) asyncLoop.quit();
+        });
+    }
+    QTimer::singleShot(5'000, &asyncLoop, &QEventLoop::quit);
+    asyncLoop.exec();
+    check(asyncResponses == 2, QStringLiteral("pooled transport should complete concurrent async requests"));
+
+#if HAS_QT_WEBSOCKETS
+    const auto waitUntil = [](const std::function<bool()> &done, int timeoutMs) {
+        QEventLoop waitLoop;
+        QTimer poll;
+        QObject::connect(&poll, &QTimer::timeout, &waitLoop, [&]() {
+            if (done()) waitLoop.quit();
+        });
+        poll.start(10);
+        QTimer::singleShot(timeoutMs, &waitLoop, &QEventLoop::quit);
+        if (!done()) waitLoop.exec();
+        return done();
+    };
+    QWebSocketServer streamServer(QStringLiteral("combined-stream"), QWebSocketServer::NonSecureMode);
+    check(streamServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local combined-stream WebSocket server should listen"));
+    QList<QWebSocket *> streamSockets;
+    QStringList streamRequestUrls;
+    QList<QStringList> streamFrames;
+    QObject::connect(&streamServer, &QWebSocketServer::newConnection, [&]() {
+        QWebSocket *socket = streamServer.nextPendingConnection();
+        const qsizetype index = streamSockets.size();
+        streamSockets.append(socket);
+        streamRequestUrls.append(socket->requestUrl().toString());
+        streamFrames.append(QStringList{});
+        QObject::connect(socket, &QWebSocket::textMessageReceived, [&, index](const QString &message) {
+            streamFrames[index].append(message);
+        });
+    });
+    const QString klineStream = BinanceWsClient::klineStreamName(QStringLiteral(" BTCUSDT "), QStringLiteral("1m"));
+    const QString tickerStream = BinanceWsClient::bookTickerStreamName(QStringLiteral("ETHUSDT"));
+    const QString thirdStream = BinanceWsClient::klineStreamName(QStringLiteral("SOLUSDT"), QStringLiteral("5m"));
+    check(klineStream == QStringLiteral("btcusdt@kline_1m")
+              && BinanceWsClient::klineStreamName(QStringLiteral("BTCUSDT"), QStringLiteral("1M"))
+                  == QStringLiteral("btcusdt@kline_1M"),
+          QStringLiteral("combined-stream names should follow Binance's lower-case stream naming"));
+
+    BinanceWsClient multiplexer;
+    multiplexer.setCombinedStreamBaseUrlOverride(
+        QStringLiteral("ws://127.0.0.1:%1/stream").arg(streamServer.serverPort()));
+    multiplexer.setMaxStreamsPerConnection(2);
+    QStringList routedKlineKeys;
+    QStringList routedTickerKeys;
+    QObject::connect(&multiplexer, &BinanceWsClient::subscriptionKline,
+                     [&](const QString &key, const QString &, const QString &, qint64, double, double, double,
+                         double close, double, bool) {
+                         if (close == 101.5) routedKlineKeys.append(key);
+                     });
+    QObject::connect(&multiplexer, &BinanceWsClient::subscriptionBookTicker,
+                     [&](const QString &key, const QString &symbol, double bid, double ask) {
+                         if (symbol == QStringLiteral("ETHUSDT") && bid < ask) routedTickerKeys.append(key);
+                     });
+    const NativeSymbolTable::SymbolId routedEthId = NativeSymbolTable::intern(QStringLiteral("ETHUSDT"));
+    QStringList routedTickKeys;
+    QObject::connect(&multiplexer, &BinanceWsClient::subscriptionTick,
+                     [&](const QString &key, const BinanceWsClient::Tick &tick) {
+                         if ((tick.type == BinanceWsClient::Tick::Type::Kline && tick.close == 101.5)
+                             || (tick.type == BinanceWsClient::Tick::Type::BookTicker && tick.symbolId == routedEthId
+                                 && tick.bidPrice == 2000.1 && tick.askPrice == 2000.2)) {
+                             routedTickKeys.append(key);
+                         }
+                     });
+    multiplexer.subscribe(QStringLiteral("row-a"), klineStream, true, false);
+    multiplexer.subscribe(QStringLiteral("row-b"), klineStream, true, false);
+    multiplexer.subscribe(QStringLiteral("row-c"), tickerStream, true, false);
+    check(multiplexer.connectionCount() == 1,
+          QStringLiteral("multiplexer should share one socket until the stream limit is reached"));
+    check(waitUntil([&]() { return streamSockets.size() == 1 && !streamFrames.value(0).isEmpty(); }, 5'000),
+          QStringLiteral("multiplexer should open its first combined socket"));
+    multiplexer.subscribe(QStringLiteral("row-d"), thirdStream, true, false);
+    check(multiplexer.subscriberCount() == 4 && multiplexer.streamCount() == 3
+              && multiplexer.connectionCount() == 2,
+          QStringLiteral("multiplexer should share streams between keys and split only at the stream limit"));
+    check(waitUntil([&]() { return streamSockets.size() == 2; }, 5'000),
+          QStringLiteral("multiplexer should open one socket per full stream group"));
+    check(streamRequestUrls.value(0).endsWith(QStringLiteral("/stream?streams=") + klineStream),
+          QStringLiteral("first combined socket should open with its initial stream in the URL"));
+    const QJsonObject subscribeFrame = QJsonDocument::fromJson(streamFrames.value(0).value(0).toUtf8()).object();
+    check(subscribeFrame.value(QStringLiteral("method")).toString() == QStringLiteral("SUBSCRIBE")
+              && subscribeFrame.value(QStringLiteral("params")).toArray() == QJsonArray{tickerStream},
+          QStringLiteral("streams added to an open socket should be sent as a SUBSCRIBE frame"));
+
+    if (streamSockets.size() == 2) {
+        streamSockets.at(0)->sendTextMessage(QStringLiteral(
+            R"({"stream":"btcusdt@kline_1m","data":{"e":"kline","s":"BTCUSDT","k":{"t":1700000000000,"s":"BTCUSDT","i":"1m","o":"100","h":"102","l":"99","c":"101.5","v":"12","x":false}}})"));
+        streamSockets.at(0)->sendTextMessage(QStringLiteral(
+            R"({"stream":"ethusdt@bookTicker","data":{"s":"ETHUSDT","b":"2000.1","B":"3","a":"2000.2","A":"4"}})"));
+    }
+    waitUntil([&]() { return routedKlineKeys.size() == 2 && routedTickerKeys.size() == 1; }, 5'000);
+    routedKlineKeys.sort();
+    check(routedKlineKeys == QStringList{QStringLiteral("row-a"), QStringLiteral("row-b")},
+          QStringLiteral("combined kline frames should reach every key subscribed to the stream"));
+    check(routedTickerKeys == QStringList{QStringLiteral("row-c")},
+          QStringLiteral("combined bookTicker frames should reach only their own subscribers"));
+    routedTickKeys.sort();
+    check(routedTickKeys == QStringList{QStringLiteral("row-a"), QStringLiteral("row-b"), QStringLiteral("row-c")},
+          QStringLiteral("scanned frames should reach subscribers as ticks carrying the interned symbol id"));
+
+    multiplexer.unsubscribe(QStringLiteral("row-a"));
+    multiplexer.unsubscribe(QStringLiteral("row-c"));
+    check(multiplexer.streamCount() == 2,
+          QStringLiteral("a stream should stay subscribed while any key still uses it"));
+    check(waitUntil([&]() { return streamFrames.value(0).size() >= 2; }, 5'000),
+          QStringLiteral("dropping the last key of a stream should send an UNSUBSCRIBE frame"));
+    const QJsonObject unsubscribeFrame = QJsonDocument::fromJson(streamFrames.value(0).value(1).toUtf8()).object();
+    check(unsubscribeFrame.value(QStringLiteral("method")).toString() == QStringLiteral("UNSUBSCRIBE")
+              && unsubscribeFrame.value(QStringLiteral("params")).toArray() == QJsonArray{tickerStream},
+          QStringLiteral("UNSUBSCRIBE should name only the streams without subscribers"));
+    multiplexer.unsubscribe(QStringLiteral("row-d"));
+    check(multiplexer.connectionCount() == 1,
+          QStringLiteral("a socket without streams should be closed"));
+    multiplexer.unsubscribeAll();
+#endif
+
+    const QStringList streamFrameSeeds{
+        QStringLiteral(R"({"e":"kline","E":1700000000100,"s":"BTCUSDT","k":{"t":1700000000000,"T":1700000059999,"s":"BTCUSDT","i":"1m","f":100,"L":200,"o":"36500.10","c":"36510.55","h":"36520.00","l":"36490.01","v":"12.345","n":100,"x":true,"q":"450000.1","V":"6.1","Q":"222000.2","B":"0"}})"),
+        QStringLiteral(R"({"stream":"ethusdt@kline_5m","data":{"e":"kline","s":"ETHUSDT","k":{"t":1700000000000,"i":"5m","o":2000,"h":2010.5,"l":1990.25,"c":2005e0,"v":"0.001","x":false}}})"),
+        QStringLiteral(R"({"u":400900217,"s":"BNBUSDT","b":"25.35190000","B":"31.21000000","a":"25.36520000","A":"40.66000000"})"),
+        QStringLiteral(R"( {"stream" : "bnbusdt@bookTicker", "data" : {"e":"bookTicker","s":"BNBUSDT","b":25.3519,"a":"2.536520e1","T":[1,{"x":null}]}} )"),
+        QStringLiteral(R"({"result":null,"id":7})"),
+        QStringLiteral(R"({"error":{"code":2,"msg":"Invalid request: unknown variable"},"id":8})"),
+        QStringLiteral(R"({"stream":"btcusdt@kline_1m","data":{"s":"BTC\u0055SDT","k":{"t":-5,"i":"1m","o":"-0","h":"1E+2","l":"0.5","c":"1","v":"2","x":"true"}}})"),
+        QStringLiteral(R"({"stream":"btcusdt@markPrice@1s","data":{"e":"markPriceUpdate","E":1700000000123,"s":"BTCUSDT","p":"36505.10","i":"36500.0","r":"0.0001","T":1700028800000}})"),
+    };
+    using NativeStreamFrameScanner::ScannedFrame;
+    const ScannedFrame scannedKline = NativeStreamFrameScanner::scan(QStringView(streamFrameSeeds.at(0)));
+    check(scannedKline.type == ScannedFrame::Type::Kline && scannedKline.openTimeMs == 1700000000000
+              && scannedKline.open == 36500.10 && scannedKline.low == 36490.01 && scannedKline.isClosed
+              && streamFrameSeeds.at(0).mid(scannedKline.symbol.offset, scannedKline.symbol.length)
+                  == QStringLiteral("BTCUSDT"),
+          QStringLiteral("the frame scanner should read kline fields straight from the frame text"));
+    check(NativeStreamFrameScanner::scan(QStringView(streamFrameSeeds.at(3))).type == ScannedFrame::Type::BookTicker
+              && NativeStreamFrameScanner::scan(QStringView(streamFrameSeeds.at(4))).type
+                  == ScannedFrame::Type::Unrecognized,
+          QStringLiteral("the frame scanner should read bookTicker frames and leave replies to QJsonDocument"));
+    bool seedsMatchJson = true;
+    for (const QString &seed : streamFrameSeeds) {
+        seedsMatchJson = seedsMatchJson
+            && sameStreamFrame(BinanceWsClient::parseStreamFrame(seed), BinanceWsClient::parseStreamFrameJson(seed));
+    }
+    check(seedsMatchJson, QStringLiteral("scanned stream frames should decode exactly like QJsonDocument"));
+
+    // Seeded mutations around the structural characters, escapes and number
+    // forms the scanner has to get right.
+    const QString mutationAlphabet = QStringLiteral("{}[]:,\"\\/-+.eE0159 \tuxtrue\u00e9");
+    QRandomGenerator fuzz(20240611);
+    int fuzzMismatches = 0;
+    int fuzzScanMismatches = 0;
+    int fuzzRecognized = 0;
+    QString firstMismatch;
+    for (int iteration = 0; iteration < 20'000; ++iteration) {
+        QString frame = streamFrameSeeds.at(fuzz.bounded(int(streamFrameSeeds.size())));
+        const int mutations = 1 + fuzz.bounded(3);
+        for (int mutation = 0; mutation < mutations && !frame.isEmpty(); ++mutation) {
+            const int at = fuzz.bounded(int(frame.size()));
+            const QChar replacement = mutationAlphabet.at(fuzz.bounded(int(mutationAlphabet.size())));
+            switch (fuzz.bounded(5)) {
+            case 0: frame[at] = replacement; break;
+            case 1: frame.remove(at, 1); break;
+            case 2: frame.insert(at, replacement); break;
+            case 3: frame.truncate(at); break;
+            default: frame.insert(at, frame.mid(fuzz.bounded(int(frame.size())), 1 + fuzz.bounded(12))); break;
+            }
+        }
+        const ScannedFrame utf16 = NativeStreamFrameScanner::scan(QStringView(frame));
+        if (utf16.type != ScannedFrame::Type::Unrecognized) ++fuzzRecognized;
+        if (!sameStreamFrame(BinanceWsClient::parseStreamFrame(frame), BinanceWsClient::parseStreamFrameJson(frame))) {
+            if (fuzzMismatches++ == 0) firstMismatch = frame;
+        }
+        const QByteArray utf8 = frame.toUtf8();
+        if (utf8.size() == frame.size() && !sameScan(utf16, NativeStreamFrameScanner::scan(QByteArrayView(utf8)))) {
+            ++fuzzScanMismatches;
+        }
+    }
+    check(fuzzMismatches == 0,
+          QStringLiteral("mutated stream frames should decode exactly like QJsonDocument (%1 differ, first: %2)")
+              .arg(fuzzMismatches)
+              .arg(firstMismatch));
+    check(fuzzScanMismatches == 0,
+          QStringLiteral("the UTF-8 and UTF-16 frame scanners should agree on ASCII frames"));
+    check(fuzzRecognized > 1'000, QStringLiteral("frame fuzzing should keep exercising the scanner's fast path"));
+
+    const QList<QByteArray> klinePageSeeds{
+        QByteArrayLiteral(R"([[1499040000000,"0.01634790","0.80000000","0.01575800","0.01577100","148976.11427815",1499644799999,"2434.19055334",308,"1756.87402397","28.46694368","0"],[1499040060000,"0.01577100","0.01600000","0.01570000","0.01590000","12.5",1499040119999,"0.2",3,"1","0.01","0"]])"),
+        QByteArrayLiteral(" [ [1700000000000, 100, 101.5, 99.25, 1.005e2, \"0\", 1700000059999] ,\n[1700000060000,\"100.5\",\"1E+2\",\"-0\",\"100\",\"7\"] ] "),
+        QByteArrayLiteral(R"([[1700000000000,"1","2","0.5","1.5","3"],[],[1700000060000,"x","2","1","1","1"],{"t":1},[1700000120000,"1","2","1","1"]])"),
+        QByteArrayLiteral(R"([])"),
+        QByteArrayLiteral(R"({"code":-1121,"msg":"Invalid symbol."})"),
+    };
+    const BinanceRestClient::KlinesResult decodedSeed = NativeKlinePageDecoder::decode(klinePageSeeds.at(0));
+    check(decodedSeed.ok && decodedSeed.candles.size() == 2 && decodedSeed.candles.at(0).openTimeMs == 1499040000000
+              && decodedSeed.candles.at(0).volume == 148976.11427815 && decodedSeed.candles.at(1).close == 0.0159,
+          QStringLiteral("the kline page decoder should read exchange rows"));
+    QVector<BinanceRestClient::KlineCandle> decodedInPlace(1);
+    check(!NativeKlinePageDecoder::decodeFast(klinePageSeeds.at(2), decodedInPlace) && decodedInPlace.size() == 1,
+          QStringLiteral("pages the fast kline decoder leaves to QJsonDocument should not touch the buffer"));
+    const NativeKlinePageDecoder::Stats decodeStatsBefore = NativeKlinePageDecoder::stats();
+    bool klineSeedsMatchJson = true;
+    for (const QByteArray &seed : klinePageSeeds) {
+        klineSeedsMatchJson = klineSeedsMatchJson
+            && sameKlines(NativeKlinePageDecoder::decode(seed), NativeKlinePageDecoder::decodeJson(seed));
+    }
+    check(klineSeedsMatchJson, QStringLiteral("decoded kline pages should match QJsonDocument exactly"));
+    const NativeKlinePageDecoder::Stats decodeStatsAfter = NativeKlinePageDecoder::stats();
+    check(decodeStatsAfter.pages - decodeStatsBefore.pages == quint64(klinePageSeeds.size())
+              && decodeStatsAfter.fallbackPages - decodeStatsBefore.fallbackPages == 2
+              && decodeStatsAfter.candles - decodeStatsBefore.candles == 5
+              && decodeStatsAfter.maxPageDecodeNs > 0,
+          QStringLiteral("kline page decoding should count pages, fallbacks, candles and decode time"));
+
+    const QByteArray klineMutationAlphabet = QByteArrayLiteral("[]{},\"\\-+.eE0159 \ntnu\xc3\xa9");
+    int klineFuzzMismatches = 0;
+    int klineFuzzFast = 0;
+    QByteArray firstKlineMismatch;
+    for (int iteration = 0; iteration < 10'000; ++iteration) {
+        QByteArray page = klinePageSeeds.at(fuzz.bounded(int(klinePageSeeds.size())));
+        const int mutations = 1 + fuzz.bounded(3);
+        for (int mutation = 0; mutation < mutations && !page.isEmpty(); ++mutation) {
+            const int at = fuzz.bounded(int(page.size()));
+            const char replacement = klineMutationAlphabet.at(fuzz.bounded(int(klineMutationAlphabet.size())));
+            switch (fuzz.bounded(5)) {
+            case 0: page[at] = replacement; break;
+            case 1: page.remove(at, 1); break;
+            case 2: page.insert(at, replacement); break;
+            case 3: page.truncate(at); break;
+            default: page.insert(at, page.mid(fuzz.bounded(int(page.size())), 1 + fuzz.bounded(12))); break;
+            }
+        }
+        QVector<BinanceRestClient::KlineCandle> fastCandles;
+        if (NativeKlinePageDecoder::decodeFast(page, fastCandles)) ++klineFuzzFast;
+        if (!sameKlines(NativeKlinePageDecoder::decode(page), NativeKlinePageDecoder::decodeJson(page))) {
+            if (klineFuzzMismatches++ == 0) firstKlineMismatch = page;
+        }
+    }
+    check(klineFuzzMismatches == 0,
+          QStringLiteral("mutated kline pages should decode exactly like QJsonDocument (%1 differ, first: %2)")
+              .arg(klineFuzzMismatches)
+              .arg(QString::fromUtf8(firstKlineMismatch)));
+    check(klineFuzzFast > 500, QStringLiteral("kline page fuzzing should keep exercising the fast decoder"));
+
+    const auto exchangeInfoBody = [](const QString &btcStepSize) {
+        const auto symbolEntry = [](const QString &symbol,
+                                    const QString &quoteAsset,
+                                    const QString &status,
+                                    const QString &contractType,
+                                    const QString &stepSize) {
+            return QJsonObject{
+                {QStringLiteral("symbol"), symbol},
+                {QStringLiteral("quoteAsset"), quoteAsset},
+                {QStringLiteral("status"), status},
+                {QStringLiteral("contractType"), contractType},
+                {QStringLiteral("quantityPrecision"), 3},
+                {QStringLiteral("pricePrecision"), 1},
+                {QStringLiteral("filters"), QJsonArray{
+                    QJsonObject{{QStringLiteral("filterType"), QStringLiteral("PRICE_FILTER")},
+                                {QStringLiteral("tickSize"), QStringLiteral("0.10")}},
+                    QJsonObject{{QStringLiteral("filterType"), QStringLiteral("LOT_SIZE")},
+                                {QStringLiteral("stepSize"), stepSize},
+                                {QStringLiteral("minQty"), stepSize},
+                                {QStringLiteral("maxQty"), QStringLiteral("1000")}},
+                    QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MARKET_LOT_SIZE")},
+                                {QStringLiteral("stepSize"), stepSize},
+                                {QStringLiteral("minQty"), stepSize},
+                                {QStringLiteral("maxQty"), QStringLiteral("120")}},
+                    QJsonObject{{QStringLiteral("filterType"), QStringLiteral("MIN_NOTIONAL")},
+                                {QStringLiteral("notional"), QStringLiteral("100")}},
+                }},
+            };
+        };
+        const QJsonArray symbols{
+            symbolEntry(QStringLiteral("ETHUSDT"), QStringLiteral("USDT"), QStringLiteral("TRADING"),
+                        QStringLiteral("PERPETUAL"), QStringLiteral("0.001")),
+            symbolEntry(QStringLiteral("BTCUSDT"), QStringLiteral("USDT"), QStringLiteral("TRADING"),
+                        QStringLiteral("PERPETUAL"), btcStepSize),
+            symbolEntry(QStringLiteral("BTCUSDT_260925"), QStringLiteral("USDT"), QStringLiteral("TRADING"),
+                        QStringLiteral("CURRENT_QUARTER"), QStringLiteral("0.001")),
+            symbolEntry(QStringLiteral("ETHBTC"), QStringLiteral("BTC"), QStringLiteral("TRADING"),
+                        QStringLiteral("PERPETUAL"), QStringLiteral("0.001")),
+            symbolEntry(QStringLiteral("XRPUSDT"), QStringLiteral("USDT"), QStringLiteral("SETTLING"),
+                        QStringLiteral("PERPETUAL"), QStringLiteral("0.1")),
+        };
+        return QJsonDocument(QJsonObject{{QStringLiteral("symbols"), symbols}}).toJson(QJsonDocument::Compact);
+    };
+
+    const NativeExchangeInfo::ParseResult parsedExchangeInfo =
+        NativeExchangeInfo::parse(exchangeInfoBody(QStringLiteral("0.001")), true, 1'000);
+    check(parsedExchangeInfo.ok
+              && parsedExchangeInfo.snapshot->usdtSymbols()
+                     == QStringList{QStringLiteral("BTCUSDT"), QStringLiteral("ETHUSDT")},
+          QStringLiteral("exchangeInfo snapshot should list trading USDT perpetuals in order"));
+    const NativeExchangeInfo::SymbolInfo *parsedBtc =
+        parsedExchangeInfo.ok ? parsedExchangeInfo.snapshot->find(QStringLiteral(" btcusdt ")) : nullptr;
+    check(parsedBtc && parsedBtc->filters.ok && parsedBtc->filters.stepSize == 0.001
+              && parsedBtc->filters.maxQty == 120.0 && parsedBtc->filters.minNotional == 100.0
+              && parsedBtc->filters.tickSize == 0.1 && parsedBtc->filters.quantityPrecision == 3,
+          QStringLiteral("exchangeInfo snapshot should expose market lot, notional and price filters"));
+    const NativeSymbolTable::SymbolId btcId = NativeSymbolTable::intern(QStringLiteral("BTCUSDT"));
+    check(btcId != NativeSymbolTable::kInvalidSymbol
+              && NativeSymbolTable::find(QStringLiteral("btcusdt")) == btcId
+              && NativeSymbolTable::name(btcId) == QStringLiteral("BTCUSDT")
+              && parsedBtc && parsedBtc->id == btcId
+              && NativeSymbolTable::intern(QStringLiteral("ETHUSDT")) != btcId,
+          QStringLiteral("interned symbols should keep one id per canonical symbol"));
+    const NativeExchangeInfo::ParseResult rejectedExchangeInfo =
+        NativeExchangeInfo::parse(QByteArrayLiteral(R"({"code":-1121,"msg":"Invalid symbol."})"), true, 1'000);
+    check(!rejectedExchangeInfo.ok && rejectedExchangeInfo.error == QStringLiteral("Invalid symbol."),
+          QStringLiteral("exchangeInfo errors should surface the Binance message"));
+    check(NativeExchangeInfo::isFilterRejection(QStringLiteral("Binance order error: Filter failure: LOT_SIZE"))
+              && NativeExchangeInfo::isFilterRejection(QStringLiteral(R"({"code":-4164,"msg":"Order's notional must be no smaller than 100"})"))
+              && !NativeExchangeInfo::isFilterRejection(QStringLiteral("Binance order error: Margin is insufficient."))
+              && !NativeExchangeInfo::isFilterRejection(QStringLiteral("-4131 PERCENT_PRICE")),
+          QStringLiteral("only symbol filter rejections should invalidate exchangeInfo"));
+
+    // Serves exchangeInfo with the current BTCUSDT step size and rejects
+    // every order with a LOT_SIZE filter failure.
+    NativeExchangeInfo::clear();
+    const NativeExchangeInfo::Stats exchangeInfoStatsBefore = NativeExchangeInfo::stats();
+    QTcpServer exchangeInfoServer;
+    check(exchangeInfoServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local exchangeInfo HTTP test server should listen"));
+    int exchangeInfoRequests = 0;
+    QString servedBtcStepSize = QStringLiteral("0.001");
+    QObject::connect(&exchangeInfoServer, &QTcpServer::newConnection, [&]() {
+        QTcpSocket *socket = exchangeInfoServer.nextPendingConnection();
+        auto pending = std::make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::readyRead, [&, socket, pending]() {
+            *pending += socket->readAll();
+            if (!pending->contains("\r\n\r\n")) {
+                return;
+            }
+            if (pending->contains("/fapi/v1/exchangeInfo")) {
+                ++exchangeInfoRequests;
+                writeJsonResponseAndClose(socket, exchangeInfoBody(servedBtcStepSize));
+            } else {
+                writeJsonResponseAndClose(socket, QByteArrayLiteral(R"({"code":-1013,"msg":"Filter failure: LOT_SIZE"})"));
+            }
+            pending->clear();
+        });
+    });
+    const QString exchangeInfoBase = QStringLiteral("http://127.0.0.1:%1").arg(exchangeInfoServer.serverPort());
+    const BinanceRestClient::FuturesSymbolFilters cachedBtc =
+        BinanceRestClient::fetchFuturesSymbolFilters(QStringLiteral("BTCUSDT"), false, 5'000, exchangeInfoBase);
+    const BinanceRestClient::FuturesSymbolFilters cachedEth =
+        BinanceRestClient::fetchFuturesSymbolFilters(QStringLiteral("ethusdt"), false, 5'000, exchangeInfoBase);
+    const BinanceRestClient::SymbolsResult cachedSymbols =
+        BinanceRestClient::fetchUsdtSymbols(true, false, 5'000, false, 0, exchangeInfoBase);
+    check(cachedBtc.ok && cachedBtc.stepSize == 0.001 && cachedEth.ok && cachedSymbols.ok
+              && cachedSymbols.symbols == QStringList{QStringLiteral("BTCUSDT"), QStringLiteral("ETHUSDT")},
+          QStringLiteral("symbol filters and USDT symbols should come from the exchangeInfo cache"));
+    check(exchangeInfoRequests == 1,
+          QStringLiteral("exchangeInfo should be downloaded once for every filter and symbol lookup (%1 requests)")
+              .arg(exchangeInfoRequests));
+
+    servedBtcStepSize = QStringLiteral("0.01");
+    const BinanceRestClient::FuturesOrderResult filterRejectedOrder = BinanceRestClient::placeFuturesMarketOrder(
+        QStringLiteral("key"), QStringLiteral("secret"), QStringLiteral("BTCUSDT"), QStringLiteral("BUY"),
+        0.0015, false, false, {}, 5'000, exchangeInfoBase);
+    check(!filterRejectedOrder.ok && filterRejectedOrder.error.contains(QStringLiteral("LOT_SIZE")),
+          QStringLiteral("local order endpoint should reject with a filter failure"));
+    QEventLoop exchangeInfoRefreshLoop;
+    QTimer exchangeInfoRefreshPoll;
+    exchangeInfoRefreshPoll.setInterval(20);
+    double refreshedBtcStepSize = 0.0;
+    QObject::connect(&exchangeInfoRefreshPoll, &QTimer::timeout, [&]() {
+        refreshedBtcStepSize = BinanceRestClient::fetchFuturesSymbolFilters(
+                                   QStringLiteral("BTCUSDT"), false, 5'000, exchangeInfoBase)
+                                   .stepSize;
+        if (refreshedBtcStepSize == 0.01) {
+            exchangeInfoRefreshLoop.quit();
+        }
+    });
+    QTimer::singleShot(5'000, &exchangeInfoRefreshLoop, &QEventLoop::quit);
+    exchangeInfoRefreshPoll.start();
+    exchangeInfoRefreshLoop.exec();
+    exchangeInfoRefreshPoll.stop();
+    check(refreshedBtcStepSize == 0.01 && exchangeInfoRequests == 2,
+          QStringLiteral("a filter rejection should refresh exchangeInfo in the background once (%1 requests)")
+              .arg(exchangeInfoRequests));
+    const NativeExchangeInfo::Stats exchangeInfoStatsAfter = NativeExchangeInfo::stats();
+    check(exchangeInfoStatsAfter.fetches - exchangeInfoStatsBefore.fetches == 1
+              && exchangeInfoStatsAfter.backgroundRefreshes - exchangeInfoStatsBefore.backgroundRefreshes == 1
+              && exchangeInfoStatsAfter.hits > exchangeInfoStatsBefore.hits,
+          QStringLiteral("exchangeInfo cache should count one fetch, one refresh and the cached lookups"));
+    const BinanceRestClient::FuturesSymbolFilters unknownSymbol =
+        BinanceRestClient::fetchFuturesSymbolFilters(QStringLiteral("DOGEUSDT"), false, 5'000, exchangeInfoBase);
+    check(!unknownSymbol.ok && unknownSymbol.error.contains(QStringLiteral("not found")),
+          QStringLiteral("unknown symbols should still be reported as missing from exchangeInfo"));
+
+    // Answers the first ticker request with a 429 and Retry-After, later ones
+    // with a price and the exchange's used-weight count.
+    QTcpServer weightServer;
+    check(weightServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local request weight HTTP test server should listen"));
+    int weightRequests = 0;
+    QObject::connect(&weightServer, &QTcpServer::newConnection, [&]() {
+        QTcpSocket *socket = weightServer.nextPendingConnection();
+        auto pending = std::make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::readyRead, [&, socket, pending]() {
+            *pending += socket->readAll();
+            if (!pending->contains("\r\n\r\n")) {
+                return;
+            }
+            const QByteArray body = ++weightRequests == 1
+                ? QByteArrayLiteral(R"({"code":-1003,"msg":"Too many requests; please use the websocket for live updates."})")
+                : QByteArrayLiteral(R"({"symbol":"BTCUSDT","price":"100.5"})");
+            QByteArray response = weightRequests == 1
+                ? QByteArrayLiteral("HTTP/1.1 429 Too Many Requests\r\nRetry-After: 30\r\n")
+                : QByteArrayLiteral("HTTP/1.1 200 OK\r\nX-MBX-USED-WEIGHT-1M: 500\r\n");
+            response += "Content-Type: application/json\r\nConnection: close\r\nContent-Length: ";
+            response += QByteArray::number(body.size());
+            response += "\r\n\r\n";
+            response += body;
+            QObject::connect(socket, &QTcpSocket::bytesWritten, socket, [socket](qint64) {
+                if (socket->bytesToWrite() == 0 && socket->state() != QAbstractSocket::UnconnectedState) {
+                    socket->disconnectFromHost();
+                }
+            });
+            socket->write(response);
+            pending->clear();
+        });
+    });
+    const QString weightBase = QStringLiteral("http://127.0.0.1:%1").arg(weightServer.serverPort());
+    check(NativeRequestLimiter::marketKey(false, false, weightBase) != NativeRequestLimiter::marketKey(false, false)
+              && NativeRequestLimiter::marketKey(false, true, weightBase) == NativeRequestLimiter::marketKey(false, false, weightBase)
+              && &NativeRequestLimiter::Limiter::forUrl(QUrl(weightBase + QStringLiteral("/api/v3/ticker/price")))
+                  == &NativeRequestLimiter::Limiter::forMarket(false, false, weightBase)
+              && &NativeRequestLimiter::Limiter::forUrl(QUrl(QStringLiteral("https://fapi.binance.com/fapi/v1/klines")))
+                  == &NativeRequestLimiter::Limiter::forMarket(true, false, QStringLiteral("https://fapi.binance.com")),
+          QStringLiteral("a custom host should get its own request-weight bucket, keyed like the kline store"));
+    NativeRequestLimiter::Limiter::forMarket(false, false, weightBase).reset(QDateTime::currentMSecsSinceEpoch());
+    const BinanceRestClient::TickerPriceResult throttledTicker =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), false, false, 5'000, weightBase);
+    const BinanceRestClient::TickerPriceResult bannedTicker =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), false, false, 5'000, weightBase);
+    check(!throttledTicker.ok && !bannedTicker.ok && weightRequests == 1
+              && bannedTicker.error.contains(QStringLiteral("ban active")),
+          QStringLiteral("a 429 should hold back further requests instead of sending them (%1 requests, %2)")
+              .arg(weightRequests)
+              .arg(bannedTicker.error));
+    const QJsonObject bannedWeight = NativeRequestLimiter::snapshot(false, false, weightBase);
+    check(bannedWeight.value(QStringLiteral("seconds_until_unban")).toDouble() > 25.0
+              && bannedWeight.value(QStringLiteral("bans")).toInt() == 1
+              && bannedWeight.value(QStringLiteral("rejected")).toInt() >= 1,
+          QStringLiteral("request weight snapshot should report the Retry-After ban"));
+    check(NativeRequestLimiter::snapshot(false, false).value(QStringLiteral("seconds_until_unban")).toDouble() == 0.0,
+          QStringLiteral("a custom host's ban should not hold back the Binance market"));
+
+    NativeRequestLimiter::Limiter::forMarket(false, false, weightBase).reset(QDateTime::currentMSecsSinceEpoch());
+    const BinanceRestClient::TickerPriceResult pricedTicker =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), false, false, 5'000, weightBase);
+    const QJsonObject usedWeight = NativeRequestLimiter::snapshot(false, false, weightBase);
+    check(pricedTicker.ok && weightRequests == 2 && usedWeight.value(QStringLiteral("used_weight_1m")).toInt() == 500
+              && usedWeight.value(QStringLiteral("available")).toDouble()
+                  <= usedWeight.value(QStringLiteral("max_per_minute")).toDouble() - 500.0 + 1.0,
+          QStringLiteral("the exchange's used weight should lower the shared bucket"));
+    NativeRequestLimiter::Limiter::forMarket(false, false, weightBase).reset(QDateTime::currentMSecsSinceEpoch());
+
+    BinanceRestClient::FuturesPositionsResult restPositions;
+    restPositions.ok = true;
+    BinanceRestClient::FuturesPosition restBtc;
+    restBtc.symbol = QStringLiteral("BTCUSDT");
+    restBtc.positionSide = QStringLiteral("BOTH");
+    restBtc.positionAmt = 0.01;
+    restBtc.entryPrice = 60'000.0;
+    restBtc.markPrice = 61'000.0;
+    restBtc.unrealizedProfit = 10.0;
+    restBtc.leverage = 10.0;
+    restBtc.notional = 610.0;
+    restBtc.positionInitialMargin = 61.0;
+    restPositions.positions.append(restBtc);
+    BinanceRestClient::BalanceResult restBalance;
+    restBalance.ok = true;
+    restBalance.totalUsdtBalance = 1'000.0;
+    restBalance.usdtBalance = 1'000.0;
+    restBalance.availableUsdtBalance = 900.0;
+
+    NativeUserDataStream::AccountState accountState;
+    const QByteArray openEth = QByteArrayLiteral(
+        R"({"e":"ACCOUNT_UPDATE","E":2000,"T":2000,"a":{"m":"ORDER","B":[{"a":"USDT","wb":"995","cw":"995","bc":"0"}],"P":[{"s":"ETHUSDT","pa":"1","ep":"3000","bep":"3000","cr":"0","up":"-5","mt":"cross","iw":"0","ps":"BOTH"}]}})");
+    check(accountState.apply(openEth) == NativeUserDataStream::EventType::AccountUpdate
+              && !accountState.positions().ok && accountState.stats().accountUpdates == 0,
+          QStringLiteral("account events should not be applied before the first resync"));
+    BinanceRestClient::FuturesOpenOrdersResult restOpenOrders;
+    restOpenOrders.ok = true;
+    accountState.resync(restPositions, restBalance, restOpenOrders, 1'000);
+    check(accountState.isSynced() && accountState.positions().positions.size() == 1
+              && std::abs(accountState.balance().availableUsdtBalance - 900.0) < 1e-9,
+          QStringLiteral("a resync should seed positions and balance from the REST snapshot"));
+    accountState.apply(QByteArrayLiteral(R"({"e":"markPriceUpdate","E":1500,"s":"BTCUSDT","p":"62000"})"));
+    const BinanceRestClient::FuturesPosition markedBtc = accountState.positions().positions.value(0);
+    check(markedBtc.markPrice == 62'000.0 && std::abs(markedBtc.unrealizedProfit - 20.0) < 1e-9
+              && std::abs(markedBtc.positionInitialMargin - 62.0) < 1e-9
+              && std::abs(accountState.balance().availableUsdtBalance - 909.0) < 1e-9,
+          QStringLiteral("mark price updates should revalue positions and the available balance"));
+
+    check(accountState.apply(openEth) == NativeUserDataStream::EventType::AccountUpdate
+              && accountState.positionSymbols() == QStringList({QStringLiteral("BTCUSDT"), QStringLiteral("ETHUSDT")})
+              && accountState.balance().totalUsdtBalance == 995.0
+              && std::abs(accountState.balance().availableUsdtBalance - 899.0) < 1e-9,
+          QStringLiteral("ACCOUNT_UPDATE should open positions and move the wallet balance"));
+    accountState.apply(QByteArrayLiteral(R"({"e":"ACCOUNT_CONFIG_UPDATE","E":2100,"T":2100,"ac":{"s":"ETHUSDT","l":5}})"));
+    check(std::abs(accountState.balance().availableUsdtBalance - 300.0) < 1e-9,
+          QStringLiteral("a leverage update should price the margin of positions opened since the resync"));
+    accountState.apply(QByteArrayLiteral(
+        R"({"e":"ACCOUNT_UPDATE","E":1500,"T":1500,"a":{"m":"ORDER","B":[],"P":[{"s":"ETHUSDT","pa":"0","ep":"0","up":"0","mt":"cross","iw":"0","ps":"BOTH"}]}})"));
+    check(accountState.positionSymbols().contains(QStringLiteral("ETHUSDT")) && accountState.stats().staleEvents == 1,
+          QStringLiteral("account updates older than the last applied one should be ignored"));
+
+    accountState.apply(QByteArrayLiteral(
+        R"({"e":"ORDER_TRADE_UPDATE","E":2200,"T":2200,"o":{"s":"BTCUSDT","c":"bot-1","S":"BUY","o":"LIMIT","f":"GTC","q":"0.01","p":"50000","ap":"0","x":"NEW","X":"NEW","i":4001,"l":"0","z":"0","T":2200,"R":false,"ps":"BOTH"}})"));
+    check(accountState.openOrders().size() == 1 && accountState.openOrders().constFirst().orderId == QStringLiteral("4001")
+              && std::abs(accountState.balance().availableUsdtBalance - 250.0) < 1e-9,
+          QStringLiteral("a new limit order should be tracked and reserve its margin"));
+    accountState.apply(QByteArrayLiteral(
+        R"({"e":"ORDER_TRADE_UPDATE","E":2300,"T":2300,"o":{"s":"BTCUSDT","c":"bot-1","S":"BUY","o":"LIMIT","f":"GTC","q":"0.01","p":"50000","ap":"50000","x":"TRADE","X":"FILLED","i":4001,"l":"0.01","z":"0.01","T":2300,"R":false,"ps":"BOTH"}})"));
+    check(accountState.openOrders().isEmpty() && accountState.stats().orderUpdates == 2,
+          QStringLiteral("a filled order should leave the open orders"));
+    accountState.apply(QByteArrayLiteral(
+        R"({"stream":"ethusdt@markPrice@1s","data":{"e":"markPriceUpdate","E":2400,"s":"ETHUSDT","p":"3100"}})"));
+    accountState.apply(QByteArrayLiteral(
+        R"({"e":"ACCOUNT_UPDATE","E":3000,"T":3000,"a":{"m":"ORDER","B":[],"P":[{"s":"BTCUSDT","pa":"0","ep":"0","up":"0","mt":"cross","iw":"0","ps":"BOTH"}]}})"));
+    const BinanceRestClient::FuturesPositionsResult streamedPositions = accountState.positions();
+    check(streamedPositions.ok && streamedPositions.positions.size() == 1
+              && streamedPositions.positions.constFirst().symbol == QStringLiteral("ETHUSDT")
+              && std::abs(streamedPositions.positions.constFirst().unrealizedProfit - 100.0) < 1e-9
+              && accountState.lastEventTimeMs() == 3000,
+          QStringLiteral("closed positions should drop out and combined-stream mark prices should apply"));
+    accountState.invalidate();
+    check(!accountState.positions().ok && !accountState.balance().ok,
+          QStringLiteral("an invalidated account state should not be read as current"));
+
+    BinanceRestClient::FuturesOpenOrder restingBtc;
+    restingBtc.symbol = QStringLiteral("BTCUSDT");
+    restingBtc.orderId = QStringLiteral("5001");
+    restingBtc.side = QStringLiteral("BUY");
+    restingBtc.type = QStringLiteral("LIMIT");
+    restingBtc.status = QStringLiteral("NEW");
+    restingBtc.price = 50'000.0;
+    restingBtc.origQty = 0.01;
+    restingBtc.updateTimeMs = 900;
+    restOpenOrders.orders = {restingBtc};
+    NativeUserDataStream::AccountState seededOrdersState;
+    seededOrdersState.resync(restPositions, restBalance, restOpenOrders, 1'000);
+    check(seededOrdersState.openOrders().size() == 1
+              && std::abs(seededOrdersState.balance().availableUsdtBalance - 900.0) < 1e-9,
+          QStringLiteral("a resync should seed open orders without counting their margin twice"));
+    seededOrdersState.apply(QByteArrayLiteral(
+        R"({"e":"ORDER_TRADE_UPDATE","E":1500,"T":1500,"o":{"s":"BTCUSDT","c":"bot-2","S":"BUY","o":"LIMIT","f":"GTC","q":"0.01","p":"50000","ap":"0","x":"CANCELED","X":"CANCELED","i":5001,"l":"0","z":"0","T":1500,"R":false,"ps":"BOTH"}})"));
+    check(seededOrdersState.openOrders().isEmpty()
+              && std::abs(seededOrdersState.balance().availableUsdtBalance - 950.0) < 1e-9,
+          QStringLiteral("cancelling an order seeded by the resync should release its margin"));
+    restOpenOrders.ok = false;
+    seededOrdersState.resync(restPositions, restBalance, restOpenOrders, 2'000);
+    check(!seededOrdersState.isSynced(),
+          QStringLiteral("a resync without the open orders should leave the state unsynced"));
+
+    const BinanceWsClient::StreamFrame markFrame = BinanceWsClient::parseStreamFrame(streamFrameSeeds.constLast());
+    check(BinanceWsClient::markPriceStreamName(QStringLiteral(" BTCUSDT ")) == QStringLiteral("btcusdt@markPrice@1s")
+              && markFrame.type == BinanceWsClient::StreamFrame::Type::MarkPrice
+              && markFrame.stream == QStringLiteral("btcusdt@markPrice@1s") && markFrame.symbol == QStringLiteral("BTCUSDT")
+              && markFrame.markPrice == 36505.10 && markFrame.eventTimeMs == 1700000000123,
+          QStringLiteral("markPrice frames should decode to the symbol's mark price and event time"));
+
+    NativePriceStream::PriceTable priceTable;
+    const NativeSymbolTable::SymbolId solId = NativeSymbolTable::intern(QStringLiteral("SOLUSDT"));
+    priceTable.updateBook(solId, 99.5, 100.5, 10'000);
+    check(priceTable.markPrice(solId, 10'000) == 100.0 && priceTable.executionPrice(solId, true, 10'000) == 100.5
+              && priceTable.executionPrice(solId, false, 10'000) == 99.5,
+          QStringLiteral("without a mark price the book mid should stand in and orders should price off the book"));
+    priceTable.updateMark(solId, 100.2, 12'000);
+    priceTable.updateBook(solId, 0.0, 100.4, 12'000);
+    const NativePriceStream::Quote solQuote = priceTable.quote(solId);
+    check(solQuote.markPrice == 100.2 && solQuote.bidPrice == 99.5 && solQuote.markUpdatedMs == 12'000
+              && solQuote.bookUpdatedMs == 10'000,
+          QStringLiteral("a book update with a missing side should be dropped"));
+    check(priceTable.markPrice(solId, 16'000) == 100.2 && priceTable.executionPrice(solId, true, 16'000) == 100.2
+              && priceTable.markPrice(solId, 18'000) == 0.0 && priceTable.executionPrice(solId, false, 18'000) == 0.0,
+          QStringLiteral("stale book and mark prices should fall back in turn and then read as missing"));
+    priceTable.clear(solId);
+    check(priceTable.quote(solId).markUpdatedMs == 0 && priceTable.markPrice(solId, 12'000) == 0.0
+              && priceTable.quote(NativeSymbolTable::kInvalidSymbol).markPrice == 0.0,
+          QStringLiteral("cleared and unknown symbols should have no price"));
+
+    // One writer keeps bid = ask - 1; a reader must never see halves of two
+    // different updates.
+    std::atomic<bool> writerDone{false};
+    std::thread priceWriter([&]() {
+        for (int update = 1; update <= 200'000; ++update) {
+            priceTable.updateBook(solId, update, update + 1.0, update);
+        }
+        writerDone.store(true);
+    });
+    int tornQuotes = 0;
+    while (!writerDone.load()) {
+        const NativePriceStream::Quote seen = priceTable.quote(solId);
+        if (seen.bookUpdatedMs != 0
+            && (seen.askPrice != seen.bidPrice + 1.0 || seen.bidPrice != double(seen.bookUpdatedMs))) {
+            ++tornQuotes;
+        }
+    }
+    priceWriter.join();
+    check(tornQuotes == 0 && priceTable.quote(solId).askPrice == 200'001.0,
+          QStringLiteral("concurrent readers should only see whole quotes (%1 torn)").arg(tornQuotes));
+
+    NativePriceStream::StopLossRule stopLoss;
+    stopLoss.limits.usdt = 20.0;
+    stopLoss.limits.percent = 10.0;
+    check(!NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 50.0, 90.0),
+          QStringLiteral("a disabled stop-loss should never trigger"));
+    stopLoss.enabled = true;
+    check(NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 0.0, 98.0)
+              && !NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 0.0, 98.5)
+              && NativePriceStream::stopLossTriggered(stopLoss, false, 100.0, 10.0, 0.0, 102.0)
+              && !NativePriceStream::stopLossTriggered(stopLoss, false, 100.0, 10.0, 0.0, 90.0),
+          QStringLiteral("a USDT stop-loss should trigger on the side-adjusted loss only"));
+    stopLoss.limits.mode = NativeStopLoss::parseMode(QStringLiteral(" Percent "));
+    check(NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 50.0, 99.5)
+              && !NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 50.0, 99.6),
+          QStringLiteral("a per-trade percent stop-loss should measure the loss against the margin"));
+    stopLoss.limits.scope = NativeStopLoss::parseScope(QStringLiteral("cumulative"));
+    check(!NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 50.0, 95.0)
+              && NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 50.0, 90.0),
+          QStringLiteral("other scopes should measure the percent against the entry notional"));
+    stopLoss.limits.mode = NativeStopLoss::Mode::Both;
+    stopLoss.limits.percent = 50.0;
+    check(NativePriceStream::stopLossTriggered(stopLoss, true, 100.0, 10.0, 50.0, 97.5),
+          QStringLiteral("a stop-loss in both modes should trigger on whichever limit is reached first"));
+    NativePriceStream::StopLossWatch scopedWatch;
+    scopedWatch.setRule(stopLoss);
+    check(!scopedWatch.enforced()
+              && !scopedWatch.flag(QStringLiteral("SOLUSDT|1m|L"), {true, 100.0, 10.0, 50.0}, 50.0)
+              && !scopedWatch.closing(QStringLiteral("SOLUSDT|1m|L")),
+          QStringLiteral("the live stop-loss should not close positions for a cumulative scope"));
+    stopLoss.limits.scope = NativeStopLoss::Scope::PerTrade;
+    scopedWatch.setRule(stopLoss);
+    check(scopedWatch.enforced()
+              && scopedWatch.flag(QStringLiteral("SOLUSDT|1m|L"), {true, 100.0, 10.0, 50.0}, 97.5)
+              && !scopedWatch.flag(QStringLiteral("SOLUSDT|1m|L"), {true, 100.0, 10.0, 50.0}, 90.0),
+          QStringLiteral("the live per_trade stop-loss should flag a position for closing once"));
+
+#if HAS_QT_WEBSOCKETS
+    // listenKey, positionRisk, account and balance endpoints of one account.
+    QTcpServer accountRestServer;
+    check(accountRestServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local user-data REST server should listen"));
+    int listenKeyCreates = 0;
+    int listenKeyCloses = 0;
+    int positionSnapshots = 0;
+    QObject::connect(&accountRestServer, &QTcpServer::newConnection, [&]() {
+        QTcpSocket *socket = accountRestServer.nextPendingConnection();
+        auto pending = std::make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::readyRead, [&, socket, pending]() {
+            *pending += socket->readAll();
+            if (!pending->contains("\r\n\r\n")) {
+                return;
+            }
+            QByteArray body = QByteArrayLiteral("{}");
+            if (pending->startsWith("POST /fapi/v1/listenKey")) {
+                ++listenKeyCreates;
+                body = QByteArrayLiteral(R"({"listenKey":"test-listen-key"})");
+            } else if (pending->startsWith("DELETE /fapi/v1/listenKey")) {
+                ++listenKeyCloses;
+            } else if (pending->contains("/fapi/v2/positionRisk")) {
+                ++positionSnapshots;
+                body = QByteArrayLiteral(
+                    R"([{"symbol":"BTCUSDT","positionSide":"BOTH","positionAmt":"0.01","entryPrice":"60000","markPrice":"61000","unRealizedProfit":"10","leverage":"10","notional":"610","positionInitialMargin":"61","isolatedWallet":"0"}])");
+            } else if (pending->contains("/fapi/v2/account")) {
+                body = QByteArrayLiteral(R"({"positions":[]})");
+            } else if (pending->contains("/fapi/v1/balance")) {
+                body = QByteArrayLiteral(R"([{"asset":"USDT","balance":"1000","availableBalance":"900"}])");
+            }
+            writeJsonResponseAndClose(socket, body);
+            pending->clear();
+        });
+    });
+    QWebSocketServer userDataServer(QStringLiteral("user-data"), QWebSocketServer::NonSecureMode);
+    check(userDataServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local user-data WebSocket server should listen"));
+    QList<QWebSocket *> userDataSockets;
+    QStringList userDataPaths;
+    QStringList userDataFrames;
+    QObject::connect(&userDataServer, &QWebSocketServer::newConnection, [&]() {
+        QWebSocket *socket = userDataServer.nextPendingConnection();
+        userDataSockets.append(socket);
+        userDataPaths.append(socket->requestUrl().path());
+        QObject::connect(socket, &QWebSocket::textMessageReceived, [&](const QString &message) {
+            userDataFrames.append(message);
+        });
+    });
+
+    NativeUserDataStream::Client userDataClient;
+    userDataClient.setStreamBaseUrlOverride(QStringLiteral("ws://127.0.0.1:%1/ws").arg(userDataServer.serverPort()));
+    userDataClient.setReconnectBaseMs(20);
+    int syncedSignals = 0;
+    QObject::connect(&userDataClient, &NativeUserDataStream::Client::synced, [&]() { ++syncedSignals; });
+    userDataClient.start(
+        QStringLiteral("key"),
+        QStringLiteral("secret"),
+        false,
+        QStringLiteral("http://127.0.0.1:%1").arg(accountRestServer.serverPort()));
+    check(waitUntil([&]() { return userDataClient.isSynced(); }, 5'000)
+              && listenKeyCreates == 1 && positionSnapshots == 1
+              && userDataPaths.value(0) == QStringLiteral("/ws/test-listen-key"),
+          QStringLiteral("the user-data client should open the listenKey stream and resync over REST"));
+    check(waitUntil([&]() { return !userDataFrames.isEmpty(); }, 5'000)
+              && QJsonDocument::fromJson(userDataFrames.value(0).toUtf8()).object().value(QStringLiteral("params")).toArray()
+                  == QJsonArray{QStringLiteral("btcusdt@markPrice@1s")},
+          QStringLiteral("the user-data client should follow the mark price of open positions"));
+    if (!userDataSockets.isEmpty()) {
+        userDataSockets.constLast()->sendTextMessage(QString::fromUtf8(openEth));
+    }
+    check(waitUntil([&]() { return userDataClient.state().positionSymbols().size() == 2; }, 5'000)
+              && positionSnapshots == 1,
+          QStringLiteral("stream events should update positions without another REST call"));
+
+    if (!userDataSockets.isEmpty()) {
+        userDataSockets.constLast()->close();
+    }
+    check(waitUntil([&]() { return syncedSignals == 2 && userDataClient.isSynced(); }, 5'000)
+              && positionSnapshots == 2 && listenKeyCreates == 1 && userDataSockets.size() == 2,
+          QStringLiteral("a dropped stream should reconnect with the same listenKey and resync once"));
+    userDataClient.stop();
+    check(waitUntil([&]() { return listenKeyCloses == 1; }, 5'000) && !userDataClient.isSynced(),
+          QStringLiteral("stopping the user-data client should close its listenKey"));
+
+    QWebSocketServer priceServer(QStringLiteral("price-stream"), QWebSocketServer::NonSecureMode);
+    check(priceServer.listen(QHostAddress::LocalHost, 0),
+          QStringLiteral("local price-stream WebSocket server should listen"));
+    QList<QWebSocket *> priceSockets;
+    QStringList priceStreams;
+    QObject::connect(&priceServer, &QWebSocketServer::newConnection, [&]() {
+        QWebSocket *socket = priceServer.nextPendingConnection();
+        priceSockets.append(socket);
+        priceStreams += QUrlQuery(socket->requestUrl()).queryItemValue(QStringLiteral("streams"))
+                            .split(QLatin1Char('/'), Qt::SkipEmptyParts);
+        QObject::connect(socket, &QWebSocket::textMessageReceived, [&](const QString &message) {
+            const QJsonObject frame = QJsonDocument::fromJson(message.toUtf8()).object();
+            if (frame.value(QStringLiteral("method")).toString() == QStringLiteral("SUBSCRIBE")) {
+                for (const QJsonValue &stream : frame.value(QStringLiteral("params")).toArray()) {
+                    priceStreams.append(stream.toString());
+                }
+            }
+        });
+    });
+    NativePriceStream::Service priceStream;
+    priceStream.setCombinedStreamBaseUrlOverride(QStringLiteral("ws://127.0.0.1:%1/stream").arg(priceServer.serverPort()));
+    QList<NativeSymbolTable::SymbolId> pricedSymbols;
+    QObject::connect(&priceStream, &NativePriceStream::Service::priceUpdated,
+                     [&](NativeSymbolTable::SymbolId symbolId) { pricedSymbols.append(symbolId); });
+    QList<NativeSymbolTable::SymbolId> markedSymbols;
+    QObject::connect(&priceStream, &NativePriceStream::Service::markUpdated,
+                     [&](NativeSymbolTable::SymbolId symbolId) { markedSymbols.append(symbolId); });
+    // The dashboard runtime's mark-price stop-loss: two of the three BTC
+    // positions are past a 10 USDT loss at the streamed mark of 36505.10.
+    NativePriceStream::StopLossRule watchRule;
+    watchRule.enabled = true;
+    watchRule.limits.usdt = 10.0;
+    NativePriceStream::StopLossWatch stopLossWatch;
+    stopLossWatch.setRule(watchRule);
+    QHash<QString, NativePriceStream::StopLossWatch::Position> watchedPositions{
+        {QStringLiteral("BTCUSDT|1m|L"), {true, 36'600.0, 1.0, 0.0}},
+        {QStringLiteral("BTCUSDT|5m|L"), {true, 36'510.0, 1.0, 0.0}},
+        {QStringLiteral("BTCUSDT|15m|S"), {false, 36'400.0, 1.0, 0.0}},
+    };
+    for (auto it = watchedPositions.cbegin(); it != watchedPositions.cend(); ++it) {
+        stopLossWatch.watch(btcId, it.key());
+    }
+    QStringList flaggedCloses;
+    QObject::connect(&priceStream, &NativePriceStream::Service::markUpdated, [&](NativeSymbolTable::SymbolId symbolId) {
+        flaggedCloses += stopLossWatch.flagMark(
+            symbolId,
+            priceStream.table().markPrice(symbolId, QDateTime::currentMSecsSinceEpoch()),
+            [&](const QString &key, NativePriceStream::StopLossWatch::Position *position) {
+                const auto it = watchedPositions.constFind(key);
+                if (it == watchedPositions.cend()) {
+                    return false;
+                }
+                *position = it.value();
+                return true;
+            });
+    });
+    priceStream.setMarket(true, false);
+    priceStream.setSymbols({QStringLiteral("btcusdt"), QStringLiteral("BTCUSDT ")});
+    check(priceStream.symbols() == QStringList{QStringLiteral("BTCUSDT")}
+              && waitUntil([&]() {
+                     return priceStreams.contains(QStringLiteral("btcusdt@markPrice@1s"))
+                         && priceStreams.contains(QStringLiteral("btcusdt@bookTicker"));
+                 }, 5'000)
+              && priceStreams.size() == 2,
+          QStringLiteral("the price stream should follow each symbol's mark price and book ticker once"));
+    if (!priceSockets.isEmpty()) {
+        priceSockets.constFirst()->sendTextMessage(streamFrameSeeds.constLast());
+        priceSockets.constFirst()->sendTextMessage(QStringLiteral(
+            R"({"stream":"btcusdt@bookTicker","data":{"e":"bookTicker","s":"BTCUSDT","b":"36504.9","B":"1","a":"36505.3","A":"2"}})"));
+    }
+    check(waitUntil([&]() { return pricedSymbols.size() == 2; }, 5'000) && pricedSymbols.constFirst() == btcId
+              && priceStream.table().quote(btcId).markPrice == 36505.10
+              && priceStream.table().executionPrice(btcId, true, QDateTime::currentMSecsSinceEpoch()) == 36505.3,
+          QStringLiteral("streamed mark and book prices should land in the symbol's table slot"));
+    check(markedSymbols == QList<NativeSymbolTable::SymbolId>{btcId},
+          QStringLiteral("only mark price updates should signal markUpdated"));
+    flaggedCloses.sort();
+    check(flaggedCloses == QStringList{QStringLiteral("BTCUSDT|15m|S"), QStringLiteral("BTCUSDT|1m|L")}
+              && stopLossWatch.closing(QStringLiteral("BTCUSDT|1m|L"))
+              && !stopLossWatch.closing(QStringLiteral("BTCUSDT|5m|L")),
+          QStringLiteral("a mark update should flag each position past its stop-loss for closing (%1)")
+              .arg(flaggedCloses.join(QLatin1Char(','))));
+    if (!priceSockets.isEmpty()) {
+        priceSockets.constFirst()->sendTextMessage(streamFrameSeeds.constLast());
+    }
+    check(waitUntil([&]() { return markedSymbols.size() == 2; }, 5'000) && flaggedCloses.size() == 2,
+          QStringLiteral("a mark tick while the closes are in flight should not flag them again"));
+    watchedPositions.remove(QStringLiteral("BTCUSDT|1m|L"));
+    stopLossWatch.finishClose(QStringLiteral("BTCUSDT|1m|L"));
+    if (!priceSockets.isEmpty()) {
+        priceSockets.constFirst()->sendTextMessage(streamFrameSeeds.constLast());
+    }
+    check(waitUntil([&]() { return markedSymbols.size() == 3; }, 5'000) && flaggedCloses.size() == 2
+              && stopLossWatch.closingKeys() == QSet<QString>{QStringLiteral("BTCUSDT|15m|S")},
+          QStringLiteral("a closed position should leave the stop-loss watch"));
+    priceStream.setSymbols({});
+    check(priceStream.symbols().isEmpty() && priceStream.table().quote(btcId).markUpdatedMs == 0,
+          QStringLiteral("unfollowed symbols should be unsubscribed and cleared"));
+#endif
+
+    // The REST and stream clients end to end against the local exchange
+    // simulator.
+    NativeExchangeSimulator::Config simulatorConfig;
+    simulatorConfig.symbols = {QStringLiteral("BTCUSDT"), QStringLiteral("ETHUSDT"), QStringLiteral("SOLUSDT")};
+    simulatorConfig.seed = 7;
+    simulatorConfig.apiKey = QStringLiteral("sim-key");
+    simulatorConfig.apiSecret = QStringLiteral("sim-secret");
+    simulatorConfig.streamIntervalMs = 50;
+    NativeExchangeSimulator::Server simulator(simulatorConfig);
+    check(simulator.listen(), QStringLiteral("the exchange simulator should listen"));
+    const QString simulatorBase = simulator.restBaseUrl();
+
+    const BinanceRestClient::SymbolsResult simulatedSymbols =
+        BinanceRestClient::fetchUsdtSymbols(true, false, 5'000, true, 0, simulatorBase);
+    check(simulatedSymbols.ok && simulatedSymbols.symbols.size() == 3
+              && simulatedSymbols.symbols.contains(QStringLiteral("SOLUSDT")),
+          QStringLiteral("the simulator should list its symbols as tradable perpetuals (%1)").arg(simulatedSymbols.error));
+
+    const BinanceRestClient::KlinesResult simulatedKlines = BinanceRestClient::fetchKlines(
+        QStringLiteral("BTCUSDT"), QStringLiteral("1m"), true, false, 100, 5'000, simulatorBase);
+    const BinanceRestClient::KlinesResult repeatedKlines = BinanceRestClient::fetchKlines(
+        QStringLiteral("BTCUSDT"), QStringLiteral("1m"), true, false, 100, 5'000, simulatorBase);
+    bool contiguousKlines = simulatedKlines.ok && simulatedKlines.candles.size() == 100;
+    for (qsizetype index = 1; contiguousKlines && index < simulatedKlines.candles.size(); ++index) {
+        const BinanceRestClient::KlineCandle &previous = simulatedKlines.candles.at(index - 1);
+        const BinanceRestClient::KlineCandle &current = simulatedKlines.candles.at(index);
+        contiguousKlines = current.openTimeMs - previous.openTimeMs == 60'000 && current.open == previous.close
+            && previous.high >= std::max(previous.open, previous.close)
+            && previous.low <= std::min(previous.open, previous.close);
+    }
+    check(contiguousKlines && repeatedKlines.ok
+              && repeatedKlines.candles.at(50).close == simulatedKlines.candles.at(50).close
+              && repeatedKlines.candles.at(50).volume == simulatedKlines.candles.at(50).volume,
+          QStringLiteral("simulated klines should be contiguous, consistent and repeatable"));
+    const qint64 pageStartMs = simulatedKlines.ok ? simulatedKlines.candles.at(10).openTimeMs : 0;
+    const BinanceRestClient::KlinesResult pagedKlines = BinanceRestClient::fetchKlines(
+        QStringLiteral("BTCUSDT"), QStringLiteral("1m"), true, false, 5, 5'000, simulatorBase, pageStartMs - 1);
+    check(pagedKlines.ok && pagedKlines.candles.size() == 5 && pagedKlines.candles.constFirst().openTimeMs == pageStartMs
+              && pagedKlines.candles.constLast().close == simulatedKlines.candles.at(14).close,
+          QStringLiteral("a startTime page should begin at the next candle and match the latest page"));
+
+    const int simBtcIndex = simulator.market().indexOf(QStringLiteral("BTCUSDT"));
+    const NativeExchangeSimulator::SymbolSpec simBtc = simulator.market().symbols().at(simBtcIndex);
+    const BinanceRestClient::FuturesSymbolFilters simulatedFilters =
+        BinanceRestClient::fetchFuturesSymbolFilters(QStringLiteral("BTCUSDT"), false, 5'000, simulatorBase);
+    check(simulatedFilters.ok && std::abs(simulatedFilters.tickSize - simBtc.tickSize) < 1e-12
+              && std::abs(simulatedFilters.stepSize - simBtc.stepSize) < 1e-12 && simulatedFilters.minNotional == 5.0
+              && simulatedFilters.pricePrecision == simBtc.pricePrecision,
+          QStringLiteral("simulated exchangeInfo filters should follow the symbol's spec"));
+    const BinanceRestClient::TickerPriceResult simulatedTicker =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), true, false, 5'000, simulatorBase);
+    const double simBtcPrice = simulator.market().priceAt(simBtcIndex, QDateTime::currentMSecsSinceEpoch());
+    check(simulatedTicker.ok && std::abs(simulatedTicker.price - simBtcPrice) <= simBtcPrice * 0.01,
+          QStringLiteral("the simulated ticker should quote the synthetic price"));
+
+    const BinanceRestClient::BalanceResult simulatedBalance = BinanceRestClient::fetchUsdtBalance(
+        QStringLiteral("sim-key"), QStringLiteral("sim-secret"), true, false, 5'000, simulatorBase);
+    check(simulatedBalance.ok && simulatedBalance.totalUsdtBalance == 10'000.0
+              && simulatedBalance.availableUsdtBalance == 10'000.0,
+          QStringLiteral("a signed balance request should read the simulated wallet (%1)").arg(simulatedBalance.error));
+    const BinanceRestClient::BalanceResult wrongSecret = BinanceRestClient::fetchUsdtBalance(
+        QStringLiteral("sim-key"), QStringLiteral("other-secret"), true, false, 5'000, simulatorBase);
+    check(!wrongSecret.ok, QStringLiteral("a request signed with the wrong secret should be rejected"));
+
+    const double simQuantity = std::ceil(100.0 / simBtcPrice / simBtc.stepSize) * simBtc.stepSize;
+    const BinanceRestClient::FuturesOrderResult simulatedOpen = BinanceRestClient::placeFuturesMarketOrder(
+        QStringLiteral("sim-key"), QStringLiteral("sim-secret"), QStringLiteral("BTCUSDT"), QStringLiteral("BUY"),
+        simQuantity, false, false, {}, 5'000, simulatorBase);
+    const BinanceRestClient::FuturesPositionsResult simulatedPositions = BinanceRestClient::fetchOpenFuturesPositions(
+        QStringLiteral("sim-key"), QStringLiteral("sim-secret"), false, 5'000, simulatorBase);
+    check(simulatedOpen.ok && simulatedOpen.status == QStringLiteral("FILLED")
+              && std::abs(simulatedOpen.executedQty - simQuantity) < simBtc.stepSize / 2.0
+              && std::abs(simulator.positionAmount(QStringLiteral("BTCUSDT")) - simQuantity) < simBtc.stepSize / 2.0
+              && simulatedPositions.ok && simulatedPositions.positions.size() == 1
+              && std::abs(simulatedPositions.positions.constFirst().positionAmt - simQuantity) < simBtc.stepSize / 2.0,
+          QStringLiteral("a simulated market order should fill and open a position (%1)").arg(simulatedOpen.error));
+    const BinanceRestClient::FuturesOrderResult simulatedClose = BinanceRestClient::placeFuturesMarketOrder(
+        QStringLiteral("sim-key"), QStringLiteral("sim-secret"), QStringLiteral("BTCUSDT"), QStringLiteral("SELL"),
+        simQuantity, false, true, {}, 5'000, simulatorBase);
+    const BinanceRestClient::FuturesOrderResult rejectedReduce = BinanceRestClient::placeFuturesMarketOrder(
+        QStringLiteral("sim-key"), QStringLiteral("sim-secret"), QStringLiteral("BTCUSDT"), QStringLiteral("SELL"),
+        simQuantity, false, true, {}, 5'000, simulatorBase);
+    check(simulatedClose.ok && simulator.positionAmount(QStringLiteral("BTCUSDT")) == 0.0
+              && simulator.walletBalance() < 10'000.0 && !rejectedReduce.ok
+              && simulator.stats().ordersFilled == 2 && simulator.stats().ordersRejected == 1,
+          QStringLiteral("a reduce-only order should close the position and then be rejected with nothing left"));
+
+    NativeExchangeSimulator::ScriptedResponse outage;
+    outage.method = QByteArrayLiteral("GET");
+    outage.path = QStringLiteral("/fapi/v1/ticker/price");
+    outage.status = 503;
+    outage.body = QByteArrayLiteral(R"({"code":-1001,"msg":"Internal error; unable to process your request."})");
+    outage.remaining = 1;
+    simulator.addScriptedResponse(outage);
+    const BinanceRestClient::TickerPriceResult scriptedFailure =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), true, false, 5'000, simulatorBase);
+    const BinanceRestClient::TickerPriceResult afterOutage =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), true, false, 5'000, simulatorBase);
+    check(!scriptedFailure.ok && afterOutage.ok && simulator.stats().scriptedResponses == 1,
+          QStringLiteral("a scripted response should be served the scripted number of times"));
+
+    simulator.banFor(60);
+    const BinanceRestClient::TickerPriceResult simulatedBan =
+        BinanceRestClient::fetchTickerPrice(QStringLiteral("BTCUSDT"), true, false, 5'000, simulatorBase);
+    check(!simulatedBan.ok && simulator.stats().banned == 1
+              && NativeRequestLimiter::snapshot(true, false, simulatorBase).value(QStringLiteral("seconds_until_unban")).toDouble() > 50.0,
+          QStringLiteral("a simulated IP ban should reach the shared request limiter"));
+    simulator.banFor(0);
+    NativeRequestLimiter::Limiter::forMarket(true, false, simulatorBase).reset(QDateTime::currentMSecsSinceEpoch());
+
+#if HAS_QT_WEBSOCKETS
+    NativePriceStream::Service simulatedPrices;
+    simulatedPrices.setCombinedStreamBaseUrlOverride(simulator.streamBaseUrl() + QStringLiteral("/stream"));
+    simulatedPrices.setMarket(true, false);
+    simulatedPrices.setSymbols({QStringLiteral("ETHUSDT")});
+    const NativeSymbolTable::SymbolId simEthId = NativeSymbolTable::intern(QStringLiteral("ETHUSDT"));
+    check(waitUntil([&]() {
+              const NativePriceStream::Quote quote = simulatedPrices.table().quote(simEthId);
+              return quote.markUpdatedMs > 0 && quote.bookUpdatedMs > 0;
+          }, 5'000)
+              && simulatedPrices.table().quote(simEthId).bidPrice < simulatedPrices.table().quote(simEthId).askPrice,
+          QStringLiteral("the price stream should follow simulated mark and book prices on the shared port"));
+    simulatedPrices.stop();
+
+    NativeUserDataStream::Client simulatedAccount;
+    simulatedAccount.setStreamBaseUrlOverride(simulator.streamBaseUrl() + QStringLiteral("/ws"));
+    simulatedAccount.start(QStringLiteral("sim-key"), QStringLiteral("sim-secret"), false, simulatorBase);
+    check(waitUntil([&]() { return simulatedAccount.isSynced(); }, 5'000) && simulator.stats().userDataConnections == 1,
+          QStringLiteral("the user-data client should sync against the simulator"));
+    const int simEthIndex = simulator.market().indexOf(QStringLiteral("ETHUSDT"));
+    const NativeExchangeSimulator::SymbolSpec simEth = simulator.market().symbols().at(simEthIndex);
+    const double simEthQuantity = std::ceil(
+        100.0 / simulator.market().priceAt(simEthIndex, QDateTime::currentMSecsSinceEpoch()) / simEth.stepSize) * simEth.stepSize;
+    const BinanceRestClient::FuturesOrderResult streamedOpen = BinanceRestClient::placeFuturesMarketOrder(
+        QStringLiteral("sim-key"), QStringLiteral("sim-secret"), QStringLiteral("ETHUSDT"), QStringLiteral("BUY"),
+        simEthQuantity, false, false, {}, 5'000, simulatorBase);
+    check(streamedOpen.ok
+              && waitUntil([&]() {
+                     return simulatedAccount.state().positionSymbols() == QStringList{QStringLiteral("ETHUSDT")};
+                 }, 5'000),
+          QStringLiteral("simulated fills should reach the account state over the user-data stream"));
+    simulatedAccount.stop();
+#endif
+    simulator.close();
+
     return failures == 0 ? 0 : 1;
 }